@@ -16,15 +16,60 @@ CREATE TABLE `saas_restaurant`.`branch`  (
   PRIMARY KEY (`branch_id`)
 );
 
+CREATE TABLE `saas_restaurant`.`branch_dish`  (
+  `branch_id` int UNSIGNED NOT NULL COMMENT '分店ID',
+  `dish_id` int UNSIGNED NOT NULL COMMENT '菜品ID',
+  `tenant_id` int UNSIGNED NOT NULL COMMENT '租户ID',
+  `dish_price` decimal(12, 2) NULL COMMENT '分店售价（NULL 沿用总店）',
+  `status` varchar(50) NULL COMMENT '分店菜品状态（NULL 沿用总店）',
+  `stock` int UNSIGNED NULL COMMENT '分店库存（NULL 沿用总店）',
+  `updated_at` timestamp NULL DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP COMMENT '更新时间',
+  PRIMARY KEY (`branch_id`, `dish_id`),
+  INDEX `idx_branch_dish_dish`(`dish_id`)
+);
+
+CREATE TABLE `saas_restaurant`.`broadcast`  (
+  `broadcast_id` bigint UNSIGNED NOT NULL AUTO_INCREMENT COMMENT '群发ID',
+  `tenant_id` int UNSIGNED NULL COMMENT '租户ID',
+  `campaign_id` int UNSIGNED NULL COMMENT '营销活动ID',
+  `channel` varchar(50) NULL COMMENT '渠道',
+  `content` text NULL COMMENT '消息内容',
+  `segment` text NULL COMMENT '会员分群条件（JSON）',
+  `status` varchar(50) NULL COMMENT '状态（发送中、已完成）',
+  `total` int UNSIGNED NULL COMMENT '收件人数',
+  `sent` int UNSIGNED NULL COMMENT '已发送数',
+  `failed` int UNSIGNED NULL COMMENT '失败数',
+  `created_at` timestamp NULL DEFAULT CURRENT_TIMESTAMP COMMENT '创建时间',
+  `updated_at` timestamp NULL DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP COMMENT '更新时间',
+  PRIMARY KEY (`broadcast_id`),
+  INDEX `idx_broadcast_campaign`(`tenant_id`, `campaign_id`)
+);
+
+CREATE TABLE `saas_restaurant`.`broadcast_delivery`  (
+  `delivery_id` bigint UNSIGNED NOT NULL AUTO_INCREMENT COMMENT '投递ID',
+  `broadcast_id` bigint UNSIGNED NULL COMMENT '群发ID',
+  `channel` varchar(50) NULL COMMENT '渠道',
+  `member_id` int UNSIGNED NULL COMMENT '会员ID',
+  `address` varchar(255) NULL COMMENT '收件地址',
+  `status` varchar(50) NULL COMMENT '状态（待发送、已发送、失败）',
+  `attempts` int UNSIGNED NULL COMMENT '已尝试次数',
+  `next_attempt_at` timestamp NULL COMMENT '下次尝试时间',
+  `updated_at` timestamp NULL DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP COMMENT '更新时间',
+  PRIMARY KEY (`delivery_id`),
+  INDEX `idx_broadcast_delivery_due`(`channel`, `status`, `next_attempt_at`),
+  INDEX `idx_broadcast_delivery_broadcast`(`broadcast_id`)
+);
+
 CREATE TABLE `saas_restaurant`.`consumption_record`  (
   `record_id` int UNSIGNED NOT NULL AUTO_INCREMENT COMMENT '记录ID',
   `created_at` timestamp NULL DEFAULT CURRENT_TIMESTAMP COMMENT '创建时间',
-  `amount` varchar(255) NULL COMMENT '消费量',
+  `amount` decimal(12, 2) NULL COMMENT '消费量',
   `order_items` varchar(255) NULL COMMENT '菜品',
   `member_id` int UNSIGNED NULL COMMENT '会员ID',
   `tenant_id` int UNSIGNED NULL COMMENT '租户ID',
   `points` varchar(255) NULL COMMENT '积分',
-  PRIMARY KEY (`record_id`)
+  PRIMARY KEY (`record_id`),
+  INDEX `idx_consumption_record_member`(`tenant_id`, `member_id`, `record_id`)
 );
 
 CREATE TABLE `saas_restaurant`.`dish`  (
@@ -32,9 +77,9 @@ CREATE TABLE `saas_restaurant`.`dish`  (
   `tenant_id` int UNSIGNED NULL COMMENT '租户ID',
   `dish_category_id` int UNSIGNED NULL COMMENT '菜品分类ID',
   `dish_name` varchar(255) NULL COMMENT '菜品名称',
-  `dish_price` varchar(255) NULL COMMENT '销售价格',
-  `cost_price` varchar(255) NULL COMMENT '成本价',
-  `origin_price` varchar(255) NULL COMMENT '原价',
+  `dish_price` decimal(12, 2) NULL COMMENT '销售价格',
+  `cost_price` decimal(12, 2) NULL COMMENT '成本价',
+  `origin_price` decimal(12, 2) NULL COMMENT '原价',
   `description` text NULL COMMENT '菜品描述',
   `sales` int UNSIGNED NULL COMMENT '销量',
   `stock` int UNSIGNED NULL COMMENT '库存数量',
@@ -58,13 +103,37 @@ CREATE TABLE `saas_restaurant`.`dish_category`  (
   PRIMARY KEY (`category_id`)
 );
 
+CREATE TABLE `saas_restaurant`.`dish_ingredient`  (
+  `ingredient_id` int UNSIGNED NOT NULL AUTO_INCREMENT COMMENT '配方ID',
+  `tenant_id` int UNSIGNED NULL COMMENT '租户ID',
+  `dish_id` int UNSIGNED NULL COMMENT '菜品ID',
+  `item_id` int UNSIGNED NULL COMMENT '物料ID',
+  `quantity` int NULL COMMENT '每份菜品消耗的物料数量',
+  `created_at` timestamp NULL DEFAULT CURRENT_TIMESTAMP COMMENT '创建时间',
+  `updated_at` timestamp NULL DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP COMMENT '更新时间',
+  `is_deleted` tinyint(1) NULL COMMENT '软删除标记（0：未删除，1：已删除）',
+  PRIMARY KEY (`ingredient_id`),
+  INDEX `idx_dish_ingredient_dish`(`dish_id`)
+);
+
+CREATE TABLE `saas_restaurant`.`ingredient_deduction`  (
+  `order_id` int UNSIGNED NOT NULL COMMENT '订单ID',
+  `tenant_id` int UNSIGNED NULL COMMENT '租户ID',
+  `item_usage` text NOT NULL COMMENT '物料用量（JSON：物料ID -> 数量）',
+  `created_at` timestamp NULL DEFAULT CURRENT_TIMESTAMP COMMENT '创建时间',
+  `deducted_at` timestamp NULL COMMENT '出库流水写入时间，为空表示待扣减',
+  `restored_at` timestamp NULL COMMENT '订单取消或删除后入库回补的时间，为空表示未回补',
+  PRIMARY KEY (`order_id`),
+  INDEX `idx_ingredient_deduction_pending`(`deducted_at`)
+);
+
 CREATE TABLE `saas_restaurant`.`inventory`  (
   `inventory_id` int UNSIGNED NOT NULL AUTO_INCREMENT COMMENT '库存ID',
   `tenant_id` int UNSIGNED NULL COMMENT '租户ID',
   `quantity` int NULL COMMENT '当前可用库存数量',
   `item_name` varchar(255) NULL COMMENT '物料名称',
   `item_category` varchar(255) NULL COMMENT '物料类型',
-  `item_cost` varchar(255) NULL COMMENT '采购价',
+  `item_cost` decimal(12, 2) NULL COMMENT '采购价',
   `min_stock` int NULL COMMENT '库存预警最小值',
   `max_stock` int NULL COMMENT '库存预警最大值',
   `supplier` varchar(255) NULL COMMENT '供应商',
@@ -88,6 +157,17 @@ CREATE TABLE `saas_restaurant`.`inventory_record`  (
   PRIMARY KEY (`record_id`)
 );
 
+CREATE TABLE `saas_restaurant`.`inventory_snapshot`  (
+  `snapshot_id` int UNSIGNED NOT NULL AUTO_INCREMENT COMMENT '库存快照ID',
+  `tenant_id` int UNSIGNED NULL COMMENT '租户ID',
+  `item_id` int UNSIGNED NOT NULL COMMENT '物料ID',
+  `quantity` int NOT NULL COMMENT '快照时的库存数量',
+  `last_record_id` int UNSIGNED NOT NULL DEFAULT 0 COMMENT '快照已包含的最后一条库存记录ID（0表示期初）',
+  `snapshot_at` timestamp NULL DEFAULT CURRENT_TIMESTAMP COMMENT '快照时间',
+  PRIMARY KEY (`snapshot_id`),
+  INDEX `idx_inventory_snapshot_item`(`item_id`, `last_record_id`)
+);
+
 CREATE TABLE `saas_restaurant`.`marketing_campaign`  (
   `campaign_id` int UNSIGNED NOT NULL AUTO_INCREMENT COMMENT '营销方案ID',
   `tenant_id` int UNSIGNED NULL COMMENT '租户ID',
@@ -113,7 +193,7 @@ CREATE TABLE `saas_restaurant`.`member`  (
   `phone` varchar(255) NULL COMMENT '会员手机号',
   `points` int UNSIGNED NULL COMMENT '当前可用积分',
   `total_points` int UNSIGNED NULL COMMENT '历史累计积分',
-  `total_spent` varchar(255) NULL COMMENT '累计消费金额',
+  `total_spent` decimal(12, 2) NULL COMMENT '累计消费金额',
   `expire_date` timestamp NULL COMMENT '会员有效期',
   `status` varchar(50) NULL COMMENT '会员状态',
   `created_at` timestamp NULL DEFAULT CURRENT_TIMESTAMP COMMENT '创建时间',
@@ -127,8 +207,8 @@ CREATE TABLE `saas_restaurant`.`member_level`  (
   `tenant_id` int UNSIGNED NULL COMMENT '租户ID',
   `level_name` varchar(255) NULL COMMENT '等级名称',
   `required_points` int UNSIGNED NULL COMMENT '升级所需要的积分',
-  `required_spent` varchar(255) NULL COMMENT '升级所需累计消费金额',
-  `discount_rate` varchar(255) NULL COMMENT '折扣率',
+  `required_spent` decimal(12, 2) NULL COMMENT '升级所需累计消费金额',
+  `discount_rate` decimal(6, 4) NULL COMMENT '折扣率',
   `icon_url` varchar(255) NULL COMMENT '等级图标',
   `benefits` json NULL COMMENT '等级权益',
   PRIMARY KEY (`level_id`)
@@ -138,8 +218,9 @@ CREATE TABLE `saas_restaurant`.`order_table`  (
   `order_id` int UNSIGNED NOT NULL AUTO_INCREMENT COMMENT '订单ID',
   `tenant_id` int UNSIGNED NULL COMMENT '租户ID',
   `user_id` int UNSIGNED NULL COMMENT '用户ID',
-  `total_amount` varchar(255) NULL COMMENT '订单总金额（不含优惠）',
-  `discount_ammout` varchar(255) NULL COMMENT '优惠金额',
+  `branch_id` int UNSIGNED NULL COMMENT '分店ID',
+  `total_amount` decimal(12, 2) NULL COMMENT '订单总金额（不含优惠）',
+  `discount_ammout` decimal(12, 2) NULL COMMENT '优惠金额',
   `payment_method` varchar(255) NULL COMMENT '支付方式',
   `payment_status` varchar(50) NULL COMMENT '支付状态',
   `order_status` varchar(50) NULL COMMENT '订单状态',
@@ -164,6 +245,47 @@ CREATE TABLE `saas_restaurant`.`permission`  (
   PRIMARY KEY (`permission_id`)
 );
 
+CREATE TABLE `saas_restaurant`.`report_category_rollup`  (
+  `tenant_id` int UNSIGNED NOT NULL COMMENT '租户ID',
+  `branch_id` int UNSIGNED NOT NULL DEFAULT 0 COMMENT '分店ID（0：全租户汇总）',
+  `granularity` varchar(10) NOT NULL COMMENT '时间粒度（hour/day）',
+  `bucket_start` datetime NOT NULL COMMENT '时间桶起点',
+  `category_id` int UNSIGNED NOT NULL DEFAULT 0 COMMENT '菜品分类ID（0：未分类）',
+  `quantity` int NOT NULL DEFAULT 0 COMMENT '销售份数',
+  `revenue` decimal(14, 2) NOT NULL DEFAULT 0 COMMENT '销售额（按明细小计）',
+  PRIMARY KEY (`tenant_id`, `branch_id`, `granularity`, `bucket_start`, `category_id`)
+);
+
+CREATE TABLE `saas_restaurant`.`report_customer`  (
+  `tenant_id` int UNSIGNED NOT NULL COMMENT '租户ID',
+  `branch_id` int UNSIGNED NOT NULL DEFAULT 0 COMMENT '分店ID（0：全租户汇总）',
+  `granularity` varchar(10) NOT NULL COMMENT '时间粒度（hour/day）',
+  `bucket_start` datetime NOT NULL COMMENT '时间桶起点',
+  `member_id` int UNSIGNED NOT NULL COMMENT '会员ID',
+  PRIMARY KEY (`tenant_id`, `branch_id`, `granularity`, `bucket_start`, `member_id`)
+);
+
+CREATE TABLE `saas_restaurant`.`report_rollup`  (
+  `tenant_id` int UNSIGNED NOT NULL COMMENT '租户ID',
+  `branch_id` int UNSIGNED NOT NULL DEFAULT 0 COMMENT '分店ID（0：全租户汇总）',
+  `granularity` varchar(10) NOT NULL COMMENT '时间粒度（hour/day）',
+  `bucket_start` datetime NOT NULL COMMENT '时间桶起点',
+  `revenue` decimal(14, 2) NOT NULL DEFAULT 0 COMMENT '营收',
+  `order_count` int NOT NULL DEFAULT 0 COMMENT '订单数',
+  `customer_count` int NOT NULL DEFAULT 0 COMMENT '客流（去重会员数 + 散客人数）',
+  PRIMARY KEY (`tenant_id`, `branch_id`, `granularity`, `bucket_start`)
+);
+
+CREATE TABLE `saas_restaurant`.`report_sketch`  (
+  `tenant_id` int UNSIGNED NOT NULL COMMENT '租户ID',
+  `branch_id` int UNSIGNED NOT NULL DEFAULT 0 COMMENT '分店ID（0：全租户汇总）',
+  `bucket_date` date NOT NULL COMMENT '日期',
+  `customers` blob NULL COMMENT '去重顾客 HyperLogLog 草图',
+  `top_dishes` text NULL COMMENT '热销菜品 Space-Saving 草图',
+  `updated_at` timestamp NULL DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP COMMENT '更新时间',
+  PRIMARY KEY (`tenant_id`, `branch_id`, `bucket_date`)
+);
+
 CREATE TABLE `saas_restaurant`.`role`  (
   `role_id` int UNSIGNED NOT NULL AUTO_INCREMENT COMMENT '角色ID',
   `tenant_id` int UNSIGNED NULL COMMENT '租户ID',
@@ -239,18 +361,48 @@ CREATE TABLE `saas_restaurant`.`user_role`  (
   PRIMARY KEY (`user_role_id`)
 );
 
+CREATE TABLE `saas_restaurant`.`voucher`  (
+  `voucher_id` bigint UNSIGNED NOT NULL COMMENT '券ID（即券码中的发券序号）',
+  `voucher_code` char(12) NOT NULL COMMENT '券码',
+  `tenant_id` int UNSIGNED NOT NULL COMMENT '租户ID',
+  `campaign_id` int UNSIGNED NOT NULL COMMENT '营销活动ID',
+  `status` varchar(50) NULL COMMENT '券状态（未使用、已使用、已作废）',
+  `order_id` int UNSIGNED NULL COMMENT '核销订单ID',
+  `member_id` int UNSIGNED NULL COMMENT '核销会员ID',
+  `redeemed_at` timestamp NULL COMMENT '核销时间',
+  `created_at` timestamp NULL DEFAULT CURRENT_TIMESTAMP COMMENT '创建时间',
+  `updated_at` timestamp NULL DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP COMMENT '更新时间',
+  PRIMARY KEY (`voucher_id`),
+  UNIQUE INDEX `idx_voucher_code`(`voucher_code`),
+  INDEX `idx_voucher_campaign`(`campaign_id`)
+);
+
 ALTER TABLE `saas_restaurant`.`branch` ADD CONSTRAINT `FK_branch_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
 ALTER TABLE `saas_restaurant`.`branch` ADD CONSTRAINT `FK_branch_manager_id` FOREIGN KEY (`manager_id`) REFERENCES `saas_restaurant`.`user` (`user_id`);
+ALTER TABLE `saas_restaurant`.`branch_dish` ADD CONSTRAINT `FK_branch_dish_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
+ALTER TABLE `saas_restaurant`.`branch_dish` ADD CONSTRAINT `FK_branch_dish_branch_id` FOREIGN KEY (`branch_id`) REFERENCES `saas_restaurant`.`branch` (`branch_id`);
+ALTER TABLE `saas_restaurant`.`branch_dish` ADD CONSTRAINT `FK_branch_dish_dish_id` FOREIGN KEY (`dish_id`) REFERENCES `saas_restaurant`.`dish` (`dish_id`) ON DELETE CASCADE;
+ALTER TABLE `saas_restaurant`.`broadcast` ADD CONSTRAINT `FK_broadcast_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
+ALTER TABLE `saas_restaurant`.`broadcast` ADD CONSTRAINT `FK_broadcast_campaign_id` FOREIGN KEY (`campaign_id`) REFERENCES `saas_restaurant`.`marketing_campaign` (`campaign_id`);
+ALTER TABLE `saas_restaurant`.`broadcast_delivery` ADD CONSTRAINT `FK_broadcast_delivery_broadcast_id` FOREIGN KEY (`broadcast_id`) REFERENCES `saas_restaurant`.`broadcast` (`broadcast_id`);
+ALTER TABLE `saas_restaurant`.`broadcast_delivery` ADD CONSTRAINT `FK_broadcast_delivery_member_id` FOREIGN KEY (`member_id`) REFERENCES `saas_restaurant`.`member` (`member_id`);
 ALTER TABLE `saas_restaurant`.`consumption_record` ADD CONSTRAINT `FK_consumption_record_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
 ALTER TABLE `saas_restaurant`.`consumption_record` ADD CONSTRAINT `FK_consumption_record_member_id` FOREIGN KEY (`member_id`) REFERENCES `saas_restaurant`.`member` (`member_id`);
 ALTER TABLE `saas_restaurant`.`dish` ADD CONSTRAINT `FK_dish_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
 ALTER TABLE `saas_restaurant`.`dish` ADD CONSTRAINT `FK_dish_dish_category_id` FOREIGN KEY (`dish_category_id`) REFERENCES `saas_restaurant`.`dish_category` (`category_id`);
 ALTER TABLE `saas_restaurant`.`dish_category` ADD CONSTRAINT `FK_dish_category_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
 ALTER TABLE `saas_restaurant`.`dish_category` ADD CONSTRAINT `FK_dish_category_parent_id` FOREIGN KEY (`parent_id`) REFERENCES `saas_restaurant`.`dish_category` (`category_id`);
+ALTER TABLE `saas_restaurant`.`dish_ingredient` ADD CONSTRAINT `FK_dish_ingredient_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
+ALTER TABLE `saas_restaurant`.`dish_ingredient` ADD CONSTRAINT `FK_dish_ingredient_dish_id` FOREIGN KEY (`dish_id`) REFERENCES `saas_restaurant`.`dish` (`dish_id`);
+ALTER TABLE `saas_restaurant`.`dish_ingredient` ADD CONSTRAINT `FK_dish_ingredient_item_id` FOREIGN KEY (`item_id`) REFERENCES `saas_restaurant`.`inventory` (`inventory_id`);
+ALTER TABLE `saas_restaurant`.`ingredient_deduction` ADD CONSTRAINT `FK_ingredient_deduction_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
+ALTER TABLE `saas_restaurant`.`ingredient_deduction` ADD CONSTRAINT `FK_ingredient_deduction_order_id` FOREIGN KEY (`order_id`) REFERENCES `saas_restaurant`.`order_table` (`order_id`);
 ALTER TABLE `saas_restaurant`.`inventory` ADD CONSTRAINT `FK_inventory_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
 ALTER TABLE `saas_restaurant`.`inventory_record` ADD CONSTRAINT `FK_inventory_record_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
 ALTER TABLE `saas_restaurant`.`inventory_record` ADD CONSTRAINT `FK_inventory_record_operator_id` FOREIGN KEY (`operator_id`) REFERENCES `saas_restaurant`.`user` (`user_id`);
 ALTER TABLE `saas_restaurant`.`inventory_record` ADD CONSTRAINT `FK_inventory_record_item_id` FOREIGN KEY (`item_id`) REFERENCES `saas_restaurant`.`inventory` (`inventory_id`);
+ALTER TABLE `saas_restaurant`.`inventory_snapshot` ADD CONSTRAINT `FK_inventory_snapshot_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
+ALTER TABLE `saas_restaurant`.`inventory_snapshot` ADD CONSTRAINT `FK_inventory_snapshot_item_id` FOREIGN KEY (`item_id`) REFERENCES `saas_restaurant`.`inventory` (`inventory_id`);
 ALTER TABLE `saas_restaurant`.`marketing_campaign` ADD CONSTRAINT `FK_marketing_campaign_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
 ALTER TABLE `saas_restaurant`.`marketing_campaign` ADD CONSTRAINT `FK_marketing_campaign_level_id` FOREIGN KEY (`level_id`) REFERENCES `saas_restaurant`.`member_level` (`level_id`);
 ALTER TABLE `saas_restaurant`.`member` ADD CONSTRAINT `FK_member_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
@@ -258,7 +410,12 @@ ALTER TABLE `saas_restaurant`.`member` ADD CONSTRAINT `FK_member_level_id` FOREI
 ALTER TABLE `saas_restaurant`.`member_level` ADD CONSTRAINT `FK_member_level_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
 ALTER TABLE `saas_restaurant`.`order_table` ADD CONSTRAINT `FK_ordertable_user_id` FOREIGN KEY (`user_id`) REFERENCES `saas_restaurant`.`user` (`user_id`);
 ALTER TABLE `saas_restaurant`.`order_table` ADD CONSTRAINT `FK_ordertable_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
+ALTER TABLE `saas_restaurant`.`order_table` ADD CONSTRAINT `FK_ordertable_branch_id` FOREIGN KEY (`branch_id`) REFERENCES `saas_restaurant`.`branch` (`branch_id`);
 ALTER TABLE `saas_restaurant`.`permission` ADD CONSTRAINT `FK_permission_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
+ALTER TABLE `saas_restaurant`.`report_category_rollup` ADD CONSTRAINT `FK_report_category_rollup_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
+ALTER TABLE `saas_restaurant`.`report_customer` ADD CONSTRAINT `FK_report_customer_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
+ALTER TABLE `saas_restaurant`.`report_rollup` ADD CONSTRAINT `FK_report_rollup_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
+ALTER TABLE `saas_restaurant`.`report_sketch` ADD CONSTRAINT `FK_report_sketch_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
 ALTER TABLE `saas_restaurant`.`role` ADD CONSTRAINT `FK_role_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
 ALTER TABLE `saas_restaurant`.`role_permission` ADD CONSTRAINT `FK_role_permission_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
 ALTER TABLE `saas_restaurant`.`role_permission` ADD CONSTRAINT `FK_role_permission_role_id` FOREIGN KEY (`role_id`) REFERENCES `saas_restaurant`.`role` (`role_id`);
@@ -267,4 +424,6 @@ ALTER TABLE `saas_restaurant`.`user` ADD CONSTRAINT `FK_user_tenant_id` FOREIGN
 ALTER TABLE `saas_restaurant`.`user_role` ADD CONSTRAINT `FK_user_role_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
 ALTER TABLE `saas_restaurant`.`user_role` ADD CONSTRAINT `FK_user_role_user_id` FOREIGN KEY (`user_id`) REFERENCES `saas_restaurant`.`user` (`user_id`);
 ALTER TABLE `saas_restaurant`.`user_role` ADD CONSTRAINT `FK_user_role_role_id` FOREIGN KEY (`role_id`) REFERENCES `saas_restaurant`.`role` (`role_id`);
+ALTER TABLE `saas_restaurant`.`voucher` ADD CONSTRAINT `FK_voucher_tenant_id` FOREIGN KEY (`tenant_id`) REFERENCES `saas_restaurant`.`tenant` (`tenant_id`);
+ALTER TABLE `saas_restaurant`.`voucher` ADD CONSTRAINT `FK_voucher_campaign_id` FOREIGN KEY (`campaign_id`) REFERENCES `saas_restaurant`.`marketing_campaign` (`campaign_id`);
 
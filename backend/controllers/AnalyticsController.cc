@@ -0,0 +1,140 @@
+#include "AnalyticsController.h"
+#include "plugins/OrderAnalytics.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace
+{
+void badRequest(const std::function<void(const HttpResponsePtr &)> &callback, const std::string &message)
+{
+  Json::Value response;
+  response["code"] = k400BadRequest;
+  response["message"] = message;
+  response["data"] = Json::Value::null;
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
+
+std::vector<std::string> splitList(const std::string &value)
+{
+  std::vector<std::string> items;
+  size_t begin = 0;
+  while (begin <= value.size())
+  {
+    auto end = value.find(',', begin);
+    if (end == std::string::npos)
+      end = value.size();
+    if (end > begin)
+      items.push_back(value.substr(begin, end - begin));
+    begin = end + 1;
+  }
+  return items;
+}
+
+// 日期或日期时间转为秒，格式错误时返回 false
+bool parseTime(const std::string &value, int64_t &seconds)
+{
+  auto date = trantor::Date::fromDbStringLocal(value);
+  if (date.microSecondsSinceEpoch() <= 0)
+    return false;
+  seconds = date.secondsSinceEpoch();
+  return true;
+}
+} // namespace
+
+void AnalyticsController::query(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const
+{
+  OrderColumns::Query query;
+  try
+  {
+    auto tenantParam = req->getParameter("tenant_id");
+    if (!tenantParam.empty())
+      query.tenantId = static_cast<uint32_t>(std::stoul(tenantParam));
+  }
+  catch (const std::exception &)
+  {
+    badRequest(callback, "tenant_id 参数错误");
+    return;
+  }
+  try
+  {
+    auto branchParam = req->getParameter("branch_id");
+    if (!branchParam.empty())
+      query.branchId = static_cast<uint32_t>(std::stoul(branchParam));
+  }
+  catch (const std::exception &)
+  {
+    badRequest(callback, "branch_id 参数错误");
+    return;
+  }
+
+  auto fromParam = req->getParameter("from");
+  if (!fromParam.empty() && !parseTime(fromParam, query.from))
+  {
+    badRequest(callback, "from 参数错误");
+    return;
+  }
+  auto toParam = req->getParameter("to");
+  if (!toParam.empty() && !parseTime(toParam, query.to))
+  {
+    badRequest(callback, "to 参数错误");
+    return;
+  }
+  if (query.from >= query.to)
+  {
+    badRequest(callback, "时间范围错误");
+    return;
+  }
+
+  for (const auto &name : splitList(req->getParameter("group_by")))
+  {
+    OrderColumns::Dimension dimension;
+    if (!OrderColumns::parseDimension(name, dimension))
+    {
+      badRequest(callback, "group_by 参数错误");
+      return;
+    }
+    if (std::find(query.groupBy.begin(), query.groupBy.end(), dimension) == query.groupBy.end())
+      query.groupBy.push_back(dimension);
+  }
+  query.paymentMethods = splitList(req->getParameter("payment_method"));
+  query.orderStatuses = splitList(req->getParameter("order_status"));
+
+  // 只读内存中的列式缓存
+  auto analytics = drogon::app().getPlugin<OrderAnalytics>();
+  auto start = std::chrono::steady_clock::now();
+  auto result = analytics->query(query);
+  auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  Json::Value groups(Json::arrayValue);
+  for (const auto &group : result.groups)
+  {
+    Json::Value item;
+    for (size_t i = 0; i < group.keys.size(); ++i)
+    {
+      auto dimension = query.groupBy[i];
+      if (dimension == OrderColumns::Weekday || dimension == OrderColumns::Hour)
+        item[OrderColumns::dimensionName(dimension)] = std::stoi(group.keys[i]);
+      else
+        item[OrderColumns::dimensionName(dimension)] = group.keys[i];
+    }
+    auto revenue = group.amountCents / 100.0;
+    item["count"] = (Json::UInt64)group.count;
+    item["revenue"] = revenue;
+    item["avg_order_value"] = group.count == 0 ? 0.0 : std::round(revenue / group.count * 100) / 100;
+    groups.append(item);
+  }
+
+  Json::Value data;
+  data["groups"] = groups;
+  data["scanned"] = (Json::UInt64)result.scanned;
+  data["window_start"] = trantor::Date(analytics->windowStart() * 1000000).toDbStringLocal();
+  data["elapsed_ms"] = std::round(elapsed * 1000) / 1000;
+  data["simd"] = OrderColumns::simdEnabled();
+
+  Json::Value response;
+  response["code"] = k200OK;
+  response["message"] = "ok";
+  response["data"] = data;
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+using namespace drogon;
+
+class AnalyticsController : public drogon::HttpController<AnalyticsController>
+{
+public:
+  METHOD_LIST_BEGIN
+  ADD_METHOD_TO(AnalyticsController::query, "/api/analytics/query", Get, Options, "AuthFilter"); // 订单分组聚合
+  METHOD_LIST_END
+
+  // tenant_id、branch_id 为空或 0 时不过滤；from、to 为日期或日期时间，from 含 to 不含，默认缓存内全部订单；
+  // group_by 为逗号分隔的 weekday、hour、payment_method、order_status；
+  // payment_method、order_status 为逗号分隔的取值，为空时不过滤
+  void query(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+};
@@ -0,0 +1,100 @@
+#include "BranchMenuController.h"
+#include "plugins/BranchMenus.h"
+
+namespace
+{
+constexpr size_t kMaxStatus = 50; // branch_dish.status 为 varchar(50)
+
+void reply(const std::function<void(const HttpResponsePtr &)> &callback,
+           int code,
+           const std::string &message,
+           const Json::Value &data = Json::Value::null)
+{
+  Json::Value response;
+  response["code"] = code;
+  response["message"] = message;
+  response["data"] = data;
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
+} // namespace
+
+void BranchMenuController::save(const HttpRequestPtr &req,
+                                std::function<void(const HttpResponsePtr &)> &&callback,
+                                uint32_t branchId,
+                                uint32_t dishId) const
+{
+  auto json = req->getJsonObject();
+  if (!json || !json->isObject())
+  {
+    reply(callback, k400BadRequest, "请求体须为 JSON 对象");
+    return;
+  }
+  BranchOverlay::Override delta;
+  delta.dishId = dishId;
+  const auto &price = (*json)["dish_price"];
+  if (!price.isNull())
+  {
+    if (!Money::isValidJson(price) || Money::fromJson(price) < Money())
+    {
+      reply(callback, k400BadRequest, "dish_price 须为非负金额");
+      return;
+    }
+    delta.price = Money::fromJson(price);
+  }
+  const auto &status = (*json)["status"];
+  if (!status.isNull())
+  {
+    if (!status.isString() || status.asString().empty() || status.asString().size() > kMaxStatus)
+    {
+      reply(callback, k400BadRequest, "status 须为不超过 50 字节的非空字符串");
+      return;
+    }
+    delta.status = status.asString();
+  }
+  const auto &stock = (*json)["stock"];
+  if (!stock.isNull())
+  {
+    if (!stock.isUInt())
+    {
+      reply(callback, k400BadRequest, "stock 须为非负整数");
+      return;
+    }
+    delta.stock = stock.asUInt();
+  }
+
+  auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
+  app().getPlugin<BranchMenus>()->saveOverride(
+      branchId,
+      std::move(delta),
+      [callbackPtr](bool found)
+      {
+        if (!found)
+        {
+          reply(*callbackPtr, k404NotFound, "分店或菜品不存在");
+          return;
+        }
+        reply(*callbackPtr, k200OK, "ok");
+      },
+      [callbackPtr](const std::string &message) { reply(*callbackPtr, k500InternalServerError, message); });
+}
+
+void BranchMenuController::remove(const HttpRequestPtr &req,
+                                  std::function<void(const HttpResponsePtr &)> &&callback,
+                                  uint32_t branchId,
+                                  uint32_t dishId) const
+{
+  auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
+  app().getPlugin<BranchMenus>()->removeOverride(
+      branchId,
+      dishId,
+      [callbackPtr](bool found)
+      {
+        if (!found)
+        {
+          reply(*callbackPtr, k404NotFound, "该菜品没有分店覆盖");
+          return;
+        }
+        reply(*callbackPtr, k200OK, "ok");
+      },
+      [callbackPtr](const std::string &message) { reply(*callbackPtr, k500InternalServerError, message); });
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+using namespace drogon;
+
+class BranchMenuController : public drogon::HttpController<BranchMenuController>
+{
+public:
+  METHOD_LIST_BEGIN
+  ADD_METHOD_TO(BranchMenuController::save, "/api/branch/{1}/dish/{2}", Put, Options, "AuthFilter");     // 设置分店菜品覆盖
+  ADD_METHOD_TO(BranchMenuController::remove, "/api/branch/{1}/dish/{2}", Delete, Options, "AuthFilter"); // 恢复总店设置
+  METHOD_LIST_END
+
+  // 请求体 {"dish_price": "12.50", "status": "售罄", "stock": 20}，省略或 null 的字段沿用总店，整条覆盖替换；
+  // 分店或菜品不存在、不属于同一租户时 code 为 404。分店菜单见 GET /api/dish?branch_id=
+  void save(const HttpRequestPtr &req,
+            std::function<void(const HttpResponsePtr &)> &&callback,
+            uint32_t branchId,
+            uint32_t dishId) const;
+  // 删除分店对该菜品的覆盖；没有覆盖时 code 为 404
+  void remove(const HttpRequestPtr &req,
+              std::function<void(const HttpResponsePtr &)> &&callback,
+              uint32_t branchId,
+              uint32_t dishId) const;
+};
@@ -0,0 +1,44 @@
+#include "BranchScheduleController.h"
+#include "plugins/BranchSchedules.h"
+
+namespace
+{
+void reply(const std::function<void(const HttpResponsePtr &)> &callback,
+           int code,
+           const std::string &message,
+           const Json::Value &data = Json::Value::null)
+{
+  Json::Value response;
+  response["code"] = code;
+  response["message"] = message;
+  response["data"] = data;
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
+} // namespace
+
+void BranchScheduleController::open(const HttpRequestPtr &req,
+                                    std::function<void(const HttpResponsePtr &)> &&callback) const
+{
+  const auto &value = req->getParameter("tenant_id");
+  if (value.empty() || value.size() > 9 || value.find_first_not_of("0123456789") != std::string::npos ||
+      std::stoul(value) == 0)
+  {
+    reply(callback, k400BadRequest, "tenant_id 参数错误");
+    return;
+  }
+  auto at = trantor::Date::now();
+  const auto &atParam = req->getParameter("at");
+  if (!atParam.empty())
+  {
+    at = trantor::Date::fromDbStringLocal(atParam);
+    if (at.microSecondsSinceEpoch() <= 0)
+    {
+      reply(callback, k400BadRequest, "at 参数错误");
+      return;
+    }
+  }
+  reply(callback,
+        k200OK,
+        "ok",
+        app().getPlugin<BranchSchedules>()->openAt(static_cast<uint32_t>(std::stoul(value)), at.secondsSinceEpoch()));
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+using namespace drogon;
+
+class BranchScheduleController : public drogon::HttpController<BranchScheduleController>
+{
+public:
+  METHOD_LIST_BEGIN
+  ADD_METHOD_TO(BranchScheduleController::open, "/api/branch/open", Get, Options, "AuthFilter"); // 各分店是否营业
+  METHOD_LIST_END
+
+  // tenant_id 必填；at 为日期时间，默认当前时间。
+  // 返回 {tenant_id, at, open_count, branches}，每个分店带 open（未设置营业时间时为 null，非营业中状态为 false）
+  // 和 next_change（下一次开门或打烊的时刻，一周多内不变时为 null）
+  void open(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+};
@@ -0,0 +1,140 @@
+#include "BroadcastController.h"
+#include "plugins/CampaignBroadcaster.h"
+
+namespace
+{
+void reply(const std::function<void(const HttpResponsePtr &)> &callback,
+           int code,
+           const std::string &message,
+           const Json::Value &data = Json::Value::null)
+{
+  Json::Value response;
+  response["code"] = code;
+  response["message"] = message;
+  response["data"] = data;
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
+
+// 非负整数数组，省略时为空
+template <typename T>
+bool parseList(const Json::Value &value, std::vector<T> &numbers)
+{
+  if (value.isNull())
+    return true;
+  if (!value.isArray())
+    return false;
+  for (const auto &item : value)
+  {
+    if (!item.isUInt())
+      return false;
+    numbers.push_back(static_cast<T>(item.asUInt()));
+  }
+  return true;
+}
+
+bool parseSegment(const Json::Value &segment, SegmentIndex::Filter &filter)
+{
+  if (segment.isNull())
+    return true;
+  if (!segment.isObject() || !parseList(segment["level_id"], filter.levels) ||
+      !parseList(segment["spend_bucket"], filter.spendBuckets) ||
+      !parseList(segment["recency_bucket"], filter.recencyBuckets) ||
+      !parseList(segment["r_score"], filter.recencyScores) || !parseList(segment["f_score"], filter.frequencyScores) ||
+      !parseList(segment["m_score"], filter.monetaryScores))
+    return false;
+  const auto &statuses = segment["status"];
+  if (statuses.isNull())
+    return true;
+  if (!statuses.isArray())
+    return false;
+  for (const auto &status : statuses)
+  {
+    if (!status.isString())
+      return false;
+    filter.statuses.push_back(status.asString());
+  }
+  return true;
+}
+
+// 非负整数参数，为空时返回 0
+bool parseId(const std::string &value, uint32_t &id)
+{
+  id = 0;
+  if (value.empty())
+    return true;
+  if (value.size() > 9 || value.find_first_not_of("0123456789") != std::string::npos)
+    return false;
+  id = static_cast<uint32_t>(std::stoul(value));
+  return true;
+}
+} // namespace
+
+void BroadcastController::create(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const
+{
+  auto json = req->getJsonObject();
+  if (!json || !json->isObject() || !(*json)["tenant_id"].isUInt() || !(*json)["campaign_id"].isUInt())
+  {
+    reply(callback, k400BadRequest, "tenant_id、campaign_id 参数错误");
+    return;
+  }
+  auto broadcaster = app().getPlugin<CampaignBroadcaster>();
+  const auto &channel = (*json)["channel"];
+  if (!channel.isString() || !broadcaster->hasChannel(channel.asString()))
+  {
+    reply(callback, k400BadRequest, "channel 参数错误");
+    return;
+  }
+  const auto &content = (*json)["content"];
+  if (!content.isString() || content.asString().empty())
+  {
+    reply(callback, k400BadRequest, "content 不能为空");
+    return;
+  }
+  SegmentIndex::Filter filter;
+  if (!parseSegment((*json)["segment"], filter))
+  {
+    reply(callback, k400BadRequest, "segment 参数错误");
+    return;
+  }
+
+  auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
+  broadcaster->create(
+      (*json)["tenant_id"].asUInt(),
+      (*json)["campaign_id"].asUInt(),
+      channel.asString(),
+      content.asString(),
+      filter,
+      [callbackPtr](uint64_t broadcastId, uint64_t total)
+      {
+        Json::Value data;
+        data["broadcast_id"] = static_cast<Json::UInt64>(broadcastId);
+        data["total"] = static_cast<Json::UInt64>(total);
+        reply(*callbackPtr, k200OK, "ok", data);
+      },
+      [callbackPtr](int code, const std::string &message) { reply(*callbackPtr, code, message); });
+}
+
+void BroadcastController::progress(const HttpRequestPtr &req,
+                                   std::function<void(const HttpResponsePtr &)> &&callback) const
+{
+  uint32_t tenantId = 0;
+  uint32_t campaignId = 0;
+  if (!parseId(req->getParameter("tenant_id"), tenantId) || tenantId == 0 ||
+      !parseId(req->getParameter("campaign_id"), campaignId) || campaignId == 0)
+  {
+    reply(callback, k400BadRequest, "tenant_id、campaign_id 参数错误");
+    return;
+  }
+  auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
+  app().getPlugin<CampaignBroadcaster>()->progress(
+      tenantId,
+      campaignId,
+      [callbackPtr, campaignId](const Json::Value &broadcasts)
+      {
+        Json::Value data;
+        data["campaign_id"] = campaignId;
+        data["broadcasts"] = broadcasts;
+        reply(*callbackPtr, k200OK, "ok", data);
+      },
+      [callbackPtr](const std::string &message) { reply(*callbackPtr, k500InternalServerError, message); });
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+using namespace drogon;
+
+class BroadcastController : public drogon::HttpController<BroadcastController>
+{
+public:
+  METHOD_LIST_BEGIN
+  ADD_METHOD_TO(BroadcastController::create, "/api/broadcast", Post, Options, "AuthFilter");            // 营销活动群发
+  ADD_METHOD_TO(BroadcastController::progress, "/api/broadcast/progress", Get, Options, "AuthFilter"); // 群发进度
+  METHOD_LIST_END
+
+  // 请求体 {"tenant_id": 1, "campaign_id": 2, "channel": "sms", "content": "...",
+  //         "segment": {"level_id": [3], "status": ["活跃"], "spend_bucket": [2, 3], "recency_bucket": [0]}}，
+  // segment 的条件同 /api/member/segment；收件人入队后返回 data.broadcast_id 和 data.total
+  void create(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+  // tenant_id、campaign_id 必填，返回活动下每次群发的 total、sent、failed、pending
+  void progress(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+};
@@ -0,0 +1,85 @@
+#include "CampaignController.h"
+#include "plugins/CampaignScheduler.h"
+#include "plugins/PricingEngine.h"
+
+namespace
+{
+void badRequest(const std::function<void(const HttpResponsePtr &)> &callback, const std::string &message)
+{
+  Json::Value response;
+  response["code"] = k400BadRequest;
+  response["message"] = message;
+  response["data"] = Json::Value::null;
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
+
+// 非负整数参数，为空时返回 0
+bool parseId(const std::string &value, uint32_t &id)
+{
+  id = 0;
+  if (value.empty())
+    return true;
+  if (value.size() > 9 || value.find_first_not_of("0123456789") != std::string::npos)
+    return false;
+  id = static_cast<uint32_t>(std::stoul(value));
+  return true;
+}
+} // namespace
+
+void CampaignController::active(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const
+{
+  uint32_t tenantId = 0;
+  if (!parseId(req->getParameter("tenant_id"), tenantId) || tenantId == 0)
+  {
+    badRequest(callback, "tenant_id 参数错误");
+    return;
+  }
+  uint32_t memberId = 0;
+  uint32_t levelId = 0;
+  if (!parseId(req->getParameter("member_id"), memberId))
+  {
+    badRequest(callback, "member_id 参数错误");
+    return;
+  }
+  if (!parseId(req->getParameter("level_id"), levelId))
+  {
+    badRequest(callback, "level_id 参数错误");
+    return;
+  }
+  if (memberId != 0)
+    levelId = app().getPlugin<PricingEngine>()->levelOf(tenantId, memberId);
+
+  auto at = trantor::Date::now();
+  auto atParam = req->getParameter("at");
+  if (!atParam.empty())
+  {
+    at = trantor::Date::fromDbStringLocal(atParam);
+    if (at.microSecondsSinceEpoch() <= 0)
+    {
+      badRequest(callback, "at 参数错误");
+      return;
+    }
+  }
+
+  Json::Value data;
+  data["level_id"] = levelId;
+  data["campaigns"] = Json::arrayValue;
+  for (const auto &campaign : app().getPlugin<CampaignScheduler>()->activeCampaigns(tenantId, levelId, at.secondsSinceEpoch()))
+  {
+    Json::Value item;
+    item["campaign_id"] = campaign.campaignId;
+    item["campaign_name"] = campaign.name;
+    item["level_id"] = campaign.levelId;
+    item["campaign_start"] = trantor::Date(campaign.start * 1000000).toDbStringLocal();
+    item["campaign_end"] = campaign.end == CampaignSchedule::kOpenEnd
+                               ? Json::Value::null
+                               : Json::Value(trantor::Date(campaign.end * 1000000).toDbStringLocal());
+    data["campaigns"].append(item);
+  }
+
+  Json::Value response;
+  response["code"] = k200OK;
+  response["message"] = "ok";
+  response["data"] = data;
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+using namespace drogon;
+
+class CampaignController : public drogon::HttpController<CampaignController>
+{
+public:
+  METHOD_LIST_BEGIN
+  ADD_METHOD_TO(CampaignController::active, "/api/campaign/active", Get, Options, "AuthFilter"); // 当前有效的营销活动
+  METHOD_LIST_END
+
+  // tenant_id 必填；member_id 或 level_id 指定会员等级，都为空时只返回面向所有等级的活动；
+  // at 为日期时间，默认当前时间
+  void active(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+};
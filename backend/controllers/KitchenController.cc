@@ -0,0 +1,84 @@
+#include "KitchenController.h"
+#include "plugins/KitchenOrders.h"
+
+namespace
+{
+void reply(const std::function<void(const HttpResponsePtr &)> &callback,
+           int code,
+           const std::string &message,
+           const Json::Value &data = Json::Value::null)
+{
+  Json::Value response;
+  response["code"] = code;
+  response["message"] = message;
+  response["data"] = data;
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
+
+// 非负整数参数，为空时返回 0
+bool parseId(const std::string &value, uint32_t &id)
+{
+  id = 0;
+  if (value.empty())
+    return true;
+  if (value.size() > 9 || value.find_first_not_of("0123456789") != std::string::npos)
+    return false;
+  id = static_cast<uint32_t>(std::stoul(value));
+  return true;
+}
+} // namespace
+
+void KitchenController::queue(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const
+{
+  auto plugin = app().getPlugin<KitchenOrders>();
+  uint32_t branchId = 0;
+  uint32_t limit = 0;
+  if (!parseId(req->getParameter("branch_id"), branchId) || branchId == 0)
+  {
+    reply(callback, k400BadRequest, "branch_id 参数错误");
+    return;
+  }
+  if (!parseId(req->getParameter("limit"), limit))
+  {
+    reply(callback, k400BadRequest, "limit 参数错误");
+    return;
+  }
+  Json::Value data;
+  data["branch_id"] = branchId;
+  data["orders"] = plugin->queueOf(branchId, limit == 0 ? plugin->snapshotLimit() : limit);
+  reply(callback, k200OK, "ok", data);
+}
+
+void KitchenController::move(const HttpRequestPtr &req,
+                             std::function<void(const HttpResponsePtr &)> &&callback,
+                             uint32_t orderId) const
+{
+  auto json = req->getJsonObject();
+  OrderFlow::Status to{};
+  if (!json || !json->isObject() || !(*json)["order_status"].isString() ||
+      !OrderFlow::parse((*json)["order_status"].asString(), to))
+  {
+    reply(callback, k400BadRequest, "order_status 参数错误");
+    return;
+  }
+  auto plugin = app().getPlugin<KitchenOrders>();
+  Json::Value data;
+  switch (plugin->move(orderId, to, data))
+  {
+    case KitchenQueue::Move::Moved:
+      reply(callback, k200OK, "ok", data);
+      break;
+    case KitchenQueue::Move::NotFound:
+      reply(callback, k404NotFound, "订单不在厨房队列中");
+      break;
+    case KitchenQueue::Move::Rejected:
+    {
+      std::string from;
+      std::string error;
+      plugin->statusOf(orderId, from);
+      OrderFlow::checkStatus(from, OrderFlow::name(to), error);
+      reply(callback, k400BadRequest, error);
+      break;
+    }
+  }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+using namespace drogon;
+
+class KitchenController : public drogon::HttpController<KitchenController>
+{
+public:
+  METHOD_LIST_BEGIN
+  ADD_METHOD_TO(KitchenController::queue, "/api/kitchen/queue", Get, Options, "AuthFilter");             // 厨房队列
+  ADD_METHOD_TO(KitchenController::move, "/api/kitchen/order/{1}/status", Post, Options, "AuthFilter"); // 推进订单状态
+  METHOD_LIST_END
+
+  // branch_id 必填，limit 默认 snapshot_limit；返回 {branch_id, orders}，orders 按优先级排，只含未完成的订单。
+  // 厨显应连接 /ws/kitchen 接收推送，不必轮询
+  void queue(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+  // 请求体 {"order_status": "制作中"}，按 OrderFlow 校验后立即生效并推送，异步写回 order_table；
+  // 返回推进后的订单，到终态的订单随即移出队列
+  void move(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, uint32_t orderId) const;
+};
@@ -0,0 +1,37 @@
+#include "KitchenWebSocket.h"
+#include "plugins/KitchenOrders.h"
+
+void KitchenWebSocket::handleNewMessage(const WebSocketConnectionPtr &wsConnPtr, std::string &&message, const WebSocketMessageType &type)
+{
+  // 只向厨显推送，状态推进走 /api/kitchen/order/{id}/status
+}
+
+void KitchenWebSocket::handleNewConnection(const HttpRequestPtr &req, const WebSocketConnectionPtr &wsConnPtr)
+{
+  uint32_t branchId = 0;
+  try
+  {
+    branchId = static_cast<uint32_t>(std::stoul(req->getParameter("branch_id")));
+  }
+  catch (const std::exception &)
+  {
+  }
+  if (branchId == 0)
+  {
+    wsConnPtr->shutdown(CloseCode::kInvalidMessage, "branch_id 参数错误");
+    return;
+  }
+
+  // 先订阅再发快照，期间的变化不会漏掉；之后推送 upsert（新增或更新）和 remove（完成、取消或删除）
+  auto kitchen = drogon::app().getPlugin<KitchenOrders>();
+  kitchen->subscribe(branchId, wsConnPtr);
+  Json::Value message;
+  message["type"] = "snapshot";
+  message["data"] = kitchen->queueOf(branchId, kitchen->snapshotLimit());
+  wsConnPtr->send(message.toStyledString());
+}
+
+void KitchenWebSocket::handleConnectionClosed(const WebSocketConnectionPtr &wsConnPtr)
+{
+  drogon::app().getPlugin<KitchenOrders>()->unsubscribe(wsConnPtr);
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <drogon/WebSocketController.h>
+using namespace drogon;
+
+class KitchenWebSocket : public drogon::WebSocketController<KitchenWebSocket>
+{
+public:
+  WS_PATH_LIST_BEGIN
+  WS_PATH_ADD("/ws/kitchen", "AuthFilter"); // 厨房队列推送，参数 branch_id、ticket（/api/ws/ticket 签发）
+  WS_PATH_LIST_END
+
+  void handleNewMessage(const WebSocketConnectionPtr &wsConnPtr, std::string &&message, const WebSocketMessageType &type) override;
+  void handleNewConnection(const HttpRequestPtr &req, const WebSocketConnectionPtr &wsConnPtr) override;
+  void handleConnectionClosed(const WebSocketConnectionPtr &wsConnPtr) override;
+};
@@ -0,0 +1,32 @@
+#include "MenuController.h"
+#include "plugins/MenuSnapshots.h"
+
+namespace
+{
+void badRequest(const std::function<void(const HttpResponsePtr &)> &callback, const std::string &message)
+{
+  Json::Value response;
+  response["code"] = k400BadRequest;
+  response["message"] = message;
+  response["data"] = Json::Value::null;
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
+} // namespace
+
+void MenuController::menu(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const
+{
+  const auto &value = req->getParameter("tenant_id");
+  if (value.empty() || value.size() > 9 || value.find_first_not_of("0123456789") != std::string::npos ||
+      std::stoul(value) == 0)
+  {
+    badRequest(callback, "tenant_id 参数错误");
+    return;
+  }
+  // 快照里已序列化好，响应只引用快照的正文不复制；正文挂在请求上，发送完之前快照不会释放
+  auto body = app().getPlugin<MenuSnapshots>()->menuOf(static_cast<uint32_t>(std::stoul(value)));
+  req->attributes()->insert("menu_body", body);
+  auto resp = HttpResponse::newHttpResponse();
+  resp->setContentTypeCode(CT_APPLICATION_JSON);
+  resp->setBody(body->data(), body->size());
+  callback(resp);
+}
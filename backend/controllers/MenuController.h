@@ -0,0 +1,17 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+using namespace drogon;
+
+class MenuController : public drogon::HttpController<MenuController>
+{
+public:
+  METHOD_LIST_BEGIN
+  ADD_METHOD_TO(MenuController::menu, "/api/menu", Get, Options, "AuthFilter"); // 点餐菜单
+  METHOD_LIST_END
+
+  // tenant_id 必填；返回 {tenant_id, version, built_at, expires_at, categories, others}，
+  // categories 按分类树先序平铺（带 depth、parent_id），各自带本分类上架中的菜品，others 为分类不存在的菜品；
+  // 菜品的 campaign_price 为当前面向所有顾客的单品折扣价，没有时为 null
+  void menu(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+};
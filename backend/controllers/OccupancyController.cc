@@ -0,0 +1,101 @@
+#include "OccupancyController.h"
+#include "plugins/TableOccupancy.h"
+
+namespace
+{
+void reply(const std::function<void(const HttpResponsePtr &)> &callback,
+           int code,
+           const std::string &message,
+           const Json::Value &data = Json::Value::null)
+{
+  Json::Value response;
+  response["code"] = code;
+  response["message"] = message;
+  response["data"] = data;
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
+
+// 取请求体中的桌号，出错时已应答
+bool tableOf(const HttpRequestPtr &req,
+             const std::function<void(const HttpResponsePtr &)> &callback,
+             std::string &table)
+{
+  auto json = req->getJsonObject();
+  if (!json || !json->isObject())
+  {
+    reply(callback, k400BadRequest, "请求体须为 JSON 对象");
+    return false;
+  }
+  const auto &value = (*json)["table_number"];
+  if (!value.isString() || value.asString().empty() || value.asString().size() > OccupancyLog::kMaxTable)
+  {
+    reply(callback, k400BadRequest, "table_number 须为不超过 36 字节的非空字符串");
+    return false;
+  }
+  table = value.asString();
+  return true;
+}
+
+TableOccupancy::Callback replyLogged(std::function<void(const HttpResponsePtr &)> &&callback)
+{
+  auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
+  return [callbackPtr](bool logged)
+  {
+    if (logged)
+      reply(*callbackPtr, k200OK, "ok");
+    else
+      reply(*callbackPtr, k500InternalServerError, "占用日志写入失败");
+  };
+}
+} // namespace
+
+void OccupancyController::occupancy(const HttpRequestPtr &req,
+                                    std::function<void(const HttpResponsePtr &)> &&callback,
+                                    uint32_t branchId) const
+{
+  Json::Value data;
+  if (!app().getPlugin<TableOccupancy>()->occupancyOf(branchId, req->getParameter("tables") == "1", data))
+  {
+    reply(callback, k404NotFound, "branch not found");
+    return;
+  }
+  reply(callback, k200OK, "ok", data);
+}
+
+void OccupancyController::seat(const HttpRequestPtr &req,
+                               std::function<void(const HttpResponsePtr &)> &&callback,
+                               uint32_t branchId) const
+{
+  std::string table;
+  if (!tableOf(req, callback, table))
+    return;
+  const auto &covers = (*req->getJsonObject())["covers"];
+  if (!covers.isUInt() || covers.asUInt() == 0 || covers.asUInt() > 65535)
+  {
+    reply(callback, k400BadRequest, "covers 须为正整数");
+    return;
+  }
+  auto plugin = app().getPlugin<TableOccupancy>();
+  if (!plugin->hasBranch(branchId))
+  {
+    reply(callback, k404NotFound, "branch not found");
+    return;
+  }
+  plugin->seat(branchId, table, static_cast<uint16_t>(covers.asUInt()), replyLogged(std::move(callback)));
+}
+
+void OccupancyController::clear(const HttpRequestPtr &req,
+                                std::function<void(const HttpResponsePtr &)> &&callback,
+                                uint32_t branchId) const
+{
+  std::string table;
+  if (!tableOf(req, callback, table))
+    return;
+  auto plugin = app().getPlugin<TableOccupancy>();
+  if (!plugin->hasBranch(branchId))
+  {
+    reply(callback, k404NotFound, "branch not found");
+    return;
+  }
+  plugin->clear(branchId, table, replyLogged(std::move(callback)));
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+using namespace drogon;
+
+class OccupancyController : public drogon::HttpController<OccupancyController>
+{
+public:
+  METHOD_LIST_BEGIN
+  ADD_METHOD_TO(OccupancyController::occupancy, "/api/branch/{1}/occupancy", Get, Options, "AuthFilter");    // 分店桌台占用
+  ADD_METHOD_TO(OccupancyController::seat, "/api/branch/{1}/occupancy/seat", Post, Options, "AuthFilter");   // 手工入座
+  ADD_METHOD_TO(OccupancyController::clear, "/api/branch/{1}/occupancy/clear", Post, Options, "AuthFilter"); // 清台
+  METHOD_LIST_END
+
+  // 返回 {branch_id, capacity, covers, available, tables_occupied}；tables=1 时带 tables（各桌人数、入座时刻、订单）
+  void occupancy(const HttpRequestPtr &req,
+                 std::function<void(const HttpResponsePtr &)> &&callback,
+                 uint32_t branchId) const;
+  // 请求体 {"table_number": "A3", "covers": 4}，桌上已有客时改为 covers 位；手工入座的桌须手工清台
+  void seat(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, uint32_t branchId) const;
+  // 请求体 {"table_number": "A3"}，连同桌上的订单一起离桌
+  void clear(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, uint32_t branchId) const;
+};
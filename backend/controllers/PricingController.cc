@@ -0,0 +1,94 @@
+#include "PricingController.h"
+#include "plugins/PricingEngine.h"
+#include "plugins/VoucherEngine.h"
+
+namespace
+{
+void badRequest(const std::function<void(const HttpResponsePtr &)> &callback,
+                const std::string &message,
+                const Json::Value &data = Json::Value::null)
+{
+  Json::Value response;
+  response["code"] = k400BadRequest;
+  response["message"] = message;
+  response["data"] = data;
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
+} // namespace
+
+void PricingController::quote(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const
+{
+  auto json = req->getJsonObject();
+  if (!json || !json->isObject())
+  {
+    badRequest(callback, "请求体须为 JSON 对象");
+    return;
+  }
+  if (!(*json)["tenant_id"].isUInt())
+  {
+    badRequest(callback, "tenant_id 参数错误");
+    return;
+  }
+  const auto &memberParam = (*json)["member_id"];
+  if (!memberParam.isNull() && !memberParam.isUInt())
+  {
+    badRequest(callback, "member_id 参数错误");
+    return;
+  }
+  auto pricing = app().getPlugin<PricingEngine>();
+  if (!memberParam.isNull() && !pricing->hasMember((*json)["tenant_id"].asUInt(), memberParam.asUInt()))
+  {
+    badRequest(callback, "会员不存在");
+    return;
+  }
+  const auto &branchParam = (*json)["branch_id"];
+  if (!branchParam.isNull() && !branchParam.isUInt())
+  {
+    badRequest(callback, "branch_id 参数错误");
+    return;
+  }
+  std::vector<PricingRules::Line> lines;
+  if (!PricingRules::linesFromJson((*json)["items"], lines))
+  {
+    badRequest(callback, "items 参数错误");
+    return;
+  }
+  // 试算只校验券，不占用
+  uint32_t voucherCampaignId = 0;
+  const auto &voucherParam = (*json)["voucher_code"];
+  if (!voucherParam.isNull() && !voucherParam.isString())
+  {
+    badRequest(callback, "voucher_code 参数错误");
+    return;
+  }
+  if (voucherParam.isString() && !voucherParam.asString().empty())
+  {
+    auto result = app().getPlugin<VoucherEngine>()->check((*json)["tenant_id"].asUInt(),
+                                                          voucherParam.asString(),
+                                                          voucherCampaignId);
+    if (result != VoucherEngine::Redeem::Ok)
+    {
+      badRequest(callback, VoucherEngine::describe(result));
+      return;
+    }
+  }
+
+  PricingRules::Quote quote;
+  bool ok = pricing->quote((*json)["tenant_id"].asUInt(),
+                           branchParam.isNull() ? 0 : branchParam.asUInt(),
+                           memberParam.isNull() ? 0 : memberParam.asUInt(),
+                           lines,
+                           quote,
+                           voucherCampaignId);
+  if (!ok)
+  {
+    badRequest(callback, "存在不可售菜品", PricingRules::toJson(quote));
+    return;
+  }
+
+  Json::Value response;
+  response["code"] = k200OK;
+  response["message"] = "ok";
+  response["data"] = PricingRules::toJson(quote);
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
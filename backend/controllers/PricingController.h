@@ -0,0 +1,18 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+using namespace drogon;
+
+class PricingController : public drogon::HttpController<PricingController>
+{
+public:
+  METHOD_LIST_BEGIN
+  ADD_METHOD_TO(PricingController::quote, "/api/order/quote", Post, Options, "AuthFilter"); // 订单试算
+  METHOD_LIST_END
+
+  // 请求体 {"tenant_id": 1, "branch_id": 2, "member_id": 3, "voucher_code": "...", "items": [{"dish_id": 1, "quantity": 2}]}，
+  // branch_id、member_id、voucher_code 可省略，指定分店时按分店售价和销售状态计价；
+  // member_id 不是本租户的会员、或券不可用时 code 为 400；
+  // 返回逐行金额、命中的活动和优惠合计，金额均为字符串。有不可售菜品时 code 为 400，data.unavailable 列出菜品ID
+  void quote(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+};
@@ -0,0 +1,171 @@
+#include "ProfileController.h"
+#include "plugins/MemberSummaries.h"
+#include "ConsumptionRecord.h"
+#include "Member.h"
+#include "MemberLevel.h"
+#include <drogon/orm/Mapper.h>
+#include <atomic>
+#include <mutex>
+
+using namespace drogon::orm;
+using namespace drogon_model::saas_restaurant;
+
+namespace
+{
+constexpr uint64_t kDefaultLimit = 20;
+constexpr uint64_t kMaxLimit = 100;
+
+void reply(const std::function<void(const HttpResponsePtr &)> &callback,
+           int code,
+           const std::string &message,
+           const Json::Value &data = Json::Value::null)
+{
+  Json::Value response;
+  response["code"] = code;
+  response["message"] = message;
+  response["data"] = data;
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
+
+// 非负整数参数，为空时取 fallback
+bool parseNumber(const std::string &value, uint64_t fallback, uint64_t &number)
+{
+  number = fallback;
+  if (value.empty())
+    return true;
+  if (value.size() > 9 || value.find_first_not_of("0123456789") != std::string::npos)
+    return false;
+  number = std::stoull(value);
+  return true;
+}
+
+// 等级、消费记录、汇总三部分并行读取，全部完成后应答；任一部分出错只应答一次
+struct Profile
+{
+  std::function<void(const HttpResponsePtr &)> callback;
+  std::mutex mutex;
+  Json::Value data;
+  std::atomic<int> remaining{3};
+  std::atomic<bool> failed{false};
+
+  void done()
+  {
+    if (--remaining == 0 && !failed)
+      reply(callback, k200OK, "ok", data);
+  }
+  void fail(const DrogonDbException &e)
+  {
+    LOG_ERROR << e.base().what();
+    if (!failed.exchange(true))
+      reply(callback, k500InternalServerError, "database error");
+  }
+};
+} // namespace
+
+void ProfileController::profile(const HttpRequestPtr &req,
+                                std::function<void(const HttpResponsePtr &)> &&callback,
+                                uint32_t memberId) const
+{
+  uint64_t offset = 0;
+  uint64_t limit = 0;
+  if (!parseNumber(req->getParameter("offset"), 0, offset) ||
+      !parseNumber(req->getParameter("limit"), kDefaultLimit, limit) || limit == 0 || limit > kMaxLimit)
+  {
+    reply(callback, k400BadRequest, "offset 或 limit 参数错误");
+    return;
+  }
+
+  auto profile = std::make_shared<Profile>();
+  profile->callback = std::move(callback);
+  auto dbClient = app().getDbClient();
+  Mapper<Member> members(dbClient);
+  members.findByPrimaryKey(
+      memberId,
+      [profile, dbClient, memberId, offset, limit](Member member)
+      {
+        if (member.getValueOfIsDeleted() != 0 || !member.getTenantId())
+        {
+          reply(profile->callback, k404NotFound, "not found");
+          return;
+        }
+        auto tenantId = member.getValueOfTenantId();
+        auto json = member.toJson();
+        json.removeMember(Member::Cols::_password);
+        profile->data["member"] = json;
+        profile->data["level"] = Json::Value::null;
+        profile->data["history"]["offset"] = static_cast<Json::UInt64>(offset);
+        profile->data["history"]["limit"] = static_cast<Json::UInt64>(limit);
+        profile->data["history"]["records"] = Json::arrayValue;
+
+        if (member.getLevelId())
+        {
+          Mapper<MemberLevel> levels(dbClient);
+          levels.findByPrimaryKey(
+              member.getValueOfLevelId(),
+              [profile](MemberLevel level)
+              {
+                {
+                  std::lock_guard<std::mutex> lock(profile->mutex);
+                  profile->data["level"] = level.toJson();
+                }
+                profile->done();
+              },
+              [profile](const DrogonDbException &e)
+              {
+                // 等级已被删除时按无等级返回
+                if (dynamic_cast<const UnexpectedRows *>(&e.base()))
+                {
+                  profile->done();
+                  return;
+                }
+                profile->fail(e);
+              });
+        }
+        else
+        {
+          profile->done();
+        }
+
+        // 带上租户条件以使用 (tenant_id, member_id, record_id) 索引，只读当前一页
+        Mapper<ConsumptionRecord> records(dbClient);
+        records.orderBy(ConsumptionRecord::Cols::_record_id, SortOrder::DESC)
+            .limit(static_cast<size_t>(limit))
+            .offset(static_cast<size_t>(offset))
+            .findBy(
+                Criteria(ConsumptionRecord::Cols::_tenant_id, CompareOperator::EQ, tenantId) &&
+                    Criteria(ConsumptionRecord::Cols::_member_id, CompareOperator::EQ, memberId),
+                [profile](const std::vector<ConsumptionRecord> &rows)
+                {
+                  {
+                    std::lock_guard<std::mutex> lock(profile->mutex);
+                    auto &list = profile->data["history"]["records"];
+                    for (const auto &row : rows)
+                      list.append(row.toJson());
+                  }
+                  profile->done();
+                },
+                [profile](const DrogonDbException &e) { profile->fail(e); });
+
+        app().getPlugin<MemberSummaries>()->summaryOf(
+            tenantId,
+            memberId,
+            [profile](const SummaryCache::Summary &summary)
+            {
+              {
+                std::lock_guard<std::mutex> lock(profile->mutex);
+                profile->data["summary"] = MemberSummaries::toJson(summary);
+              }
+              profile->done();
+            },
+            [profile](const DrogonDbException &e) { profile->fail(e); });
+      },
+      [profile](const DrogonDbException &e)
+      {
+        if (dynamic_cast<const UnexpectedRows *>(&e.base()))
+        {
+          reply(profile->callback, k404NotFound, "not found");
+          return;
+        }
+        profile->fail(e);
+      });
+}
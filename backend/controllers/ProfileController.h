@@ -0,0 +1,18 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+using namespace drogon;
+
+class ProfileController : public drogon::HttpController<ProfileController>
+{
+public:
+  METHOD_LIST_BEGIN
+  ADD_METHOD_TO(ProfileController::profile, "/api/member/{1}/profile", Get, Options, "AuthFilter"); // 会员档案
+  METHOD_LIST_END
+
+  // 一次返回会员（不含密码）、所属等级、按时间倒序从 offset 起最多 limit 条消费记录（默认 20，最多 100）
+  // 和消费汇总 {orders, total_amount, avg_amount, points_earned, first_at, last_at}；会员不存在或已删除时 code 为 404
+  void profile(const HttpRequestPtr &req,
+               std::function<void(const HttpResponsePtr &)> &&callback,
+               uint32_t memberId) const;
+};
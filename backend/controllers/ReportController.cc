@@ -0,0 +1,411 @@
+#include "ReportController.h"
+#include "plugins/ReportSketches.h"
+#include <cmath>
+#include <map>
+
+using namespace drogon::orm;
+
+namespace
+{
+struct ReportRange
+{
+  uint32_t tenantId{0};
+  uint32_t branchId{0};
+  trantor::Date from; // 含
+  trantor::Date to;   // 不含
+};
+
+void badRequest(const std::function<void(const HttpResponsePtr &)> &callback, const std::string &message)
+{
+  Json::Value response;
+  response["code"] = k400BadRequest;
+  response["message"] = message;
+  response["data"] = Json::Value::null;
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
+
+void dbError(const std::function<void(const HttpResponsePtr &)> &callback, const DrogonDbException &e)
+{
+  LOG_ERROR << e.base().what();
+  Json::Value response;
+  response["code"] = k500InternalServerError;
+  response["message"] = "database error";
+  response["data"] = Json::Value::null;
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
+
+void ok(const std::function<void(const HttpResponsePtr &)> &callback, Json::Value data)
+{
+  Json::Value response;
+  response["code"] = k200OK;
+  response["message"] = "ok";
+  response["data"] = std::move(data);
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
+
+bool parseRange(const HttpRequestPtr &req, ReportRange &range, std::string &err)
+{
+  try
+  {
+    auto tenantParam = req->getParameter("tenant_id");
+    if (!tenantParam.empty())
+      range.tenantId = static_cast<uint32_t>(std::stoul(tenantParam));
+  }
+  catch (const std::exception &)
+  {
+    err = "tenant_id 参数错误";
+    return false;
+  }
+  try
+  {
+    auto branchParam = req->getParameter("branch_id");
+    if (!branchParam.empty())
+      range.branchId = static_cast<uint32_t>(std::stoul(branchParam));
+  }
+  catch (const std::exception &)
+  {
+    err = "branch_id 参数错误";
+    return false;
+  }
+
+  auto toParam = req->getParameter("to");
+  auto fromParam = req->getParameter("from");
+  auto to = toParam.empty() ? trantor::Date::now() : trantor::Date::fromDbStringLocal(toParam);
+  if (to.microSecondsSinceEpoch() == 0)
+  {
+    err = "to 参数错误";
+    return false;
+  }
+  range.to = to.roundDay().after(86400.0);
+  range.from = fromParam.empty() ? range.to.after(-86400.0 * 7) : trantor::Date::fromDbStringLocal(fromParam).roundDay();
+  if (range.from.microSecondsSinceEpoch() <= 0 || range.from.microSecondsSinceEpoch() >= range.to.microSecondsSinceEpoch())
+  {
+    err = "from 参数错误";
+    return false;
+  }
+  return true;
+}
+
+// 汇总表的公共过滤条件
+std::string rangeCondition(const ReportRange &range)
+{
+  std::string condition = " where branch_id = ? and granularity = ? and bucket_start >= ? and bucket_start < ?";
+  if (range.tenantId != 0)
+    condition += " and tenant_id = ?";
+  return condition;
+}
+
+void bindRange(internal::SqlBinder &binder, const ReportRange &range, const std::string &granularity)
+{
+  binder << range.branchId << granularity << range.from.toDbStringLocal() << range.to.toDbStringLocal();
+  if (range.tenantId != 0)
+    binder << range.tenantId;
+}
+
+std::string dayOf(const trantor::Date &at)
+{
+  return at.toDbStringLocal().substr(0, 10);
+}
+
+double averageOf(double revenue, int64_t orders)
+{
+  return orders == 0 ? 0.0 : std::round(revenue / orders * 100) / 100;
+}
+} // namespace
+
+void ReportController::getSummary(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const
+{
+  ReportRange range;
+  std::string err;
+  if (!parseRange(req, range, err))
+  {
+    badRequest(callback, err);
+    return;
+  }
+
+  // 按天桶求和，客流为各天去重客流之和
+  auto dbClient = drogon::app().getDbClient();
+  auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
+  auto binder = *dbClient << "select coalesce(sum(revenue), 0) as revenue, coalesce(sum(order_count), 0) as orders, "
+                             "coalesce(sum(customer_count), 0) as customers from report_rollup" +
+                                 rangeCondition(range);
+  bindRange(binder, range, "day");
+  binder >> [dbClient, callbackPtr, range](const Result &r)
+  {
+    Json::Value data;
+    auto revenue = r[0]["revenue"].as<double>();
+    auto orders = r[0]["orders"].as<int64_t>();
+    data["revenue"] = revenue;
+    data["orders"] = (Json::Int64)orders;
+    data["customers"] = (Json::Int64)r[0]["customers"].as<int64_t>();
+    data["avg_order_value"] = averageOf(revenue, orders);
+
+    std::string sql = "select count(*) as count from member where created_at >= ? and created_at < ? "
+                      "and (is_deleted = 0 or is_deleted is null)";
+    if (range.tenantId != 0)
+      sql += " and tenant_id = ?";
+    auto memberBinder = *dbClient << std::move(sql);
+    memberBinder << range.from.toDbStringLocal() << range.to.toDbStringLocal();
+    if (range.tenantId != 0)
+      memberBinder << range.tenantId;
+    memberBinder >> [callbackPtr, data](const Result &members) mutable
+    {
+      data["new_members"] = (Json::Int64)members[0]["count"].as<int64_t>();
+      ok(*callbackPtr, std::move(data));
+    };
+    memberBinder >> [callbackPtr](const DrogonDbException &e) { dbError(*callbackPtr, e); };
+  };
+  binder >> [callbackPtr](const DrogonDbException &e) { dbError(*callbackPtr, e); };
+}
+
+void ReportController::getTrend(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const
+{
+  ReportRange range;
+  std::string err;
+  if (!parseRange(req, range, err))
+  {
+    badRequest(callback, err);
+    return;
+  }
+  auto granularity = req->getParameter("granularity");
+  if (granularity.empty())
+    granularity = "day";
+  if (granularity != "day" && granularity != "hour")
+  {
+    badRequest(callback, "granularity 参数错误");
+    return;
+  }
+  double step = granularity == "day" ? 86400.0 : 3600.0;
+  auto buckets = (range.to.microSecondsSinceEpoch() - range.from.microSecondsSinceEpoch()) / (int64_t)(step * 1000000);
+  if (buckets > 2000)
+  {
+    badRequest(callback, "时间范围过大");
+    return;
+  }
+
+  auto dbClient = drogon::app().getDbClient();
+  auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
+  auto binder = *dbClient << "select bucket_start, sum(revenue) as revenue, sum(order_count) as orders, "
+                             "sum(customer_count) as customers from report_rollup" +
+                                 rangeCondition(range) + " group by bucket_start";
+  bindRange(binder, range, granularity);
+  binder >> [callbackPtr, range, step](const Result &r)
+  {
+    std::map<std::string, Result::SizeType> rows;
+    for (Result::SizeType i = 0; i < r.size(); ++i)
+      rows.emplace(r[i]["bucket_start"].as<std::string>(), i);
+
+    Json::Value data(Json::arrayValue);
+    for (auto at = range.from; at.microSecondsSinceEpoch() < range.to.microSecondsSinceEpoch(); at = at.after(step))
+    {
+      auto bucket = at.toDbStringLocal();
+      Json::Value item;
+      item["bucket"] = bucket;
+      double revenue = 0;
+      int64_t orders = 0;
+      int64_t customers = 0;
+      auto it = rows.find(bucket);
+      if (it != rows.end())
+      {
+        auto row = r[it->second];
+        revenue = row["revenue"].as<double>();
+        orders = row["orders"].as<int64_t>();
+        customers = row["customers"].as<int64_t>();
+      }
+      item["revenue"] = revenue;
+      item["orders"] = (Json::Int64)orders;
+      item["customers"] = (Json::Int64)customers;
+      item["avg_order_value"] = averageOf(revenue, orders);
+      data.append(item);
+    }
+    ok(*callbackPtr, std::move(data));
+  };
+  binder >> [callbackPtr](const DrogonDbException &e) { dbError(*callbackPtr, e); };
+}
+
+void ReportController::getCategory(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const
+{
+  ReportRange range;
+  std::string err;
+  if (!parseRange(req, range, err))
+  {
+    badRequest(callback, err);
+    return;
+  }
+
+  auto dbClient = drogon::app().getDbClient();
+  auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
+  auto binder = *dbClient << "select r.category_id, c.category_name, sum(r.quantity) as quantity, sum(r.revenue) as revenue "
+                             "from (select category_id, quantity, revenue from report_category_rollup" +
+                                 rangeCondition(range) +
+                                 ") r left join dish_category c on c.category_id = r.category_id "
+                                 "group by r.category_id, c.category_name order by revenue desc";
+  bindRange(binder, range, "day");
+  binder >> [callbackPtr](const Result &r)
+  {
+    double total = 0;
+    for (const auto &row : r)
+      total += row["revenue"].as<double>();
+    Json::Value data(Json::arrayValue);
+    for (const auto &row : r)
+    {
+      Json::Value item;
+      auto revenue = row["revenue"].as<double>();
+      item["category_id"] = row["category_id"].as<uint32_t>();
+      item["category_name"] = row["category_name"].isNull() ? "未分类" : row["category_name"].as<std::string>();
+      item["quantity"] = (Json::Int64)row["quantity"].as<int64_t>();
+      item["revenue"] = revenue;
+      item["share"] = total > 0 ? std::round(revenue / total * 1000) / 10 : 0.0;
+      data.append(item);
+    }
+    ok(*callbackPtr, std::move(data));
+  };
+  binder >> [callbackPtr](const DrogonDbException &e) { dbError(*callbackPtr, e); };
+}
+
+void ReportController::getMembership(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const
+{
+  ReportRange range;
+  std::string err;
+  if (!parseRange(req, range, err))
+  {
+    badRequest(callback, err);
+    return;
+  }
+
+  // 会员表规模远小于订单表，直接分组计数
+  std::string sql = "select m.level_id, l.level_name, count(*) as count from member m "
+                    "left join member_level l on l.level_id = m.level_id "
+                    "where (m.is_deleted = 0 or m.is_deleted is null)";
+  if (range.tenantId != 0)
+    sql += " and m.tenant_id = ?";
+  sql += " group by m.level_id, l.level_name order by m.level_id";
+  auto dbClient = drogon::app().getDbClient();
+  auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
+  auto binder = *dbClient << std::move(sql);
+  if (range.tenantId != 0)
+    binder << range.tenantId;
+  binder >> [callbackPtr](const Result &r)
+  {
+    Json::Value data(Json::arrayValue);
+    for (const auto &row : r)
+    {
+      Json::Value item;
+      item["level_id"] = row["level_id"].isNull() ? 0 : row["level_id"].as<uint32_t>();
+      item["level_name"] = row["level_name"].isNull() ? "无等级" : row["level_name"].as<std::string>();
+      item["count"] = (Json::Int64)row["count"].as<int64_t>();
+      data.append(item);
+    }
+    ok(*callbackPtr, std::move(data));
+  };
+  binder >> [callbackPtr](const DrogonDbException &e) { dbError(*callbackPtr, e); };
+}
+
+void ReportController::getCustomers(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const
+{
+  ReportRange range;
+  std::string err;
+  if (!parseRange(req, range, err))
+  {
+    badRequest(callback, err);
+    return;
+  }
+
+  auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
+  drogon::app().getPlugin<ReportSketches>()->summarize(
+      range.tenantId,
+      range.branchId,
+      dayOf(range.from),
+      dayOf(range.to),
+      [callbackPtr, range](const ReportSketches::Summary &summary)
+      {
+        Json::Value days(Json::arrayValue);
+        for (auto at = range.from; at.microSecondsSinceEpoch() < range.to.microSecondsSinceEpoch(); at = at.after(86400.0))
+        {
+          auto day = dayOf(at);
+          auto it = summary.days.find(day);
+          Json::Value item;
+          item["date"] = day;
+          item["customers"] = it == summary.days.end() ? 0.0 : std::round(it->second.estimate());
+          days.append(item);
+        }
+        Json::Value data;
+        data["days"] = days;
+        data["customers"] = std::round(summary.customers.estimate());
+        data["standard_error"] = std::round(HyperLogLog::standardError() * 10000) / 10000;
+        ok(*callbackPtr, std::move(data));
+      },
+      [callbackPtr](const DrogonDbException &e) { dbError(*callbackPtr, e); });
+}
+
+void ReportController::getTopDishes(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const
+{
+  ReportRange range;
+  std::string err;
+  if (!parseRange(req, range, err))
+  {
+    badRequest(callback, err);
+    return;
+  }
+  size_t limit = 10;
+  try
+  {
+    auto limitParam = req->getParameter("limit");
+    if (!limitParam.empty())
+      limit = std::stoul(limitParam);
+  }
+  catch (const std::exception &)
+  {
+    badRequest(callback, "limit 参数错误");
+    return;
+  }
+
+  auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
+  drogon::app().getPlugin<ReportSketches>()->summarize(
+      range.tenantId,
+      range.branchId,
+      dayOf(range.from),
+      dayOf(range.to),
+      [callbackPtr, limit](const ReportSketches::Summary &summary)
+      {
+        auto top = summary.dishes.top(limit);
+        Json::Value data;
+        data["total"] = (Json::UInt64)summary.dishes.total();
+        data["max_error"] = (Json::UInt64)summary.dishes.maxError();
+        data["items"] = Json::Value(Json::arrayValue);
+        if (top.empty())
+        {
+          ok(*callbackPtr, std::move(data));
+          return;
+        }
+
+        // 补上菜品名称
+        std::string sql = "select dish_id, dish_name from dish where dish_id in (";
+        for (size_t i = 0; i < top.size(); ++i)
+          sql += i == 0 ? "?" : ", ?";
+        sql += ")";
+        auto dbClient = drogon::app().getDbClient();
+        auto binder = *dbClient << std::move(sql);
+        for (const auto &counter : top)
+          binder << counter.key;
+        binder >> [callbackPtr, top, data](const Result &r) mutable
+        {
+          std::map<uint32_t, std::string> names;
+          for (const auto &row : r)
+            names[row["dish_id"].as<uint32_t>()] = row["dish_name"].isNull() ? "" : row["dish_name"].as<std::string>();
+          for (const auto &counter : top)
+          {
+            Json::Value item;
+            item["dish_id"] = counter.key;
+            item["dish_name"] = names.count(counter.key) ? names[counter.key] : "已删除菜品";
+            item["count"] = (Json::UInt64)counter.count;
+            item["error"] = (Json::UInt64)counter.error;
+            item["lower_bound"] = (Json::UInt64)(counter.count - counter.error);
+            data["items"].append(item);
+          }
+          ok(*callbackPtr, std::move(data));
+        };
+        binder >> [callbackPtr](const DrogonDbException &e) { dbError(*callbackPtr, e); };
+      },
+      [callbackPtr](const DrogonDbException &e) { dbError(*callbackPtr, e); });
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+using namespace drogon;
+
+class ReportController : public drogon::HttpController<ReportController>
+{
+public:
+  METHOD_LIST_BEGIN
+  ADD_METHOD_TO(ReportController::getSummary, "/api/report/summary", Get, Options, "AuthFilter");       // 汇总指标
+  ADD_METHOD_TO(ReportController::getTrend, "/api/report/trend", Get, Options, "AuthFilter");           // 营收趋势
+  ADD_METHOD_TO(ReportController::getCategory, "/api/report/category", Get, Options, "AuthFilter");     // 品类构成
+  ADD_METHOD_TO(ReportController::getMembership, "/api/report/membership", Get, Options, "AuthFilter"); // 会员等级分布
+  ADD_METHOD_TO(ReportController::getCustomers, "/api/report/customers", Get, Options, "AuthFilter");     // 去重顾客（近似）
+  ADD_METHOD_TO(ReportController::getTopDishes, "/api/report/topdishes", Get, Options, "AuthFilter");     // 热销菜品（近似）
+  METHOD_LIST_END
+
+  // 公共参数：tenant_id 为空或 0 时汇总全部租户；branch_id 为空或 0 时为全租户；
+  // from、to 为日期（含），默认最近 7 天
+  void getSummary(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+  // granularity 可选 day、hour，默认 day；没有订单的时间桶补 0
+  void getTrend(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+  void getCategory(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+  void getMembership(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+  // 按天合并 HyperLogLog 草图，standard_error 为估计值的相对标准误差
+  void getCustomers(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+  // limit 默认 10；每项计数不小于真实份数，高估不超过 error，count - error 为真实份数下界
+  void getTopDishes(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+};
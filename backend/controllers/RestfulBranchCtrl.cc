@@ -6,6 +6,7 @@
  */
 
 #include "RestfulBranchCtrl.h"
+#include "plugins/OpeningHours.h"
 #include <string>
 
 
@@ -43,3 +44,14 @@ void RestfulBranchCtrl::create(const HttpRequestPtr &req,
 {
     RestfulBranchCtrlBase::create(req, std::move(callback));
 }
+
+bool RestfulBranchCtrl::doCustomValidations(const Json::Value &pJson, std::string &err)
+{
+    // 为空表示未设置
+    const auto &openingHours = pJson["opening_hours"];
+    if (openingHours.isNull() || !openingHours.isString() ||
+        openingHours.asString().find_first_not_of(" \t\r\n") == std::string::npos)
+        return true;
+    OpeningHours hours;
+    return OpeningHours::parse(openingHours.asString(), hours, err);
+}
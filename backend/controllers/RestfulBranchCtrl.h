@@ -43,4 +43,8 @@ public:
            std::function<void(const HttpResponsePtr &)> &&callback);
   void create(const HttpRequestPtr &req,
               std::function<void(const HttpResponsePtr &)> &&callback);
+
+protected:
+  // opening_hours 须能解析，见 OpeningHours
+  bool doCustomValidations(const Json::Value &pJson, std::string &err) override;
 };
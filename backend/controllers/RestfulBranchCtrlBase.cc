@@ -7,6 +7,9 @@
  */
 
 #include "RestfulBranchCtrlBase.h"
+#include "BranchMenus.h"
+#include "BranchSchedules.h"
+#include "TableOccupancy.h"
 #include <string>
 
 void RestfulBranchCtrlBase::getOne(const HttpRequestPtr &req,
@@ -126,10 +129,13 @@ void RestfulBranchCtrlBase::updateOne(const HttpRequestPtr &req,
 
     mapper.update(
         object,
-        [callbackPtr](const size_t count)
+        [callbackPtr, id](const size_t count)
         {
             if (count == 1)
             {
+                drogon::app().getPlugin<BranchMenus>()->branchChanged(id);
+                drogon::app().getPlugin<BranchSchedules>()->branchChanged(id);
+                drogon::app().getPlugin<TableOccupancy>()->branchChanged(id);
                 Json::Value ret;
                 ret["code"] = k200OK;
                 ret["message"] = "ok";
@@ -177,10 +183,13 @@ void RestfulBranchCtrlBase::deleteOne(const HttpRequestPtr &req,
     drogon::orm::Mapper<Branch> mapper(dbClientPtr);
     mapper.deleteByPrimaryKey(
         id,
-        [callbackPtr](const size_t count)
+        [callbackPtr, id](const size_t count)
         {
             if (count == 1)
             {
+                drogon::app().getPlugin<BranchMenus>()->branchChanged(id);
+                drogon::app().getPlugin<BranchSchedules>()->branchChanged(id);
+                drogon::app().getPlugin<TableOccupancy>()->branchChanged(id);
                 auto resp = HttpResponse::newHttpResponse();
                 resp->setStatusCode(k204NoContent);
                 (*callbackPtr)(resp);
@@ -403,6 +412,9 @@ void RestfulBranchCtrlBase::create(const HttpRequestPtr &req,
             object,
             [req, callbackPtr, this](Branch newObject)
             {
+                drogon::app().getPlugin<BranchMenus>()->branchChanged(newObject.getPrimaryKey());
+                drogon::app().getPlugin<BranchSchedules>()->branchChanged(newObject.getPrimaryKey());
+                drogon::app().getPlugin<TableOccupancy>()->branchChanged(newObject.getPrimaryKey());
                 Json::Value ret;
                 ret["code"] = k200OK;
                 ret["message"] = "ok";
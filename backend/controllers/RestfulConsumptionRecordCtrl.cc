@@ -6,6 +6,7 @@
  */
 
 #include "RestfulConsumptionRecordCtrl.h"
+#include "plugins/Money.h"
 #include <string>
 
 void RestfulConsumptionRecordCtrl::getOne(const HttpRequestPtr &req,
@@ -47,3 +48,8 @@ void RestfulConsumptionRecordCtrl::create(const HttpRequestPtr &req,
 {
     RestfulConsumptionRecordCtrlBase::create(req, std::move(callback));
 }
+
+bool RestfulConsumptionRecordCtrl::doCustomValidations(const Json::Value &pJson, std::string &err)
+{
+    return Money::checkFields(pJson, {"amount"}, err);
+}
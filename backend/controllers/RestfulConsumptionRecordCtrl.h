@@ -48,4 +48,8 @@ public:
            std::function<void(const HttpResponsePtr &)> &&callback);
   void create(const HttpRequestPtr &req,
               std::function<void(const HttpResponsePtr &)> &&callback);
+
+protected:
+  // amount 须为十进制数
+  bool doCustomValidations(const Json::Value &pJson, std::string &err) override;
 };
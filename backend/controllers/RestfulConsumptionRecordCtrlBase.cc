@@ -7,6 +7,12 @@
  */
 
 #include "RestfulConsumptionRecordCtrlBase.h"
+#include "MemberLevels.h"
+#include "MemberRfm.h"
+#include "MemberSegments.h"
+#include "MemberSummaries.h"
+#include "ReportSketches.h"
+#include <atomic>
 #include <string>
 
 void RestfulConsumptionRecordCtrlBase::getOne(const HttpRequestPtr &req,
@@ -50,30 +56,46 @@ void RestfulConsumptionRecordCtrlBase::getOneByMemberId(const HttpRequestPtr &re
 {
 
     auto dbClientPtr = getDbClient();
+    auto callbackPtr =
+        std::make_shared<std::function<void(const HttpResponsePtr &)>>(
+            std::move(callback));
     drogon::orm::Mapper<ConsumptionRecord> mapper(dbClientPtr);
     auto criteria = drogon::orm::Criteria(ConsumptionRecord::Cols::_member_id, drogon::orm::CompareOperator::EQ, id);
-    std::vector<ConsumptionRecord> records = mapper.findBy(criteria);
-
-    Json::Value ret;
-    if (records.empty())
-    {
-        ret["code"] = k404NotFound;
-        ret["message"] = "not found";
-        auto resp = HttpResponse::newHttpJsonResponse(ret);
-        callback(resp);
-        return;
-    }
-    Json::Value list;
-    list.resize(0);
-    ret["code"] = k200OK;
-    ret["message"] = "ok";
-    for (auto &obj : records)
-    {
-        list.append(makeJson(req, obj));
-    }
-    ret["data"] = list;
-    auto resp = HttpResponse::newHttpJsonResponse(ret);
-    callback(resp);
+    // 异步查询，不阻塞事件循环；前台会员页请使用 /api/member/{id}/profile 分页读取
+    mapper.findBy(
+        criteria,
+        [req, callbackPtr, this](const std::vector<ConsumptionRecord> &records)
+        {
+            Json::Value ret;
+            if (records.empty())
+            {
+                ret["code"] = k404NotFound;
+                ret["message"] = "not found";
+                auto resp = HttpResponse::newHttpJsonResponse(ret);
+                (*callbackPtr)(resp);
+                return;
+            }
+            Json::Value list;
+            list.resize(0);
+            ret["code"] = k200OK;
+            ret["message"] = "ok";
+            for (auto &obj : records)
+            {
+                list.append(makeJson(req, obj));
+            }
+            ret["data"] = list;
+            auto resp = HttpResponse::newHttpJsonResponse(ret);
+            (*callbackPtr)(resp);
+        },
+        [callbackPtr](const DrogonDbException &e)
+        {
+            LOG_ERROR << e.base().what();
+            Json::Value ret;
+            ret["code"] = k500InternalServerError;
+            ret["message"] = "database error";
+            auto resp = HttpResponse::newHttpJsonResponse(ret);
+            (*callbackPtr)(resp);
+        });
 }
 
 void RestfulConsumptionRecordCtrlBase::updateOne(const HttpRequestPtr &req,
@@ -162,6 +184,7 @@ void RestfulConsumptionRecordCtrlBase::updateOne(const HttpRequestPtr &req,
         {
             if (count == 1)
             {
+                drogon::app().getPlugin<MemberSummaries>()->consumptionChanged();
                 auto resp = HttpResponse::newHttpResponse();
                 resp->setStatusCode(k202Accepted);
                 (*callbackPtr)(resp);
@@ -211,6 +234,7 @@ void RestfulConsumptionRecordCtrlBase::deleteOne(const HttpRequestPtr &req,
         {
             if (count == 1)
             {
+                drogon::app().getPlugin<MemberSummaries>()->consumptionChanged();
                 auto resp = HttpResponse::newHttpResponse();
                 resp->setStatusCode(k204NoContent);
                 (*callbackPtr)(resp);
@@ -421,25 +445,78 @@ void RestfulConsumptionRecordCtrlBase::create(const HttpRequestPtr &req,
         auto callbackPtr =
             std::make_shared<std::function<void(const HttpResponsePtr &)>>(
                 std::move(callback));
-        drogon::orm::Mapper<ConsumptionRecord> mapper(dbClientPtr);
-        mapper.insert(
-            object,
-            [req, callbackPtr, this](ConsumptionRecord newObject)
-            {
-                Json::Value ret;
-                ret["code"] = k200OK;
-                ret["message"] = "ok";
-                ret["data"][ConsumptionRecord::primaryKeyName] = newObject.getPrimaryKey();
-                (*callbackPtr)(HttpResponse::newHttpJsonResponse(ret));
-            },
-            [callbackPtr](const DrogonDbException &e)
+        // 记录、会员累计值和等级升级在同一事务中写入
+        dbClientPtr->newTransactionAsync(
+            [object, callbackPtr](const std::shared_ptr<Transaction> &transaction)
             {
-                LOG_ERROR << e.base().what();
-                Json::Value ret;
-                ret["code"] = k500InternalServerError;
-                ret["message"] = "database error";
-                auto resp = HttpResponse::newHttpJsonResponse(ret);
-                (*callbackPtr)(resp);
+                if (!transaction)
+                {
+                    Json::Value ret;
+                    ret["code"] = k500InternalServerError;
+                    ret["message"] = "database error";
+                    auto resp = HttpResponse::newHttpJsonResponse(ret);
+                    (*callbackPtr)(resp);
+                    return;
+                }
+                auto failed = std::make_shared<std::atomic<bool>>(false);
+                auto inserted = std::make_shared<ConsumptionRecord>();
+                auto upgraded = std::make_shared<std::pair<uint32_t, uint32_t>>(0, 0); // 租户, 升到的等级
+                transaction->setCommitCallback(
+                    [callbackPtr, failed, inserted, upgraded](bool committed)
+                    {
+                        if (*failed)
+                            return;
+                        if (!committed)
+                        {
+                            Json::Value ret;
+                            ret["code"] = k500InternalServerError;
+                            ret["message"] = "database error";
+                            auto resp = HttpResponse::newHttpJsonResponse(ret);
+                            (*callbackPtr)(resp);
+                            return;
+                        }
+                        drogon::app().getPlugin<ReportSketches>()->consumptionCreated(*inserted);
+                        drogon::app().getPlugin<MemberSegments>()->consumptionCreated(*inserted);
+                        drogon::app().getPlugin<MemberRfm>()->consumptionCreated(*inserted);
+                        drogon::app().getPlugin<MemberSummaries>()->consumptionCreated(*inserted);
+                        if (upgraded->second != 0)
+                            drogon::app().getPlugin<MemberLevels>()->upgraded(upgraded->first,
+                                                                               inserted->getValueOfMemberId(),
+                                                                               upgraded->second);
+                        Json::Value ret;
+                        ret["code"] = k200OK;
+                        ret["message"] = "ok";
+                        ret["data"][ConsumptionRecord::primaryKeyName] = inserted->getPrimaryKey();
+                        (*callbackPtr)(HttpResponse::newHttpJsonResponse(ret));
+                    });
+                // 出错时事务自动回滚且不再触发提交回调，在这里应答，只应答一次
+                auto onError = [failed, callbackPtr]()
+                {
+                    if (failed->exchange(true))
+                        return;
+                    Json::Value ret;
+                    ret["code"] = k500InternalServerError;
+                    ret["message"] = "database error";
+                    auto resp = HttpResponse::newHttpJsonResponse(ret);
+                    (*callbackPtr)(resp);
+                };
+                drogon::orm::Mapper<ConsumptionRecord> mapper(transaction);
+                mapper.insert(
+                    object,
+                    [transaction, inserted, upgraded, onError](ConsumptionRecord newObject)
+                    {
+                        *inserted = newObject;
+                        drogon::app().getPlugin<MemberLevels>()->consumptionCreated(
+                            transaction,
+                            newObject,
+                            [upgraded](uint32_t tenantId, uint32_t levelId) { *upgraded = {tenantId, levelId}; },
+                            onError);
+                    },
+                    [onError](const DrogonDbException &e)
+                    {
+                        LOG_ERROR << e.base().what();
+                        onError();
+                    });
             });
     }
     catch (const Json::Exception &e)
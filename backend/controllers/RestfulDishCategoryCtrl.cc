@@ -43,3 +43,9 @@ void RestfulDishCategoryCtrl::create(const HttpRequestPtr &req,
 {
     RestfulDishCategoryCtrlBase::create(req, std::move(callback));
 }
+
+void RestfulDishCategoryCtrl::getTree(const HttpRequestPtr &req,
+                                      std::function<void(const HttpResponsePtr &)> &&callback)
+{
+    RestfulDishCategoryCtrlBase::getTree(req, std::move(callback));
+}
@@ -22,6 +22,7 @@ class RestfulDishCategoryCtrl : public drogon::HttpController<RestfulDishCategor
 {
 public:
   METHOD_LIST_BEGIN
+  ADD_METHOD_TO(RestfulDishCategoryCtrl::getTree, "/api/dishcategory/tree", Get, Options, "AuthFilter");
   ADD_METHOD_TO(RestfulDishCategoryCtrl::getOne, "/api/dishcategory/{1}", Get, Options, "AuthFilter");
   ADD_METHOD_TO(RestfulDishCategoryCtrl::updateOne, "/api/dishcategory/{1}", Put, Options, "AuthFilter");
   ADD_METHOD_TO(RestfulDishCategoryCtrl::deleteOne, "/api/dishcategory/{1}", Delete, Options, "AuthFilter");
@@ -43,4 +44,6 @@ public:
            std::function<void(const HttpResponsePtr &)> &&callback);
   void create(const HttpRequestPtr &req,
               std::function<void(const HttpResponsePtr &)> &&callback);
+  void getTree(const HttpRequestPtr &req,
+               std::function<void(const HttpResponsePtr &)> &&callback);
 };
@@ -7,6 +7,8 @@
  */
 
 #include "RestfulDishCategoryCtrlBase.h"
+#include "CategoryTrees.h"
+#include "MenuSnapshots.h"
 #include <string>
 
 void RestfulDishCategoryCtrlBase::getOne(const HttpRequestPtr &req,
@@ -132,10 +134,12 @@ void RestfulDishCategoryCtrlBase::updateOne(const HttpRequestPtr &req,
 
     mapper.update(
         object,
-        [callbackPtr](const size_t count)
+        [callbackPtr, id](const size_t count)
         {
             if (count == 1)
             {
+                drogon::app().getPlugin<CategoryTrees>()->categoryChanged(id);
+                drogon::app().getPlugin<MenuSnapshots>()->categoryChanged(id);
                 Json::Value ret;
                 ret["code"] = k200OK;
                 ret["message"] = "ok";
@@ -183,10 +187,12 @@ void RestfulDishCategoryCtrlBase::deleteOne(const HttpRequestPtr &req,
     drogon::orm::Mapper<DishCategory> mapper(dbClientPtr);
     mapper.deleteByPrimaryKey(
         id,
-        [callbackPtr](const size_t count)
+        [callbackPtr, id](const size_t count)
         {
             if (count == 1)
             {
+                drogon::app().getPlugin<CategoryTrees>()->categoryChanged(id);
+                drogon::app().getPlugin<MenuSnapshots>()->categoryChanged(id);
                 auto resp = HttpResponse::newHttpResponse();
                 resp->setStatusCode(k204NoContent);
                 (*callbackPtr)(resp);
@@ -408,6 +414,8 @@ void RestfulDishCategoryCtrlBase::create(const HttpRequestPtr &req,
             object,
             [req, callbackPtr, this](DishCategory newObject)
             {
+                drogon::app().getPlugin<CategoryTrees>()->categoryChanged(newObject.getPrimaryKey());
+                drogon::app().getPlugin<MenuSnapshots>()->categoryChanged(newObject.getPrimaryKey());
                 (*callbackPtr)(HttpResponse::newHttpJsonResponse(
                     makeJson(req, newObject)));
             },
@@ -434,6 +442,30 @@ void RestfulDishCategoryCtrlBase::create(const HttpRequestPtr &req,
     }
 }
 
+void RestfulDishCategoryCtrlBase::getTree(const HttpRequestPtr &req,
+                                          std::function<void(const HttpResponsePtr &)> &&callback)
+{
+    uint32_t tenantId = 0;
+    try
+    {
+        tenantId = static_cast<uint32_t>(std::stoul(req->getParameter("tenant_id")));
+    }
+    catch (...)
+    {
+        Json::Value ret;
+        ret["code"] = k400BadRequest;
+        ret["message"] = "tenant_id is required";
+        auto resp = HttpResponse::newHttpJsonResponse(ret);
+        callback(resp);
+        return;
+    }
+    Json::Value ret;
+    ret["code"] = k200OK;
+    ret["message"] = "ok";
+    ret["data"] = drogon::app().getPlugin<CategoryTrees>()->treeOf(tenantId);
+    callback(HttpResponse::newHttpJsonResponse(ret));
+}
+
 /*
 void RestfulDishCategoryCtrlBase::update(const HttpRequestPtr &req,
                                          std::function<void(const HttpResponsePtr &)> &&callback)
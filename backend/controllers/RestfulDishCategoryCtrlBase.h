@@ -35,6 +35,8 @@ class RestfulDishCategoryCtrlBase : public RestfulController
              std::function<void(const HttpResponsePtr &)> &&callback);
     void create(const HttpRequestPtr &req,
                 std::function<void(const HttpResponsePtr &)> &&callback);
+    void getTree(const HttpRequestPtr &req,
+                 std::function<void(const HttpResponsePtr &)> &&callback);
 
 
 //  void update(const HttpRequestPtr &req,
@@ -6,6 +6,7 @@
  */
 
 #include "RestfulDishCtrl.h"
+#include "plugins/Money.h"
 #include <string>
 
 void RestfulDishCtrl::getOne(const HttpRequestPtr &req,
@@ -46,3 +47,8 @@ void RestfulDishCtrl::create(const HttpRequestPtr &req,
 {
     RestfulDishCtrlBase::create(req, std::move(callback));
 }
+
+bool RestfulDishCtrl::doCustomValidations(const Json::Value &pJson, std::string &err)
+{
+    return Money::checkFields(pJson, {"dish_price", "cost_price", "origin_price"}, err);
+}
@@ -46,4 +46,8 @@ public:
                     std::function<void(const HttpResponsePtr &)> &&callback);
   void create(const HttpRequestPtr &req,
               std::function<void(const HttpResponsePtr &)> &&callback);
+
+protected:
+  // dish_price、cost_price、origin_price 须为十进制数
+  bool doCustomValidations(const Json::Value &pJson, std::string &err) override;
 };
@@ -7,6 +7,11 @@
  */
 
 #include "RestfulDishCtrlBase.h"
+#include "BranchMenus.h"
+#include "CategoryTrees.h"
+#include "DishSearch.h"
+#include "MenuSnapshots.h"
+#include "ReportAggregator.h"
 #include <string>
 
 void RestfulDishCtrlBase::getOne(const HttpRequestPtr &req,
@@ -126,10 +131,13 @@ void RestfulDishCtrlBase::updateOne(const HttpRequestPtr &req,
 
     mapper.update(
         object,
-        [callbackPtr](const size_t count)
+        [callbackPtr, id](const size_t count)
         {
             if (count == 1)
             {
+                drogon::app().getPlugin<DishSearch>()->dishChanged(id);
+                drogon::app().getPlugin<MenuSnapshots>()->dishChanged(id);
+                drogon::app().getPlugin<ReportAggregator>()->dishChanged(id);
                 Json::Value ret;
                 ret["code"] = k200OK;
                 ret["message"] = "ok";
@@ -177,10 +185,12 @@ void RestfulDishCtrlBase::deleteOne(const HttpRequestPtr &req,
     drogon::orm::Mapper<Dish> mapper(dbClientPtr);
     mapper.deleteByPrimaryKey(
         id,
-        [callbackPtr](const size_t count)
+        [callbackPtr, id](const size_t count)
         {
             if (count == 1)
             {
+                drogon::app().getPlugin<DishSearch>()->dishChanged(id);
+                drogon::app().getPlugin<MenuSnapshots>()->dishChanged(id);
                 auto resp = HttpResponse::newHttpResponse();
                 resp->setStatusCode(k204NoContent);
                 (*callbackPtr)(resp);
@@ -414,6 +424,84 @@ void RestfulDishCtrlBase::get(const HttpRequestPtr &req,
             return;
         }
     }
+    iter = parameters.find("branch_id");
+    if (iter != parameters.end())
+    {
+        // 分店菜单：总店菜单快照叠加分店覆盖，不查库
+        Json::Value list;
+        bool found = false;
+        try
+        {
+            found = drogon::app().getPlugin<BranchMenus>()->dishesOf(static_cast<uint32_t>(std::stoul(iter->second)),
+                                                                     list);
+        }
+        catch (...)
+        {
+            auto resp = HttpResponse::newHttpResponse();
+            resp->setStatusCode(k400BadRequest);
+            callback(resp);
+            return;
+        }
+        Json::Value ret;
+        ret["code"] = found ? k200OK : k404NotFound;
+        ret["message"] = found ? "ok" : "branch not found";
+        ret["data"] = found ? list : Json::Value(Json::arrayValue);
+        callback(HttpResponse::newHttpJsonResponse(ret));
+        return;
+    }
+    iter = parameters.find("category_subtree");
+    if (iter != parameters.end())
+    {
+        // 按分类树的先序区间取出子树内全部分类，一次查询
+        std::vector<uint32_t> categoryIds;
+        try
+        {
+            categoryIds = drogon::app().getPlugin<CategoryTrees>()->subtreeOf(
+                static_cast<uint32_t>(std::stoul(iter->second)));
+        }
+        catch (...)
+        {
+            auto resp = HttpResponse::newHttpResponse();
+            resp->setStatusCode(k400BadRequest);
+            callback(resp);
+            return;
+        }
+        if (categoryIds.empty())
+        {
+            Json::Value ret;
+            ret["code"] = k404NotFound;
+            ret["message"] = "category not found";
+            callback(HttpResponse::newHttpJsonResponse(ret));
+            return;
+        }
+        auto callbackPtr =
+            std::make_shared<std::function<void(const HttpResponsePtr &)>>(
+                std::move(callback));
+        mapper.findBy(
+            Criteria(Dish::Cols::_dish_category_id, CompareOperator::In, categoryIds) &&
+                (Criteria(Dish::Cols::_is_deleted, CompareOperator::EQ, 0) ||
+                 Criteria(Dish::Cols::_is_deleted, CompareOperator::IsNull)),
+            [req, callbackPtr, this](const std::vector<Dish> &v)
+            {
+                Json::Value list(Json::arrayValue);
+                for (auto &obj : v)
+                    list.append(makeJson(req, obj));
+                Json::Value ret;
+                ret["code"] = k200OK;
+                ret["message"] = "ok";
+                ret["data"] = list;
+                (*callbackPtr)(HttpResponse::newHttpJsonResponse(ret));
+            },
+            [callbackPtr](const DrogonDbException &e)
+            {
+                LOG_ERROR << e.base().what();
+                Json::Value ret;
+                ret["code"] = k500InternalServerError;
+                ret["message"] = "database error";
+                (*callbackPtr)(HttpResponse::newHttpJsonResponse(ret));
+            });
+        return;
+    }
     auto callbackPtr =
         std::make_shared<std::function<void(const HttpResponsePtr &)>>(
             std::move(callback));
@@ -540,6 +628,8 @@ void RestfulDishCtrlBase::create(const HttpRequestPtr &req,
             object,
             [req, callbackPtr, this](Dish newObject)
             {
+                drogon::app().getPlugin<DishSearch>()->dishChanged(newObject.getPrimaryKey());
+                drogon::app().getPlugin<MenuSnapshots>()->dishChanged(newObject.getPrimaryKey());
                 Json::Value ret;
                 ret["code"] = k200OK;
                 ret["message"] = "ok";
@@ -0,0 +1,49 @@
+/**
+ *
+ *  RestfulDishIngredientCtrl.cc
+ *  This file is generated by drogon_ctl
+ *
+ */
+
+#include "RestfulDishIngredientCtrl.h"
+#include <string>
+
+void RestfulDishIngredientCtrl::getOne(const HttpRequestPtr &req,
+                                       std::function<void(const HttpResponsePtr &)> &&callback,
+                                       DishIngredient::PrimaryKeyType &&id)
+{
+    RestfulDishIngredientCtrlBase::getOne(req, std::move(callback), std::move(id));
+}
+
+void RestfulDishIngredientCtrl::getOneByDishId(const HttpRequestPtr &req,
+                                               std::function<void(const HttpResponsePtr &)> &&callback,
+                                               std::string &&dishId)
+{
+    RestfulDishIngredientCtrlBase::getOneByDishId(req, std::move(callback), std::move(dishId));
+}
+
+void RestfulDishIngredientCtrl::updateOne(const HttpRequestPtr &req,
+                                          std::function<void(const HttpResponsePtr &)> &&callback,
+                                          DishIngredient::PrimaryKeyType &&id)
+{
+    RestfulDishIngredientCtrlBase::updateOne(req, std::move(callback), std::move(id));
+}
+
+void RestfulDishIngredientCtrl::deleteOne(const HttpRequestPtr &req,
+                                          std::function<void(const HttpResponsePtr &)> &&callback,
+                                          DishIngredient::PrimaryKeyType &&id)
+{
+    RestfulDishIngredientCtrlBase::deleteOne(req, std::move(callback), std::move(id));
+}
+
+void RestfulDishIngredientCtrl::get(const HttpRequestPtr &req,
+                                    std::function<void(const HttpResponsePtr &)> &&callback)
+{
+    RestfulDishIngredientCtrlBase::get(req, std::move(callback));
+}
+
+void RestfulDishIngredientCtrl::create(const HttpRequestPtr &req,
+                                       std::function<void(const HttpResponsePtr &)> &&callback)
+{
+    RestfulDishIngredientCtrlBase::create(req, std::move(callback));
+}
@@ -0,0 +1,49 @@
+/**
+ *
+ *  RestfulDishIngredientCtrl.h
+ *  This file is generated by drogon_ctl
+ *
+ */
+
+#pragma once
+
+#include <drogon/HttpController.h>
+#include "RestfulDishIngredientCtrlBase.h"
+
+#include "DishIngredient.h"
+using namespace drogon;
+using namespace drogon_model::saas_restaurant;
+/**
+ * @brief this class is created by the drogon_ctl command.
+ * this class is a restful API controller for reading and writing the dish_ingredient table.
+ */
+
+class RestfulDishIngredientCtrl : public drogon::HttpController<RestfulDishIngredientCtrl>, public RestfulDishIngredientCtrlBase
+{
+public:
+  METHOD_LIST_BEGIN
+  ADD_METHOD_TO(RestfulDishIngredientCtrl::getOne, "/api/dishingredient/{1}", Get, Options, "AuthFilter");
+  ADD_METHOD_TO(RestfulDishIngredientCtrl::getOneByDishId, "/api/dishingredient/dish/{1}", Get, Options, "AuthFilter");
+  ADD_METHOD_TO(RestfulDishIngredientCtrl::updateOne, "/api/dishingredient/{1}", Put, Options, "AuthFilter");
+  ADD_METHOD_TO(RestfulDishIngredientCtrl::deleteOne, "/api/dishingredient/{1}", Delete, Options, "AuthFilter");
+  ADD_METHOD_TO(RestfulDishIngredientCtrl::get, "/api/dishingredient", Get, Options, "AuthFilter");
+  ADD_METHOD_TO(RestfulDishIngredientCtrl::create, "/api/dishingredient", Post, Options, "AuthFilter");
+  // ADD_METHOD_TO(RestfulDishIngredientCtrl::update,"/api/dishingredient",Put,Options,"AuthFilter");
+  METHOD_LIST_END
+
+  void getOne(const HttpRequestPtr &req,
+              std::function<void(const HttpResponsePtr &)> &&callback,
+              DishIngredient::PrimaryKeyType &&id);
+  void getOneByDishId(const HttpRequestPtr &req,
+                      std::function<void(const HttpResponsePtr &)> &&callback, std::string &&dishId);
+  void updateOne(const HttpRequestPtr &req,
+                 std::function<void(const HttpResponsePtr &)> &&callback,
+                 DishIngredient::PrimaryKeyType &&id);
+  void deleteOne(const HttpRequestPtr &req,
+                 std::function<void(const HttpResponsePtr &)> &&callback,
+                 DishIngredient::PrimaryKeyType &&id);
+  void get(const HttpRequestPtr &req,
+           std::function<void(const HttpResponsePtr &)> &&callback);
+  void create(const HttpRequestPtr &req,
+              std::function<void(const HttpResponsePtr &)> &&callback);
+};
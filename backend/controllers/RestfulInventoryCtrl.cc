@@ -6,6 +6,9 @@
  */
 
 #include "RestfulInventoryCtrl.h"
+#include "plugins/Money.h"
+#include "plugins/StockWarningEngine.h"
+#include "plugins/InventoryForecaster.h"
 #include <string>
 
 
@@ -16,11 +19,30 @@ void RestfulInventoryCtrl::getOne(const HttpRequestPtr &req,
     RestfulInventoryCtrlBase::getOne(req, std::move(callback), std::move(id));
 }
 
+void RestfulInventoryCtrl::getQuantity(const HttpRequestPtr &req,
+                                       std::function<void(const HttpResponsePtr &)> &&callback,
+                                       Inventory::PrimaryKeyType &&id)
+{
+    RestfulInventoryCtrlBase::getQuantity(req, std::move(callback), std::move(id));
+}
+
+void RestfulInventoryCtrl::getForecast(const HttpRequestPtr &req,
+                                       std::function<void(const HttpResponsePtr &)> &&callback)
+{
+    RestfulInventoryCtrlBase::getForecast(req, std::move(callback));
+}
+
 
 void RestfulInventoryCtrl::updateOne(const HttpRequestPtr &req,
                                      std::function<void(const HttpResponsePtr &)> &&callback,
                                      Inventory::PrimaryKeyType &&id)
 {
+    // 库存数量由出入库流水推导，不允许直接修改
+    auto jsonPtr = req->jsonObject();
+    if (jsonPtr)
+    {
+        jsonPtr->removeMember(Inventory::Cols::_quantity);
+    }
     RestfulInventoryCtrlBase::updateOne(req, std::move(callback), std::move(id));
 }
 
@@ -29,7 +51,19 @@ void RestfulInventoryCtrl::deleteOne(const HttpRequestPtr &req,
                                      std::function<void(const HttpResponsePtr &)> &&callback,
                                      Inventory::PrimaryKeyType &&id)
 {
-    RestfulInventoryCtrlBase::deleteOne(req, std::move(callback), std::move(id));
+    auto itemId = id;
+    RestfulInventoryCtrlBase::deleteOne(
+        req,
+        [callback = std::move(callback), itemId](const HttpResponsePtr &resp)
+        {
+            if (resp->getStatusCode() == k204NoContent)
+            {
+                drogon::app().getPlugin<StockWarningEngine>()->removeItem(0, itemId);
+                drogon::app().getPlugin<InventoryForecaster>()->removeItem(itemId);
+            }
+            callback(resp);
+        },
+        std::move(id));
 }
 
 void RestfulInventoryCtrl::get(const HttpRequestPtr &req,
@@ -43,3 +77,8 @@ void RestfulInventoryCtrl::create(const HttpRequestPtr &req,
 {
     RestfulInventoryCtrlBase::create(req, std::move(callback));
 }
+
+bool RestfulInventoryCtrl::doCustomValidations(const Json::Value &pJson, std::string &err)
+{
+    return Money::checkFields(pJson, {"item_cost"}, err);
+}
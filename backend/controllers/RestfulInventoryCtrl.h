@@ -22,7 +22,9 @@ class RestfulInventoryCtrl : public drogon::HttpController<RestfulInventoryCtrl>
 {
 public:
   METHOD_LIST_BEGIN
+  ADD_METHOD_TO(RestfulInventoryCtrl::getForecast, "/api/inventory/forecast", Get, Options, "AuthFilter"); // 消耗预测与补货建议
   ADD_METHOD_TO(RestfulInventoryCtrl::getOne, "/api/inventory/{1}", Get, Options, "AuthFilter");
+  ADD_METHOD_TO(RestfulInventoryCtrl::getQuantity, "/api/inventory/{1}/quantity", Get, Options, "AuthFilter");
   ADD_METHOD_TO(RestfulInventoryCtrl::updateOne, "/api/inventory/{1}", Put, Options, "AuthFilter");
   ADD_METHOD_TO(RestfulInventoryCtrl::deleteOne, "/api/inventory/{1}", Delete, Options, "AuthFilter");
   ADD_METHOD_TO(RestfulInventoryCtrl::get, "/api/inventory", Get, Options, "AuthFilter");
@@ -33,6 +35,11 @@ public:
   void getOne(const HttpRequestPtr &req,
               std::function<void(const HttpResponsePtr &)> &&callback,
               Inventory::PrimaryKeyType &&id);
+  void getQuantity(const HttpRequestPtr &req,
+                   std::function<void(const HttpResponsePtr &)> &&callback,
+                   Inventory::PrimaryKeyType &&id);
+  void getForecast(const HttpRequestPtr &req,
+                   std::function<void(const HttpResponsePtr &)> &&callback);
   void updateOne(const HttpRequestPtr &req,
                  std::function<void(const HttpResponsePtr &)> &&callback,
                  Inventory::PrimaryKeyType &&id);
@@ -43,4 +50,8 @@ public:
            std::function<void(const HttpResponsePtr &)> &&callback);
   void create(const HttpRequestPtr &req,
               std::function<void(const HttpResponsePtr &)> &&callback);
+
+protected:
+  // item_cost 须为十进制数
+  bool doCustomValidations(const Json::Value &pJson, std::string &err) override;
 };
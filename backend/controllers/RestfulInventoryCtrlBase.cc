@@ -7,6 +7,11 @@
  */
 
 #include "RestfulInventoryCtrlBase.h"
+#include "plugins/InventoryLedger.h"
+#include "plugins/StockWarningEngine.h"
+#include "plugins/InventoryForecaster.h"
+#include <algorithm>
+#include <map>
 #include <string>
 
 void RestfulInventoryCtrlBase::getOne(const HttpRequestPtr &req,
@@ -44,6 +49,107 @@ void RestfulInventoryCtrlBase::getOne(const HttpRequestPtr &req,
         });
 }
 
+void RestfulInventoryCtrlBase::getQuantity(const HttpRequestPtr &req,
+                                           std::function<void(const HttpResponsePtr &)> &&callback,
+                                           Inventory::PrimaryKeyType &&id)
+{
+    auto ledger = drogon::app().getPlugin<InventoryLedger>();
+    Json::Value ret;
+    if (!ledger->hasItem(id))
+    {
+        ret["code"] = k404NotFound;
+        ret["message"] = "No resources found";
+        auto resp = HttpResponse::newHttpJsonResponse(ret);
+        callback(resp);
+        return;
+    }
+    // at 参数为空时返回当前数量，否则返回该时刻的历史数量
+    auto at = req->getParameter("at");
+    ret["code"] = k200OK;
+    ret["message"] = "ok";
+    ret["data"][Inventory::primaryKeyName] = id;
+    if (at.empty())
+    {
+        ret["data"]["quantity"] = (Json::Int64)ledger->quantityOf(id);
+        ret["data"]["at"] = trantor::Date::now().toDbStringLocal();
+        auto resp = HttpResponse::newHttpJsonResponse(ret);
+        callback(resp);
+        return;
+    }
+    auto date = trantor::Date::fromDbStringLocal(at);
+    ret["data"]["at"] = date.toDbStringLocal();
+    auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
+    ledger->quantityAt(
+        id,
+        date,
+        [ret, callbackPtr](int64_t quantity) mutable
+        {
+            ret["data"]["quantity"] = (Json::Int64)quantity;
+            auto resp = HttpResponse::newHttpJsonResponse(ret);
+            (*callbackPtr)(resp);
+        },
+        [callbackPtr](const DrogonDbException &e)
+        {
+            LOG_ERROR << e.base().what();
+            Json::Value ret;
+            ret["error"] = "database error";
+            auto resp = HttpResponse::newHttpJsonResponse(ret);
+            resp->setStatusCode(k500InternalServerError);
+            (*callbackPtr)(resp);
+        });
+}
+
+void RestfulInventoryCtrlBase::getForecast(const HttpRequestPtr &req,
+                                           std::function<void(const HttpResponsePtr &)> &&callback)
+{
+    uint32_t tenantId = 0;
+    auto tenantParam = req->getParameter("tenant_id");
+    try
+    {
+        if (!tenantParam.empty())
+            tenantId = static_cast<uint32_t>(std::stoul(tenantParam));
+    }
+    catch (const std::exception &)
+    {
+        Json::Value ret;
+        ret["code"] = k400BadRequest;
+        ret["message"] = "tenant_id 参数错误";
+        auto resp = HttpResponse::newHttpJsonResponse(ret);
+        callback(resp);
+        return;
+    }
+
+    // 预测结果由插件增量维护，这里只按供应商分组
+    auto items = drogon::app().getPlugin<InventoryForecaster>()->forecast(tenantId);
+    std::sort(items.begin(), items.end(), [](const auto &a, const auto &b)
+              {
+        if ((a.daysUntilStockout < 0) != (b.daysUntilStockout < 0))
+            return b.daysUntilStockout < 0;
+        return a.daysUntilStockout < b.daysUntilStockout; });
+    std::map<std::string, Json::Value> groups;
+    for (const auto &item : items)
+    {
+        auto &group = groups[item.supplier];
+        if (group.isNull())
+        {
+            group["supplier"] = item.supplier;
+            group["reorder_quantity"] = (Json::Int64)0;
+            group["items"] = Json::Value(Json::arrayValue);
+        }
+        group["reorder_quantity"] = group["reorder_quantity"].asInt64() + item.reorderQuantity;
+        group["items"].append(InventoryForecaster::toJson(item));
+    }
+
+    Json::Value ret;
+    ret["code"] = k200OK;
+    ret["message"] = "ok";
+    ret["data"] = Json::Value(Json::arrayValue);
+    for (auto &[supplier, group] : groups)
+        ret["data"].append(group);
+    auto resp = HttpResponse::newHttpJsonResponse(ret);
+    callback(resp);
+}
+
 void RestfulInventoryCtrlBase::updateOne(const HttpRequestPtr &req,
                                          std::function<void(const HttpResponsePtr &)> &&callback,
                                          Inventory::PrimaryKeyType &&id)
@@ -126,10 +232,13 @@ void RestfulInventoryCtrlBase::updateOne(const HttpRequestPtr &req,
 
     mapper.update(
         object,
-        [callbackPtr](const size_t count)
+        [callbackPtr, id](const size_t count)
         {
             if (count == 1)
             {
+                // 阈值或删除标记可能变化，重新判断预警
+                drogon::app().getPlugin<StockWarningEngine>()->refreshItem(id);
+                drogon::app().getPlugin<InventoryForecaster>()->refreshItem(id);
                 Json::Value ret;
                 ret["code"] = k200OK;
                 ret["message"] = "ok";
@@ -412,6 +521,12 @@ void RestfulInventoryCtrlBase::create(const HttpRequestPtr &req,
             object,
             [req, callbackPtr, this](Inventory newObject)
             {
+                // 期初数量写入库存流水账
+                drogon::app().getPlugin<InventoryLedger>()->openItem(newObject.getValueOfTenantId(),
+                                                                     newObject.getPrimaryKey(),
+                                                                     newObject.getValueOfQuantity());
+                drogon::app().getPlugin<StockWarningEngine>()->refreshItem(newObject.getPrimaryKey());
+                drogon::app().getPlugin<InventoryForecaster>()->refreshItem(newObject.getPrimaryKey());
                 Json::Value ret;
                 ret["code"] = k200OK;
                 ret["message"] = "ok";
@@ -25,6 +25,11 @@ class RestfulInventoryCtrlBase : public RestfulController
     void getOne(const HttpRequestPtr &req,
                 std::function<void(const HttpResponsePtr &)> &&callback,
                 Inventory::PrimaryKeyType &&id);
+    void getQuantity(const HttpRequestPtr &req,
+                     std::function<void(const HttpResponsePtr &)> &&callback,
+                     Inventory::PrimaryKeyType &&id);
+    void getForecast(const HttpRequestPtr &req,
+                     std::function<void(const HttpResponsePtr &)> &&callback);
     void updateOne(const HttpRequestPtr &req,
                    std::function<void(const HttpResponsePtr &)> &&callback,
                    Inventory::PrimaryKeyType &&id);
@@ -6,6 +6,7 @@
  */
 
 #include "RestfulInventoryRecordCtrl.h"
+#include "plugins/InventoryLedger.h"
 #include <string>
 
 void RestfulInventoryRecordCtrl::getOne(const HttpRequestPtr &req,
@@ -26,14 +27,90 @@ void RestfulInventoryRecordCtrl::updateOne(const HttpRequestPtr &req,
                                            std::function<void(const HttpResponsePtr &)> &&callback,
                                            InventoryRecord::PrimaryKeyType &&id)
 {
-    RestfulInventoryRecordCtrlBase::updateOne(req, std::move(callback), std::move(id));
+    // 修改流水后重建原物料和新物料的账本
+    uint32_t newItemId = 0;
+    auto jsonPtr = req->jsonObject();
+    if (jsonPtr && (*jsonPtr)[InventoryRecord::Cols::_item_id].isUInt())
+    {
+        newItemId = (*jsonPtr)[InventoryRecord::Cols::_item_id].asUInt();
+    }
+    auto recordId = id;
+    itemOf(recordId,
+           std::move(callback),
+           [this, req, recordId, newItemId](uint32_t itemId, std::function<void(const HttpResponsePtr &)> &&callback)
+           {
+               RestfulInventoryRecordCtrlBase::updateOne(
+                   req,
+                   [callback = std::move(callback), itemId, newItemId](const HttpResponsePtr &resp)
+                   {
+                       if (resp->getStatusCode() == k202Accepted)
+                       {
+                           auto ledger = drogon::app().getPlugin<InventoryLedger>();
+                           if (itemId != 0)
+                               ledger->reloadItem(itemId);
+                           if (newItemId != 0 && newItemId != itemId)
+                               ledger->reloadItem(newItemId);
+                       }
+                       callback(resp);
+                   },
+                   InventoryRecord::PrimaryKeyType(recordId));
+           });
 }
 
 void RestfulInventoryRecordCtrl::deleteOne(const HttpRequestPtr &req,
                                            std::function<void(const HttpResponsePtr &)> &&callback,
                                            InventoryRecord::PrimaryKeyType &&id)
 {
-    RestfulInventoryRecordCtrlBase::deleteOne(req, std::move(callback), std::move(id));
+    auto recordId = id;
+    itemOf(recordId,
+           std::move(callback),
+           [this, req, recordId](uint32_t itemId, std::function<void(const HttpResponsePtr &)> &&callback)
+           {
+               RestfulInventoryRecordCtrlBase::deleteOne(
+                   req,
+                   [callback = std::move(callback), itemId](const HttpResponsePtr &resp)
+                   {
+                       if (resp->getStatusCode() == k204NoContent && itemId != 0)
+                       {
+                           drogon::app().getPlugin<InventoryLedger>()->reloadItem(itemId);
+                       }
+                       callback(resp);
+                   },
+                   InventoryRecord::PrimaryKeyType(recordId));
+           });
+}
+
+void RestfulInventoryRecordCtrl::itemOf(
+    InventoryRecord::PrimaryKeyType recordId,
+    std::function<void(const HttpResponsePtr &)> &&callback,
+    std::function<void(uint32_t itemId, std::function<void(const HttpResponsePtr &)> &&callback)> &&next)
+{
+    // 账本只保留最新快照之后的流水，修改前先查出流水所属的物料
+    auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
+    auto nextPtr = std::make_shared<
+        std::function<void(uint32_t, std::function<void(const HttpResponsePtr &)> &&)>>(std::move(next));
+    Mapper<InventoryRecord> mapper(getDbClient());
+    mapper.findByPrimaryKey(
+        recordId,
+        [callbackPtr, nextPtr](const InventoryRecord &record)
+        {
+            (*nextPtr)(record.getValueOfItemId(), std::move(*callbackPtr));
+        },
+        [callbackPtr, nextPtr](const DrogonDbException &e)
+        {
+            // 流水不存在时交给基类返回 404
+            if (dynamic_cast<const UnexpectedRows *>(&e.base()))
+            {
+                (*nextPtr)(0, std::move(*callbackPtr));
+                return;
+            }
+            LOG_ERROR << e.base().what();
+            Json::Value ret;
+            ret["error"] = "database error";
+            auto resp = HttpResponse::newHttpJsonResponse(ret);
+            resp->setStatusCode(k500InternalServerError);
+            (*callbackPtr)(resp);
+        });
 }
 
 void RestfulInventoryRecordCtrl::get(const HttpRequestPtr &req,
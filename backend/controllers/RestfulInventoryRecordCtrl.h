@@ -49,4 +49,10 @@ public:
            std::function<void(const HttpResponsePtr &)> &&callback);
   void create(const HttpRequestPtr &req,
               std::function<void(const HttpResponsePtr &)> &&callback);
+
+private:
+  /// 查出流水所属的物料后继续处理；流水不存在时 itemId 为 0
+  void itemOf(InventoryRecord::PrimaryKeyType recordId,
+              std::function<void(const HttpResponsePtr &)> &&callback,
+              std::function<void(uint32_t itemId, std::function<void(const HttpResponsePtr &)> &&callback)> &&next);
 };
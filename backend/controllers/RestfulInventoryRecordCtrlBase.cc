@@ -7,6 +7,8 @@
  */
 
 #include "RestfulInventoryRecordCtrlBase.h"
+#include "plugins/InventoryLedger.h"
+#include <limits>
 #include <string>
 
 void RestfulInventoryRecordCtrlBase::getOne(const HttpRequestPtr &req,
@@ -48,31 +50,72 @@ void RestfulInventoryRecordCtrlBase::getOneByInventoryId(const HttpRequestPtr &r
                                                          std::function<void(const HttpResponsePtr &)> &&callback,
                                                          std::string &&id)
 {
-
-    auto dbClientPtr = getDbClient();
-
-    drogon::orm::Mapper<InventoryRecord> mapper(dbClientPtr);
-    auto criteria = drogon::orm::Criteria(InventoryRecord::Cols::_item_id, drogon::orm::CompareOperator::EQ, id);
-    std::vector<InventoryRecord> records = mapper.findBy(criteria);
     Json::Value ret;
-    if (records.empty())
+    uint32_t itemId = 0;
+    size_t offset = 0;
+    size_t limit = 0;
+    try
+    {
+        itemId = (uint32_t)std::stoul(id);
+        auto &parameters = req->parameters();
+        auto iter = parameters.find("offset");
+        if (iter != parameters.end())
+            offset = std::stoull(iter->second);
+        iter = parameters.find("limit");
+        if (iter != parameters.end())
+            limit = std::stoull(iter->second);
+    }
+    catch (...)
     {
-        ret["code"] = k404NotFound;
-        ret["message"] = "No resources found";
+        ret["code"] = k400BadRequest;
+        ret["message"] = "Bad parameters";
         auto resp = HttpResponse::newHttpJsonResponse(ret);
         callback(resp);
         return;
     }
-    Json::Value list;
-    for (auto &obj : records)
-    {
-        list.append(makeJson(req, obj));
-    }
-    ret["code"] = k200OK;
-    ret["message"] = "ok";
-    ret["data"] = list;
-    auto resp = HttpResponse::newHttpJsonResponse(ret);
-    callback(resp);
+    // 按时间区间查询流水，默认返回全部
+    auto from = req->getParameter("from");
+    auto to = req->getParameter("to");
+    auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
+    drogon::app().getPlugin<InventoryLedger>()->history(
+        itemId,
+        from.empty() ? trantor::Date(0) : trantor::Date::fromDbStringLocal(from),
+        to.empty() ? trantor::Date(std::numeric_limits<int64_t>::max()) : trantor::Date::fromDbStringLocal(to),
+        offset,
+        limit,
+        [this, req, callbackPtr](const std::vector<InventoryLedger::HistoryEntry> &records)
+        {
+            Json::Value ret;
+            if (records.empty())
+            {
+                ret["code"] = k404NotFound;
+                ret["message"] = "No resources found";
+                auto resp = HttpResponse::newHttpJsonResponse(ret);
+                (*callbackPtr)(resp);
+                return;
+            }
+            Json::Value list;
+            for (auto &entry : records)
+            {
+                auto obj = makeJson(req, entry.record);
+                obj["balance"] = (Json::Int64)entry.balance;
+                list.append(obj);
+            }
+            ret["code"] = k200OK;
+            ret["message"] = "ok";
+            ret["data"] = list;
+            auto resp = HttpResponse::newHttpJsonResponse(ret);
+            (*callbackPtr)(resp);
+        },
+        [callbackPtr](const DrogonDbException &e)
+        {
+            LOG_ERROR << e.base().what();
+            Json::Value ret;
+            ret["error"] = "database error";
+            auto resp = HttpResponse::newHttpJsonResponse(ret);
+            resp->setStatusCode(k500InternalServerError);
+            (*callbackPtr)(resp);
+        });
 }
 
 void RestfulInventoryRecordCtrlBase::updateOne(const HttpRequestPtr &req,
@@ -425,6 +468,7 @@ void RestfulInventoryRecordCtrlBase::create(const HttpRequestPtr &req,
             object,
             [req, callbackPtr, this](InventoryRecord newObject)
             {
+                drogon::app().getPlugin<InventoryLedger>()->append(newObject);
                 Json::Value ret;
                 ret["code"] = k200OK;
                 ret["message"] = "ok";
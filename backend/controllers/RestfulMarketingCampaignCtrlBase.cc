@@ -7,6 +7,9 @@
  */
 
 #include "RestfulMarketingCampaignCtrlBase.h"
+#include "CampaignScheduler.h"
+#include "MenuSnapshots.h"
+#include "PricingEngine.h"
 #include <string>
 
 void RestfulMarketingCampaignCtrlBase::getOne(const HttpRequestPtr &req,
@@ -126,10 +129,13 @@ void RestfulMarketingCampaignCtrlBase::updateOne(const HttpRequestPtr &req,
 
     mapper.update(
         object,
-        [callbackPtr](const size_t count)
+        [callbackPtr, id](const size_t count)
         {
             if (count == 1)
             {
+                drogon::app().getPlugin<CampaignScheduler>()->campaignChanged(id);
+                drogon::app().getPlugin<PricingEngine>()->campaignChanged(id);
+                drogon::app().getPlugin<MenuSnapshots>()->campaignChanged(id);
                 Json::Value ret;
                 ret["code"] = k200OK;
                 ret["message"] = "ok";
@@ -177,10 +183,13 @@ void RestfulMarketingCampaignCtrlBase::deleteOne(const HttpRequestPtr &req,
     drogon::orm::Mapper<MarketingCampaign> mapper(dbClientPtr);
     mapper.deleteByPrimaryKey(
         id,
-        [callbackPtr](const size_t count)
+        [callbackPtr, id](const size_t count)
         {
             if (count == 1)
             {
+                drogon::app().getPlugin<CampaignScheduler>()->campaignChanged(id);
+                drogon::app().getPlugin<PricingEngine>()->campaignChanged(id);
+                drogon::app().getPlugin<MenuSnapshots>()->campaignChanged(id);
                 auto resp = HttpResponse::newHttpResponse();
                 resp->setStatusCode(k204NoContent);
                 (*callbackPtr)(resp);
@@ -402,6 +411,9 @@ void RestfulMarketingCampaignCtrlBase::create(const HttpRequestPtr &req,
             object,
             [req, callbackPtr, this](MarketingCampaign newObject)
             {
+                drogon::app().getPlugin<CampaignScheduler>()->campaignChanged(newObject.getPrimaryKey());
+                drogon::app().getPlugin<PricingEngine>()->campaignChanged(newObject.getPrimaryKey());
+                drogon::app().getPlugin<MenuSnapshots>()->campaignChanged(newObject.getPrimaryKey());
                 Json::Value ret;
                 ret["code"] = k200OK;
                 ret["message"] = "ok";
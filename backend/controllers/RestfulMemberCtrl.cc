@@ -6,6 +6,7 @@
  */
 
 #include "RestfulMemberCtrl.h"
+#include "plugins/Money.h"
 #include <string>
 
 
@@ -43,3 +44,8 @@ void RestfulMemberCtrl::create(const HttpRequestPtr &req,
 {
     RestfulMemberCtrlBase::create(req, std::move(callback));
 }
+
+bool RestfulMemberCtrl::doCustomValidations(const Json::Value &pJson, std::string &err)
+{
+    return Money::checkFields(pJson, {"total_spent"}, err);
+}
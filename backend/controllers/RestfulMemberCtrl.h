@@ -43,4 +43,8 @@ public:
            std::function<void(const HttpResponsePtr &)> &&callback);
   void create(const HttpRequestPtr &req,
               std::function<void(const HttpResponsePtr &)> &&callback);
+
+protected:
+  // total_spent 须为十进制数
+  bool doCustomValidations(const Json::Value &pJson, std::string &err) override;
 };
@@ -7,8 +7,27 @@
  */
 
 #include "RestfulMemberCtrlBase.h"
+#include "MemberExpiry.h"
+#include "MemberSearch.h"
+#include "MemberLevels.h"
+#include "MemberRfm.h"
+#include "MemberSegments.h"
+#include "PricingEngine.h"
+#include <atomic>
 #include <string>
 
+namespace
+{
+// 带 ?with=rfm 时附带 RFM 评分和生命周期指标
+Json::Value withRfm(const HttpRequestPtr &req, const Member &member, Json::Value &&json)
+{
+    if (req->getParameter("with") == "rfm")
+        json["rfm"] = drogon::app().getPlugin<MemberRfm>()->metricsOf(member.getValueOfTenantId(),
+                                                                      member.getValueOfMemberId());
+    return std::move(json);
+}
+} // namespace
+
 void RestfulMemberCtrlBase::getOne(const HttpRequestPtr &req,
                                    std::function<void(const HttpResponsePtr &)> &&callback,
                                    Member::PrimaryKeyType &&id)
@@ -23,7 +42,7 @@ void RestfulMemberCtrlBase::getOne(const HttpRequestPtr &req,
         id,
         [req, callbackPtr, this](Member r)
         {
-            (*callbackPtr)(HttpResponse::newHttpJsonResponse(makeJson(req, r)));
+            (*callbackPtr)(HttpResponse::newHttpJsonResponse(withRfm(req, r, makeJson(req, r))));
         },
         [callbackPtr](const DrogonDbException &e)
         {
@@ -122,14 +141,95 @@ void RestfulMemberCtrlBase::updateOne(const HttpRequestPtr &req,
     auto callbackPtr =
         std::make_shared<std::function<void(const HttpResponsePtr &)>>(
             std::move(callback));
+    // 改了累计积分或消费且未指定等级时，在同一事务中重新评估等级
+    if (!jsonPtr->isMember("level_id") && (jsonPtr->isMember("total_points") || jsonPtr->isMember("total_spent")))
+    {
+        dbClientPtr->newTransactionAsync(
+            [object, callbackPtr, id](const std::shared_ptr<Transaction> &transaction)
+            {
+                if (!transaction)
+                {
+                    Json::Value ret;
+                    ret["code"] = k500InternalServerError;
+                    ret["message"] = "database error";
+                    auto resp = HttpResponse::newHttpJsonResponse(ret);
+                    (*callbackPtr)(resp);
+                    return;
+                }
+                auto failed = std::make_shared<std::atomic<bool>>(false);
+                auto updated = std::make_shared<size_t>(0);
+                transaction->setCommitCallback(
+                    [callbackPtr, id, failed, updated](bool committed)
+                    {
+                        if (*failed)
+                            return;
+                        Json::Value ret;
+                        if (!committed || *updated > 1)
+                        {
+                            if (*updated > 1)
+                                LOG_FATAL << "More than one resource is updated: " << *updated;
+                            ret["code"] = k500InternalServerError;
+                            ret["message"] = "database error";
+                        }
+                        else if (*updated == 0)
+                        {
+                            ret["code"] = k200OK;
+                            ret["message"] = "No resources are updated";
+                        }
+                        else
+                        {
+                            // 回读会员，包含升级后的等级
+                            drogon::app().getPlugin<PricingEngine>()->memberChanged(id);
+                            drogon::app().getPlugin<MemberSegments>()->memberChanged(id);
+                            drogon::app().getPlugin<MemberExpiry>()->memberChanged(id);
+                            drogon::app().getPlugin<MemberSearch>()->memberChanged(id);
+                            ret["code"] = k200OK;
+                            ret["message"] = "ok";
+                        }
+                        auto resp = HttpResponse::newHttpJsonResponse(ret);
+                        (*callbackPtr)(resp);
+                    });
+                // 出错时事务自动回滚且不再触发提交回调，在这里应答，只应答一次
+                auto onError = [failed, callbackPtr]()
+                {
+                    if (failed->exchange(true))
+                        return;
+                    Json::Value ret;
+                    ret["code"] = k500InternalServerError;
+                    ret["message"] = "database error";
+                    auto resp = HttpResponse::newHttpJsonResponse(ret);
+                    (*callbackPtr)(resp);
+                };
+                drogon::orm::Mapper<Member> mapper(transaction);
+                mapper.update(
+                    object,
+                    [transaction, id, updated, onError](const size_t count)
+                    {
+                        *updated = count;
+                        if (count == 1)
+                            drogon::app().getPlugin<MemberLevels>()->evaluate(
+                                transaction, id, [](uint32_t, uint32_t) {}, onError);
+                    },
+                    [onError](const DrogonDbException &e)
+                    {
+                        LOG_ERROR << e.base().what();
+                        onError();
+                    });
+            });
+        return;
+    }
     drogon::orm::Mapper<Member> mapper(dbClientPtr);
 
     mapper.update(
         object,
-        [callbackPtr](const size_t count)
+        [callbackPtr, id](const size_t count)
         {
             if (count == 1)
             {
+                drogon::app().getPlugin<PricingEngine>()->memberChanged(id);
+                drogon::app().getPlugin<MemberSegments>()->memberChanged(id);
+                drogon::app().getPlugin<MemberExpiry>()->memberChanged(id);
+                drogon::app().getPlugin<MemberSearch>()->memberChanged(id);
                 Json::Value ret;
                 ret["code"] = k200OK;
                 ret["message"] = "ok";
@@ -177,10 +277,14 @@ void RestfulMemberCtrlBase::deleteOne(const HttpRequestPtr &req,
     drogon::orm::Mapper<Member> mapper(dbClientPtr);
     mapper.deleteByPrimaryKey(
         id,
-        [callbackPtr](const size_t count)
+        [callbackPtr, id](const size_t count)
         {
             if (count == 1)
             {
+                drogon::app().getPlugin<PricingEngine>()->memberChanged(id);
+                drogon::app().getPlugin<MemberSegments>()->memberChanged(id);
+                drogon::app().getPlugin<MemberExpiry>()->memberChanged(id);
+                drogon::app().getPlugin<MemberSearch>()->memberChanged(id);
                 auto resp = HttpResponse::newHttpResponse();
                 resp->setStatusCode(k204NoContent);
                 (*callbackPtr)(resp);
@@ -291,7 +395,7 @@ void RestfulMemberCtrlBase::get(const HttpRequestPtr &req,
                     ret.resize(0);
                     for (auto &obj : v)
                     {
-                        ret.append(makeJson(req, obj));
+                        ret.append(withRfm(req, obj, makeJson(req, obj)));
                     }
                     (*callbackPtr)(HttpResponse::newHttpJsonResponse(ret)); }, [callbackPtr](const DrogonDbException &e)
                           { 
@@ -324,7 +428,7 @@ void RestfulMemberCtrlBase::get(const HttpRequestPtr &req,
                 {
                     if(obj.getValueOfIsDeleted())
                     continue;
-                    list.append(makeJson(req, obj));
+                    list.append(withRfm(req, obj, makeJson(req, obj)));
                 }
                 ret["code"]=k200OK;
                 ret["message"]="ok";
@@ -412,6 +516,10 @@ void RestfulMemberCtrlBase::create(const HttpRequestPtr &req,
             object,
             [req, callbackPtr, this](Member newObject)
             {
+                drogon::app().getPlugin<PricingEngine>()->memberChanged(newObject.getPrimaryKey());
+                drogon::app().getPlugin<MemberSegments>()->memberChanged(newObject.getPrimaryKey());
+                drogon::app().getPlugin<MemberExpiry>()->memberChanged(newObject.getPrimaryKey());
+                drogon::app().getPlugin<MemberSearch>()->memberChanged(newObject.getPrimaryKey());
                 Json::Value ret;
                 ret["code"] = k200OK;
                 ret["message"] = "ok";
@@ -6,6 +6,7 @@
  */
 
 #include "RestfulMemberLevelCtrl.h"
+#include "plugins/Money.h"
 #include <string>
 
 
@@ -43,3 +44,8 @@ void RestfulMemberLevelCtrl::create(const HttpRequestPtr &req,
 {
     RestfulMemberLevelCtrlBase::create(req, std::move(callback));
 }
+
+bool RestfulMemberLevelCtrl::doCustomValidations(const Json::Value &pJson, std::string &err)
+{
+    return Money::checkFields(pJson, {"required_spent"}, err) && Rate::checkFields(pJson, {"discount_rate"}, err);
+}
@@ -7,6 +7,8 @@
  */
 
 #include "RestfulMemberLevelCtrlBase.h"
+#include "MemberLevels.h"
+#include "PricingEngine.h"
 #include <string>
 
 void RestfulMemberLevelCtrlBase::getOne(const HttpRequestPtr &req,
@@ -132,10 +134,12 @@ void RestfulMemberLevelCtrlBase::updateOne(const HttpRequestPtr &req,
 
     mapper.update(
         object,
-        [callbackPtr](const size_t count)
+        [callbackPtr, id](const size_t count)
         {
             if (count == 1)
             {
+                drogon::app().getPlugin<PricingEngine>()->levelChanged(id);
+                drogon::app().getPlugin<MemberLevels>()->levelChanged(id);
                 auto resp = HttpResponse::newHttpResponse();
                 resp->setStatusCode(k202Accepted);
                 (*callbackPtr)(resp);
@@ -181,10 +185,12 @@ void RestfulMemberLevelCtrlBase::deleteOne(const HttpRequestPtr &req,
     drogon::orm::Mapper<MemberLevel> mapper(dbClientPtr);
     mapper.deleteByPrimaryKey(
         id,
-        [callbackPtr](const size_t count)
+        [callbackPtr, id](const size_t count)
         {
             if (count == 1)
             {
+                drogon::app().getPlugin<PricingEngine>()->levelChanged(id);
+                drogon::app().getPlugin<MemberLevels>()->levelChanged(id);
                 auto resp = HttpResponse::newHttpResponse();
                 resp->setStatusCode(k204NoContent);
                 (*callbackPtr)(resp);
@@ -422,6 +428,8 @@ void RestfulMemberLevelCtrlBase::create(const HttpRequestPtr &req,
             object,
             [req, callbackPtr, this](MemberLevel newObject)
             {
+                drogon::app().getPlugin<PricingEngine>()->levelChanged(newObject.getPrimaryKey());
+                drogon::app().getPlugin<MemberLevels>()->levelChanged(newObject.getPrimaryKey());
                 Json::Value ret;
                 ret["code"] = k200OK;
                 ret["message"] = "ok";
@@ -6,8 +6,153 @@
  */
 
 #include "RestfulOrderTableCtrl.h"
+#include "KitchenOrders.h"
+#include "Money.h"
+#include "OrderEvents.h"
+#include "PricingEngine.h"
+#include "VoucherEngine.h"
+#include <atomic>
 #include <string>
 
+namespace
+{
+// 修改状态时按状态机校验；订单在厨房队列中时以队列中的状态为准，推进后可能尚未写库
+bool checkTransition(const Json::Value &json, const OrderTable &before, std::string &err)
+{
+    const auto &status = json["order_status"];
+    if (status.isString() && !status.asString().empty())
+    {
+        auto from = before.getValueOfOrderStatus();
+        drogon::app().getPlugin<KitchenOrders>()->statusOf(before.getValueOfOrderId(), from);
+        if (!OrderFlow::checkStatus(from, status.asString(), err))
+            return false;
+    }
+    const auto &payment = json["payment_status"];
+    return !payment.isString() || payment.asString().empty() ||
+           OrderFlow::checkPayment(before.getValueOfPaymentStatus(), payment.asString(), err);
+}
+
+// 与基类 RestfulOrderTableCtrlBase 相同的 {"error"} 格式
+HttpResponsePtr failure(HttpStatusCode code, const std::string &error)
+{
+    Json::Value ret;
+    ret["error"] = error;
+    auto resp = HttpResponse::newHttpJsonResponse(ret);
+    resp->setStatusCode(code);
+    return resp;
+}
+
+HttpResponsePtr badRequest(const std::string &message, const Json::Value &data = Json::Value::null)
+{
+    Json::Value ret;
+    ret["code"] = k400BadRequest;
+    ret["message"] = message;
+    ret["data"] = data;
+    return HttpResponse::newHttpJsonResponse(ret);
+}
+
+bool parseDetail(const Json::Value &text, Json::Value &detail)
+{
+    if (!text.isString())
+        return false;
+    std::string errs;
+    const auto &value = text.asString();
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    return reader->parse(value.data(), value.data() + value.size(), &detail, &errs) && detail.isObject();
+}
+
+// 下单时占用的券，订单写库成功后 confirm，失败时 release
+struct VoucherHold
+{
+    uint64_t seq{0};
+    uint32_t tenantId{0};
+    uint32_t campaignId{0};
+    uint32_t memberId{0};
+};
+
+// 按服务端规则和分店售价计价，改写 order_detail、total_amount、discount_ammout；
+// 明细中没有有效菜品或有不可售菜品时返回错误响应。
+// 明细带 voucher_code 时：新建订单占用该券（hold.seq 不为 0）；修改订单只能沿用 previous 中已核销的券
+HttpResponsePtr priceOrder(Json::Value &json,
+                           uint32_t tenantId,
+                           uint32_t branchId,
+                           const Json::Value *previous,
+                           VoucherHold &hold)
+{
+    Json::Value detail;
+    std::vector<PricingRules::Line> lines;
+    if (!parseDetail(json["order_detail"], detail) || !PricingRules::linesFromJson(detail["items"], lines))
+        return badRequest("订单明细中没有有效的菜品");
+
+    // 只接受前台验证过的会员ID，不把会员卡号等字符串当作主键
+    uint32_t memberId = 0;
+    const auto &member = detail["member_id"];
+    auto pricing = drogon::app().getPlugin<PricingEngine>();
+    if (member.isUInt())
+        memberId = member.asUInt();
+    else if (!member.isNull() && !(member.isString() && member.asString().empty()))
+        return badRequest("member_id 须为会员ID");
+    if (memberId != 0 && !pricing->hasMember(tenantId, memberId))
+        return badRequest("会员不存在");
+
+    uint32_t voucherCampaignId = 0;
+    const auto &code = detail["voucher_code"];
+    if (!code.isNull() && !code.isString())
+        return badRequest("voucher_code 须为券码");
+    if (code.isString() && !code.asString().empty())
+    {
+        if (previous)
+        {
+            if (!previous->isObject() || (*previous)["voucher_code"] != code ||
+                !(*previous)["voucher_campaign_id"].isUInt())
+                return badRequest("修改订单时不能使用新的券");
+            voucherCampaignId = (*previous)["voucher_campaign_id"].asUInt();
+        }
+        else
+        {
+            auto voucher = drogon::app().getPlugin<VoucherEngine>();
+            auto result = voucher->hold(tenantId, code.asString(), hold.seq, hold.campaignId);
+            if (result != VoucherEngine::Redeem::Ok)
+            {
+                hold.seq = 0;
+                return badRequest(VoucherEngine::describe(result));
+            }
+            hold.tenantId = tenantId;
+            hold.memberId = memberId;
+            voucherCampaignId = hold.campaignId;
+        }
+    }
+
+    PricingRules::Quote quote;
+    bool ok = pricing->quote(tenantId, branchId, memberId, lines, quote, voucherCampaignId);
+    // 券活动没有参与计价时不占用券
+    if (hold.seq != 0 && (!ok || quote.voucherCampaignId == 0))
+    {
+        drogon::app().getPlugin<VoucherEngine>()->release(hold.seq);
+        hold.seq = 0;
+    }
+    if (!ok)
+        return badRequest("存在不可售菜品", PricingRules::toJson(quote));
+
+    auto quoted = PricingRules::toJson(quote);
+    detail["items"] = quoted["lines"];
+    detail["applied"] = quoted["applied"];
+    detail["subtotal"] = quoted["subtotal"];
+    detail["discount_amount"] = quoted["discount"];
+    detail["discount_rate"] = quoted["member_rate"];
+    if (quote.voucherCampaignId != 0)
+        detail["voucher_campaign_id"] = quote.voucherCampaignId;
+    else
+        detail.removeMember("voucher_campaign_id");
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "";
+    json["order_detail"] = Json::writeString(writer, detail);
+    json["total_amount"] = quote.total.toJson();
+    json["discount_ammout"] = quote.discount.toJson();
+    return nullptr;
+}
+} // namespace
 
 void RestfulOrderTableCtrl::getOne(const HttpRequestPtr &req,
                                    std::function<void(const HttpResponsePtr &)> &&callback,
@@ -21,7 +166,170 @@ void RestfulOrderTableCtrl::updateOne(const HttpRequestPtr &req,
                                       std::function<void(const HttpResponsePtr &)> &&callback,
                                       OrderTable::PrimaryKeyType &&id)
 {
-    RestfulOrderTableCtrlBase::updateOne(req, std::move(callback), std::move(id));
+    // 先读出修改前的订单，报表按修改前后的差值调整
+    auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
+    drogon::orm::Mapper<OrderTable> mapper(getDbClient());
+    mapper.findByPrimaryKey(
+        id,
+        [this, req, callbackPtr, id](const OrderTable &before)
+        {
+            auto jsonPtr = req->jsonObject();
+            std::string err;
+            if (jsonPtr && !checkTransition(*jsonPtr, before, err))
+            {
+                (*callbackPtr)(failure(k400BadRequest, err));
+                return;
+            }
+            if (jsonPtr)
+            {
+                // 明细有变化时重新计价，否则不接受客户端改金额
+                Json::Value detail;
+                Json::Value previous;
+                if (jsonPtr->isMember("order_detail") && !(*jsonPtr)["order_detail"].isNull() &&
+                    !(parseDetail((*jsonPtr)["order_detail"], detail) &&
+                      parseDetail(Json::Value(before.getValueOfOrderDetail()), previous) && detail == previous))
+                {
+                    const auto &branch = (*jsonPtr)["branch_id"];
+                    VoucherHold hold;
+                    if (auto error = priceOrder(*jsonPtr,
+                                                before.getValueOfTenantId(),
+                                                branch.isUInt() ? branch.asUInt() : before.getValueOfBranchId(),
+                                                &previous,
+                                                hold))
+                    {
+                        (*callbackPtr)(error);
+                        return;
+                    }
+                }
+                else
+                {
+                    jsonPtr->removeMember("total_amount");
+                    jsonPtr->removeMember("discount_ammout");
+                }
+
+                const auto &status = (*jsonPtr)["order_status"];
+                if (status.isString() && !status.asString().empty())
+                {
+                    if (status.asString() != before.getValueOfOrderStatus())
+                    {
+                        updateWithStatus(*jsonPtr, before, callbackPtr);
+                        return;
+                    }
+                    // 状态没变时不写该列，以免覆盖读出之后厨房写回的状态
+                    jsonPtr->removeMember("order_status");
+                }
+            }
+            RestfulOrderTableCtrlBase::updateOne(
+                req,
+                [callbackPtr, before](const HttpResponsePtr &resp)
+                {
+                    auto json = resp->getJsonObject();
+                    if (json && (*json)["code"].asInt() == k200OK && (*json)["message"].asString() == "ok")
+                    {
+                        OrderEvents::updated(before);
+                    }
+                    (*callbackPtr)(resp);
+                },
+                OrderTable::PrimaryKeyType(id));
+        },
+        [this, req, callbackPtr, id](const DrogonDbException &e)
+        {
+            // 订单不存在时按基类的方式应答，其他数据库错误不能跳过状态校验直接写
+            if (!dynamic_cast<const UnexpectedRows *>(&e.base()))
+            {
+                LOG_ERROR << e.base().what();
+                (*callbackPtr)(failure(k500InternalServerError, "database error"));
+                return;
+            }
+            RestfulOrderTableCtrlBase::updateOne(
+                req, [callbackPtr](const HttpResponsePtr &resp) { (*callbackPtr)(resp); }, OrderTable::PrimaryKeyType(id));
+        });
+}
+
+void RestfulOrderTableCtrl::updateWithStatus(const Json::Value &json,
+                                             const OrderTable &before,
+                                             const std::shared_ptr<std::function<void(const HttpResponsePtr &)>> &callbackPtr)
+{
+    // 与基类 updateOne 相同的校验
+    std::string err;
+    if (!doCustomValidations(json, err) ||
+        !(isMasquerading() ? OrderTable::validateMasqueradedJsonForUpdate(json, masqueradingVector(), err)
+                           : OrderTable::validateJsonForUpdate(json, err)))
+    {
+        (*callbackPtr)(failure(k400BadRequest, err));
+        return;
+    }
+    OrderTable object;
+    try
+    {
+        if (isMasquerading())
+            object.updateByMasqueradedJson(json, masqueradingVector());
+        else
+            object.updateByJson(json);
+    }
+    catch (const Json::Exception &e)
+    {
+        LOG_ERROR << e.what();
+        (*callbackPtr)(failure(k400BadRequest, "Field type error"));
+        return;
+    }
+    if (object.getPrimaryKey() != before.getPrimaryKey())
+    {
+        (*callbackPtr)(failure(k400BadRequest, "Bad primary key"));
+        return;
+    }
+
+    getDbClient()->newTransactionAsync(
+        [object, before, callbackPtr](const std::shared_ptr<Transaction> &transaction)
+        {
+            if (!transaction)
+            {
+                (*callbackPtr)(failure(k500InternalServerError, "database error"));
+                return;
+            }
+            auto failed = std::make_shared<std::atomic<bool>>(false);
+            transaction->setCommitCallback(
+                [before, failed, callbackPtr](bool committed)
+                {
+                    if (*failed)
+                        return;
+                    if (!committed)
+                    {
+                        (*callbackPtr)(failure(k500InternalServerError, "database error"));
+                        return;
+                    }
+                    OrderEvents::updated(before);
+                    Json::Value ret;
+                    ret["code"] = k200OK;
+                    ret["message"] = "ok";
+                    (*callbackPtr)(HttpResponse::newHttpJsonResponse(ret));
+                });
+            // 出错时事务自动回滚且不再触发提交回调，在这里应答，只应答一次
+            auto onError = [failed, callbackPtr](const DrogonDbException &e)
+            {
+                LOG_ERROR << "Failed to update order: " << e.base().what();
+                if (!failed->exchange(true))
+                    (*callbackPtr)(failure(k500InternalServerError, "database error"));
+            };
+            // 与厨房队列写回状态相同的条件写：库中仍是读出时的状态才改，历史数据中为空的状态按空串比较
+            transaction->execSqlAsync(
+                "update order_table set order_status = ? where order_id = ? and coalesce(order_status, '') = ?",
+                [transaction, object, failed, callbackPtr, onError](const Result &result)
+                {
+                    if (result.affectedRows() == 0)
+                    {
+                        if (!failed->exchange(true))
+                            (*callbackPtr)(failure(k409Conflict, "订单状态已被修改，请刷新后重试"));
+                        transaction->rollback();
+                        return;
+                    }
+                    Mapper<OrderTable>(transaction).update(object, [](size_t) {}, onError);
+                },
+                onError,
+                object.getValueOfOrderStatus(),
+                before.getValueOfOrderId(),
+                before.getValueOfOrderStatus());
+        });
 }
 
 
@@ -29,7 +337,35 @@ void RestfulOrderTableCtrl::deleteOne(const HttpRequestPtr &req,
                                       std::function<void(const HttpResponsePtr &)> &&callback,
                                       OrderTable::PrimaryKeyType &&id)
 {
-    RestfulOrderTableCtrlBase::deleteOne(req, std::move(callback), std::move(id));
+    auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
+    drogon::orm::Mapper<OrderTable> mapper(getDbClient());
+    mapper.findByPrimaryKey(
+        id,
+        [this, req, callbackPtr, id](const OrderTable &before)
+        {
+            RestfulOrderTableCtrlBase::deleteOne(
+                req,
+                [callbackPtr, before](const HttpResponsePtr &resp)
+                {
+                    if (resp->getStatusCode() == k204NoContent)
+                    {
+                        OrderEvents::removed(before);
+                    }
+                    (*callbackPtr)(resp);
+                },
+                OrderTable::PrimaryKeyType(id));
+        },
+        [this, req, callbackPtr, id](const DrogonDbException &e)
+        {
+            if (!dynamic_cast<const UnexpectedRows *>(&e.base()))
+            {
+                LOG_ERROR << e.base().what();
+                (*callbackPtr)(failure(k500InternalServerError, "database error"));
+                return;
+            }
+            RestfulOrderTableCtrlBase::deleteOne(
+                req, [callbackPtr](const HttpResponsePtr &resp) { (*callbackPtr)(resp); }, OrderTable::PrimaryKeyType(id));
+        });
 }
 
 void RestfulOrderTableCtrl::get(const HttpRequestPtr &req,
@@ -41,5 +377,72 @@ void RestfulOrderTableCtrl::get(const HttpRequestPtr &req,
 void RestfulOrderTableCtrl::create(const HttpRequestPtr &req,
                                    std::function<void(const HttpResponsePtr &)> &&callback)
 {
-    RestfulOrderTableCtrlBase::create(req, std::move(callback));
+    // 金额一律按服务端规则计价，覆盖客户端提交的值
+    auto jsonPtr = req->jsonObject();
+    VoucherHold hold;
+    if (jsonPtr)
+    {
+        if (!(*jsonPtr)["tenant_id"].isUInt())
+        {
+            callback(badRequest("tenant_id 参数错误"));
+            return;
+        }
+        const auto &branch = (*jsonPtr)["branch_id"];
+        if (auto error = priceOrder(
+                *jsonPtr, (*jsonPtr)["tenant_id"].asUInt(), branch.isUInt() ? branch.asUInt() : 0, nullptr, hold))
+        {
+            callback(error);
+            return;
+        }
+    }
+    auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
+    RestfulOrderTableCtrlBase::create(
+        req,
+        [this, jsonPtr, callbackPtr, hold](const HttpResponsePtr &resp)
+        {
+            // 写库成功后按请求体和自增ID还原订单，与基类插入的对象一致
+            auto json = resp->getJsonObject();
+            bool created = jsonPtr && json && (*json)["code"].asInt() == k200OK &&
+                           (*json)["data"][OrderTable::primaryKeyName].isUInt();
+            if (created)
+            {
+                OrderTable order(isMasquerading() ? OrderTable(*jsonPtr, masqueradingVector()) : OrderTable(*jsonPtr));
+                order.setOrderId((*json)["data"][OrderTable::primaryKeyName].asUInt());
+                OrderEvents::created(order);
+            }
+            // 订单已按券计价，核销日志写失败时只能记下，由人工处理
+            auto voucher = drogon::app().getPlugin<VoucherEngine>();
+            if (hold.seq != 0 && created)
+            {
+                auto orderId = (*json)["data"][OrderTable::primaryKeyName].asUInt();
+                voucher->confirm(hold.seq,
+                                 hold.tenantId,
+                                 hold.campaignId,
+                                 orderId,
+                                 hold.memberId,
+                                 [orderId](VoucherEngine::Redeem result, uint32_t)
+                                 {
+                                     if (result != VoucherEngine::Redeem::Ok)
+                                         LOG_ERROR << "Order " << orderId
+                                                   << " was priced with a voucher that failed to redeem";
+                                 });
+            }
+            else if (hold.seq != 0)
+            {
+                voucher->release(hold.seq);
+            }
+            (*callbackPtr)(resp);
+        });
+}
+
+bool RestfulOrderTableCtrl::doCustomValidations(const Json::Value &pJson, std::string &err)
+{
+    // 为空表示未设置；能否从原状态改过来在 updateOne 中按修改前的订单校验
+    const auto &status = pJson["order_status"];
+    if (status.isString() && !status.asString().empty() && !OrderFlow::checkStatus("", status.asString(), err))
+        return false;
+    const auto &payment = pJson["payment_status"];
+    if (payment.isString() && !payment.asString().empty() && !OrderFlow::checkPayment("", payment.asString(), err))
+        return false;
+    return Money::checkFields(pJson, {"total_amount", "discount_ammout"}, err);
 }
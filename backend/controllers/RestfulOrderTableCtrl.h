@@ -43,4 +43,14 @@ public:
            std::function<void(const HttpResponsePtr &)> &&callback);
   void create(const HttpRequestPtr &req,
               std::function<void(const HttpResponsePtr &)> &&callback);
+
+protected:
+  // order_status、payment_status 须为 OrderFlow 中的状态，金额须为十进制数
+  bool doCustomValidations(const Json::Value &pJson, std::string &err) override;
+
+private:
+  // 改订单状态：在事务中先按读出时的状态条件写 order_status，库中状态已被改过时回滚并返回 409
+  void updateWithStatus(const Json::Value &json,
+                        const OrderTable &before,
+                        const std::shared_ptr<std::function<void(const HttpResponsePtr &)>> &callbackPtr);
 };
@@ -442,6 +442,7 @@ RestfulOrderTableCtrlBase::RestfulOrderTableCtrlBase()
     : RestfulController({"order_id",
                          "tenant_id",
                          "user_id",
+                         "branch_id",
                          "total_amount",
                          "discount_ammout",
                          "payment_method",
@@ -463,6 +464,7 @@ RestfulOrderTableCtrlBase::RestfulOrderTableCtrlBase()
         "order_id",         // the alias for the order_id column.
         "tenant_id",        // the alias for the tenant_id column.
         "user_id",          // the alias for the user_id column.
+        "branch_id",        // the alias for the branch_id column.
         "total_amount",     // the alias for the total_amount column.
         "discount_ammout",  // the alias for the discount_ammout column.
         "payment_method",   // the alias for the payment_method column.
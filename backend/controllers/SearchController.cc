@@ -0,0 +1,99 @@
+#include "SearchController.h"
+#include "plugins/DishSearch.h"
+#include "plugins/MemberSearch.h"
+
+namespace
+{
+constexpr uint64_t kDefaultLimit = 10;
+constexpr uint64_t kDefaultDishLimit = 20;
+constexpr size_t kMaxDishQuery = 256;
+
+void badRequest(const std::function<void(const HttpResponsePtr &)> &callback, const std::string &message)
+{
+  Json::Value response;
+  response["code"] = k400BadRequest;
+  response["message"] = message;
+  response["data"] = Json::Value::null;
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
+
+// 非负整数参数，为空时取 fallback
+bool parseNumber(const std::string &value, uint64_t fallback, uint64_t &number)
+{
+  number = fallback;
+  if (value.empty())
+    return true;
+  if (value.size() > 9 || value.find_first_not_of("0123456789") != std::string::npos)
+    return false;
+  number = std::stoull(value);
+  return true;
+}
+} // namespace
+
+void SearchController::members(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const
+{
+  uint64_t tenantId = 0;
+  if (!parseNumber(req->getParameter("tenant_id"), 0, tenantId) || tenantId == 0)
+  {
+    badRequest(callback, "tenant_id 参数错误");
+    return;
+  }
+  const auto &query = req->getParameter("q");
+  if (query.empty() || query.size() > PrefixIndex::kMaxKey)
+  {
+    badRequest(callback, "q 不能为空且不超过 " + std::to_string(PrefixIndex::kMaxKey) + " 字节");
+    return;
+  }
+  auto search = app().getPlugin<MemberSearch>();
+  uint64_t limit = 0;
+  if (!parseNumber(req->getParameter("limit"), kDefaultLimit, limit) || limit == 0 || limit > search->maxLimit())
+  {
+    badRequest(callback, "limit 须为 1 到 " + std::to_string(search->maxLimit()) + " 的整数");
+    return;
+  }
+
+  Json::Value data(Json::arrayValue);
+  for (const auto &match : search->search(static_cast<uint32_t>(tenantId), query, limit))
+  {
+    Json::Value member;
+    member["member_id"] = match.memberId;
+    member["phone"] = match.phone;
+    member["username"] = match.username;
+    data.append(member);
+  }
+
+  Json::Value response;
+  response["code"] = k200OK;
+  response["message"] = "ok";
+  response["data"] = data;
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
+
+void SearchController::dishes(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const
+{
+  uint64_t tenantId = 0;
+  if (!parseNumber(req->getParameter("tenant_id"), 0, tenantId) || tenantId == 0)
+  {
+    badRequest(callback, "tenant_id 参数错误");
+    return;
+  }
+  const auto &query = req->getParameter("q");
+  if (query.empty() || query.size() > kMaxDishQuery)
+  {
+    badRequest(callback, "q 不能为空且不超过 " + std::to_string(kMaxDishQuery) + " 字节");
+    return;
+  }
+  auto search = app().getPlugin<DishSearch>();
+  uint64_t limit = 0;
+  if (!parseNumber(req->getParameter("limit"), kDefaultDishLimit, limit) || limit == 0 || limit > search->maxLimit())
+  {
+    badRequest(callback, "limit 须为 1 到 " + std::to_string(search->maxLimit()) + " 的整数");
+    return;
+  }
+
+  Json::Value response;
+  response["code"] = k200OK;
+  response["message"] = "ok";
+  response["data"] = search->search(static_cast<uint32_t>(tenantId), query, limit);
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+using namespace drogon;
+
+class SearchController : public drogon::HttpController<SearchController>
+{
+public:
+  METHOD_LIST_BEGIN
+  ADD_METHOD_TO(SearchController::members, "/api/member/search", Get, Options, "AuthFilter"); // 收银台查找会员
+  ADD_METHOD_TO(SearchController::dishes, "/api/dish/search", Get, Options, "AuthFilter");    // 菜品全文检索
+  METHOD_LIST_END
+
+  // tenant_id、q 必填，q 为手机号或用户名片段，不区分大小写；3 字节以上的 q 同时匹配中间片段（如尾号）。
+  // limit 默认 10；返回 [{member_id, phone, username}]，开头匹配的排在前面
+  void members(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+  // tenant_id、q 必填，q 按空白拆成多个词，须全部命中；可输入菜名、描述中的片段或菜名拼音首字母（如 gbjd）。
+  // limit 默认 20；返回菜品数组，score 越大匹配越好，同分按 sort_order、销量从高到低
+  void dishes(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+};
@@ -0,0 +1,130 @@
+#include "SegmentController.h"
+#include "plugins/MemberSegments.h"
+#include "plugins/Money.h"
+#include <drogon/utils/Utilities.h>
+
+namespace
+{
+constexpr uint64_t kMaxLimit = 10000;
+
+void badRequest(const std::function<void(const HttpResponsePtr &)> &callback, const std::string &message)
+{
+  Json::Value response;
+  response["code"] = k400BadRequest;
+  response["message"] = message;
+  response["data"] = Json::Value::null;
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
+
+// 非负整数参数，为空时返回 0
+bool parseNumber(const std::string &value, uint64_t &number)
+{
+  number = 0;
+  if (value.empty())
+    return true;
+  if (value.size() > 9 || value.find_first_not_of("0123456789") != std::string::npos)
+    return false;
+  number = std::stoull(value);
+  return true;
+}
+
+// 逗号分隔的非负整数列表
+template <typename T>
+bool parseList(const std::string &value, std::vector<T> &numbers)
+{
+  for (const auto &item : utils::splitString(value, ","))
+  {
+    uint64_t number = 0;
+    if (item.empty() || !parseNumber(item, number))
+      return false;
+    numbers.push_back(static_cast<T>(number));
+  }
+  return true;
+}
+} // namespace
+
+void SegmentController::select(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const
+{
+  uint64_t tenantId = 0;
+  if (!parseNumber(req->getParameter("tenant_id"), tenantId) || tenantId == 0)
+  {
+    badRequest(callback, "tenant_id 参数错误");
+    return;
+  }
+  SegmentIndex::Filter filter;
+  if (!parseList(req->getParameter("level_id"), filter.levels))
+  {
+    badRequest(callback, "level_id 参数错误");
+    return;
+  }
+  if (!parseList(req->getParameter("spend_bucket"), filter.spendBuckets))
+  {
+    badRequest(callback, "spend_bucket 参数错误");
+    return;
+  }
+  if (!parseList(req->getParameter("recency_bucket"), filter.recencyBuckets))
+  {
+    badRequest(callback, "recency_bucket 参数错误");
+    return;
+  }
+  if (!parseList(req->getParameter("r_score"), filter.recencyScores) ||
+      !parseList(req->getParameter("f_score"), filter.frequencyScores) ||
+      !parseList(req->getParameter("m_score"), filter.monetaryScores))
+  {
+    badRequest(callback, "r_score、f_score 或 m_score 参数错误");
+    return;
+  }
+  auto status = req->getParameter("status");
+  if (!status.empty())
+    filter.statuses = utils::splitString(status, ",");
+  uint64_t offset = 0;
+  uint64_t limit = 0;
+  if (!parseNumber(req->getParameter("offset"), offset) || !parseNumber(req->getParameter("limit"), limit) ||
+      limit > kMaxLimit)
+  {
+    badRequest(callback, "offset 或 limit 参数错误");
+    return;
+  }
+
+  auto segments = app().getPlugin<MemberSegments>();
+  std::vector<uint32_t> ids;
+  auto count = segments->select(static_cast<uint32_t>(tenantId), filter, offset, limit, ids);
+
+  Json::Value data;
+  data["count"] = static_cast<Json::UInt64>(count);
+  data["window_days"] = segments->windowDays();
+  // 第 i 档为 [min, max)，最后一档没有上限
+  data["spend_buckets"] = Json::arrayValue;
+  const auto &spendBounds = segments->spendBounds();
+  for (size_t i = 0; i <= spendBounds.size(); ++i)
+  {
+    Json::Value bucket;
+    bucket["bucket"] = static_cast<Json::UInt>(i);
+    bucket["min"] = Money::fromRaw(i == 0 ? 0 : spendBounds[i - 1]).toJson();
+    bucket["max"] = i == spendBounds.size() ? Json::Value::null : Money::fromRaw(spendBounds[i]).toJson();
+    data["spend_buckets"].append(bucket);
+  }
+  // 第 i 档为距最近消费不超过 max_days 天，倒数第二档没有上限，最后一档为从未消费
+  data["recency_buckets"] = Json::arrayValue;
+  const auto &recencyBounds = segments->recencyBounds();
+  for (size_t i = 0; i <= recencyBounds.size() + 1; ++i)
+  {
+    Json::Value bucket;
+    bucket["bucket"] = static_cast<Json::UInt>(i);
+    bucket["max_days"] = i < recencyBounds.size() ? Json::Value(recencyBounds[i]) : Json::Value::null;
+    bucket["never"] = i == recencyBounds.size() + 1;
+    data["recency_buckets"].append(bucket);
+  }
+  if (limit > 0)
+  {
+    data["member_ids"] = Json::arrayValue;
+    for (auto id : ids)
+      data["member_ids"].append(id);
+  }
+
+  Json::Value response;
+  response["code"] = k200OK;
+  response["message"] = "ok";
+  response["data"] = data;
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+using namespace drogon;
+
+class SegmentController : public drogon::HttpController<SegmentController>
+{
+public:
+  METHOD_LIST_BEGIN
+  ADD_METHOD_TO(SegmentController::select, "/api/member/segment", Get, Options, "AuthFilter"); // 会员分群圈选
+  METHOD_LIST_END
+
+  // tenant_id 必填；level_id、status、spend_bucket、recency_bucket 为逗号分隔的列表，同一参数内取并集，
+  // 不同参数之间取交集，省略表示不限。r_score、f_score、m_score 按 RFM 评分（1-5，0 为未评分）圈选，用法相同。
+  // 返回人数和各档边界；limit 大于 0 时另返回按ID升序从 offset 起的会员ID
+  void select(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+};
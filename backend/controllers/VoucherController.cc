@@ -0,0 +1,108 @@
+#include "VoucherController.h"
+#include "plugins/VoucherEngine.h"
+
+namespace
+{
+void reply(const std::function<void(const HttpResponsePtr &)> &callback,
+           int code,
+           const std::string &message,
+           const Json::Value &data = Json::Value::null)
+{
+  Json::Value response;
+  response["code"] = code;
+  response["message"] = message;
+  response["data"] = data;
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
+
+bool optionalId(const Json::Value &value)
+{
+  return value.isNull() || value.isUInt();
+}
+} // namespace
+
+void VoucherController::issue(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const
+{
+  auto json = req->getJsonObject();
+  if (!json || !json->isObject() || !(*json)["tenant_id"].isUInt() || !(*json)["campaign_id"].isUInt())
+  {
+    reply(callback, k400BadRequest, "tenant_id、campaign_id 参数错误");
+    return;
+  }
+  auto engine = app().getPlugin<VoucherEngine>();
+  const auto &count = (*json)["count"];
+  if (!count.isUInt() || count.asUInt() == 0 || count.asUInt() > engine->maxIssue())
+  {
+    reply(callback, k400BadRequest, "count 须为 1 到 " + std::to_string(engine->maxIssue()) + " 的整数");
+    return;
+  }
+
+  auto campaignId = (*json)["campaign_id"].asUInt();
+  auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
+  engine->issue(
+      (*json)["tenant_id"].asUInt(),
+      campaignId,
+      count.asUInt(),
+      [callbackPtr, campaignId](std::vector<std::string> codes)
+      {
+        if (codes.empty())
+        {
+          reply(*callbackPtr, k404NotFound, "营销活动不存在");
+          return;
+        }
+        Json::Value data;
+        data["campaign_id"] = campaignId;
+        data["codes"] = Json::arrayValue;
+        for (auto &code : codes)
+          data["codes"].append(std::move(code));
+        reply(*callbackPtr, k200OK, "ok", data);
+      },
+      [callbackPtr](const std::string &message) { reply(*callbackPtr, k500InternalServerError, message); });
+}
+
+void VoucherController::redeem(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const
+{
+  auto json = req->getJsonObject();
+  if (!json || !json->isObject() || !(*json)["tenant_id"].isUInt() || !(*json)["code"].isString() ||
+      !optionalId((*json)["order_id"]) || !optionalId((*json)["member_id"]))
+  {
+    reply(callback, k400BadRequest, "参数错误");
+    return;
+  }
+  auto code = (*json)["code"].asString();
+  app().getPlugin<VoucherEngine>()->redeem(
+      (*json)["tenant_id"].asUInt(),
+      code,
+      (*json)["order_id"].asUInt(),
+      (*json)["member_id"].asUInt(),
+      [callback = std::move(callback), code](VoucherEngine::Redeem result, uint32_t campaignId)
+      {
+        switch (result)
+        {
+          case VoucherEngine::Redeem::Ok:
+          {
+            Json::Value data;
+            data["code"] = code;
+            data["campaign_id"] = campaignId;
+            reply(callback, k200OK, "ok", data);
+            break;
+          }
+          case VoucherEngine::Redeem::AlreadyRedeemed:
+            reply(callback, k409Conflict, VoucherEngine::describe(result));
+            break;
+          case VoucherEngine::Redeem::Voided:
+            reply(callback, k410Gone, VoucherEngine::describe(result));
+            break;
+          case VoucherEngine::Redeem::Inactive:
+            reply(callback, k403Forbidden, VoucherEngine::describe(result));
+            break;
+          case VoucherEngine::Redeem::Disabled:
+          case VoucherEngine::Redeem::Failed:
+            reply(callback, k503ServiceUnavailable, VoucherEngine::describe(result));
+            break;
+          default:
+            reply(callback, k404NotFound, VoucherEngine::describe(result));
+            break;
+        }
+      });
+}
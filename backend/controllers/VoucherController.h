@@ -0,0 +1,19 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+using namespace drogon;
+
+class VoucherController : public drogon::HttpController<VoucherController>
+{
+public:
+  METHOD_LIST_BEGIN
+  ADD_METHOD_TO(VoucherController::issue, "/api/voucher/issue", Post, Options, "AuthFilter");   // 批量发券
+  ADD_METHOD_TO(VoucherController::redeem, "/api/voucher/redeem", Post, Options, "AuthFilter"); // 核销
+  METHOD_LIST_END
+
+  // 请求体 {"tenant_id": 1, "campaign_id": 2, "count": 100}，返回 data.codes
+  void issue(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+  // 请求体 {"tenant_id": 1, "code": "...", "order_id": 3, "member_id": 4}，order_id、member_id 可省略；
+  // 券码无效为 404，活动不在进行中为 403，已核销为 409，已作废为 410，未配置密钥或暂不可用为 503
+  void redeem(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+};
@@ -0,0 +1,53 @@
+#include "WarningController.h"
+#include "plugins/StockWarningEngine.h"
+
+void WarningController::getWarnings(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const
+{
+  Json::Value response;
+  uint32_t tenantId = 0;
+  auto tenantParam = req->getParameter("tenant_id");
+  try
+  {
+    if (!tenantParam.empty())
+      tenantId = static_cast<uint32_t>(std::stoul(tenantParam));
+  }
+  catch (const std::exception &)
+  {
+    response["code"] = k400BadRequest;
+    response["message"] = "tenant_id 参数错误";
+    response["data"] = Json::Value::null;
+    callback(HttpResponse::newHttpJsonResponse(response));
+    return;
+  }
+
+  auto status = req->getParameter("status");
+  if (status.empty())
+    status = "ACTIVE";
+  if (status != "ACTIVE" && status != "RESOLVED" && status != "ALL")
+  {
+    response["code"] = k400BadRequest;
+    response["message"] = "status 参数错误";
+    response["data"] = Json::Value::null;
+    callback(HttpResponse::newHttpJsonResponse(response));
+    return;
+  }
+
+  // 直接读取内存中的活跃预警，不扫描库存表
+  auto engine = drogon::app().getPlugin<StockWarningEngine>();
+  Json::Value data(Json::arrayValue);
+  if (status != "RESOLVED")
+  {
+    for (const auto &warning : engine->index().active(tenantId))
+      data.append(StockWarningEngine::toJson(warning));
+  }
+  if (status != "ACTIVE")
+  {
+    for (const auto &warning : engine->index().resolved(tenantId))
+      data.append(StockWarningEngine::toJson(warning));
+  }
+
+  response["code"] = k200OK;
+  response["message"] = "ok";
+  response["data"] = data;
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
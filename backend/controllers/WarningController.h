@@ -0,0 +1,15 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+using namespace drogon;
+
+class WarningController : public drogon::HttpController<WarningController>
+{
+public:
+  METHOD_LIST_BEGIN
+  ADD_METHOD_TO(WarningController::getWarnings, "/api/warnings", Get, Options, "AuthFilter"); // 库存预警列表
+  METHOD_LIST_END
+
+  // tenant_id 为空或 0 时返回全部租户；status 可选 ACTIVE、RESOLVED、ALL，默认 ACTIVE
+  void getWarnings(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+};
@@ -0,0 +1,39 @@
+#include "WarningWebSocket.h"
+#include "plugins/StockWarningEngine.h"
+
+void WarningWebSocket::handleNewMessage(const WebSocketConnectionPtr &wsConnPtr, std::string &&message, const WebSocketMessageType &type)
+{
+  // 只向客户端推送，忽略客户端消息
+}
+
+void WarningWebSocket::handleNewConnection(const HttpRequestPtr &req, const WebSocketConnectionPtr &wsConnPtr)
+{
+  uint32_t tenantId = 0;
+  try
+  {
+    auto tenantParam = req->getParameter("tenant_id");
+    if (!tenantParam.empty())
+      tenantId = static_cast<uint32_t>(std::stoul(tenantParam));
+  }
+  catch (const std::exception &)
+  {
+    wsConnPtr->shutdown(CloseCode::kInvalidMessage, "tenant_id 参数错误");
+    return;
+  }
+
+  auto engine = drogon::app().getPlugin<StockWarningEngine>();
+  engine->subscribe(tenantId, wsConnPtr);
+
+  // 连接建立后先发送当前活跃预警
+  Json::Value message;
+  message["type"] = "snapshot";
+  message["data"] = Json::Value(Json::arrayValue);
+  for (const auto &warning : engine->index().active(tenantId))
+    message["data"].append(StockWarningEngine::toJson(warning));
+  wsConnPtr->send(message.toStyledString());
+}
+
+void WarningWebSocket::handleConnectionClosed(const WebSocketConnectionPtr &wsConnPtr)
+{
+  drogon::app().getPlugin<StockWarningEngine>()->unsubscribe(wsConnPtr);
+}
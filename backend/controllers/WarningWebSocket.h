@@ -0,0 +1,16 @@
+#pragma once
+
+#include <drogon/WebSocketController.h>
+using namespace drogon;
+
+class WarningWebSocket : public drogon::WebSocketController<WarningWebSocket>
+{
+public:
+  WS_PATH_LIST_BEGIN
+  WS_PATH_ADD("/ws/warnings", "AuthFilter"); // 库存预警推送，参数 tenant_id、ticket（/api/ws/ticket 签发）
+  WS_PATH_LIST_END
+
+  void handleNewMessage(const WebSocketConnectionPtr &wsConnPtr, std::string &&message, const WebSocketMessageType &type) override;
+  void handleNewConnection(const HttpRequestPtr &req, const WebSocketConnectionPtr &wsConnPtr) override;
+  void handleConnectionClosed(const WebSocketConnectionPtr &wsConnPtr) override;
+};
@@ -0,0 +1,38 @@
+#include "WsTicketController.h"
+#include "plugins/WsTickets.h"
+
+namespace
+{
+void reply(const std::function<void(const HttpResponsePtr &)> &callback,
+           int code,
+           const std::string &message,
+           const Json::Value &data = Json::Value::null)
+{
+  Json::Value response;
+  response["code"] = code;
+  response["message"] = message;
+  response["data"] = data;
+  callback(HttpResponse::newHttpJsonResponse(response));
+}
+
+const char *const kSocketPaths[] = {"/ws/warnings", "/ws/kitchen"};
+} // namespace
+
+void WsTicketController::issue(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const
+{
+  auto json = req->getJsonObject();
+  std::string path = json && json->isObject() ? (*json)["path"].asString() : "";
+  bool known = false;
+  for (auto socketPath : kSocketPaths)
+    known = known || path == socketPath;
+  if (!known)
+  {
+    reply(callback, k400BadRequest, "path 参数错误");
+    return;
+  }
+  auto tickets = app().getPlugin<WsTickets>();
+  Json::Value data;
+  data["ticket"] = tickets->issue(path);
+  data["expires_in"] = tickets->ttl();
+  reply(callback, k200OK, "ok", data);
+}
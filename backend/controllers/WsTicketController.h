@@ -0,0 +1,16 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+using namespace drogon;
+
+class WsTicketController : public drogon::HttpController<WsTicketController>
+{
+public:
+  METHOD_LIST_BEGIN
+  ADD_METHOD_TO(WsTicketController::issue, "/api/ws/ticket", Post, Options, "AuthFilter"); // 签发 WebSocket 连接票据
+  METHOD_LIST_END
+
+  // 请求体 {"path": "/ws/kitchen"}，path 为 /ws/warnings 或 /ws/kitchen；
+  // 返回 {ticket, expires_in}，以 ?ticket= 发起升级请求，票据只能用一次
+  void issue(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+};
@@ -5,6 +5,7 @@
  */
 
 #include "AuthFilter.h"
+#include "plugins/WsTickets.h"
 #include <jwt-cpp/jwt.h>
 #include <chrono>
 #include <drogon/drogon.h>
@@ -31,7 +32,24 @@ void AuthFilter::doFilter(const HttpRequestPtr &req,
                           FilterChainCallback &&fccb)
 {
     // 获取 Authorization header
-    const auto &header = req->getHeader("Authorization");
+    std::string header = req->getHeader("Authorization");
+
+    // 浏览器 WebSocket 无法设置请求头，/ws/ 的升级请求改用 /api/ws/ticket 签发的一次性票据
+    const auto &ticket = req->getParameter("ticket");
+    if (header.empty() && !ticket.empty() && req->path().compare(0, 4, "/ws/") == 0)
+    {
+        if (app().getPlugin<WsTickets>()->consume(ticket, req->path()))
+        {
+            fccb();
+            return;
+        }
+        Json::Value response;
+        response["code"] = 401;
+        response["message"] = "票据无效或已过期";
+        response["data"] = Json::Value(Json::nullValue);
+        fcb(HttpResponse::newHttpJsonResponse(response));
+        return;
+    }
 
     if (header.empty() || header.substr(0, 7) != "Bearer ")
     {
@@ -0,0 +1,28 @@
+-- 金额、比例列由 varchar 改为 DECIMAL
+-- 已有数据中无法解析为数字的值（空串、"¥12" 等）先置为 NULL，避免 MODIFY 失败或被截断为 0
+-- 执行前请先备份；在 MariaDB 10.5 上验证
+
+UPDATE `saas_restaurant`.`consumption_record` SET `amount` = NULL WHERE `amount` NOT REGEXP '^[[:space:]]*[-+]?([0-9]+[.]?[0-9]*|[.][0-9]+)[[:space:]]*$';
+UPDATE `saas_restaurant`.`dish` SET `dish_price` = NULL WHERE `dish_price` NOT REGEXP '^[[:space:]]*[-+]?([0-9]+[.]?[0-9]*|[.][0-9]+)[[:space:]]*$';
+UPDATE `saas_restaurant`.`dish` SET `cost_price` = NULL WHERE `cost_price` NOT REGEXP '^[[:space:]]*[-+]?([0-9]+[.]?[0-9]*|[.][0-9]+)[[:space:]]*$';
+UPDATE `saas_restaurant`.`dish` SET `origin_price` = NULL WHERE `origin_price` NOT REGEXP '^[[:space:]]*[-+]?([0-9]+[.]?[0-9]*|[.][0-9]+)[[:space:]]*$';
+UPDATE `saas_restaurant`.`inventory` SET `item_cost` = NULL WHERE `item_cost` NOT REGEXP '^[[:space:]]*[-+]?([0-9]+[.]?[0-9]*|[.][0-9]+)[[:space:]]*$';
+UPDATE `saas_restaurant`.`member` SET `total_spent` = NULL WHERE `total_spent` NOT REGEXP '^[[:space:]]*[-+]?([0-9]+[.]?[0-9]*|[.][0-9]+)[[:space:]]*$';
+UPDATE `saas_restaurant`.`member_level` SET `required_spent` = NULL WHERE `required_spent` NOT REGEXP '^[[:space:]]*[-+]?([0-9]+[.]?[0-9]*|[.][0-9]+)[[:space:]]*$';
+UPDATE `saas_restaurant`.`member_level` SET `discount_rate` = NULL WHERE `discount_rate` NOT REGEXP '^[[:space:]]*[-+]?([0-9]+[.]?[0-9]*|[.][0-9]+)[[:space:]]*$';
+UPDATE `saas_restaurant`.`order_table` SET `total_amount` = NULL WHERE `total_amount` NOT REGEXP '^[[:space:]]*[-+]?([0-9]+[.]?[0-9]*|[.][0-9]+)[[:space:]]*$';
+UPDATE `saas_restaurant`.`order_table` SET `discount_ammout` = NULL WHERE `discount_ammout` NOT REGEXP '^[[:space:]]*[-+]?([0-9]+[.]?[0-9]*|[.][0-9]+)[[:space:]]*$';
+
+ALTER TABLE `saas_restaurant`.`consumption_record` MODIFY COLUMN `amount` decimal(12, 2) NULL COMMENT '消费量';
+ALTER TABLE `saas_restaurant`.`dish`
+  MODIFY COLUMN `dish_price` decimal(12, 2) NULL COMMENT '销售价格',
+  MODIFY COLUMN `cost_price` decimal(12, 2) NULL COMMENT '成本价',
+  MODIFY COLUMN `origin_price` decimal(12, 2) NULL COMMENT '原价';
+ALTER TABLE `saas_restaurant`.`inventory` MODIFY COLUMN `item_cost` decimal(12, 2) NULL COMMENT '采购价';
+ALTER TABLE `saas_restaurant`.`member` MODIFY COLUMN `total_spent` decimal(12, 2) NULL COMMENT '累计消费金额';
+ALTER TABLE `saas_restaurant`.`member_level`
+  MODIFY COLUMN `required_spent` decimal(12, 2) NULL COMMENT '升级所需累计消费金额',
+  MODIFY COLUMN `discount_rate` decimal(6, 4) NULL COMMENT '折扣率';
+ALTER TABLE `saas_restaurant`.`order_table`
+  MODIFY COLUMN `total_amount` decimal(12, 2) NULL COMMENT '订单总金额（不含优惠）',
+  MODIFY COLUMN `discount_ammout` decimal(12, 2) NULL COMMENT '优惠金额';
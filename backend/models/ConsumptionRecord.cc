@@ -28,7 +28,7 @@ const std::string ConsumptionRecord::tableName = "consumption_record";
 const std::vector<typename ConsumptionRecord::MetaData> ConsumptionRecord::metaData_={
 {"record_id","uint32_t","int(10) unsigned",4,1,1,1},
 {"created_at","::trantor::Date","timestamp",0,0,0,0},
-{"amount","std::string","varchar(255)",255,0,0,0},
+{"amount","std::string","decimal(12,2)",0,0,0,0},
 {"order_items","std::string","varchar(255)",255,0,0,0},
 {"member_id","uint32_t","int(10) unsigned",4,0,0,0},
 {"tenant_id","uint32_t","int(10) unsigned",4,0,0,0},
@@ -1301,14 +1301,6 @@ bool ConsumptionRecord::validJsonOfField(size_t index,
                 err="Type error in the "+fieldName+" field";
                 return false;
             }
-            if(pJson.isString() && std::strlen(pJson.asCString()) > 255)
-            {
-                err="String length exceeds limit for the " +
-                    fieldName +
-                    " field (the maximum value is 255)";
-                return false;
-            }
-
             break;
         case 3:
             if(pJson.isNull())
@@ -40,9 +40,9 @@ const std::vector<typename Dish::MetaData> Dish::metaData_={
 {"tenant_id","uint32_t","int(10) unsigned",4,0,0,0},
 {"dish_category_id","uint32_t","int(10) unsigned",4,0,0,0},
 {"dish_name","std::string","varchar(255)",255,0,0,0},
-{"dish_price","std::string","varchar(255)",255,0,0,0},
-{"cost_price","std::string","varchar(255)",255,0,0,0},
-{"origin_price","std::string","varchar(255)",255,0,0,0},
+{"dish_price","std::string","decimal(12,2)",0,0,0,0},
+{"cost_price","std::string","decimal(12,2)",0,0,0,0},
+{"origin_price","std::string","decimal(12,2)",0,0,0,0},
 {"description","std::string","text",0,0,0,0},
 {"sales","uint32_t","int(10) unsigned",4,0,0,0},
 {"stock","uint32_t","int(10) unsigned",4,0,0,0},
@@ -2738,14 +2738,6 @@ bool Dish::validJsonOfField(size_t index,
                 err="Type error in the "+fieldName+" field";
                 return false;
             }
-            if(pJson.isString() && std::strlen(pJson.asCString()) > 255)
-            {
-                err="String length exceeds limit for the " +
-                    fieldName +
-                    " field (the maximum value is 255)";
-                return false;
-            }
-
             break;
         case 5:
             if(pJson.isNull())
@@ -2757,14 +2749,6 @@ bool Dish::validJsonOfField(size_t index,
                 err="Type error in the "+fieldName+" field";
                 return false;
             }
-            if(pJson.isString() && std::strlen(pJson.asCString()) > 255)
-            {
-                err="String length exceeds limit for the " +
-                    fieldName +
-                    " field (the maximum value is 255)";
-                return false;
-            }
-
             break;
         case 6:
             if(pJson.isNull())
@@ -2776,14 +2760,6 @@ bool Dish::validJsonOfField(size_t index,
                 err="Type error in the "+fieldName+" field";
                 return false;
             }
-            if(pJson.isString() && std::strlen(pJson.asCString()) > 255)
-            {
-                err="String length exceeds limit for the " +
-                    fieldName +
-                    " field (the maximum value is 255)";
-                return false;
-            }
-
             break;
         case 7:
             if(pJson.isNull())
@@ -0,0 +1,1599 @@
+/**
+ *
+ *  DishIngredient.cc
+ *  DO NOT EDIT. This file is generated by drogon_ctl
+ *
+ */
+
+#include "DishIngredient.h"
+#include <drogon/utils/Utilities.h>
+#include <string>
+
+using namespace drogon;
+using namespace drogon::orm;
+using namespace drogon_model::saas_restaurant;
+
+const std::string DishIngredient::Cols::_ingredient_id = "ingredient_id";
+const std::string DishIngredient::Cols::_tenant_id = "tenant_id";
+const std::string DishIngredient::Cols::_dish_id = "dish_id";
+const std::string DishIngredient::Cols::_item_id = "item_id";
+const std::string DishIngredient::Cols::_quantity = "quantity";
+const std::string DishIngredient::Cols::_created_at = "created_at";
+const std::string DishIngredient::Cols::_updated_at = "updated_at";
+const std::string DishIngredient::Cols::_is_deleted = "is_deleted";
+const std::string DishIngredient::primaryKeyName = "ingredient_id";
+const bool DishIngredient::hasPrimaryKey = true;
+const std::string DishIngredient::tableName = "dish_ingredient";
+
+const std::vector<typename DishIngredient::MetaData> DishIngredient::metaData_={
+{"ingredient_id","uint32_t","int(10) unsigned",4,1,1,1},
+{"tenant_id","uint32_t","int(10) unsigned",4,0,0,0},
+{"dish_id","uint32_t","int(10) unsigned",4,0,0,0},
+{"item_id","uint32_t","int(10) unsigned",4,0,0,0},
+{"quantity","int32_t","int(11)",4,0,0,0},
+{"created_at","::trantor::Date","timestamp",0,0,0,0},
+{"updated_at","::trantor::Date","timestamp",0,0,0,0},
+{"is_deleted","int8_t","tinyint(1)",1,0,0,0}
+};
+const std::string &DishIngredient::getColumnName(size_t index) noexcept(false)
+{
+    assert(index < metaData_.size());
+    return metaData_[index].colName_;
+}
+DishIngredient::DishIngredient(const Row &r, const ssize_t indexOffset) noexcept
+{
+    if(indexOffset < 0)
+    {
+        if(!r["ingredient_id"].isNull())
+        {
+            ingredientId_=std::make_shared<uint32_t>(r["ingredient_id"].as<uint32_t>());
+        }
+        if(!r["tenant_id"].isNull())
+        {
+            tenantId_=std::make_shared<uint32_t>(r["tenant_id"].as<uint32_t>());
+        }
+        if(!r["dish_id"].isNull())
+        {
+            dishId_=std::make_shared<uint32_t>(r["dish_id"].as<uint32_t>());
+        }
+        if(!r["item_id"].isNull())
+        {
+            itemId_=std::make_shared<uint32_t>(r["item_id"].as<uint32_t>());
+        }
+        if(!r["quantity"].isNull())
+        {
+            quantity_=std::make_shared<int32_t>(r["quantity"].as<int32_t>());
+        }
+        if(!r["created_at"].isNull())
+        {
+            auto timeStr = r["created_at"].as<std::string>();
+            struct tm stm;
+            memset(&stm,0,sizeof(stm));
+            auto p = strptime(timeStr.c_str(),"%Y-%m-%d %H:%M:%S",&stm);
+            time_t t = mktime(&stm);
+            size_t decimalNum = 0;
+            if(p)
+            {
+                if(*p=='.')
+                {
+                    std::string decimals(p+1,&timeStr[timeStr.length()]);
+                    while(decimals.length()<6)
+                    {
+                        decimals += "0";
+                    }
+                    decimalNum = (size_t)atol(decimals.c_str());
+                }
+                createdAt_=std::make_shared<::trantor::Date>(t*1000000+decimalNum);
+            }
+        }
+        if(!r["updated_at"].isNull())
+        {
+            auto timeStr = r["updated_at"].as<std::string>();
+            struct tm stm;
+            memset(&stm,0,sizeof(stm));
+            auto p = strptime(timeStr.c_str(),"%Y-%m-%d %H:%M:%S",&stm);
+            time_t t = mktime(&stm);
+            size_t decimalNum = 0;
+            if(p)
+            {
+                if(*p=='.')
+                {
+                    std::string decimals(p+1,&timeStr[timeStr.length()]);
+                    while(decimals.length()<6)
+                    {
+                        decimals += "0";
+                    }
+                    decimalNum = (size_t)atol(decimals.c_str());
+                }
+                updatedAt_=std::make_shared<::trantor::Date>(t*1000000+decimalNum);
+            }
+        }
+        if(!r["is_deleted"].isNull())
+        {
+            isDeleted_=std::make_shared<int8_t>(r["is_deleted"].as<int8_t>());
+        }
+    }
+    else
+    {
+        size_t offset = (size_t)indexOffset;
+        if(offset + 8 > r.size())
+        {
+            LOG_FATAL << "Invalid SQL result for this model";
+            return;
+        }
+        size_t index;
+        index = offset + 0;
+        if(!r[index].isNull())
+        {
+            ingredientId_=std::make_shared<uint32_t>(r[index].as<uint32_t>());
+        }
+        index = offset + 1;
+        if(!r[index].isNull())
+        {
+            tenantId_=std::make_shared<uint32_t>(r[index].as<uint32_t>());
+        }
+        index = offset + 2;
+        if(!r[index].isNull())
+        {
+            dishId_=std::make_shared<uint32_t>(r[index].as<uint32_t>());
+        }
+        index = offset + 3;
+        if(!r[index].isNull())
+        {
+            itemId_=std::make_shared<uint32_t>(r[index].as<uint32_t>());
+        }
+        index = offset + 4;
+        if(!r[index].isNull())
+        {
+            quantity_=std::make_shared<int32_t>(r[index].as<int32_t>());
+        }
+        index = offset + 5;
+        if(!r[index].isNull())
+        {
+            auto timeStr = r[index].as<std::string>();
+            struct tm stm;
+            memset(&stm,0,sizeof(stm));
+            auto p = strptime(timeStr.c_str(),"%Y-%m-%d %H:%M:%S",&stm);
+            time_t t = mktime(&stm);
+            size_t decimalNum = 0;
+            if(p)
+            {
+                if(*p=='.')
+                {
+                    std::string decimals(p+1,&timeStr[timeStr.length()]);
+                    while(decimals.length()<6)
+                    {
+                        decimals += "0";
+                    }
+                    decimalNum = (size_t)atol(decimals.c_str());
+                }
+                createdAt_=std::make_shared<::trantor::Date>(t*1000000+decimalNum);
+            }
+        }
+        index = offset + 6;
+        if(!r[index].isNull())
+        {
+            auto timeStr = r[index].as<std::string>();
+            struct tm stm;
+            memset(&stm,0,sizeof(stm));
+            auto p = strptime(timeStr.c_str(),"%Y-%m-%d %H:%M:%S",&stm);
+            time_t t = mktime(&stm);
+            size_t decimalNum = 0;
+            if(p)
+            {
+                if(*p=='.')
+                {
+                    std::string decimals(p+1,&timeStr[timeStr.length()]);
+                    while(decimals.length()<6)
+                    {
+                        decimals += "0";
+                    }
+                    decimalNum = (size_t)atol(decimals.c_str());
+                }
+                updatedAt_=std::make_shared<::trantor::Date>(t*1000000+decimalNum);
+            }
+        }
+        index = offset + 7;
+        if(!r[index].isNull())
+        {
+            isDeleted_=std::make_shared<int8_t>(r[index].as<int8_t>());
+        }
+    }
+
+}
+
+DishIngredient::DishIngredient(const Json::Value &pJson, const std::vector<std::string> &pMasqueradingVector) noexcept(false)
+{
+    if(pMasqueradingVector.size() != 8)
+    {
+        LOG_ERROR << "Bad masquerading vector";
+        return;
+    }
+    if(!pMasqueradingVector[0].empty() && pJson.isMember(pMasqueradingVector[0]))
+    {
+        dirtyFlag_[0] = true;
+        if(!pJson[pMasqueradingVector[0]].isNull())
+        {
+            ingredientId_=std::make_shared<uint32_t>((uint32_t)pJson[pMasqueradingVector[0]].asUInt64());
+        }
+    }
+    if(!pMasqueradingVector[1].empty() && pJson.isMember(pMasqueradingVector[1]))
+    {
+        dirtyFlag_[1] = true;
+        if(!pJson[pMasqueradingVector[1]].isNull())
+        {
+            tenantId_=std::make_shared<uint32_t>((uint32_t)pJson[pMasqueradingVector[1]].asUInt64());
+        }
+    }
+    if(!pMasqueradingVector[2].empty() && pJson.isMember(pMasqueradingVector[2]))
+    {
+        dirtyFlag_[2] = true;
+        if(!pJson[pMasqueradingVector[2]].isNull())
+        {
+            dishId_=std::make_shared<uint32_t>((uint32_t)pJson[pMasqueradingVector[2]].asUInt64());
+        }
+    }
+    if(!pMasqueradingVector[3].empty() && pJson.isMember(pMasqueradingVector[3]))
+    {
+        dirtyFlag_[3] = true;
+        if(!pJson[pMasqueradingVector[3]].isNull())
+        {
+            itemId_=std::make_shared<uint32_t>((uint32_t)pJson[pMasqueradingVector[3]].asUInt64());
+        }
+    }
+    if(!pMasqueradingVector[4].empty() && pJson.isMember(pMasqueradingVector[4]))
+    {
+        dirtyFlag_[4] = true;
+        if(!pJson[pMasqueradingVector[4]].isNull())
+        {
+            quantity_=std::make_shared<int32_t>((int32_t)pJson[pMasqueradingVector[4]].asInt64());
+        }
+    }
+    if(!pMasqueradingVector[5].empty() && pJson.isMember(pMasqueradingVector[5]))
+    {
+        dirtyFlag_[5] = true;
+        if(!pJson[pMasqueradingVector[5]].isNull())
+        {
+            auto timeStr = pJson[pMasqueradingVector[5]].asString();
+            struct tm stm;
+            memset(&stm,0,sizeof(stm));
+            auto p = strptime(timeStr.c_str(),"%Y-%m-%d %H:%M:%S",&stm);
+            time_t t = mktime(&stm);
+            size_t decimalNum = 0;
+            if(p)
+            {
+                if(*p=='.')
+                {
+                    std::string decimals(p+1,&timeStr[timeStr.length()]);
+                    while(decimals.length()<6)
+                    {
+                        decimals += "0";
+                    }
+                    decimalNum = (size_t)atol(decimals.c_str());
+                }
+                createdAt_=std::make_shared<::trantor::Date>(t*1000000+decimalNum);
+            }
+        }
+    }
+    if(!pMasqueradingVector[6].empty() && pJson.isMember(pMasqueradingVector[6]))
+    {
+        dirtyFlag_[6] = true;
+        if(!pJson[pMasqueradingVector[6]].isNull())
+        {
+            auto timeStr = pJson[pMasqueradingVector[6]].asString();
+            struct tm stm;
+            memset(&stm,0,sizeof(stm));
+            auto p = strptime(timeStr.c_str(),"%Y-%m-%d %H:%M:%S",&stm);
+            time_t t = mktime(&stm);
+            size_t decimalNum = 0;
+            if(p)
+            {
+                if(*p=='.')
+                {
+                    std::string decimals(p+1,&timeStr[timeStr.length()]);
+                    while(decimals.length()<6)
+                    {
+                        decimals += "0";
+                    }
+                    decimalNum = (size_t)atol(decimals.c_str());
+                }
+                updatedAt_=std::make_shared<::trantor::Date>(t*1000000+decimalNum);
+            }
+        }
+    }
+    if(!pMasqueradingVector[7].empty() && pJson.isMember(pMasqueradingVector[7]))
+    {
+        dirtyFlag_[7] = true;
+        if(!pJson[pMasqueradingVector[7]].isNull())
+        {
+            isDeleted_=std::make_shared<int8_t>((int8_t)pJson[pMasqueradingVector[7]].asInt64());
+        }
+    }
+}
+
+DishIngredient::DishIngredient(const Json::Value &pJson) noexcept(false)
+{
+    if(pJson.isMember("ingredient_id"))
+    {
+        dirtyFlag_[0]=true;
+        if(!pJson["ingredient_id"].isNull())
+        {
+            ingredientId_=std::make_shared<uint32_t>((uint32_t)pJson["ingredient_id"].asUInt64());
+        }
+    }
+    if(pJson.isMember("tenant_id"))
+    {
+        dirtyFlag_[1]=true;
+        if(!pJson["tenant_id"].isNull())
+        {
+            tenantId_=std::make_shared<uint32_t>((uint32_t)pJson["tenant_id"].asUInt64());
+        }
+    }
+    if(pJson.isMember("dish_id"))
+    {
+        dirtyFlag_[2]=true;
+        if(!pJson["dish_id"].isNull())
+        {
+            dishId_=std::make_shared<uint32_t>((uint32_t)pJson["dish_id"].asUInt64());
+        }
+    }
+    if(pJson.isMember("item_id"))
+    {
+        dirtyFlag_[3]=true;
+        if(!pJson["item_id"].isNull())
+        {
+            itemId_=std::make_shared<uint32_t>((uint32_t)pJson["item_id"].asUInt64());
+        }
+    }
+    if(pJson.isMember("quantity"))
+    {
+        dirtyFlag_[4]=true;
+        if(!pJson["quantity"].isNull())
+        {
+            quantity_=std::make_shared<int32_t>((int32_t)pJson["quantity"].asInt64());
+        }
+    }
+    if(pJson.isMember("created_at"))
+    {
+        dirtyFlag_[5]=true;
+        if(!pJson["created_at"].isNull())
+        {
+            auto timeStr = pJson["created_at"].asString();
+            struct tm stm;
+            memset(&stm,0,sizeof(stm));
+            auto p = strptime(timeStr.c_str(),"%Y-%m-%d %H:%M:%S",&stm);
+            time_t t = mktime(&stm);
+            size_t decimalNum = 0;
+            if(p)
+            {
+                if(*p=='.')
+                {
+                    std::string decimals(p+1,&timeStr[timeStr.length()]);
+                    while(decimals.length()<6)
+                    {
+                        decimals += "0";
+                    }
+                    decimalNum = (size_t)atol(decimals.c_str());
+                }
+                createdAt_=std::make_shared<::trantor::Date>(t*1000000+decimalNum);
+            }
+        }
+    }
+    if(pJson.isMember("updated_at"))
+    {
+        dirtyFlag_[6]=true;
+        if(!pJson["updated_at"].isNull())
+        {
+            auto timeStr = pJson["updated_at"].asString();
+            struct tm stm;
+            memset(&stm,0,sizeof(stm));
+            auto p = strptime(timeStr.c_str(),"%Y-%m-%d %H:%M:%S",&stm);
+            time_t t = mktime(&stm);
+            size_t decimalNum = 0;
+            if(p)
+            {
+                if(*p=='.')
+                {
+                    std::string decimals(p+1,&timeStr[timeStr.length()]);
+                    while(decimals.length()<6)
+                    {
+                        decimals += "0";
+                    }
+                    decimalNum = (size_t)atol(decimals.c_str());
+                }
+                updatedAt_=std::make_shared<::trantor::Date>(t*1000000+decimalNum);
+            }
+        }
+    }
+    if(pJson.isMember("is_deleted"))
+    {
+        dirtyFlag_[7]=true;
+        if(!pJson["is_deleted"].isNull())
+        {
+            isDeleted_=std::make_shared<int8_t>((int8_t)pJson["is_deleted"].asInt64());
+        }
+    }
+}
+
+void DishIngredient::updateByMasqueradedJson(const Json::Value &pJson,
+                                            const std::vector<std::string> &pMasqueradingVector) noexcept(false)
+{
+    if(pMasqueradingVector.size() != 8)
+    {
+        LOG_ERROR << "Bad masquerading vector";
+        return;
+    }
+    if(!pMasqueradingVector[0].empty() && pJson.isMember(pMasqueradingVector[0]))
+    {
+        if(!pJson[pMasqueradingVector[0]].isNull())
+        {
+            ingredientId_=std::make_shared<uint32_t>((uint32_t)pJson[pMasqueradingVector[0]].asUInt64());
+        }
+    }
+    if(!pMasqueradingVector[1].empty() && pJson.isMember(pMasqueradingVector[1]))
+    {
+        dirtyFlag_[1] = true;
+        if(!pJson[pMasqueradingVector[1]].isNull())
+        {
+            tenantId_=std::make_shared<uint32_t>((uint32_t)pJson[pMasqueradingVector[1]].asUInt64());
+        }
+    }
+    if(!pMasqueradingVector[2].empty() && pJson.isMember(pMasqueradingVector[2]))
+    {
+        dirtyFlag_[2] = true;
+        if(!pJson[pMasqueradingVector[2]].isNull())
+        {
+            dishId_=std::make_shared<uint32_t>((uint32_t)pJson[pMasqueradingVector[2]].asUInt64());
+        }
+    }
+    if(!pMasqueradingVector[3].empty() && pJson.isMember(pMasqueradingVector[3]))
+    {
+        dirtyFlag_[3] = true;
+        if(!pJson[pMasqueradingVector[3]].isNull())
+        {
+            itemId_=std::make_shared<uint32_t>((uint32_t)pJson[pMasqueradingVector[3]].asUInt64());
+        }
+    }
+    if(!pMasqueradingVector[4].empty() && pJson.isMember(pMasqueradingVector[4]))
+    {
+        dirtyFlag_[4] = true;
+        if(!pJson[pMasqueradingVector[4]].isNull())
+        {
+            quantity_=std::make_shared<int32_t>((int32_t)pJson[pMasqueradingVector[4]].asInt64());
+        }
+    }
+    if(!pMasqueradingVector[5].empty() && pJson.isMember(pMasqueradingVector[5]))
+    {
+        dirtyFlag_[5] = true;
+        if(!pJson[pMasqueradingVector[5]].isNull())
+        {
+            auto timeStr = pJson[pMasqueradingVector[5]].asString();
+            struct tm stm;
+            memset(&stm,0,sizeof(stm));
+            auto p = strptime(timeStr.c_str(),"%Y-%m-%d %H:%M:%S",&stm);
+            time_t t = mktime(&stm);
+            size_t decimalNum = 0;
+            if(p)
+            {
+                if(*p=='.')
+                {
+                    std::string decimals(p+1,&timeStr[timeStr.length()]);
+                    while(decimals.length()<6)
+                    {
+                        decimals += "0";
+                    }
+                    decimalNum = (size_t)atol(decimals.c_str());
+                }
+                createdAt_=std::make_shared<::trantor::Date>(t*1000000+decimalNum);
+            }
+        }
+    }
+    if(!pMasqueradingVector[6].empty() && pJson.isMember(pMasqueradingVector[6]))
+    {
+        dirtyFlag_[6] = true;
+        if(!pJson[pMasqueradingVector[6]].isNull())
+        {
+            auto timeStr = pJson[pMasqueradingVector[6]].asString();
+            struct tm stm;
+            memset(&stm,0,sizeof(stm));
+            auto p = strptime(timeStr.c_str(),"%Y-%m-%d %H:%M:%S",&stm);
+            time_t t = mktime(&stm);
+            size_t decimalNum = 0;
+            if(p)
+            {
+                if(*p=='.')
+                {
+                    std::string decimals(p+1,&timeStr[timeStr.length()]);
+                    while(decimals.length()<6)
+                    {
+                        decimals += "0";
+                    }
+                    decimalNum = (size_t)atol(decimals.c_str());
+                }
+                updatedAt_=std::make_shared<::trantor::Date>(t*1000000+decimalNum);
+            }
+        }
+    }
+    if(!pMasqueradingVector[7].empty() && pJson.isMember(pMasqueradingVector[7]))
+    {
+        dirtyFlag_[7] = true;
+        if(!pJson[pMasqueradingVector[7]].isNull())
+        {
+            isDeleted_=std::make_shared<int8_t>((int8_t)pJson[pMasqueradingVector[7]].asInt64());
+        }
+    }
+}
+
+void DishIngredient::updateByJson(const Json::Value &pJson) noexcept(false)
+{
+    if(pJson.isMember("ingredient_id"))
+    {
+        if(!pJson["ingredient_id"].isNull())
+        {
+            ingredientId_=std::make_shared<uint32_t>((uint32_t)pJson["ingredient_id"].asUInt64());
+        }
+    }
+    if(pJson.isMember("tenant_id"))
+    {
+        dirtyFlag_[1] = true;
+        if(!pJson["tenant_id"].isNull())
+        {
+            tenantId_=std::make_shared<uint32_t>((uint32_t)pJson["tenant_id"].asUInt64());
+        }
+    }
+    if(pJson.isMember("dish_id"))
+    {
+        dirtyFlag_[2] = true;
+        if(!pJson["dish_id"].isNull())
+        {
+            dishId_=std::make_shared<uint32_t>((uint32_t)pJson["dish_id"].asUInt64());
+        }
+    }
+    if(pJson.isMember("item_id"))
+    {
+        dirtyFlag_[3] = true;
+        if(!pJson["item_id"].isNull())
+        {
+            itemId_=std::make_shared<uint32_t>((uint32_t)pJson["item_id"].asUInt64());
+        }
+    }
+    if(pJson.isMember("quantity"))
+    {
+        dirtyFlag_[4] = true;
+        if(!pJson["quantity"].isNull())
+        {
+            quantity_=std::make_shared<int32_t>((int32_t)pJson["quantity"].asInt64());
+        }
+    }
+    if(pJson.isMember("created_at"))
+    {
+        dirtyFlag_[5] = true;
+        if(!pJson["created_at"].isNull())
+        {
+            auto timeStr = pJson["created_at"].asString();
+            struct tm stm;
+            memset(&stm,0,sizeof(stm));
+            auto p = strptime(timeStr.c_str(),"%Y-%m-%d %H:%M:%S",&stm);
+            time_t t = mktime(&stm);
+            size_t decimalNum = 0;
+            if(p)
+            {
+                if(*p=='.')
+                {
+                    std::string decimals(p+1,&timeStr[timeStr.length()]);
+                    while(decimals.length()<6)
+                    {
+                        decimals += "0";
+                    }
+                    decimalNum = (size_t)atol(decimals.c_str());
+                }
+                createdAt_=std::make_shared<::trantor::Date>(t*1000000+decimalNum);
+            }
+        }
+    }
+    if(pJson.isMember("updated_at"))
+    {
+        dirtyFlag_[6] = true;
+        if(!pJson["updated_at"].isNull())
+        {
+            auto timeStr = pJson["updated_at"].asString();
+            struct tm stm;
+            memset(&stm,0,sizeof(stm));
+            auto p = strptime(timeStr.c_str(),"%Y-%m-%d %H:%M:%S",&stm);
+            time_t t = mktime(&stm);
+            size_t decimalNum = 0;
+            if(p)
+            {
+                if(*p=='.')
+                {
+                    std::string decimals(p+1,&timeStr[timeStr.length()]);
+                    while(decimals.length()<6)
+                    {
+                        decimals += "0";
+                    }
+                    decimalNum = (size_t)atol(decimals.c_str());
+                }
+                updatedAt_=std::make_shared<::trantor::Date>(t*1000000+decimalNum);
+            }
+        }
+    }
+    if(pJson.isMember("is_deleted"))
+    {
+        dirtyFlag_[7] = true;
+        if(!pJson["is_deleted"].isNull())
+        {
+            isDeleted_=std::make_shared<int8_t>((int8_t)pJson["is_deleted"].asInt64());
+        }
+    }
+}
+
+const uint32_t &DishIngredient::getValueOfIngredientId() const noexcept
+{
+    static const uint32_t defaultValue = uint32_t();
+    if(ingredientId_)
+        return *ingredientId_;
+    return defaultValue;
+}
+const std::shared_ptr<uint32_t> &DishIngredient::getIngredientId() const noexcept
+{
+    return ingredientId_;
+}
+void DishIngredient::setIngredientId(const uint32_t &pIngredientId) noexcept
+{
+    ingredientId_ = std::make_shared<uint32_t>(pIngredientId);
+    dirtyFlag_[0] = true;
+}
+const typename DishIngredient::PrimaryKeyType & DishIngredient::getPrimaryKey() const
+{
+    assert(ingredientId_);
+    return *ingredientId_;
+}
+
+const uint32_t &DishIngredient::getValueOfTenantId() const noexcept
+{
+    static const uint32_t defaultValue = uint32_t();
+    if(tenantId_)
+        return *tenantId_;
+    return defaultValue;
+}
+const std::shared_ptr<uint32_t> &DishIngredient::getTenantId() const noexcept
+{
+    return tenantId_;
+}
+void DishIngredient::setTenantId(const uint32_t &pTenantId) noexcept
+{
+    tenantId_ = std::make_shared<uint32_t>(pTenantId);
+    dirtyFlag_[1] = true;
+}
+void DishIngredient::setTenantIdToNull() noexcept
+{
+    tenantId_.reset();
+    dirtyFlag_[1] = true;
+}
+
+const uint32_t &DishIngredient::getValueOfDishId() const noexcept
+{
+    static const uint32_t defaultValue = uint32_t();
+    if(dishId_)
+        return *dishId_;
+    return defaultValue;
+}
+const std::shared_ptr<uint32_t> &DishIngredient::getDishId() const noexcept
+{
+    return dishId_;
+}
+void DishIngredient::setDishId(const uint32_t &pDishId) noexcept
+{
+    dishId_ = std::make_shared<uint32_t>(pDishId);
+    dirtyFlag_[2] = true;
+}
+void DishIngredient::setDishIdToNull() noexcept
+{
+    dishId_.reset();
+    dirtyFlag_[2] = true;
+}
+
+const uint32_t &DishIngredient::getValueOfItemId() const noexcept
+{
+    static const uint32_t defaultValue = uint32_t();
+    if(itemId_)
+        return *itemId_;
+    return defaultValue;
+}
+const std::shared_ptr<uint32_t> &DishIngredient::getItemId() const noexcept
+{
+    return itemId_;
+}
+void DishIngredient::setItemId(const uint32_t &pItemId) noexcept
+{
+    itemId_ = std::make_shared<uint32_t>(pItemId);
+    dirtyFlag_[3] = true;
+}
+void DishIngredient::setItemIdToNull() noexcept
+{
+    itemId_.reset();
+    dirtyFlag_[3] = true;
+}
+
+const int32_t &DishIngredient::getValueOfQuantity() const noexcept
+{
+    static const int32_t defaultValue = int32_t();
+    if(quantity_)
+        return *quantity_;
+    return defaultValue;
+}
+const std::shared_ptr<int32_t> &DishIngredient::getQuantity() const noexcept
+{
+    return quantity_;
+}
+void DishIngredient::setQuantity(const int32_t &pQuantity) noexcept
+{
+    quantity_ = std::make_shared<int32_t>(pQuantity);
+    dirtyFlag_[4] = true;
+}
+void DishIngredient::setQuantityToNull() noexcept
+{
+    quantity_.reset();
+    dirtyFlag_[4] = true;
+}
+
+const ::trantor::Date &DishIngredient::getValueOfCreatedAt() const noexcept
+{
+    static const ::trantor::Date defaultValue = ::trantor::Date();
+    if(createdAt_)
+        return *createdAt_;
+    return defaultValue;
+}
+const std::shared_ptr<::trantor::Date> &DishIngredient::getCreatedAt() const noexcept
+{
+    return createdAt_;
+}
+void DishIngredient::setCreatedAt(const ::trantor::Date &pCreatedAt) noexcept
+{
+    createdAt_ = std::make_shared<::trantor::Date>(pCreatedAt);
+    dirtyFlag_[5] = true;
+}
+void DishIngredient::setCreatedAtToNull() noexcept
+{
+    createdAt_.reset();
+    dirtyFlag_[5] = true;
+}
+
+const ::trantor::Date &DishIngredient::getValueOfUpdatedAt() const noexcept
+{
+    static const ::trantor::Date defaultValue = ::trantor::Date();
+    if(updatedAt_)
+        return *updatedAt_;
+    return defaultValue;
+}
+const std::shared_ptr<::trantor::Date> &DishIngredient::getUpdatedAt() const noexcept
+{
+    return updatedAt_;
+}
+void DishIngredient::setUpdatedAt(const ::trantor::Date &pUpdatedAt) noexcept
+{
+    updatedAt_ = std::make_shared<::trantor::Date>(pUpdatedAt);
+    dirtyFlag_[6] = true;
+}
+void DishIngredient::setUpdatedAtToNull() noexcept
+{
+    updatedAt_.reset();
+    dirtyFlag_[6] = true;
+}
+
+const int8_t &DishIngredient::getValueOfIsDeleted() const noexcept
+{
+    static const int8_t defaultValue = int8_t();
+    if(isDeleted_)
+        return *isDeleted_;
+    return defaultValue;
+}
+const std::shared_ptr<int8_t> &DishIngredient::getIsDeleted() const noexcept
+{
+    return isDeleted_;
+}
+void DishIngredient::setIsDeleted(const int8_t &pIsDeleted) noexcept
+{
+    isDeleted_ = std::make_shared<int8_t>(pIsDeleted);
+    dirtyFlag_[7] = true;
+}
+void DishIngredient::setIsDeletedToNull() noexcept
+{
+    isDeleted_.reset();
+    dirtyFlag_[7] = true;
+}
+
+void DishIngredient::updateId(const uint64_t id)
+{
+    ingredientId_ = std::make_shared<uint32_t>(static_cast<uint32_t>(id));
+}
+
+const std::vector<std::string> &DishIngredient::insertColumns() noexcept
+{
+    static const std::vector<std::string> inCols={
+        "tenant_id",
+        "dish_id",
+        "item_id",
+        "quantity",
+        "created_at",
+        "updated_at",
+        "is_deleted"
+    };
+    return inCols;
+}
+
+void DishIngredient::outputArgs(drogon::orm::internal::SqlBinder &binder) const
+{
+    if(dirtyFlag_[1])
+    {
+        if(getTenantId())
+        {
+            binder << getValueOfTenantId();
+        }
+        else
+        {
+            binder << nullptr;
+        }
+    }
+    if(dirtyFlag_[2])
+    {
+        if(getDishId())
+        {
+            binder << getValueOfDishId();
+        }
+        else
+        {
+            binder << nullptr;
+        }
+    }
+    if(dirtyFlag_[3])
+    {
+        if(getItemId())
+        {
+            binder << getValueOfItemId();
+        }
+        else
+        {
+            binder << nullptr;
+        }
+    }
+    if(dirtyFlag_[4])
+    {
+        if(getQuantity())
+        {
+            binder << getValueOfQuantity();
+        }
+        else
+        {
+            binder << nullptr;
+        }
+    }
+    if(dirtyFlag_[5])
+    {
+        if(getCreatedAt())
+        {
+            binder << getValueOfCreatedAt();
+        }
+        else
+        {
+            binder << nullptr;
+        }
+    }
+    if(dirtyFlag_[6])
+    {
+        if(getUpdatedAt())
+        {
+            binder << getValueOfUpdatedAt();
+        }
+        else
+        {
+            binder << nullptr;
+        }
+    }
+    if(dirtyFlag_[7])
+    {
+        if(getIsDeleted())
+        {
+            binder << getValueOfIsDeleted();
+        }
+        else
+        {
+            binder << nullptr;
+        }
+    }
+}
+
+const std::vector<std::string> DishIngredient::updateColumns() const
+{
+    std::vector<std::string> ret;
+    if(dirtyFlag_[1])
+    {
+        ret.push_back(getColumnName(1));
+    }
+    if(dirtyFlag_[2])
+    {
+        ret.push_back(getColumnName(2));
+    }
+    if(dirtyFlag_[3])
+    {
+        ret.push_back(getColumnName(3));
+    }
+    if(dirtyFlag_[4])
+    {
+        ret.push_back(getColumnName(4));
+    }
+    if(dirtyFlag_[5])
+    {
+        ret.push_back(getColumnName(5));
+    }
+    if(dirtyFlag_[6])
+    {
+        ret.push_back(getColumnName(6));
+    }
+    if(dirtyFlag_[7])
+    {
+        ret.push_back(getColumnName(7));
+    }
+    return ret;
+}
+
+void DishIngredient::updateArgs(drogon::orm::internal::SqlBinder &binder) const
+{
+    if(dirtyFlag_[1])
+    {
+        if(getTenantId())
+        {
+            binder << getValueOfTenantId();
+        }
+        else
+        {
+            binder << nullptr;
+        }
+    }
+    if(dirtyFlag_[2])
+    {
+        if(getDishId())
+        {
+            binder << getValueOfDishId();
+        }
+        else
+        {
+            binder << nullptr;
+        }
+    }
+    if(dirtyFlag_[3])
+    {
+        if(getItemId())
+        {
+            binder << getValueOfItemId();
+        }
+        else
+        {
+            binder << nullptr;
+        }
+    }
+    if(dirtyFlag_[4])
+    {
+        if(getQuantity())
+        {
+            binder << getValueOfQuantity();
+        }
+        else
+        {
+            binder << nullptr;
+        }
+    }
+    if(dirtyFlag_[5])
+    {
+        if(getCreatedAt())
+        {
+            binder << getValueOfCreatedAt();
+        }
+        else
+        {
+            binder << nullptr;
+        }
+    }
+    if(dirtyFlag_[6])
+    {
+        if(getUpdatedAt())
+        {
+            binder << getValueOfUpdatedAt();
+        }
+        else
+        {
+            binder << nullptr;
+        }
+    }
+    if(dirtyFlag_[7])
+    {
+        if(getIsDeleted())
+        {
+            binder << getValueOfIsDeleted();
+        }
+        else
+        {
+            binder << nullptr;
+        }
+    }
+}
+Json::Value DishIngredient::toJson() const
+{
+    Json::Value ret;
+    if(getIngredientId())
+    {
+        ret["ingredient_id"]=getValueOfIngredientId();
+    }
+    else
+    {
+        ret["ingredient_id"]=Json::Value();
+    }
+    if(getTenantId())
+    {
+        ret["tenant_id"]=getValueOfTenantId();
+    }
+    else
+    {
+        ret["tenant_id"]=Json::Value();
+    }
+    if(getDishId())
+    {
+        ret["dish_id"]=getValueOfDishId();
+    }
+    else
+    {
+        ret["dish_id"]=Json::Value();
+    }
+    if(getItemId())
+    {
+        ret["item_id"]=getValueOfItemId();
+    }
+    else
+    {
+        ret["item_id"]=Json::Value();
+    }
+    if(getQuantity())
+    {
+        ret["quantity"]=getValueOfQuantity();
+    }
+    else
+    {
+        ret["quantity"]=Json::Value();
+    }
+    if(getCreatedAt())
+    {
+        ret["created_at"]=getCreatedAt()->toDbStringLocal();
+    }
+    else
+    {
+        ret["created_at"]=Json::Value();
+    }
+    if(getUpdatedAt())
+    {
+        ret["updated_at"]=getUpdatedAt()->toDbStringLocal();
+    }
+    else
+    {
+        ret["updated_at"]=Json::Value();
+    }
+    if(getIsDeleted())
+    {
+        ret["is_deleted"]=getValueOfIsDeleted();
+    }
+    else
+    {
+        ret["is_deleted"]=Json::Value();
+    }
+    return ret;
+}
+
+Json::Value DishIngredient::toMasqueradedJson(
+    const std::vector<std::string> &pMasqueradingVector) const
+{
+    Json::Value ret;
+    if(pMasqueradingVector.size() == 8)
+    {
+        if(!pMasqueradingVector[0].empty())
+        {
+            if(getIngredientId())
+            {
+                ret[pMasqueradingVector[0]]=getValueOfIngredientId();
+            }
+            else
+            {
+                ret[pMasqueradingVector[0]]=Json::Value();
+            }
+        }
+        if(!pMasqueradingVector[1].empty())
+        {
+            if(getTenantId())
+            {
+                ret[pMasqueradingVector[1]]=getValueOfTenantId();
+            }
+            else
+            {
+                ret[pMasqueradingVector[1]]=Json::Value();
+            }
+        }
+        if(!pMasqueradingVector[2].empty())
+        {
+            if(getDishId())
+            {
+                ret[pMasqueradingVector[2]]=getValueOfDishId();
+            }
+            else
+            {
+                ret[pMasqueradingVector[2]]=Json::Value();
+            }
+        }
+        if(!pMasqueradingVector[3].empty())
+        {
+            if(getItemId())
+            {
+                ret[pMasqueradingVector[3]]=getValueOfItemId();
+            }
+            else
+            {
+                ret[pMasqueradingVector[3]]=Json::Value();
+            }
+        }
+        if(!pMasqueradingVector[4].empty())
+        {
+            if(getQuantity())
+            {
+                ret[pMasqueradingVector[4]]=getValueOfQuantity();
+            }
+            else
+            {
+                ret[pMasqueradingVector[4]]=Json::Value();
+            }
+        }
+        if(!pMasqueradingVector[5].empty())
+        {
+            if(getCreatedAt())
+            {
+                ret[pMasqueradingVector[5]]=getCreatedAt()->toDbStringLocal();
+            }
+            else
+            {
+                ret[pMasqueradingVector[5]]=Json::Value();
+            }
+        }
+        if(!pMasqueradingVector[6].empty())
+        {
+            if(getUpdatedAt())
+            {
+                ret[pMasqueradingVector[6]]=getUpdatedAt()->toDbStringLocal();
+            }
+            else
+            {
+                ret[pMasqueradingVector[6]]=Json::Value();
+            }
+        }
+        if(!pMasqueradingVector[7].empty())
+        {
+            if(getIsDeleted())
+            {
+                ret[pMasqueradingVector[7]]=getValueOfIsDeleted();
+            }
+            else
+            {
+                ret[pMasqueradingVector[7]]=Json::Value();
+            }
+        }
+        return ret;
+    }
+    LOG_ERROR << "Masquerade failed";
+    if(getIngredientId())
+    {
+        ret["ingredient_id"]=getValueOfIngredientId();
+    }
+    else
+    {
+        ret["ingredient_id"]=Json::Value();
+    }
+    if(getTenantId())
+    {
+        ret["tenant_id"]=getValueOfTenantId();
+    }
+    else
+    {
+        ret["tenant_id"]=Json::Value();
+    }
+    if(getDishId())
+    {
+        ret["dish_id"]=getValueOfDishId();
+    }
+    else
+    {
+        ret["dish_id"]=Json::Value();
+    }
+    if(getItemId())
+    {
+        ret["item_id"]=getValueOfItemId();
+    }
+    else
+    {
+        ret["item_id"]=Json::Value();
+    }
+    if(getQuantity())
+    {
+        ret["quantity"]=getValueOfQuantity();
+    }
+    else
+    {
+        ret["quantity"]=Json::Value();
+    }
+    if(getCreatedAt())
+    {
+        ret["created_at"]=getCreatedAt()->toDbStringLocal();
+    }
+    else
+    {
+        ret["created_at"]=Json::Value();
+    }
+    if(getUpdatedAt())
+    {
+        ret["updated_at"]=getUpdatedAt()->toDbStringLocal();
+    }
+    else
+    {
+        ret["updated_at"]=Json::Value();
+    }
+    if(getIsDeleted())
+    {
+        ret["is_deleted"]=getValueOfIsDeleted();
+    }
+    else
+    {
+        ret["is_deleted"]=Json::Value();
+    }
+    return ret;
+}
+
+bool DishIngredient::validateJsonForCreation(const Json::Value &pJson, std::string &err)
+{
+    if(pJson.isMember("ingredient_id"))
+    {
+        if(!validJsonOfField(0, "ingredient_id", pJson["ingredient_id"], err, true))
+            return false;
+    }
+    if(pJson.isMember("tenant_id"))
+    {
+        if(!validJsonOfField(1, "tenant_id", pJson["tenant_id"], err, true))
+            return false;
+    }
+    if(pJson.isMember("dish_id"))
+    {
+        if(!validJsonOfField(2, "dish_id", pJson["dish_id"], err, true))
+            return false;
+    }
+    if(pJson.isMember("item_id"))
+    {
+        if(!validJsonOfField(3, "item_id", pJson["item_id"], err, true))
+            return false;
+    }
+    if(pJson.isMember("quantity"))
+    {
+        if(!validJsonOfField(4, "quantity", pJson["quantity"], err, true))
+            return false;
+    }
+    if(pJson.isMember("created_at"))
+    {
+        if(!validJsonOfField(5, "created_at", pJson["created_at"], err, true))
+            return false;
+    }
+    if(pJson.isMember("updated_at"))
+    {
+        if(!validJsonOfField(6, "updated_at", pJson["updated_at"], err, true))
+            return false;
+    }
+    if(pJson.isMember("is_deleted"))
+    {
+        if(!validJsonOfField(7, "is_deleted", pJson["is_deleted"], err, true))
+            return false;
+    }
+    return true;
+}
+bool DishIngredient::validateMasqueradedJsonForCreation(const Json::Value &pJson,
+                                                        const std::vector<std::string> &pMasqueradingVector,
+                                                        std::string &err)
+{
+    if(pMasqueradingVector.size() != 8)
+    {
+        err = "Bad masquerading vector";
+        return false;
+    }
+    try {
+      if(!pMasqueradingVector[0].empty())
+      {
+          if(pJson.isMember(pMasqueradingVector[0]))
+          {
+              if(!validJsonOfField(0, pMasqueradingVector[0], pJson[pMasqueradingVector[0]], err, true))
+                  return false;
+          }
+      }
+      if(!pMasqueradingVector[1].empty())
+      {
+          if(pJson.isMember(pMasqueradingVector[1]))
+          {
+              if(!validJsonOfField(1, pMasqueradingVector[1], pJson[pMasqueradingVector[1]], err, true))
+                  return false;
+          }
+      }
+      if(!pMasqueradingVector[2].empty())
+      {
+          if(pJson.isMember(pMasqueradingVector[2]))
+          {
+              if(!validJsonOfField(2, pMasqueradingVector[2], pJson[pMasqueradingVector[2]], err, true))
+                  return false;
+          }
+      }
+      if(!pMasqueradingVector[3].empty())
+      {
+          if(pJson.isMember(pMasqueradingVector[3]))
+          {
+              if(!validJsonOfField(3, pMasqueradingVector[3], pJson[pMasqueradingVector[3]], err, true))
+                  return false;
+          }
+      }
+      if(!pMasqueradingVector[4].empty())
+      {
+          if(pJson.isMember(pMasqueradingVector[4]))
+          {
+              if(!validJsonOfField(4, pMasqueradingVector[4], pJson[pMasqueradingVector[4]], err, true))
+                  return false;
+          }
+      }
+      if(!pMasqueradingVector[5].empty())
+      {
+          if(pJson.isMember(pMasqueradingVector[5]))
+          {
+              if(!validJsonOfField(5, pMasqueradingVector[5], pJson[pMasqueradingVector[5]], err, true))
+                  return false;
+          }
+      }
+      if(!pMasqueradingVector[6].empty())
+      {
+          if(pJson.isMember(pMasqueradingVector[6]))
+          {
+              if(!validJsonOfField(6, pMasqueradingVector[6], pJson[pMasqueradingVector[6]], err, true))
+                  return false;
+          }
+      }
+      if(!pMasqueradingVector[7].empty())
+      {
+          if(pJson.isMember(pMasqueradingVector[7]))
+          {
+              if(!validJsonOfField(7, pMasqueradingVector[7], pJson[pMasqueradingVector[7]], err, true))
+                  return false;
+          }
+      }
+    }
+    catch(const Json::LogicError &e)
+    {
+      err = e.what();
+      return false;
+    }
+    return true;
+}
+bool DishIngredient::validateJsonForUpdate(const Json::Value &pJson, std::string &err)
+{
+    if(pJson.isMember("ingredient_id"))
+    {
+        if(!validJsonOfField(0, "ingredient_id", pJson["ingredient_id"], err, false))
+            return false;
+    }
+    else
+    {
+        err = "The value of primary key must be set in the json object for update";
+        return false;
+    }
+    if(pJson.isMember("tenant_id"))
+    {
+        if(!validJsonOfField(1, "tenant_id", pJson["tenant_id"], err, false))
+            return false;
+    }
+    if(pJson.isMember("dish_id"))
+    {
+        if(!validJsonOfField(2, "dish_id", pJson["dish_id"], err, false))
+            return false;
+    }
+    if(pJson.isMember("item_id"))
+    {
+        if(!validJsonOfField(3, "item_id", pJson["item_id"], err, false))
+            return false;
+    }
+    if(pJson.isMember("quantity"))
+    {
+        if(!validJsonOfField(4, "quantity", pJson["quantity"], err, false))
+            return false;
+    }
+    if(pJson.isMember("created_at"))
+    {
+        if(!validJsonOfField(5, "created_at", pJson["created_at"], err, false))
+            return false;
+    }
+    if(pJson.isMember("updated_at"))
+    {
+        if(!validJsonOfField(6, "updated_at", pJson["updated_at"], err, false))
+            return false;
+    }
+    if(pJson.isMember("is_deleted"))
+    {
+        if(!validJsonOfField(7, "is_deleted", pJson["is_deleted"], err, false))
+            return false;
+    }
+    return true;
+}
+bool DishIngredient::validateMasqueradedJsonForUpdate(const Json::Value &pJson,
+                                                      const std::vector<std::string> &pMasqueradingVector,
+                                                      std::string &err)
+{
+    if(pMasqueradingVector.size() != 8)
+    {
+        err = "Bad masquerading vector";
+        return false;
+    }
+    try {
+      if(!pMasqueradingVector[0].empty() && pJson.isMember(pMasqueradingVector[0]))
+      {
+          if(!validJsonOfField(0, pMasqueradingVector[0], pJson[pMasqueradingVector[0]], err, false))
+              return false;
+      }
+    else
+    {
+        err = "The value of primary key must be set in the json object for update";
+        return false;
+    }
+      if(!pMasqueradingVector[1].empty() && pJson.isMember(pMasqueradingVector[1]))
+      {
+          if(!validJsonOfField(1, pMasqueradingVector[1], pJson[pMasqueradingVector[1]], err, false))
+              return false;
+      }
+      if(!pMasqueradingVector[2].empty() && pJson.isMember(pMasqueradingVector[2]))
+      {
+          if(!validJsonOfField(2, pMasqueradingVector[2], pJson[pMasqueradingVector[2]], err, false))
+              return false;
+      }
+      if(!pMasqueradingVector[3].empty() && pJson.isMember(pMasqueradingVector[3]))
+      {
+          if(!validJsonOfField(3, pMasqueradingVector[3], pJson[pMasqueradingVector[3]], err, false))
+              return false;
+      }
+      if(!pMasqueradingVector[4].empty() && pJson.isMember(pMasqueradingVector[4]))
+      {
+          if(!validJsonOfField(4, pMasqueradingVector[4], pJson[pMasqueradingVector[4]], err, false))
+              return false;
+      }
+      if(!pMasqueradingVector[5].empty() && pJson.isMember(pMasqueradingVector[5]))
+      {
+          if(!validJsonOfField(5, pMasqueradingVector[5], pJson[pMasqueradingVector[5]], err, false))
+              return false;
+      }
+      if(!pMasqueradingVector[6].empty() && pJson.isMember(pMasqueradingVector[6]))
+      {
+          if(!validJsonOfField(6, pMasqueradingVector[6], pJson[pMasqueradingVector[6]], err, false))
+              return false;
+      }
+      if(!pMasqueradingVector[7].empty() && pJson.isMember(pMasqueradingVector[7]))
+      {
+          if(!validJsonOfField(7, pMasqueradingVector[7], pJson[pMasqueradingVector[7]], err, false))
+              return false;
+      }
+    }
+    catch(const Json::LogicError &e)
+    {
+      err = e.what();
+      return false;
+    }
+    return true;
+}
+bool DishIngredient::validJsonOfField(size_t index,
+                                      const std::string &fieldName,
+                                      const Json::Value &pJson,
+                                      std::string &err,
+                                      bool isForCreation)
+{
+    switch(index)
+    {
+        case 0:
+            if(pJson.isNull())
+            {
+                err="The " + fieldName + " column cannot be null";
+                return false;
+            }
+            if(isForCreation)
+            {
+                err="The automatic primary key cannot be set";
+                return false;
+            }
+            if(!pJson.isUInt())
+            {
+                err="Type error in the "+fieldName+" field";
+                return false;
+            }
+            break;
+        case 1:
+            if(pJson.isNull())
+            {
+                return true;
+            }
+            if(!pJson.isUInt())
+            {
+                err="Type error in the "+fieldName+" field";
+                return false;
+            }
+            break;
+        case 2:
+            if(pJson.isNull())
+            {
+                return true;
+            }
+            if(!pJson.isUInt())
+            {
+                err="Type error in the "+fieldName+" field";
+                return false;
+            }
+            break;
+        case 3:
+            if(pJson.isNull())
+            {
+                return true;
+            }
+            if(!pJson.isUInt())
+            {
+                err="Type error in the "+fieldName+" field";
+                return false;
+            }
+            break;
+        case 4:
+            if(pJson.isNull())
+            {
+                return true;
+            }
+            if(!pJson.isInt())
+            {
+                err="Type error in the "+fieldName+" field";
+                return false;
+            }
+            break;
+        case 5:
+            if(pJson.isNull())
+            {
+                return true;
+            }
+            if(!pJson.isString())
+            {
+                err="Type error in the "+fieldName+" field";
+                return false;
+            }
+            break;
+        case 6:
+            if(pJson.isNull())
+            {
+                return true;
+            }
+            if(!pJson.isString())
+            {
+                err="Type error in the "+fieldName+" field";
+                return false;
+            }
+            break;
+        case 7:
+            if(pJson.isNull())
+            {
+                return true;
+            }
+            if(!pJson.isInt())
+            {
+                err="Type error in the "+fieldName+" field";
+                return false;
+            }
+            break;
+        default:
+            err="Internal error in the server";
+            return false;
+    }
+    return true;
+}
@@ -39,7 +39,7 @@ const std::vector<typename Inventory::MetaData> Inventory::metaData_={
 {"quantity","int32_t","int(11)",4,0,0,0},
 {"item_name","std::string","varchar(255)",255,0,0,0},
 {"item_category","std::string","varchar(255)",255,0,0,0},
-{"item_cost","std::string","varchar(255)",255,0,0,0},
+{"item_cost","std::string","decimal(12,2)",0,0,0,0},
 {"min_stock","int32_t","int(11)",4,0,0,0},
 {"max_stock","int32_t","int(11)",4,0,0,0},
 {"supplier","std::string","varchar(255)",255,0,0,0},
@@ -2468,14 +2468,6 @@ bool Inventory::validJsonOfField(size_t index,
                 err="Type error in the "+fieldName+" field";
                 return false;
             }
-            if(pJson.isString() && std::strlen(pJson.asCString()) > 255)
-            {
-                err="String length exceeds limit for the " +
-                    fieldName +
-                    " field (the maximum value is 255)";
-                return false;
-            }
-
             break;
         case 6:
             if(pJson.isNull())
@@ -43,7 +43,7 @@ const std::vector<typename Member::MetaData> Member::metaData_={
 {"phone","std::string","varchar(255)",255,0,0,0},
 {"points","uint32_t","int(10) unsigned",4,0,0,0},
 {"total_points","uint32_t","int(10) unsigned",4,0,0,0},
-{"total_spent","std::string","varchar(255)",255,0,0,0},
+{"total_spent","std::string","decimal(12,2)",0,0,0,0},
 {"expire_date","::trantor::Date","timestamp",0,0,0,0},
 {"status","std::string","varchar(50)",50,0,0,0},
 {"created_at","::trantor::Date","timestamp",0,0,0,0},
@@ -2613,14 +2613,6 @@ bool Member::validJsonOfField(size_t index,
                 err="Type error in the "+fieldName+" field";
                 return false;
             }
-            if(pJson.isString() && std::strlen(pJson.asCString()) > 255)
-            {
-                err="String length exceeds limit for the " +
-                    fieldName +
-                    " field (the maximum value is 255)";
-                return false;
-            }
-
             break;
         case 9:
             if(pJson.isNull())
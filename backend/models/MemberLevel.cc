@@ -33,8 +33,8 @@ const std::vector<typename MemberLevel::MetaData> MemberLevel::metaData_={
 {"tenant_id","uint32_t","int(10) unsigned",4,0,0,0},
 {"level_name","std::string","varchar(255)",255,0,0,0},
 {"required_points","uint32_t","int(10) unsigned",4,0,0,0},
-{"required_spent","std::string","varchar(255)",255,0,0,0},
-{"discount_rate","std::string","varchar(255)",255,0,0,0},
+{"required_spent","std::string","decimal(12,2)",0,0,0,0},
+{"discount_rate","std::string","decimal(6,4)",0,0,0,0},
 {"icon_url","std::string","varchar(255)",255,0,0,0},
 {"benefits","std::string","longtext",0,0,0,0}
 };
@@ -1377,14 +1377,6 @@ bool MemberLevel::validJsonOfField(size_t index,
                 err="Type error in the "+fieldName+" field";
                 return false;
             }
-            if(pJson.isString() && std::strlen(pJson.asCString()) > 255)
-            {
-                err="String length exceeds limit for the " +
-                    fieldName +
-                    " field (the maximum value is 255)";
-                return false;
-            }
-
             break;
         case 5:
             if(pJson.isNull())
@@ -1396,14 +1388,6 @@ bool MemberLevel::validJsonOfField(size_t index,
                 err="Type error in the "+fieldName+" field";
                 return false;
             }
-            if(pJson.isString() && std::strlen(pJson.asCString()) > 255)
-            {
-                err="String length exceeds limit for the " +
-                    fieldName +
-                    " field (the maximum value is 255)";
-                return false;
-            }
-
             break;
         case 6:
             if(pJson.isNull())
@@ -18,6 +18,7 @@ using namespace drogon_model::saas_restaurant;
 const std::string OrderTable::Cols::_order_id = "order_id";
 const std::string OrderTable::Cols::_tenant_id = "tenant_id";
 const std::string OrderTable::Cols::_user_id = "user_id";
+const std::string OrderTable::Cols::_branch_id = "branch_id";
 const std::string OrderTable::Cols::_total_amount = "total_amount";
 const std::string OrderTable::Cols::_discount_ammout = "discount_ammout";
 const std::string OrderTable::Cols::_payment_method = "payment_method";
@@ -37,8 +38,9 @@ const std::vector<typename OrderTable::MetaData> OrderTable::metaData_={
 {"order_id","uint32_t","int(10) unsigned",4,1,1,1},
 {"tenant_id","uint32_t","int(10) unsigned",4,0,0,0},
 {"user_id","uint32_t","int(10) unsigned",4,0,0,0},
-{"total_amount","std::string","varchar(255)",255,0,0,0},
-{"discount_ammout","std::string","varchar(255)",255,0,0,0},
+{"branch_id","uint32_t","int(10) unsigned",4,0,0,0},
+{"total_amount","std::string","decimal(12,2)",0,0,0,0},
+{"discount_ammout","std::string","decimal(12,2)",0,0,0,0},
 {"payment_method","std::string","varchar(255)",255,0,0,0},
 {"payment_status","std::string","varchar(50)",50,0,0,0},
 {"order_status","std::string","varchar(50)",50,0,0,0},
@@ -70,6 +72,10 @@ OrderTable::OrderTable(const Row &r, const ssize_t indexOffset) noexcept
         {
             userId_=std::make_shared<uint32_t>(r["user_id"].as<uint32_t>());
         }
+        if(!r["branch_id"].isNull())
+        {
+            branchId_=std::make_shared<uint32_t>(r["branch_id"].as<uint32_t>());
+        }
         if(!r["total_amount"].isNull())
         {
             totalAmount_=std::make_shared<std::string>(r["total_amount"].as<std::string>());
@@ -154,7 +160,7 @@ OrderTable::OrderTable(const Row &r, const ssize_t indexOffset) noexcept
     else
     {
         size_t offset = (size_t)indexOffset;
-        if(offset + 14 > r.size())
+        if(offset + 15 > r.size())
         {
             LOG_FATAL << "Invalid SQL result for this model";
             return;
@@ -178,45 +184,50 @@ OrderTable::OrderTable(const Row &r, const ssize_t indexOffset) noexcept
         index = offset + 3;
         if(!r[index].isNull())
         {
-            totalAmount_=std::make_shared<std::string>(r[index].as<std::string>());
+            branchId_=std::make_shared<uint32_t>(r[index].as<uint32_t>());
         }
         index = offset + 4;
         if(!r[index].isNull())
         {
-            discountAmmout_=std::make_shared<std::string>(r[index].as<std::string>());
+            totalAmount_=std::make_shared<std::string>(r[index].as<std::string>());
         }
         index = offset + 5;
         if(!r[index].isNull())
         {
-            paymentMethod_=std::make_shared<std::string>(r[index].as<std::string>());
+            discountAmmout_=std::make_shared<std::string>(r[index].as<std::string>());
         }
         index = offset + 6;
         if(!r[index].isNull())
         {
-            paymentStatus_=std::make_shared<std::string>(r[index].as<std::string>());
+            paymentMethod_=std::make_shared<std::string>(r[index].as<std::string>());
         }
         index = offset + 7;
         if(!r[index].isNull())
         {
-            orderStatus_=std::make_shared<std::string>(r[index].as<std::string>());
+            paymentStatus_=std::make_shared<std::string>(r[index].as<std::string>());
         }
         index = offset + 8;
         if(!r[index].isNull())
         {
-            deliveryAddress_=std::make_shared<std::string>(r[index].as<std::string>());
+            orderStatus_=std::make_shared<std::string>(r[index].as<std::string>());
         }
         index = offset + 9;
         if(!r[index].isNull())
         {
-            orderDetail_=std::make_shared<std::string>(r[index].as<std::string>());
+            deliveryAddress_=std::make_shared<std::string>(r[index].as<std::string>());
         }
         index = offset + 10;
         if(!r[index].isNull())
         {
-            remark_=std::make_shared<std::string>(r[index].as<std::string>());
+            orderDetail_=std::make_shared<std::string>(r[index].as<std::string>());
         }
         index = offset + 11;
         if(!r[index].isNull())
+        {
+            remark_=std::make_shared<std::string>(r[index].as<std::string>());
+        }
+        index = offset + 12;
+        if(!r[index].isNull())
         {
             auto timeStr = r[index].as<std::string>();
             struct tm stm;
@@ -238,7 +249,7 @@ OrderTable::OrderTable(const Row &r, const ssize_t indexOffset) noexcept
                 createdAt_=std::make_shared<::trantor::Date>(t*1000000+decimalNum);
             }
         }
-        index = offset + 12;
+        index = offset + 13;
         if(!r[index].isNull())
         {
             auto timeStr = r[index].as<std::string>();
@@ -261,7 +272,7 @@ OrderTable::OrderTable(const Row &r, const ssize_t indexOffset) noexcept
                 updatedAt_=std::make_shared<::trantor::Date>(t*1000000+decimalNum);
             }
         }
-        index = offset + 13;
+        index = offset + 14;
         if(!r[index].isNull())
         {
             isDeleted_=std::make_shared<int8_t>(r[index].as<int8_t>());
@@ -272,7 +283,7 @@ OrderTable::OrderTable(const Row &r, const ssize_t indexOffset) noexcept
 
 OrderTable::OrderTable(const Json::Value &pJson, const std::vector<std::string> &pMasqueradingVector) noexcept(false)
 {
-    if(pMasqueradingVector.size() != 14)
+    if(pMasqueradingVector.size() != 15)
     {
         LOG_ERROR << "Bad masquerading vector";
         return;
@@ -306,7 +317,7 @@ OrderTable::OrderTable(const Json::Value &pJson, const std::vector<std::string>
         dirtyFlag_[3] = true;
         if(!pJson[pMasqueradingVector[3]].isNull())
         {
-            totalAmount_=std::make_shared<std::string>(pJson[pMasqueradingVector[3]].asString());
+            branchId_=std::make_shared<uint32_t>((uint32_t)pJson[pMasqueradingVector[3]].asUInt64());
         }
     }
     if(!pMasqueradingVector[4].empty() && pJson.isMember(pMasqueradingVector[4]))
@@ -314,7 +325,7 @@ OrderTable::OrderTable(const Json::Value &pJson, const std::vector<std::string>
         dirtyFlag_[4] = true;
         if(!pJson[pMasqueradingVector[4]].isNull())
         {
-            discountAmmout_=std::make_shared<std::string>(pJson[pMasqueradingVector[4]].asString());
+            totalAmount_=std::make_shared<std::string>(pJson[pMasqueradingVector[4]].asString());
         }
     }
     if(!pMasqueradingVector[5].empty() && pJson.isMember(pMasqueradingVector[5]))
@@ -322,7 +333,7 @@ OrderTable::OrderTable(const Json::Value &pJson, const std::vector<std::string>
         dirtyFlag_[5] = true;
         if(!pJson[pMasqueradingVector[5]].isNull())
         {
-            paymentMethod_=std::make_shared<std::string>(pJson[pMasqueradingVector[5]].asString());
+            discountAmmout_=std::make_shared<std::string>(pJson[pMasqueradingVector[5]].asString());
         }
     }
     if(!pMasqueradingVector[6].empty() && pJson.isMember(pMasqueradingVector[6]))
@@ -330,7 +341,7 @@ OrderTable::OrderTable(const Json::Value &pJson, const std::vector<std::string>
         dirtyFlag_[6] = true;
         if(!pJson[pMasqueradingVector[6]].isNull())
         {
-            paymentStatus_=std::make_shared<std::string>(pJson[pMasqueradingVector[6]].asString());
+            paymentMethod_=std::make_shared<std::string>(pJson[pMasqueradingVector[6]].asString());
         }
     }
     if(!pMasqueradingVector[7].empty() && pJson.isMember(pMasqueradingVector[7]))
@@ -338,7 +349,7 @@ OrderTable::OrderTable(const Json::Value &pJson, const std::vector<std::string>
         dirtyFlag_[7] = true;
         if(!pJson[pMasqueradingVector[7]].isNull())
         {
-            orderStatus_=std::make_shared<std::string>(pJson[pMasqueradingVector[7]].asString());
+            paymentStatus_=std::make_shared<std::string>(pJson[pMasqueradingVector[7]].asString());
         }
     }
     if(!pMasqueradingVector[8].empty() && pJson.isMember(pMasqueradingVector[8]))
@@ -346,7 +357,7 @@ OrderTable::OrderTable(const Json::Value &pJson, const std::vector<std::string>
         dirtyFlag_[8] = true;
         if(!pJson[pMasqueradingVector[8]].isNull())
         {
-            deliveryAddress_=std::make_shared<std::string>(pJson[pMasqueradingVector[8]].asString());
+            orderStatus_=std::make_shared<std::string>(pJson[pMasqueradingVector[8]].asString());
         }
     }
     if(!pMasqueradingVector[9].empty() && pJson.isMember(pMasqueradingVector[9]))
@@ -354,7 +365,7 @@ OrderTable::OrderTable(const Json::Value &pJson, const std::vector<std::string>
         dirtyFlag_[9] = true;
         if(!pJson[pMasqueradingVector[9]].isNull())
         {
-            orderDetail_=std::make_shared<std::string>(pJson[pMasqueradingVector[9]].asString());
+            deliveryAddress_=std::make_shared<std::string>(pJson[pMasqueradingVector[9]].asString());
         }
     }
     if(!pMasqueradingVector[10].empty() && pJson.isMember(pMasqueradingVector[10]))
@@ -362,7 +373,7 @@ OrderTable::OrderTable(const Json::Value &pJson, const std::vector<std::string>
         dirtyFlag_[10] = true;
         if(!pJson[pMasqueradingVector[10]].isNull())
         {
-            remark_=std::make_shared<std::string>(pJson[pMasqueradingVector[10]].asString());
+            orderDetail_=std::make_shared<std::string>(pJson[pMasqueradingVector[10]].asString());
         }
     }
     if(!pMasqueradingVector[11].empty() && pJson.isMember(pMasqueradingVector[11]))
@@ -370,7 +381,15 @@ OrderTable::OrderTable(const Json::Value &pJson, const std::vector<std::string>
         dirtyFlag_[11] = true;
         if(!pJson[pMasqueradingVector[11]].isNull())
         {
-            auto timeStr = pJson[pMasqueradingVector[11]].asString();
+            remark_=std::make_shared<std::string>(pJson[pMasqueradingVector[11]].asString());
+        }
+    }
+    if(!pMasqueradingVector[12].empty() && pJson.isMember(pMasqueradingVector[12]))
+    {
+        dirtyFlag_[12] = true;
+        if(!pJson[pMasqueradingVector[12]].isNull())
+        {
+            auto timeStr = pJson[pMasqueradingVector[12]].asString();
             struct tm stm;
             memset(&stm,0,sizeof(stm));
             auto p = strptime(timeStr.c_str(),"%Y-%m-%d %H:%M:%S",&stm);
@@ -391,12 +410,12 @@ OrderTable::OrderTable(const Json::Value &pJson, const std::vector<std::string>
             }
         }
     }
-    if(!pMasqueradingVector[12].empty() && pJson.isMember(pMasqueradingVector[12]))
+    if(!pMasqueradingVector[13].empty() && pJson.isMember(pMasqueradingVector[13]))
     {
-        dirtyFlag_[12] = true;
-        if(!pJson[pMasqueradingVector[12]].isNull())
+        dirtyFlag_[13] = true;
+        if(!pJson[pMasqueradingVector[13]].isNull())
         {
-            auto timeStr = pJson[pMasqueradingVector[12]].asString();
+            auto timeStr = pJson[pMasqueradingVector[13]].asString();
             struct tm stm;
             memset(&stm,0,sizeof(stm));
             auto p = strptime(timeStr.c_str(),"%Y-%m-%d %H:%M:%S",&stm);
@@ -417,12 +436,12 @@ OrderTable::OrderTable(const Json::Value &pJson, const std::vector<std::string>
             }
         }
     }
-    if(!pMasqueradingVector[13].empty() && pJson.isMember(pMasqueradingVector[13]))
+    if(!pMasqueradingVector[14].empty() && pJson.isMember(pMasqueradingVector[14]))
     {
-        dirtyFlag_[13] = true;
-        if(!pJson[pMasqueradingVector[13]].isNull())
+        dirtyFlag_[14] = true;
+        if(!pJson[pMasqueradingVector[14]].isNull())
         {
-            isDeleted_=std::make_shared<int8_t>((int8_t)pJson[pMasqueradingVector[13]].asInt64());
+            isDeleted_=std::make_shared<int8_t>((int8_t)pJson[pMasqueradingVector[14]].asInt64());
         }
     }
 }
@@ -453,9 +472,17 @@ OrderTable::OrderTable(const Json::Value &pJson) noexcept(false)
             userId_=std::make_shared<uint32_t>((uint32_t)pJson["user_id"].asUInt64());
         }
     }
-    if(pJson.isMember("total_amount"))
+    if(pJson.isMember("branch_id"))
     {
         dirtyFlag_[3]=true;
+        if(!pJson["branch_id"].isNull())
+        {
+            branchId_=std::make_shared<uint32_t>((uint32_t)pJson["branch_id"].asUInt64());
+        }
+    }
+    if(pJson.isMember("total_amount"))
+    {
+        dirtyFlag_[4]=true;
         if(!pJson["total_amount"].isNull())
         {
             totalAmount_=std::make_shared<std::string>(pJson["total_amount"].asString());
@@ -463,7 +490,7 @@ OrderTable::OrderTable(const Json::Value &pJson) noexcept(false)
     }
     if(pJson.isMember("discount_ammout"))
     {
-        dirtyFlag_[4]=true;
+        dirtyFlag_[5]=true;
         if(!pJson["discount_ammout"].isNull())
         {
             discountAmmout_=std::make_shared<std::string>(pJson["discount_ammout"].asString());
@@ -471,7 +498,7 @@ OrderTable::OrderTable(const Json::Value &pJson) noexcept(false)
     }
     if(pJson.isMember("payment_method"))
     {
-        dirtyFlag_[5]=true;
+        dirtyFlag_[6]=true;
         if(!pJson["payment_method"].isNull())
         {
             paymentMethod_=std::make_shared<std::string>(pJson["payment_method"].asString());
@@ -479,7 +506,7 @@ OrderTable::OrderTable(const Json::Value &pJson) noexcept(false)
     }
     if(pJson.isMember("payment_status"))
     {
-        dirtyFlag_[6]=true;
+        dirtyFlag_[7]=true;
         if(!pJson["payment_status"].isNull())
         {
             paymentStatus_=std::make_shared<std::string>(pJson["payment_status"].asString());
@@ -487,7 +514,7 @@ OrderTable::OrderTable(const Json::Value &pJson) noexcept(false)
     }
     if(pJson.isMember("order_status"))
     {
-        dirtyFlag_[7]=true;
+        dirtyFlag_[8]=true;
         if(!pJson["order_status"].isNull())
         {
             orderStatus_=std::make_shared<std::string>(pJson["order_status"].asString());
@@ -495,7 +522,7 @@ OrderTable::OrderTable(const Json::Value &pJson) noexcept(false)
     }
     if(pJson.isMember("delivery_address"))
     {
-        dirtyFlag_[8]=true;
+        dirtyFlag_[9]=true;
         if(!pJson["delivery_address"].isNull())
         {
             deliveryAddress_=std::make_shared<std::string>(pJson["delivery_address"].asString());
@@ -503,7 +530,7 @@ OrderTable::OrderTable(const Json::Value &pJson) noexcept(false)
     }
     if(pJson.isMember("order_detail"))
     {
-        dirtyFlag_[9]=true;
+        dirtyFlag_[10]=true;
         if(!pJson["order_detail"].isNull())
         {
             orderDetail_=std::make_shared<std::string>(pJson["order_detail"].asString());
@@ -511,7 +538,7 @@ OrderTable::OrderTable(const Json::Value &pJson) noexcept(false)
     }
     if(pJson.isMember("remark"))
     {
-        dirtyFlag_[10]=true;
+        dirtyFlag_[11]=true;
         if(!pJson["remark"].isNull())
         {
             remark_=std::make_shared<std::string>(pJson["remark"].asString());
@@ -519,7 +546,7 @@ OrderTable::OrderTable(const Json::Value &pJson) noexcept(false)
     }
     if(pJson.isMember("created_at"))
     {
-        dirtyFlag_[11]=true;
+        dirtyFlag_[12]=true;
         if(!pJson["created_at"].isNull())
         {
             auto timeStr = pJson["created_at"].asString();
@@ -545,7 +572,7 @@ OrderTable::OrderTable(const Json::Value &pJson) noexcept(false)
     }
     if(pJson.isMember("updated_at"))
     {
-        dirtyFlag_[12]=true;
+        dirtyFlag_[13]=true;
         if(!pJson["updated_at"].isNull())
         {
             auto timeStr = pJson["updated_at"].asString();
@@ -571,7 +598,7 @@ OrderTable::OrderTable(const Json::Value &pJson) noexcept(false)
     }
     if(pJson.isMember("is_deleted"))
     {
-        dirtyFlag_[13]=true;
+        dirtyFlag_[14]=true;
         if(!pJson["is_deleted"].isNull())
         {
             isDeleted_=std::make_shared<int8_t>((int8_t)pJson["is_deleted"].asInt64());
@@ -582,7 +609,7 @@ OrderTable::OrderTable(const Json::Value &pJson) noexcept(false)
 void OrderTable::updateByMasqueradedJson(const Json::Value &pJson,
                                             const std::vector<std::string> &pMasqueradingVector) noexcept(false)
 {
-    if(pMasqueradingVector.size() != 14)
+    if(pMasqueradingVector.size() != 15)
     {
         LOG_ERROR << "Bad masquerading vector";
         return;
@@ -615,7 +642,7 @@ void OrderTable::updateByMasqueradedJson(const Json::Value &pJson,
         dirtyFlag_[3] = true;
         if(!pJson[pMasqueradingVector[3]].isNull())
         {
-            totalAmount_=std::make_shared<std::string>(pJson[pMasqueradingVector[3]].asString());
+            branchId_=std::make_shared<uint32_t>((uint32_t)pJson[pMasqueradingVector[3]].asUInt64());
         }
     }
     if(!pMasqueradingVector[4].empty() && pJson.isMember(pMasqueradingVector[4]))
@@ -623,7 +650,7 @@ void OrderTable::updateByMasqueradedJson(const Json::Value &pJson,
         dirtyFlag_[4] = true;
         if(!pJson[pMasqueradingVector[4]].isNull())
         {
-            discountAmmout_=std::make_shared<std::string>(pJson[pMasqueradingVector[4]].asString());
+            totalAmount_=std::make_shared<std::string>(pJson[pMasqueradingVector[4]].asString());
         }
     }
     if(!pMasqueradingVector[5].empty() && pJson.isMember(pMasqueradingVector[5]))
@@ -631,7 +658,7 @@ void OrderTable::updateByMasqueradedJson(const Json::Value &pJson,
         dirtyFlag_[5] = true;
         if(!pJson[pMasqueradingVector[5]].isNull())
         {
-            paymentMethod_=std::make_shared<std::string>(pJson[pMasqueradingVector[5]].asString());
+            discountAmmout_=std::make_shared<std::string>(pJson[pMasqueradingVector[5]].asString());
         }
     }
     if(!pMasqueradingVector[6].empty() && pJson.isMember(pMasqueradingVector[6]))
@@ -639,7 +666,7 @@ void OrderTable::updateByMasqueradedJson(const Json::Value &pJson,
         dirtyFlag_[6] = true;
         if(!pJson[pMasqueradingVector[6]].isNull())
         {
-            paymentStatus_=std::make_shared<std::string>(pJson[pMasqueradingVector[6]].asString());
+            paymentMethod_=std::make_shared<std::string>(pJson[pMasqueradingVector[6]].asString());
         }
     }
     if(!pMasqueradingVector[7].empty() && pJson.isMember(pMasqueradingVector[7]))
@@ -647,7 +674,7 @@ void OrderTable::updateByMasqueradedJson(const Json::Value &pJson,
         dirtyFlag_[7] = true;
         if(!pJson[pMasqueradingVector[7]].isNull())
         {
-            orderStatus_=std::make_shared<std::string>(pJson[pMasqueradingVector[7]].asString());
+            paymentStatus_=std::make_shared<std::string>(pJson[pMasqueradingVector[7]].asString());
         }
     }
     if(!pMasqueradingVector[8].empty() && pJson.isMember(pMasqueradingVector[8]))
@@ -655,7 +682,7 @@ void OrderTable::updateByMasqueradedJson(const Json::Value &pJson,
         dirtyFlag_[8] = true;
         if(!pJson[pMasqueradingVector[8]].isNull())
         {
-            deliveryAddress_=std::make_shared<std::string>(pJson[pMasqueradingVector[8]].asString());
+            orderStatus_=std::make_shared<std::string>(pJson[pMasqueradingVector[8]].asString());
         }
     }
     if(!pMasqueradingVector[9].empty() && pJson.isMember(pMasqueradingVector[9]))
@@ -663,7 +690,7 @@ void OrderTable::updateByMasqueradedJson(const Json::Value &pJson,
         dirtyFlag_[9] = true;
         if(!pJson[pMasqueradingVector[9]].isNull())
         {
-            orderDetail_=std::make_shared<std::string>(pJson[pMasqueradingVector[9]].asString());
+            deliveryAddress_=std::make_shared<std::string>(pJson[pMasqueradingVector[9]].asString());
         }
     }
     if(!pMasqueradingVector[10].empty() && pJson.isMember(pMasqueradingVector[10]))
@@ -671,7 +698,7 @@ void OrderTable::updateByMasqueradedJson(const Json::Value &pJson,
         dirtyFlag_[10] = true;
         if(!pJson[pMasqueradingVector[10]].isNull())
         {
-            remark_=std::make_shared<std::string>(pJson[pMasqueradingVector[10]].asString());
+            orderDetail_=std::make_shared<std::string>(pJson[pMasqueradingVector[10]].asString());
         }
     }
     if(!pMasqueradingVector[11].empty() && pJson.isMember(pMasqueradingVector[11]))
@@ -679,7 +706,15 @@ void OrderTable::updateByMasqueradedJson(const Json::Value &pJson,
         dirtyFlag_[11] = true;
         if(!pJson[pMasqueradingVector[11]].isNull())
         {
-            auto timeStr = pJson[pMasqueradingVector[11]].asString();
+            remark_=std::make_shared<std::string>(pJson[pMasqueradingVector[11]].asString());
+        }
+    }
+    if(!pMasqueradingVector[12].empty() && pJson.isMember(pMasqueradingVector[12]))
+    {
+        dirtyFlag_[12] = true;
+        if(!pJson[pMasqueradingVector[12]].isNull())
+        {
+            auto timeStr = pJson[pMasqueradingVector[12]].asString();
             struct tm stm;
             memset(&stm,0,sizeof(stm));
             auto p = strptime(timeStr.c_str(),"%Y-%m-%d %H:%M:%S",&stm);
@@ -700,12 +735,12 @@ void OrderTable::updateByMasqueradedJson(const Json::Value &pJson,
             }
         }
     }
-    if(!pMasqueradingVector[12].empty() && pJson.isMember(pMasqueradingVector[12]))
+    if(!pMasqueradingVector[13].empty() && pJson.isMember(pMasqueradingVector[13]))
     {
-        dirtyFlag_[12] = true;
-        if(!pJson[pMasqueradingVector[12]].isNull())
+        dirtyFlag_[13] = true;
+        if(!pJson[pMasqueradingVector[13]].isNull())
         {
-            auto timeStr = pJson[pMasqueradingVector[12]].asString();
+            auto timeStr = pJson[pMasqueradingVector[13]].asString();
             struct tm stm;
             memset(&stm,0,sizeof(stm));
             auto p = strptime(timeStr.c_str(),"%Y-%m-%d %H:%M:%S",&stm);
@@ -726,12 +761,12 @@ void OrderTable::updateByMasqueradedJson(const Json::Value &pJson,
             }
         }
     }
-    if(!pMasqueradingVector[13].empty() && pJson.isMember(pMasqueradingVector[13]))
+    if(!pMasqueradingVector[14].empty() && pJson.isMember(pMasqueradingVector[14]))
     {
-        dirtyFlag_[13] = true;
-        if(!pJson[pMasqueradingVector[13]].isNull())
+        dirtyFlag_[14] = true;
+        if(!pJson[pMasqueradingVector[14]].isNull())
         {
-            isDeleted_=std::make_shared<int8_t>((int8_t)pJson[pMasqueradingVector[13]].asInt64());
+            isDeleted_=std::make_shared<int8_t>((int8_t)pJson[pMasqueradingVector[14]].asInt64());
         }
     }
 }
@@ -761,9 +796,17 @@ void OrderTable::updateByJson(const Json::Value &pJson) noexcept(false)
             userId_=std::make_shared<uint32_t>((uint32_t)pJson["user_id"].asUInt64());
         }
     }
-    if(pJson.isMember("total_amount"))
+    if(pJson.isMember("branch_id"))
     {
         dirtyFlag_[3] = true;
+        if(!pJson["branch_id"].isNull())
+        {
+            branchId_=std::make_shared<uint32_t>((uint32_t)pJson["branch_id"].asUInt64());
+        }
+    }
+    if(pJson.isMember("total_amount"))
+    {
+        dirtyFlag_[4] = true;
         if(!pJson["total_amount"].isNull())
         {
             totalAmount_=std::make_shared<std::string>(pJson["total_amount"].asString());
@@ -771,7 +814,7 @@ void OrderTable::updateByJson(const Json::Value &pJson) noexcept(false)
     }
     if(pJson.isMember("discount_ammout"))
     {
-        dirtyFlag_[4] = true;
+        dirtyFlag_[5] = true;
         if(!pJson["discount_ammout"].isNull())
         {
             discountAmmout_=std::make_shared<std::string>(pJson["discount_ammout"].asString());
@@ -779,7 +822,7 @@ void OrderTable::updateByJson(const Json::Value &pJson) noexcept(false)
     }
     if(pJson.isMember("payment_method"))
     {
-        dirtyFlag_[5] = true;
+        dirtyFlag_[6] = true;
         if(!pJson["payment_method"].isNull())
         {
             paymentMethod_=std::make_shared<std::string>(pJson["payment_method"].asString());
@@ -787,7 +830,7 @@ void OrderTable::updateByJson(const Json::Value &pJson) noexcept(false)
     }
     if(pJson.isMember("payment_status"))
     {
-        dirtyFlag_[6] = true;
+        dirtyFlag_[7] = true;
         if(!pJson["payment_status"].isNull())
         {
             paymentStatus_=std::make_shared<std::string>(pJson["payment_status"].asString());
@@ -795,7 +838,7 @@ void OrderTable::updateByJson(const Json::Value &pJson) noexcept(false)
     }
     if(pJson.isMember("order_status"))
     {
-        dirtyFlag_[7] = true;
+        dirtyFlag_[8] = true;
         if(!pJson["order_status"].isNull())
         {
             orderStatus_=std::make_shared<std::string>(pJson["order_status"].asString());
@@ -803,7 +846,7 @@ void OrderTable::updateByJson(const Json::Value &pJson) noexcept(false)
     }
     if(pJson.isMember("delivery_address"))
     {
-        dirtyFlag_[8] = true;
+        dirtyFlag_[9] = true;
         if(!pJson["delivery_address"].isNull())
         {
             deliveryAddress_=std::make_shared<std::string>(pJson["delivery_address"].asString());
@@ -811,7 +854,7 @@ void OrderTable::updateByJson(const Json::Value &pJson) noexcept(false)
     }
     if(pJson.isMember("order_detail"))
     {
-        dirtyFlag_[9] = true;
+        dirtyFlag_[10] = true;
         if(!pJson["order_detail"].isNull())
         {
             orderDetail_=std::make_shared<std::string>(pJson["order_detail"].asString());
@@ -819,7 +862,7 @@ void OrderTable::updateByJson(const Json::Value &pJson) noexcept(false)
     }
     if(pJson.isMember("remark"))
     {
-        dirtyFlag_[10] = true;
+        dirtyFlag_[11] = true;
         if(!pJson["remark"].isNull())
         {
             remark_=std::make_shared<std::string>(pJson["remark"].asString());
@@ -827,7 +870,7 @@ void OrderTable::updateByJson(const Json::Value &pJson) noexcept(false)
     }
     if(pJson.isMember("created_at"))
     {
-        dirtyFlag_[11] = true;
+        dirtyFlag_[12] = true;
         if(!pJson["created_at"].isNull())
         {
             auto timeStr = pJson["created_at"].asString();
@@ -853,7 +896,7 @@ void OrderTable::updateByJson(const Json::Value &pJson) noexcept(false)
     }
     if(pJson.isMember("updated_at"))
     {
-        dirtyFlag_[12] = true;
+        dirtyFlag_[13] = true;
         if(!pJson["updated_at"].isNull())
         {
             auto timeStr = pJson["updated_at"].asString();
@@ -879,7 +922,7 @@ void OrderTable::updateByJson(const Json::Value &pJson) noexcept(false)
     }
     if(pJson.isMember("is_deleted"))
     {
-        dirtyFlag_[13] = true;
+        dirtyFlag_[14] = true;
         if(!pJson["is_deleted"].isNull())
         {
             isDeleted_=std::make_shared<int8_t>((int8_t)pJson["is_deleted"].asInt64());
@@ -953,6 +996,28 @@ void OrderTable::setUserIdToNull() noexcept
     dirtyFlag_[2] = true;
 }
 
+const uint32_t &OrderTable::getValueOfBranchId() const noexcept
+{
+    static const uint32_t defaultValue = uint32_t();
+    if(branchId_)
+        return *branchId_;
+    return defaultValue;
+}
+const std::shared_ptr<uint32_t> &OrderTable::getBranchId() const noexcept
+{
+    return branchId_;
+}
+void OrderTable::setBranchId(const uint32_t &pBranchId) noexcept
+{
+    branchId_ = std::make_shared<uint32_t>(pBranchId);
+    dirtyFlag_[3] = true;
+}
+void OrderTable::setBranchIdToNull() noexcept
+{
+    branchId_.reset();
+    dirtyFlag_[3] = true;
+}
+
 const std::string &OrderTable::getValueOfTotalAmount() const noexcept
 {
     static const std::string defaultValue = std::string();
@@ -967,17 +1032,17 @@ const std::shared_ptr<std::string> &OrderTable::getTotalAmount() const noexcept
 void OrderTable::setTotalAmount(const std::string &pTotalAmount) noexcept
 {
     totalAmount_ = std::make_shared<std::string>(pTotalAmount);
-    dirtyFlag_[3] = true;
+    dirtyFlag_[4] = true;
 }
 void OrderTable::setTotalAmount(std::string &&pTotalAmount) noexcept
 {
     totalAmount_ = std::make_shared<std::string>(std::move(pTotalAmount));
-    dirtyFlag_[3] = true;
+    dirtyFlag_[4] = true;
 }
 void OrderTable::setTotalAmountToNull() noexcept
 {
     totalAmount_.reset();
-    dirtyFlag_[3] = true;
+    dirtyFlag_[4] = true;
 }
 
 const std::string &OrderTable::getValueOfDiscountAmmout() const noexcept
@@ -994,17 +1059,17 @@ const std::shared_ptr<std::string> &OrderTable::getDiscountAmmout() const noexce
 void OrderTable::setDiscountAmmout(const std::string &pDiscountAmmout) noexcept
 {
     discountAmmout_ = std::make_shared<std::string>(pDiscountAmmout);
-    dirtyFlag_[4] = true;
+    dirtyFlag_[5] = true;
 }
 void OrderTable::setDiscountAmmout(std::string &&pDiscountAmmout) noexcept
 {
     discountAmmout_ = std::make_shared<std::string>(std::move(pDiscountAmmout));
-    dirtyFlag_[4] = true;
+    dirtyFlag_[5] = true;
 }
 void OrderTable::setDiscountAmmoutToNull() noexcept
 {
     discountAmmout_.reset();
-    dirtyFlag_[4] = true;
+    dirtyFlag_[5] = true;
 }
 
 const std::string &OrderTable::getValueOfPaymentMethod() const noexcept
@@ -1021,17 +1086,17 @@ const std::shared_ptr<std::string> &OrderTable::getPaymentMethod() const noexcep
 void OrderTable::setPaymentMethod(const std::string &pPaymentMethod) noexcept
 {
     paymentMethod_ = std::make_shared<std::string>(pPaymentMethod);
-    dirtyFlag_[5] = true;
+    dirtyFlag_[6] = true;
 }
 void OrderTable::setPaymentMethod(std::string &&pPaymentMethod) noexcept
 {
     paymentMethod_ = std::make_shared<std::string>(std::move(pPaymentMethod));
-    dirtyFlag_[5] = true;
+    dirtyFlag_[6] = true;
 }
 void OrderTable::setPaymentMethodToNull() noexcept
 {
     paymentMethod_.reset();
-    dirtyFlag_[5] = true;
+    dirtyFlag_[6] = true;
 }
 
 const std::string &OrderTable::getValueOfPaymentStatus() const noexcept
@@ -1048,17 +1113,17 @@ const std::shared_ptr<std::string> &OrderTable::getPaymentStatus() const noexcep
 void OrderTable::setPaymentStatus(const std::string &pPaymentStatus) noexcept
 {
     paymentStatus_ = std::make_shared<std::string>(pPaymentStatus);
-    dirtyFlag_[6] = true;
+    dirtyFlag_[7] = true;
 }
 void OrderTable::setPaymentStatus(std::string &&pPaymentStatus) noexcept
 {
     paymentStatus_ = std::make_shared<std::string>(std::move(pPaymentStatus));
-    dirtyFlag_[6] = true;
+    dirtyFlag_[7] = true;
 }
 void OrderTable::setPaymentStatusToNull() noexcept
 {
     paymentStatus_.reset();
-    dirtyFlag_[6] = true;
+    dirtyFlag_[7] = true;
 }
 
 const std::string &OrderTable::getValueOfOrderStatus() const noexcept
@@ -1075,17 +1140,17 @@ const std::shared_ptr<std::string> &OrderTable::getOrderStatus() const noexcept
 void OrderTable::setOrderStatus(const std::string &pOrderStatus) noexcept
 {
     orderStatus_ = std::make_shared<std::string>(pOrderStatus);
-    dirtyFlag_[7] = true;
+    dirtyFlag_[8] = true;
 }
 void OrderTable::setOrderStatus(std::string &&pOrderStatus) noexcept
 {
     orderStatus_ = std::make_shared<std::string>(std::move(pOrderStatus));
-    dirtyFlag_[7] = true;
+    dirtyFlag_[8] = true;
 }
 void OrderTable::setOrderStatusToNull() noexcept
 {
     orderStatus_.reset();
-    dirtyFlag_[7] = true;
+    dirtyFlag_[8] = true;
 }
 
 const std::string &OrderTable::getValueOfDeliveryAddress() const noexcept
@@ -1102,17 +1167,17 @@ const std::shared_ptr<std::string> &OrderTable::getDeliveryAddress() const noexc
 void OrderTable::setDeliveryAddress(const std::string &pDeliveryAddress) noexcept
 {
     deliveryAddress_ = std::make_shared<std::string>(pDeliveryAddress);
-    dirtyFlag_[8] = true;
+    dirtyFlag_[9] = true;
 }
 void OrderTable::setDeliveryAddress(std::string &&pDeliveryAddress) noexcept
 {
     deliveryAddress_ = std::make_shared<std::string>(std::move(pDeliveryAddress));
-    dirtyFlag_[8] = true;
+    dirtyFlag_[9] = true;
 }
 void OrderTable::setDeliveryAddressToNull() noexcept
 {
     deliveryAddress_.reset();
-    dirtyFlag_[8] = true;
+    dirtyFlag_[9] = true;
 }
 
 const std::string &OrderTable::getValueOfOrderDetail() const noexcept
@@ -1129,17 +1194,17 @@ const std::shared_ptr<std::string> &OrderTable::getOrderDetail() const noexcept
 void OrderTable::setOrderDetail(const std::string &pOrderDetail) noexcept
 {
     orderDetail_ = std::make_shared<std::string>(pOrderDetail);
-    dirtyFlag_[9] = true;
+    dirtyFlag_[10] = true;
 }
 void OrderTable::setOrderDetail(std::string &&pOrderDetail) noexcept
 {
     orderDetail_ = std::make_shared<std::string>(std::move(pOrderDetail));
-    dirtyFlag_[9] = true;
+    dirtyFlag_[10] = true;
 }
 void OrderTable::setOrderDetailToNull() noexcept
 {
     orderDetail_.reset();
-    dirtyFlag_[9] = true;
+    dirtyFlag_[10] = true;
 }
 
 const std::string &OrderTable::getValueOfRemark() const noexcept
@@ -1156,17 +1221,17 @@ const std::shared_ptr<std::string> &OrderTable::getRemark() const noexcept
 void OrderTable::setRemark(const std::string &pRemark) noexcept
 {
     remark_ = std::make_shared<std::string>(pRemark);
-    dirtyFlag_[10] = true;
+    dirtyFlag_[11] = true;
 }
 void OrderTable::setRemark(std::string &&pRemark) noexcept
 {
     remark_ = std::make_shared<std::string>(std::move(pRemark));
-    dirtyFlag_[10] = true;
+    dirtyFlag_[11] = true;
 }
 void OrderTable::setRemarkToNull() noexcept
 {
     remark_.reset();
-    dirtyFlag_[10] = true;
+    dirtyFlag_[11] = true;
 }
 
 const ::trantor::Date &OrderTable::getValueOfCreatedAt() const noexcept
@@ -1183,12 +1248,12 @@ const std::shared_ptr<::trantor::Date> &OrderTable::getCreatedAt() const noexcep
 void OrderTable::setCreatedAt(const ::trantor::Date &pCreatedAt) noexcept
 {
     createdAt_ = std::make_shared<::trantor::Date>(pCreatedAt);
-    dirtyFlag_[11] = true;
+    dirtyFlag_[12] = true;
 }
 void OrderTable::setCreatedAtToNull() noexcept
 {
     createdAt_.reset();
-    dirtyFlag_[11] = true;
+    dirtyFlag_[12] = true;
 }
 
 const ::trantor::Date &OrderTable::getValueOfUpdatedAt() const noexcept
@@ -1205,12 +1270,12 @@ const std::shared_ptr<::trantor::Date> &OrderTable::getUpdatedAt() const noexcep
 void OrderTable::setUpdatedAt(const ::trantor::Date &pUpdatedAt) noexcept
 {
     updatedAt_ = std::make_shared<::trantor::Date>(pUpdatedAt);
-    dirtyFlag_[12] = true;
+    dirtyFlag_[13] = true;
 }
 void OrderTable::setUpdatedAtToNull() noexcept
 {
     updatedAt_.reset();
-    dirtyFlag_[12] = true;
+    dirtyFlag_[13] = true;
 }
 
 const int8_t &OrderTable::getValueOfIsDeleted() const noexcept
@@ -1227,12 +1292,12 @@ const std::shared_ptr<int8_t> &OrderTable::getIsDeleted() const noexcept
 void OrderTable::setIsDeleted(const int8_t &pIsDeleted) noexcept
 {
     isDeleted_ = std::make_shared<int8_t>(pIsDeleted);
-    dirtyFlag_[13] = true;
+    dirtyFlag_[14] = true;
 }
 void OrderTable::setIsDeletedToNull() noexcept
 {
     isDeleted_.reset();
-    dirtyFlag_[13] = true;
+    dirtyFlag_[14] = true;
 }
 
 void OrderTable::updateId(const uint64_t id)
@@ -1245,6 +1310,7 @@ const std::vector<std::string> &OrderTable::insertColumns() noexcept
     static const std::vector<std::string> inCols={
         "tenant_id",
         "user_id",
+        "branch_id",
         "total_amount",
         "discount_ammout",
         "payment_method",
@@ -1285,6 +1351,17 @@ void OrderTable::outputArgs(drogon::orm::internal::SqlBinder &binder) const
         }
     }
     if(dirtyFlag_[3])
+    {
+        if(getBranchId())
+        {
+            binder << getValueOfBranchId();
+        }
+        else
+        {
+            binder << nullptr;
+        }
+    }
+    if(dirtyFlag_[4])
     {
         if(getTotalAmount())
         {
@@ -1295,7 +1372,7 @@ void OrderTable::outputArgs(drogon::orm::internal::SqlBinder &binder) const
             binder << nullptr;
         }
     }
-    if(dirtyFlag_[4])
+    if(dirtyFlag_[5])
     {
         if(getDiscountAmmout())
         {
@@ -1306,7 +1383,7 @@ void OrderTable::outputArgs(drogon::orm::internal::SqlBinder &binder) const
             binder << nullptr;
         }
     }
-    if(dirtyFlag_[5])
+    if(dirtyFlag_[6])
     {
         if(getPaymentMethod())
         {
@@ -1317,7 +1394,7 @@ void OrderTable::outputArgs(drogon::orm::internal::SqlBinder &binder) const
             binder << nullptr;
         }
     }
-    if(dirtyFlag_[6])
+    if(dirtyFlag_[7])
     {
         if(getPaymentStatus())
         {
@@ -1328,7 +1405,7 @@ void OrderTable::outputArgs(drogon::orm::internal::SqlBinder &binder) const
             binder << nullptr;
         }
     }
-    if(dirtyFlag_[7])
+    if(dirtyFlag_[8])
     {
         if(getOrderStatus())
         {
@@ -1339,7 +1416,7 @@ void OrderTable::outputArgs(drogon::orm::internal::SqlBinder &binder) const
             binder << nullptr;
         }
     }
-    if(dirtyFlag_[8])
+    if(dirtyFlag_[9])
     {
         if(getDeliveryAddress())
         {
@@ -1350,7 +1427,7 @@ void OrderTable::outputArgs(drogon::orm::internal::SqlBinder &binder) const
             binder << nullptr;
         }
     }
-    if(dirtyFlag_[9])
+    if(dirtyFlag_[10])
     {
         if(getOrderDetail())
         {
@@ -1361,7 +1438,7 @@ void OrderTable::outputArgs(drogon::orm::internal::SqlBinder &binder) const
             binder << nullptr;
         }
     }
-    if(dirtyFlag_[10])
+    if(dirtyFlag_[11])
     {
         if(getRemark())
         {
@@ -1372,7 +1449,7 @@ void OrderTable::outputArgs(drogon::orm::internal::SqlBinder &binder) const
             binder << nullptr;
         }
     }
-    if(dirtyFlag_[11])
+    if(dirtyFlag_[12])
     {
         if(getCreatedAt())
         {
@@ -1383,7 +1460,7 @@ void OrderTable::outputArgs(drogon::orm::internal::SqlBinder &binder) const
             binder << nullptr;
         }
     }
-    if(dirtyFlag_[12])
+    if(dirtyFlag_[13])
     {
         if(getUpdatedAt())
         {
@@ -1394,7 +1471,7 @@ void OrderTable::outputArgs(drogon::orm::internal::SqlBinder &binder) const
             binder << nullptr;
         }
     }
-    if(dirtyFlag_[13])
+    if(dirtyFlag_[14])
     {
         if(getIsDeleted())
         {
@@ -1462,6 +1539,10 @@ const std::vector<std::string> OrderTable::updateColumns() const
     {
         ret.push_back(getColumnName(13));
     }
+    if(dirtyFlag_[14])
+    {
+        ret.push_back(getColumnName(14));
+    }
     return ret;
 }
 
@@ -1490,6 +1571,17 @@ void OrderTable::updateArgs(drogon::orm::internal::SqlBinder &binder) const
         }
     }
     if(dirtyFlag_[3])
+    {
+        if(getBranchId())
+        {
+            binder << getValueOfBranchId();
+        }
+        else
+        {
+            binder << nullptr;
+        }
+    }
+    if(dirtyFlag_[4])
     {
         if(getTotalAmount())
         {
@@ -1500,7 +1592,7 @@ void OrderTable::updateArgs(drogon::orm::internal::SqlBinder &binder) const
             binder << nullptr;
         }
     }
-    if(dirtyFlag_[4])
+    if(dirtyFlag_[5])
     {
         if(getDiscountAmmout())
         {
@@ -1511,7 +1603,7 @@ void OrderTable::updateArgs(drogon::orm::internal::SqlBinder &binder) const
             binder << nullptr;
         }
     }
-    if(dirtyFlag_[5])
+    if(dirtyFlag_[6])
     {
         if(getPaymentMethod())
         {
@@ -1522,7 +1614,7 @@ void OrderTable::updateArgs(drogon::orm::internal::SqlBinder &binder) const
             binder << nullptr;
         }
     }
-    if(dirtyFlag_[6])
+    if(dirtyFlag_[7])
     {
         if(getPaymentStatus())
         {
@@ -1533,7 +1625,7 @@ void OrderTable::updateArgs(drogon::orm::internal::SqlBinder &binder) const
             binder << nullptr;
         }
     }
-    if(dirtyFlag_[7])
+    if(dirtyFlag_[8])
     {
         if(getOrderStatus())
         {
@@ -1544,7 +1636,7 @@ void OrderTable::updateArgs(drogon::orm::internal::SqlBinder &binder) const
             binder << nullptr;
         }
     }
-    if(dirtyFlag_[8])
+    if(dirtyFlag_[9])
     {
         if(getDeliveryAddress())
         {
@@ -1555,7 +1647,7 @@ void OrderTable::updateArgs(drogon::orm::internal::SqlBinder &binder) const
             binder << nullptr;
         }
     }
-    if(dirtyFlag_[9])
+    if(dirtyFlag_[10])
     {
         if(getOrderDetail())
         {
@@ -1566,7 +1658,7 @@ void OrderTable::updateArgs(drogon::orm::internal::SqlBinder &binder) const
             binder << nullptr;
         }
     }
-    if(dirtyFlag_[10])
+    if(dirtyFlag_[11])
     {
         if(getRemark())
         {
@@ -1577,7 +1669,7 @@ void OrderTable::updateArgs(drogon::orm::internal::SqlBinder &binder) const
             binder << nullptr;
         }
     }
-    if(dirtyFlag_[11])
+    if(dirtyFlag_[12])
     {
         if(getCreatedAt())
         {
@@ -1588,7 +1680,7 @@ void OrderTable::updateArgs(drogon::orm::internal::SqlBinder &binder) const
             binder << nullptr;
         }
     }
-    if(dirtyFlag_[12])
+    if(dirtyFlag_[13])
     {
         if(getUpdatedAt())
         {
@@ -1599,7 +1691,7 @@ void OrderTable::updateArgs(drogon::orm::internal::SqlBinder &binder) const
             binder << nullptr;
         }
     }
-    if(dirtyFlag_[13])
+    if(dirtyFlag_[14])
     {
         if(getIsDeleted())
         {
@@ -1638,6 +1730,14 @@ Json::Value OrderTable::toJson() const
     {
         ret["user_id"]=Json::Value();
     }
+    if(getBranchId())
+    {
+        ret["branch_id"]=getValueOfBranchId();
+    }
+    else
+    {
+        ret["branch_id"]=Json::Value();
+    }
     if(getTotalAmount())
     {
         ret["total_amount"]=getValueOfTotalAmount();
@@ -1733,7 +1833,7 @@ Json::Value OrderTable::toMasqueradedJson(
     const std::vector<std::string> &pMasqueradingVector) const
 {
     Json::Value ret;
-    if(pMasqueradingVector.size() == 14)
+    if(pMasqueradingVector.size() == 15)
     {
         if(!pMasqueradingVector[0].empty())
         {
@@ -1770,9 +1870,9 @@ Json::Value OrderTable::toMasqueradedJson(
         }
         if(!pMasqueradingVector[3].empty())
         {
-            if(getTotalAmount())
+            if(getBranchId())
             {
-                ret[pMasqueradingVector[3]]=getValueOfTotalAmount();
+                ret[pMasqueradingVector[3]]=getValueOfBranchId();
             }
             else
             {
@@ -1781,9 +1881,9 @@ Json::Value OrderTable::toMasqueradedJson(
         }
         if(!pMasqueradingVector[4].empty())
         {
-            if(getDiscountAmmout())
+            if(getTotalAmount())
             {
-                ret[pMasqueradingVector[4]]=getValueOfDiscountAmmout();
+                ret[pMasqueradingVector[4]]=getValueOfTotalAmount();
             }
             else
             {
@@ -1792,9 +1892,9 @@ Json::Value OrderTable::toMasqueradedJson(
         }
         if(!pMasqueradingVector[5].empty())
         {
-            if(getPaymentMethod())
+            if(getDiscountAmmout())
             {
-                ret[pMasqueradingVector[5]]=getValueOfPaymentMethod();
+                ret[pMasqueradingVector[5]]=getValueOfDiscountAmmout();
             }
             else
             {
@@ -1803,9 +1903,9 @@ Json::Value OrderTable::toMasqueradedJson(
         }
         if(!pMasqueradingVector[6].empty())
         {
-            if(getPaymentStatus())
+            if(getPaymentMethod())
             {
-                ret[pMasqueradingVector[6]]=getValueOfPaymentStatus();
+                ret[pMasqueradingVector[6]]=getValueOfPaymentMethod();
             }
             else
             {
@@ -1814,9 +1914,9 @@ Json::Value OrderTable::toMasqueradedJson(
         }
         if(!pMasqueradingVector[7].empty())
         {
-            if(getOrderStatus())
+            if(getPaymentStatus())
             {
-                ret[pMasqueradingVector[7]]=getValueOfOrderStatus();
+                ret[pMasqueradingVector[7]]=getValueOfPaymentStatus();
             }
             else
             {
@@ -1825,9 +1925,9 @@ Json::Value OrderTable::toMasqueradedJson(
         }
         if(!pMasqueradingVector[8].empty())
         {
-            if(getDeliveryAddress())
+            if(getOrderStatus())
             {
-                ret[pMasqueradingVector[8]]=getValueOfDeliveryAddress();
+                ret[pMasqueradingVector[8]]=getValueOfOrderStatus();
             }
             else
             {
@@ -1836,9 +1936,9 @@ Json::Value OrderTable::toMasqueradedJson(
         }
         if(!pMasqueradingVector[9].empty())
         {
-            if(getOrderDetail())
+            if(getDeliveryAddress())
             {
-                ret[pMasqueradingVector[9]]=getValueOfOrderDetail();
+                ret[pMasqueradingVector[9]]=getValueOfDeliveryAddress();
             }
             else
             {
@@ -1847,9 +1947,9 @@ Json::Value OrderTable::toMasqueradedJson(
         }
         if(!pMasqueradingVector[10].empty())
         {
-            if(getRemark())
+            if(getOrderDetail())
             {
-                ret[pMasqueradingVector[10]]=getValueOfRemark();
+                ret[pMasqueradingVector[10]]=getValueOfOrderDetail();
             }
             else
             {
@@ -1858,9 +1958,9 @@ Json::Value OrderTable::toMasqueradedJson(
         }
         if(!pMasqueradingVector[11].empty())
         {
-            if(getCreatedAt())
+            if(getRemark())
             {
-                ret[pMasqueradingVector[11]]=getCreatedAt()->toDbStringLocal();
+                ret[pMasqueradingVector[11]]=getValueOfRemark();
             }
             else
             {
@@ -1869,9 +1969,9 @@ Json::Value OrderTable::toMasqueradedJson(
         }
         if(!pMasqueradingVector[12].empty())
         {
-            if(getUpdatedAt())
+            if(getCreatedAt())
             {
-                ret[pMasqueradingVector[12]]=getUpdatedAt()->toDbStringLocal();
+                ret[pMasqueradingVector[12]]=getCreatedAt()->toDbStringLocal();
             }
             else
             {
@@ -1880,15 +1980,26 @@ Json::Value OrderTable::toMasqueradedJson(
         }
         if(!pMasqueradingVector[13].empty())
         {
-            if(getIsDeleted())
+            if(getUpdatedAt())
             {
-                ret[pMasqueradingVector[13]]=getValueOfIsDeleted();
+                ret[pMasqueradingVector[13]]=getUpdatedAt()->toDbStringLocal();
             }
             else
             {
                 ret[pMasqueradingVector[13]]=Json::Value();
             }
         }
+        if(!pMasqueradingVector[14].empty())
+        {
+            if(getIsDeleted())
+            {
+                ret[pMasqueradingVector[14]]=getValueOfIsDeleted();
+            }
+            else
+            {
+                ret[pMasqueradingVector[14]]=Json::Value();
+            }
+        }
         return ret;
     }
     LOG_ERROR << "Masquerade failed";
@@ -1916,6 +2027,14 @@ Json::Value OrderTable::toMasqueradedJson(
     {
         ret["user_id"]=Json::Value();
     }
+    if(getBranchId())
+    {
+        ret["branch_id"]=getValueOfBranchId();
+    }
+    else
+    {
+        ret["branch_id"]=Json::Value();
+    }
     if(getTotalAmount())
     {
         ret["total_amount"]=getValueOfTotalAmount();
@@ -2024,59 +2143,64 @@ bool OrderTable::validateJsonForCreation(const Json::Value &pJson, std::string &
         if(!validJsonOfField(2, "user_id", pJson["user_id"], err, true))
             return false;
     }
+    if(pJson.isMember("branch_id"))
+    {
+        if(!validJsonOfField(3, "branch_id", pJson["branch_id"], err, true))
+            return false;
+    }
     if(pJson.isMember("total_amount"))
     {
-        if(!validJsonOfField(3, "total_amount", pJson["total_amount"], err, true))
+        if(!validJsonOfField(4, "total_amount", pJson["total_amount"], err, true))
             return false;
     }
     if(pJson.isMember("discount_ammout"))
     {
-        if(!validJsonOfField(4, "discount_ammout", pJson["discount_ammout"], err, true))
+        if(!validJsonOfField(5, "discount_ammout", pJson["discount_ammout"], err, true))
             return false;
     }
     if(pJson.isMember("payment_method"))
     {
-        if(!validJsonOfField(5, "payment_method", pJson["payment_method"], err, true))
+        if(!validJsonOfField(6, "payment_method", pJson["payment_method"], err, true))
             return false;
     }
     if(pJson.isMember("payment_status"))
     {
-        if(!validJsonOfField(6, "payment_status", pJson["payment_status"], err, true))
+        if(!validJsonOfField(7, "payment_status", pJson["payment_status"], err, true))
             return false;
     }
     if(pJson.isMember("order_status"))
     {
-        if(!validJsonOfField(7, "order_status", pJson["order_status"], err, true))
+        if(!validJsonOfField(8, "order_status", pJson["order_status"], err, true))
             return false;
     }
     if(pJson.isMember("delivery_address"))
     {
-        if(!validJsonOfField(8, "delivery_address", pJson["delivery_address"], err, true))
+        if(!validJsonOfField(9, "delivery_address", pJson["delivery_address"], err, true))
             return false;
     }
     if(pJson.isMember("order_detail"))
     {
-        if(!validJsonOfField(9, "order_detail", pJson["order_detail"], err, true))
+        if(!validJsonOfField(10, "order_detail", pJson["order_detail"], err, true))
             return false;
     }
     if(pJson.isMember("remark"))
     {
-        if(!validJsonOfField(10, "remark", pJson["remark"], err, true))
+        if(!validJsonOfField(11, "remark", pJson["remark"], err, true))
             return false;
     }
     if(pJson.isMember("created_at"))
     {
-        if(!validJsonOfField(11, "created_at", pJson["created_at"], err, true))
+        if(!validJsonOfField(12, "created_at", pJson["created_at"], err, true))
             return false;
     }
     if(pJson.isMember("updated_at"))
     {
-        if(!validJsonOfField(12, "updated_at", pJson["updated_at"], err, true))
+        if(!validJsonOfField(13, "updated_at", pJson["updated_at"], err, true))
             return false;
     }
     if(pJson.isMember("is_deleted"))
     {
-        if(!validJsonOfField(13, "is_deleted", pJson["is_deleted"], err, true))
+        if(!validJsonOfField(14, "is_deleted", pJson["is_deleted"], err, true))
             return false;
     }
     return true;
@@ -2085,7 +2209,7 @@ bool OrderTable::validateMasqueradedJsonForCreation(const Json::Value &pJson,
                                                     const std::vector<std::string> &pMasqueradingVector,
                                                     std::string &err)
 {
-    if(pMasqueradingVector.size() != 14)
+    if(pMasqueradingVector.size() != 15)
     {
         err = "Bad masquerading vector";
         return false;
@@ -2203,6 +2327,14 @@ bool OrderTable::validateMasqueradedJsonForCreation(const Json::Value &pJson,
                   return false;
           }
       }
+      if(!pMasqueradingVector[14].empty())
+      {
+          if(pJson.isMember(pMasqueradingVector[14]))
+          {
+              if(!validJsonOfField(14, pMasqueradingVector[14], pJson[pMasqueradingVector[14]], err, true))
+                  return false;
+          }
+      }
     }
     catch(const Json::LogicError &e)
     {
@@ -2233,59 +2365,64 @@ bool OrderTable::validateJsonForUpdate(const Json::Value &pJson, std::string &er
         if(!validJsonOfField(2, "user_id", pJson["user_id"], err, false))
             return false;
     }
+    if(pJson.isMember("branch_id"))
+    {
+        if(!validJsonOfField(3, "branch_id", pJson["branch_id"], err, false))
+            return false;
+    }
     if(pJson.isMember("total_amount"))
     {
-        if(!validJsonOfField(3, "total_amount", pJson["total_amount"], err, false))
+        if(!validJsonOfField(4, "total_amount", pJson["total_amount"], err, false))
             return false;
     }
     if(pJson.isMember("discount_ammout"))
     {
-        if(!validJsonOfField(4, "discount_ammout", pJson["discount_ammout"], err, false))
+        if(!validJsonOfField(5, "discount_ammout", pJson["discount_ammout"], err, false))
             return false;
     }
     if(pJson.isMember("payment_method"))
     {
-        if(!validJsonOfField(5, "payment_method", pJson["payment_method"], err, false))
+        if(!validJsonOfField(6, "payment_method", pJson["payment_method"], err, false))
             return false;
     }
     if(pJson.isMember("payment_status"))
     {
-        if(!validJsonOfField(6, "payment_status", pJson["payment_status"], err, false))
+        if(!validJsonOfField(7, "payment_status", pJson["payment_status"], err, false))
             return false;
     }
     if(pJson.isMember("order_status"))
     {
-        if(!validJsonOfField(7, "order_status", pJson["order_status"], err, false))
+        if(!validJsonOfField(8, "order_status", pJson["order_status"], err, false))
             return false;
     }
     if(pJson.isMember("delivery_address"))
     {
-        if(!validJsonOfField(8, "delivery_address", pJson["delivery_address"], err, false))
+        if(!validJsonOfField(9, "delivery_address", pJson["delivery_address"], err, false))
             return false;
     }
     if(pJson.isMember("order_detail"))
     {
-        if(!validJsonOfField(9, "order_detail", pJson["order_detail"], err, false))
+        if(!validJsonOfField(10, "order_detail", pJson["order_detail"], err, false))
             return false;
     }
     if(pJson.isMember("remark"))
     {
-        if(!validJsonOfField(10, "remark", pJson["remark"], err, false))
+        if(!validJsonOfField(11, "remark", pJson["remark"], err, false))
             return false;
     }
     if(pJson.isMember("created_at"))
     {
-        if(!validJsonOfField(11, "created_at", pJson["created_at"], err, false))
+        if(!validJsonOfField(12, "created_at", pJson["created_at"], err, false))
             return false;
     }
     if(pJson.isMember("updated_at"))
     {
-        if(!validJsonOfField(12, "updated_at", pJson["updated_at"], err, false))
+        if(!validJsonOfField(13, "updated_at", pJson["updated_at"], err, false))
             return false;
     }
     if(pJson.isMember("is_deleted"))
     {
-        if(!validJsonOfField(13, "is_deleted", pJson["is_deleted"], err, false))
+        if(!validJsonOfField(14, "is_deleted", pJson["is_deleted"], err, false))
             return false;
     }
     return true;
@@ -2294,7 +2431,7 @@ bool OrderTable::validateMasqueradedJsonForUpdate(const Json::Value &pJson,
                                                   const std::vector<std::string> &pMasqueradingVector,
                                                   std::string &err)
 {
-    if(pMasqueradingVector.size() != 14)
+    if(pMasqueradingVector.size() != 15)
     {
         err = "Bad masquerading vector";
         return false;
@@ -2375,6 +2512,11 @@ bool OrderTable::validateMasqueradedJsonForUpdate(const Json::Value &pJson,
           if(!validJsonOfField(13, pMasqueradingVector[13], pJson[pMasqueradingVector[13]], err, false))
               return false;
       }
+      if(!pMasqueradingVector[14].empty() && pJson.isMember(pMasqueradingVector[14]))
+      {
+          if(!validJsonOfField(14, pMasqueradingVector[14], pJson[pMasqueradingVector[14]], err, false))
+              return false;
+      }
     }
     catch(const Json::LogicError &e)
     {
@@ -2435,19 +2577,11 @@ bool OrderTable::validJsonOfField(size_t index,
             {
                 return true;
             }
-            if(!pJson.isString())
+            if(!pJson.isUInt())
             {
                 err="Type error in the "+fieldName+" field";
                 return false;
             }
-            if(pJson.isString() && std::strlen(pJson.asCString()) > 255)
-            {
-                err="String length exceeds limit for the " +
-                    fieldName +
-                    " field (the maximum value is 255)";
-                return false;
-            }
-
             break;
         case 4:
             if(pJson.isNull())
@@ -2459,16 +2593,19 @@ bool OrderTable::validJsonOfField(size_t index,
                 err="Type error in the "+fieldName+" field";
                 return false;
             }
-            if(pJson.isString() && std::strlen(pJson.asCString()) > 255)
+            break;
+        case 5:
+            if(pJson.isNull())
             {
-                err="String length exceeds limit for the " +
-                    fieldName +
-                    " field (the maximum value is 255)";
+                return true;
+            }
+            if(!pJson.isString())
+            {
+                err="Type error in the "+fieldName+" field";
                 return false;
             }
-
             break;
-        case 5:
+        case 6:
             if(pJson.isNull())
             {
                 return true;
@@ -2487,7 +2624,7 @@ bool OrderTable::validJsonOfField(size_t index,
             }
 
             break;
-        case 6:
+        case 7:
             if(pJson.isNull())
             {
                 return true;
@@ -2506,7 +2643,7 @@ bool OrderTable::validJsonOfField(size_t index,
             }
 
             break;
-        case 7:
+        case 8:
             if(pJson.isNull())
             {
                 return true;
@@ -2525,7 +2662,7 @@ bool OrderTable::validJsonOfField(size_t index,
             }
 
             break;
-        case 8:
+        case 9:
             if(pJson.isNull())
             {
                 return true;
@@ -2544,7 +2681,7 @@ bool OrderTable::validJsonOfField(size_t index,
             }
 
             break;
-        case 9:
+        case 10:
             if(pJson.isNull())
             {
                 return true;
@@ -2555,7 +2692,7 @@ bool OrderTable::validJsonOfField(size_t index,
                 return false;
             }
             break;
-        case 10:
+        case 11:
             if(pJson.isNull())
             {
                 return true;
@@ -2566,7 +2703,7 @@ bool OrderTable::validJsonOfField(size_t index,
                 return false;
             }
             break;
-        case 11:
+        case 12:
             if(pJson.isNull())
             {
                 return true;
@@ -2577,7 +2714,7 @@ bool OrderTable::validJsonOfField(size_t index,
                 return false;
             }
             break;
-        case 12:
+        case 13:
             if(pJson.isNull())
             {
                 return true;
@@ -2588,7 +2725,7 @@ bool OrderTable::validJsonOfField(size_t index,
                 return false;
             }
             break;
-        case 13:
+        case 14:
             if(pJson.isNull())
             {
                 return true;
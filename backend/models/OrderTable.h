@@ -49,6 +49,7 @@ class OrderTable
         static const std::string _order_id;
         static const std::string _tenant_id;
         static const std::string _user_id;
+        static const std::string _branch_id;
         static const std::string _total_amount;
         static const std::string _discount_ammout;
         static const std::string _payment_method;
@@ -137,6 +138,15 @@ class OrderTable
     void setUserId(const uint32_t &pUserId) noexcept;
     void setUserIdToNull() noexcept;
 
+    /**  For column branch_id  */
+    ///Get the value of the column branch_id, returns the default value if the column is null
+    const uint32_t &getValueOfBranchId() const noexcept;
+    ///Return a shared_ptr object pointing to the column const value, or an empty shared_ptr object if the column is null
+    const std::shared_ptr<uint32_t> &getBranchId() const noexcept;
+    ///Set the value of the column branch_id
+    void setBranchId(const uint32_t &pBranchId) noexcept;
+    void setBranchIdToNull() noexcept;
+
     /**  For column total_amount  */
     ///Get the value of the column total_amount, returns the default value if the column is null
     const std::string &getValueOfTotalAmount() const noexcept;
@@ -245,7 +255,7 @@ class OrderTable
     void setIsDeletedToNull() noexcept;
 
 
-    static size_t getColumnNumber() noexcept {  return 14;  }
+    static size_t getColumnNumber() noexcept {  return 15;  }
     static const std::string &getColumnName(size_t index) noexcept(false);
 
     Json::Value toJson() const;
@@ -277,6 +287,7 @@ class OrderTable
     std::shared_ptr<uint32_t> orderId_;
     std::shared_ptr<uint32_t> tenantId_;
     std::shared_ptr<uint32_t> userId_;
+    std::shared_ptr<uint32_t> branchId_;
     std::shared_ptr<std::string> totalAmount_;
     std::shared_ptr<std::string> discountAmmout_;
     std::shared_ptr<std::string> paymentMethod_;
@@ -299,7 +310,7 @@ class OrderTable
         const bool notNull_;
     };
     static const std::vector<MetaData> metaData_;
-    bool dirtyFlag_[14]={ false };
+    bool dirtyFlag_[15]={ false };
   public:
     static const std::string &sqlForFindingByPrimaryKey()
     {
@@ -331,57 +342,62 @@ class OrderTable
         }
         if(dirtyFlag_[3])
         {
-            sql += "total_amount,";
+            sql += "branch_id,";
             ++parametersCount;
         }
         if(dirtyFlag_[4])
         {
-            sql += "discount_ammout,";
+            sql += "total_amount,";
             ++parametersCount;
         }
         if(dirtyFlag_[5])
         {
-            sql += "payment_method,";
+            sql += "discount_ammout,";
             ++parametersCount;
         }
         if(dirtyFlag_[6])
         {
-            sql += "payment_status,";
+            sql += "payment_method,";
             ++parametersCount;
         }
         if(dirtyFlag_[7])
         {
-            sql += "order_status,";
+            sql += "payment_status,";
             ++parametersCount;
         }
         if(dirtyFlag_[8])
         {
-            sql += "delivery_address,";
+            sql += "order_status,";
             ++parametersCount;
         }
         if(dirtyFlag_[9])
         {
-            sql += "order_detail,";
+            sql += "delivery_address,";
             ++parametersCount;
         }
         if(dirtyFlag_[10])
+        {
+            sql += "order_detail,";
+            ++parametersCount;
+        }
+        if(dirtyFlag_[11])
         {
             sql += "remark,";
             ++parametersCount;
         }
         sql += "created_at,";
         ++parametersCount;
-        if(!dirtyFlag_[11])
+        if(!dirtyFlag_[12])
         {
             needSelection=true;
         }
         sql += "updated_at,";
         ++parametersCount;
-        if(!dirtyFlag_[12])
+        if(!dirtyFlag_[13])
         {
             needSelection=true;
         }
-        if(dirtyFlag_[13])
+        if(dirtyFlag_[14])
         {
             sql += "is_deleted,";
             ++parametersCount;
@@ -450,12 +466,17 @@ class OrderTable
         {
             sql.append("?,");
 
+        }
+        if(dirtyFlag_[12])
+        {
+            sql.append("?,");
+
         }
         else
         {
             sql +="default,";
         }
-        if(dirtyFlag_[12])
+        if(dirtyFlag_[13])
         {
             sql.append("?,");
 
@@ -464,7 +485,7 @@ class OrderTable
         {
             sql +="default,";
         }
-        if(dirtyFlag_[13])
+        if(dirtyFlag_[14])
         {
             sql.append("?,");
 
@@ -0,0 +1,258 @@
+/**
+ *
+ *  BranchMenus.cc
+ *
+ */
+
+#include "BranchMenus.h"
+#include "Branch.h"
+#include "MenuSnapshots.h"
+#include <drogon/drogon.h>
+
+using namespace drogon;
+using namespace drogon::orm;
+using namespace drogon_model::saas_restaurant;
+
+namespace
+{
+// branch_dish 的一行，NULL 列表示沿用总店
+BranchOverlay::Override overrideOf(const Row &row)
+{
+    BranchOverlay::Override delta;
+    delta.dishId = row["dish_id"].as<uint32_t>();
+    if (!row["dish_price"].isNull())
+        delta.price = Money::fromString(row["dish_price"].as<std::string>());
+    if (!row["status"].isNull())
+        delta.status = row["status"].as<std::string>();
+    if (!row["stock"].isNull())
+        delta.stock = row["stock"].as<uint32_t>();
+    return delta;
+}
+} // namespace
+
+void BranchMenus::initAndStart(const Json::Value &config)
+{
+    dbClient_ = app().getDbClient(config.get("db_client", "default").asString());
+    load();
+}
+
+void BranchMenus::shutdown()
+{
+}
+
+void BranchMenus::load()
+{
+    try
+    {
+        auto branches = dbClient_->execSqlSync(
+            "select branch_id, tenant_id from branch "
+            "where tenant_id is not null and (is_deleted = 0 or is_deleted is null)");
+        auto rows = dbClient_->execSqlSync("select branch_id, dish_id, dish_price, status, stock from branch_dish");
+        std::unordered_map<uint32_t, std::vector<BranchOverlay::Override>> overrides;
+        for (const auto &row : rows)
+            overrides[row["branch_id"].as<uint32_t>()].push_back(overrideOf(row));
+
+        auto next = std::make_shared<Branches>();
+        for (const auto &row : branches)
+        {
+            auto branchId = row["branch_id"].as<uint32_t>();
+            (*next)[branchId] = std::make_shared<BranchOverlay>(branchId,
+                                                                row["tenant_id"].as<uint32_t>(),
+                                                                std::move(overrides[branchId]));
+        }
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        branches_.publish(std::move(next));
+        LOG_INFO << "Branch menus loaded " << branches.size() << " branches, " << rows.size() << " overrides";
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to load branch menus: " << e.base().what();
+    }
+}
+
+void BranchMenus::publish(uint32_t branchId,
+                          const std::function<std::shared_ptr<const BranchOverlay>(const BranchOverlay *current)> &update)
+{
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    auto current = branches_.load();
+    auto next = current ? std::make_shared<Branches>(*current) : std::make_shared<Branches>();
+    auto it = next->find(branchId);
+    auto overlay = update(it == next->end() ? nullptr : it->second.get());
+    if (overlay)
+        (*next)[branchId] = std::move(overlay);
+    else
+        next->erase(branchId);
+    branches_.publish(std::move(next));
+}
+
+void BranchMenus::branchChanged(uint32_t branchId)
+{
+    auto remove = [this, branchId]()
+    { publish(branchId, [](const BranchOverlay *) { return std::shared_ptr<const BranchOverlay>(); }); };
+    Mapper<Branch>(dbClient_).findByPrimaryKey(
+        branchId,
+        [this, branchId, remove](const Branch &branch)
+        {
+            if (branch.getValueOfIsDeleted() == 1 || !branch.getTenantId())
+            {
+                remove();
+                return;
+            }
+            // 连同覆盖一起重读，分店换租户时不残留旧数据
+            auto tenantId = branch.getValueOfTenantId();
+            dbClient_->execSqlAsync(
+                "select b.dish_id, b.dish_price, b.status, b.stock from branch_dish b "
+                "join dish d on d.dish_id = b.dish_id and d.tenant_id = ? where b.branch_id = ?",
+                [this, branchId, tenantId](const Result &rows)
+                {
+                    std::vector<BranchOverlay::Override> overrides;
+                    for (const auto &row : rows)
+                        overrides.push_back(overrideOf(row));
+                    auto overlay = std::make_shared<const BranchOverlay>(branchId, tenantId, std::move(overrides));
+                    publish(branchId, [&overlay](const BranchOverlay *) { return overlay; });
+                },
+                [branchId](const DrogonDbException &e)
+                {
+                    LOG_ERROR << "Failed to load overrides of branch " << branchId << ": " << e.base().what();
+                },
+                tenantId,
+                branchId);
+        },
+        [branchId, remove](const DrogonDbException &e)
+        {
+            if (!dynamic_cast<const UnexpectedRows *>(&e.base()))
+            {
+                LOG_ERROR << "Failed to refresh branch " << branchId << " for menus: " << e.base().what();
+                return;
+            }
+            remove();
+        });
+}
+
+void BranchMenus::saveOverride(uint32_t branchId,
+                               BranchOverlay::Override delta,
+                               std::function<void(bool found)> &&callback,
+                               std::function<void(const std::string &message)> &&errorCallback)
+{
+    // 分店和菜品须属于同一租户且未删除，NULL 列沿用总店
+    auto dishId = delta.dishId;
+    auto price = delta.price ? delta.price->toString() : std::string();
+    auto status = delta.status ? *delta.status : std::string();
+    auto stock = delta.stock ? std::to_string(*delta.stock) : std::string();
+    dbClient_->execSqlAsync(
+        "insert into branch_dish (branch_id, dish_id, tenant_id, dish_price, status, stock) "
+        "select b.branch_id, d.dish_id, b.tenant_id, nullif(?, ''), nullif(?, ''), nullif(?, '') "
+        "from branch b join dish d on d.tenant_id = b.tenant_id "
+        "where b.branch_id = ? and d.dish_id = ? "
+        "and (b.is_deleted = 0 or b.is_deleted is null) and (d.is_deleted = 0 or d.is_deleted is null) "
+        "on duplicate key update dish_price = values(dish_price), status = values(status), stock = values(stock)",
+        [this, branchId, delta = std::move(delta), callback](const Result &result)
+        {
+            if (result.affectedRows() == 0)
+            {
+                // 值没变时 MySQL 也报 0 行，已有这条覆盖说明分店和菜品都在
+                bool found = false;
+                if (auto branches = branches_.load())
+                {
+                    auto it = branches->find(branchId);
+                    found = it != branches->end() && it->second->find(delta.dishId);
+                }
+                callback(found);
+                return;
+            }
+            bool known = false;
+            publish(branchId,
+                    [&](const BranchOverlay *current) -> std::shared_ptr<const BranchOverlay>
+                    {
+                        if (!current)
+                            return nullptr;
+                        known = true;
+                        return current->with(delta);
+                    });
+            // 内存中还没有这个分店时整店重读
+            if (!known)
+                branchChanged(branchId);
+            callback(true);
+        },
+        [errorCallback](const DrogonDbException &e)
+        {
+            LOG_ERROR << "Failed to save branch dish override: " << e.base().what();
+            errorCallback("database error");
+        },
+        price,
+        status,
+        stock,
+        branchId,
+        dishId);
+}
+
+void BranchMenus::removeOverride(uint32_t branchId,
+                                 uint32_t dishId,
+                                 std::function<void(bool found)> &&callback,
+                                 std::function<void(const std::string &message)> &&errorCallback)
+{
+    dbClient_->execSqlAsync(
+        "delete from branch_dish where branch_id = ? and dish_id = ?",
+        [this, branchId, dishId, callback](const Result &result)
+        {
+            publish(branchId,
+                    [dishId](const BranchOverlay *current) -> std::shared_ptr<const BranchOverlay>
+                    { return current ? current->without(dishId) : nullptr; });
+            callback(result.affectedRows() != 0);
+        },
+        [errorCallback](const DrogonDbException &e)
+        {
+            LOG_ERROR << "Failed to remove branch dish override: " << e.base().what();
+            errorCallback("database error");
+        },
+        branchId,
+        dishId);
+}
+
+std::shared_ptr<const BranchOverlay> BranchMenus::overlayOf(uint32_t branchId)
+{
+    thread_local SnapshotCell<Branches>::Reader reader;
+    auto branches = reader.get(branches_);
+    if (!branches)
+        return nullptr;
+    auto it = branches->find(branchId);
+    return it == branches->end() ? nullptr : it->second;
+}
+
+bool BranchMenus::dishesOf(uint32_t branchId, Json::Value &dishes)
+{
+    thread_local SnapshotCell<Branches>::Reader reader;
+    auto branches = reader.get(branches_);
+    if (!branches)
+        return false;
+    auto it = branches->find(branchId);
+    if (it == branches->end())
+        return false;
+    const auto &overlay = *it->second;
+    dishes = Json::Value(Json::arrayValue);
+    app().getPlugin<MenuSnapshots>()->readMenu(
+        overlay.tenantId(),
+        [&overlay, &dishes](const MenuSnapshot &menu)
+        {
+            for (const auto &dish : menu.dishes())
+            {
+                auto effective = overlay.resolve(dish);
+                Json::Value item;
+                item["dish_id"] = dish.dishId;
+                item["tenant_id"] = overlay.tenantId();
+                item["branch_id"] = overlay.branchId();
+                item["dish_category_id"] = dish.categoryId;
+                item["dish_name"] = dish.name;
+                item["dish_price"] = effective.price.toJson();
+                item["description"] = dish.description;
+                item["status"] = *effective.status;
+                item["stock"] = effective.stock;
+                item["cover_img"] = dish.coverImg;
+                item["sort_order"] = dish.sortOrder;
+                item["sales"] = dish.sales;
+                item["overridden"] = effective.delta != nullptr;
+                dishes.append(item);
+            }
+        });
+    return true;
+}
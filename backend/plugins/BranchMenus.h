@@ -0,0 +1,68 @@
+/**
+ *
+ *  BranchMenus.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/orm/DbClient.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "BranchOverlay.h"
+#include "SnapshotCell.h"
+
+/**
+ * @brief 分店菜单：租户菜单快照叠加 branch_dish 表中的分店覆盖。
+ *
+ * 每个未删除的分店一个 BranchOverlay，覆盖的增删改先写库，成功后复制出新版本，
+ * 再复制分店目录整体发布，读者与 MenuSnapshots 一样不加锁。分店增删改按主键重读分店。
+ */
+class BranchMenus : public drogon::Plugin<BranchMenus>
+{
+public:
+  BranchMenus() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  void branchChanged(uint32_t branchId);
+
+  /// 写入一条覆盖，分店或菜品不存在、不属于同一租户时 found 为 false
+  void saveOverride(uint32_t branchId,
+                    BranchOverlay::Override delta,
+                    std::function<void(bool found)> &&callback,
+                    std::function<void(const std::string &message)> &&errorCallback);
+  /// 删除一条覆盖，恢复为总店设置
+  void removeOverride(uint32_t branchId,
+                      uint32_t dishId,
+                      std::function<void(bool found)> &&callback,
+                      std::function<void(const std::string &message)> &&errorCallback);
+
+  /// 分店的全部菜品（含下架的）按菜单顺序输出生效值，分店不存在时返回 false
+  bool dishesOf(uint32_t branchId, Json::Value &dishes);
+  /// 分店当前的覆盖，分店不存在时为空
+  std::shared_ptr<const BranchOverlay> overlayOf(uint32_t branchId);
+
+private:
+  using Branches = std::unordered_map<uint32_t, std::shared_ptr<const BranchOverlay>>;
+
+  void load();
+  /// 在当前目录上修改一个分店后发布，update 返回空指针表示移除该分店
+  void publish(uint32_t branchId,
+               const std::function<std::shared_ptr<const BranchOverlay>(const BranchOverlay *current)> &update);
+
+  drogon::orm::DbClientPtr dbClient_;
+  std::mutex writeMutex_;
+  SnapshotCell<Branches> branches_;
+};
@@ -0,0 +1,87 @@
+/**
+ *
+ *  BranchOverlay.cc
+ *
+ */
+
+#include "BranchOverlay.h"
+#include <algorithm>
+
+namespace
+{
+bool byDish(const BranchOverlay::Override &delta, uint32_t dishId)
+{
+    return delta.dishId < dishId;
+}
+} // namespace
+
+BranchOverlay::BranchOverlay(uint32_t branchId, uint32_t tenantId, std::vector<Override> overrides)
+    : branchId_(branchId), tenantId_(tenantId), overrides_(std::move(overrides))
+{
+    std::stable_sort(overrides_.begin(),
+                     overrides_.end(),
+                     [](const Override &a, const Override &b) { return a.dishId < b.dishId; });
+    // 相同菜品只留最后一条
+    size_t kept = 0;
+    for (size_t i = 0; i < overrides_.size(); ++i)
+    {
+        if (kept > 0 && overrides_[kept - 1].dishId == overrides_[i].dishId)
+        {
+            overrides_[kept - 1] = std::move(overrides_[i]);
+            continue;
+        }
+        if (kept != i)
+            overrides_[kept] = std::move(overrides_[i]);
+        ++kept;
+    }
+    overrides_.resize(kept);
+}
+
+std::shared_ptr<const BranchOverlay> BranchOverlay::with(Override delta) const
+{
+    auto next = std::make_shared<BranchOverlay>(*this);
+    auto &overrides = next->overrides_;
+    auto it = std::lower_bound(overrides.begin(), overrides.end(), delta.dishId, byDish);
+    if (it != overrides.end() && it->dishId == delta.dishId)
+        *it = std::move(delta);
+    else
+        overrides.insert(it, std::move(delta));
+    return next;
+}
+
+std::shared_ptr<const BranchOverlay> BranchOverlay::without(uint32_t dishId) const
+{
+    auto next = std::make_shared<BranchOverlay>(*this);
+    auto &overrides = next->overrides_;
+    auto it = std::lower_bound(overrides.begin(), overrides.end(), dishId, byDish);
+    if (it != overrides.end() && it->dishId == dishId)
+        overrides.erase(it);
+    return next;
+}
+
+const BranchOverlay::Override *BranchOverlay::find(uint32_t dishId) const
+{
+    auto it = std::lower_bound(overrides_.begin(), overrides_.end(), dishId, byDish);
+    return it != overrides_.end() && it->dishId == dishId ? &*it : nullptr;
+}
+
+BranchOverlay::Effective BranchOverlay::resolve(const MenuSnapshot::Dish &dish) const
+{
+    Effective effective;
+    effective.dish = &dish;
+    effective.price = dish.price;
+    effective.status = &dish.status;
+    effective.stock = dish.stock;
+    effective.delta = find(dish.dishId);
+    if (effective.delta)
+    {
+        const auto &delta = *effective.delta;
+        if (delta.price)
+            effective.price = *delta.price;
+        if (delta.status)
+            effective.status = &*delta.status;
+        if (delta.stock)
+            effective.stock = *delta.stock;
+    }
+    return effective;
+}
@@ -0,0 +1,65 @@
+/**
+ *
+ *  BranchOverlay.h
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "MenuSnapshot.h"
+
+/**
+ * @brief 单个分店对租户菜单的覆盖：售价、销售状态、库存，只存与总店不同的字段。
+ *
+ * 生效值 = 租户菜单快照中的菜品 + 本分店的覆盖，读取时逐个菜品合并，不复制总店菜单。
+ * 对象构造后只读，修改时复制出新版本（写时复制），覆盖通常只有几十条，复制代价很小；
+ * 读者持有旧版本期间不受影响。
+ */
+class BranchOverlay
+{
+public:
+  struct Override
+  {
+    uint32_t dishId{0};
+    std::optional<Money> price;
+    std::optional<std::string> status;
+    std::optional<uint32_t> stock;
+  };
+  /// 菜品在本分店的生效值，字段指向快照或覆盖，随二者的生命周期有效
+  struct Effective
+  {
+    const MenuSnapshot::Dish *dish{nullptr};
+    Money price;
+    const std::string *status{nullptr};
+    uint32_t stock{0};
+    const Override *delta{nullptr}; // 没有覆盖时为空
+  };
+
+  BranchOverlay(uint32_t branchId, uint32_t tenantId) : branchId_(branchId), tenantId_(tenantId) {}
+  /// 批量载入，同一菜品有多条时保留最后一条
+  BranchOverlay(uint32_t branchId, uint32_t tenantId, std::vector<Override> overrides);
+
+  /// 新增或替换一条覆盖，返回新版本
+  std::shared_ptr<const BranchOverlay> with(Override delta) const;
+  /// 删除一条覆盖，返回新版本
+  std::shared_ptr<const BranchOverlay> without(uint32_t dishId) const;
+
+  const Override *find(uint32_t dishId) const;
+  Effective resolve(const MenuSnapshot::Dish &dish) const;
+
+  uint32_t branchId() const { return branchId_; }
+  uint32_t tenantId() const { return tenantId_; }
+  /// 按菜品ID升序
+  const std::vector<Override> &overrides() const { return overrides_; }
+
+private:
+  uint32_t branchId_{0};
+  uint32_t tenantId_{0};
+  std::vector<Override> overrides_;
+};
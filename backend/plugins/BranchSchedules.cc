@@ -0,0 +1,200 @@
+/**
+ *
+ *  BranchSchedules.cc
+ *
+ */
+
+#include "BranchSchedules.h"
+#include "Branch.h"
+#include <drogon/drogon.h>
+#include <algorithm>
+#include <ctime>
+
+using namespace drogon;
+using namespace drogon::orm;
+using namespace drogon_model::saas_restaurant;
+
+void BranchSchedules::initAndStart(const Json::Value &config)
+{
+    dbClient_ = app().getDbClient(config.get("db_client", "default").asString());
+    horizonDays_ = config.get("horizon_days", 8).asInt();
+    load();
+}
+
+void BranchSchedules::shutdown()
+{
+}
+
+BranchSchedules::Schedule BranchSchedules::scheduleOf(uint32_t branchId,
+                                                      const std::string &branchName,
+                                                      const std::string &status,
+                                                      const std::string &openingHours)
+{
+    Schedule schedule;
+    schedule.branchId = branchId;
+    schedule.branchName = branchName;
+    schedule.operating = status.empty() || status == "营业中";
+    if (openingHours.find_first_not_of(" \t\r\n") == std::string::npos)
+        return schedule;
+    auto hours = std::make_shared<OpeningHours>();
+    std::string error;
+    if (OpeningHours::parse(openingHours, *hours, error))
+        schedule.hours = std::move(hours);
+    else
+        LOG_WARN << "Branch " << branchId << " has invalid opening hours: " << error;
+    return schedule;
+}
+
+void BranchSchedules::load()
+{
+    try
+    {
+        auto rows = dbClient_->execSqlSync(
+            "select branch_id, tenant_id, branch_name, status, opening_hours from branch "
+            "where tenant_id is not null and (is_deleted = 0 or is_deleted is null) order by branch_id");
+        std::unordered_map<uint32_t, std::shared_ptr<Schedules>> schedules;
+        std::unordered_map<uint32_t, uint32_t> branchTenant;
+        for (const auto &row : rows)
+        {
+            auto branchId = row["branch_id"].as<uint32_t>();
+            auto tenantId = row["tenant_id"].as<uint32_t>();
+            auto &list = schedules[tenantId];
+            if (!list)
+                list = std::make_shared<Schedules>();
+            list->push_back(scheduleOf(branchId,
+                                       row["branch_name"].isNull() ? "" : row["branch_name"].as<std::string>(),
+                                       row["status"].isNull() ? "" : row["status"].as<std::string>(),
+                                       row["opening_hours"].isNull() ? "" : row["opening_hours"].as<std::string>()));
+            branchTenant[branchId] = tenantId;
+        }
+        auto next = std::make_shared<Tenants>();
+        for (auto &[tenantId, list] : schedules)
+            (*next)[tenantId] = std::move(list);
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        branchTenant_ = std::move(branchTenant);
+        tenants_.publish(std::move(next));
+        LOG_INFO << "Branch schedules loaded " << rows.size() << " branches";
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to load branch schedules: " << e.base().what();
+    }
+}
+
+void BranchSchedules::publish(uint32_t branchId, uint32_t tenantId, Schedule schedule)
+{
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    auto current = tenants_.load();
+    auto next = current ? std::make_shared<Tenants>(*current) : std::make_shared<Tenants>();
+    auto byBranch = [](const Schedule &item, uint32_t id) { return item.branchId < id; };
+
+    // 只复制涉及的租户的列表
+    auto previous = branchTenant_.find(branchId);
+    if (previous != branchTenant_.end())
+    {
+        auto it = next->find(previous->second);
+        if (it != next->end())
+        {
+            auto list = std::make_shared<Schedules>(*it->second);
+            auto pos = std::lower_bound(list->begin(), list->end(), branchId, byBranch);
+            if (pos != list->end() && pos->branchId == branchId)
+                list->erase(pos);
+            if (list->empty())
+                next->erase(it);
+            else
+                it->second = std::move(list);
+        }
+        branchTenant_.erase(previous);
+    }
+    if (tenantId != 0)
+    {
+        auto &slot = (*next)[tenantId];
+        auto list = slot ? std::make_shared<Schedules>(*slot) : std::make_shared<Schedules>();
+        list->insert(std::lower_bound(list->begin(), list->end(), branchId, byBranch), std::move(schedule));
+        slot = std::move(list);
+        branchTenant_[branchId] = tenantId;
+    }
+    tenants_.publish(std::move(next));
+}
+
+void BranchSchedules::branchChanged(uint32_t branchId)
+{
+    Mapper<Branch>(dbClient_).findByPrimaryKey(
+        branchId,
+        [this, branchId](const Branch &branch)
+        {
+            if (branch.getValueOfIsDeleted() == 1 || !branch.getTenantId())
+            {
+                publish(branchId, 0, Schedule());
+                return;
+            }
+            publish(branchId,
+                    branch.getValueOfTenantId(),
+                    scheduleOf(branchId,
+                               branch.getValueOfBranchName(),
+                               branch.getValueOfStatus(),
+                               branch.getValueOfOpeningHours()));
+        },
+        [this, branchId](const DrogonDbException &e)
+        {
+            if (!dynamic_cast<const UnexpectedRows *>(&e.base()))
+            {
+                LOG_ERROR << "Failed to refresh schedule of branch " << branchId << ": " << e.base().what();
+                return;
+            }
+            publish(branchId, 0, Schedule());
+        });
+}
+
+Json::Value BranchSchedules::openAt(uint32_t tenantId, int64_t at)
+{
+    // 本地日期和当天分钟数只算一次，之后每个分店只查位图
+    time_t seconds = static_cast<time_t>(at);
+    struct tm local;
+    localtime_r(&seconds, &local);
+    auto day = OpeningHours::dayOf(local.tm_year + 1900,
+                                   static_cast<uint32_t>(local.tm_mon + 1),
+                                   static_cast<uint32_t>(local.tm_mday));
+    auto minute = static_cast<uint32_t>(local.tm_hour * 60 + local.tm_min);
+    auto minuteStart = at - local.tm_sec;
+
+    Json::Value data;
+    data["tenant_id"] = tenantId;
+    data["at"] = trantor::Date(at * 1000000).toDbStringLocal();
+    Json::Value branches(Json::arrayValue);
+    uint32_t openCount = 0;
+    thread_local SnapshotCell<Tenants>::Reader reader;
+    const Schedules *schedules = nullptr;
+    if (auto tenants = reader.get(tenants_))
+    {
+        auto it = tenants->find(tenantId);
+        if (it != tenants->end())
+            schedules = it->second.get();
+    }
+    if (schedules)
+    {
+        for (const auto &schedule : *schedules)
+        {
+            Json::Value item;
+            item["branch_id"] = schedule.branchId;
+            item["branch_name"] = schedule.branchName;
+            item["open"] = Json::Value::null;
+            item["next_change"] = Json::Value::null;
+            if (!schedule.operating)
+                item["open"] = false;
+            else if (schedule.hours)
+            {
+                bool open = schedule.hours->isOpen(day, minute);
+                openCount += open;
+                item["open"] = open;
+                auto minutes = schedule.hours->minutesUntilChange(day, minute, horizonDays_);
+                if (minutes >= 0)
+                    item["next_change"] = trantor::Date((minuteStart + minutes * 60) * 1000000).toDbStringLocal();
+            }
+            branches.append(std::move(item));
+        }
+    }
+    data["open_count"] = openCount;
+    data["branches"] = std::move(branches);
+    return data;
+}
@@ -0,0 +1,70 @@
+/**
+ *
+ *  BranchSchedules.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/orm/DbClient.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "OpeningHours.h"
+#include "SnapshotCell.h"
+
+/**
+ * @brief 分店营业时间：branch.opening_hours 载入时解析一次，按租户缓存编译好的周位图。
+ *
+ * 写入时由 RestfulBranchCtrl 校验格式，这里只处理已入库的文本；历史数据解析失败的记为未设置。
+ * 按租户的分店列表不可变，分店增删改时复制该租户的列表后整体发布，查询不加锁、不解析文本。
+ * 星期和日期按服务器本地时间计算，与报表一致。
+ */
+class BranchSchedules : public drogon::Plugin<BranchSchedules>
+{
+public:
+  BranchSchedules() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  void branchChanged(uint32_t branchId);
+
+  /// 租户全部分店在 at（秒）时刻是否营业：{tenant_id, at, open_count, branches: [...]}，
+  /// 分店的 open 为 null 表示未设置营业时间，next_change 为下一次开门或打烊的时刻
+  Json::Value openAt(uint32_t tenantId, int64_t at);
+
+private:
+  struct Schedule
+  {
+    uint32_t branchId{0};
+    std::string branchName;
+    bool operating{true};                       // status 为 营业中 或未填写
+    std::shared_ptr<const OpeningHours> hours; // 未设置或无法解析时为空
+  };
+  using Schedules = std::vector<Schedule>; // 按分店ID升序
+  using Tenants = std::unordered_map<uint32_t, std::shared_ptr<const Schedules>>;
+
+  void load();
+  static Schedule scheduleOf(uint32_t branchId,
+                             const std::string &branchName,
+                             const std::string &status,
+                             const std::string &openingHours);
+  /// 从原租户移除分店，tenantId 不为 0 时放入新租户，然后发布
+  void publish(uint32_t branchId, uint32_t tenantId, Schedule schedule);
+
+  drogon::orm::DbClientPtr dbClient_;
+  int32_t horizonDays_{8};
+  std::mutex writeMutex_;
+  std::unordered_map<uint32_t, uint32_t> branchTenant_; // 受 writeMutex_ 保护
+  SnapshotCell<Tenants> tenants_;
+};
@@ -0,0 +1,219 @@
+/**
+ *
+ *  BroadcastPump.cc
+ *
+ */
+
+#include "BroadcastPump.h"
+#include <json/json.h>
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <random>
+
+FileSender::FileSender(const std::string &path) : out_(path, std::ios::app)
+{
+}
+
+void FileSender::send(const std::vector<BroadcastDelivery> &batch, std::vector<Outcome> &outcomes)
+{
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    builder["emitUTF8"] = true;
+    std::string lines;
+    for (const auto &delivery : batch)
+    {
+        Json::Value line;
+        line["delivery_id"] = static_cast<Json::UInt64>(delivery.deliveryId);
+        line["broadcast_id"] = static_cast<Json::UInt64>(delivery.broadcastId);
+        line["member_id"] = delivery.memberId;
+        line["address"] = delivery.address;
+        line["content"] = delivery.content;
+        lines += Json::writeString(builder, line);
+        lines += '\n';
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    out_ << lines;
+    out_.flush();
+    outcomes.assign(batch.size(), out_ ? Outcome::Sent : Outcome::Retry);
+}
+
+TokenBucket::TokenBucket(double rate, double burst)
+    : rate_(std::max(rate, 0.001)), burst_(std::max(burst, 1.0)), tokens_(burst_), last_(Clock::now())
+{
+}
+
+void TokenBucket::refill(Clock::time_point now)
+{
+    if (now <= last_)
+        return;
+    tokens_ = std::min(burst_, tokens_ + std::chrono::duration<double>(now - last_).count() * rate_);
+    last_ = now;
+}
+
+size_t TokenBucket::take(size_t wanted, Clock::time_point now)
+{
+    refill(now);
+    auto taken = std::min(wanted, static_cast<size_t>(tokens_));
+    tokens_ -= static_cast<double>(taken);
+    return taken;
+}
+
+void TokenBucket::refund(size_t count)
+{
+    tokens_ = std::min(burst_, tokens_ + static_cast<double>(count));
+}
+
+TokenBucket::Clock::duration TokenBucket::untilAvailable(size_t count, Clock::time_point now)
+{
+    refill(now);
+    auto wanted = std::min(static_cast<double>(count), burst_);
+    if (tokens_ >= wanted)
+        return Clock::duration::zero();
+    return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>((wanted - tokens_) / rate_));
+}
+
+double RetryPolicy::delayAfter(uint32_t attempts, double jitter) const
+{
+    auto delay = std::min(maxDelay, baseDelay * std::pow(2.0, static_cast<double>(attempts > 0 ? attempts - 1 : 0)));
+    return delay * (0.5 + 0.5 * std::clamp(jitter, 0.0, 1.0));
+}
+
+BroadcastPump::BroadcastPump(std::shared_ptr<BroadcastSender> sender,
+                             TokenBucket bucket,
+                             RetryPolicy retry,
+                             size_t batchSize,
+                             double idleInterval,
+                             Fetch &&fetch,
+                             Commit &&commit)
+    : sender_(std::move(sender)),
+      bucket_(bucket),
+      retry_(retry),
+      batchSize_(std::clamp<size_t>(batchSize, 1, static_cast<size_t>(bucket.burst()))),
+      idleInterval_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(std::max(idleInterval, 0.01)))),
+      fetch_(std::move(fetch)),
+      commit_(std::move(commit))
+{
+}
+
+BroadcastPump::~BroadcastPump()
+{
+    stop();
+}
+
+void BroadcastPump::start()
+{
+    thread_ = std::thread([this]() { run(); });
+}
+
+void BroadcastPump::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_one();
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void BroadcastPump::wake()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        woken_ = true;
+    }
+    cv_.notify_one();
+}
+
+bool BroadcastPump::waitFor(std::chrono::steady_clock::duration duration)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait_for(lock, duration, [this]() { return stopping_ || woken_; });
+    woken_ = false;
+    return !stopping_;
+}
+
+void BroadcastPump::run()
+{
+    std::mt19937 rng(std::random_device{}());
+    std::uniform_real_distribution<double> jitter(0.0, 1.0);
+    std::vector<BroadcastSender::Outcome> outcomes;
+    std::vector<Result> results;
+    while (true)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_)
+                return;
+        }
+        // 攒够整批再发，减少网关请求次数
+        auto wait = bucket_.untilAvailable(batchSize_);
+        if (wait > std::chrono::steady_clock::duration::zero())
+        {
+            if (!waitFor(wait))
+                return;
+            continue;
+        }
+        auto allowance = bucket_.take(batchSize_);
+        auto now = static_cast<int64_t>(std::time(nullptr));
+        std::vector<BroadcastDelivery> batch;
+        try
+        {
+            batch = fetch_(allowance, now);
+        }
+        catch (const std::exception &)
+        {
+            // 存储暂不可用，空闲后再试
+        }
+        if (batch.size() < allowance)
+            bucket_.refund(allowance - batch.size());
+        if (batch.empty())
+        {
+            if (!waitFor(idleInterval_))
+                return;
+            continue;
+        }
+
+        outcomes.clear();
+        try
+        {
+            sender_->send(batch, outcomes);
+        }
+        catch (const std::exception &)
+        {
+            outcomes.clear();
+        }
+        outcomes.resize(batch.size(), BroadcastSender::Outcome::Retry);
+
+        results.clear();
+        for (size_t i = 0; i < batch.size(); ++i)
+        {
+            Result result;
+            result.deliveryId = batch[i].deliveryId;
+            result.broadcastId = batch[i].broadcastId;
+            result.attempts = batch[i].attempts + 1;
+            if (outcomes[i] == BroadcastSender::Outcome::Sent)
+                result.state = Result::Sent;
+            else if (outcomes[i] == BroadcastSender::Outcome::Rejected || result.attempts >= retry_.maxAttempts)
+                result.state = Result::Failed;
+            else
+            {
+                result.state = Result::Retry;
+                result.retryAt = now + static_cast<int64_t>(std::ceil(retry_.delayAfter(result.attempts, jitter(rng))));
+            }
+            results.push_back(result);
+        }
+        try
+        {
+            commit_(results);
+        }
+        catch (const std::exception &)
+        {
+            // 提交失败的消息保持待发送，之后会被重发
+            if (!waitFor(idleInterval_))
+                return;
+        }
+    }
+}
@@ -0,0 +1,158 @@
+/**
+ *
+ *  BroadcastPump.h
+ *
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// 一条待投递的消息
+struct BroadcastDelivery
+{
+  uint64_t deliveryId{0};
+  uint64_t broadcastId{0};
+  uint32_t memberId{0};
+  std::string address; // 手机号等，由渠道决定
+  std::string content;
+  uint32_t attempts{0}; // 已尝试次数
+};
+
+/**
+ * @brief 渠道发送接口，由投递线程同步调用。
+ */
+class BroadcastSender
+{
+public:
+  enum class Outcome
+  {
+    Sent,
+    Retry,   // 临时失败，退避后重试
+    Rejected // 永久失败，不再重试
+  };
+  virtual ~BroadcastSender() = default;
+  /// 整批发送，outcomes 与 batch 一一对应
+  virtual void send(const std::vector<BroadcastDelivery> &batch, std::vector<Outcome> &outcomes) = 0;
+};
+
+/**
+ * @brief 本地替身：把消息按 JSON 行追加到文件，离线联调和压测时代替短信、邮件网关。
+ */
+class FileSender : public BroadcastSender
+{
+public:
+  explicit FileSender(const std::string &path);
+  void send(const std::vector<BroadcastDelivery> &batch, std::vector<Outcome> &outcomes) override;
+
+private:
+  std::mutex mutex_;
+  std::ofstream out_;
+};
+
+/**
+ * @brief 令牌桶限速，rate 为每秒条数，burst 为桶容量。
+ */
+class TokenBucket
+{
+public:
+  using Clock = std::chrono::steady_clock;
+  TokenBucket(double rate, double burst);
+  /// 取不超过 wanted 个令牌，返回实际取到的个数
+  size_t take(size_t wanted, Clock::time_point now = Clock::now());
+  /// 退回未用完的令牌
+  void refund(size_t count);
+  /// 攒够 count 个令牌还需等待的时间
+  Clock::duration untilAvailable(size_t count, Clock::time_point now = Clock::now());
+  double burst() const { return burst_; }
+
+private:
+  void refill(Clock::time_point now);
+
+  double rate_;
+  double burst_;
+  double tokens_;
+  Clock::time_point last_;
+};
+
+/**
+ * @brief 指数退避重试策略，第 n 次失败后等待 min(base * 2^(n-1), max) 秒，乘以 [0.5, 1) 的随机抖动。
+ */
+struct RetryPolicy
+{
+  uint32_t maxAttempts{5};
+  double baseDelay{30};
+  double maxDelay{3600};
+  double delayAfter(uint32_t attempts, double jitter) const;
+};
+
+/**
+ * @brief 单个渠道的投递线程：攒够一批的令牌后取到期消息、整批发送、提交结果。
+ *
+ * 批大小不超过令牌桶容量。存取由回调提供，fetch(limit, now) 返回不超过 limit 条 next_attempt_at <= now 的消息，
+ * commit 写回每条的结果。消息在 commit 前崩溃会被重发，即至少投递一次。
+ * 线程自带定时等待，不使用任何事件循环。
+ */
+class BroadcastPump
+{
+public:
+  struct Result
+  {
+    enum State
+    {
+      Sent,
+      Retry,
+      Failed
+    };
+    uint64_t deliveryId{0};
+    uint64_t broadcastId{0};
+    State state{Sent};
+    uint32_t attempts{0};
+    int64_t retryAt{0}; // 秒，Retry 时有效
+  };
+  using Fetch = std::function<std::vector<BroadcastDelivery>(size_t limit, int64_t now)>;
+  using Commit = std::function<void(const std::vector<Result> &results)>;
+
+  BroadcastPump(std::shared_ptr<BroadcastSender> sender,
+                TokenBucket bucket,
+                RetryPolicy retry,
+                size_t batchSize,
+                double idleInterval,
+                Fetch &&fetch,
+                Commit &&commit);
+  ~BroadcastPump();
+
+  void start();
+  /// 等当前批次提交后停止
+  void stop();
+  /// 有新消息时唤醒空闲等待
+  void wake();
+
+private:
+  void run();
+  /// 等待 duration 或被唤醒，返回 false 表示正在停止
+  bool waitFor(std::chrono::steady_clock::duration duration);
+
+  std::shared_ptr<BroadcastSender> sender_;
+  TokenBucket bucket_;
+  RetryPolicy retry_;
+  size_t batchSize_;
+  std::chrono::steady_clock::duration idleInterval_;
+  Fetch fetch_;
+  Commit commit_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopping_{false};
+  bool woken_{false};
+  std::thread thread_;
+};
@@ -0,0 +1,344 @@
+/**
+ *
+ *  CampaignBroadcaster.cc
+ *
+ */
+
+#include "CampaignBroadcaster.h"
+#include "HttpSender.h"
+#include "MemberSegments.h"
+#include <drogon/drogon.h>
+#include <atomic>
+#include <ctime>
+#include <unordered_map>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+namespace
+{
+const std::string kSending = "发送中";
+const std::string kPending = "待发送";
+const std::string kSent = "已发送";
+const std::string kFailed = "失败";
+constexpr size_t kRowsPerInsert = 1000;
+
+// 收件地址列白名单，拼进 SQL
+std::string addressExpression(const std::string &column)
+{
+    if (column == "phone" || column == "username")
+        return column;
+    return "cast(member_id as char)";
+}
+
+Json::Value filterToJson(const SegmentIndex::Filter &filter)
+{
+    Json::Value segment;
+    for (auto level : filter.levels)
+        segment["level_id"].append(level);
+    for (const auto &status : filter.statuses)
+        segment["status"].append(status);
+    for (auto bucket : filter.spendBuckets)
+        segment["spend_bucket"].append(static_cast<Json::UInt>(bucket));
+    for (auto bucket : filter.recencyBuckets)
+        segment["recency_bucket"].append(static_cast<Json::UInt>(bucket));
+    return segment;
+}
+} // namespace
+
+void CampaignBroadcaster::initAndStart(const Json::Value &config)
+{
+    dbClient_ = app().getDbClient(config.get("db_client", "default").asString());
+    clientLoop_.run();
+
+    RetryPolicy retry;
+    retry.maxAttempts = std::max(config.get("max_attempts", 5).asUInt(), 1u);
+    retry.baseDelay = config.get("retry_base", 30.0).asDouble();
+    retry.maxDelay = config.get("retry_max", 3600.0).asDouble();
+    auto idleInterval = config.get("idle_interval", 2.0).asDouble();
+
+    const auto &channels = config["channels"];
+    for (const auto &name : channels.getMemberNames())
+    {
+        const auto &channelConfig = channels[name];
+        std::shared_ptr<BroadcastSender> sender;
+        auto type = channelConfig.get("sender", "file").asString();
+        if (type == "http")
+            sender = std::make_shared<HttpSender>(channelConfig.get("url", "").asString(),
+                                                  clientLoop_.getLoop(),
+                                                  channelConfig.get("timeout", 10.0).asDouble());
+        else
+            sender = std::make_shared<FileSender>(channelConfig.get("path", "./broadcast_" + name + ".jsonl").asString());
+
+        auto &channel = channels_[name];
+        channel.addressColumn = channelConfig.get("address", "phone").asString();
+        channel.pump = std::make_unique<BroadcastPump>(
+            sender,
+            TokenBucket(channelConfig.get("rate", 50.0).asDouble(), channelConfig.get("burst", 100.0).asDouble()),
+            retry,
+            channelConfig.get("batch", 100).asUInt(),
+            idleInterval,
+            [this, name](size_t limit, int64_t now) { return fetch(name, limit, now); },
+            [this](const std::vector<BroadcastPump::Result> &results) { commit(results); });
+        channel.pump->start();
+        LOG_INFO << "Broadcast channel " << name << " started with " << type << " sender";
+    }
+}
+
+void CampaignBroadcaster::shutdown()
+{
+    // 等各渠道当前批次提交后退出，发送器的事件循环随插件析构
+    for (auto &[name, channel] : channels_)
+        channel.pump->stop();
+}
+
+std::vector<BroadcastDelivery> CampaignBroadcaster::fetch(const std::string &channel, size_t limit, int64_t now)
+{
+    std::vector<BroadcastDelivery> batch;
+    try
+    {
+        auto rows = dbClient_->execSqlSync(
+            "select d.delivery_id, d.broadcast_id, d.member_id, d.address, d.attempts, b.content "
+            "from broadcast_delivery d join broadcast b on b.broadcast_id = d.broadcast_id "
+            "where d.channel = ? and d.status = ? and d.next_attempt_at <= from_unixtime(?) "
+            "order by d.next_attempt_at, d.delivery_id limit " +
+                std::to_string(limit),
+            channel,
+            kPending,
+            now);
+        for (const auto &row : rows)
+        {
+            BroadcastDelivery delivery;
+            delivery.deliveryId = row["delivery_id"].as<uint64_t>();
+            delivery.broadcastId = row["broadcast_id"].as<uint64_t>();
+            delivery.memberId = row["member_id"].as<uint32_t>();
+            delivery.address = row["address"].isNull() ? std::string() : row["address"].as<std::string>();
+            delivery.content = row["content"].isNull() ? std::string() : row["content"].as<std::string>();
+            delivery.attempts = row["attempts"].isNull() ? 0 : row["attempts"].as<uint32_t>();
+            batch.push_back(std::move(delivery));
+        }
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to fetch broadcast deliveries for " << channel << ": " << e.base().what();
+    }
+    return batch;
+}
+
+void CampaignBroadcaster::commit(const std::vector<BroadcastPump::Result> &results)
+{
+    std::string sql = "insert into broadcast_delivery (delivery_id, status, attempts, next_attempt_at) values ";
+    for (size_t i = 0; i < results.size(); ++i)
+        sql += i == 0 ? "(?, ?, ?, from_unixtime(?))" : ", (?, ?, ?, from_unixtime(?))";
+    sql += " on duplicate key update status = values(status), attempts = values(attempts), "
+           "next_attempt_at = values(next_attempt_at)";
+
+    auto now = static_cast<int64_t>(std::time(nullptr));
+    std::unordered_map<uint64_t, std::pair<uint64_t, uint64_t>> counts; // 群发 -> 成功、失败条数
+    try
+    {
+        auto transaction = dbClient_->newTransaction();
+        {
+            auto binder = *transaction << std::move(sql);
+            for (const auto &result : results)
+            {
+                auto status = result.state == BroadcastPump::Result::Sent     ? kSent
+                              : result.state == BroadcastPump::Result::Failed ? kFailed
+                                                                              : kPending;
+                binder << result.deliveryId << status << result.attempts
+                       << (result.state == BroadcastPump::Result::Retry ? result.retryAt : now);
+                if (result.state == BroadcastPump::Result::Sent)
+                    ++counts[result.broadcastId].first;
+                else if (result.state == BroadcastPump::Result::Failed)
+                    ++counts[result.broadcastId].second;
+            }
+            binder << Mode::Blocking;
+            binder >> [](const Result &) {};
+            binder.exec(); // 失败时抛出异常，事务自动回滚
+        }
+        for (const auto &[broadcastId, count] : counts)
+            transaction->execSqlSync(
+                "update broadcast set sent = sent + ?, failed = failed + ?, "
+                "status = if(sent + failed >= total, '已完成', status) where broadcast_id = ?",
+                count.first,
+                count.second,
+                broadcastId);
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to commit broadcast results: " << e.base().what();
+        throw std::runtime_error(e.base().what());
+    }
+}
+
+void CampaignBroadcaster::create(uint32_t tenantId,
+                                 uint32_t campaignId,
+                                 const std::string &channel,
+                                 const std::string &content,
+                                 const SegmentIndex::Filter &filter,
+                                 std::function<void(uint64_t broadcastId, uint64_t total)> &&callback,
+                                 std::function<void(int code, const std::string &message)> &&errorCallback)
+{
+    auto channelIt = channels_.find(channel);
+    if (channelIt == channels_.end())
+    {
+        errorCallback(400, "渠道未配置");
+        return;
+    }
+    auto callbackPtr = std::make_shared<std::function<void(uint64_t, uint64_t)>>(std::move(callback));
+    auto errorPtr = std::make_shared<std::function<void(int, const std::string &)>>(std::move(errorCallback));
+    auto address = addressExpression(channelIt->second.addressColumn);
+    auto *pump = channelIt->second.pump.get();
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    auto segment = Json::writeString(builder, filterToJson(filter));
+
+    dbClient_->execSqlAsync(
+        "select tenant_id from marketing_campaign where campaign_id = ? and (is_deleted = 0 or is_deleted is null)",
+        [this, tenantId, campaignId, channel, content, filter, address, pump, segment, callbackPtr, errorPtr](
+            const Result &result)
+        {
+            if (result.empty() || result[0]["tenant_id"].isNull() || result[0]["tenant_id"].as<uint32_t>() != tenantId)
+            {
+                (*errorPtr)(404, "营销活动不存在");
+                return;
+            }
+            auto members = std::make_shared<std::vector<uint32_t>>();
+            app().getPlugin<MemberSegments>()->select(tenantId, filter, 0, UINT64_MAX, *members);
+            if (members->empty())
+            {
+                (*errorPtr)(400, "分群内没有会员");
+                return;
+            }
+
+            dbClient_->newTransactionAsync(
+                [this, tenantId, campaignId, channel, content, address, pump, segment, members, callbackPtr, errorPtr](
+                    const std::shared_ptr<Transaction> &transaction)
+                {
+                    if (!transaction)
+                    {
+                        (*errorPtr)(500, "database error");
+                        return;
+                    }
+                    auto broadcastId = std::make_shared<uint64_t>(0);
+                    auto total = std::make_shared<uint64_t>(0);
+                    auto failed = std::make_shared<std::atomic<bool>>(false);
+                    transaction->setCommitCallback(
+                        [broadcastId, total, failed, pump, callbackPtr, errorPtr](bool committed)
+                        {
+                            if (*failed)
+                                return;
+                            if (!committed || *broadcastId == 0)
+                            {
+                                (*errorPtr)(500, "database error");
+                                return;
+                            }
+                            pump->wake();
+                            (*callbackPtr)(*broadcastId, *total);
+                        });
+                    // 出错时事务自动回滚且不再触发提交回调，在这里应答，只应答一次
+                    auto onError = [failed, errorPtr](const DrogonDbException &e)
+                    {
+                        LOG_ERROR << "Failed to create broadcast: " << e.base().what();
+                        if (!failed->exchange(true))
+                            (*errorPtr)(500, "database error");
+                    };
+
+                    transaction->execSqlAsync(
+                        "insert into broadcast (tenant_id, campaign_id, channel, content, segment, status, total, sent, "
+                        "failed) values (?, ?, ?, ?, ?, ?, 0, 0, 0)",
+                        [transaction, tenantId, channel, address, members, broadcastId, total, failed, onError](
+                            const Result &inserted)
+                        {
+                            *broadcastId = inserted.insertId();
+                            // 收件地址取自会员当前资料，没有地址的会员不入队
+                            for (size_t begin = 0; begin < members->size(); begin += kRowsPerInsert)
+                            {
+                                auto end = std::min(begin + kRowsPerInsert, members->size());
+                                std::string sql = "insert into broadcast_delivery (broadcast_id, channel, member_id, "
+                                                  "address, status, attempts, next_attempt_at) select ?, ?, member_id, " +
+                                                  address + ", ?, 0, now() from member where tenant_id = ? and " +
+                                                  address + " is not null and " + address +
+                                                  " <> '' and (is_deleted = 0 or is_deleted is null) and member_id in (";
+                                for (size_t i = begin; i < end; ++i)
+                                {
+                                    sql += i == begin ? "" : ",";
+                                    sql += std::to_string((*members)[i]);
+                                }
+                                sql += ")";
+                                transaction->execSqlAsync(
+                                    sql,
+                                    [total](const Result &rows) { *total += rows.affectedRows(); },
+                                    onError,
+                                    *broadcastId,
+                                    channel,
+                                    kPending,
+                                    tenantId);
+                            }
+                            transaction->execSqlAsync(
+                                "update broadcast set total = (select count(*) from broadcast_delivery where "
+                                "broadcast_id = ?), status = if(total = 0, '已完成', status) where broadcast_id = ?",
+                                [](const Result &) {},
+                                onError,
+                                *broadcastId,
+                                *broadcastId);
+                        },
+                        onError,
+                        tenantId,
+                        campaignId,
+                        channel,
+                        content,
+                        segment,
+                        kSending);
+                });
+        },
+        [errorPtr](const DrogonDbException &e)
+        {
+            LOG_ERROR << e.base().what();
+            (*errorPtr)(500, "database error");
+        },
+        campaignId);
+}
+
+void CampaignBroadcaster::progress(uint32_t tenantId,
+                                   uint32_t campaignId,
+                                   std::function<void(const Json::Value &broadcasts)> &&callback,
+                                   std::function<void(const std::string &message)> &&errorCallback)
+{
+    auto callbackPtr = std::make_shared<std::function<void(const Json::Value &)>>(std::move(callback));
+    auto errorPtr = std::make_shared<std::function<void(const std::string &)>>(std::move(errorCallback));
+    dbClient_->execSqlAsync(
+        "select broadcast_id, channel, status, total, sent, failed, created_at, updated_at from broadcast "
+        "where tenant_id = ? and campaign_id = ? order by broadcast_id",
+        [callbackPtr](const Result &result)
+        {
+            Json::Value broadcasts(Json::arrayValue);
+            for (const auto &row : result)
+            {
+                Json::Value item;
+                auto total = row["total"].as<uint64_t>();
+                auto sent = row["sent"].as<uint64_t>();
+                auto failed = row["failed"].as<uint64_t>();
+                item["broadcast_id"] = static_cast<Json::UInt64>(row["broadcast_id"].as<uint64_t>());
+                item["channel"] = row["channel"].as<std::string>();
+                item["status"] = row["status"].as<std::string>();
+                item["total"] = static_cast<Json::UInt64>(total);
+                item["sent"] = static_cast<Json::UInt64>(sent);
+                item["failed"] = static_cast<Json::UInt64>(failed);
+                item["pending"] = static_cast<Json::UInt64>(total > sent + failed ? total - sent - failed : 0);
+                item["created_at"] =
+                    row["created_at"].isNull() ? Json::Value::null : Json::Value(row["created_at"].as<std::string>());
+                item["updated_at"] =
+                    row["updated_at"].isNull() ? Json::Value::null : Json::Value(row["updated_at"].as<std::string>());
+                broadcasts.append(item);
+            }
+            (*callbackPtr)(broadcasts);
+        },
+        [errorPtr](const DrogonDbException &e)
+        {
+            LOG_ERROR << e.base().what();
+            (*errorPtr)("database error");
+        },
+        tenantId,
+        campaignId);
+}
@@ -0,0 +1,71 @@
+/**
+ *
+ *  CampaignBroadcaster.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/orm/DbClient.h>
+#include <trantor/net/EventLoopThread.h>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "BroadcastPump.h"
+#include "SegmentIndex.h"
+
+/**
+ * @brief 营销活动群发：把分群会员写入持久化投递队列，按渠道限速、批量发送、失败退避重试。
+ *
+ * 队列即 broadcast_delivery 表，创建群发时在一个事务里写入全部收件人。每个渠道一个投递线程，
+ * 同步读写数据库、同步调用发送器，HTTP 发送器使用插件自己的事件循环，不占用处理请求的 IO 线程。
+ * 渠道的发送器可以是 http（向网关 POST 一批消息）或 file（本地替身，写 JSON 行文件）。
+ * 进度按群发累计在 broadcast 表的 sent / failed 中，全部有结果后状态变为已完成。
+ */
+class CampaignBroadcaster : public drogon::Plugin<CampaignBroadcaster>
+{
+public:
+  CampaignBroadcaster() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  bool hasChannel(const std::string &channel) const { return channels_.count(channel) > 0; }
+
+  /// 向分群会员群发，收件人全部入队后回调；code 为 404 时营销活动不存在，400 时分群为空
+  void create(uint32_t tenantId,
+              uint32_t campaignId,
+              const std::string &channel,
+              const std::string &content,
+              const SegmentIndex::Filter &filter,
+              std::function<void(uint64_t broadcastId, uint64_t total)> &&callback,
+              std::function<void(int code, const std::string &message)> &&errorCallback);
+
+  /// 活动下各次群发的进度
+  void progress(uint32_t tenantId,
+                uint32_t campaignId,
+                std::function<void(const Json::Value &broadcasts)> &&callback,
+                std::function<void(const std::string &message)> &&errorCallback);
+
+private:
+  struct Channel
+  {
+    std::string addressColumn; // member 表中作为收件地址的列
+    std::unique_ptr<BroadcastPump> pump;
+  };
+
+  std::vector<BroadcastDelivery> fetch(const std::string &channel, size_t limit, int64_t now);
+  void commit(const std::vector<BroadcastPump::Result> &results);
+
+  drogon::orm::DbClientPtr dbClient_;
+  trantor::EventLoopThread clientLoop_; // HTTP 发送器专用
+  std::map<std::string, Channel> channels_;
+};
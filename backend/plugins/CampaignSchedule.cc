@@ -0,0 +1,92 @@
+/**
+ *
+ *  CampaignSchedule.cc
+ *
+ */
+
+#include "CampaignSchedule.h"
+#include <algorithm>
+
+void CampaignSchedule::set(Campaign campaign)
+{
+    if (campaign.end <= campaign.start)
+    {
+        remove(campaign.campaignId);
+        return;
+    }
+    auto campaignId = campaign.campaignId;
+    campaigns_[campaignId] = std::move(campaign);
+    rebuild();
+}
+
+bool CampaignSchedule::remove(uint32_t campaignId)
+{
+    if (campaigns_.erase(campaignId) == 0)
+        return false;
+    rebuild();
+    return true;
+}
+
+const CampaignSchedule::Campaign *CampaignSchedule::find(uint32_t campaignId) const
+{
+    auto it = campaigns_.find(campaignId);
+    return it == campaigns_.end() ? nullptr : &it->second;
+}
+
+void CampaignSchedule::rebuild()
+{
+    points_.clear();
+    segments_.clear();
+    std::vector<const Campaign *> ordered;
+    ordered.reserve(campaigns_.size());
+    for (const auto &[campaignId, campaign] : campaigns_)
+    {
+        ordered.push_back(&campaign);
+        points_.push_back(campaign.start);
+        if (campaign.end != kOpenEnd)
+            points_.push_back(campaign.end);
+    }
+    std::sort(points_.begin(), points_.end());
+    points_.erase(std::unique(points_.begin(), points_.end()), points_.end());
+    std::sort(ordered.begin(), ordered.end(), [](const Campaign *a, const Campaign *b) {
+        return a->start != b->start ? a->start < b->start : a->campaignId < b->campaignId;
+    });
+
+    // 每个活动覆盖从开始点到结束点之间的连续若干段
+    segments_.resize(points_.size());
+    for (const auto *campaign : ordered)
+    {
+        auto first = std::lower_bound(points_.begin(), points_.end(), campaign->start) - points_.begin();
+        auto last = campaign->end == kOpenEnd
+                        ? static_cast<std::ptrdiff_t>(points_.size())
+                        : std::lower_bound(points_.begin(), points_.end(), campaign->end) - points_.begin();
+        for (auto i = first; i < last; ++i)
+            segments_[i].push_back(campaign);
+    }
+}
+
+std::vector<const CampaignSchedule::Campaign *> CampaignSchedule::activeAt(int64_t at, uint32_t levelId) const
+{
+    std::vector<const Campaign *> active;
+    auto it = std::upper_bound(points_.begin(), points_.end(), at);
+    if (it == points_.begin())
+        return active;
+    for (const auto *campaign : segments_[it - points_.begin() - 1])
+    {
+        if (campaign->levelId == 0 || campaign->levelId == levelId)
+            active.push_back(campaign);
+    }
+    return active;
+}
+
+int64_t CampaignSchedule::nextChange(int64_t at) const
+{
+    auto it = std::upper_bound(points_.begin(), points_.end(), at);
+    return it == points_.end() ? kOpenEnd : *it;
+}
+
+std::vector<int64_t> CampaignSchedule::boundariesIn(int64_t from, int64_t to) const
+{
+    return std::vector<int64_t>(std::lower_bound(points_.begin(), points_.end(), from),
+                                std::lower_bound(points_.begin(), points_.end(), to));
+}
@@ -0,0 +1,66 @@
+/**
+ *
+ *  CampaignSchedule.h
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 单个租户营销活动的时间表。
+ *
+ * 所有活动的开始、结束时间排序去重后把时间轴切成若干段，每段记录期间有效的活动。
+ * 查询某一时刻对某个会员等级有效的活动只需二分定位所在段，O(log n + k)。
+ * 活动增删时整体重建，活动数量不大且写入很少，读多写少的场景下比区间树简单。
+ */
+class CampaignSchedule
+{
+public:
+  static constexpr int64_t kOpenEnd = INT64_MAX;
+
+  struct Campaign
+  {
+    uint32_t campaignId{0};
+    uint32_t levelId{0}; // 0 表示所有会员等级
+    int64_t start{0};    // 秒，含
+    int64_t end{kOpenEnd}; // 秒，不含
+    std::string name;
+  };
+
+  CampaignSchedule() = default;
+  // 时间段里存的是指向 campaigns_ 的指针，复制后须重建
+  CampaignSchedule(const CampaignSchedule &other) : campaigns_(other.campaigns_) { rebuild(); }
+  CampaignSchedule &operator=(const CampaignSchedule &other)
+  {
+    campaigns_ = other.campaigns_;
+    rebuild();
+    return *this;
+  }
+  CampaignSchedule(CampaignSchedule &&) = default;
+  CampaignSchedule &operator=(CampaignSchedule &&) = default;
+
+  /// 新增或替换，结束时间不晚于开始时间的活动视为无效并移除
+  void set(Campaign campaign);
+  bool remove(uint32_t campaignId);
+  const Campaign *find(uint32_t campaignId) const;
+  size_t size() const { return campaigns_.size(); }
+
+  /// at 时刻对该等级有效的活动，按开始时间升序
+  std::vector<const Campaign *> activeAt(int64_t at, uint32_t levelId) const;
+  /// [from, to) 内的开始、结束时间点，升序
+  std::vector<int64_t> boundariesIn(int64_t from, int64_t to) const;
+  /// at 之后第一个开始或结束时间点，没有时为 kOpenEnd
+  int64_t nextChange(int64_t at) const;
+
+private:
+  void rebuild();
+
+  std::unordered_map<uint32_t, Campaign> campaigns_;
+  std::vector<int64_t> points_;                          // 时间段起点，升序
+  std::vector<std::vector<const Campaign *>> segments_; // segments_[i] 覆盖 [points_[i], points_[i + 1])
+};
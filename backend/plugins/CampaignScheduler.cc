@@ -0,0 +1,236 @@
+/**
+ *
+ *  CampaignScheduler.cc
+ *
+ */
+
+#include "CampaignScheduler.h"
+#include "MenuSnapshots.h"
+#include "PricingEngine.h"
+#include <drogon/drogon.h>
+#include <algorithm>
+#include <mutex>
+#include <tuple>
+
+using namespace drogon;
+using namespace drogon::orm;
+using namespace drogon_model::saas_restaurant;
+
+namespace
+{
+const std::string kPending = "未开始";
+const std::string kRunning = "进行中";
+const std::string kEnded = "已结束";
+
+// 时间轮按引用计数释放条目，释放即到点
+class BoundaryEntry
+{
+public:
+  explicit BoundaryEntry(std::function<void()> callback) : callback_(std::move(callback)) {}
+  ~BoundaryEntry() { callback_(); }
+
+private:
+  std::function<void()> callback_;
+};
+} // namespace
+
+void CampaignScheduler::initAndStart(const Json::Value &config)
+{
+    dbClient_ = app().getDbClient(config.get("db_client", "default").asString());
+    horizon_ = std::max<int64_t>(config.get("arm_horizon", 7200).asInt64(), 60);
+    load();
+    wheel_ = std::make_unique<trantor::TimingWheel>(app().getLoop(), static_cast<size_t>(horizon_ + 60));
+
+    auto now = trantor::Date::now().secondsSinceEpoch();
+    std::vector<uint32_t> tenantIds;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        for (const auto &[tenantId, tenant] : tenants_)
+            tenantIds.push_back(tenantId);
+    }
+    // 停机期间错过的时间点在启动时补上
+    for (auto tenantId : tenantIds)
+        reconcile(tenantId);
+    arm(now, now + horizon_);
+
+    timerId_ = app().getLoop()->runEvery(static_cast<double>(horizon_ / 2),
+                                         [this]()
+                                         {
+                                             auto now = trantor::Date::now().secondsSinceEpoch();
+                                             arm(now, now + horizon_);
+                                         });
+}
+
+void CampaignScheduler::shutdown()
+{
+    stopping_ = true;
+    app().getLoop()->invalidateTimer(timerId_);
+    wheel_.reset();
+}
+
+std::string CampaignScheduler::statusAt(const CampaignSchedule::Campaign &campaign, int64_t at)
+{
+    if (at < campaign.start)
+        return kPending;
+    return at < campaign.end ? kRunning : kEnded;
+}
+
+void CampaignScheduler::load()
+{
+    try
+    {
+        auto campaigns = Mapper<MarketingCampaign>(dbClient_).findAll();
+        for (const auto &campaign : campaigns)
+            apply(campaign);
+        LOG_INFO << "Campaign scheduler loaded " << campaigns.size() << " campaigns";
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to load campaigns for scheduling: " << e.base().what();
+    }
+}
+
+void CampaignScheduler::removeCampaign(uint32_t campaignId)
+{
+    for (auto &[tenantId, tenant] : tenants_)
+    {
+        tenant.schedule.remove(campaignId);
+        tenant.status.erase(campaignId);
+    }
+}
+
+void CampaignScheduler::apply(const MarketingCampaign &campaign)
+{
+    auto campaignId = campaign.getValueOfCampaignId();
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        removeCampaign(campaignId);
+        if (campaign.getValueOfIsDeleted() == 1 || campaign.getValueOfStatus() == kEnded)
+            return;
+
+        CampaignSchedule::Campaign entry;
+        entry.campaignId = campaignId;
+        entry.levelId = campaign.getValueOfLevelId();
+        entry.start = campaign.getCampaignStart() ? campaign.getValueOfCampaignStart().secondsSinceEpoch() : 0;
+        entry.end = campaign.getCampaignEnd() ? campaign.getValueOfCampaignEnd().secondsSinceEpoch()
+                                              : CampaignSchedule::kOpenEnd;
+        entry.name = campaign.getValueOfCampaignName();
+        auto &tenant = tenants_[campaign.getValueOfTenantId()];
+        tenant.schedule.set(std::move(entry));
+        if (!tenant.schedule.find(campaignId))
+            return;
+        tenant.status[campaignId] = campaign.getValueOfStatus();
+    }
+    if (wheel_ && !stopping_)
+    {
+        auto now = trantor::Date::now().secondsSinceEpoch();
+        arm(now, now + horizon_);
+    }
+}
+
+void CampaignScheduler::arm(int64_t from, int64_t to)
+{
+    if (stopping_)
+        return;
+    std::vector<std::pair<int64_t, uint32_t>> fresh;
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        armed_.erase(armed_.begin(), armed_.lower_bound({from, 0}));
+        for (const auto &[tenantId, tenant] : tenants_)
+        {
+            for (auto point : tenant.schedule.boundariesIn(from, to))
+            {
+                if (armed_.insert({point, tenantId}).second)
+                    fresh.push_back({point, tenantId});
+            }
+        }
+    }
+    // 多等一秒，保证到点时当前时间已越过边界
+    for (const auto &[point, tenantId] : fresh)
+    {
+        auto delay = static_cast<size_t>(point - from + 1);
+        wheel_->insertEntry(delay,
+                            std::make_shared<BoundaryEntry>(
+                                [this, tenantId = tenantId]()
+                                {
+                                    if (!stopping_)
+                                        reconcile(tenantId);
+                                }));
+    }
+}
+
+void CampaignScheduler::reconcile(uint32_t tenantId)
+{
+    auto now = trantor::Date::now().secondsSinceEpoch();
+    std::vector<std::tuple<uint32_t, std::string, std::string>> changes;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = tenants_.find(tenantId);
+        if (it == tenants_.end())
+            return;
+        for (const auto &[campaignId, status] : it->second.status)
+        {
+            const auto *campaign = it->second.schedule.find(campaignId);
+            if (!campaign)
+                continue;
+            auto expected = statusAt(*campaign, now);
+            if (expected != status)
+                changes.emplace_back(campaignId, status, expected);
+        }
+    }
+    for (const auto &[campaignId, from, to] : changes)
+        updateStatus(campaignId, from, to);
+}
+
+void CampaignScheduler::updateStatus(uint32_t campaignId, const std::string &from, const std::string &to)
+{
+    // 带上旧状态作为条件，期间被手动修改过的活动不覆盖
+    dbClient_->execSqlAsync(
+        "update marketing_campaign set status = ? where campaign_id = ? and coalesce(status, '') = ?",
+        [this, campaignId, to](const Result &result)
+        {
+            if (result.affectedRows() == 1)
+                LOG_INFO << "Campaign " << campaignId << " is now " << to;
+            campaignChanged(campaignId);
+            app().getPlugin<PricingEngine>()->campaignChanged(campaignId);
+            app().getPlugin<MenuSnapshots>()->campaignChanged(campaignId);
+        },
+        [campaignId](const DrogonDbException &e)
+        {
+            LOG_ERROR << "Failed to update status of campaign " << campaignId << ": " << e.base().what();
+        },
+        to,
+        campaignId,
+        from);
+}
+
+void CampaignScheduler::campaignChanged(uint32_t campaignId)
+{
+    Mapper<MarketingCampaign>(dbClient_).findByPrimaryKey(
+        campaignId,
+        [this](const MarketingCampaign &campaign) { apply(campaign); },
+        [this, campaignId](const DrogonDbException &e)
+        {
+            if (!dynamic_cast<const UnexpectedRows *>(&e.base()))
+            {
+                LOG_ERROR << "Failed to refresh campaign " << campaignId << " for scheduling: " << e.base().what();
+                return;
+            }
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            removeCampaign(campaignId);
+        });
+}
+
+std::vector<CampaignSchedule::Campaign> CampaignScheduler::activeCampaigns(uint32_t tenantId,
+                                                                           uint32_t levelId,
+                                                                           int64_t at) const
+{
+    std::vector<CampaignSchedule::Campaign> active;
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = tenants_.find(tenantId);
+    if (it == tenants_.end())
+        return active;
+    for (const auto *campaign : it->second.schedule.activeAt(at, levelId))
+        active.push_back(*campaign);
+    return active;
+}
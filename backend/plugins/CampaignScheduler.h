@@ -0,0 +1,76 @@
+/**
+ *
+ *  CampaignScheduler.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/orm/DbClient.h>
+#include <trantor/net/EventLoop.h>
+#include <trantor/utils/TimingWheel.h>
+#include <atomic>
+#include <memory>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "CampaignSchedule.h"
+#include "MarketingCampaign.h"
+
+/**
+ * @brief 营销活动的内存时间表和定时启停。
+ *
+ * 未删除、状态不是“已结束”的活动按租户放入 CampaignSchedule，随活动增删改刷新。
+ * 未来 arm_horizon 秒内的开始、结束时间点挂到时间轮上，到点把状态改为“进行中”或“已结束”，
+ * 每 arm_horizon / 2 秒补挂下一段。手动结束的活动不再参与调度。
+ */
+class CampaignScheduler : public drogon::Plugin<CampaignScheduler>
+{
+public:
+  CampaignScheduler() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  /// 活动增删改后按主键重新读取
+  void campaignChanged(uint32_t campaignId);
+
+  /// at 时刻对该会员等级有效的活动，levelId 为 0 时只返回面向所有等级的活动
+  std::vector<CampaignSchedule::Campaign> activeCampaigns(uint32_t tenantId, uint32_t levelId, int64_t at) const;
+
+private:
+  struct Tenant
+  {
+    CampaignSchedule schedule;
+    std::unordered_map<uint32_t, std::string> status; // 数据库中的当前状态
+  };
+
+  static std::string statusAt(const CampaignSchedule::Campaign &campaign, int64_t at);
+  void load();
+  void apply(const drogon_model::saas_restaurant::MarketingCampaign &campaign);
+  void removeCampaign(uint32_t campaignId);
+  /// 把 [from, to) 内尚未挂上的时间点挂到时间轮
+  void arm(int64_t from, int64_t to);
+  /// 按当前时间修正租户内所有活动的状态
+  void reconcile(uint32_t tenantId);
+  void updateStatus(uint32_t campaignId, const std::string &from, const std::string &to);
+
+  drogon::orm::DbClientPtr dbClient_;
+  trantor::TimerId timerId_{0};
+  int64_t horizon_{7200};
+  std::unique_ptr<trantor::TimingWheel> wheel_;
+  std::atomic<bool> stopping_{false};
+
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<uint32_t, Tenant> tenants_;
+  std::set<std::pair<int64_t, uint32_t>> armed_; // 已挂上的（时间点，租户）
+};
@@ -0,0 +1,138 @@
+/**
+ *
+ *  CategoryTree.cc
+ *
+ */
+
+#include "CategoryTree.h"
+#include <algorithm>
+
+void CategoryTree::set(Category category)
+{
+    auto categoryId = category.categoryId;
+    nodes_[categoryId].category = std::move(category);
+    rebuild();
+}
+
+void CategoryTree::remove(uint32_t categoryId)
+{
+    if (nodes_.erase(categoryId) != 0)
+        rebuild();
+}
+
+void CategoryTree::rebuild()
+{
+    children_.clear();
+    order_.clear();
+    order_.reserve(nodes_.size());
+    for (auto &[categoryId, node] : nodes_)
+    {
+        auto parentId = node.category.parentId;
+        node.parent = parentId != categoryId && nodes_.count(parentId) != 0 ? parentId : 0;
+        node.enter = node.exit = 0;
+        children_[node.parent].push_back(categoryId);
+    }
+    auto before = [this](uint32_t a, uint32_t b)
+    {
+        const auto &x = nodes_.at(a).category;
+        const auto &y = nodes_.at(b).category;
+        return x.sortOrder != y.sortOrder ? x.sortOrder > y.sortOrder : a < b;
+    };
+    for (auto &[parentId, list] : children_)
+        std::sort(list.begin(), list.end(), before);
+
+    // 显式栈的先序遍历；exit 在子树全部编号后回填
+    std::vector<std::pair<uint32_t, size_t>> stack;
+    auto visit = [&](uint32_t rootId, uint32_t depth)
+    {
+        stack.emplace_back(rootId, 0);
+        auto &root = nodes_.at(rootId);
+        root.enter = static_cast<uint32_t>(order_.size());
+        root.depth = depth;
+        order_.push_back(rootId);
+        while (!stack.empty())
+        {
+            auto &[current, next] = stack.back();
+            auto it = children_.find(current);
+            if (it == children_.end() || next == it->second.size())
+            {
+                nodes_.at(current).exit = static_cast<uint32_t>(order_.size());
+                stack.pop_back();
+                continue;
+            }
+            auto childId = it->second[next++];
+            auto &child = nodes_.at(childId);
+            child.enter = static_cast<uint32_t>(order_.size());
+            child.depth = static_cast<uint32_t>(stack.size()) + depth;
+            order_.push_back(childId);
+            stack.emplace_back(childId, 0);
+        }
+    };
+    auto roots = children_.find(0);
+    if (roots != children_.end())
+    {
+        for (auto rootId : roots->second)
+            visit(rootId, 0);
+    }
+
+    // 成环的分类从根到不了，按ID从小到大断开环挂到根上
+    if (order_.size() < nodes_.size())
+    {
+        std::vector<uint32_t> orphans;
+        for (const auto &[categoryId, node] : nodes_)
+        {
+            if (node.exit == 0)
+                orphans.push_back(categoryId);
+        }
+        std::sort(orphans.begin(), orphans.end());
+        for (auto categoryId : orphans)
+        {
+            auto &node = nodes_.at(categoryId);
+            if (node.exit != 0)
+                continue;
+            auto &siblings = children_[node.parent];
+            siblings.erase(std::find(siblings.begin(), siblings.end(), categoryId));
+            node.parent = 0;
+            auto &rootList = children_[0];
+            rootList.insert(std::upper_bound(rootList.begin(), rootList.end(), categoryId, before), categoryId);
+            visit(categoryId, 0);
+        }
+    }
+}
+
+const CategoryTree::Node *CategoryTree::find(uint32_t categoryId) const
+{
+    auto it = nodes_.find(categoryId);
+    return it == nodes_.end() ? nullptr : &it->second;
+}
+
+bool CategoryTree::contains(uint32_t ancestor, uint32_t categoryId) const
+{
+    auto outer = find(ancestor);
+    auto inner = find(categoryId);
+    return outer && inner && outer->enter <= inner->enter && inner->enter < outer->exit;
+}
+
+std::vector<uint32_t> CategoryTree::subtree(uint32_t categoryId) const
+{
+    auto node = find(categoryId);
+    if (!node)
+        return {};
+    return std::vector<uint32_t>(order_.begin() + node->enter, order_.begin() + node->exit);
+}
+
+std::vector<uint32_t> CategoryTree::pathOf(uint32_t categoryId) const
+{
+    std::vector<uint32_t> path;
+    for (auto node = find(categoryId); node; node = node->parent == 0 ? nullptr : find(node->parent))
+        path.push_back(node->category.categoryId);
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+const std::vector<uint32_t> &CategoryTree::childrenOf(uint32_t categoryId) const
+{
+    static const std::vector<uint32_t> empty;
+    auto it = children_.find(categoryId);
+    return it == children_.end() ? empty : it->second;
+}
@@ -0,0 +1,65 @@
+/**
+ *
+ *  CategoryTree.h
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 单个租户的菜品分类树，按先序遍历给每个分类编号，子树对应连续区间。
+ *
+ * 分类 c 的区间为 [enter, exit)，d 在 c 的子树内当且仅当 c.enter <= d.enter < c.exit，
+ * 子树内的分类就是先序序列中的这一段，不需要递归查询。同级按 sort_order 从大到小、再按ID排。
+ * 父分类不存在（或为自身、成环）的分类当作根。每次增删改后整体重排，分类数通常只有几十到几百。
+ * 不加锁，由调用方保证互斥。
+ */
+class CategoryTree
+{
+public:
+  struct Category
+  {
+    uint32_t categoryId{0};
+    uint32_t parentId{0}; // 0 表示根
+    std::string name;
+    int32_t sortOrder{0};
+  };
+  struct Node
+  {
+    Category category;
+    uint32_t parent{0}; // 实际挂载的父分类，根为 0
+    uint32_t enter{0};
+    uint32_t exit{0};
+    uint32_t depth{0};
+  };
+
+  void set(Category category);
+  void remove(uint32_t categoryId);
+
+  const Node *find(uint32_t categoryId) const;
+  /// ancestor 的子树（含自身）是否包含 categoryId
+  bool contains(uint32_t ancestor, uint32_t categoryId) const;
+  /// 子树内的全部分类ID（含自身，先序），分类不存在时为空
+  std::vector<uint32_t> subtree(uint32_t categoryId) const;
+  /// 从根到该分类的ID路径
+  std::vector<uint32_t> pathOf(uint32_t categoryId) const;
+  /// 全部分类的先序序列
+  const std::vector<uint32_t> &order() const { return order_; }
+  /// 直接子分类，已排好序
+  const std::vector<uint32_t> &childrenOf(uint32_t categoryId) const;
+  const std::vector<uint32_t> &roots() const { return childrenOf(0); }
+  size_t size() const { return nodes_.size(); }
+
+private:
+  void rebuild();
+
+  std::unordered_map<uint32_t, Node> nodes_;
+  std::unordered_map<uint32_t, std::vector<uint32_t>> children_; // 父分类 -> 子分类，0 为根
+  std::vector<uint32_t> order_;
+};
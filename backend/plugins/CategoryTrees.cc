@@ -0,0 +1,145 @@
+/**
+ *
+ *  CategoryTrees.cc
+ *
+ */
+
+#include "CategoryTrees.h"
+#include <drogon/drogon.h>
+#include <mutex>
+
+using namespace drogon;
+using namespace drogon::orm;
+using namespace drogon_model::saas_restaurant;
+
+void CategoryTrees::initAndStart(const Json::Value &config)
+{
+    dbClient_ = app().getDbClient(config.get("db_client", "default").asString());
+    load();
+}
+
+void CategoryTrees::shutdown()
+{
+}
+
+void CategoryTrees::load()
+{
+    try
+    {
+        auto categories = Mapper<DishCategory>(dbClient_).findBy(
+            Criteria(DishCategory::Cols::_is_deleted, CompareOperator::EQ, 0) ||
+            Criteria(DishCategory::Cols::_is_deleted, CompareOperator::IsNull));
+        for (const auto &category : categories)
+            applyCategory(category);
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        LOG_INFO << "Category trees loaded " << tenants_.size() << " tenants, " << categoryTenant_.size()
+                 << " categories";
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to load dish category trees: " << e.base().what();
+    }
+}
+
+void CategoryTrees::unlist(uint32_t categoryId)
+{
+    auto it = categoryTenant_.find(categoryId);
+    if (it == categoryTenant_.end())
+        return;
+    auto tree = tenants_.find(it->second);
+    if (tree != tenants_.end())
+        tree->second.remove(categoryId);
+    categoryTenant_.erase(it);
+}
+
+void CategoryTrees::applyCategory(const DishCategory &category)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto categoryId = category.getValueOfCategoryId();
+    auto tenant = categoryTenant_.find(categoryId);
+    // 换租户时先从原租户的树上摘下
+    if (tenant != categoryTenant_.end() && tenant->second != category.getValueOfTenantId())
+        unlist(categoryId);
+    if (category.getValueOfIsDeleted() == 1 || !category.getTenantId())
+    {
+        unlist(categoryId);
+        return;
+    }
+    CategoryTree::Category entry;
+    entry.categoryId = categoryId;
+    entry.parentId = category.getValueOfParentId();
+    entry.name = category.getValueOfCategoryName();
+    entry.sortOrder = category.getValueOfSortOrder();
+    tenants_[category.getValueOfTenantId()].set(std::move(entry));
+    categoryTenant_[categoryId] = category.getValueOfTenantId();
+}
+
+void CategoryTrees::categoryChanged(uint32_t categoryId)
+{
+    Mapper<DishCategory>(dbClient_).findByPrimaryKey(
+        categoryId,
+        [this](const DishCategory &category) { applyCategory(category); },
+        [this, categoryId](const DrogonDbException &e)
+        {
+            if (!dynamic_cast<const UnexpectedRows *>(&e.base()))
+            {
+                LOG_ERROR << "Failed to refresh dish category " << categoryId << ": " << e.base().what();
+                return;
+            }
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            unlist(categoryId);
+        });
+}
+
+Json::Value CategoryTrees::treeOf(uint32_t tenantId) const
+{
+    Json::Value roots(Json::arrayValue);
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto tenant = tenants_.find(tenantId);
+    if (tenant == tenants_.end())
+        return roots;
+    const auto &tree = tenant->second;
+    // 先序的逆序里子分类总在父分类之前，自底向上拼出嵌套结构
+    std::unordered_map<uint32_t, Json::Value> built;
+    built.reserve(tree.size());
+    const auto &order = tree.order();
+    for (auto it = order.rbegin(); it != order.rend(); ++it)
+    {
+        const auto &node = *tree.find(*it);
+        Json::Value item;
+        item["category_id"] = node.category.categoryId;
+        item["tenant_id"] = tenantId;
+        item["parent_id"] = node.parent;
+        item["category_name"] = node.category.name;
+        item["sort_order"] = node.category.sortOrder;
+        item["depth"] = node.depth;
+        item["left"] = node.enter;
+        item["right"] = node.exit;
+        Json::Value path(Json::arrayValue);
+        for (auto ancestor : tree.pathOf(*it))
+            path.append(ancestor);
+        item["path"] = path;
+        Json::Value children(Json::arrayValue);
+        for (auto childId : tree.childrenOf(*it))
+        {
+            auto child = built.find(childId);
+            children.append(std::move(child->second));
+            built.erase(child);
+        }
+        item["children"] = std::move(children);
+        built.emplace(*it, std::move(item));
+    }
+    for (auto rootId : tree.roots())
+        roots.append(std::move(built.at(rootId)));
+    return roots;
+}
+
+std::vector<uint32_t> CategoryTrees::subtreeOf(uint32_t categoryId) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto tenant = categoryTenant_.find(categoryId);
+    if (tenant == categoryTenant_.end())
+        return {};
+    auto tree = tenants_.find(tenant->second);
+    return tree == tenants_.end() ? std::vector<uint32_t>{} : tree->second.subtree(categoryId);
+}
@@ -0,0 +1,54 @@
+/**
+ *
+ *  CategoryTrees.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/orm/DbClient.h>
+#include <cstdint>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "CategoryTree.h"
+#include "DishCategory.h"
+
+/**
+ * @brief 菜品分类树，按租户常驻 CategoryTree。
+ *
+ * 启动时载入未删除的分类，之后分类增删改按主键重读该分类并重排所在租户的树。
+ * 按父分类筛选菜品时用先序区间取出整棵子树的分类ID，不再逐层查询。
+ */
+class CategoryTrees : public drogon::Plugin<CategoryTrees>
+{
+public:
+  CategoryTrees() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  void categoryChanged(uint32_t categoryId);
+
+  /// 租户的分类树 JSON 数组，每个分类带 children、depth、left/right 区间和 path
+  Json::Value treeOf(uint32_t tenantId) const;
+  /// 子树内的全部分类ID（含自身），分类不存在时为空
+  std::vector<uint32_t> subtreeOf(uint32_t categoryId) const;
+
+private:
+  void load();
+  void applyCategory(const drogon_model::saas_restaurant::DishCategory &category);
+  void unlist(uint32_t categoryId);
+
+  drogon::orm::DbClientPtr dbClient_;
+
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<uint32_t, CategoryTree> tenants_;
+  std::unordered_map<uint32_t, uint32_t> categoryTenant_; // 分类 -> 租户
+};
@@ -0,0 +1,289 @@
+/**
+ *
+ *  DishIndex.cc
+ *
+ */
+
+#include "DishIndex.h"
+#include "PinyinInitials.h"
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+constexpr size_t kMaxTerms = 8;
+
+bool isSeparator(char32_t ch)
+{
+    if (ch < 0x80)
+        return !((ch >= 'a' && ch <= 'z') || (ch >= '0' && ch <= '9'));
+    // 全角空格和中文标点、全角 ASCII 标点
+    return (ch >= 0x3000 && ch <= 0x303F) || (ch >= 0xFF00 && ch <= 0xFF0F) || (ch >= 0xFF1A && ch <= 0xFF20) ||
+           (ch >= 0xFF3B && ch <= 0xFF40) || (ch >= 0xFF5B && ch <= 0xFF65) || (ch >= 0x2000 && ch <= 0x206F);
+}
+} // namespace
+
+std::u32string DishIndex::normalize(std::string_view text)
+{
+    std::u32string result;
+    result.reserve(text.size());
+    auto push = [&result](char32_t ch)
+    {
+        if (ch >= 0xFF10 && ch <= 0xFF5A)
+            ch = ch - 0xFF10 + '0'; // 全角字母数字
+        if (ch >= 'A' && ch <= 'Z')
+            ch += 'a' - 'A';
+        if (isSeparator(ch))
+        {
+            if (!result.empty() && result.back() != 0)
+                result.push_back(0);
+            return;
+        }
+        result.push_back(ch);
+    };
+    for (size_t i = 0; i < text.size();)
+    {
+        auto lead = static_cast<unsigned char>(text[i]);
+        size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+        if (length == 0 || i + length > text.size())
+        {
+            push(0); // 非法字节当作分隔
+            ++i;
+            continue;
+        }
+        char32_t ch = length == 1 ? lead : lead & (0xFF >> (length + 1));
+        bool valid = true;
+        for (size_t k = 1; k < length; ++k)
+        {
+            auto next = static_cast<unsigned char>(text[i + k]);
+            if ((next & 0xC0) != 0x80)
+                valid = false;
+            ch = ch << 6 | (next & 0x3F);
+        }
+        i += valid ? length : 1;
+        push(valid ? ch : 0);
+    }
+    if (!result.empty() && result.back() == 0)
+        result.pop_back();
+    return result;
+}
+
+char32_t DishIndex::initialOf(char32_t ch)
+{
+    if (ch < pinyin::kFirst || ch > pinyin::kLast)
+        return 0;
+    auto letter = pinyin::kInitials[ch - pinyin::kFirst];
+    return letter == '_' ? 0 : static_cast<char32_t>(letter);
+}
+
+std::u32string DishIndex::initialsOf(const std::u32string &text)
+{
+    // 英文数字原样保留，没有首字母的汉字当作分隔
+    std::u32string initials;
+    initials.reserve(text.size());
+    for (auto ch : text)
+    {
+        auto mapped = ch < 0x80 ? ch : initialOf(ch);
+        if (mapped == 0 && (initials.empty() || initials.back() == 0))
+            continue;
+        initials.push_back(mapped);
+    }
+    if (!initials.empty() && initials.back() == 0)
+        initials.pop_back();
+    return initials;
+}
+
+uint64_t DishIndex::tokenOf(Field field, char32_t first, char32_t second)
+{
+    return static_cast<uint64_t>(field) << 42 | static_cast<uint64_t>(first) << 21 | second;
+}
+
+void DishIndex::tokenize(Field field, const std::u32string &text, std::vector<uint64_t> &tokens)
+{
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        if (text[i] == 0)
+            continue;
+        tokens.push_back(tokenOf(field, text[i], 0));
+        if (i + 1 < text.size() && text[i + 1] != 0)
+            tokens.push_back(tokenOf(field, text[i], text[i + 1]));
+    }
+}
+
+void DishIndex::unindex(const Doc &doc)
+{
+    std::vector<uint64_t> tokens;
+    for (uint8_t field = 0; field < FieldCount; ++field)
+        tokenize(static_cast<Field>(field), doc.fields[field], tokens);
+    std::sort(tokens.begin(), tokens.end());
+    tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+    for (auto token : tokens)
+    {
+        auto it = postings_.find(token);
+        if (it == postings_.end())
+            continue;
+        auto &list = it->second;
+        auto pos = std::lower_bound(list.begin(), list.end(), doc.dish.dishId);
+        if (pos != list.end() && *pos == doc.dish.dishId)
+            list.erase(pos);
+        if (list.empty())
+            postings_.erase(it);
+    }
+}
+
+void DishIndex::set(Dish dish)
+{
+    remove(dish.dishId);
+    auto dishId = dish.dishId;
+    auto &doc = docs_[dishId];
+    doc.dish = std::move(dish);
+    doc.fields[Name] = normalize(doc.dish.name);
+    doc.fields[Initials] = initialsOf(doc.fields[Name]);
+    doc.fields[Description] = normalize(doc.dish.description);
+
+    std::vector<uint64_t> tokens;
+    for (uint8_t field = 0; field < FieldCount; ++field)
+        tokenize(static_cast<Field>(field), doc.fields[field], tokens);
+    std::sort(tokens.begin(), tokens.end());
+    tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+    for (auto token : tokens)
+    {
+        auto &list = postings_[token];
+        list.insert(std::lower_bound(list.begin(), list.end(), dishId), dishId);
+    }
+}
+
+void DishIndex::remove(uint32_t dishId)
+{
+    auto it = docs_.find(dishId);
+    if (it == docs_.end())
+        return;
+    unindex(it->second);
+    docs_.erase(it);
+}
+
+std::vector<uint32_t> DishIndex::candidates(Field field, const std::u32string &term) const
+{
+    std::vector<const std::vector<uint32_t> *> lists;
+    if (term.size() == 1)
+    {
+        auto it = postings_.find(tokenOf(field, term[0], 0));
+        if (it == postings_.end())
+            return {};
+        return it->second;
+    }
+    for (size_t i = 0; i + 1 < term.size(); ++i)
+    {
+        auto it = postings_.find(tokenOf(field, term[i], term[i + 1]));
+        if (it == postings_.end())
+            return {};
+        lists.push_back(&it->second);
+    }
+    // 从最短的倒排表出发，逐个二分确认其余表中也有
+    std::sort(lists.begin(), lists.end(), [](auto a, auto b) { return a->size() < b->size(); });
+    std::vector<uint32_t> result;
+    for (auto dishId : *lists[0])
+    {
+        bool all = std::all_of(lists.begin() + 1, lists.end(), [dishId](const std::vector<uint32_t> *list)
+                               { return std::binary_search(list->begin(), list->end(), dishId); });
+        if (all)
+            result.push_back(dishId);
+    }
+    return result;
+}
+
+int32_t DishIndex::scoreOf(Field field, const std::u32string &text, const std::u32string &term)
+{
+    auto pos = text.find(term);
+    if (pos == std::u32string::npos)
+        return 0;
+    switch (field)
+    {
+    case Name:
+        if (text == term)
+            return 100;
+        if (pos == 0)
+            return 80;
+        return text[pos - 1] == 0 ? 70 : 60;
+    case Initials:
+        if (text == term)
+            return 55;
+        return pos == 0 ? 50 : 40;
+    default:
+        return 20;
+    }
+}
+
+std::vector<DishIndex::Hit> DishIndex::search(std::string_view query, size_t limit) const
+{
+    std::vector<std::u32string> terms;
+    auto normalized = normalize(query);
+    for (size_t start = 0; start < normalized.size() && terms.size() < kMaxTerms;)
+    {
+        auto end = normalized.find(char32_t(0), start);
+        if (end == std::u32string::npos)
+            end = normalized.size();
+        auto term = normalized.substr(start, end - start);
+        if (std::find(terms.begin(), terms.end(), term) == terms.end())
+            terms.push_back(std::move(term));
+        start = end + 1;
+    }
+    if (terms.empty() || limit == 0)
+        return {};
+
+    // 每个词取各字段中的最高分，所有词都命中才算匹配；得分表按菜品ID有序，便于二分求交
+    using Scored = std::pair<uint32_t, int32_t>;
+    std::vector<Scored> scores;
+    for (size_t t = 0; t < terms.size(); ++t)
+    {
+        const auto &term = terms[t];
+        std::vector<Scored> best;
+        for (uint8_t field = 0; field < FieldCount; ++field)
+        {
+            for (auto dishId : candidates(static_cast<Field>(field), term))
+            {
+                auto previous = std::lower_bound(scores.begin(), scores.end(), Scored{dishId, 0},
+                                                 [](const Scored &a, const Scored &b) { return a.first < b.first; });
+                if (t > 0 && (previous == scores.end() || previous->first != dishId))
+                    continue;
+                auto score = scoreOf(static_cast<Field>(field), docs_.at(dishId).fields[field], term);
+                if (score > 0)
+                    best.emplace_back(dishId, score + (t > 0 ? previous->second : 0));
+            }
+        }
+        // 同一菜品多个字段命中时取最高分
+        std::sort(best.begin(), best.end(), [](const Scored &a, const Scored &b)
+                  { return a.first != b.first ? a.first < b.first : a.second > b.second; });
+        best.erase(std::unique(best.begin(), best.end(), [](const Scored &a, const Scored &b)
+                               { return a.first == b.first; }),
+                   best.end());
+        scores.swap(best);
+        if (scores.empty())
+            return {};
+    }
+
+    std::vector<Hit> hits;
+    hits.reserve(scores.size());
+    for (const auto &[dishId, score] : scores)
+        hits.push_back(Hit{&docs_.at(dishId).dish, score});
+    auto before = [](const Hit &a, const Hit &b)
+    {
+        if (a.score != b.score)
+            return a.score > b.score;
+        if (a.dish->sortOrder != b.dish->sortOrder)
+            return a.dish->sortOrder > b.dish->sortOrder;
+        if (a.dish->sales != b.dish->sales)
+            return a.dish->sales > b.dish->sales;
+        return a.dish->dishId < b.dish->dishId;
+    };
+    if (hits.size() > limit)
+    {
+        std::partial_sort(hits.begin(), hits.begin() + static_cast<std::ptrdiff_t>(limit), hits.end(), before);
+        hits.resize(limit);
+    }
+    else
+    {
+        std::sort(hits.begin(), hits.end(), before);
+    }
+    return hits;
+}
@@ -0,0 +1,82 @@
+/**
+ *
+ *  DishIndex.h
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 单个租户的菜品全文检索倒排索引。
+ *
+ * 菜品名、拼音首字母、描述三个字段分别按字符切成单字和相邻二元组建倒排表（按菜品ID有序），
+ * 中文逐字切分，英文数字转小写后同样逐字符切分，空白和标点断开。
+ * 查询按空白拆成多个词，每个词取其二元组（单字时取单字）在同一字段内求交，再在候选菜品上核对是否真正连续出现；
+ * 全部词都命中的菜品按匹配程度、sort_order、销量排序。拼音首字母覆盖基本汉字区，查不到读音的字不参与。
+ * 不加锁，由调用方保证互斥。
+ */
+class DishIndex
+{
+public:
+  struct Dish
+  {
+    uint32_t dishId{0};
+    uint32_t categoryId{0};
+    std::string name;
+    std::string description;
+    std::string status;
+    std::string coverImg;
+    int64_t price{0}; // 分
+    int32_t sortOrder{0};
+    uint32_t sales{0};
+  };
+  struct Hit
+  {
+    const Dish *dish;
+    int32_t score;
+  };
+
+  void set(Dish dish);
+  void remove(uint32_t dishId);
+  /// 按匹配程度、sort_order、销量从高到低，最多 limit 个；返回的指针在下次修改前有效
+  std::vector<Hit> search(std::string_view query, size_t limit) const;
+  size_t size() const { return docs_.size(); }
+
+  /// 规范化后的字符序列：ASCII 转小写，空白和标点记为 0 作为分隔
+  static std::u32string normalize(std::string_view text);
+  /// 汉字的拼音首字母（小写），不在基本汉字区或查不到读音时返回 0
+  static char32_t initialOf(char32_t ch);
+  static std::u32string initialsOf(const std::u32string &text);
+
+private:
+  enum Field : uint8_t
+  {
+    Name,
+    Initials,
+    Description,
+    FieldCount
+  };
+  struct Doc
+  {
+    Dish dish;
+    std::u32string fields[FieldCount];
+  };
+
+  static uint64_t tokenOf(Field field, char32_t first, char32_t second);
+  static void tokenize(Field field, const std::u32string &text, std::vector<uint64_t> &tokens);
+  /// 单个查询词在一个字段上的得分，0 表示不匹配
+  static int32_t scoreOf(Field field, const std::u32string &text, const std::u32string &term);
+  /// 在 field 字段含有 term 全部二元组的菜品
+  std::vector<uint32_t> candidates(Field field, const std::u32string &term) const;
+  void unindex(const Doc &doc);
+
+  std::unordered_map<uint32_t, Doc> docs_;
+  std::unordered_map<uint64_t, std::vector<uint32_t>> postings_; // 令牌 -> 有序菜品ID
+};
@@ -0,0 +1,119 @@
+/**
+ *
+ *  DishSearch.cc
+ *
+ */
+
+#include "DishSearch.h"
+#include "Money.h"
+#include <drogon/drogon.h>
+#include <algorithm>
+#include <mutex>
+
+using namespace drogon;
+using namespace drogon::orm;
+using namespace drogon_model::saas_restaurant;
+
+void DishSearch::initAndStart(const Json::Value &config)
+{
+    dbClient_ = app().getDbClient(config.get("db_client", "default").asString());
+    maxLimit_ = std::max(config.get("max_limit", 100).asUInt(), 1u);
+    load();
+}
+
+void DishSearch::shutdown()
+{
+}
+
+void DishSearch::load()
+{
+    try
+    {
+        auto dishes = Mapper<Dish>(dbClient_).findBy(
+            Criteria(Dish::Cols::_is_deleted, CompareOperator::EQ, 0) ||
+            Criteria(Dish::Cols::_is_deleted, CompareOperator::IsNull));
+        for (const auto &dish : dishes)
+            applyDish(dish);
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        LOG_INFO << "Dish search loaded " << tenants_.size() << " tenants, " << dishTenant_.size() << " dishes";
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to load dish search index: " << e.base().what();
+    }
+}
+
+void DishSearch::unlist(uint32_t dishId)
+{
+    auto it = dishTenant_.find(dishId);
+    if (it == dishTenant_.end())
+        return;
+    auto index = tenants_.find(it->second);
+    if (index != tenants_.end())
+        index->second.remove(dishId);
+    dishTenant_.erase(it);
+}
+
+void DishSearch::applyDish(const Dish &dish)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto dishId = dish.getValueOfDishId();
+    unlist(dishId);
+    if (dish.getValueOfIsDeleted() == 1 || !dish.getTenantId())
+        return;
+    DishIndex::Dish entry;
+    entry.dishId = dishId;
+    entry.categoryId = dish.getValueOfDishCategoryId();
+    entry.name = dish.getValueOfDishName();
+    entry.description = dish.getValueOfDescription();
+    entry.status = dish.getValueOfStatus();
+    entry.coverImg = dish.getValueOfCoverImg();
+    entry.price = Money::fromString(dish.getValueOfDishPrice()).raw();
+    entry.sortOrder = dish.getValueOfSortOrder();
+    entry.sales = dish.getValueOfSales();
+    tenants_[dish.getValueOfTenantId()].set(std::move(entry));
+    dishTenant_[dishId] = dish.getValueOfTenantId();
+}
+
+void DishSearch::dishChanged(uint32_t dishId)
+{
+    Mapper<Dish>(dbClient_).findByPrimaryKey(
+        dishId,
+        [this](const Dish &dish) { applyDish(dish); },
+        [this, dishId](const DrogonDbException &e)
+        {
+            if (!dynamic_cast<const UnexpectedRows *>(&e.base()))
+            {
+                LOG_ERROR << "Failed to refresh dish " << dishId << " for search: " << e.base().what();
+                return;
+            }
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            unlist(dishId);
+        });
+}
+
+Json::Value DishSearch::search(uint32_t tenantId, const std::string &query, size_t limit) const
+{
+    Json::Value result(Json::arrayValue);
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto tenant = tenants_.find(tenantId);
+    if (tenant == tenants_.end())
+        return result;
+    for (const auto &hit : tenant->second.search(query, std::min(limit, maxLimit_)))
+    {
+        const auto &dish = *hit.dish;
+        Json::Value item;
+        item["dish_id"] = dish.dishId;
+        item["dish_category_id"] = dish.categoryId;
+        item["dish_name"] = dish.name;
+        item["dish_price"] = Money::fromRaw(dish.price).toJson();
+        item["description"] = dish.description;
+        item["status"] = dish.status;
+        item["cover_img"] = dish.coverImg;
+        item["sort_order"] = dish.sortOrder;
+        item["sales"] = dish.sales;
+        item["score"] = hit.score;
+        result.append(item);
+    }
+    return result;
+}
@@ -0,0 +1,53 @@
+/**
+ *
+ *  DishSearch.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/orm/DbClient.h>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include "Dish.h"
+#include "DishIndex.h"
+
+/**
+ * @brief 菜品全文检索，按租户常驻 DishIndex，查询只读内存。
+ *
+ * 启动时载入未删除的菜品，之后菜品增删改按主键重读该菜品。
+ */
+class DishSearch : public drogon::Plugin<DishSearch>
+{
+public:
+  DishSearch() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  void dishChanged(uint32_t dishId);
+
+  /// 命中的菜品 JSON 数组，按匹配程度、sort_order、销量排序
+  Json::Value search(uint32_t tenantId, const std::string &query, size_t limit) const;
+  size_t maxLimit() const { return maxLimit_; }
+
+private:
+  void load();
+  void applyDish(const drogon_model::saas_restaurant::Dish &dish);
+  void unlist(uint32_t dishId);
+
+  drogon::orm::DbClientPtr dbClient_;
+  size_t maxLimit_{100};
+
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<uint32_t, DishIndex> tenants_;
+  std::unordered_map<uint32_t, uint32_t> dishTenant_; // 菜品 -> 租户
+};
@@ -0,0 +1,49 @@
+/**
+ *
+ *  ExpiryBuckets.cc
+ *
+ */
+
+#include "ExpiryBuckets.h"
+
+void ExpiryBuckets::set(uint32_t memberId, int64_t expireAt, int32_t day)
+{
+    remove(memberId);
+    buckets_[day].emplace(expireAt, memberId);
+    members_[memberId] = Entry{expireAt, day};
+}
+
+void ExpiryBuckets::remove(uint32_t memberId)
+{
+    auto it = members_.find(memberId);
+    if (it == members_.end())
+        return;
+    auto bucket = buckets_.find(it->second.day);
+    if (bucket != buckets_.end())
+    {
+        bucket->second.erase({it->second.expireAt, memberId});
+        if (bucket->second.empty())
+            buckets_.erase(bucket);
+    }
+    members_.erase(it);
+}
+
+std::vector<std::pair<uint32_t, int64_t>> ExpiryBuckets::takeDue(int64_t now, int32_t today, size_t limit)
+{
+    std::vector<std::pair<uint32_t, int64_t>> due;
+    for (auto bucket = buckets_.begin(); bucket != buckets_.end() && bucket->first <= today && due.size() < limit;)
+    {
+        auto &entries = bucket->second;
+        while (!entries.empty() && due.size() < limit && entries.begin()->first <= now)
+        {
+            due.emplace_back(entries.begin()->second, entries.begin()->first);
+            members_.erase(entries.begin()->second);
+            entries.erase(entries.begin());
+        }
+        // 桶里还有会员时要么已取够，要么剩下的还没到时刻，之后的桶更晚
+        if (!entries.empty())
+            break;
+        bucket = buckets_.erase(bucket);
+    }
+    return due;
+}
@@ -0,0 +1,44 @@
+/**
+ *
+ *  ExpiryBuckets.h
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 按到期日分桶的到期队列。
+ *
+ * 每个到期日一个桶，桶内按到期时刻排序；到期扫描只看不晚于当天的桶，且只取桶内已到期的前缀，
+ * 不需要扫描全部会员。一个会员同一时刻只在一个桶中，重新设置时从旧桶移走。
+ */
+class ExpiryBuckets
+{
+public:
+  /// 设置会员的到期时刻（秒）和到期日
+  void set(uint32_t memberId, int64_t expireAt, int32_t day);
+  void remove(uint32_t memberId);
+  bool contains(uint32_t memberId) const { return members_.count(memberId) != 0; }
+  /// 取出最多 limit 个到期时刻不晚于 now 的会员，按到期时刻升序；today 为 now 所在的日
+  std::vector<std::pair<uint32_t, int64_t>> takeDue(int64_t now, int32_t today, size_t limit);
+  size_t size() const { return members_.size(); }
+  size_t bucketCount() const { return buckets_.size(); }
+
+private:
+  struct Entry
+  {
+    int64_t expireAt;
+    int32_t day;
+  };
+
+  std::map<int32_t, std::set<std::pair<int64_t, uint32_t>>> buckets_; // 到期日 -> (到期时刻, 会员)
+  std::unordered_map<uint32_t, Entry> members_;
+};
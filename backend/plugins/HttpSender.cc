@@ -0,0 +1,63 @@
+/**
+ *
+ *  HttpSender.cc
+ *
+ */
+
+#include "HttpSender.h"
+#include <drogon/drogon.h>
+#include <unordered_set>
+
+using namespace drogon;
+
+HttpSender::HttpSender(const std::string &url, trantor::EventLoop *loop, double timeout) : timeout_(timeout)
+{
+    auto scheme = url.find("://");
+    auto slash = url.find('/', scheme == std::string::npos ? 0 : scheme + 3);
+    client_ = HttpClient::newHttpClient(url.substr(0, slash), loop);
+    path_ = slash == std::string::npos ? "/" : url.substr(slash);
+}
+
+void HttpSender::send(const std::vector<BroadcastDelivery> &batch, std::vector<Outcome> &outcomes)
+{
+    Json::Value body;
+    body["messages"] = Json::arrayValue;
+    for (const auto &delivery : batch)
+    {
+        Json::Value message;
+        message["delivery_id"] = static_cast<Json::UInt64>(delivery.deliveryId);
+        message["member_id"] = delivery.memberId;
+        message["address"] = delivery.address;
+        message["content"] = delivery.content;
+        body["messages"].append(message);
+    }
+    auto req = HttpRequest::newHttpJsonRequest(body);
+    req->setMethod(Post);
+    req->setPath(path_);
+    auto [result, resp] = client_->sendRequest(req, timeout_);
+    auto status = resp ? static_cast<int>(resp->getStatusCode()) : 0;
+    if (result != ReqResult::Ok || !resp || status == 429 || status >= 500)
+    {
+        outcomes.assign(batch.size(), Outcome::Retry);
+        return;
+    }
+    if (status >= 300)
+    {
+        LOG_WARN << "Broadcast gateway rejected batch with status " << status;
+        outcomes.assign(batch.size(), Outcome::Rejected);
+        return;
+    }
+    std::unordered_set<uint64_t> rejected;
+    auto json = resp->getJsonObject();
+    if (json && (*json)["rejected"].isArray())
+    {
+        for (const auto &id : (*json)["rejected"])
+        {
+            if (id.isUInt64())
+                rejected.insert(id.asUInt64());
+        }
+    }
+    outcomes.clear();
+    for (const auto &delivery : batch)
+        outcomes.push_back(rejected.count(delivery.deliveryId) ? Outcome::Rejected : Outcome::Sent);
+}
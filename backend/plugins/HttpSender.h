@@ -0,0 +1,32 @@
+/**
+ *
+ *  HttpSender.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/HttpClient.h>
+#include <string>
+#include <vector>
+
+#include "BroadcastPump.h"
+
+/**
+ * @brief 群发的 HTTP 渠道：向网关 POST {"messages": [...]}。
+ *
+ * 2xx 为成功，响应体 rejected 中列出的 delivery_id 不再重试；429、5xx、超时和连不上整批重试，其余 4xx 整批放弃。
+ * 在投递线程中同步等待响应，请求本身跑在构造时给定的事件循环上。
+ */
+class HttpSender : public BroadcastSender
+{
+public:
+  /// url 形如 http://host:port/path，loop 不能是调用 send 的线程的事件循环
+  HttpSender(const std::string &url, trantor::EventLoop *loop, double timeout);
+  void send(const std::vector<BroadcastDelivery> &batch, std::vector<Outcome> &outcomes) override;
+
+private:
+  drogon::HttpClientPtr client_;
+  std::string path_;
+  double timeout_;
+};
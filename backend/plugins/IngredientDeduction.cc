@@ -0,0 +1,573 @@
+/**
+ *
+ *  IngredientDeduction.cc
+ *
+ */
+
+#include "IngredientDeduction.h"
+#include "InventoryLedger.h"
+#include "DishIngredient.h"
+#include "InventoryRecord.h"
+#include "OrderFlow.h"
+#include <drogon/drogon.h>
+#include <algorithm>
+#include <future>
+#include <memory>
+
+using namespace drogon;
+using namespace drogon::orm;
+using namespace drogon_model::saas_restaurant;
+
+namespace
+{
+Criteria notDeleted()
+{
+    return Criteria(DishIngredient::Cols::_is_deleted, CompareOperator::EQ, 0) ||
+           Criteria(DishIngredient::Cols::_is_deleted, CompareOperator::IsNull);
+}
+
+uint32_t toId(const Json::Value &value)
+{
+    if (value.isString())
+        return static_cast<uint32_t>(std::stoul(value.asString()));
+    return value.asUInt();
+}
+
+// 发件箱中的物料用量：{"物料ID": 数量}
+std::string usageText(const std::map<uint32_t, int64_t> &usage)
+{
+    Json::Value json(Json::objectValue);
+    for (auto &[itemId, quantity] : usage)
+        json[std::to_string(itemId)] = static_cast<Json::Int64>(quantity);
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    return Json::writeString(builder, json);
+}
+
+bool parseUsage(const std::string &text, std::map<uint32_t, int64_t> &usage)
+{
+    Json::Value json;
+    std::string errs;
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    if (!reader->parse(text.data(), text.data() + text.size(), &json, &errs) || !json.isObject())
+        return false;
+    try
+    {
+        for (const auto &key : json.getMemberNames())
+        {
+            auto quantity = json[key].asInt64();
+            if (quantity > 0)
+                usage[static_cast<uint32_t>(std::stoul(key))] += quantity;
+        }
+    }
+    catch (const std::exception &)
+    {
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+void IngredientDeduction::initAndStart(const Json::Value &config)
+{
+    dbClient_ = app().getDbClient(config.get("db_client", "default").asString());
+    flushInterval_ = config.get("flush_interval", 1.0).asDouble();
+    maxRowsPerInsert_ = config.get("max_rows_per_insert", 500).asUInt();
+    if (maxRowsPerInsert_ == 0)
+        maxRowsPerInsert_ = 1;
+    recoverWindow_ = config.get("recover_window", 600.0).asDouble();
+
+    load();
+    recover();
+
+    // 合并一个周期内的订单后统一写库；写库在专用线程同步进行
+    flushLoop_.run();
+    if (flushInterval_ > 0)
+        timerId_ = flushLoop_.getLoop()->runEvery(flushInterval_, [this]() { flush(); });
+}
+
+void IngredientDeduction::shutdown()
+{
+    // 等正在进行的写入结束，再在当前线程写完剩余的
+    flushLoop_.getLoop()->invalidateTimer(timerId_);
+    flushLoop_.getLoop()->quit();
+    flushLoop_.wait();
+    flush();
+}
+
+void IngredientDeduction::load()
+{
+    try
+    {
+        auto ingredients = Mapper<DishIngredient>(dbClient_).findBy(notDeleted());
+        std::lock_guard<std::mutex> lock(recipeMutex_);
+        recipes_.clear();
+        ingredientDishes_.clear();
+        for (auto &ingredient : ingredients)
+        {
+            auto dishId = ingredient.getValueOfDishId();
+            recipes_[dishId].push_back({ingredient.getValueOfIngredientId(),
+                                        ingredient.getValueOfItemId(),
+                                        ingredient.getValueOfQuantity()});
+            ingredientDishes_[ingredient.getValueOfIngredientId()] = dishId;
+        }
+        LOG_INFO << "Ingredient deduction loaded " << ingredients.size() << " recipe lines of "
+                 << recipes_.size() << " dishes";
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to load dish ingredients: " << e.base().what();
+    }
+}
+
+void IngredientDeduction::recover()
+{
+    try
+    {
+        // 订单已提交、发件箱还没写入时崩溃：按下单时间补扫，订单明细重新展开
+        if (recoverWindow_ > 0)
+        {
+            auto orders = dbClient_->execSqlSync(
+                "select o.order_id, o.tenant_id, o.order_detail from order_table o "
+                "left join ingredient_deduction d on d.order_id = o.order_id "
+                "where d.order_id is null and o.created_at >= date_sub(now(), interval ? second) "
+                "and (o.order_status is null or o.order_status <> '已取消')",
+                static_cast<int64_t>(recoverWindow_));
+            size_t restored = 0;
+            for (const auto &row : orders)
+            {
+                auto orderId = row["order_id"].as<uint32_t>();
+                std::map<uint32_t, int64_t> usage;
+                {
+                    std::lock_guard<std::mutex> lock(recipeMutex_);
+                    if (row["order_detail"].isNull() ||
+                        !expandLocked(orderId, row["order_detail"].as<std::string>(), usage))
+                        continue;
+                }
+                dbClient_->execSqlSync(
+                    "insert ignore into ingredient_deduction (order_id, tenant_id, item_usage) values (?, ?, ?)",
+                    orderId,
+                    row["tenant_id"].isNull() ? 0u : row["tenant_id"].as<uint32_t>(),
+                    usageText(usage));
+                ++restored;
+            }
+            if (restored > 0)
+                LOG_WARN << "Ingredient deduction restored " << restored << " orders missing from the outbox";
+        }
+
+        // 上次未扣减的发件箱记录
+        auto rows = dbClient_->execSqlSync(
+            "select order_id, tenant_id, item_usage from ingredient_deduction where deducted_at is null order by order_id");
+        for (const auto &row : rows)
+        {
+            std::map<uint32_t, int64_t> usage;
+            if (!parseUsage(row["item_usage"].as<std::string>(), usage))
+            {
+                LOG_WARN << "Invalid item_usage in ingredient_deduction of order " << row["order_id"].as<uint32_t>();
+                continue;
+            }
+            enqueue(row["tenant_id"].isNull() ? 0u : row["tenant_id"].as<uint32_t>(),
+                    row["order_id"].as<uint32_t>(),
+                    usage);
+        }
+        if (rows.size() > 0)
+            LOG_INFO << "Ingredient deduction resumed " << rows.size() << " pending orders";
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to recover ingredient deductions: " << e.base().what();
+    }
+}
+
+void IngredientDeduction::reloadDish(uint32_t dishId)
+{
+    Mapper<DishIngredient> mapper(dbClient_);
+    mapper.findBy(
+        Criteria(DishIngredient::Cols::_dish_id, CompareOperator::EQ, dishId) && notDeleted(),
+        [this, dishId](const std::vector<DishIngredient> &ingredients)
+        {
+            std::lock_guard<std::mutex> lock(recipeMutex_);
+            auto &recipe = recipes_[dishId];
+            for (auto &component : recipe)
+                ingredientDishes_.erase(component.ingredientId);
+            recipe.clear();
+            for (auto &ingredient : ingredients)
+            {
+                recipe.push_back({ingredient.getValueOfIngredientId(),
+                                  ingredient.getValueOfItemId(),
+                                  ingredient.getValueOfQuantity()});
+                ingredientDishes_[ingredient.getValueOfIngredientId()] = dishId;
+            }
+            if (recipe.empty())
+                recipes_.erase(dishId);
+        },
+        [dishId](const DrogonDbException &e)
+        {
+            LOG_ERROR << "Failed to reload ingredients of dish " << dishId << ": " << e.base().what();
+        });
+}
+
+void IngredientDeduction::ingredientChanged(uint32_t ingredientId)
+{
+    uint32_t oldDishId = 0;
+    {
+        std::lock_guard<std::mutex> lock(recipeMutex_);
+        auto it = ingredientDishes_.find(ingredientId);
+        if (it != ingredientDishes_.end())
+            oldDishId = it->second;
+    }
+    Mapper<DishIngredient> mapper(dbClient_);
+    mapper.findByPrimaryKey(
+        ingredientId,
+        [this, oldDishId](const DishIngredient &ingredient)
+        {
+            // 配方改挂到其他菜品时两边都要重载
+            auto dishId = ingredient.getValueOfDishId();
+            reloadDish(dishId);
+            if (oldDishId != 0 && oldDishId != dishId)
+                reloadDish(oldDishId);
+        },
+        [this, ingredientId, oldDishId](const DrogonDbException &e)
+        {
+            if (dynamic_cast<const UnexpectedRows *>(&e.base()))
+            {
+                // 配方已被物理删除
+                if (oldDishId != 0)
+                    reloadDish(oldDishId);
+                return;
+            }
+            LOG_ERROR << "Failed to refresh ingredient " << ingredientId << ": " << e.base().what();
+        });
+}
+
+bool IngredientDeduction::expandLocked(uint32_t orderId,
+                                       const std::string &orderDetail,
+                                       std::map<uint32_t, int64_t> &usage) const
+{
+    Json::Value detail;
+    std::string errs;
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    if (orderDetail.empty() || !reader->parse(orderDetail.data(), orderDetail.data() + orderDetail.size(), &detail, &errs))
+    {
+        LOG_WARN << "Order " << orderId << " has no valid order_detail, skip deduction";
+        return false;
+    }
+    const auto &lines = detail.isArray() ? detail : detail["items"];
+    if (!lines.isArray())
+        return false;
+    try
+    {
+        for (auto &line : lines)
+        {
+            auto recipe = recipes_.find(toId(line["dish_id"]));
+            if (recipe == recipes_.end())
+                continue;
+            int64_t portions = line.get("quantity", 1).asInt64();
+            if (portions <= 0)
+                continue;
+            for (auto &component : recipe->second)
+            {
+                if (component.quantity > 0)
+                    usage[component.itemId] += component.quantity * portions;
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        LOG_WARN << "Invalid order_detail of order " << orderId << ": " << e.what();
+        return false;
+    }
+    return !usage.empty();
+}
+
+void IngredientDeduction::deductOrder(const OrderTable &order)
+{
+    auto orderId = order.getValueOfOrderId();
+    auto tenantId = order.getValueOfTenantId();
+    std::map<uint32_t, int64_t> usage;
+    {
+        std::lock_guard<std::mutex> lock(recipeMutex_);
+        if (!expandLocked(orderId, order.getValueOfOrderDetail(), usage))
+            return;
+    }
+
+    // 先落发件箱再进内存，进程崩溃后可从发件箱重做；重复调用时发件箱已有记录，不再累加
+    dbClient_->execSqlAsync(
+        "insert ignore into ingredient_deduction (order_id, tenant_id, item_usage) values (?, ?, ?)",
+        [this, tenantId, orderId, usage](const Result &r)
+        {
+            if (r.affectedRows() == 0)
+                return;
+            enqueue(tenantId, orderId, usage);
+            if (flushInterval_ <= 0)
+                flushLoop_.getLoop()->queueInLoop([this]() { flush(); });
+        },
+        [orderId](const DrogonDbException &e)
+        {
+            // 启动时按 recover_window 补扫
+            LOG_ERROR << "Failed to queue deduction of order " << orderId << ": " << e.base().what();
+        },
+        orderId,
+        tenantId,
+        usageText(usage));
+}
+
+void IngredientDeduction::orderChanged(uint32_t orderId)
+{
+    Mapper<OrderTable> mapper(dbClient_);
+    mapper.findByPrimaryKey(
+        orderId,
+        [this, orderId](const OrderTable &order)
+        {
+            OrderFlow::Status status;
+            if (OrderFlow::parse(order.getValueOfOrderStatus(), status) && status == OrderFlow::Status::Cancelled)
+                restoreOrder(orderId);
+        },
+        [orderId](const DrogonDbException &e)
+        {
+            LOG_ERROR << "Failed to read status of order " << orderId << ": " << e.base().what();
+        });
+}
+
+void IngredientDeduction::restoreOrder(uint32_t orderId)
+{
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        restoring_.push_back(orderId);
+    }
+    if (flushInterval_ <= 0)
+        flushLoop_.getLoop()->queueInLoop([this]() { flush(); });
+}
+
+void IngredientDeduction::enqueue(uint32_t tenantId, uint32_t orderId, const std::map<uint32_t, int64_t> &usage)
+{
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    auto &pending = pending_[tenantId];
+    for (auto &[itemId, quantity] : usage)
+        pending.items[itemId] += quantity;
+    pending.orderIds.push_back(orderId);
+}
+
+void IngredientDeduction::flush()
+{
+    std::map<uint32_t, Pending> pending;
+    std::vector<uint32_t> requeueing;
+    std::vector<uint32_t> restoring;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        pending.swap(pending_);
+        requeueing.swap(requeueing_);
+        restoring.swap(restoring_);
+    }
+    // 上个周期写库失败的订单进入本周期之后的批次
+    if (!requeueing.empty() && !requeue(requeueing))
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        requeueing_.insert(requeueing_.end(), requeueing.begin(), requeueing.end());
+    }
+    for (auto &[tenantId, tenantPending] : pending)
+    {
+        if (writeTenant(tenantId, tenantPending))
+            continue;
+        // 事务可能已经提交，不直接放回用量，下个周期按发件箱中仍未扣减的订单重新装载
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        requeueing_.insert(requeueing_.end(), tenantPending.orderIds.begin(), tenantPending.orderIds.end());
+    }
+    for (auto orderId : restoring)
+    {
+        if (writeRestore(orderId))
+            continue;
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        restoring_.push_back(orderId);
+    }
+}
+
+bool IngredientDeduction::requeue(const std::vector<uint32_t> &orderIds)
+{
+    Result rows(nullptr);
+    try
+    {
+        std::string sql = "select order_id, tenant_id, item_usage from ingredient_deduction "
+                          "where deducted_at is null and order_id in (";
+        for (size_t i = 0; i < orderIds.size(); ++i)
+            sql += i == 0 ? "?" : ", ?";
+        sql += ") order by order_id";
+        auto binder = *dbClient_ << std::move(sql);
+        for (auto orderId : orderIds)
+            binder << orderId;
+        binder << Mode::Blocking;
+        binder >> [&rows](const Result &r) { rows = r; };
+        binder.exec();
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to requeue " << orderIds.size() << " deductions: " << e.base().what();
+        return false;
+    }
+    for (const auto &row : rows)
+    {
+        std::map<uint32_t, int64_t> usage;
+        if (!parseUsage(row["item_usage"].as<std::string>(), usage))
+        {
+            LOG_WARN << "Invalid item_usage in ingredient_deduction of order " << row["order_id"].as<uint32_t>();
+            continue;
+        }
+        enqueue(row["tenant_id"].isNull() ? 0u : row["tenant_id"].as<uint32_t>(), row["order_id"].as<uint32_t>(), usage);
+    }
+    return true;
+}
+
+std::vector<InventoryRecord> IngredientDeduction::insertRecords(const std::shared_ptr<Transaction> &transaction,
+                                                                uint32_t tenantId,
+                                                                const std::string &recordType,
+                                                                const std::map<uint32_t, int64_t> &items,
+                                                                const std::string &remark) const
+{
+    std::vector<std::pair<uint32_t, int64_t>> rows(items.begin(), items.end());
+    uint64_t firstId = 0;
+    for (size_t begin = 0; begin < rows.size(); begin += maxRowsPerInsert_)
+    {
+        auto end = std::min(rows.size(), begin + maxRowsPerInsert_);
+        std::string sql = "insert into inventory_record (record_type, quantity, item_id, tenant_id, remark) values ";
+        for (size_t i = begin; i < end; ++i)
+            sql += i == begin ? "(?, ?, ?, ?, ?)" : ", (?, ?, ?, ?, ?)";
+        auto binder = *transaction << std::move(sql);
+        for (size_t i = begin; i < end; ++i)
+            binder << recordType << std::to_string(rows[i].second) << rows[i].first << tenantId << remark;
+        binder << Mode::Blocking;
+        binder >> [&firstId](const Result &r)
+        {
+            if (firstId == 0)
+                firstId = r.insertId();
+        };
+        binder.exec(); // 失败时抛出异常，事务自动回滚
+    }
+
+    // 读回本批流水：不假定多行 insert 的自增 ID 连续，备注中含订单号，批次之间不会重复
+    return Mapper<InventoryRecord>(transaction)
+        .orderBy(InventoryRecord::Cols::_record_id)
+        .findBy(Criteria(InventoryRecord::Cols::_record_id, CompareOperator::GE, firstId) &&
+                Criteria(InventoryRecord::Cols::_tenant_id, CompareOperator::EQ, tenantId) &&
+                Criteria(InventoryRecord::Cols::_remark, CompareOperator::EQ, remark));
+}
+
+bool IngredientDeduction::writeTenant(uint32_t tenantId, const Pending &pending)
+{
+    std::string remark = "订单自动扣减：";
+    for (size_t i = 0; i < pending.orderIds.size() && i < 20; ++i)
+    {
+        if (i > 0)
+            remark += ",";
+        remark += "#" + std::to_string(pending.orderIds[i]);
+    }
+    if (pending.orderIds.size() > 20)
+        remark += " 等" + std::to_string(pending.orderIds.size()) + "单";
+
+    std::vector<InventoryRecord> records;
+    auto committed = std::make_shared<std::promise<bool>>();
+    auto future = committed->get_future();
+    try
+    {
+        auto transaction = dbClient_->newTransaction([committed](bool success) { committed->set_value(success); });
+        // 先标记发件箱：有订单已被扣减过（上次提交结果未知时）就整批回滚，由 requeue 重新装载
+        std::string sql = "update ingredient_deduction set deducted_at = now() where deducted_at is null and order_id in (";
+        for (size_t i = 0; i < pending.orderIds.size(); ++i)
+            sql += i == 0 ? "?" : ", ?";
+        sql += ")";
+        auto binder = *transaction << std::move(sql);
+        for (auto orderId : pending.orderIds)
+            binder << orderId;
+        binder << Mode::Blocking;
+        size_t marked = 0;
+        binder >> [&marked](const Result &r) { marked = r.affectedRows(); };
+        binder.exec();
+        if (marked != pending.orderIds.size())
+        {
+            LOG_WARN << "Deduction of tenant " << tenantId << " found " << pending.orderIds.size() - marked
+                     << " orders already deducted";
+            transaction->rollback();
+            return false;
+        }
+
+        records = insertRecords(transaction, tenantId, "出库", pending.items, remark);
+        if (records.size() != pending.items.size())
+        {
+            LOG_ERROR << "Deduction of tenant " << tenantId << " read back " << records.size() << " of "
+                      << pending.items.size() << " records";
+            transaction->rollback();
+            return false;
+        }
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to deduct " << pending.items.size() << " items of tenant " << tenantId << ": "
+                  << e.base().what();
+        return false;
+    }
+
+    // 事务在 transaction 释放时提交，等提交结果，不设超时：超时后重试可能与仍在进行的提交重复扣减
+    if (!future.get())
+    {
+        LOG_ERROR << "Failed to commit deduction of tenant " << tenantId;
+        return false;
+    }
+    app().getPlugin<InventoryLedger>()->appendBatch(records);
+    LOG_DEBUG << "Deducted " << records.size() << " items of tenant " << tenantId;
+    return true;
+}
+
+bool IngredientDeduction::writeRestore(uint32_t orderId)
+{
+    std::vector<InventoryRecord> records;
+    auto committed = std::make_shared<std::promise<bool>>();
+    auto future = committed->get_future();
+    try
+    {
+        auto transaction = dbClient_->newTransaction([committed](bool success) { committed->set_value(success); });
+        // 锁住发件箱记录，与扣减批次串行
+        auto rows = transaction->execSqlSync(
+            "select tenant_id, item_usage, restored_at from ingredient_deduction where order_id = ? for update", orderId);
+        if (rows.empty())
+        {
+            // 还没进发件箱：写一条已回补的占位记录，之后到达的下单扣减被 insert ignore 忽略
+            transaction->execSqlSync("insert ignore into ingredient_deduction (order_id, tenant_id, item_usage, deducted_at, "
+                                     "restored_at) values (?, 0, '{}', now(), now())",
+                                     orderId);
+        }
+        else if (rows[0]["restored_at"].isNull())
+        {
+            auto tenantId = rows[0]["tenant_id"].isNull() ? 0u : rows[0]["tenant_id"].as<uint32_t>();
+            std::map<uint32_t, int64_t> usage;
+            if (parseUsage(rows[0]["item_usage"].as<std::string>(), usage) && !usage.empty())
+            {
+                // 发件箱里还没扣减的也回补：扣减批次迟早写出库，两边相抵
+                records = insertRecords(transaction, tenantId, "入库", usage, "订单取消回补：#" + std::to_string(orderId));
+                if (records.size() != usage.size())
+                {
+                    LOG_ERROR << "Restore of order " << orderId << " read back " << records.size() << " of "
+                              << usage.size() << " records";
+                    transaction->rollback();
+                    return false;
+                }
+            }
+            transaction->execSqlSync("update ingredient_deduction set restored_at = now() where order_id = ?", orderId);
+        }
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to restore stock of order " << orderId << ": " << e.base().what();
+        return false;
+    }
+
+    if (!future.get())
+    {
+        LOG_ERROR << "Failed to commit stock restore of order " << orderId;
+        return false;
+    }
+    if (!records.empty())
+        app().getPlugin<InventoryLedger>()->appendBatch(records);
+    LOG_DEBUG << "Restored " << records.size() << " items of order " << orderId;
+    return true;
+}
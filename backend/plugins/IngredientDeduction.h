@@ -0,0 +1,104 @@
+/**
+ *
+ *  IngredientDeduction.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/orm/DbClient.h>
+#include <trantor/net/EventLoopThread.h>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "InventoryRecord.h"
+#include "OrderTable.h"
+
+/**
+ * @brief 按菜品配方（dish_ingredient）自动扣减库存。
+ *
+ * 配方常驻内存。下单时把订单明细展开为物料用量，先写入 ingredient_deduction 待扣减表（发件箱），
+ * 再按 (租户, 物料) 累加到内存，定时在专用线程批量写入：同一事务内用多行 insert 写出库流水、
+ * 读回这些流水、标记发件箱已扣减，提交后由 InventoryLedger 用一条语句回写各物料数量。
+ * 进程崩溃时未扣减的发件箱记录在下次启动时重做，下单后还没来得及写发件箱的订单按 recover_window 补扫。
+ * 写库失败的批次按发件箱中仍未扣减的订单重新装载，不会重复扣减。
+ * 订单取消或删除后按发件箱中的用量写入库流水回补，restored_at 保证只回补一次。
+ */
+class IngredientDeduction : public drogon::Plugin<IngredientDeduction>
+{
+public:
+  IngredientDeduction() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  /// 订单创建成功后调用，明细格式：{"items": [{"dish_id": 1, "quantity": 2}, ...]}
+  void deductOrder(const drogon_model::saas_restaurant::OrderTable &order);
+  /// 订单修改后调用，回读状态，已取消时回补库存
+  void orderChanged(uint32_t orderId);
+  /// 订单删除后调用，回补库存
+  void restoreOrder(uint32_t orderId);
+
+  /// 配方记录新增、修改或删除后调用，重新加载相关菜品的配方
+  void ingredientChanged(uint32_t ingredientId);
+  void reloadDish(uint32_t dishId);
+
+  /// 在调用线程同步写入待扣减的物料用量，失败的留待下次
+  void flush();
+
+private:
+  struct Component
+  {
+    uint32_t ingredientId;
+    uint32_t itemId;
+    int64_t quantity; // 每份菜品的用量
+  };
+  struct Pending
+  {
+    std::map<uint32_t, int64_t> items; // 物料ID -> 待扣减数量
+    std::vector<uint32_t> orderIds;
+  };
+
+  void load();
+  /// 重做上次未完成的扣减：补写漏掉的发件箱记录，再装载未扣减的记录
+  void recover();
+  /// 按配方把订单明细展开为物料用量，调用方持有 recipeMutex_
+  bool expandLocked(uint32_t orderId, const std::string &orderDetail, std::map<uint32_t, int64_t> &usage) const;
+  void enqueue(uint32_t tenantId, uint32_t orderId, const std::map<uint32_t, int64_t> &usage);
+  /// 一个事务内写出库流水并标记发件箱，成功返回 true
+  bool writeTenant(uint32_t tenantId, const Pending &pending);
+  /// 写库失败后，从发件箱重新装载这些订单中仍未扣减的，装载失败返回 false
+  bool requeue(const std::vector<uint32_t> &orderIds);
+  /// 一个事务内按发件箱用量写入库流水并标记已回补，成功返回 true
+  bool writeRestore(uint32_t orderId);
+  /// 在事务中批量写流水并读回，失败时抛出异常
+  std::vector<drogon_model::saas_restaurant::InventoryRecord> insertRecords(
+      const std::shared_ptr<drogon::orm::Transaction> &transaction,
+      uint32_t tenantId,
+      const std::string &recordType,
+      const std::map<uint32_t, int64_t> &items,
+      const std::string &remark) const;
+
+  drogon::orm::DbClientPtr dbClient_;
+  double flushInterval_{1.0};
+  size_t maxRowsPerInsert_{500};
+  double recoverWindow_{600.0};
+  trantor::EventLoopThread flushLoop_{"IngredientDeduction"}; // 同步写库，不占用主循环
+  trantor::TimerId timerId_{0};
+
+  mutable std::mutex recipeMutex_;
+  std::unordered_map<uint32_t, std::vector<Component>> recipes_; // 菜品ID -> 配方
+  std::unordered_map<uint32_t, uint32_t> ingredientDishes_;      // 配方ID -> 菜品ID
+
+  std::mutex pendingMutex_;
+  std::map<uint32_t, Pending> pending_; // 租户ID -> 待扣减
+  std::vector<uint32_t> requeueing_;    // 写库失败、待从发件箱重新装载的订单
+  std::vector<uint32_t> restoring_;     // 待回补的订单
+};
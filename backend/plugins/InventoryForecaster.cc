@@ -0,0 +1,344 @@
+/**
+ *
+ *  InventoryForecaster.cc
+ *
+ */
+
+#include "InventoryForecaster.h"
+#include "Inventory.h"
+#include <drogon/drogon.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace drogon;
+using namespace drogon::orm;
+using namespace drogon_model::saas_restaurant;
+
+void InventoryForecaster::initAndStart(const Json::Value &config)
+{
+    dbClient_ = app().getDbClient(config.get("db_client", "default").asString());
+    alpha_ = config.get("alpha", 0.3).asDouble();
+    windowDays_ = config.get("window_days", 90).asInt();
+    leadTimeDays_ = config.get("lead_time_days", 3.0).asDouble();
+    batchHour_ = config.get("batch_hour", 3).asInt();
+    batchQueue_ = std::make_unique<trantor::ConcurrentTaskQueue>(config.get("batch_threads", 4).asUInt(),
+                                                                 "InventoryForecaster");
+
+    auto ledger = app().getPlugin<InventoryLedger>();
+    ledger->addMovementListener([this](uint32_t tenantId, uint32_t itemId, const InventoryLedger::Movement &movement)
+                                {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto tenant = tenants_.find(tenantId);
+        if (tenant == tenants_.end())
+            return;
+        auto item = tenant->second.find(itemId);
+        if (item == tenant->second.end())
+            return;
+        addMovement(item->second, movement);
+        derive(item->second); });
+    ledger->addListener([this](uint32_t tenantId, uint32_t itemId, int64_t quantity)
+                        {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto tenant = tenants_.find(tenantId);
+        if (tenant == tenants_.end())
+            return;
+        auto item = tenant->second.find(itemId);
+        if (item == tenant->second.end())
+            return;
+        item->second.quantity = quantity;
+        derive(item->second); });
+
+    runBatch();
+    scheduleBatch();
+}
+
+void InventoryForecaster::shutdown()
+{
+    app().getLoop()->invalidateTimer(timerId_);
+    batchQueue_.reset();
+}
+
+int64_t InventoryForecaster::dayOf(int64_t at)
+{
+    // 按本地自然日分桶，加半天避免夏令时切换造成的偏差
+    auto midnight = trantor::Date(at).roundDay().microSecondsSinceEpoch();
+    return (midnight + 43200LL * 1000000) / (86400LL * 1000000);
+}
+
+void InventoryForecaster::roll(ItemForecast &item, int64_t day) const
+{
+    if (item.day < 0)
+    {
+        item.day = day;
+        return;
+    }
+    if (day <= item.day)
+        return;
+    // 把当前统计日并入平滑值，中间没有出库的日子按 0 计
+    if (item.seeded)
+        item.smoothedOutflow = alpha_ * item.dayOutflow + (1 - alpha_) * item.smoothedOutflow;
+    else
+        item.smoothedOutflow = item.dayOutflow;
+    item.seeded = true;
+    auto idleDays = day - item.day - 1;
+    if (idleDays > 0)
+        item.smoothedOutflow *= std::pow(1 - alpha_, static_cast<double>(idleDays));
+    item.dayOutflow = 0;
+    item.day = day;
+}
+
+void InventoryForecaster::addMovement(ItemForecast &item, const InventoryLedger::Movement &movement) const
+{
+    if (movement.recordId != 0 && movement.recordId <= item.lastRecordId)
+        return;
+    item.lastRecordId = std::max(item.lastRecordId, movement.recordId);
+    // 只统计出库
+    if (movement.delta >= 0)
+        return;
+    roll(item, dayOf(movement.at));
+    item.dayOutflow += static_cast<double>(-movement.delta);
+}
+
+void InventoryForecaster::derive(ItemForecast &item) const
+{
+    // 当天出库已超过平滑值时以当天为准，偏向提前预警
+    item.dailyUsage = item.seeded ? std::max(item.smoothedOutflow, item.dayOutflow) : item.dayOutflow;
+    if (item.dailyUsage > 0)
+        item.daysUntilStockout = static_cast<double>(std::max<int64_t>(item.quantity, 0)) / item.dailyUsage;
+    else
+        item.daysUntilStockout = -1;
+
+    // 到货前的消耗会让库存跌破最小值时，补到最大值
+    int64_t target = item.maxStock > item.minStock ? item.maxStock : item.minStock;
+    bool reorder = item.quantity - item.dailyUsage * leadTimeDays_ <= item.minStock;
+    item.reorderQuantity = reorder ? std::max<int64_t>(target - item.quantity, 0) : 0;
+}
+
+void InventoryForecaster::refreshItem(uint32_t itemId)
+{
+    Mapper<Inventory> mapper(dbClient_);
+    mapper.findByPrimaryKey(
+        itemId,
+        [this](const Inventory &inventory)
+        {
+            auto itemId = inventory.getValueOfInventoryId();
+            if (inventory.getValueOfIsDeleted())
+            {
+                removeItem(itemId);
+                return;
+            }
+            auto ledger = app().getPlugin<InventoryLedger>();
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto owner = itemTenants_.find(itemId);
+            if (owner != itemTenants_.end() && owner->second != inventory.getValueOfTenantId())
+            {
+                tenants_[owner->second].erase(itemId);
+            }
+            auto &tenant = tenants_[inventory.getValueOfTenantId()];
+            auto existing = tenant.find(itemId);
+            bool added = existing == tenant.end();
+            if (added)
+            {
+                ItemForecast item;
+                roll(item, dayOf(trantor::Date::now().microSecondsSinceEpoch()));
+                existing = tenant.emplace(itemId, std::move(item)).first;
+            }
+            auto &item = existing->second;
+            item.tenantId = inventory.getValueOfTenantId();
+            item.itemId = itemId;
+            item.itemName = inventory.getValueOfItemName();
+            item.supplier = inventory.getValueOfSupplier();
+            item.minStock = inventory.getValueOfMinStock();
+            item.maxStock = inventory.getValueOfMaxStock();
+            item.quantity = ledger->quantityOf(itemId);
+            derive(item);
+            itemTenants_[itemId] = item.tenantId;
+            // 新物料在后台线程补算窗口内的历史流水
+            if (added)
+                backfill(item.tenantId, itemId);
+        },
+        [this, itemId](const DrogonDbException &e)
+        {
+            if (dynamic_cast<const UnexpectedRows *>(&e.base()))
+            {
+                removeItem(itemId);
+                return;
+            }
+            LOG_ERROR << "Failed to refresh forecast of item " << itemId << ": " << e.base().what();
+        });
+}
+
+void InventoryForecaster::backfill(uint32_t tenantId, uint32_t itemId)
+{
+    batchQueue_->runTaskInQueue(
+        [this, tenantId, itemId]()
+        {
+            auto ledger = app().getPlugin<InventoryLedger>();
+            auto now = trantor::Date::now();
+            auto since = now.after(-86400.0 * windowDays_).roundDay().microSecondsSinceEpoch();
+            auto movements = ledger->loadMovements(tenantId, itemId, since);
+            ItemForecast computed;
+            for (auto &movement : movements[itemId])
+                addMovement(computed, movement);
+            roll(computed, dayOf(now.microSecondsSinceEpoch()));
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto tenant = tenants_.find(tenantId);
+            if (tenant == tenants_.end())
+                return;
+            auto existing = tenant->second.find(itemId);
+            if (existing == tenant->second.end())
+                return;
+            // 补算期间到达的新流水按 record_id 补记
+            for (auto &movement : ledger->movements(itemId, since))
+                addMovement(computed, movement);
+            auto &item = existing->second;
+            computed.tenantId = item.tenantId;
+            computed.itemId = item.itemId;
+            computed.itemName = item.itemName;
+            computed.supplier = item.supplier;
+            computed.minStock = item.minStock;
+            computed.maxStock = item.maxStock;
+            computed.quantity = ledger->quantityOf(itemId);
+            derive(computed);
+            item = std::move(computed);
+        });
+}
+
+void InventoryForecaster::removeItem(uint32_t itemId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto owner = itemTenants_.find(itemId);
+    if (owner == itemTenants_.end())
+        return;
+    tenants_[owner->second].erase(itemId);
+    itemTenants_.erase(owner);
+}
+
+std::vector<InventoryForecaster::ItemForecast> InventoryForecaster::forecast(uint32_t tenantId) const
+{
+    std::vector<ItemForecast> ret;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &[id, items] : tenants_)
+    {
+        if (tenantId != 0 && id != tenantId)
+            continue;
+        for (auto &[itemId, item] : items)
+            ret.push_back(item);
+    }
+    return ret;
+}
+
+Json::Value InventoryForecaster::toJson(const ItemForecast &item)
+{
+    Json::Value ret;
+    ret["tenant_id"] = item.tenantId;
+    ret["item_id"] = item.itemId;
+    ret["item_name"] = item.itemName;
+    ret["supplier"] = item.supplier;
+    ret["quantity"] = (Json::Int64)item.quantity;
+    ret["min_stock"] = item.minStock;
+    ret["max_stock"] = item.maxStock;
+    ret["daily_usage"] = std::round(item.dailyUsage * 100) / 100;
+    if (item.daysUntilStockout < 0)
+        ret["days_until_stockout"] = Json::Value::null;
+    else
+        ret["days_until_stockout"] = std::round(item.daysUntilStockout * 10) / 10;
+    ret["reorder_quantity"] = (Json::Int64)item.reorderQuantity;
+    return ret;
+}
+
+void InventoryForecaster::runBatch()
+{
+    Mapper<Inventory> mapper(dbClient_);
+    mapper.findBy(
+        Criteria(Inventory::Cols::_is_deleted, CompareOperator::EQ, 0) ||
+            Criteria(Inventory::Cols::_is_deleted, CompareOperator::IsNull),
+        [this](const std::vector<Inventory> &inventories)
+        {
+            auto now = trantor::Date::now();
+            auto today = dayOf(now.microSecondsSinceEpoch());
+            auto since = now.after(-86400.0 * windowDays_).roundDay().microSecondsSinceEpoch();
+            auto todayStart = now.roundDay().microSecondsSinceEpoch();
+
+            auto byTenant = std::make_shared<std::unordered_map<uint32_t, std::vector<Inventory>>>();
+            for (auto &inventory : inventories)
+                (*byTenant)[inventory.getValueOfTenantId()].push_back(inventory);
+            {
+                // 已没有物料的租户直接清空
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (auto it = tenants_.begin(); it != tenants_.end();)
+                {
+                    if (byTenant->count(it->first))
+                    {
+                        ++it;
+                        continue;
+                    }
+                    for (auto &[itemId, item] : it->second)
+                        itemTenants_.erase(itemId);
+                    it = tenants_.erase(it);
+                }
+            }
+
+            for (auto &entry : *byTenant)
+            {
+                auto tenantId = entry.first;
+                batchQueue_->runTaskInQueue([this, byTenant, tenantId, today, since, todayStart]()
+                                            {
+                    auto ledger = app().getPlugin<InventoryLedger>();
+                    auto movements = ledger->loadMovements(tenantId, 0, since);
+                    std::unordered_map<uint32_t, ItemForecast> computed;
+                    for (auto &inventory : byTenant->at(tenantId))
+                    {
+                        ItemForecast item;
+                        item.tenantId = tenantId;
+                        item.itemId = inventory.getValueOfInventoryId();
+                        item.itemName = inventory.getValueOfItemName();
+                        item.supplier = inventory.getValueOfSupplier();
+                        item.minStock = inventory.getValueOfMinStock();
+                        item.maxStock = inventory.getValueOfMaxStock();
+                        for (auto &movement : movements[item.itemId])
+                            addMovement(item, movement);
+                        roll(item, today);
+                        computed.emplace(item.itemId, std::move(item));
+                    }
+
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    for (auto &[itemId, item] : computed)
+                    {
+                        // 重算期间到达的新流水按 record_id 补记
+                        for (auto &movement : ledger->movements(itemId, todayStart))
+                            addMovement(item, movement);
+                        item.quantity = ledger->quantityOf(itemId);
+                        derive(item);
+                        itemTenants_[itemId] = tenantId;
+                    }
+                    auto &current = tenants_[tenantId];
+                    for (auto &[itemId, item] : current)
+                    {
+                        if (!computed.count(itemId))
+                            itemTenants_.erase(itemId);
+                    }
+                    current.swap(computed);
+                    LOG_DEBUG << "Inventory forecast of tenant " << tenantId << " recomputed, " << current.size()
+                              << " items"; });
+            }
+        },
+        [](const DrogonDbException &e)
+        {
+            LOG_ERROR << "Failed to load inventory for forecasting: " << e.base().what();
+        });
+}
+
+void InventoryForecaster::scheduleBatch()
+{
+    // 每天 batch_hour 点全量重算
+    auto now = trantor::Date::now();
+    auto next = now.roundDay().after(3600.0 * batchHour_);
+    if (next.microSecondsSinceEpoch() <= now.microSecondsSinceEpoch())
+        next = next.after(86400.0);
+    timerId_ = app().getLoop()->runAt(next, [this]()
+                                      {
+        runBatch();
+        scheduleBatch(); });
+}
@@ -0,0 +1,89 @@
+/**
+ *
+ *  InventoryForecaster.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/orm/DbClient.h>
+#include <trantor/utils/ConcurrentTaskQueue.h>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "InventoryLedger.h"
+
+/**
+ * @brief 库存消耗预测与补货建议。
+ *
+ * 按自然日汇总出库量，用指数平滑估计日均消耗。新流水到达时增量更新，
+ * 每晚按租户并行全量重算以修正被修改或删除的流水；请求只读取计算结果。
+ */
+class InventoryForecaster : public drogon::Plugin<InventoryForecaster>
+{
+public:
+  InventoryForecaster() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  struct ItemForecast
+  {
+    uint32_t tenantId{0};
+    uint32_t itemId{0};
+    std::string itemName;
+    std::string supplier;
+    int32_t minStock{0};
+    int32_t maxStock{0};
+    int64_t quantity{0};
+
+    double smoothedOutflow{0}; // 已结束各日出库量的平滑值
+    bool seeded{false};
+    int64_t day{-1};           // 当前统计日
+    double dayOutflow{0};      // 当前统计日已出库量
+    uint32_t lastRecordId{0};  // 已计入的最大流水号
+
+    double dailyUsage{0};
+    double daysUntilStockout{-1}; // 无消耗时为 -1
+    int64_t reorderQuantity{0};
+  };
+
+  /// 物料新增或修改后，从数据库重新读取名称、供应商和阈值
+  void refreshItem(uint32_t itemId);
+  void removeItem(uint32_t itemId);
+
+  /// tenantId 为 0 时返回所有租户
+  std::vector<ItemForecast> forecast(uint32_t tenantId) const;
+  static Json::Value toJson(const ItemForecast &item);
+
+  /// 全量重算所有租户，各租户在线程池中并行执行
+  void runBatch();
+  /// 从数据库补算物料窗口内的历史流水，在批处理线程中执行
+  void backfill(uint32_t tenantId, uint32_t itemId);
+
+private:
+  static int64_t dayOf(int64_t at);
+  void roll(ItemForecast &item, int64_t day) const;
+  void addMovement(ItemForecast &item, const InventoryLedger::Movement &movement) const;
+  void derive(ItemForecast &item) const;
+  void scheduleBatch();
+
+  drogon::orm::DbClientPtr dbClient_;
+  double alpha_{0.3};
+  int windowDays_{90};
+  double leadTimeDays_{3};
+  int batchHour_{3};
+  std::unique_ptr<trantor::ConcurrentTaskQueue> batchQueue_;
+  trantor::TimerId timerId_{0};
+
+  mutable std::mutex mutex_;
+  std::unordered_map<uint32_t, std::unordered_map<uint32_t, ItemForecast>> tenants_;
+  std::unordered_map<uint32_t, uint32_t> itemTenants_;
+};
@@ -0,0 +1,552 @@
+/**
+ *
+ *  InventoryLedger.cc
+ *
+ */
+
+#include "InventoryLedger.h"
+#include "Inventory.h"
+#include <drogon/drogon.h>
+#include <algorithm>
+#include <limits>
+
+using namespace drogon;
+using namespace drogon::orm;
+using namespace drogon_model::saas_restaurant;
+
+void InventoryLedger::initAndStart(const Json::Value &config)
+{
+    dbClientName_ = config.get("db_client", "default").asString();
+    snapshotInterval_ = config.get("snapshot_interval", 600.0).asDouble();
+    snapshotMinDeltas_ = config.get("snapshot_min_deltas", 1).asUInt();
+    dbClient_ = app().getDbClient(dbClientName_);
+
+    load();
+
+    // 周期性为有新流水的物料写入快照
+    timerId_ = app().getLoop()->runEvery(snapshotInterval_, [this]() { writeSnapshots(); });
+}
+
+void InventoryLedger::shutdown()
+{
+    app().getLoop()->invalidateTimer(timerId_);
+}
+
+void InventoryLedger::addListener(QuantityListener listener)
+{
+    listeners_.push_back(std::move(listener));
+}
+
+void InventoryLedger::addMovementListener(MovementListener listener)
+{
+    movementListeners_.push_back(std::move(listener));
+}
+
+int64_t InventoryLedger::deltaOf(const InventoryRecord &record)
+{
+    int64_t quantity = 0;
+    try
+    {
+        quantity = std::stoll(record.getValueOfQuantity());
+    }
+    catch (...)
+    {
+        LOG_WARN << "Invalid quantity in inventory record " << record.getValueOfRecordId();
+        return 0;
+    }
+    // 记录类型：入库 / 出库
+    if (record.getValueOfRecordType() == "出库")
+        return -quantity;
+    return quantity;
+}
+
+void InventoryLedger::load()
+{
+    std::vector<Inventory> inventories;
+    Result recordRows(nullptr);
+    Result snapshotRows(nullptr);
+    try
+    {
+        inventories = Mapper<Inventory>(dbClient_).findAll();
+        // 每个物料只读最新快照和它之后的流水
+        recordRows = dbClient_->execSqlSync(
+            "select r.* from inventory_record r left join (select item_id, max(last_record_id) as last_record_id "
+            "from inventory_snapshot group by item_id) s on s.item_id = r.item_id "
+            "where r.record_id > coalesce(s.last_record_id, 0) order by r.record_id");
+        snapshotRows = dbClient_->execSqlSync(
+            "select s.* from inventory_snapshot s join (select item_id, max(last_record_id) as last_record_id "
+            "from inventory_snapshot group by item_id) m on m.item_id = s.item_id and m.last_record_id = s.last_record_id "
+            "order by s.item_id, s.snapshot_id");
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to load inventory ledger: " << e.base().what();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ledgers_.clear();
+    std::map<uint32_t, int64_t> currentQuantity;
+    for (auto &inventory : inventories)
+    {
+        ledgers_[inventory.getValueOfInventoryId()].tenantId = inventory.getValueOfTenantId();
+        currentQuantity[inventory.getValueOfInventoryId()] = inventory.getValueOfQuantity();
+    }
+    std::map<uint32_t, std::vector<StockLedger::Entry>> entries;
+    for (const auto &row : recordRows)
+    {
+        InventoryRecord record(row);
+        auto itemId = record.getValueOfItemId();
+        auto &ledger = ledgers_[itemId];
+        if (ledger.tenantId == 0)
+            ledger.tenantId = record.getValueOfTenantId();
+        entries[itemId].push_back(
+            {record.getValueOfRecordId(), record.getValueOfCreatedAt().microSecondsSinceEpoch(), deltaOf(record)});
+    }
+    for (auto &[itemId, itemEntries] : entries)
+        ledgers_[itemId].book.assign(std::move(itemEntries));
+    for (const auto &row : snapshotRows)
+    {
+        auto it = ledgers_.find(row["item_id"].as<uint32_t>());
+        if (it == ledgers_.end())
+            continue;
+        auto lastRecordId = row["last_record_id"].as<uint32_t>();
+        auto at = lastRecordId == 0
+                      ? 0
+                      : trantor::Date::fromDbStringLocal(row["snapshot_at"].as<std::string>()).microSecondsSinceEpoch();
+        it->second.book.restore(at, lastRecordId, row["quantity"].as<int64_t>());
+    }
+
+    // 没有任何快照的物料是首次启用，以当前 inventory.quantity 倒推期初数量并持久化
+    for (auto &[itemId, ledger] : ledgers_)
+    {
+        StockLedger::Snapshot opening;
+        if (ledger.book.ensureOpening(currentQuantity[itemId], opening))
+            persistSnapshot(ledger.tenantId, itemId, opening);
+    }
+    LOG_INFO << "Inventory ledger loaded: " << ledgers_.size() << " items, " << recordRows.size()
+             << " records after the latest snapshots";
+}
+
+void InventoryLedger::openItem(uint32_t tenantId, uint32_t itemId, int64_t quantity)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto &ledger = ledgers_[itemId];
+        ledger.tenantId = tenantId;
+        ledger.book.open(quantity);
+    }
+    persistSnapshot(tenantId, itemId, {0, 0, quantity, 0});
+    notify(tenantId, itemId, quantity);
+}
+
+void InventoryLedger::append(const InventoryRecord &record)
+{
+    appendBatch({record});
+}
+
+void InventoryLedger::appendBatch(const std::vector<InventoryRecord> &records)
+{
+    if (records.empty())
+        return;
+    auto now = trantor::Date::now().microSecondsSinceEpoch();
+    struct Appended
+    {
+        uint32_t tenantId;
+        uint32_t itemId;
+        Movement movement;
+    };
+    std::vector<Appended> appended;
+    appended.reserve(records.size());
+    std::vector<std::pair<uint32_t, uint32_t>> opened;
+    std::map<uint32_t, uint32_t> stale; // 物料ID -> 失效快照之前的最小流水ID
+    std::map<uint32_t, int64_t> quantities;
+    std::map<uint32_t, uint32_t> tenants;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &record : records)
+        {
+            auto itemId = record.getValueOfItemId();
+            auto recordId = record.getValueOfRecordId();
+            auto at = record.getValueOfCreatedAt().microSecondsSinceEpoch();
+            if (at == 0)
+                at = now;
+            auto &ledger = ledgers_[itemId];
+            if (!ledger.book.opened())
+            {
+                ledger.tenantId = record.getValueOfTenantId();
+                ledger.book.open(0);
+                opened.emplace_back(ledger.tenantId, itemId);
+            }
+            Movement movement{recordId, at, deltaOf(record)};
+            size_t dropped = 0;
+            if (!ledger.book.insert({recordId, at, movement.delta}, dropped))
+                continue;
+            // 编号小于基准的流水没有计入已持久化的基准快照
+            if (dropped > 0 || recordId < ledger.book.snapshots().front().lastRecordId)
+            {
+                auto it = stale.find(itemId);
+                if (it == stale.end() || recordId < it->second)
+                    stale[itemId] = recordId;
+            }
+            appended.push_back({record.getValueOfTenantId(), itemId, movement});
+            tenants[itemId] = record.getValueOfTenantId();
+        }
+        for (auto &[itemId, tenantId] : tenants)
+            quantities[itemId] = ledgers_[itemId].book.current();
+    }
+    for (auto &[tenantId, itemId] : opened)
+        persistSnapshot(tenantId, itemId, {0, 0, 0, 0});
+    // 晚到的流水插在已有快照之前，这些快照不再成立
+    for (auto &[itemId, recordId] : stale)
+        dropSnapshots(itemId, recordId);
+    persistQuantities(quantities);
+    for (auto &entry : appended)
+    {
+        for (auto &listener : movementListeners_)
+            listener(entry.tenantId, entry.itemId, entry.movement);
+    }
+    // 同一物料只通知最终数量
+    for (auto &[itemId, quantity] : quantities)
+        notify(tenants[itemId], itemId, quantity);
+}
+
+void InventoryLedger::reloadItem(uint32_t itemId)
+{
+    // 历史流水已变，只有期初快照仍然成立
+    dbClient_->execSqlAsync(
+        "select quantity from inventory_snapshot where item_id = ? and last_record_id = 0 order by snapshot_id desc limit 1",
+        [this, itemId](const Result &result)
+        {
+            int64_t opening = 0;
+            if (result.empty())
+                LOG_WARN << "Inventory item " << itemId << " has no opening snapshot, reloading from 0";
+            else
+                opening = result[0]["quantity"].as<int64_t>();
+            Mapper<InventoryRecord> mapper(dbClient_);
+            mapper.orderBy(InventoryRecord::Cols::_record_id)
+                .findBy(
+                    Criteria(InventoryRecord::Cols::_item_id, CompareOperator::EQ, itemId),
+                    [this, itemId, opening](const std::vector<InventoryRecord> &records)
+                    {
+                        int64_t quantity;
+                        uint32_t tenantId;
+                        {
+                            std::lock_guard<std::mutex> lock(mutex_);
+                            auto &ledger = ledgers_[itemId];
+                            ledger.book.open(opening);
+                            // 其余快照由后台任务重建，写入后再压缩
+                            std::vector<StockLedger::Entry> entries;
+                            entries.reserve(records.size());
+                            for (auto &record : records)
+                            {
+                                if (ledger.tenantId == 0)
+                                    ledger.tenantId = record.getValueOfTenantId();
+                                entries.push_back({record.getValueOfRecordId(),
+                                                   record.getValueOfCreatedAt().microSecondsSinceEpoch(),
+                                                   deltaOf(record)});
+                            }
+                            ledger.book.assign(std::move(entries));
+                            quantity = ledger.book.current();
+                            tenantId = ledger.tenantId;
+                        }
+                        dropSnapshots(itemId, 0);
+                        persistQuantity(itemId, quantity);
+                        notify(tenantId, itemId, quantity);
+                        LOG_DEBUG << "Inventory ledger reloaded item " << itemId << " of tenant " << tenantId;
+                    },
+                    [itemId](const DrogonDbException &e)
+                    {
+                        LOG_ERROR << "Failed to reload inventory item " << itemId << ": " << e.base().what();
+                    });
+        },
+        [itemId](const DrogonDbException &e)
+        {
+            LOG_ERROR << "Failed to reload inventory item " << itemId << ": " << e.base().what();
+        },
+        itemId);
+}
+
+bool InventoryLedger::hasItem(uint32_t itemId) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ledgers_.find(itemId) != ledgers_.end();
+}
+
+int64_t InventoryLedger::quantityOf(uint32_t itemId) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ledgers_.find(itemId);
+    if (it == ledgers_.end())
+        return 0;
+    return it->second.book.current();
+}
+
+void InventoryLedger::quantityAt(uint32_t itemId,
+                                 const trantor::Date &at,
+                                 std::function<void(int64_t quantity)> &&callback,
+                                 std::function<void(const DrogonDbException &)> &&errorCallback) const
+{
+    int64_t quantity = 0;
+    bool inMemory = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = ledgers_.find(itemId);
+        if (it != ledgers_.end())
+        {
+            const auto &book = it->second.book;
+            inMemory = !book.opened() || book.snapshots().front().lastRecordId == 0 ||
+                       at.microSecondsSinceEpoch() >= book.snapshots().front().at;
+            if (inMemory)
+                quantity = book.quantityAt(at.microSecondsSinceEpoch());
+        }
+    }
+    if (inMemory)
+    {
+        callback(quantity);
+        return;
+    }
+    // 早于内存基准，由该时刻之前最近的持久化快照推算
+    balanceBefore(itemId, UINT32_MAX, at, std::move(callback), std::move(errorCallback));
+}
+
+std::vector<InventoryLedger::Movement> InventoryLedger::movements(uint32_t itemId, int64_t since) const
+{
+    std::vector<Movement> ret;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ledgers_.find(itemId);
+    if (it == ledgers_.end())
+        return ret;
+    const auto &entries = it->second.book.entries();
+    auto first = it->second.book.range(since, INT64_MAX).first;
+    ret.reserve(entries.size() - first);
+    for (size_t i = first; i < entries.size(); ++i)
+        ret.push_back({entries[i].recordId, entries[i].at, entries[i].delta});
+    return ret;
+}
+
+std::map<uint32_t, std::vector<InventoryLedger::Movement>> InventoryLedger::loadMovements(uint32_t tenantId,
+                                                                                           uint32_t itemId,
+                                                                                           int64_t since) const
+{
+    std::map<uint32_t, std::vector<Movement>> ret;
+    Result rows(nullptr);
+    try
+    {
+        if (itemId != 0)
+            rows = dbClient_->execSqlSync(
+                "select * from inventory_record where item_id = ? and created_at >= ? order by record_id",
+                itemId,
+                trantor::Date(since));
+        else
+            rows = dbClient_->execSqlSync(
+                "select * from inventory_record where item_id in (select inventory_id from inventory where tenant_id = ?) "
+                "and created_at >= ? order by record_id",
+                tenantId,
+                trantor::Date(since));
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to load movements of tenant " << tenantId << ": " << e.base().what();
+        return ret;
+    }
+    for (const auto &row : rows)
+    {
+        InventoryRecord record(row);
+        ret[record.getValueOfItemId()].push_back(
+            {record.getValueOfRecordId(), record.getValueOfCreatedAt().microSecondsSinceEpoch(), deltaOf(record)});
+    }
+    return ret;
+}
+
+void InventoryLedger::history(uint32_t itemId,
+                              const trantor::Date &from,
+                              const trantor::Date &to,
+                              size_t offset,
+                              size_t limit,
+                              std::function<void(const std::vector<HistoryEntry> &)> &&callback,
+                              std::function<void(const DrogonDbException &)> &&errorCallback) const
+{
+    auto criteria = Criteria(InventoryRecord::Cols::_item_id, CompareOperator::EQ, itemId);
+    if (from.microSecondsSinceEpoch() > 0)
+        criteria = criteria && Criteria(InventoryRecord::Cols::_created_at, CompareOperator::GE, from);
+    if (to.microSecondsSinceEpoch() < INT64_MAX)
+        criteria = criteria && Criteria(InventoryRecord::Cols::_created_at, CompareOperator::LE, to);
+    Mapper<InventoryRecord> mapper(dbClient_);
+    mapper.orderBy(InventoryRecord::Cols::_record_id);
+    // MySQL 的 offset 必须带 limit
+    if (limit > 0 || offset > 0)
+        mapper.limit(limit > 0 ? limit : std::numeric_limits<size_t>::max()).offset(offset);
+    auto errorPtr = std::make_shared<std::function<void(const DrogonDbException &)>>(std::move(errorCallback));
+    mapper.findBy(
+        criteria,
+        [this, itemId, callback = std::move(callback), errorPtr](const std::vector<InventoryRecord> &records) mutable
+        {
+            if (records.empty())
+            {
+                callback({});
+                return;
+            }
+            balanceBefore(
+                itemId,
+                records.front().getValueOfRecordId(),
+                trantor::Date(INT64_MAX),
+                [records, callback = std::move(callback)](int64_t balance)
+                {
+                    std::vector<HistoryEntry> ret;
+                    ret.reserve(records.size());
+                    for (auto &record : records)
+                    {
+                        balance += deltaOf(record);
+                        ret.push_back({record, balance});
+                    }
+                    callback(ret);
+                },
+                [errorPtr](const DrogonDbException &e) { (*errorPtr)(e); });
+        },
+        [errorPtr](const DrogonDbException &e) { (*errorPtr)(e); });
+}
+
+void InventoryLedger::balanceBefore(uint32_t itemId,
+                                    uint32_t beforeRecordId,
+                                    const trantor::Date &at,
+                                    std::function<void(int64_t balance)> &&callback,
+                                    std::function<void(const DrogonDbException &)> &&errorCallback) const
+{
+    // 与 deltaOf 一致：出库为负数
+    static const std::string delta =
+        "case when r.record_type = '出库' then -cast(r.quantity as signed) else cast(r.quantity as signed) end";
+    auto onResult = [callback = std::move(callback)](const Result &result)
+    {
+        callback(result.empty() || result[0]["balance"].isNull() ? 0 : result[0]["balance"].as<int64_t>());
+    };
+    if (at.microSecondsSinceEpoch() == INT64_MAX)
+    {
+        dbClient_->execSqlAsync(
+            "select s.quantity + coalesce((select sum(" + delta +
+                ") from inventory_record r where r.item_id = s.item_id and r.record_id > s.last_record_id "
+                "and r.record_id < ?), 0) as balance from inventory_snapshot s where s.item_id = ? and s.last_record_id < ? "
+                "order by s.last_record_id desc, s.snapshot_id desc limit 1",
+            std::move(onResult),
+            std::move(errorCallback),
+            beforeRecordId,
+            itemId,
+            beforeRecordId);
+        return;
+    }
+    dbClient_->execSqlAsync(
+        "select s.quantity + coalesce((select sum(" + delta +
+            ") from inventory_record r where r.item_id = s.item_id and r.record_id > s.last_record_id "
+            "and r.record_id < ? and r.created_at <= ?), 0) as balance from inventory_snapshot s "
+            "where s.item_id = ? and s.last_record_id < ? and (s.last_record_id = 0 or s.snapshot_at <= ?) "
+            "order by s.last_record_id desc, s.snapshot_id desc limit 1",
+        std::move(onResult),
+        std::move(errorCallback),
+        beforeRecordId,
+        at,
+        itemId,
+        beforeRecordId,
+        at);
+}
+
+void InventoryLedger::writeSnapshots()
+{
+    std::vector<std::tuple<uint32_t, uint32_t, StockLedger::Snapshot>> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &[itemId, ledger] : ledgers_)
+        {
+            StockLedger::Snapshot snapshot;
+            if (!ledger.book.takeSnapshot(snapshotMinDeltas_, snapshot))
+                continue;
+            pending.emplace_back(ledger.tenantId, itemId, snapshot);
+            // 快照之前的流水不再留在内存，需要时从数据库查询
+            ledger.book.compact();
+        }
+    }
+    for (auto &[tenantId, itemId, snapshot] : pending)
+        persistSnapshot(tenantId, itemId, snapshot);
+    if (!pending.empty())
+        LOG_DEBUG << "Inventory ledger wrote " << pending.size() << " snapshots";
+}
+
+void InventoryLedger::persistSnapshot(uint32_t tenantId, uint32_t itemId, const StockLedger::Snapshot &snapshot)
+{
+    auto snapshotAt = snapshot.at == 0 ? trantor::Date::now() : trantor::Date(snapshot.at);
+    dbClient_->execSqlAsync(
+        "insert into inventory_snapshot (tenant_id, item_id, quantity, last_record_id, snapshot_at) values (?, ?, ?, ?, ?)",
+        [](const Result &) {},
+        [itemId](const DrogonDbException &e)
+        {
+            LOG_ERROR << "Failed to write snapshot of item " << itemId << ": " << e.base().what();
+        },
+        tenantId,
+        itemId,
+        snapshot.quantity,
+        snapshot.lastRecordId,
+        snapshotAt);
+}
+
+void InventoryLedger::dropSnapshots(uint32_t itemId, uint32_t lastRecordId)
+{
+    // 期初快照 last_record_id 为 0，始终保留
+    std::string sql = "delete from inventory_snapshot where item_id = ? and last_record_id > ?";
+    dbClient_->execSqlAsync(
+        sql,
+        [](const Result &) {},
+        [itemId](const DrogonDbException &e)
+        {
+            LOG_ERROR << "Failed to drop snapshots of item " << itemId << ": " << e.base().what();
+        },
+        itemId,
+        lastRecordId);
+}
+
+void InventoryLedger::persistQuantity(uint32_t itemId, int64_t quantity)
+{
+    // inventory.quantity 只作为派生值的缓存，供列表查询使用
+    dbClient_->execSqlAsync(
+        "update inventory set quantity = ? where inventory_id = ?",
+        [](const Result &) {},
+        [itemId](const DrogonDbException &e)
+        {
+            LOG_ERROR << "Failed to update quantity of item " << itemId << ": " << e.base().what();
+        },
+        quantity,
+        itemId);
+}
+
+void InventoryLedger::persistQuantities(const std::map<uint32_t, int64_t> &quantities)
+{
+    if (quantities.empty())
+        return;
+    if (quantities.size() == 1)
+    {
+        persistQuantity(quantities.begin()->first, quantities.begin()->second);
+        return;
+    }
+    std::string sql = "update inventory set quantity = case inventory_id";
+    std::string ids;
+    for (size_t i = 0; i < quantities.size(); ++i)
+    {
+        sql += " when ? then ?";
+        ids += i == 0 ? "?" : ", ?";
+    }
+    sql += " end where inventory_id in (" + ids + ")";
+    auto binder = *dbClient_ << std::move(sql);
+    for (auto &[itemId, quantity] : quantities)
+        binder << itemId << quantity;
+    for (auto &[itemId, quantity] : quantities)
+        binder << itemId;
+    binder >> [](const Result &) {};
+    binder >> [count = quantities.size()](const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to update quantity of " << count << " items: " << e.base().what();
+    };
+}
+
+void InventoryLedger::notify(uint32_t tenantId, uint32_t itemId, int64_t quantity)
+{
+    for (auto &listener : listeners_)
+        listener(tenantId, itemId, quantity);
+}
@@ -0,0 +1,128 @@
+/**
+ *
+ *  InventoryLedger.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/orm/DbClient.h>
+#include <trantor/utils/Date.h>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "InventoryRecord.h"
+#include "StockLedger.h"
+
+/**
+ * @brief 以 inventory_record 为流水账推导库存数量。
+ *
+ * 每个物料在内存中只保存最新快照之后的流水（StockLedger），快照由后台任务周期性写入
+ * inventory_snapshot 表，写入后压缩掉已包含的流水。写库回调乱序到达时流水插入到有序位置，
+ * 插在已有快照之前时删除失效的快照。
+ * 任意时刻的数量 = 该时刻之前最近的快照 + 快照之后的流水增量；早于内存基准的时刻和流水明细从数据库查询。
+ */
+class InventoryLedger : public drogon::Plugin<InventoryLedger>
+{
+public:
+  InventoryLedger() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  /// 物料数量变化时的回调，在数据库线程中调用
+  using QuantityListener = std::function<void(uint32_t tenantId, uint32_t itemId, int64_t quantity)>;
+  /// 注册数量变化回调，须在依赖插件的 initAndStart 中调用
+  void addListener(QuantityListener listener);
+
+  struct Movement
+  {
+    uint32_t recordId;
+    int64_t at; // 微秒时间戳
+    int64_t delta;
+  };
+  /// 新流水追加时的回调；流水修改、删除不会回调
+  using MovementListener = std::function<void(uint32_t tenantId, uint32_t itemId, const Movement &movement)>;
+  void addMovementListener(MovementListener listener);
+
+  /// 流水记录的数量增量，出库为负数
+  static int64_t deltaOf(const drogon_model::saas_restaurant::InventoryRecord &record);
+
+  /// 新建物料时写入期初快照
+  void openItem(uint32_t tenantId, uint32_t itemId, int64_t quantity);
+  /// 追加一条新插入的流水，并回写 inventory.quantity
+  void append(const drogon_model::saas_restaurant::InventoryRecord &record);
+  /// 追加一批新插入的流水，按物料合并后用一条语句回写 inventory.quantity
+  void appendBatch(const std::vector<drogon_model::saas_restaurant::InventoryRecord> &records);
+  /// 流水被修改或删除后，从期初快照和全部流水重建该物料
+  void reloadItem(uint32_t itemId);
+
+  bool hasItem(uint32_t itemId) const;
+  /// 当前数量
+  int64_t quantityOf(uint32_t itemId) const;
+  /// 指定时刻（含）的数量；早于内存基准时查询数据库
+  void quantityAt(uint32_t itemId,
+                  const trantor::Date &at,
+                  std::function<void(int64_t quantity)> &&callback,
+                  std::function<void(const drogon::orm::DrogonDbException &)> &&errorCallback) const;
+
+  struct HistoryEntry
+  {
+    drogon_model::saas_restaurant::InventoryRecord record;
+    int64_t balance; // 该流水生效后的数量
+  };
+  /// 从数据库查询 [from, to] 区间内的流水，offset/limit 作用于区间内
+  void history(uint32_t itemId,
+               const trantor::Date &from,
+               const trantor::Date &to,
+               size_t offset,
+               size_t limit,
+               std::function<void(const std::vector<HistoryEntry> &)> &&callback,
+               std::function<void(const drogon::orm::DrogonDbException &)> &&errorCallback) const;
+
+  /// 内存中 at 不早于 since 的流水增量，按 record_id 升序；只含最新快照之后的流水
+  std::vector<Movement> movements(uint32_t itemId, int64_t since) const;
+  /// 从数据库读取 at 不早于 since 的流水增量，按物料分组、record_id 升序；
+  /// itemId 为 0 时读取租户的全部物料。同步查询，不能在 IO 线程和数据库回调中调用
+  std::map<uint32_t, std::vector<Movement>> loadMovements(uint32_t tenantId, uint32_t itemId, int64_t since) const;
+
+private:
+  struct ItemLedger
+  {
+    uint32_t tenantId{0};
+    StockLedger book; // 至少有一个快照：期初或最近一次压缩的基准
+  };
+
+  void load();
+  /// 第 beforeRecordId 条流水之前、时刻不晚于 at 的数量，从数据库计算
+  void balanceBefore(uint32_t itemId,
+                     uint32_t beforeRecordId,
+                     const trantor::Date &at,
+                     std::function<void(int64_t balance)> &&callback,
+                     std::function<void(const drogon::orm::DrogonDbException &)> &&errorCallback) const;
+  void writeSnapshots();
+  void persistSnapshot(uint32_t tenantId, uint32_t itemId, const StockLedger::Snapshot &snapshot);
+  /// 删除 lastRecordId 之后的已持久化快照
+  void dropSnapshots(uint32_t itemId, uint32_t lastRecordId);
+  void persistQuantity(uint32_t itemId, int64_t quantity);
+  void persistQuantities(const std::map<uint32_t, int64_t> &quantities);
+  void notify(uint32_t tenantId, uint32_t itemId, int64_t quantity);
+
+  drogon::orm::DbClientPtr dbClient_;
+  std::string dbClientName_{"default"};
+  double snapshotInterval_{600.0};
+  size_t snapshotMinDeltas_{1};
+  trantor::TimerId timerId_{0};
+
+  mutable std::mutex mutex_;
+  std::map<uint32_t, ItemLedger> ledgers_;
+  std::vector<QuantityListener> listeners_;
+  std::vector<MovementListener> movementListeners_;
+};
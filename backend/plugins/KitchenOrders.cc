@@ -0,0 +1,420 @@
+/**
+ *
+ *  KitchenOrders.cc
+ *
+ */
+
+#include "KitchenOrders.h"
+#include <drogon/drogon.h>
+#include <algorithm>
+#include <array>
+
+using namespace drogon;
+using namespace drogon::orm;
+using namespace drogon_model::saas_restaurant;
+
+namespace
+{
+std::string compact(const Json::Value &value)
+{
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "";
+    return Json::writeString(writer, value);
+}
+} // namespace
+
+void KitchenOrders::initAndStart(const Json::Value &config)
+{
+    dbClient_ = app().getDbClient(config.get("db_client", "default").asString());
+    flushInterval_ = config.get("flush_interval", 0.5).asDouble();
+    snapshotLimit_ = std::max(config.get("snapshot_limit", 200).asUInt(), 1u);
+    std::array<int64_t, 3> lead{0, 60, 300};
+    const auto &leads = config["priority_lead"];
+    for (auto kind : {KitchenQueue::Kind::DineIn, KitchenQueue::Kind::Takeaway, KitchenQueue::Kind::Delivery})
+    {
+        const auto &value = leads[KitchenQueue::kindName(kind)];
+        if (value.isNumeric())
+            lead[static_cast<size_t>(kind)] = value.asInt64();
+    }
+    queue_ = KitchenQueue(lead);
+
+    load();
+
+    // 合并一个周期内的推进后统一写库
+    if (flushInterval_ > 0)
+        timerId_ = app().getLoop()->runEvery(flushInterval_, [this]() { flush(); });
+}
+
+void KitchenOrders::shutdown()
+{
+    app().getLoop()->invalidateTimer(timerId_);
+    flush(true);
+}
+
+void KitchenOrders::load()
+{
+    // 不按下单时间截断，跨天仍未完成的订单同样要上厨显、能推进
+    std::vector<std::string> statuses;
+    for (auto status : {OrderFlow::Status::Pending,
+                        OrderFlow::Status::Confirmed,
+                        OrderFlow::Status::Cooking,
+                        OrderFlow::Status::Ready})
+        statuses.emplace_back(OrderFlow::name(status));
+    try
+    {
+        auto orders = Mapper<OrderTable>(dbClient_).findBy(
+            Criteria(OrderTable::Cols::_order_status, CompareOperator::In, statuses) &&
+            Criteria(OrderTable::Cols::_branch_id, CompareOperator::IsNotNull) &&
+            (Criteria(OrderTable::Cols::_is_deleted, CompareOperator::EQ, 0) ||
+             Criteria(OrderTable::Cols::_is_deleted, CompareOperator::IsNull)));
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &order : orders)
+        {
+            KitchenQueue::Ticket ticket;
+            if (ticketOf(order, ticket))
+                queue_.put(std::move(ticket));
+        }
+        LOG_INFO << "Kitchen queue loaded " << queue_.size() << " active orders";
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to load active orders: " << e.base().what();
+    }
+}
+
+bool KitchenOrders::ticketOf(const OrderTable &order, KitchenQueue::Ticket &ticket) const
+{
+    if (order.getValueOfIsDeleted() == 1 || !order.getBranchId() ||
+        !OrderFlow::parse(order.getValueOfOrderStatus(), ticket.status))
+        return false;
+    ticket.orderId = order.getValueOfOrderId();
+    ticket.tenantId = order.getValueOfTenantId();
+    ticket.branchId = order.getValueOfBranchId();
+    ticket.placedAt = (order.getCreatedAt() ? order.getValueOfCreatedAt() : trantor::Date::now()).secondsSinceEpoch();
+    ticket.changedAt = order.getUpdatedAt() ? order.getValueOfUpdatedAt().secondsSinceEpoch() : ticket.placedAt;
+    ticket.payment = order.getValueOfPaymentStatus();
+    ticket.remark = order.getValueOfRemark();
+
+    Json::Value detail;
+    std::string errs;
+    const auto &text = order.getValueOfOrderDetail();
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    if (!text.empty() && reader->parse(text.data(), text.data() + text.size(), &detail, &errs) && detail.isObject())
+    {
+        const auto &table = detail["table_number"];
+        if (table.isString() || table.isIntegral())
+            ticket.table = table.asString();
+        if (detail["items"].isArray())
+            ticket.items = detail["items"];
+    }
+    if (ticket.items.isNull())
+        ticket.items = Json::Value(Json::arrayValue);
+    if (!order.getValueOfDeliveryAddress().empty())
+        ticket.kind = KitchenQueue::Kind::Delivery;
+    else if (!ticket.table.empty())
+        ticket.kind = KitchenQueue::Kind::DineIn;
+    else
+        ticket.kind = KitchenQueue::Kind::Takeaway;
+    return true;
+}
+
+void KitchenOrders::orderCreated(const OrderTable &order)
+{
+    std::vector<Message> messages;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        refresh(order.getValueOfOrderId(), &order, messages);
+    }
+    publish(messages);
+}
+
+void KitchenOrders::orderChanged(uint32_t orderId)
+{
+    Mapper<OrderTable>(dbClient_).findByPrimaryKey(
+        orderId,
+        [this, orderId](const OrderTable &order)
+        {
+            std::vector<Message> messages;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                refresh(orderId, &order, messages);
+            }
+            publish(messages);
+        },
+        [this, orderId](const DrogonDbException &e)
+        {
+            if (!dynamic_cast<const UnexpectedRows *>(&e.base()))
+            {
+                LOG_ERROR << "Failed to refresh order " << orderId << " for kitchen: " << e.base().what();
+                return;
+            }
+            std::vector<Message> messages;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                refresh(orderId, nullptr, messages);
+            }
+            publish(messages);
+        });
+}
+
+void KitchenOrders::refresh(uint32_t orderId, const OrderTable *order, std::vector<Message> &messages)
+{
+    KitchenQueue::Ticket ticket;
+    bool queued = order && ticketOf(*order, ticket);
+    auto pending = persist_.find(orderId);
+    if (pending != persist_.end())
+    {
+        const auto &stored = order ? order->getValueOfOrderStatus() : std::string();
+        const auto &persist = pending->second;
+        if (order && (stored == persist.persisted || (persist.writing && stored == persist.sending)))
+        {
+            // 推进的状态还没写到库里，以内存为准；已推进到终态的不再放回队列
+            auto current = queue_.find(orderId);
+            if (!current)
+                return;
+            ticket.status = current->status;
+            ticket.changedAt = current->changedAt;
+        }
+        else
+        {
+            // 库中状态已被他处改写，以库为准，不再写回
+            persist_.erase(pending);
+        }
+    }
+
+    auto previous = queue_.find(orderId);
+    bool had = previous != nullptr;
+    auto previousBranch = had ? previous->branchId : 0;
+    if (!queued)
+    {
+        if (queue_.remove(orderId))
+            messages.push_back(removal(previousBranch, orderId, order ? order->getValueOfOrderStatus() : std::string()));
+        return;
+    }
+    switch (queue_.put(ticket))
+    {
+        case KitchenQueue::Change::Put:
+            // 换了分店的，原分店的厨显也要移除
+            if (had && previousBranch != ticket.branchId)
+                messages.push_back(removal(previousBranch, orderId, OrderFlow::name(ticket.status)));
+            messages.push_back(upsert(ticket));
+            break;
+        case KitchenQueue::Change::Removed:
+            messages.push_back(removal(previousBranch, orderId, OrderFlow::name(ticket.status)));
+            break;
+        case KitchenQueue::Change::None:
+            break;
+    }
+}
+
+bool KitchenOrders::statusOf(uint32_t orderId, std::string &status) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto ticket = queue_.find(orderId);
+    if (!ticket)
+        return false;
+    status = OrderFlow::name(ticket->status);
+    return true;
+}
+
+KitchenQueue::Move KitchenOrders::move(uint32_t orderId, OrderFlow::Status to, Json::Value &data)
+{
+    std::vector<Message> messages;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto current = queue_.find(orderId);
+        if (!current)
+            return KitchenQueue::Move::NotFound;
+        std::string from = OrderFlow::name(current->status);
+        KitchenQueue::Ticket ticket;
+        auto result = queue_.move(orderId, to, trantor::Date::now().secondsSinceEpoch(), ticket);
+        if (result != KitchenQueue::Move::Moved)
+            return result;
+        data = toJson(ticket);
+        if (from == OrderFlow::name(to))
+            return result;
+        // 同一订单在写库前多次推进，只记最后的状态
+        auto [it, inserted] = persist_.try_emplace(orderId);
+        if (inserted)
+            it->second.persisted = from;
+        it->second.target = OrderFlow::name(to);
+        messages.push_back(OrderFlow::active(to) ? upsert(ticket) : removal(ticket.branchId, orderId, it->second.target));
+    }
+    publish(messages);
+    if (flushInterval_ <= 0)
+        flush();
+    return KitchenQueue::Move::Moved;
+}
+
+void KitchenOrders::flush(bool wait)
+{
+    struct Write
+    {
+        uint32_t orderId;
+        std::string target;
+        std::string persisted;
+    };
+    std::vector<Write> writes;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = persist_.begin(); it != persist_.end();)
+        {
+            auto &persist = it->second;
+            if (persist.writing)
+            {
+                ++it;
+                continue;
+            }
+            if (persist.target == persist.persisted)
+            {
+                it = persist_.erase(it);
+                continue;
+            }
+            persist.writing = true;
+            persist.sending = persist.target;
+            writes.push_back({it->first, persist.target, persist.persisted});
+            ++it;
+        }
+    }
+
+    // 条件写：库中仍是上次写入的状态才覆盖，期间被 PUT 改过的以库为准
+    const std::string sql = "update order_table set order_status = ? where order_id = ? and order_status = ?";
+    for (auto &write : writes)
+    {
+        if (wait)
+        {
+            try
+            {
+                auto result = dbClient_->execSqlSync(sql, write.target, write.orderId, write.persisted);
+                written(write.orderId, write.target, result.affectedRows());
+            }
+            catch (const DrogonDbException &e)
+            {
+                LOG_ERROR << "Failed to write status of order " << write.orderId << ": " << e.base().what();
+            }
+            continue;
+        }
+        dbClient_->execSqlAsync(
+            sql,
+            [this, orderId = write.orderId, sent = write.target](const Result &result)
+            { written(orderId, sent, result.affectedRows()); },
+            [this, orderId = write.orderId](const DrogonDbException &e)
+            {
+                // 下个周期重试
+                LOG_ERROR << "Failed to write status of order " << orderId << ": " << e.base().what();
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = persist_.find(orderId);
+                if (it != persist_.end())
+                    it->second.writing = false;
+            },
+            write.target,
+            write.orderId,
+            write.persisted);
+    }
+}
+
+void KitchenOrders::written(uint32_t orderId, const std::string &sent, size_t affectedRows)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = persist_.find(orderId);
+        // 写库期间库中状态被他处改写，已按库中状态重读
+        if (it == persist_.end() || !it->second.writing || it->second.sending != sent)
+            return;
+        if (affectedRows != 0)
+        {
+            it->second.persisted = sent;
+            it->second.writing = false;
+            if (it->second.target == sent)
+                persist_.erase(it);
+            return;
+        }
+        persist_.erase(it);
+    }
+    LOG_WARN << "Status of order " << orderId << " was changed elsewhere, reloading";
+    orderChanged(orderId);
+}
+
+Json::Value KitchenOrders::queueOf(uint32_t branchId, size_t limit) const
+{
+    std::vector<KitchenQueue::Ticket> tickets;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tickets = queue_.list(branchId, limit);
+    }
+    Json::Value orders(Json::arrayValue);
+    for (const auto &ticket : tickets)
+        orders.append(toJson(ticket));
+    return orders;
+}
+
+Json::Value KitchenOrders::toJson(const KitchenQueue::Ticket &ticket)
+{
+    Json::Value ret;
+    ret["order_id"] = ticket.orderId;
+    ret["tenant_id"] = ticket.tenantId;
+    ret["branch_id"] = ticket.branchId;
+    ret["order_status"] = OrderFlow::name(ticket.status);
+    ret["kind"] = KitchenQueue::kindName(ticket.kind);
+    ret["table_number"] = ticket.table;
+    ret["payment_status"] = ticket.payment;
+    ret["remark"] = ticket.remark;
+    ret["items"] = ticket.items;
+    ret["placed_at"] = trantor::Date(ticket.placedAt * 1000000).toDbStringLocal();
+    ret["status_at"] = trantor::Date(ticket.changedAt * 1000000).toDbStringLocal();
+    return ret;
+}
+
+KitchenOrders::Message KitchenOrders::upsert(const KitchenQueue::Ticket &ticket)
+{
+    Json::Value message;
+    message["type"] = "upsert";
+    message["data"] = toJson(ticket);
+    return Message{ticket.branchId, compact(message)};
+}
+
+KitchenOrders::Message KitchenOrders::removal(uint32_t branchId, uint32_t orderId, const std::string &status)
+{
+    Json::Value message;
+    message["type"] = "remove";
+    message["data"]["order_id"] = orderId;
+    message["data"]["order_status"] = status;
+    return Message{branchId, compact(message)};
+}
+
+void KitchenOrders::subscribe(uint32_t branchId, const WebSocketConnectionPtr &conn)
+{
+    conn->setContext(std::make_shared<uint32_t>(branchId));
+    std::lock_guard<std::mutex> lock(connMutex_);
+    connections_[branchId].insert(conn);
+}
+
+void KitchenOrders::unsubscribe(const WebSocketConnectionPtr &conn)
+{
+    auto branchId = conn->getContext<uint32_t>();
+    if (!branchId)
+        return;
+    std::lock_guard<std::mutex> lock(connMutex_);
+    auto it = connections_.find(*branchId);
+    if (it == connections_.end())
+        return;
+    it->second.erase(conn);
+    if (it->second.empty())
+        connections_.erase(it);
+}
+
+void KitchenOrders::publish(const std::vector<Message> &messages)
+{
+    if (messages.empty())
+        return;
+    std::lock_guard<std::mutex> lock(connMutex_);
+    for (const auto &message : messages)
+    {
+        auto it = connections_.find(message.branchId);
+        if (it == connections_.end())
+            continue;
+        for (auto &conn : it->second)
+            conn->send(message.payload);
+    }
+}
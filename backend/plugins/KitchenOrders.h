@@ -0,0 +1,97 @@
+/**
+ *
+ *  KitchenOrders.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/WebSocketConnection.h>
+#include <drogon/orm/DbClient.h>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "KitchenQueue.h"
+#include "OrderTable.h"
+
+/**
+ * @brief 各分店厨房的活跃订单队列，推送给已连接的厨显。
+ *
+ * 启动时加载全部未到终态、带 branch_id 的订单，之后随订单创建、修改、删除更新，
+ * 到终态即移出内存。厨房推进状态时先改内存并推送，再按 flush_interval 合并写回 order_table：
+ * 同一订单多次推进只写最后的状态，写库条件为库中仍是上次写入的状态，被他处改过时以库中为准重读。
+ */
+class KitchenOrders : public drogon::Plugin<KitchenOrders>
+{
+public:
+  KitchenOrders() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  void orderCreated(const drogon_model::saas_restaurant::OrderTable &order);
+  /// 订单修改或删除后按主键重读
+  void orderChanged(uint32_t orderId);
+
+  /// 队列中订单的当前状态，可能尚未写库；不在队列中时返回 false
+  bool statusOf(uint32_t orderId, std::string &status) const;
+  /// 厨房推进状态，成功时 data 为推进后的订单
+  KitchenQueue::Move move(uint32_t orderId, OrderFlow::Status to, Json::Value &data);
+  /// 分店队列前 limit 个订单，按优先级排
+  Json::Value queueOf(uint32_t branchId, size_t limit) const;
+  size_t snapshotLimit() const { return snapshotLimit_; }
+
+  void subscribe(uint32_t branchId, const drogon::WebSocketConnectionPtr &conn);
+  void unsubscribe(const drogon::WebSocketConnectionPtr &conn);
+
+  static Json::Value toJson(const KitchenQueue::Ticket &ticket);
+
+  /// 写回已推进的状态，wait 时同步写完再返回
+  void flush(bool wait = false);
+
+private:
+  struct Persist
+  {
+    std::string persisted; // 库中的状态
+    std::string target;    // 内存中的状态
+    std::string sending;   // 写库中的状态
+    bool writing{false};
+  };
+  struct Message
+  {
+    uint32_t branchId;
+    std::string payload;
+  };
+
+  void load();
+  /// 订单在厨房队列中的样子，已删除、无分店或状态不认识时返回 false
+  bool ticketOf(const drogon_model::saas_restaurant::OrderTable &order, KitchenQueue::Ticket &ticket) const;
+  /// 用库中的订单更新队列，调用方持有 mutex_
+  void refresh(uint32_t orderId,
+               const drogon_model::saas_restaurant::OrderTable *order,
+               std::vector<Message> &messages);
+  void written(uint32_t orderId, const std::string &sent, size_t affectedRows);
+  void publish(const std::vector<Message> &messages);
+  static Message upsert(const KitchenQueue::Ticket &ticket);
+  static Message removal(uint32_t branchId, uint32_t orderId, const std::string &status);
+
+  drogon::orm::DbClientPtr dbClient_;
+  double flushInterval_{0.5};
+  size_t snapshotLimit_{200};
+  trantor::TimerId timerId_{0};
+
+  mutable std::mutex mutex_;
+  KitchenQueue queue_;
+  std::unordered_map<uint32_t, Persist> persist_; // 订单ID -> 待写回的状态
+
+  std::mutex connMutex_;
+  std::unordered_map<uint32_t, std::set<drogon::WebSocketConnectionPtr>> connections_;
+};
@@ -0,0 +1,105 @@
+/**
+ *
+ *  KitchenQueue.cc
+ *
+ */
+
+#include "KitchenQueue.h"
+#include <algorithm>
+
+KitchenQueue::Change KitchenQueue::put(Ticket ticket)
+{
+    auto it = tickets_.find(ticket.orderId);
+    if (!OrderFlow::active(ticket.status))
+    {
+        if (it == tickets_.end())
+            return Change::None;
+        unlink(it->second);
+        tickets_.erase(it);
+        return Change::Removed;
+    }
+    if (it != tickets_.end())
+        unlink(it->second);
+    branches_[ticket.branchId].emplace(rankOf(ticket), ticket.orderId);
+    auto orderId = ticket.orderId;
+    tickets_[orderId] = std::move(ticket);
+    return Change::Put;
+}
+
+bool KitchenQueue::remove(uint32_t orderId)
+{
+    auto it = tickets_.find(orderId);
+    if (it == tickets_.end())
+        return false;
+    unlink(it->second);
+    tickets_.erase(it);
+    return true;
+}
+
+const KitchenQueue::Ticket *KitchenQueue::find(uint32_t orderId) const
+{
+    auto it = tickets_.find(orderId);
+    return it == tickets_.end() ? nullptr : &it->second;
+}
+
+KitchenQueue::Move KitchenQueue::move(uint32_t orderId, OrderFlow::Status to, int64_t at, Ticket &ticket)
+{
+    auto it = tickets_.find(orderId);
+    if (it == tickets_.end())
+        return Move::NotFound;
+    if (!OrderFlow::canMove(it->second.status, to))
+        return Move::Rejected;
+    // 排序键与状态无关，留在原位
+    if (it->second.status != to)
+    {
+        it->second.status = to;
+        it->second.changedAt = at;
+    }
+    ticket = it->second;
+    if (!OrderFlow::active(to))
+    {
+        unlink(it->second);
+        tickets_.erase(it);
+    }
+    return Move::Moved;
+}
+
+std::vector<KitchenQueue::Ticket> KitchenQueue::list(uint32_t branchId, size_t limit) const
+{
+    std::vector<Ticket> result;
+    auto branch = branches_.find(branchId);
+    if (branch == branches_.end())
+        return result;
+    result.reserve(std::min(limit, branch->second.size()));
+    for (const auto &key : branch->second)
+    {
+        if (result.size() >= limit)
+            break;
+        result.push_back(tickets_.at(key.second));
+    }
+    return result;
+}
+
+const char *KitchenQueue::kindName(Kind kind)
+{
+    switch (kind)
+    {
+        case Kind::DineIn:
+            return "堂食";
+        case Kind::Takeaway:
+            return "外带";
+        case Kind::Delivery:
+            return "外卖";
+    }
+    return "";
+}
+
+void KitchenQueue::unlink(const Ticket &ticket)
+{
+    auto branch = branches_.find(ticket.branchId);
+    if (branch == branches_.end())
+        return;
+    branch->second.erase(Key(rankOf(ticket), ticket.orderId));
+    if (branch->second.empty())
+        branches_.erase(branch);
+}
@@ -0,0 +1,92 @@
+/**
+ *
+ *  KitchenQueue.h
+ *
+ */
+
+#pragma once
+
+#include <json/json.h>
+#include <array>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "OrderFlow.h"
+
+/**
+ * @brief 各分店厨房的活跃订单队列，只保存未到终态的订单。
+ *
+ * 优先级按下单时刻减去该类型的提前量排，越小越靠前；外卖等骑手、外带等顾客，可以给更大的提前量。
+ * 每个分店一个有序集合，增删改为 O(log n)，取队列前 k 个为 O(k)。
+ * 状态推进按 OrderFlow 校验，到终态即移出。不加锁，由调用方保证互斥。
+ */
+class KitchenQueue
+{
+public:
+  enum class Kind : uint8_t
+  {
+    DineIn,   // 堂食：有桌号
+    Takeaway, // 外带：无桌号、无配送地址
+    Delivery  // 外卖：有配送地址
+  };
+  struct Ticket
+  {
+    uint32_t orderId{0};
+    uint32_t tenantId{0};
+    uint32_t branchId{0};
+    OrderFlow::Status status{OrderFlow::Status::Pending};
+    Kind kind{Kind::DineIn};
+    int64_t placedAt{0};  // 下单时刻，秒
+    int64_t changedAt{0}; // 进入当前状态的时刻，秒
+    std::string table;
+    std::string payment;
+    std::string remark;
+    Json::Value items; // order_detail.items
+  };
+  enum class Change
+  {
+    None,
+    Put,    // 新增或更新
+    Removed // 到终态或被删除，移出队列
+  };
+  enum class Move
+  {
+    Moved,
+    NotFound, // 不在队列中（不存在或已到终态）
+    Rejected  // 状态机不允许
+  };
+
+  /// lead 按 Kind 排列，单位秒
+  explicit KitchenQueue(std::array<int64_t, 3> lead = {0, 0, 0}) : lead_(lead) {}
+
+  /// 插入或替换订单，终态订单移出
+  Change put(Ticket ticket);
+  bool remove(uint32_t orderId);
+  const Ticket *find(uint32_t orderId) const;
+  /// 推进状态，成功时 ticket 为推进后的订单
+  Move move(uint32_t orderId, OrderFlow::Status to, int64_t at, Ticket &ticket);
+
+  /// 分店队列前 limit 个订单，按优先级排
+  std::vector<Ticket> list(uint32_t branchId, size_t limit = SIZE_MAX) const;
+  /// 排序键，越小越靠前
+  int64_t rankOf(const Ticket &ticket) const
+  {
+    return ticket.placedAt - lead_[static_cast<size_t>(ticket.kind)];
+  }
+  size_t size() const { return tickets_.size(); }
+
+  static const char *kindName(Kind kind);
+
+private:
+  using Key = std::pair<int64_t, uint32_t>; // (排序键, 订单ID)
+
+  void unlink(const Ticket &ticket);
+
+  std::array<int64_t, 3> lead_;
+  std::unordered_map<uint32_t, Ticket> tickets_;
+  std::unordered_map<uint32_t, std::set<Key>> branches_;
+};
@@ -0,0 +1,52 @@
+/**
+ *
+ *  LevelLadder.cc
+ *
+ */
+
+#include "LevelLadder.h"
+#include <algorithm>
+#include <tuple>
+
+LevelLadder::LevelLadder(std::vector<Level> levels)
+{
+    std::sort(levels.begin(), levels.end(), [](const Level &a, const Level &b) {
+        return std::make_tuple(a.requiredSpent, a.requiredPoints, a.levelId) <
+               std::make_tuple(b.requiredSpent, b.requiredPoints, b.levelId);
+    });
+    int64_t points = 0;
+    Money spent;
+    for (const auto &level : levels)
+    {
+        points = std::max(points, level.requiredPoints);
+        spent = std::max(spent, level.requiredSpent);
+        levels_.push_back(level.levelId);
+        points_.push_back(points);
+        spent_.push_back(spent);
+    }
+}
+
+int LevelLadder::rankFor(int64_t points, Money spent) const
+{
+    auto byPoints = std::upper_bound(points_.begin(), points_.end(), points) - points_.begin();
+    auto bySpent = std::upper_bound(spent_.begin(), spent_.end(), spent) - spent_.begin();
+    return static_cast<int>(std::min(byPoints, bySpent)) - 1;
+}
+
+uint32_t LevelLadder::levelFor(int64_t points, Money spent) const
+{
+    auto rank = rankFor(points, spent);
+    return rank < 0 ? 0 : levels_[rank];
+}
+
+int LevelLadder::rankOf(uint32_t levelId) const
+{
+    auto it = std::find(levels_.begin(), levels_.end(), levelId);
+    return it == levels_.end() ? -1 : static_cast<int>(it - levels_.begin());
+}
+
+uint32_t LevelLadder::upgrade(uint32_t currentLevel, int64_t points, Money spent) const
+{
+    auto rank = rankFor(points, spent);
+    return rank > rankOf(currentLevel) ? levels_[rank] : 0;
+}
@@ -0,0 +1,51 @@
+/**
+ *
+ *  LevelLadder.h
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Money.h"
+
+/**
+ * @brief 单个租户的会员等级阶梯，按门槛排好序后二分查找会员应处的等级。
+ *
+ * 等级按 (required_spent, required_points, level_id) 升序排成阶梯，累计积分和累计消费都达到门槛才算满足；
+ * 每级门槛取自身与下面各级的较大值，满足的等级总是阶梯的一个前缀，两列各二分一次后取较低者。
+ */
+class LevelLadder
+{
+public:
+  struct Level
+  {
+    uint32_t levelId{0};
+    int64_t requiredPoints{0};
+    Money requiredSpent;
+  };
+
+  LevelLadder() = default;
+  explicit LevelLadder(std::vector<Level> levels);
+
+  /// 满足门槛的最高等级，一级都不满足时为 0
+  uint32_t levelFor(int64_t points, Money spent) const;
+  /// 只升不降：应升到的等级，不需要升级时为 0；当前等级不在阶梯中时视为最低
+  uint32_t upgrade(uint32_t currentLevel, int64_t points, Money spent) const;
+  /// 等级在阶梯中的位次，不在阶梯中为 -1
+  int rankOf(uint32_t levelId) const;
+  size_t size() const { return levels_.size(); }
+  bool operator==(const LevelLadder &other) const
+  {
+    return levels_ == other.levels_ && points_ == other.points_ && spent_ == other.spent_;
+  }
+
+private:
+  int rankFor(int64_t points, Money spent) const;
+
+  std::vector<uint32_t> levels_; // 按阶梯顺序的等级ID
+  std::vector<int64_t> points_;  // 累计最大值，单调不减
+  std::vector<Money> spent_;     // 同上
+};
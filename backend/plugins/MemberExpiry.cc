@@ -0,0 +1,216 @@
+/**
+ *
+ *  MemberExpiry.cc
+ *
+ */
+
+#include "MemberExpiry.h"
+#include "MemberSegments.h"
+#include "PricingEngine.h"
+#include <drogon/drogon.h>
+#include <algorithm>
+#include <atomic>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+namespace
+{
+const std::string kExpired = "已过期";
+const std::string kExpiryEvent = "会员到期";
+} // namespace
+
+void MemberExpiry::initAndStart(const Json::Value &config)
+{
+    dbClient_ = app().getDbClient(config.get("db_client", "default").asString());
+    batchSize_ = std::max(config.get("batch_size", 200).asUInt(), 1u);
+
+    load();
+
+    timerId_ = app().getLoop()->runEvery(60.0, [this]() { tick(); });
+    app().getLoop()->queueInLoop([this]() { tick(); });
+}
+
+void MemberExpiry::shutdown()
+{
+    app().getLoop()->invalidateTimer(timerId_);
+}
+
+int32_t MemberExpiry::dayOf(int64_t at)
+{
+    // 按本地自然日，加半天避免夏令时切换造成的偏差
+    auto midnight = trantor::Date(at * 1000000).roundDay().microSecondsSinceEpoch();
+    return static_cast<int32_t>((midnight + 43200LL * 1000000) / (86400LL * 1000000));
+}
+
+void MemberExpiry::load()
+{
+    try
+    {
+        auto members = dbClient_->execSqlSync(
+            "select member_id, unix_timestamp(expire_date) as expire_at from member "
+            "where expire_date is not null and (status is null or status <> ?) "
+            "and (is_deleted = 0 or is_deleted is null)",
+            kExpired);
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &row : members)
+        {
+            auto expireAt = row["expire_at"].as<int64_t>();
+            buckets_.set(row["member_id"].as<uint32_t>(), expireAt, dayOf(expireAt));
+        }
+        LOG_INFO << "Member expiry loaded " << buckets_.size() << " members in " << buckets_.bucketCount() << " days";
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to load member expiry: " << e.base().what();
+    }
+}
+
+void MemberExpiry::memberChanged(uint32_t memberId)
+{
+    dbClient_->execSqlAsync(
+        "select unix_timestamp(expire_date) as expire_at, status, is_deleted from member where member_id = ?",
+        [this, memberId](const Result &result)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (result.empty() || result[0]["expire_at"].isNull() ||
+                (!result[0]["status"].isNull() && result[0]["status"].as<std::string>() == kExpired) ||
+                (!result[0]["is_deleted"].isNull() && result[0]["is_deleted"].as<int>() == 1))
+            {
+                buckets_.remove(memberId);
+                return;
+            }
+            auto expireAt = result[0]["expire_at"].as<int64_t>();
+            buckets_.set(memberId, expireAt, dayOf(expireAt));
+        },
+        [memberId](const DrogonDbException &e)
+        { LOG_ERROR << "Failed to refresh expiry of member " << memberId << ": " << e.base().what(); },
+        memberId);
+}
+
+void MemberExpiry::tick()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sweeping_)
+            return;
+        sweeping_ = true;
+    }
+    sweep();
+}
+
+void MemberExpiry::restore(const std::vector<std::pair<uint32_t, int64_t>> &batch)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &[memberId, expireAt] : batch)
+    {
+        if (!buckets_.contains(memberId))
+            buckets_.set(memberId, expireAt, dayOf(expireAt));
+    }
+    sweeping_ = false;
+}
+
+void MemberExpiry::sweep()
+{
+    auto now = trantor::Date::now();
+    auto batch = std::make_shared<std::vector<std::pair<uint32_t, int64_t>>>();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        *batch = buckets_.takeDue(now.secondsSinceEpoch(), dayOf(now.secondsSinceEpoch()), batchSize_);
+        if (batch->empty())
+        {
+            sweeping_ = false;
+            return;
+        }
+    }
+    auto at = now.toDbStringLocal();
+    dbClient_->newTransactionAsync(
+        [this, batch, at](const std::shared_ptr<Transaction> &transaction)
+        {
+            if (!transaction)
+            {
+                LOG_ERROR << "Failed to start member expiry transaction";
+                restore(*batch);
+                return;
+            }
+            auto failed = std::make_shared<std::atomic<bool>>(false);
+            auto expired = std::make_shared<std::vector<uint32_t>>();
+            transaction->setCommitCallback(
+                [this, batch, failed, expired](bool committed)
+                {
+                    if (*failed)
+                        return;
+                    if (!committed)
+                    {
+                        LOG_ERROR << "Failed to commit member expiry";
+                        restore(*batch);
+                        return;
+                    }
+                    // 过期后不再享受等级折扣
+                    for (auto memberId : *expired)
+                    {
+                        app().getPlugin<MemberSegments>()->memberChanged(memberId);
+                        app().getPlugin<PricingEngine>()->memberChanged(memberId);
+                    }
+                    LOG_INFO << "Member expiry: " << expired->size() << " of " << batch->size() << " due members expired";
+                    app().getLoop()->queueInLoop([this]() { sweep(); });
+                });
+            // 出错时事务自动回滚且不再触发提交回调，在这里放回，只放回一次
+            auto onError = [this, batch, failed](const DrogonDbException &e)
+            {
+                LOG_ERROR << "Failed to expire members: " << e.base().what();
+                if (!failed->exchange(true))
+                    restore(*batch);
+            };
+
+            // 加锁复查，期间续期、删除或已过期的会员跳过
+            std::string sql =
+                "select member_id, tenant_id, coalesce(points, 0) as points from member where expire_date <= ? "
+                "and (status is null or status <> ?) and (is_deleted = 0 or is_deleted is null) and member_id in (";
+            for (size_t i = 0; i < batch->size(); ++i)
+                sql += i == 0 ? "?" : ", ?";
+            sql += ") for update";
+            auto binder = *transaction << std::move(sql);
+            binder << at << kExpired;
+            for (const auto &entry : *batch)
+                binder << entry.first;
+            binder >> [transaction, at, expired, onError](const Result &rows)
+            {
+                if (rows.empty())
+                    return;
+                std::string update = "update member set status = ?, points = 0 where member_id in (";
+                std::string events =
+                    "insert into consumption_record (created_at, amount, order_items, member_id, tenant_id, points) values ";
+                for (size_t i = 0; i < rows.size(); ++i)
+                {
+                    update += i == 0 ? "?" : ", ?";
+                    events += i == 0 ? "(?, 0, ?, ?, ?, ?)" : ", (?, 0, ?, ?, ?, ?)";
+                }
+                update += ")";
+
+                {
+                    auto updateBinder = *transaction << std::move(update);
+                    updateBinder << kExpired;
+                    for (const auto &row : rows)
+                        updateBinder << row["member_id"].as<uint32_t>();
+                    updateBinder >> [](const Result &) {};
+                    updateBinder >> onError;
+                }
+                auto eventBinder = *transaction << std::move(events);
+                for (const auto &row : rows)
+                {
+                    auto memberId = row["member_id"].as<uint32_t>();
+                    expired->push_back(memberId);
+                    eventBinder << at << kExpiryEvent << memberId;
+                    if (row["tenant_id"].isNull())
+                        eventBinder << nullptr;
+                    else
+                        eventBinder << row["tenant_id"].as<uint32_t>();
+                    eventBinder << std::to_string(-row["points"].as<int64_t>());
+                }
+                eventBinder >> [](const Result &) {};
+                eventBinder >> onError;
+            };
+            binder >> onError;
+        });
+}
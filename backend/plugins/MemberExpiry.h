@@ -0,0 +1,58 @@
+/**
+ *
+ *  MemberExpiry.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/orm/DbClient.h>
+#include <trantor/net/EventLoop.h>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "ExpiryBuckets.h"
+
+/**
+ * @brief 会员到期：到 expire_date 时把会员状态改为“已过期”并清零可用积分。
+ *
+ * 启动时把未过期、设置了有效期的会员按到期日放入 ExpiryBuckets，之后随会员增删改刷新。
+ * 每分钟只取已到期的会员，每 batch_size 个一个小事务：带条件加锁复查、改写状态和积分，
+ * 并为每个会员写一条金额为 0、积分为负的“会员到期”消费记录作为事件；一批提交后再取下一批，
+ * 不会长时间锁住会员表。失败的一批放回队列，下一分钟重试。
+ */
+class MemberExpiry : public drogon::Plugin<MemberExpiry>
+{
+public:
+  MemberExpiry() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  /// 会员增删改后按主键重新读取有效期
+  void memberChanged(uint32_t memberId);
+
+private:
+  static int32_t dayOf(int64_t at);
+  void load();
+  void tick();
+  /// 过期一批，提交后继续下一批，没有到期会员时停止
+  void sweep();
+  /// 把未处理的一批放回队列，期间被重新设置过有效期的会员除外
+  void restore(const std::vector<std::pair<uint32_t, int64_t>> &batch);
+
+  drogon::orm::DbClientPtr dbClient_;
+  trantor::TimerId timerId_{0};
+  size_t batchSize_{200};
+
+  std::mutex mutex_;
+  ExpiryBuckets buckets_;
+  bool sweeping_{false};
+};
@@ -0,0 +1,293 @@
+/**
+ *
+ *  MemberLevels.cc
+ *
+ */
+
+#include "MemberLevels.h"
+#include "MemberSegments.h"
+#include "PricingEngine.h"
+#include <drogon/drogon.h>
+#include <algorithm>
+#include <charconv>
+#include <map>
+
+using namespace drogon;
+using namespace drogon::orm;
+using namespace drogon_model::saas_restaurant;
+
+namespace
+{
+// 批量改写时每条语句的会员数
+constexpr size_t kIdsPerUpdate = 1000;
+
+// 消费记录的积分是文本列，不是非负整数时按 0 计
+int64_t pointsOf(const std::string &text)
+{
+    int64_t points = 0;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), points);
+    if (ec != std::errc() || end != text.data() + text.size() || points < 0)
+        return 0;
+    return points;
+}
+} // namespace
+
+void MemberLevels::initAndStart(const Json::Value &config)
+{
+    dbClient_ = app().getDbClient(config.get("db_client", "default").asString());
+    workers_ = std::max(config.get("workers", 4).asUInt(), 1u);
+    reevaluateDelay_ = config.get("reevaluate_delay", 5.0).asDouble();
+    batchQueue_ = std::make_unique<trantor::ConcurrentTaskQueue>(workers_, "MemberLevels");
+
+    try
+    {
+        replaceLadders(dbClient_->execSqlSync(
+            "select level_id, tenant_id, required_points, required_spent from member_level where tenant_id is not null"));
+        LOG_INFO << "Member levels loaded " << ladders_.size() << " tenants";
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to load member levels: " << e.base().what();
+    }
+}
+
+void MemberLevels::shutdown()
+{
+    batchQueue_.reset();
+}
+
+std::shared_ptr<const LevelLadder> MemberLevels::ladderOf(uint32_t tenantId) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = ladders_.find(tenantId);
+    return it == ladders_.end() ? nullptr : it->second;
+}
+
+std::vector<uint32_t> MemberLevels::replaceLadders(const Result &levels)
+{
+    std::unordered_map<uint32_t, std::vector<LevelLadder::Level>> byTenant;
+    for (const auto &row : levels)
+    {
+        LevelLadder::Level level;
+        level.levelId = row["level_id"].as<uint32_t>();
+        // 未设门槛的一列按 0 计
+        level.requiredPoints = row["required_points"].isNull() ? 0 : row["required_points"].as<int64_t>();
+        if (!row["required_spent"].isNull())
+            level.requiredSpent = Money::fromString(row["required_spent"].as<std::string>());
+        byTenant[row["tenant_id"].as<uint32_t>()].push_back(level);
+    }
+    std::unordered_map<uint32_t, std::shared_ptr<const LevelLadder>> ladders;
+    for (auto &[tenantId, tenantLevels] : byTenant)
+        ladders.emplace(tenantId, std::make_shared<const LevelLadder>(std::move(tenantLevels)));
+
+    std::vector<uint32_t> changed;
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    for (const auto &[tenantId, ladder] : ladders)
+    {
+        auto it = ladders_.find(tenantId);
+        if (it == ladders_.end() || !(*it->second == *ladder))
+            changed.push_back(tenantId);
+    }
+    // 等级全部删除的租户不再升级，已有等级保持不变
+    ladders_.swap(ladders);
+    return changed;
+}
+
+void MemberLevels::schedule(const std::vector<uint32_t> &tenantIds)
+{
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    for (auto tenantId : tenantIds)
+    {
+        if (!pending_.insert(tenantId).second)
+            continue;
+        app().getLoop()->runAfter(reevaluateDelay_, [this, tenantId]() { reevaluate(tenantId); });
+    }
+}
+
+void MemberLevels::levelChanged(uint32_t levelId)
+{
+    dbClient_->execSqlAsync(
+        "select level_id, tenant_id, required_points, required_spent from member_level where tenant_id is not null",
+        [this](const Result &levels) { schedule(replaceLadders(levels)); },
+        [levelId](const DrogonDbException &e)
+        { LOG_ERROR << "Failed to reload member levels after level " << levelId << ": " << e.base().what(); });
+}
+
+void MemberLevels::upgraded(uint32_t tenantId, uint32_t memberId, uint32_t levelId) const
+{
+    app().getPlugin<PricingEngine>()->memberLevelChanged(tenantId, memberId, levelId);
+    app().getPlugin<MemberSegments>()->memberLevelChanged(memberId, levelId);
+}
+
+void MemberLevels::evaluate(const std::shared_ptr<Transaction> &transaction,
+                            uint32_t memberId,
+                            Evaluated &&evaluated,
+                            Failed &&failed)
+{
+    auto evaluatedPtr = std::make_shared<Evaluated>(std::move(evaluated));
+    auto failedPtr = std::make_shared<Failed>(std::move(failed));
+    transaction->execSqlAsync(
+        "select tenant_id, level_id, total_points, total_spent, is_deleted from member where member_id = ?",
+        [this, transaction, memberId, evaluatedPtr, failedPtr](const Result &result)
+        {
+            if (result.empty() || result[0]["tenant_id"].isNull() ||
+                (!result[0]["is_deleted"].isNull() && result[0]["is_deleted"].as<int>() == 1))
+            {
+                (*evaluatedPtr)(0, 0);
+                return;
+            }
+            const auto &row = result[0];
+            auto tenantId = row["tenant_id"].as<uint32_t>();
+            auto ladder = ladderOf(tenantId);
+            auto levelId = !ladder ? 0
+                                   : ladder->upgrade(row["level_id"].isNull() ? 0 : row["level_id"].as<uint32_t>(),
+                                                     row["total_points"].isNull() ? 0 : row["total_points"].as<int64_t>(),
+                                                     row["total_spent"].isNull()
+                                                         ? Money()
+                                                         : Money::fromString(row["total_spent"].as<std::string>()));
+            if (levelId == 0)
+            {
+                (*evaluatedPtr)(tenantId, 0);
+                return;
+            }
+            transaction->execSqlAsync(
+                "update member set level_id = ? where member_id = ?",
+                [evaluatedPtr, tenantId, levelId](const Result &) { (*evaluatedPtr)(tenantId, levelId); },
+                [failedPtr, memberId](const DrogonDbException &e)
+                {
+                    LOG_ERROR << "Failed to upgrade member " << memberId << ": " << e.base().what();
+                    (*failedPtr)();
+                },
+                levelId,
+                memberId);
+        },
+        [failedPtr, memberId](const DrogonDbException &e)
+        {
+            LOG_ERROR << "Failed to evaluate level of member " << memberId << ": " << e.base().what();
+            (*failedPtr)();
+        },
+        memberId);
+}
+
+void MemberLevels::consumptionCreated(const std::shared_ptr<Transaction> &transaction,
+                                      const ConsumptionRecord &record,
+                                      Evaluated &&evaluated,
+                                      Failed &&failed)
+{
+    if (!record.getMemberId())
+    {
+        evaluated(0, 0);
+        return;
+    }
+    auto memberId = record.getValueOfMemberId();
+    auto points = pointsOf(record.getValueOfPoints());
+    auto evaluatedPtr = std::make_shared<Evaluated>(std::move(evaluated));
+    auto failedPtr = std::make_shared<Failed>(std::move(failed));
+    transaction->execSqlAsync(
+        "update member set total_spent = coalesce(total_spent, 0) + ?, "
+        "total_points = coalesce(total_points, 0) + ?, points = coalesce(points, 0) + ? where member_id = ?",
+        [this, transaction, memberId, evaluatedPtr, failedPtr](const Result &)
+        {
+            evaluate(transaction,
+                     memberId,
+                     [evaluatedPtr](uint32_t tenantId, uint32_t levelId) { (*evaluatedPtr)(tenantId, levelId); },
+                     [failedPtr]() { (*failedPtr)(); });
+        },
+        [failedPtr, memberId](const DrogonDbException &e)
+        {
+            LOG_ERROR << "Failed to accumulate consumption of member " << memberId << ": " << e.base().what();
+            (*failedPtr)();
+        },
+        Money::fromString(record.getValueOfAmount()).toString(),
+        points,
+        points,
+        memberId);
+}
+
+void MemberLevels::reevaluate(uint32_t tenantId)
+{
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        pending_.erase(tenantId);
+    }
+    auto ladder = ladderOf(tenantId);
+    if (!ladder)
+        return;
+    dbClient_->execSqlAsync(
+        "select member_id, level_id, total_points, total_spent from member "
+        "where tenant_id = ? and (is_deleted = 0 or is_deleted is null)",
+        [this, tenantId, ladder](const Result &result)
+        {
+            if (result.empty())
+                return;
+            auto rows = std::make_shared<const Result>(result);
+            auto slice = (rows->size() + workers_ - 1) / workers_;
+            for (size_t begin = 0; begin < rows->size(); begin += slice)
+            {
+                auto end = std::min(begin + slice, rows->size());
+                batchQueue_->runTaskInQueue([this, tenantId, ladder, rows, begin, end]()
+                                            {
+                    // 按 (原等级, 新等级) 分组，一组一条语句
+                    std::map<std::pair<uint32_t, uint32_t>, std::vector<uint32_t>> moves;
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        const auto &row = (*rows)[i];
+                        auto from = row["level_id"].isNull() ? 0 : row["level_id"].as<uint32_t>();
+                        auto to = ladder->upgrade(from,
+                                                  row["total_points"].isNull() ? 0 : row["total_points"].as<int64_t>(),
+                                                  row["total_spent"].isNull()
+                                                      ? Money()
+                                                      : Money::fromString(row["total_spent"].as<std::string>()));
+                        if (to != 0)
+                            moves[{from, to}].push_back(row["member_id"].as<uint32_t>());
+                    }
+
+                    size_t moved = 0;
+                    for (const auto &[step, ids] : moves)
+                    {
+                        for (size_t first = 0; first < ids.size(); first += kIdsPerUpdate)
+                        {
+                            auto last = std::min(first + kIdsPerUpdate, ids.size());
+                            std::string sql = "update member set level_id = ? where tenant_id = ? and coalesce(level_id, 0) = ? "
+                                              "and member_id in (";
+                            for (size_t i = first; i < last; ++i)
+                                sql += i == first ? "?" : ", ?";
+                            sql += ")";
+                            size_t affected = 0;
+                            try
+                            {
+                                auto binder = *dbClient_ << std::move(sql);
+                                binder << step.second << tenantId << step.first;
+                                for (size_t i = first; i < last; ++i)
+                                    binder << ids[i];
+                                binder << Mode::Blocking;
+                                binder >> [&affected](const Result &r) { affected = r.affectedRows(); };
+                                binder.exec();
+                            }
+                            catch (const DrogonDbException &e)
+                            {
+                                LOG_ERROR << "Failed to upgrade members of tenant " << tenantId << ": " << e.base().what();
+                                continue;
+                            }
+                            moved += affected;
+                            for (size_t i = first; i < last; ++i)
+                            {
+                                // 有会员在重评期间已被改过等级时，逐个回读
+                                if (affected == last - first)
+                                    upgraded(tenantId, ids[i], step.second);
+                                else
+                                {
+                                    app().getPlugin<PricingEngine>()->memberChanged(ids[i]);
+                                    app().getPlugin<MemberSegments>()->memberChanged(ids[i]);
+                                }
+                            }
+                        }
+                    }
+                    LOG_DEBUG << "Member levels of tenant " << tenantId << " reevaluated, " << moved << " of "
+                              << end - begin << " members upgraded"; });
+            }
+        },
+        [tenantId](const DrogonDbException &e)
+        { LOG_ERROR << "Failed to load members of tenant " << tenantId << " for level reevaluation: " << e.base().what(); },
+        tenantId);
+}
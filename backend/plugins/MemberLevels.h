@@ -0,0 +1,84 @@
+/**
+ *
+ *  MemberLevels.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/orm/DbClient.h>
+#include <drogon/orm/Transaction.h>
+#include <trantor/utils/ConcurrentTaskQueue.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "ConsumptionRecord.h"
+#include "LevelLadder.h"
+
+/**
+ * @brief 会员等级自动升级，按租户常驻等级阶梯。
+ *
+ * 新增消费记录和修改会员累计值时，在调用方的事务中累加、读回累计值，二分查出应处等级，
+ * 需要升级时在同一事务中改写 level_id，提交后再同步到计价和分群。只升不降。
+ * 等级定义增删改后重载阶梯，阶梯有变化的租户在 reevaluate_delay 秒后由线程池分片整体重评，
+ * 按 (原等级, 新等级) 分组批量改写，条件中带原等级，与并发的单个评估不冲突。
+ */
+class MemberLevels : public drogon::Plugin<MemberLevels>
+{
+public:
+  MemberLevels() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  /// 评估完成，levelId 为升到的等级，未升级为 0
+  using Evaluated = std::function<void(uint32_t tenantId, uint32_t levelId)>;
+  /// 语句出错，事务已回滚，调用方的提交回调不会再触发
+  using Failed = std::function<void()>;
+
+  /// 在事务中把消费记录的金额、积分累加到会员并评估等级
+  void consumptionCreated(const std::shared_ptr<drogon::orm::Transaction> &transaction,
+                          const drogon_model::saas_restaurant::ConsumptionRecord &record,
+                          Evaluated &&evaluated,
+                          Failed &&failed);
+  /// 在事务中按会员当前的累计值评估等级
+  void evaluate(const std::shared_ptr<drogon::orm::Transaction> &transaction,
+                uint32_t memberId,
+                Evaluated &&evaluated,
+                Failed &&failed);
+  /// 事务提交后把升级同步到计价和分群
+  void upgraded(uint32_t tenantId, uint32_t memberId, uint32_t levelId) const;
+
+  void levelChanged(uint32_t levelId);
+  /// 按当前阶梯整体重评租户的会员
+  void reevaluate(uint32_t tenantId);
+
+private:
+  std::shared_ptr<const LevelLadder> ladderOf(uint32_t tenantId) const;
+  /// 用 member_level 的全部行替换阶梯，返回阶梯有变化的租户
+  std::vector<uint32_t> replaceLadders(const drogon::orm::Result &levels);
+  /// 重载后阶梯有变化的租户稍后整体重评，期间的多次修改只重评一次
+  void schedule(const std::vector<uint32_t> &tenantIds);
+
+  drogon::orm::DbClientPtr dbClient_;
+  std::unique_ptr<trantor::ConcurrentTaskQueue> batchQueue_;
+  size_t workers_{4};
+  double reevaluateDelay_{5.0};
+
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<uint32_t, std::shared_ptr<const LevelLadder>> ladders_;
+
+  std::mutex pendingMutex_;
+  std::unordered_set<uint32_t> pending_; // 已排队等待重评的租户
+};
@@ -0,0 +1,272 @@
+/**
+ *
+ *  MemberRfm.cc
+ *
+ */
+
+#include "MemberRfm.h"
+#include "MemberSegments.h"
+#include "Money.h"
+#include <drogon/drogon.h>
+#include <algorithm>
+#include <mutex>
+
+using namespace drogon;
+using namespace drogon::orm;
+using namespace drogon_model::saas_restaurant;
+
+namespace
+{
+// to_days('1970-01-01')，数据库按本地日期算出的天数与 dayOf 一致
+constexpr int32_t kEpochDays = 719528;
+} // namespace
+
+struct MemberRfm::Run
+{
+    uint32_t mark{0}; // 本次全量读取的最大 record_id
+    std::atomic<size_t> remaining{0};
+    std::atomic<bool> failed{false};
+    std::mutex mutex;
+    std::unordered_map<uint32_t, RfmTable> tenants;
+};
+
+void MemberRfm::initAndStart(const Json::Value &config)
+{
+    dbClient_ = app().getDbClient(config.get("db_client", "default").asString());
+    batchHour_ = config.get("batch_hour", 4).asInt();
+    pageSize_ = std::max(config.get("page_size", 5000).asUInt(), 100u);
+    partitionRows_ = std::max<uint64_t>(config.get("partition_rows", 200000).asUInt64(), pageSize_);
+    batchQueue_ = std::make_unique<trantor::ConcurrentTaskQueue>(config.get("batch_threads", 4).asUInt(), "MemberRfm");
+
+    runBatch();
+    scheduleBatch();
+}
+
+void MemberRfm::shutdown()
+{
+    stopping_ = true;
+    app().getLoop()->invalidateTimer(timerId_);
+    batchQueue_.reset();
+}
+
+int32_t MemberRfm::dayOf(const trantor::Date &at)
+{
+    // 按本地自然日，加半天避免夏令时切换造成的偏差
+    auto midnight = at.roundDay().microSecondsSinceEpoch();
+    return static_cast<int32_t>((midnight + 43200LL * 1000000) / (86400LL * 1000000));
+}
+
+void MemberRfm::scheduleBatch()
+{
+    // 每天 batch_hour 点全量重算
+    auto now = trantor::Date::now();
+    auto next = now.roundDay().after(3600.0 * batchHour_);
+    if (next.microSecondsSinceEpoch() <= now.microSecondsSinceEpoch())
+        next = next.after(86400.0);
+    timerId_ = app().getLoop()->runAt(next, [this]()
+                                      {
+        runBatch();
+        scheduleBatch(); });
+}
+
+void MemberRfm::runBatch()
+{
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (running_)
+            return;
+        running_ = true;
+        deltas_.clear();
+    }
+    auto fail = [this](const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to plan RFM batch: " << e.base().what();
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        running_ = false;
+        deltas_.clear();
+    };
+    dbClient_->execSqlAsync(
+        "select coalesce(max(record_id), 0) as mark from consumption_record",
+        [this, fail](const Result &result)
+        {
+            auto run = std::make_shared<Run>();
+            run->mark = result[0]["mark"].as<uint32_t>();
+            dbClient_->execSqlAsync(
+                "select tenant_id, min(member_id) as first_member, max(member_id) as last_member, count(*) as n "
+                "from consumption_record where tenant_id is not null and member_id is not null and amount > 0 "
+                "and record_id <= ? group by tenant_id",
+                [this, run](const Result &tenants)
+                {
+                    // 每个租户按会员ID区间切成约 partition_rows 条记录一片
+                    struct Partition
+                    {
+                        uint32_t tenantId;
+                        uint32_t firstMember;
+                        uint32_t lastMember;
+                    };
+                    std::vector<Partition> partitions;
+                    for (const auto &row : tenants)
+                    {
+                        auto tenantId = row["tenant_id"].as<uint32_t>();
+                        auto first = row["first_member"].as<uint64_t>();
+                        auto last = row["last_member"].as<uint64_t>();
+                        auto pieces = std::max<uint64_t>((row["n"].as<uint64_t>() + partitionRows_ - 1) / partitionRows_, 1);
+                        auto step = std::max<uint64_t>((last - first + 1 + pieces - 1) / pieces, 1);
+                        for (auto lo = first; lo <= last; lo += step)
+                            partitions.push_back(Partition{tenantId,
+                                                           static_cast<uint32_t>(lo),
+                                                           static_cast<uint32_t>(std::min(lo + step - 1, last))});
+                        run->tenants[tenantId];
+                    }
+                    LOG_INFO << "RFM batch: " << tenants.size() << " tenants in " << partitions.size()
+                             << " partitions up to record " << run->mark;
+                    if (partitions.empty())
+                    {
+                        finish(run);
+                        return;
+                    }
+                    run->remaining = partitions.size();
+                    for (const auto &partition : partitions)
+                        batchQueue_->runTaskInQueue([this, run, partition]()
+                                                    { scan(run, partition.tenantId, partition.firstMember, partition.lastMember); });
+                },
+                fail,
+                run->mark);
+        },
+        fail);
+}
+
+void MemberRfm::scan(const std::shared_ptr<Run> &run, uint32_t tenantId, uint32_t firstMember, uint32_t lastMember)
+{
+    std::unordered_map<uint32_t, RfmTable::Metrics> members;
+    // 键集分页的游标，(member_id, record_id) 有索引
+    uint32_t cursorMember = firstMember;
+    uint32_t cursorRecord = 0;
+    try
+    {
+        while (!stopping_ && !run->failed)
+        {
+            auto page = dbClient_->execSqlSync(
+                "select record_id, member_id, to_days(created_at) - ? as day, amount from consumption_record "
+                "where tenant_id = ? and member_id <= ? and record_id <= ? and amount > 0 and created_at is not null "
+                "and (member_id > ? or (member_id = ? and record_id > ?)) "
+                "order by member_id, record_id limit ?",
+                kEpochDays,
+                tenantId,
+                lastMember,
+                run->mark,
+                cursorMember,
+                cursorMember,
+                cursorRecord,
+                static_cast<uint64_t>(pageSize_));
+            for (const auto &row : page)
+            {
+                cursorMember = row["member_id"].as<uint32_t>();
+                cursorRecord = row["record_id"].as<uint32_t>();
+                members[cursorMember].add(row["day"].as<int32_t>(),
+                                          Money::fromString(row["amount"].as<std::string>()).raw());
+            }
+            if (page.size() < pageSize_)
+                break;
+        }
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to scan consumption of tenant " << tenantId << " members " << firstMember << "-"
+                  << lastMember << " for RFM: " << e.base().what();
+        run->failed = true;
+    }
+    {
+        std::lock_guard<std::mutex> lock(run->mutex);
+        run->tenants[tenantId].merge(std::move(members));
+    }
+    if (--run->remaining == 0)
+        finish(run);
+}
+
+void MemberRfm::finish(const std::shared_ptr<Run> &run)
+{
+    if (run->failed || stopping_)
+    {
+        LOG_ERROR << "RFM batch aborted, keeping previous scores";
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        running_ = false;
+        deltas_.clear();
+        return;
+    }
+    auto today = dayOf(trantor::Date::now());
+    for (auto &[tenantId, table] : run->tenants)
+        table.rescore(today);
+
+    std::vector<std::pair<uint32_t, RfmTable::Scores>> scores;
+    size_t members = 0;
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        // 全量期间新增、水位之后的记录补记
+        for (const auto &delta : deltas_)
+        {
+            if (delta.recordId > run->mark)
+                run->tenants[delta.tenantId].add(delta.memberId, delta.day, delta.cents);
+        }
+        deltas_.clear();
+        running_ = false;
+        tenants_.swap(run->tenants);
+        for (const auto &[tenantId, table] : tenants_)
+        {
+            auto tenantScores = table.scores(today);
+            scores.insert(scores.end(), tenantScores.begin(), tenantScores.end());
+            members += table.size();
+        }
+    }
+    app().getPlugin<MemberSegments>()->rfmScored(scores);
+    LOG_INFO << "RFM batch finished, " << members << " members scored";
+}
+
+void MemberRfm::consumptionCreated(const ConsumptionRecord &record)
+{
+    if (!record.getMemberId() || !record.getTenantId() || Money::fromString(record.getValueOfAmount()).raw() <= 0)
+        return;
+    auto day = dayOf(record.getCreatedAt() ? record.getValueOfCreatedAt() : trantor::Date::now());
+    auto memberId = record.getValueOfMemberId();
+    RfmTable::Scores scores;
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto &table = tenants_[record.getValueOfTenantId()];
+        table.add(memberId, day, Money::fromString(record.getValueOfAmount()).raw());
+        if (running_)
+            deltas_.push_back(Delta{record.getValueOfRecordId(),
+                                    record.getValueOfTenantId(),
+                                    memberId,
+                                    day,
+                                    Money::fromString(record.getValueOfAmount()).raw()});
+        scores = table.scoreOf(*table.find(memberId), dayOf(trantor::Date::now()));
+    }
+    app().getPlugin<MemberSegments>()->rfmScored({{memberId, scores}});
+}
+
+Json::Value MemberRfm::metricsOf(uint32_t tenantId, uint32_t memberId) const
+{
+    auto today = dayOf(trantor::Date::now());
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto tenant = tenants_.find(tenantId);
+    if (tenant == tenants_.end())
+        return Json::Value::null;
+    auto metrics = tenant->second.find(memberId);
+    if (!metrics || metrics->orders == 0)
+        return Json::Value::null;
+    auto scores = tenant->second.scoreOf(*metrics, today);
+    auto tenure = std::max(today - metrics->firstDay, 0) + 1;
+
+    Json::Value json;
+    json["r_score"] = scores[0];
+    json["f_score"] = scores[1];
+    json["m_score"] = scores[2];
+    json["recency_days"] = std::max(today - metrics->lastDay, 0);
+    json["frequency"] = metrics->orders;
+    json["lifetime_value"] = Money::fromRaw(metrics->cents).toJson();
+    json["avg_order_value"] = Money::fromRaw(metrics->cents / metrics->orders).toJson();
+    json["tenure_days"] = tenure;
+    // 按在店天数折算的年消费，不足 30 天按 30 天
+    json["annual_value"] = Money::fromRaw(metrics->cents * 365 / std::max(tenure, 30)).toJson();
+    return json;
+}
@@ -0,0 +1,79 @@
+/**
+ *
+ *  MemberRfm.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/orm/DbClient.h>
+#include <trantor/net/EventLoop.h>
+#include <trantor/utils/ConcurrentTaskQueue.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "ConsumptionRecord.h"
+#include "RfmTable.h"
+
+/**
+ * @brief 会员 RFM 评分和生命周期指标，按租户常驻 RfmTable。
+ *
+ * 全量计算在启动时和每天 batch_hour 点进行：先记下当前最大 record_id，按租户和会员ID区间切成分片，
+ * 由线程池并行按 (member_id, record_id) 键集分页逐页读取消费记录累加，不整表载入；
+ * 全部分片完成后替换旧表、重算分位边界，并把评分写入会员分群。
+ * 两次全量之间新增的消费记录按已有边界增量累加、评分；全量期间到达的记录在替换时补记。
+ * 金额为 0 的记录（如会员到期事件）不计入。
+ */
+class MemberRfm : public drogon::Plugin<MemberRfm>
+{
+public:
+  MemberRfm() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  void consumptionCreated(const drogon_model::saas_restaurant::ConsumptionRecord &record);
+
+  /// 会员的 RFM 评分和生命周期指标，没有消费记录时返回 null
+  Json::Value metricsOf(uint32_t tenantId, uint32_t memberId) const;
+
+private:
+  struct Delta
+  {
+    uint32_t recordId;
+    uint32_t tenantId;
+    uint32_t memberId;
+    int32_t day;
+    int64_t cents;
+  };
+  struct Run;
+
+  static int32_t dayOf(const trantor::Date &at);
+  void runBatch();
+  void scheduleBatch();
+  /// 读取一个分片：租户内 [firstMember, lastMember] 的会员，record_id 不超过 run 的水位
+  void scan(const std::shared_ptr<Run> &run, uint32_t tenantId, uint32_t firstMember, uint32_t lastMember);
+  void finish(const std::shared_ptr<Run> &run);
+
+  drogon::orm::DbClientPtr dbClient_;
+  std::unique_ptr<trantor::ConcurrentTaskQueue> batchQueue_;
+  trantor::TimerId timerId_{0};
+  int batchHour_{4};
+  size_t pageSize_{5000};
+  uint64_t partitionRows_{200000};
+  std::atomic<bool> stopping_{false};
+
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<uint32_t, RfmTable> tenants_;
+  bool running_{false};
+  std::vector<Delta> deltas_; // 全量期间到达的记录
+};
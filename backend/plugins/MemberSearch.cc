@@ -0,0 +1,117 @@
+/**
+ *
+ *  MemberSearch.cc
+ *
+ */
+
+#include "MemberSearch.h"
+#include <drogon/drogon.h>
+#include <algorithm>
+#include <mutex>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+namespace
+{
+std::string textOf(const Field &field)
+{
+    return field.isNull() ? std::string() : field.as<std::string>();
+}
+} // namespace
+
+void MemberSearch::initAndStart(const Json::Value &config)
+{
+    dbClient_ = app().getDbClient(config.get("db_client", "default").asString());
+    maxLimit_ = std::max(config.get("max_limit", 50).asUInt(), 1u);
+    load();
+}
+
+void MemberSearch::shutdown()
+{
+}
+
+void MemberSearch::load()
+{
+    try
+    {
+        auto members = dbClient_->execSqlSync(
+            "select member_id, tenant_id, phone, username from member "
+            "where tenant_id is not null and (is_deleted = 0 or is_deleted is null)");
+        std::unordered_map<uint32_t, std::vector<std::pair<uint32_t, std::vector<std::string>>>> rows;
+        for (const auto &row : members)
+        {
+            auto memberId = row["member_id"].as<uint32_t>();
+            auto tenantId = row["tenant_id"].as<uint32_t>();
+            rows[tenantId].emplace_back(memberId,
+                                        std::vector<std::string>{textOf(row["phone"]), textOf(row["username"])});
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        for (auto &[tenantId, list] : rows)
+        {
+            for (const auto &item : list)
+                memberTenant_[item.first] = tenantId;
+            tenants_[tenantId].load(std::move(list));
+        }
+        LOG_INFO << "Member search loaded " << tenants_.size() << " tenants, " << members.size() << " members";
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to load member search index: " << e.base().what();
+    }
+}
+
+void MemberSearch::unlist(uint32_t memberId)
+{
+    auto it = memberTenant_.find(memberId);
+    if (it == memberTenant_.end())
+        return;
+    auto index = tenants_.find(it->second);
+    if (index != tenants_.end())
+        index->second.remove(memberId);
+    memberTenant_.erase(it);
+}
+
+void MemberSearch::memberChanged(uint32_t memberId)
+{
+    dbClient_->execSqlAsync(
+        "select tenant_id, phone, username, is_deleted from member where member_id = ?",
+        [this, memberId](const Result &result)
+        {
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            if (result.empty() || result[0]["tenant_id"].isNull() ||
+                (!result[0]["is_deleted"].isNull() && result[0]["is_deleted"].as<int>() == 1))
+            {
+                unlist(memberId);
+                return;
+            }
+            auto tenantId = result[0]["tenant_id"].as<uint32_t>();
+            auto it = memberTenant_.find(memberId);
+            if (it != memberTenant_.end() && it->second != tenantId)
+                unlist(memberId);
+            tenants_[tenantId].set(memberId, {textOf(result[0]["phone"]), textOf(result[0]["username"])});
+            memberTenant_[memberId] = tenantId;
+        },
+        [memberId](const DrogonDbException &e)
+        { LOG_ERROR << "Failed to reload member " << memberId << " for search: " << e.base().what(); },
+        memberId);
+}
+
+std::vector<MemberSearch::Match> MemberSearch::search(uint32_t tenantId, const std::string &query, size_t limit) const
+{
+    std::vector<Match> matches;
+    std::vector<uint32_t> ids;
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto tenant = tenants_.find(tenantId);
+    if (tenant == tenants_.end())
+        return matches;
+    tenant->second.search(query, std::min(limit, maxLimit_), ids);
+    matches.reserve(ids.size());
+    for (auto id : ids)
+    {
+        const auto &fields = *tenant->second.fieldsOf(id);
+        matches.push_back(Match{id, fields[0], fields[1]});
+    }
+    return matches;
+}
@@ -0,0 +1,60 @@
+/**
+ *
+ *  MemberSearch.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/orm/DbClient.h>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "PrefixIndex.h"
+
+/**
+ * @brief 收银台按手机号片段、用户名查找会员，按租户常驻 PrefixIndex。
+ *
+ * 启动时载入未删除会员的手机号和用户名，之后会员增删改按主键重读该会员。
+ * 查询只读内存，不访问数据库。
+ */
+class MemberSearch : public drogon::Plugin<MemberSearch>
+{
+public:
+  struct Match
+  {
+    uint32_t memberId;
+    std::string phone;
+    std::string username;
+  };
+
+  MemberSearch() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  void memberChanged(uint32_t memberId);
+
+  /// 前缀匹配在前，最多 limit 个
+  std::vector<Match> search(uint32_t tenantId, const std::string &query, size_t limit) const;
+  size_t maxLimit() const { return maxLimit_; }
+
+private:
+  void load();
+  void unlist(uint32_t memberId);
+
+  drogon::orm::DbClientPtr dbClient_;
+  size_t maxLimit_{50};
+
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<uint32_t, PrefixIndex> tenants_;
+  std::unordered_map<uint32_t, uint32_t> memberTenant_; // 会员 -> 租户
+};
@@ -0,0 +1,247 @@
+/**
+ *
+ *  MemberSegments.cc
+ *
+ */
+
+#include "MemberSegments.h"
+#include "Money.h"
+#include <drogon/drogon.h>
+#include <algorithm>
+#include <mutex>
+
+using namespace drogon;
+using namespace drogon::orm;
+using namespace drogon_model::saas_restaurant;
+
+namespace
+{
+// to_days('1970-01-01')，数据库按本地日期算出的天数与 dayOf 一致
+constexpr int32_t kEpochDays = 719528;
+} // namespace
+
+void MemberSegments::initAndStart(const Json::Value &config)
+{
+    dbClient_ = app().getDbClient(config.get("db_client", "default").asString());
+    windowDays_ = std::max(config.get("window_days", 30).asInt(), 1);
+    for (const auto &bound : config.get("spend_buckets", Json::Value(Json::arrayValue)))
+    {
+        if (Money::isValidJson(bound))
+            spendBounds_.push_back(Money::fromJson(bound).raw());
+    }
+    if (spendBounds_.empty())
+        spendBounds_ = {10000, 30000, 100000, 300000};
+    for (const auto &bound : config.get("recency_days", Json::Value(Json::arrayValue)))
+        recencyBounds_.push_back(bound.asInt());
+    if (recencyBounds_.empty())
+        recencyBounds_ = {7, 30, 90};
+    std::sort(spendBounds_.begin(), spendBounds_.end());
+    spendBounds_.erase(std::unique(spendBounds_.begin(), spendBounds_.end()), spendBounds_.end());
+    std::sort(recencyBounds_.begin(), recencyBounds_.end());
+    recencyBounds_.erase(std::unique(recencyBounds_.begin(), recencyBounds_.end()), recencyBounds_.end());
+
+    load();
+
+    timerId_ = app().getLoop()->runEvery(60.0, [this]() { tick(); });
+}
+
+void MemberSegments::shutdown()
+{
+    app().getLoop()->invalidateTimer(timerId_);
+}
+
+int32_t MemberSegments::dayOf(const trantor::Date &at)
+{
+    // 按本地自然日，加半天避免夏令时切换造成的偏差
+    auto midnight = at.roundDay().microSecondsSinceEpoch();
+    return static_cast<int32_t>((midnight + 43200LL * 1000000) / (86400LL * 1000000));
+}
+
+SegmentIndex &MemberSegments::tenant(uint32_t tenantId)
+{
+    auto it = tenants_.find(tenantId);
+    if (it == tenants_.end())
+    {
+        it = tenants_.emplace(tenantId, SegmentIndex(spendBounds_, recencyBounds_, windowDays_)).first;
+        it->second.advance(today_);
+    }
+    return it->second;
+}
+
+void MemberSegments::unlist(uint32_t memberId)
+{
+    auto it = memberTenant_.find(memberId);
+    if (it == memberTenant_.end())
+        return;
+    auto index = tenants_.find(it->second);
+    if (index != tenants_.end())
+        index->second.removeMember(memberId);
+    memberTenant_.erase(it);
+}
+
+void MemberSegments::load()
+{
+    try
+    {
+        auto members = dbClient_->execSqlSync(
+            "select member_id, tenant_id, level_id, status from member "
+            "where tenant_id is not null and (is_deleted = 0 or is_deleted is null)");
+        auto spends = dbClient_->execSqlSync(
+            "select member_id, to_days(created_at) - ? as day, sum(amount) as spent from consumption_record "
+            "where member_id is not null and created_at >= ? group by member_id, day",
+            kEpochDays,
+            trantor::Date::now().roundDay().after(-86400.0 * (windowDays_ - 1)).toDbStringLocal());
+        auto visits = dbClient_->execSqlSync(
+            "select member_id, to_days(max(created_at)) - ? as day from consumption_record "
+            "where member_id is not null and created_at is not null and amount > 0 group by member_id",
+            kEpochDays);
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        today_ = dayOf(trantor::Date::now());
+        for (const auto &row : members)
+        {
+            auto memberId = row["member_id"].as<uint32_t>();
+            auto tenantId = row["tenant_id"].as<uint32_t>();
+            tenant(tenantId).setMember(memberId,
+                                       row["level_id"].isNull() ? 0 : row["level_id"].as<uint32_t>(),
+                                       row["status"].isNull() ? std::string() : row["status"].as<std::string>());
+            memberTenant_[memberId] = tenantId;
+        }
+        for (const auto &row : spends)
+        {
+            auto it = memberTenant_.find(row["member_id"].as<uint32_t>());
+            if (it == memberTenant_.end() || row["spent"].isNull())
+                continue;
+            tenants_.at(it->second).setDailySpend(it->first,
+                                                  row["day"].as<int32_t>(),
+                                                  Money::fromString(row["spent"].as<std::string>()).raw());
+        }
+        for (const auto &row : visits)
+        {
+            auto it = memberTenant_.find(row["member_id"].as<uint32_t>());
+            if (it != memberTenant_.end())
+                tenants_.at(it->second).setLastVisit(it->first, row["day"].as<int32_t>());
+        }
+        LOG_INFO << "Member segments loaded " << tenants_.size() << " tenants, " << members.size() << " members";
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to load member segments: " << e.base().what();
+    }
+}
+
+void MemberSegments::tick()
+{
+    auto today = dayOf(trantor::Date::now());
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if (today <= today_)
+            return;
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    today_ = today;
+    for (auto &[tenantId, index] : tenants_)
+        index.advance(today);
+}
+
+void MemberSegments::memberChanged(uint32_t memberId)
+{
+    dbClient_->execSqlAsync(
+        "select tenant_id, level_id, status, is_deleted from member where member_id = ?",
+        [this, memberId](const Result &result)
+        {
+            if (result.empty() || result[0]["tenant_id"].isNull() ||
+                (!result[0]["is_deleted"].isNull() && result[0]["is_deleted"].as<int>() == 1))
+            {
+                std::unique_lock<std::shared_mutex> lock(mutex_);
+                unlist(memberId);
+                return;
+            }
+            auto tenantId = result[0]["tenant_id"].as<uint32_t>();
+            auto levelId = result[0]["level_id"].isNull() ? 0 : result[0]["level_id"].as<uint32_t>();
+            auto status = result[0]["status"].isNull() ? std::string() : result[0]["status"].as<std::string>();
+            {
+                std::unique_lock<std::shared_mutex> lock(mutex_);
+                auto it = memberTenant_.find(memberId);
+                if (it != memberTenant_.end() && it->second == tenantId)
+                {
+                    tenant(tenantId).setMember(memberId, levelId, status);
+                    return;
+                }
+            }
+
+            // 新会员或更换了租户：连同消费一起重读
+            dbClient_->execSqlAsync(
+                "select to_days(created_at) - ? as day, sum(amount) as spent from consumption_record "
+                "where member_id = ? and created_at is not null and amount > 0 group by day",
+                [this, memberId, tenantId, levelId, status](const Result &days)
+                {
+                    std::unique_lock<std::shared_mutex> lock(mutex_);
+                    unlist(memberId);
+                    auto &index = tenant(tenantId);
+                    index.setMember(memberId, levelId, status);
+                    memberTenant_[memberId] = tenantId;
+                    for (const auto &row : days)
+                    {
+                        auto day = row["day"].as<int32_t>();
+                        if (day > today_ - windowDays_ && !row["spent"].isNull())
+                            index.setDailySpend(memberId, day, Money::fromString(row["spent"].as<std::string>()).raw());
+                        else
+                            index.setLastVisit(memberId, day);
+                    }
+                },
+                [memberId](const DrogonDbException &e)
+                { LOG_ERROR << "Failed to refresh consumption of member " << memberId << ": " << e.base().what(); },
+                kEpochDays,
+                memberId);
+        },
+        [memberId](const DrogonDbException &e)
+        { LOG_ERROR << "Failed to refresh member " << memberId << " for segments: " << e.base().what(); },
+        memberId);
+}
+
+void MemberSegments::memberLevelChanged(uint32_t memberId, uint32_t levelId)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = memberTenant_.find(memberId);
+    if (it != memberTenant_.end())
+        tenant(it->second).setLevel(memberId, levelId);
+}
+
+void MemberSegments::consumptionCreated(const ConsumptionRecord &record)
+{
+    if (!record.getMemberId() || !record.getTenantId())
+        return;
+    auto at = record.getCreatedAt() ? record.getValueOfCreatedAt() : trantor::Date::now();
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    // 会员尚未登记时按记录上的租户累计，会员登记后生效
+    auto it = memberTenant_.find(record.getValueOfMemberId());
+    auto tenantId = it == memberTenant_.end() ? record.getValueOfTenantId() : it->second;
+    tenant(tenantId).addConsumption(record.getValueOfMemberId(), dayOf(at), Money::fromString(record.getValueOfAmount()).raw());
+}
+
+void MemberSegments::rfmScored(const std::vector<std::pair<uint32_t, std::array<uint8_t, 3>>> &scores)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    for (const auto &[memberId, rfm] : scores)
+    {
+        auto it = memberTenant_.find(memberId);
+        if (it != memberTenant_.end())
+            tenant(it->second).setRfm(memberId, rfm);
+    }
+}
+
+uint64_t MemberSegments::select(uint32_t tenantId,
+                                const SegmentIndex::Filter &filter,
+                                uint64_t offset,
+                                uint64_t limit,
+                                std::vector<uint32_t> &ids) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = tenants_.find(tenantId);
+    if (it == tenants_.end())
+        return 0;
+    auto members = it->second.select(filter);
+    ids = members.page(offset, limit);
+    return members.cardinality();
+}
@@ -0,0 +1,78 @@
+/**
+ *
+ *  MemberSegments.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/orm/DbClient.h>
+#include <trantor/net/EventLoop.h>
+#include <array>
+#include <cstdint>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ConsumptionRecord.h"
+#include "SegmentIndex.h"
+
+/**
+ * @brief 按租户常驻会员分群位图，用于营销活动圈选会员。
+ *
+ * 启动时加载未删除会员的等级、状态，以及近 window_days 天按天汇总的消费和最近消费日；
+ * 之后会员增删改按主键重读该会员，新增消费记录直接累加。每分钟检查日期，跨天时整体换档。
+ * 消费记录的修改和删除不回退，重启后按数据库重建。金额为 0 的记录（如会员到期事件）不算到店。
+ */
+class MemberSegments : public drogon::Plugin<MemberSegments>
+{
+public:
+  MemberSegments() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  void memberChanged(uint32_t memberId);
+  /// 等级评估已知新等级时直接更新，不再回读
+  void memberLevelChanged(uint32_t memberId, uint32_t levelId);
+  void consumptionCreated(const drogon_model::saas_restaurant::ConsumptionRecord &record);
+  /// 写入一批会员的 R、F、M 评分，未登记的会员忽略
+  void rfmScored(const std::vector<std::pair<uint32_t, std::array<uint8_t, 3>>> &scores);
+
+  /// 按条件圈选，ids 为升序的第 offset 个起最多 limit 个会员ID
+  uint64_t select(uint32_t tenantId,
+                  const SegmentIndex::Filter &filter,
+                  uint64_t offset,
+                  uint64_t limit,
+                  std::vector<uint32_t> &ids) const;
+
+  /// 消费档边界（分）和到店档边界（天）
+  const std::vector<int64_t> &spendBounds() const { return spendBounds_; }
+  const std::vector<int32_t> &recencyBounds() const { return recencyBounds_; }
+  int32_t windowDays() const { return windowDays_; }
+
+private:
+  static int32_t dayOf(const trantor::Date &at);
+  void load();
+  void tick();
+  SegmentIndex &tenant(uint32_t tenantId);
+  /// 从所有租户中移除会员
+  void unlist(uint32_t memberId);
+
+  drogon::orm::DbClientPtr dbClient_;
+  trantor::TimerId timerId_{0};
+  std::vector<int64_t> spendBounds_;
+  std::vector<int32_t> recencyBounds_;
+  int32_t windowDays_{30};
+
+  mutable std::shared_mutex mutex_;
+  int32_t today_{0};
+  std::unordered_map<uint32_t, SegmentIndex> tenants_;
+  std::unordered_map<uint32_t, uint32_t> memberTenant_; // 会员 -> 租户
+};
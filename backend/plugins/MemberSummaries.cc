@@ -0,0 +1,141 @@
+/**
+ *
+ *  MemberSummaries.cc
+ *
+ */
+
+#include "MemberSummaries.h"
+#include "Money.h"
+#include <drogon/drogon.h>
+#include <charconv>
+
+using namespace drogon;
+using namespace drogon::orm;
+using namespace drogon_model::saas_restaurant;
+
+namespace
+{
+// 消费记录的积分是文本列，不是非负整数时按 0 计
+int64_t pointsOf(const std::string &text)
+{
+    int64_t points = 0;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), points);
+    if (ec != std::errc() || end != text.data() + text.size() || points < 0)
+        return 0;
+    return points;
+}
+} // namespace
+
+void MemberSummaries::initAndStart(const Json::Value &config)
+{
+    dbClient_ = app().getDbClient(config.get("db_client", "default").asString());
+    cache_ = std::make_unique<SummaryCache>(config.get("capacity", 100000).asUInt());
+}
+
+void MemberSummaries::shutdown()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_->clear();
+    pending_.clear();
+}
+
+void MemberSummaries::summaryOf(uint32_t tenantId, uint32_t memberId, Loaded &&loaded, Failed &&failed)
+{
+    uint64_t writes = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        SummaryCache::Summary summary;
+        if (cache_->get(memberId, summary))
+        {
+            loaded(summary);
+            return;
+        }
+        auto &pending = pending_[memberId];
+        ++pending.loads;
+        writes = pending.writes;
+    }
+    // 与 pointsOf 同样只计非负整数的积分
+    dbClient_->execSqlAsync(
+        "select count(*) as orders, coalesce(sum(amount), 0) as amount, "
+        "coalesce(sum(case when points regexp '^[0-9]+$' then cast(points as signed) else 0 end), 0) as points, "
+        "coalesce(unix_timestamp(min(created_at)), 0) as first_at, "
+        "coalesce(unix_timestamp(max(created_at)), 0) as last_at "
+        "from consumption_record where tenant_id = ? and member_id = ? and amount > 0",
+        [this, memberId, writes, loaded = std::move(loaded)](const Result &result)
+        {
+            const auto &row = result[0];
+            SummaryCache::Summary summary;
+            summary.orders = row["orders"].as<uint32_t>();
+            summary.cents = Money::fromString(row["amount"].as<std::string>()).raw();
+            summary.points = row["points"].as<int64_t>();
+            summary.firstAt = static_cast<int64_t>(row["first_at"].as<double>());
+            summary.lastAt = static_cast<int64_t>(row["last_at"].as<double>());
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = pending_.find(memberId);
+                if (it != pending_.end())
+                {
+                    if (it->second.writes == writes)
+                        cache_->put(memberId, summary);
+                    if (--it->second.loads == 0)
+                        pending_.erase(it);
+                }
+            }
+            loaded(summary);
+        },
+        [this, memberId, failed = std::move(failed)](const DrogonDbException &e)
+        {
+            LOG_ERROR << "Failed to summarize consumption of member " << memberId << ": " << e.base().what();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = pending_.find(memberId);
+                if (it != pending_.end() && --it->second.loads == 0)
+                    pending_.erase(it);
+            }
+            failed(e);
+        },
+        tenantId,
+        memberId);
+}
+
+void MemberSummaries::consumptionCreated(const ConsumptionRecord &record)
+{
+    if (!record.getMemberId() || Money::fromString(record.getValueOfAmount()).raw() <= 0)
+        return;
+    auto memberId = record.getValueOfMemberId();
+    auto at = (record.getCreatedAt() ? record.getValueOfCreatedAt() : trantor::Date::now()).secondsSinceEpoch();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (cache_->add(memberId, at, Money::fromString(record.getValueOfAmount()).raw(), pointsOf(record.getValueOfPoints())))
+        return;
+    auto it = pending_.find(memberId);
+    if (it != pending_.end())
+        ++it->second.writes;
+}
+
+void MemberSummaries::consumptionChanged()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_->clear();
+    for (auto &[memberId, pending] : pending_)
+        ++pending.writes;
+}
+
+Json::Value MemberSummaries::toJson(const SummaryCache::Summary &summary)
+{
+    Json::Value json;
+    json["orders"] = summary.orders;
+    json["total_amount"] = Money::fromRaw(summary.cents).toJson();
+    json["avg_amount"] = Money::fromRaw(summary.orders == 0 ? 0 : summary.cents / summary.orders).toJson();
+    json["points_earned"] = static_cast<Json::Int64>(summary.points);
+    if (summary.orders == 0)
+    {
+        json["first_at"] = Json::Value::null;
+        json["last_at"] = Json::Value::null;
+    }
+    else
+    {
+        json["first_at"] = trantor::Date(summary.firstAt * 1000000).toDbStringLocal();
+        json["last_at"] = trantor::Date(summary.lastAt * 1000000).toDbStringLocal();
+    }
+    return json;
+}
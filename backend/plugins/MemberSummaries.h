@@ -0,0 +1,61 @@
+/**
+ *
+ *  MemberSummaries.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/orm/DbClient.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "ConsumptionRecord.h"
+#include "SummaryCache.h"
+
+/**
+ * @brief 会员消费汇总（笔数、金额、获得积分、首末次消费时间），供会员档案接口使用。
+ *
+ * 按需从数据库聚合后放入容量为 capacity 的 LRU 缓存，新增消费记录直接累加到已缓存的汇总；
+ * 聚合期间该会员有新增消费时本次结果只返回不缓存，避免丢掉这笔消费。
+ * 消费记录的修改和删除不知道涉及哪个会员，整体清空缓存。
+ */
+class MemberSummaries : public drogon::Plugin<MemberSummaries>
+{
+public:
+  using Loaded = std::function<void(const SummaryCache::Summary &)>;
+  using Failed = std::function<void(const drogon::orm::DrogonDbException &)>;
+
+  MemberSummaries() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  /// 缓存命中时直接回调，否则按 (tenant_id, member_id) 索引异步聚合
+  void summaryOf(uint32_t tenantId, uint32_t memberId, Loaded &&loaded, Failed &&failed);
+  void consumptionCreated(const drogon_model::saas_restaurant::ConsumptionRecord &record);
+  void consumptionChanged();
+
+  static Json::Value toJson(const SummaryCache::Summary &summary);
+
+private:
+  // 正在聚合的会员：进行中的查询数和期间到达的写入数
+  struct Pending
+  {
+    uint32_t loads{0};
+    uint64_t writes{0};
+  };
+
+  drogon::orm::DbClientPtr dbClient_;
+  std::mutex mutex_;
+  std::unique_ptr<SummaryCache> cache_;
+  std::unordered_map<uint32_t, Pending> pending_;
+};
@@ -0,0 +1,142 @@
+/**
+ *
+ *  MenuSnapshot.cc
+ *
+ */
+
+#include "MenuSnapshot.h"
+#include <algorithm>
+
+namespace
+{
+Json::Value dishJson(const MenuSnapshot::Item &item)
+{
+    const auto &dish = *item.dish;
+    Json::Value json;
+    json["dish_id"] = dish.dishId;
+    json["dish_category_id"] = dish.categoryId;
+    json["dish_name"] = dish.name;
+    json["dish_price"] = dish.price.toJson();
+    json["description"] = dish.description;
+    json["status"] = dish.status;
+    json["cover_img"] = dish.coverImg;
+    json["sort_order"] = dish.sortOrder;
+    json["sales"] = dish.sales;
+    json["campaign_id"] = item.campaignId;
+    json["campaign_price"] = item.campaignId != 0 ? item.campaignPrice.toJson() : Json::Value::null;
+    return json;
+}
+} // namespace
+
+std::shared_ptr<const MenuSnapshot> MenuSnapshot::build(uint32_t tenantId,
+                                                        uint64_t version,
+                                                        const Sources &sources,
+                                                        int64_t at)
+{
+    std::shared_ptr<MenuSnapshot> menu(new MenuSnapshot());
+    menu->tenantId_ = tenantId;
+    menu->version_ = version;
+    menu->builtAt_ = at;
+
+    // 当前有效的活动，下一个启停时刻即快照过期时刻
+    std::vector<const PricingRules::Campaign *> active;
+    for (const auto *entry : sources.schedule.activeAt(at, 0))
+    {
+        auto it = sources.campaigns.find(entry->campaignId);
+        if (it != sources.campaigns.end())
+            active.push_back(&it->second);
+    }
+    auto next = sources.schedule.nextChange(at);
+    if (next != CampaignSchedule::kOpenEnd)
+        menu->expiresAt_ = next;
+
+    menu->dishes_.reserve(sources.dishes.size());
+    for (const auto &[dishId, dish] : sources.dishes)
+        menu->dishes_.push_back(dish);
+    // 分类的先序位置，分类不存在的排在最后
+    auto rank = [&sources](const Dish &dish)
+    {
+        auto node = sources.categories.find(dish.categoryId);
+        return node ? node->enter : std::numeric_limits<uint32_t>::max();
+    };
+    std::sort(menu->dishes_.begin(),
+              menu->dishes_.end(),
+              [&rank](const Dish &a, const Dish &b)
+              {
+                  auto x = rank(a);
+                  auto y = rank(b);
+                  if (x != y)
+                      return x < y;
+                  if (a.sortOrder != b.sortOrder)
+                      return a.sortOrder > b.sortOrder;
+                  return a.dishId < b.dishId;
+              });
+
+    menu->index_.reserve(menu->dishes_.size());
+    for (size_t i = 0; i < menu->dishes_.size(); ++i)
+        menu->index_.emplace(menu->dishes_[i].dishId, i);
+
+    menu->items_.reserve(menu->dishes_.size());
+    for (const auto &dish : menu->dishes_)
+    {
+        if (dish.status == "下架")
+            continue;
+        Item item;
+        item.dish = &dish;
+        const PricingRules::Campaign *best = nullptr;
+        for (auto campaign : active)
+        {
+            if (!campaign->dishIds.empty() &&
+                !std::binary_search(campaign->dishIds.begin(), campaign->dishIds.end(), dish.dishId))
+                continue;
+            if (!best || campaign->rate < best->rate ||
+                (campaign->rate == best->rate && campaign->campaignId < best->campaignId))
+                best = campaign;
+        }
+        if (best)
+        {
+            item.campaignId = best->campaignId;
+            item.campaignPrice = dish.price * best->rate;
+        }
+        menu->items_.push_back(item);
+    }
+
+    // 序列化：分类按先序平铺，带 depth 和 parent_id，各自挂上本分类的菜品
+    Json::Value categories(Json::arrayValue);
+    Json::Value others(Json::arrayValue);
+    auto item = menu->items_.begin();
+    for (auto categoryId : sources.categories.order())
+    {
+        const auto &node = *sources.categories.find(categoryId);
+        Json::Value category;
+        category["category_id"] = categoryId;
+        category["parent_id"] = node.parent;
+        category["category_name"] = node.category.name;
+        category["sort_order"] = node.category.sortOrder;
+        category["depth"] = node.depth;
+        Json::Value dishes(Json::arrayValue);
+        for (; item != menu->items_.end() && item->dish->categoryId == categoryId; ++item)
+            dishes.append(dishJson(*item));
+        category["dishes"] = std::move(dishes);
+        categories.append(std::move(category));
+    }
+    for (; item != menu->items_.end(); ++item)
+        others.append(dishJson(*item));
+
+    Json::Value data;
+    data["tenant_id"] = tenantId;
+    data["version"] = static_cast<Json::UInt64>(version);
+    data["built_at"] = static_cast<Json::Int64>(at);
+    data["expires_at"] = menu->expiresAt_ == kNever ? Json::Value::null : Json::Value(static_cast<Json::Int64>(menu->expiresAt_));
+    data["categories"] = std::move(categories);
+    data["others"] = std::move(others);
+    Json::Value response;
+    response["code"] = 200;
+    response["message"] = "ok";
+    response["data"] = std::move(data);
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    builder["emitUTF8"] = true;
+    menu->body_ = Json::writeString(builder, response);
+    return menu;
+}
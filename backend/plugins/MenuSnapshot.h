@@ -0,0 +1,95 @@
+/**
+ *
+ *  MenuSnapshot.h
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "CampaignSchedule.h"
+#include "CategoryTree.h"
+#include "Money.h"
+#include "PricingRules.h"
+
+/**
+ * @brief 单个租户某一版本的菜单：分类、菜品、价格和活动价，构造后只读。
+ *
+ * 分类按分类树先序排列，分类内的菜品按 sort_order 从大到小、再按ID排，分类不存在的菜品归入 others。
+ * 活动价取构造时刻有效、面向所有顾客的单品折扣中折扣率最低的一个；下一个活动开始或结束的时刻记为
+ * expiresAt，过期后须重新构造。响应 JSON 在构造时序列化好，读取时与快照共享。
+ */
+class MenuSnapshot
+{
+public:
+  struct Dish
+  {
+    uint32_t dishId{0};
+    uint32_t categoryId{0};
+    std::string name;
+    std::string description;
+    std::string status;
+    std::string coverImg;
+    Money price;
+    int32_t sortOrder{0};
+    uint32_t sales{0};
+    uint32_t stock{0};
+  };
+  /// 写者维护的租户菜单原始数据
+  struct Sources
+  {
+    std::unordered_map<uint32_t, Dish> dishes;
+    CategoryTree categories;
+    std::unordered_map<uint32_t, PricingRules::Campaign> campaigns; // 只放面向所有顾客的单品折扣活动
+    CampaignSchedule schedule;                                      // 与 campaigns 同步的起止时间
+  };
+  struct Item
+  {
+    const Dish *dish{nullptr};
+    Money campaignPrice;
+    uint32_t campaignId{0}; // 0 表示没有活动价
+  };
+
+  static constexpr int64_t kNever = std::numeric_limits<int64_t>::max();
+
+  /// 按 at（秒）时刻的活动构造，下架的菜品不上菜单，但仍在 dishes() 中供分店覆盖
+  static std::shared_ptr<const MenuSnapshot> build(uint32_t tenantId,
+                                                   uint64_t version,
+                                                   const Sources &sources,
+                                                   int64_t at);
+
+  uint32_t tenantId() const { return tenantId_; }
+  uint64_t version() const { return version_; }
+  int64_t builtAt() const { return builtAt_; }
+  int64_t expiresAt() const { return expiresAt_; }
+  /// 按菜单顺序排列的全部未删除菜品，含下架的
+  const std::vector<Dish> &dishes() const { return dishes_; }
+  /// 按ID查找未删除的菜品（含下架的），不存在时返回空指针
+  const Dish *findDish(uint32_t dishId) const
+  {
+    auto it = index_.find(dishId);
+    return it == index_.end() ? nullptr : &dishes_[it->second];
+  }
+  /// 按菜单顺序排列的上架菜品
+  const std::vector<Item> &items() const { return items_; }
+  /// 序列化好的响应：{"code": 200, "message": "ok", "data": {...}}
+  const std::string &body() const { return body_; }
+
+private:
+  MenuSnapshot() = default;
+
+  uint32_t tenantId_{0};
+  uint64_t version_{0};
+  int64_t builtAt_{0};
+  int64_t expiresAt_{kNever};
+  std::vector<Dish> dishes_;
+  std::unordered_map<uint32_t, size_t> index_; // 菜品ID -> dishes_ 下标
+  std::vector<Item> items_;
+  std::string body_;
+};
@@ -0,0 +1,293 @@
+/**
+ *
+ *  MenuSnapshots.cc
+ *
+ */
+
+#include "MenuSnapshots.h"
+#include <drogon/drogon.h>
+#include <algorithm>
+
+using namespace drogon;
+using namespace drogon::orm;
+using namespace drogon_model::saas_restaurant;
+
+void MenuSnapshots::initAndStart(const Json::Value &config)
+{
+    dbClient_ = app().getDbClient(config.get("db_client", "default").asString());
+    load();
+    // 到期的快照在主循环上重建，不占用处理请求的 IO 线程
+    timerId_ = app().getLoop()->runEvery(config.get("refresh_interval", 1.0).asDouble(), [this]() { refresh(); });
+}
+
+void MenuSnapshots::shutdown()
+{
+    app().getLoop()->invalidateTimer(timerId_);
+}
+
+void MenuSnapshots::load()
+{
+    try
+    {
+        std::vector<uint32_t> touched;
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        for (const auto &category : Mapper<DishCategory>(dbClient_).findAll())
+            applyCategory(category, touched);
+        for (const auto &dish : Mapper<Dish>(dbClient_).findAll())
+            applyDish(dish, touched);
+        for (const auto &campaign : Mapper<MarketingCampaign>(dbClient_).findAll())
+            applyCampaign(campaign, touched);
+        publish(touched);
+        LOG_INFO << "Menu snapshots loaded " << sources_.size() << " tenants, " << dishTenant_.size() << " dishes";
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to load menu snapshots: " << e.base().what();
+    }
+}
+
+void MenuSnapshots::unlistDish(uint32_t dishId, std::vector<uint32_t> &touched)
+{
+    auto it = dishTenant_.find(dishId);
+    if (it == dishTenant_.end())
+        return;
+    sources_[it->second].dishes.erase(dishId);
+    touched.push_back(it->second);
+    dishTenant_.erase(it);
+}
+
+void MenuSnapshots::unlistCategory(uint32_t categoryId, std::vector<uint32_t> &touched)
+{
+    auto it = categoryTenant_.find(categoryId);
+    if (it == categoryTenant_.end())
+        return;
+    sources_[it->second].categories.remove(categoryId);
+    touched.push_back(it->second);
+    categoryTenant_.erase(it);
+}
+
+void MenuSnapshots::unlistCampaign(uint32_t campaignId, std::vector<uint32_t> &touched)
+{
+    auto it = campaignTenant_.find(campaignId);
+    if (it == campaignTenant_.end())
+        return;
+    sources_[it->second].campaigns.erase(campaignId);
+    sources_[it->second].schedule.remove(campaignId);
+    touched.push_back(it->second);
+    campaignTenant_.erase(it);
+}
+
+void MenuSnapshots::applyDish(const Dish &dish, std::vector<uint32_t> &touched)
+{
+    auto dishId = dish.getValueOfDishId();
+    unlistDish(dishId, touched);
+    if (dish.getValueOfIsDeleted() == 1 || !dish.getTenantId())
+        return;
+    MenuSnapshot::Dish entry;
+    entry.dishId = dishId;
+    entry.categoryId = dish.getValueOfDishCategoryId();
+    entry.name = dish.getValueOfDishName();
+    entry.description = dish.getValueOfDescription();
+    entry.status = dish.getValueOfStatus();
+    entry.coverImg = dish.getValueOfCoverImg();
+    entry.price = Money::fromString(dish.getValueOfDishPrice());
+    entry.sortOrder = dish.getValueOfSortOrder();
+    entry.sales = dish.getValueOfSales();
+    entry.stock = dish.getValueOfStock();
+    sources_[dish.getValueOfTenantId()].dishes[dishId] = std::move(entry);
+    dishTenant_[dishId] = dish.getValueOfTenantId();
+    touched.push_back(dish.getValueOfTenantId());
+}
+
+void MenuSnapshots::applyCategory(const DishCategory &category, std::vector<uint32_t> &touched)
+{
+    auto categoryId = category.getValueOfCategoryId();
+    unlistCategory(categoryId, touched);
+    if (category.getValueOfIsDeleted() == 1 || !category.getTenantId())
+        return;
+    CategoryTree::Category entry;
+    entry.categoryId = categoryId;
+    entry.parentId = category.getValueOfParentId();
+    entry.name = category.getValueOfCategoryName();
+    entry.sortOrder = category.getValueOfSortOrder();
+    sources_[category.getValueOfTenantId()].categories.set(std::move(entry));
+    categoryTenant_[categoryId] = category.getValueOfTenantId();
+    touched.push_back(category.getValueOfTenantId());
+}
+
+void MenuSnapshots::applyCampaign(const MarketingCampaign &campaign, std::vector<uint32_t> &touched)
+{
+    auto campaignId = campaign.getValueOfCampaignId();
+    unlistCampaign(campaignId, touched);
+    // 与计价一致：进行中且能解析的单品折扣才有活动价，菜单只展示面向所有顾客、不需凭券的活动价
+    PricingRules::Campaign rule;
+    if (campaign.getValueOfIsDeleted() == 1 || !campaign.getTenantId() || campaign.getValueOfStatus() != "进行中" ||
+        campaign.getValueOfLevelId() != 0 ||
+        !PricingRules::compileCampaign(campaign.getValueOfCampaignContent(), rule) ||
+        rule.kind != PricingRules::Campaign::Discount || rule.voucher)
+        return;
+    rule.campaignId = campaignId;
+    rule.name = campaign.getValueOfCampaignName();
+    rule.levelId = campaign.getValueOfLevelId();
+    rule.start = campaign.getCampaignStart() ? campaign.getValueOfCampaignStart().secondsSinceEpoch() : 0;
+    rule.end = campaign.getCampaignEnd() ? campaign.getValueOfCampaignEnd().secondsSinceEpoch() : 0;
+    auto &sources = sources_[campaign.getValueOfTenantId()];
+    sources.schedule.set(rule.window());
+    sources.campaigns[campaignId] = std::move(rule);
+    campaignTenant_[campaignId] = campaign.getValueOfTenantId();
+    touched.push_back(campaign.getValueOfTenantId());
+}
+
+void MenuSnapshots::publish(const std::vector<uint32_t> &touched)
+{
+    if (touched.empty())
+        return;
+    auto now = trantor::Date::now().secondsSinceEpoch();
+    // 复制目录后只替换受影响的租户，其余租户沿用原快照
+    auto current = catalog_.load();
+    auto next = current ? std::make_shared<Catalog>(*current) : std::make_shared<Catalog>();
+    ++version_;
+    for (auto tenantId : touched)
+    {
+        auto it = sources_.find(tenantId);
+        if (it == sources_.end() || (it->second.dishes.empty() && it->second.categories.size() == 0))
+        {
+            next->erase(tenantId);
+            continue;
+        }
+        auto &menu = (*next)[tenantId];
+        if (!menu || menu->version() != version_)
+        {
+            menu = MenuSnapshot::build(tenantId, version_, it->second, now);
+            if (menu->expiresAt() != MenuSnapshot::kNever)
+                expiries_.emplace(menu->expiresAt(), tenantId);
+        }
+    }
+    catalog_.publish(std::move(next));
+}
+
+void MenuSnapshots::refresh()
+{
+    auto now = trantor::Date::now().secondsSinceEpoch();
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    auto current = catalog_.load();
+    std::vector<uint32_t> touched;
+    while (!expiries_.empty() && expiries_.begin()->first <= now)
+    {
+        auto tenantId = expiries_.begin()->second;
+        expiries_.erase(expiries_.begin());
+        // 期间已经重建过或已下线的租户不再重建
+        if (!current)
+            continue;
+        auto it = current->find(tenantId);
+        if (it == current->end() || it->second->expiresAt() > now)
+            continue;
+        if (std::find(touched.begin(), touched.end(), tenantId) == touched.end())
+            touched.push_back(tenantId);
+    }
+    publish(touched);
+}
+
+void MenuSnapshots::dishChanged(uint32_t dishId)
+{
+    Mapper<Dish>(dbClient_).findByPrimaryKey(
+        dishId,
+        [this](const Dish &dish)
+        {
+            std::vector<uint32_t> touched;
+            std::lock_guard<std::mutex> lock(writeMutex_);
+            applyDish(dish, touched);
+            publish(touched);
+        },
+        [this, dishId](const DrogonDbException &e)
+        {
+            if (!dynamic_cast<const UnexpectedRows *>(&e.base()))
+            {
+                LOG_ERROR << "Failed to refresh dish " << dishId << " for menu: " << e.base().what();
+                return;
+            }
+            std::vector<uint32_t> touched;
+            std::lock_guard<std::mutex> lock(writeMutex_);
+            unlistDish(dishId, touched);
+            publish(touched);
+        });
+}
+
+void MenuSnapshots::categoryChanged(uint32_t categoryId)
+{
+    Mapper<DishCategory>(dbClient_).findByPrimaryKey(
+        categoryId,
+        [this](const DishCategory &category)
+        {
+            std::vector<uint32_t> touched;
+            std::lock_guard<std::mutex> lock(writeMutex_);
+            applyCategory(category, touched);
+            publish(touched);
+        },
+        [this, categoryId](const DrogonDbException &e)
+        {
+            if (!dynamic_cast<const UnexpectedRows *>(&e.base()))
+            {
+                LOG_ERROR << "Failed to refresh dish category " << categoryId << " for menu: " << e.base().what();
+                return;
+            }
+            std::vector<uint32_t> touched;
+            std::lock_guard<std::mutex> lock(writeMutex_);
+            unlistCategory(categoryId, touched);
+            publish(touched);
+        });
+}
+
+void MenuSnapshots::campaignChanged(uint32_t campaignId)
+{
+    Mapper<MarketingCampaign>(dbClient_).findByPrimaryKey(
+        campaignId,
+        [this](const MarketingCampaign &campaign)
+        {
+            std::vector<uint32_t> touched;
+            std::lock_guard<std::mutex> lock(writeMutex_);
+            applyCampaign(campaign, touched);
+            publish(touched);
+        },
+        [this, campaignId](const DrogonDbException &e)
+        {
+            if (!dynamic_cast<const UnexpectedRows *>(&e.base()))
+            {
+                LOG_ERROR << "Failed to refresh campaign " << campaignId << " for menu: " << e.base().what();
+                return;
+            }
+            std::vector<uint32_t> touched;
+            std::lock_guard<std::mutex> lock(writeMutex_);
+            unlistCampaign(campaignId, touched);
+            publish(touched);
+        });
+}
+
+std::shared_ptr<const std::string> MenuSnapshots::menuOf(uint32_t tenantId)
+{
+    thread_local SnapshotCell<Catalog>::Reader reader;
+    std::shared_ptr<const MenuSnapshot> menu;
+    if (auto catalog = reader.get(catalog_))
+    {
+        auto it = catalog->find(tenantId);
+        if (it != catalog->end())
+            menu = it->second;
+    }
+    if (!menu)
+        menu = MenuSnapshot::build(tenantId, 0, MenuSnapshot::Sources(), trantor::Date::now().secondsSinceEpoch());
+    // 别名构造：响应体与快照共用引用计数，持有期间快照不会释放
+    return std::shared_ptr<const std::string>(menu, &menu->body());
+}
+
+bool MenuSnapshots::readMenu(uint32_t tenantId, const std::function<void(const MenuSnapshot &)> &read)
+{
+    thread_local SnapshotCell<Catalog>::Reader reader;
+    auto catalog = reader.get(catalog_);
+    if (!catalog)
+        return false;
+    auto it = catalog->find(tenantId);
+    if (it == catalog->end())
+        return false;
+    read(*it->second);
+    return true;
+}
@@ -0,0 +1,84 @@
+/**
+ *
+ *  MenuSnapshots.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/orm/DbClient.h>
+#include <trantor/net/EventLoop.h>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Dish.h"
+#include "DishCategory.h"
+#include "MarketingCampaign.h"
+#include "MenuSnapshot.h"
+#include "SnapshotCell.h"
+
+/**
+ * @brief 按租户发布不可变的菜单快照，IO 线程读取时不加锁。
+ *
+ * 菜品、分类、活动的增删改按主键重读单行，更新写者侧的原始数据后重建该租户的 MenuSnapshot，
+ * 再复制一份租户到快照的目录整体原子替换。读者用线程本地的 SnapshotCell::Reader 取当前目录，
+ * 版本没变时不碰任何共享的写入位置。活动到了启停时刻的快照由主循环上的定时器重建，
+ * 过期到重建之间读者仍拿到旧快照，最多晚一个 refresh_interval。
+ */
+class MenuSnapshots : public drogon::Plugin<MenuSnapshots>
+{
+public:
+  MenuSnapshots() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  void dishChanged(uint32_t dishId);
+  void categoryChanged(uint32_t categoryId);
+  void campaignChanged(uint32_t campaignId);
+
+  /// 租户当前菜单的响应体 {"code", "message", "data"}，与快照共享不复制；租户没有菜品和分类时为空菜单
+  std::shared_ptr<const std::string> menuOf(uint32_t tenantId);
+  /// 在当前线程上读取租户的菜单快照，租户没有菜单时不调用 read 并返回 false；read 内不能再调用 readMenu
+  bool readMenu(uint32_t tenantId, const std::function<void(const MenuSnapshot &)> &read);
+
+private:
+  using Catalog = std::unordered_map<uint32_t, std::shared_ptr<const MenuSnapshot>>;
+
+  void load();
+  // 以下 apply/unlist 须持有 writeMutex_，把受影响的租户记入 touched
+  void applyDish(const drogon_model::saas_restaurant::Dish &dish, std::vector<uint32_t> &touched);
+  void applyCategory(const drogon_model::saas_restaurant::DishCategory &category, std::vector<uint32_t> &touched);
+  void applyCampaign(const drogon_model::saas_restaurant::MarketingCampaign &campaign,
+                     std::vector<uint32_t> &touched);
+  void unlistDish(uint32_t dishId, std::vector<uint32_t> &touched);
+  void unlistCategory(uint32_t categoryId, std::vector<uint32_t> &touched);
+  void unlistCampaign(uint32_t campaignId, std::vector<uint32_t> &touched);
+  /// 重建 touched 中的租户并发布新目录，须持有 writeMutex_
+  void publish(const std::vector<uint32_t> &touched);
+  /// 重建已到期的快照，由定时器调用
+  void refresh();
+
+  drogon::orm::DbClientPtr dbClient_;
+
+  std::mutex writeMutex_; // 只在写者之间互斥
+  std::unordered_map<uint32_t, MenuSnapshot::Sources> sources_;
+  std::unordered_map<uint32_t, uint32_t> dishTenant_;
+  std::unordered_map<uint32_t, uint32_t> categoryTenant_;
+  std::unordered_map<uint32_t, uint32_t> campaignTenant_;
+  std::multimap<int64_t, uint32_t> expiries_; // 快照到期时刻 -> 租户，重建过的租户留下的旧条目到期时跳过
+  uint64_t version_{0};
+  SnapshotCell<Catalog> catalog_;
+  trantor::TimerId timerId_{0};
+};
@@ -0,0 +1,221 @@
+/**
+ *
+ *  Money.h
+ *
+ */
+
+#pragma once
+
+#include <json/json.h>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <type_traits>
+
+/**
+ * @brief 定点小数，内部为 int64 的 10^Scale 倍整数。
+ *
+ * 数据库列为 DECIMAL，生成的模型中仍是字符串，读取时用 fromString 换算；
+ * JSON 输出固定位数的字符串（如 "12.50"），输入接受数字或字符串。超出 Scale 位的小数四舍五入（远离 0）。
+ * 对象只有一个 int64 成员，连续存放的数组可直接按整数累加，编译器能自动向量化。
+ */
+template <int Scale>
+class Decimal
+{
+public:
+  static_assert(Scale >= 0 && Scale <= 9, "unsupported scale");
+  static constexpr int64_t kFactor = [] {
+    int64_t factor = 1;
+    for (int i = 0; i < Scale; ++i)
+      factor *= 10;
+    return factor;
+  }();
+
+  constexpr Decimal() = default;
+  static constexpr Decimal fromRaw(int64_t raw)
+  {
+    Decimal value;
+    value.raw_ = raw;
+    return value;
+  }
+  static constexpr Decimal fromInteger(int64_t units) { return fromRaw(units * kFactor); }
+
+  /// 解析 "-12.345"、"+3"、".5"，允许首尾空格；格式错误时返回 false
+  static bool parse(const std::string &text, Decimal &value)
+  {
+    size_t i = 0;
+    size_t n = text.size();
+    while (i < n && text[i] == ' ')
+      ++i;
+    while (n > i && text[n - 1] == ' ')
+      --n;
+    bool negative = false;
+    if (i < n && (text[i] == '+' || text[i] == '-'))
+      negative = text[i++] == '-';
+    int64_t units = 0;
+    size_t digits = 0;
+    for (; i < n && text[i] >= '0' && text[i] <= '9'; ++i, ++digits)
+    {
+      if (units > (INT64_MAX / kFactor - 9) / 10)
+        return false;
+      units = units * 10 + (text[i] - '0');
+    }
+    int64_t fraction = 0;
+    int64_t scale = kFactor;
+    bool roundUp = false;
+    if (i < n && text[i] == '.')
+    {
+      for (++i; i < n && text[i] >= '0' && text[i] <= '9'; ++i, ++digits)
+      {
+        if (scale > 1)
+        {
+          scale /= 10;
+          fraction += (text[i] - '0') * scale;
+        }
+        else if (scale == 1)
+        {
+          // 只看多出的第一位
+          roundUp = text[i] >= '5';
+          scale = 0;
+        }
+      }
+    }
+    if (i != n || digits == 0)
+      return false;
+    int64_t raw = units * kFactor + fraction + (roundUp ? 1 : 0);
+    value.raw_ = negative ? -raw : raw;
+    return true;
+  }
+
+  /// 宽松解析，格式错误时为 0，用于读取数据库中的值
+  static Decimal fromString(const std::string &text)
+  {
+    Decimal value;
+    return parse(text, value) ? value : Decimal();
+  }
+
+  /// 数字按 jsoncpp 输出的十进制文本解析，指数形式（如 1e+20）视为格式错误
+  static bool isValidJson(const Json::Value &json)
+  {
+    Decimal value;
+    if (json.isString() || json.isNumeric())
+      return parse(json.asString(), value);
+    return false;
+  }
+
+  /// 校验 JSON 中的这些字段，缺省或 null 表示不修改；格式错误时 err 为给用户看的说明
+  static bool checkFields(const Json::Value &json, std::initializer_list<const char *> names, std::string &err)
+  {
+    for (auto name : names)
+    {
+      const auto &value = json[name];
+      if (value.isNull() || isValidJson(value))
+        continue;
+      err = std::string(name) + " 须为十进制数";
+      return false;
+    }
+    return true;
+  }
+
+  static Decimal fromJson(const Json::Value &json)
+  {
+    // 数字也走文本解析，不经 double 乘法取整
+    if (json.isString() || json.isNumeric())
+      return fromString(json.asString());
+    return Decimal();
+  }
+
+  static Decimal fromDouble(double value)
+  {
+    double scaled = value * static_cast<double>(kFactor);
+    return fromRaw(static_cast<int64_t>(scaled < 0 ? scaled - 0.5 : scaled + 0.5));
+  }
+
+  constexpr int64_t raw() const { return raw_; }
+  double toDouble() const { return static_cast<double>(raw_) / static_cast<double>(kFactor); }
+
+  std::string toString() const
+  {
+    uint64_t magnitude = raw_ < 0 ? uint64_t(0) - static_cast<uint64_t>(raw_) : static_cast<uint64_t>(raw_);
+    std::string text = std::to_string(magnitude / static_cast<uint64_t>(kFactor));
+    if (Scale > 0)
+    {
+      std::string fraction = std::to_string(magnitude % static_cast<uint64_t>(kFactor));
+      text += '.';
+      text.append(Scale - fraction.size(), '0');
+      text += fraction;
+    }
+    return raw_ < 0 ? "-" + text : text;
+  }
+
+  Json::Value toJson() const { return Json::Value(toString()); }
+
+  /// 乘以另一精度的小数（如折扣率），结果保持本精度，四舍五入
+  template <int OtherScale>
+  Decimal operator*(const Decimal<OtherScale> &other) const
+  {
+    return fromRaw(roundDiv(raw_ * other.raw(), Decimal<OtherScale>::kFactor));
+  }
+  constexpr Decimal operator*(int64_t times) const { return fromRaw(raw_ * times); }
+  /// 平均分摊，四舍五入
+  Decimal operator/(int64_t parts) const { return fromRaw(roundDiv(raw_, parts)); }
+
+  constexpr Decimal operator+(const Decimal &other) const { return fromRaw(raw_ + other.raw_); }
+  constexpr Decimal operator-(const Decimal &other) const { return fromRaw(raw_ - other.raw_); }
+  constexpr Decimal operator-() const { return fromRaw(-raw_); }
+  Decimal &operator+=(const Decimal &other)
+  {
+    raw_ += other.raw_;
+    return *this;
+  }
+  Decimal &operator-=(const Decimal &other)
+  {
+    raw_ -= other.raw_;
+    return *this;
+  }
+
+  constexpr bool operator==(const Decimal &other) const { return raw_ == other.raw_; }
+  constexpr bool operator!=(const Decimal &other) const { return raw_ != other.raw_; }
+  constexpr bool operator<(const Decimal &other) const { return raw_ < other.raw_; }
+  constexpr bool operator<=(const Decimal &other) const { return raw_ <= other.raw_; }
+  constexpr bool operator>(const Decimal &other) const { return raw_ > other.raw_; }
+  constexpr bool operator>=(const Decimal &other) const { return raw_ >= other.raw_; }
+
+private:
+  static int64_t roundDiv(int64_t value, int64_t divisor)
+  {
+    if (divisor < 0)
+    {
+      value = -value;
+      divisor = -divisor;
+    }
+    return value >= 0 ? (value + divisor / 2) / divisor : -((-value + divisor / 2) / divisor);
+  }
+
+  int64_t raw_{0};
+};
+
+using Money = Decimal<2>; // 金额，精确到分
+using Rate = Decimal<4>;  // 折扣率等比例
+
+static_assert(sizeof(Money) == sizeof(int64_t) && std::is_trivially_copyable<Money>::value,
+              "Money arrays are summed as int64 arrays");
+
+/// 批量求和，循环只有整数加法，可被自动向量化
+template <int Scale>
+Decimal<Scale> sumOf(const Decimal<Scale> *values, size_t count)
+{
+  int64_t total = 0;
+  for (size_t i = 0; i < count; ++i)
+    total += values[i].raw();
+  return Decimal<Scale>::fromRaw(total);
+}
+
+/// 批量乘以同一比例，如整单折扣逐行分摊
+template <int Scale, int RateScale>
+void scaleAll(const Decimal<Scale> *values, const Decimal<RateScale> &rate, Decimal<Scale> *out, size_t count)
+{
+  for (size_t i = 0; i < count; ++i)
+    out[i] = values[i] * rate;
+}
@@ -0,0 +1,186 @@
+/**
+ *
+ *  OccupancyBoard.cc
+ *
+ */
+
+#include "OccupancyBoard.h"
+#include <algorithm>
+
+void OccupancyBoard::setCapacity(uint32_t branchId, uint32_t capacity)
+{
+    auto &branch = branches_[branchId];
+    branch.registered = true;
+    branch.summary.capacity = capacity;
+}
+
+void OccupancyBoard::removeBranch(uint32_t branchId)
+{
+    auto it = branches_.find(branchId);
+    if (it == branches_.end())
+        return;
+    for (const auto &[name, table] : it->second.tables)
+        for (auto orderId : table.orders)
+            orders_.erase(orderId);
+    branches_.erase(it);
+}
+
+bool OccupancyBoard::hasBranch(uint32_t branchId) const
+{
+    auto it = branches_.find(branchId);
+    return it != branches_.end() && it->second.registered;
+}
+
+bool OccupancyBoard::apply(const Event &event)
+{
+    switch (event.type)
+    {
+        case Event::Seat:
+            if (event.table.empty())
+                return false;
+            seat(event);
+            return true;
+        case Event::Release:
+            return release(event.orderId);
+        case Event::Clear:
+            return clear(event.branchId, event.table);
+    }
+    return false;
+}
+
+void OccupancyBoard::seat(const Event &event)
+{
+    if (event.orderId != 0)
+    {
+        auto seated = orders_.find(event.orderId);
+        if (seated != orders_.end())
+        {
+            // 已在这张桌上的订单只更新人数；换了桌的先从原桌离开
+            if (seated->second.branchId != event.branchId || seated->second.table != event.table)
+                release(event.orderId);
+        }
+    }
+    auto &branch = branches_[event.branchId];
+    auto [it, inserted] = branch.tables.try_emplace(event.table);
+    auto &table = it->second;
+    if (inserted)
+    {
+        table.name = event.table;
+        table.since = event.at;
+        table.covers = event.covers;
+        branch.summary.covers += event.covers;
+        ++branch.summary.tables;
+    }
+    else
+    {
+        auto covers = event.orderId != 0 ? std::max(table.covers, event.covers) : event.covers;
+        branch.summary.covers = branch.summary.covers - table.covers + covers;
+        table.covers = covers;
+    }
+    if (event.orderId == 0)
+    {
+        table.manual = true;
+        return;
+    }
+    if (std::find(table.orders.begin(), table.orders.end(), event.orderId) == table.orders.end())
+        table.orders.push_back(event.orderId);
+    orders_[event.orderId] = Seat{event.branchId, event.table};
+}
+
+bool OccupancyBoard::release(uint32_t orderId)
+{
+    auto seated = orders_.find(orderId);
+    if (seated == orders_.end())
+        return false;
+    auto branch = branches_.find(seated->second.branchId);
+    auto table = branch->second.tables.find(seated->second.table);
+    orders_.erase(seated);
+    auto &orders = table->second.orders;
+    orders.erase(std::find(orders.begin(), orders.end(), orderId));
+    if (orders.empty() && !table->second.manual)
+        leave(branch->second, table);
+    return true;
+}
+
+bool OccupancyBoard::clear(uint32_t branchId, const std::string &name)
+{
+    auto branch = branches_.find(branchId);
+    if (branch == branches_.end())
+        return false;
+    auto table = branch->second.tables.find(name);
+    if (table == branch->second.tables.end())
+        return false;
+    for (auto orderId : table->second.orders)
+        orders_.erase(orderId);
+    leave(branch->second, table);
+    return true;
+}
+
+void OccupancyBoard::leave(Branch &branch, std::unordered_map<std::string, Table>::iterator table)
+{
+    branch.summary.covers -= table->second.covers;
+    --branch.summary.tables;
+    branch.tables.erase(table);
+}
+
+bool OccupancyBoard::summary(uint32_t branchId, Summary &summary) const
+{
+    auto it = branches_.find(branchId);
+    if (it == branches_.end() || !it->second.registered)
+        return false;
+    summary = it->second.summary;
+    return true;
+}
+
+std::vector<OccupancyBoard::Table> OccupancyBoard::tables(uint32_t branchId) const
+{
+    std::vector<Table> result;
+    auto it = branches_.find(branchId);
+    if (it == branches_.end())
+        return result;
+    result.reserve(it->second.tables.size());
+    for (const auto &[name, table] : it->second.tables)
+        result.push_back(table);
+    std::sort(result.begin(),
+              result.end(),
+              [](const Table &a, const Table &b) { return a.since != b.since ? a.since < b.since : a.name < b.name; });
+    return result;
+}
+
+bool OccupancyBoard::locate(uint32_t orderId, uint32_t &branchId, std::string &table) const
+{
+    auto it = orders_.find(orderId);
+    if (it == orders_.end())
+        return false;
+    branchId = it->second.branchId;
+    table = it->second.table;
+    return true;
+}
+
+std::vector<OccupancyBoard::Event> OccupancyBoard::checkpoint() const
+{
+    std::vector<Event> events;
+    for (const auto &[branchId, branch] : branches_)
+    {
+        if (!branch.registered)
+            continue;
+        for (const auto &[name, table] : branch.tables)
+        {
+            // 手工入座在前，设定人数；订单入座取较大值，人数不变
+            Event event;
+            event.type = Event::Seat;
+            event.branchId = branchId;
+            event.covers = table.covers;
+            event.table = name;
+            event.at = table.since;
+            if (table.manual)
+                events.push_back(event);
+            for (auto orderId : table.orders)
+            {
+                event.orderId = orderId;
+                events.push_back(event);
+            }
+        }
+    }
+    return events;
+}
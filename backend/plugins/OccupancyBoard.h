@@ -0,0 +1,93 @@
+/**
+ *
+ *  OccupancyBoard.h
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 各分店的桌台占用：哪些桌有客、每桌几位、由哪些订单占用。
+ *
+ * 只由入座、离桌、清台三种事件驱动，同样的事件序列重放得到同样的状态，便于写前日志恢复。
+ * 每个分店维护就座人数和占用桌数两个计数，查询分店概况为 O(1)。
+ * 同一桌可挂多个订单（加单），订单入座时人数取较大值、不重复累加；手工入座直接设定人数，
+ * 不随订单结束而离桌，须手工清台。不加锁，由调用方保证互斥。
+ */
+class OccupancyBoard
+{
+public:
+  struct Event
+  {
+    enum Type : uint8_t
+    {
+      Seat = 1,    // 入座或加单，orderId 为 0 表示手工入座
+      Release = 2, // 订单结束，桌上没有其他订单且不是手工入座时离桌
+      Clear = 3    // 清台
+    };
+    Type type{Seat};
+    uint32_t branchId{0};
+    uint32_t orderId{0};
+    uint16_t covers{0};
+    std::string table;
+    int64_t at{0}; // 秒
+  };
+  struct Table
+  {
+    std::string name;
+    uint16_t covers{0};
+    int64_t since{0};
+    bool manual{false};
+    std::vector<uint32_t> orders;
+  };
+  struct Summary
+  {
+    uint32_t capacity{0};
+    uint32_t covers{0};
+    uint32_t tables{0};
+  };
+
+  /// 登记分店及其最大同时就餐人数，只有登记过的分店可查询
+  void setCapacity(uint32_t branchId, uint32_t capacity);
+  void removeBranch(uint32_t branchId);
+  bool hasBranch(uint32_t branchId) const;
+
+  /// 返回事件是否改变了状态
+  bool apply(const Event &event);
+
+  bool summary(uint32_t branchId, Summary &summary) const;
+  /// 分店当前有客的桌，按入座时刻排
+  std::vector<Table> tables(uint32_t branchId) const;
+  /// 订单所在的分店和桌，没有时返回 false
+  bool locate(uint32_t orderId, uint32_t &branchId, std::string &table) const;
+  /// 用入座事件表示的当前状态，重放后得到同样的状态；只含登记过的分店
+  std::vector<Event> checkpoint() const;
+
+  size_t orderCount() const { return orders_.size(); }
+
+private:
+  struct Branch
+  {
+    bool registered{false};
+    Summary summary;
+    std::unordered_map<std::string, Table> tables;
+  };
+  struct Seat
+  {
+    uint32_t branchId{0};
+    std::string table;
+  };
+
+  void seat(const Event &event);
+  bool release(uint32_t orderId);
+  bool clear(uint32_t branchId, const std::string &table);
+  void leave(Branch &branch, std::unordered_map<std::string, Table>::iterator table);
+
+  std::unordered_map<uint32_t, Branch> branches_;
+  std::unordered_map<uint32_t, Seat> orders_;
+};
@@ -0,0 +1,224 @@
+/**
+ *
+ *  OccupancyLog.cc
+ *
+ */
+
+#include "OccupancyLog.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+constexpr uint32_t kMagic = 0x4f434350; // "OCCP"
+constexpr size_t kRecordSize = 64;
+
+void put16(unsigned char *p, uint16_t v)
+{
+    p[0] = static_cast<unsigned char>(v);
+    p[1] = static_cast<unsigned char>(v >> 8);
+}
+
+void put32(unsigned char *p, uint32_t v)
+{
+    for (int i = 0; i < 4; ++i)
+        p[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+void put64(unsigned char *p, uint64_t v)
+{
+    for (int i = 0; i < 8; ++i)
+        p[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+uint16_t get16(const unsigned char *p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t get32(const unsigned char *p)
+{
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; --i)
+        v = (v << 8) | p[i];
+    return v;
+}
+
+uint64_t get64(const unsigned char *p)
+{
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; --i)
+        v = (v << 8) | p[i];
+    return v;
+}
+
+// FNV-1a
+uint32_t checksum(const unsigned char *p, size_t n)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < n; ++i)
+        h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+// magic | type | table 长度 | covers | branch | order | at | table | checksum
+void encodeRecord(const OccupancyBoard::Event &event, unsigned char *p)
+{
+    std::memset(p, 0, kRecordSize);
+    auto length = std::min(event.table.size(), OccupancyLog::kMaxTable);
+    put32(p, kMagic);
+    p[4] = event.type;
+    p[5] = static_cast<unsigned char>(length);
+    put16(p + 6, event.covers);
+    put32(p + 8, event.branchId);
+    put32(p + 12, event.orderId);
+    put64(p + 16, static_cast<uint64_t>(event.at));
+    std::memcpy(p + 24, event.table.data(), length);
+    put32(p + 60, checksum(p, 60));
+}
+
+bool decodeRecord(const unsigned char *p, OccupancyBoard::Event &event)
+{
+    if (get32(p) != kMagic || get32(p + 60) != checksum(p, 60) || p[4] < OccupancyBoard::Event::Seat ||
+        p[4] > OccupancyBoard::Event::Clear || p[5] > OccupancyLog::kMaxTable)
+        return false;
+    event.type = static_cast<OccupancyBoard::Event::Type>(p[4]);
+    event.covers = get16(p + 6);
+    event.branchId = get32(p + 8);
+    event.orderId = get32(p + 12);
+    event.at = static_cast<int64_t>(get64(p + 16));
+    event.table.assign(reinterpret_cast<const char *>(p + 24), p[5]);
+    return true;
+}
+
+bool writeAll(int fd, const std::vector<unsigned char> &buffer, uint64_t offset)
+{
+    size_t written = 0;
+    while (written < buffer.size())
+    {
+        auto n = ::pwrite(fd, buffer.data() + written, buffer.size() - written, static_cast<off_t>(offset + written));
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        written += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+std::vector<unsigned char> encodeAll(const std::vector<OccupancyBoard::Event> &events)
+{
+    std::vector<unsigned char> buffer(events.size() * kRecordSize);
+    for (size_t i = 0; i < events.size(); ++i)
+        encodeRecord(events[i], buffer.data() + i * kRecordSize);
+    return buffer;
+}
+} // namespace
+
+OccupancyLog::~OccupancyLog()
+{
+    if (fd_ >= 0)
+        ::close(fd_);
+}
+
+bool OccupancyLog::open(const std::string &path, std::string &error)
+{
+    path_ = path;
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0640);
+    if (fd_ < 0)
+    {
+        error = std::strerror(errno);
+        return false;
+    }
+    auto end = ::lseek(fd_, 0, SEEK_END);
+    size_ = end < 0 ? 0 : static_cast<uint64_t>(end);
+    return true;
+}
+
+size_t OccupancyLog::replay(const std::function<void(const OccupancyBoard::Event &)> &callback)
+{
+    size_t count = 0;
+    uint64_t valid = 0;
+    unsigned char buffer[kRecordSize * 256];
+    size_t filled = 0;
+    bool corrupted = false;
+    while (!corrupted)
+    {
+        auto n = ::pread(fd_, buffer + filled, sizeof(buffer) - filled, static_cast<off_t>(valid + filled));
+        if (n <= 0)
+            break;
+        filled += static_cast<size_t>(n);
+        size_t used = 0;
+        for (; used + kRecordSize <= filled; used += kRecordSize)
+        {
+            OccupancyBoard::Event event;
+            if (!decodeRecord(buffer + used, event))
+            {
+                corrupted = true;
+                break;
+            }
+            callback(event);
+            ++count;
+            valid += kRecordSize;
+        }
+        std::memmove(buffer, buffer + used, filled - used);
+        filled -= used;
+    }
+    // 丢弃末尾不完整或损坏的记录，后续追加从有效末尾开始
+    if (valid != size_ && ::ftruncate(fd_, static_cast<off_t>(valid)) == 0)
+        size_ = valid;
+    return count;
+}
+
+bool OccupancyLog::append(const std::vector<OccupancyBoard::Event> &events)
+{
+    if (events.empty())
+        return true;
+    auto buffer = encodeAll(events);
+    if (!writeAll(fd_, buffer, size_) || ::fdatasync(fd_) != 0)
+    {
+        // 截掉可能写了一部分的记录，调用方放弃本批事件
+        if (::ftruncate(fd_, static_cast<off_t>(size_)) != 0)
+            size_ = static_cast<uint64_t>(::lseek(fd_, 0, SEEK_END));
+        return false;
+    }
+    size_ += buffer.size();
+    return true;
+}
+
+bool OccupancyLog::rewrite(const std::vector<OccupancyBoard::Event> &events)
+{
+    // 先写临时文件并落盘，再 rename 替换，任一步失败旧日志都完整
+    auto temporary = path_ + ".tmp";
+    int fd = ::open(temporary.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0640);
+    if (fd < 0)
+        return false;
+    auto buffer = encodeAll(events);
+    if (!writeAll(fd, buffer, 0) || ::fdatasync(fd) != 0 || ::rename(temporary.c_str(), path_.c_str()) != 0)
+    {
+        ::close(fd);
+        ::unlink(temporary.c_str());
+        return false;
+    }
+    // rename 本身也要落盘
+    auto slash = path_.find_last_of('/');
+    auto directory = slash == std::string::npos ? std::string(".") : path_.substr(0, slash + 1);
+    int dirFd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd >= 0)
+    {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+    ::close(fd_);
+    fd_ = fd;
+    size_ = buffer.size();
+    return true;
+}
+
+uint64_t OccupancyLog::records() const
+{
+    return size_ / kRecordSize;
+}
@@ -0,0 +1,48 @@
+/**
+ *
+ *  OccupancyLog.h
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "OccupancyBoard.h"
+
+/**
+ * @brief 桌台占用事件的写前日志。
+ *
+ * 每条事件定长 64 字节并带校验，桌号最长 kMaxTable 字节；批量 write 后 fdatasync 一次（组提交）。
+ * 状态只保存在日志中，不写数据库：日志过长时把当前状态写成新日志，fdatasync 后 rename 替换旧日志（压缩）。
+ * 启动时重放，末尾写了一半的记录被忽略。
+ */
+class OccupancyLog
+{
+public:
+  static constexpr size_t kMaxTable = 36;
+
+  OccupancyLog() = default;
+  ~OccupancyLog();
+  OccupancyLog(const OccupancyLog &) = delete;
+  OccupancyLog &operator=(const OccupancyLog &) = delete;
+
+  bool open(const std::string &path, std::string &error);
+  bool isOpen() const { return fd_ >= 0; }
+  /// 按写入顺序回调每条完整记录，返回记录数
+  size_t replay(const std::function<void(const OccupancyBoard::Event &)> &callback);
+  /// 写入并落盘，失败时文件截回写入前的长度
+  bool append(const std::vector<OccupancyBoard::Event> &events);
+  /// 用 events 原子替换整个日志，失败时旧日志不变
+  bool rewrite(const std::vector<OccupancyBoard::Event> &events);
+  /// 日志中的记录数
+  uint64_t records() const;
+
+private:
+  std::string path_;
+  int fd_{-1};
+  uint64_t size_{0};
+};
@@ -0,0 +1,459 @@
+/**
+ *
+ *  OpeningHours.cc
+ *
+ */
+
+#include "OpeningHours.h"
+#include <algorithm>
+#include <cctype>
+#include <initializer_list>
+#include <map>
+#include <string_view>
+
+namespace
+{
+using Ranges = std::vector<std::pair<uint32_t, uint32_t>>; // [开始, 结束) 分钟，结束小于开始为跨夜
+
+constexpr uint32_t kDayMinutes = 24 * 60;
+constexpr int32_t kMaxHolidaySpan = 366;
+
+struct Cursor
+{
+    const std::string &text;
+    size_t pos{0};
+
+    bool done() const { return pos >= text.size(); }
+    bool digit() const { return !done() && text[pos] >= '0' && text[pos] <= '9'; }
+    void skipSpaces()
+    {
+        while (!done())
+        {
+            if (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r')
+                ++pos;
+            else if (text.compare(pos, 3, "　") == 0)
+                pos += 3;
+            else
+                break;
+        }
+    }
+    bool consume(const char *literal)
+    {
+        std::string_view word(literal);
+        if (text.compare(pos, word.size(), word) != 0)
+            return false;
+        pos += word.size();
+        return true;
+    }
+    bool consumeAny(std::initializer_list<const char *> literals)
+    {
+        for (auto literal : literals)
+            if (consume(literal))
+                return true;
+        return false;
+    }
+    // 英文不区分大小写
+    bool consumeWord(const char *word)
+    {
+        size_t length = std::char_traits<char>::length(word);
+        if (pos + length > text.size())
+            return false;
+        for (size_t i = 0; i < length; ++i)
+            if (std::tolower(static_cast<unsigned char>(text[pos + i])) != word[i])
+                return false;
+        pos += length;
+        while (!done() && (std::isalpha(static_cast<unsigned char>(text[pos])) || text[pos] == '.'))
+            ++pos;
+        return true;
+    }
+    bool rangeSeparator()
+    {
+        skipSpaces();
+        return consumeAny({"-", "~", "～", "至", "到", "—", "–"});
+    }
+    bool listSeparator()
+    {
+        skipSpaces();
+        return consumeAny({",", "，", "、"});
+    }
+    bool number(size_t minDigits, size_t maxDigits, uint32_t &value)
+    {
+        size_t count = 0;
+        value = 0;
+        while (digit() && count < maxDigits)
+        {
+            value = value * 10 + static_cast<uint32_t>(text[pos++] - '0');
+            ++count;
+        }
+        return count >= minDigits;
+    }
+};
+
+bool parseTime(Cursor &cursor, uint32_t &minutes, std::string &error)
+{
+    cursor.skipSpaces();
+    uint32_t hour = 0;
+    uint32_t minute = 0;
+    if (!cursor.number(1, 2, hour) || !cursor.consumeAny({":", "："}) || !cursor.number(2, 2, minute))
+    {
+        error = "无法识别，时间应写成 HH:MM";
+        return false;
+    }
+    if (minute >= 60 || hour > 24 || (hour == 24 && minute != 0))
+    {
+        error = "时间超出范围";
+        return false;
+    }
+    if (minute % OpeningHours::kSlotMinutes != 0)
+    {
+        error = "时间须为 5 分钟的整数倍";
+        return false;
+    }
+    minutes = hour * 60 + minute;
+    return true;
+}
+
+bool parseRanges(Cursor &cursor, Ranges &ranges, std::string &error)
+{
+    cursor.skipSpaces();
+    if (cursor.consumeAny({"休息", "闭店", "不营业", "closed", "Closed"}))
+        return true;
+    if (cursor.consumeAny({"全天", "24小时"}))
+    {
+        ranges.emplace_back(0, kDayMinutes);
+        return true;
+    }
+    while (true)
+    {
+        uint32_t start = 0;
+        uint32_t end = 0;
+        if (!parseTime(cursor, start, error))
+            return false;
+        if (!cursor.rangeSeparator())
+        {
+            error = "时段应写成 HH:MM-HH:MM";
+            return false;
+        }
+        if (!parseTime(cursor, end, error))
+            return false;
+        if (start == end || start == kDayMinutes)
+        {
+            error = "时段的开始和结束不能相同";
+            return false;
+        }
+        ranges.emplace_back(start, end);
+        // 时段之间可用逗号或空格分隔
+        bool separated = cursor.listSeparator();
+        cursor.skipSpaces();
+        if (cursor.done())
+            return true;
+        if (!separated && !cursor.digit())
+        {
+            error = "时段后有无法识别的内容";
+            return false;
+        }
+    }
+}
+
+bool parseWeekday(Cursor &cursor, uint32_t &weekday)
+{
+    cursor.skipSpaces();
+    static const char *const english[] = {"mon", "tue", "wed", "thu", "fri", "sat", "sun"};
+    for (uint32_t i = 0; i < 7; ++i)
+        if (cursor.consumeWord(english[i]))
+        {
+            weekday = i;
+            return true;
+        }
+    auto mark = cursor.pos;
+    if (!cursor.consumeAny({"星期", "礼拜", "周"}))
+        return false;
+    static const char *const chinese[] = {"一", "二", "三", "四", "五", "六", "日", "天"};
+    for (uint32_t i = 0; i < 8; ++i)
+        if (cursor.consume(chinese[i]))
+        {
+            weekday = std::min(i, 6u);
+            return true;
+        }
+    cursor.pos = mark;
+    return false;
+}
+
+// 星期掩码，位 0 为周一；没写星期时为 0
+bool parseDays(Cursor &cursor, uint32_t &mask, std::string &error)
+{
+    mask = 0;
+    while (true)
+    {
+        cursor.skipSpaces();
+        if (cursor.consumeAny({"每天", "每日", "全周"}) || cursor.consumeWord("daily"))
+            mask |= 0x7F;
+        else if (cursor.consumeAny({"工作日"}) || cursor.consumeWord("weekday"))
+            mask |= 0x1F;
+        else if (cursor.consumeAny({"周末"}) || cursor.consumeWord("weekend"))
+            mask |= 0x60;
+        else
+        {
+            uint32_t from = 0;
+            if (!parseWeekday(cursor, from))
+            {
+                // 没写星期即每天，后面的内容交给时段解析
+                if (mask == 0)
+                    return true;
+                error = "分隔符后应为星期";
+                return false;
+            }
+            auto to = from;
+            auto mark = cursor.pos;
+            if (cursor.rangeSeparator())
+            {
+                if (!parseWeekday(cursor, to))
+                {
+                    cursor.pos = mark;
+                    error = "星期区间应写成 周一至周五";
+                    return false;
+                }
+            }
+            // 允许 周五至周一 这样跨周的区间
+            for (auto day = from;; day = (day + 1) % 7)
+            {
+                mask |= 1u << day;
+                if (day == to)
+                    break;
+            }
+        }
+        auto mark = cursor.pos;
+        if (!cursor.listSeparator())
+            return true;
+        cursor.skipSpaces();
+        if (cursor.digit())
+        {
+            cursor.pos = mark;
+            return true;
+        }
+    }
+}
+
+bool isDateAhead(const Cursor &cursor)
+{
+    const auto &text = cursor.text;
+    auto pos = cursor.pos;
+    for (size_t i = 0; i < 4; ++i)
+        if (pos + i >= text.size() || text[pos + i] < '0' || text[pos + i] > '9')
+            return false;
+    return pos + 4 < text.size() && (text[pos + 4] == '-' || text[pos + 4] == '/');
+}
+
+bool parseDate(Cursor &cursor, int32_t &day, std::string &error)
+{
+    cursor.skipSpaces();
+    uint32_t year = 0;
+    uint32_t month = 0;
+    uint32_t date = 0;
+    if (!cursor.number(4, 4, year) || !cursor.consumeAny({"-", "/"}) || !cursor.number(1, 2, month) ||
+        !cursor.consumeAny({"-", "/"}) || !cursor.number(1, 2, date))
+    {
+        error = "日期应写成 YYYY-MM-DD";
+        return false;
+    }
+    static const uint32_t days[] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    if (year < 2000 || year > 2100 || month < 1 || month > 12 || date < 1 || date > days[month - 1] ||
+        (month == 2 && date == 29 && !leap))
+    {
+        error = "日期不存在";
+        return false;
+    }
+    day = OpeningHours::dayOf(static_cast<int32_t>(year), month, date);
+    return true;
+}
+
+void setSlots(OpeningHours::Day &bits, uint32_t from, uint32_t to)
+{
+    for (auto slot = from / OpeningHours::kSlotMinutes; slot < to / OpeningHours::kSlotMinutes; ++slot)
+        bits[slot / 64] |= uint64_t(1) << (slot % 64);
+}
+
+bool testSlot(const OpeningHours::Day &bits, uint32_t slot)
+{
+    return (bits[slot / 64] >> (slot % 64)) & 1;
+}
+
+// from 起第一个为 wanted 的格，没有时返回 kSlotsPerDay
+uint32_t findSlot(const OpeningHours::Day &bits, uint32_t from, bool wanted)
+{
+    for (auto w = from / 64; w < bits.size(); ++w)
+    {
+        uint64_t word = wanted ? bits[w] : ~bits[w];
+        if (w == from / 64)
+            word &= ~uint64_t(0) << (from % 64);
+        auto valid = OpeningHours::kSlotsPerDay - w * 64;
+        if (valid < 64)
+            word &= (uint64_t(1) << valid) - 1;
+        if (word)
+            return static_cast<uint32_t>(w * 64 + __builtin_ctzll(word));
+    }
+    return OpeningHours::kSlotsPerDay;
+}
+} // namespace
+
+bool OpeningHours::parse(const std::string &text, OpeningHours &hours, std::string &error)
+{
+    // 先按段切开，段内再逐个解析
+    std::vector<std::string> entries;
+    std::string current;
+    for (size_t pos = 0; pos <= text.size();)
+    {
+        size_t length = 0;
+        if (pos == text.size())
+            length = 1;
+        else if (text[pos] == ';' || text[pos] == '\n')
+            length = 1;
+        else if (text.compare(pos, 3, "；") == 0)
+            length = 3;
+        if (length == 0)
+        {
+            current += text[pos++];
+            continue;
+        }
+        if (current.find_first_not_of(" \t\r") != std::string::npos)
+            entries.push_back(current);
+        current.clear();
+        pos += length;
+    }
+    if (entries.empty())
+    {
+        error = "营业时间为空";
+        return false;
+    }
+
+    std::array<Ranges, 7> weekly;
+    std::map<int32_t, Ranges> holidays;
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        Cursor cursor{entries[i]};
+        std::string reason;
+        Ranges ranges;
+        cursor.skipSpaces();
+        bool ok = true;
+        if (isDateAhead(cursor))
+        {
+            int32_t from = 0;
+            int32_t to = 0;
+            ok = parseDate(cursor, from, reason);
+            to = from;
+            if (ok)
+            {
+                auto mark = cursor.pos;
+                cursor.skipSpaces();
+                if (cursor.rangeSeparator() && (cursor.skipSpaces(), isDateAhead(cursor)))
+                    ok = parseDate(cursor, to, reason);
+                else
+                    cursor.pos = mark;
+            }
+            if (ok && (to < from || to - from >= kMaxHolidaySpan))
+            {
+                reason = "日期区间无效";
+                ok = false;
+            }
+            ok = ok && parseRanges(cursor, ranges, reason);
+            for (const auto &[start, end] : ranges)
+                if (ok && end < start)
+                {
+                    reason = "节假日时段不能跨夜";
+                    ok = false;
+                }
+            if (ok)
+                for (auto day = from; day <= to; ++day)
+                    holidays[day] = ranges;
+        }
+        else
+        {
+            uint32_t mask = 0;
+            ok = parseDays(cursor, mask, reason) && parseRanges(cursor, ranges, reason);
+            if (ok)
+                for (uint32_t day = 0; day < 7; ++day)
+                    if (mask == 0 || (mask >> day) & 1)
+                        weekly[day] = ranges;
+        }
+        if (!ok)
+        {
+            auto begin = entries[i].find_first_not_of(" \t\r");
+            auto end = entries[i].find_last_not_of(" \t\r");
+            error = "营业时间第 " + std::to_string(i + 1) + " 段「" + entries[i].substr(begin, end - begin + 1) +
+                    "」：" + reason;
+            return false;
+        }
+    }
+
+    OpeningHours compiled;
+    for (uint32_t day = 0; day < 7; ++day)
+        for (const auto &[start, end] : weekly[day])
+        {
+            if (start < end)
+            {
+                setSlots(compiled.week_[day], start, end);
+                continue;
+            }
+            // 跨夜：后半段记到下一天
+            setSlots(compiled.week_[day], start, kDayMinutes);
+            setSlots(compiled.week_[(day + 1) % 7], 0, end);
+        }
+    compiled.holidays_.reserve(holidays.size());
+    for (const auto &[day, ranges] : holidays)
+    {
+        Day bits{};
+        for (const auto &[start, end] : ranges)
+            setSlots(bits, start, end);
+        compiled.holidays_.emplace_back(day, bits);
+    }
+    hours = std::move(compiled);
+    return true;
+}
+
+int32_t OpeningHours::dayOf(int32_t year, uint32_t month, uint32_t day)
+{
+    // 公历转儒略日的常用算法，以 3 月为一年的开始
+    year -= month <= 2;
+    const int32_t era = (year >= 0 ? year : year - 399) / 400;
+    const auto yearOfEra = static_cast<uint32_t>(year - era * 400);
+    const uint32_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const uint32_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<int32_t>(dayOfEra) - 719468;
+}
+
+uint32_t OpeningHours::weekdayOf(int32_t day)
+{
+    // 1970-01-01 是周四
+    return static_cast<uint32_t>((day % 7 + 7 + 3) % 7);
+}
+
+const OpeningHours::Day &OpeningHours::dayBits(int32_t day) const
+{
+    auto it = std::lower_bound(holidays_.begin(),
+                               holidays_.end(),
+                               day,
+                               [](const std::pair<int32_t, Day> &holiday, int32_t value) { return holiday.first < value; });
+    if (it != holidays_.end() && it->first == day)
+        return it->second;
+    return week_[weekdayOf(day)];
+}
+
+bool OpeningHours::isOpen(int32_t day, uint32_t minute) const
+{
+    return testSlot(dayBits(day), std::min(minute, kDayMinutes - 1) / kSlotMinutes);
+}
+
+int64_t OpeningHours::minutesUntilChange(int32_t day, uint32_t minute, int32_t horizonDays) const
+{
+    minute = std::min(minute, kDayMinutes - 1);
+    auto slot = minute / kSlotMinutes;
+    bool open = testSlot(dayBits(day), slot);
+    for (int32_t offset = 0; offset <= horizonDays; ++offset)
+    {
+        auto next = findSlot(dayBits(day + offset), offset == 0 ? slot + 1 : 0, !open);
+        if (next < kSlotsPerDay)
+            return int64_t(offset) * kDayMinutes + next * kSlotMinutes - minute;
+    }
+    return -1;
+}
@@ -0,0 +1,56 @@
+/**
+ *
+ *  OpeningHours.h
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 分店营业时间：由 branch.opening_hours 文本解析一次，编译成按 5 分钟一格的周位图。
+ *
+ * 文本由 ";"、"；" 或换行分隔成若干段，每段为：
+ *   [星期] 时段[,时段...]     例：每天 10:00-22:00；周一至周五 11:00-14:00,17:00-21:30；周一 休息
+ *   日期[至日期] 时段或休息    例：2025-10-01 休息；2025-10-02至2025-10-03 10:00-14:00
+ * 星期可写 周一/星期一/Mon、工作日、周末、每天，多个用 "," 或 "、" 分隔，区间用 "-"、"~" 或 "至"；
+ * 省略星期即每天。时段写法为 HH:MM-HH:MM，须为 5 分钟的整数倍，结束早于开始表示营业到次日，
+ * 也可写 全天、休息。后面的段覆盖前面同一天的设置。
+ * 日期段为节假日，整天替换当天的设置（包括前一天跨夜延续过来的部分），不能跨夜。
+ * 日期以本地日计，为 1970-01-01 起的天数；分钟为当天零点起的分钟数。
+ */
+class OpeningHours
+{
+public:
+  static constexpr uint32_t kSlotMinutes = 5;
+  static constexpr uint32_t kSlotsPerDay = 24 * 60 / kSlotMinutes;
+  /// 一天 288 格，每格一位
+  using Day = std::array<uint64_t, (kSlotsPerDay + 63) / 64>;
+
+  /// 解析失败返回 false，error 为给用户看的说明
+  static bool parse(const std::string &text, OpeningHours &hours, std::string &error);
+  /// 公历日期转 1970-01-01 起的天数
+  static int32_t dayOf(int32_t year, uint32_t month, uint32_t day);
+  /// 0 为周一
+  static uint32_t weekdayOf(int32_t day);
+
+  bool isOpen(int32_t day, uint32_t minute) const;
+  /// 从 day 的 minute 起，营业状态保持不变的分钟数；horizonDays 天内都不变时返回 -1
+  int64_t minutesUntilChange(int32_t day, uint32_t minute, int32_t horizonDays = 8) const;
+
+  /// 按星期的位图，0 为周一
+  const std::array<Day, 7> &week() const { return week_; }
+  /// 按日期升序的节假日
+  const std::vector<std::pair<int32_t, Day>> &holidays() const { return holidays_; }
+
+private:
+  const Day &dayBits(int32_t day) const;
+
+  std::array<Day, 7> week_{};
+  std::vector<std::pair<int32_t, Day>> holidays_;
+};
@@ -0,0 +1,132 @@
+/**
+ *
+ *  OrderAnalytics.cc
+ *
+ */
+
+#include "OrderAnalytics.h"
+#include <drogon/drogon.h>
+#include <ctime>
+
+using namespace drogon;
+using namespace drogon::orm;
+using namespace drogon_model::saas_restaurant;
+
+void OrderAnalytics::initAndStart(const Json::Value &config)
+{
+    dbClient_ = app().getDbClient(config.get("db_client", "default").asString());
+    windowSeconds_ = config.get("window_days", 400).asInt64() * 86400;
+
+    load();
+
+    // 每小时丢弃窗口之外的订单
+    timerId_ = app().getLoop()->runEvery(3600.0, [this]() { columns_.trim(windowStart()); });
+}
+
+void OrderAnalytics::shutdown()
+{
+    app().getLoop()->invalidateTimer(timerId_);
+}
+
+int64_t OrderAnalytics::windowStart() const
+{
+    return trantor::Date::now().secondsSinceEpoch() - windowSeconds_;
+}
+
+OrderColumns::OrderRow OrderAnalytics::rowOf(uint32_t orderId,
+                                             uint32_t tenantId,
+                                             uint32_t branchId,
+                                             const Money &amount,
+                                             const trantor::Date &createdAt,
+                                             const std::string &paymentMethod,
+                                             const std::string &orderStatus)
+{
+    OrderColumns::OrderRow row;
+    row.orderId = orderId;
+    row.tenantId = tenantId;
+    row.branchId = branchId;
+    row.amountCents = amount.raw();
+    row.createdAt = createdAt.secondsSinceEpoch();
+    row.paymentMethod = paymentMethod;
+    row.orderStatus = orderStatus;
+
+    // 星期和小时按服务器本地时间拆分，与报表时间桶一致
+    time_t seconds = static_cast<time_t>(row.createdAt);
+    struct tm local;
+    localtime_r(&seconds, &local);
+    row.weekday = static_cast<uint8_t>(local.tm_wday == 0 ? 7 : local.tm_wday);
+    row.hour = static_cast<uint8_t>(local.tm_hour);
+    return row;
+}
+
+void OrderAnalytics::load()
+{
+    auto from = trantor::Date(windowStart() * 1000000);
+    try
+    {
+        auto rows = dbClient_->execSqlSync(
+            "select order_id, tenant_id, branch_id, total_amount, payment_method, order_status, created_at "
+            "from order_table where created_at >= ? and (is_deleted = 0 or is_deleted is null) order by created_at",
+            from.toDbStringLocal());
+        for (const auto &row : rows)
+        {
+            columns_.upsert(rowOf(row["order_id"].as<uint32_t>(),
+                                  row["tenant_id"].as<uint32_t>(),
+                                  row["branch_id"].isNull() ? 0 : row["branch_id"].as<uint32_t>(),
+                                  row["total_amount"].isNull() ? Money() : Money::fromString(row["total_amount"].as<std::string>()),
+                                  trantor::Date::fromDbStringLocal(row["created_at"].as<std::string>()),
+                                  row["payment_method"].isNull() ? "" : row["payment_method"].as<std::string>(),
+                                  row["order_status"].isNull() ? "" : row["order_status"].as<std::string>()));
+        }
+        LOG_INFO << "Order analytics loaded " << columns_.size() << " orders";
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to load orders for analytics: " << e.base().what();
+    }
+}
+
+void OrderAnalytics::orderCreated(const OrderTable &order)
+{
+    if (order.getValueOfIsDeleted() == 1)
+        return;
+    auto createdAt = order.getCreatedAt() ? order.getValueOfCreatedAt() : trantor::Date::now();
+    columns_.upsert(rowOf(order.getValueOfOrderId(),
+                          order.getValueOfTenantId(),
+                          order.getValueOfBranchId(),
+                          Money::fromString(order.getValueOfTotalAmount()),
+                          createdAt,
+                          order.getValueOfPaymentMethod(),
+                          order.getValueOfOrderStatus()));
+}
+
+void OrderAnalytics::refreshOrder(uint32_t orderId)
+{
+    Mapper<OrderTable> mapper(dbClient_);
+    mapper.findByPrimaryKey(
+        orderId,
+        [this](const OrderTable &order)
+        {
+            if (order.getValueOfIsDeleted() == 1)
+                columns_.remove(order.getValueOfOrderId());
+            else
+                orderCreated(order);
+        },
+        [this, orderId](const DrogonDbException &e)
+        {
+            if (dynamic_cast<const UnexpectedRows *>(&e.base()))
+                columns_.remove(orderId);
+            else
+                LOG_ERROR << "Failed to refresh order " << orderId << " for analytics: " << e.base().what();
+        });
+}
+
+void OrderAnalytics::removeOrder(uint32_t orderId)
+{
+    columns_.remove(orderId);
+}
+
+OrderColumns::Result OrderAnalytics::query(const OrderColumns::Query &query) const
+{
+    return columns_.query(query);
+}
@@ -0,0 +1,61 @@
+/**
+ *
+ *  OrderAnalytics.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/orm/DbClient.h>
+#include <trantor/net/EventLoop.h>
+#include <trantor/utils/Date.h>
+
+#include "Money.h"
+#include "OrderColumns.h"
+#include "OrderTable.h"
+
+/**
+ * @brief 最近订单的列式分析缓存。
+ *
+ * 启动时从 order_table 加载 window_days 天内的订单，订单写入时同步追加或更新，
+ * 每小时丢弃窗口之外的订单。/api/analytics/query 只读这份缓存，不访问数据库。
+ */
+class OrderAnalytics : public drogon::Plugin<OrderAnalytics>
+{
+public:
+  OrderAnalytics() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  /// 订单创建后追加
+  void orderCreated(const drogon_model::saas_restaurant::OrderTable &order);
+  /// 订单修改后重新读取，已删除的订单移出缓存
+  void refreshOrder(uint32_t orderId);
+  /// 订单被物理删除
+  void removeOrder(uint32_t orderId);
+
+  OrderColumns::Result query(const OrderColumns::Query &query) const;
+  /// 缓存覆盖的最早时间（秒）
+  int64_t windowStart() const;
+
+private:
+  static OrderColumns::OrderRow rowOf(uint32_t orderId,
+                                      uint32_t tenantId,
+                                      uint32_t branchId,
+                                      const Money &amount,
+                                      const trantor::Date &createdAt,
+                                      const std::string &paymentMethod,
+                                      const std::string &orderStatus);
+  void load();
+
+  drogon::orm::DbClientPtr dbClient_;
+  trantor::TimerId timerId_{0};
+  int64_t windowSeconds_{400 * 86400};
+  OrderColumns columns_;
+};
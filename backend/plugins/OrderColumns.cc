@@ -0,0 +1,479 @@
+/**
+ *
+ *  OrderColumns.cc
+ *
+ */
+
+#include "OrderColumns.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define ORDER_COLUMNS_X86 1
+#endif
+
+namespace
+{
+// 每块的行数，掩码和分组下标放在栈上
+constexpr size_t kBlockRows = 2048;
+
+bool detectAvx2()
+{
+#ifdef ORDER_COLUMNS_X86
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+std::atomic<bool> &simdFlag()
+{
+    static std::atomic<bool> enabled{detectAvx2()};
+    return enabled;
+}
+
+void rangeMaskScalar(const int64_t *ts, size_t n, int64_t from, int64_t to, uint8_t *mask)
+{
+    for (size_t i = 0; i < n; ++i)
+        mask[i] = static_cast<uint8_t>((ts[i] >= from) & (ts[i] < to));
+}
+
+void groupKeysScalar(const uint8_t *const *dims, const uint32_t *strides, const uint8_t *mask,
+                     uint32_t trash, size_t n, uint32_t *keys)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        uint32_t key = 0;
+        for (size_t d = 0; d < OrderColumns::DimensionCount; ++d)
+            key += dims[d][i] * strides[d];
+        keys[i] = mask[i] ? key : trash;
+    }
+}
+
+void maskedSumScalar(const int64_t *amounts, const uint8_t *mask, size_t n, uint64_t &count, int64_t &sum)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        count += mask[i];
+        sum += amounts[i] & -static_cast<int64_t>(mask[i]);
+    }
+}
+
+#ifdef ORDER_COLUMNS_X86
+__attribute__((target("avx2"))) void maskedSumAvx2(const int64_t *amounts, const uint8_t *mask, size_t n,
+                                                    uint64_t &count, int64_t &sum)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i sums = zero;
+    __m256i counts = zero;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        int32_t bytes;
+        std::memcpy(&bytes, mask + i, sizeof(bytes));
+        __m256i selected = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(bytes));
+        counts = _mm256_add_epi64(counts, selected);
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(amounts + i));
+        sums = _mm256_add_epi64(sums, _mm256_and_si256(v, _mm256_sub_epi64(zero, selected)));
+    }
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), sums);
+    sum += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), counts);
+    count += static_cast<uint64_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    maskedSumScalar(amounts + i, mask + i, n - i, count, sum);
+}
+
+__attribute__((target("avx2"))) void rangeMaskAvx2(const int64_t *ts, size_t n, int64_t from, int64_t to,
+                                                    uint8_t *mask)
+{
+    const __m256i vfrom = _mm256_set1_epi64x(from);
+    const __m256i vto = _mm256_set1_epi64x(to);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ts + i));
+        // from <= ts && ts < to
+        __m256i before = _mm256_cmpgt_epi64(vfrom, v);
+        __m256i inside = _mm256_andnot_si256(before, _mm256_cmpgt_epi64(vto, v));
+        int bits = _mm256_movemask_pd(_mm256_castsi256_pd(inside));
+        mask[i] = bits & 1;
+        mask[i + 1] = (bits >> 1) & 1;
+        mask[i + 2] = (bits >> 2) & 1;
+        mask[i + 3] = (bits >> 3) & 1;
+    }
+    rangeMaskScalar(ts + i, n - i, from, to, mask + i);
+}
+
+__attribute__((target("avx2"))) void groupKeysAvx2(const uint8_t *const *dims, const uint32_t *strides,
+                                                    const uint8_t *mask, uint32_t trash, size_t n, uint32_t *keys)
+{
+    __m256i vstrides[OrderColumns::DimensionCount];
+    for (size_t d = 0; d < OrderColumns::DimensionCount; ++d)
+        vstrides[d] = _mm256_set1_epi32(static_cast<int>(strides[d]));
+    const __m256i vtrash = _mm256_set1_epi32(static_cast<int>(trash));
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i key = zero;
+        for (size_t d = 0; d < OrderColumns::DimensionCount; ++d)
+        {
+            __m256i codes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(dims[d] + i)));
+            key = _mm256_add_epi32(key, _mm256_mullo_epi32(codes, vstrides[d]));
+        }
+        // 被过滤的行写到丢弃槽，累加时不用分支
+        __m256i selected = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(mask + i)));
+        __m256i dropped = _mm256_cmpeq_epi32(selected, zero);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(keys + i), _mm256_blendv_epi8(key, vtrash, dropped));
+    }
+    const uint8_t *tail[OrderColumns::DimensionCount];
+    for (size_t d = 0; d < OrderColumns::DimensionCount; ++d)
+        tail[d] = dims[d] + i;
+    groupKeysScalar(tail, strides, mask + i, trash, n - i, keys + i);
+}
+#endif
+
+void maskedSum(const int64_t *amounts, const uint8_t *mask, size_t n, uint64_t &count, int64_t &sum)
+{
+#ifdef ORDER_COLUMNS_X86
+    if (simdFlag().load(std::memory_order_relaxed))
+    {
+        maskedSumAvx2(amounts, mask, n, count, sum);
+        return;
+    }
+#endif
+    maskedSumScalar(amounts, mask, n, count, sum);
+}
+
+void rangeMask(const int64_t *ts, size_t n, int64_t from, int64_t to, uint8_t *mask)
+{
+#ifdef ORDER_COLUMNS_X86
+    if (simdFlag().load(std::memory_order_relaxed))
+    {
+        rangeMaskAvx2(ts, n, from, to, mask);
+        return;
+    }
+#endif
+    rangeMaskScalar(ts, n, from, to, mask);
+}
+
+void groupKeys(const uint8_t *const *dims, const uint32_t *strides, const uint8_t *mask, uint32_t trash,
+               size_t n, uint32_t *keys)
+{
+#ifdef ORDER_COLUMNS_X86
+    if (simdFlag().load(std::memory_order_relaxed))
+    {
+        groupKeysAvx2(dims, strides, mask, trash, n, keys);
+        return;
+    }
+#endif
+    groupKeysScalar(dims, strides, mask, trash, n, keys);
+}
+
+const uint32_t kDimensionSizes[] = {8, 24, 0, 0}; // 字典维度的大小取字典长度
+} // namespace
+
+const char *OrderColumns::dimensionName(Dimension dimension)
+{
+    switch (dimension)
+    {
+    case Weekday:
+        return "weekday";
+    case Hour:
+        return "hour";
+    case PaymentMethod:
+        return "payment_method";
+    case OrderStatus:
+        return "order_status";
+    default:
+        return "";
+    }
+}
+
+bool OrderColumns::parseDimension(const std::string &name, Dimension &dimension)
+{
+    for (uint8_t d = 0; d < DimensionCount; ++d)
+    {
+        if (name == dimensionName(static_cast<Dimension>(d)))
+        {
+            dimension = static_cast<Dimension>(d);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool OrderColumns::simdEnabled()
+{
+    return simdFlag().load();
+}
+
+void OrderColumns::setSimdEnabled(bool enabled)
+{
+    simdFlag().store(enabled && detectAvx2());
+}
+
+uint8_t OrderColumns::Dictionary::encode(const std::string &value)
+{
+    auto it = codes.find(value);
+    if (it != codes.end())
+        return it->second;
+    // 超出 255 个取值时归入空值
+    if (values.size() > 255)
+        return 0;
+    auto code = static_cast<uint8_t>(values.size());
+    values.push_back(value);
+    codes.emplace(value, code);
+    return code;
+}
+
+void OrderColumns::upsert(const OrderRow &row)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto owner = orderTenants_.find(row.orderId);
+    if (owner != orderTenants_.end() && owner->second != row.tenantId)
+    {
+        auto &previous = tenants_[owner->second];
+        auto it = previous.rowOf.find(row.orderId);
+        if (it != previous.rowOf.end())
+        {
+            previous.alive[it->second] = 0;
+            previous.rowOf.erase(it);
+        }
+    }
+    orderTenants_[row.orderId] = row.tenantId;
+
+    auto &columns = tenants_[row.tenantId];
+    auto payment = payments_.encode(row.paymentMethod);
+    auto status = statuses_.encode(row.orderStatus);
+    auto existing = columns.rowOf.find(row.orderId);
+    if (existing != columns.rowOf.end())
+    {
+        auto i = existing->second;
+        if ((i > 0 && row.createdAt < columns.createdAt[i - 1]) ||
+            (i + 1 < columns.createdAt.size() && row.createdAt > columns.createdAt[i + 1]))
+            columns.sorted = false;
+        columns.createdAt[i] = row.createdAt;
+        columns.amounts[i] = row.amountCents;
+        columns.branches[i] = row.branchId;
+        columns.weekdays[i] = row.weekday;
+        columns.hours[i] = row.hour;
+        columns.payments[i] = payment;
+        columns.statuses[i] = status;
+        columns.alive[i] = 1;
+        return;
+    }
+    if (!columns.createdAt.empty() && row.createdAt < columns.createdAt.back())
+        columns.sorted = false;
+    columns.rowOf.emplace(row.orderId, static_cast<uint32_t>(columns.orderIds.size()));
+    columns.orderIds.push_back(row.orderId);
+    columns.createdAt.push_back(row.createdAt);
+    columns.amounts.push_back(row.amountCents);
+    columns.branches.push_back(row.branchId);
+    columns.weekdays.push_back(row.weekday);
+    columns.hours.push_back(row.hour);
+    columns.payments.push_back(payment);
+    columns.statuses.push_back(status);
+    columns.alive.push_back(1);
+}
+
+void OrderColumns::remove(uint32_t orderId)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto owner = orderTenants_.find(orderId);
+    if (owner == orderTenants_.end())
+        return;
+    auto &columns = tenants_[owner->second];
+    auto it = columns.rowOf.find(orderId);
+    if (it != columns.rowOf.end())
+    {
+        columns.alive[it->second] = 0;
+        columns.rowOf.erase(it);
+    }
+    orderTenants_.erase(owner);
+}
+
+void OrderColumns::trim(int64_t before)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    for (auto &[tenantId, columns] : tenants_)
+    {
+        // 顺带清掉已删除的行
+        TenantColumns kept;
+        for (size_t i = 0; i < columns.orderIds.size(); ++i)
+        {
+            if (!columns.alive[i] || columns.createdAt[i] < before)
+            {
+                if (columns.alive[i])
+                    orderTenants_.erase(columns.orderIds[i]);
+                continue;
+            }
+            kept.rowOf.emplace(columns.orderIds[i], static_cast<uint32_t>(kept.orderIds.size()));
+            kept.orderIds.push_back(columns.orderIds[i]);
+            kept.createdAt.push_back(columns.createdAt[i]);
+            kept.amounts.push_back(columns.amounts[i]);
+            kept.branches.push_back(columns.branches[i]);
+            kept.weekdays.push_back(columns.weekdays[i]);
+            kept.hours.push_back(columns.hours[i]);
+            kept.payments.push_back(columns.payments[i]);
+            kept.statuses.push_back(columns.statuses[i]);
+            kept.alive.push_back(1);
+        }
+        kept.sorted = std::is_sorted(kept.createdAt.begin(), kept.createdAt.end());
+        columns = std::move(kept);
+    }
+}
+
+size_t OrderColumns::size() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    size_t rows = 0;
+    for (auto &[tenantId, columns] : tenants_)
+        rows += columns.rowOf.size();
+    return rows;
+}
+
+void OrderColumns::scan(const TenantColumns &columns,
+                        const Query &query,
+                        const uint8_t *paymentAllowed,
+                        const uint8_t *statusAllowed,
+                        const uint32_t *strides,
+                        uint32_t trash,
+                        std::vector<uint64_t> &counts,
+                        std::vector<int64_t> &sums,
+                        uint64_t &scanned) const
+{
+    size_t first = 0;
+    size_t last = columns.orderIds.size();
+    if (columns.sorted)
+    {
+        first = std::lower_bound(columns.createdAt.begin(), columns.createdAt.end(), query.from) -
+                columns.createdAt.begin();
+        last = std::lower_bound(columns.createdAt.begin() + first, columns.createdAt.end(), query.to) -
+               columns.createdAt.begin();
+    }
+    scanned += last - first;
+
+    const uint8_t *dims[DimensionCount] = {columns.weekdays.data(),
+                                           columns.hours.data(),
+                                           columns.payments.data(),
+                                           columns.statuses.data()};
+    uint8_t mask[kBlockRows];
+    uint32_t keys[kBlockRows];
+    for (size_t begin = first; begin < last; begin += kBlockRows)
+    {
+        auto n = std::min(kBlockRows, last - begin);
+        rangeMask(columns.createdAt.data() + begin, n, query.from, query.to, mask);
+        const uint8_t *alive = columns.alive.data() + begin;
+        const uint8_t *payments = columns.payments.data() + begin;
+        const uint8_t *statuses = columns.statuses.data() + begin;
+        for (size_t i = 0; i < n; ++i)
+            mask[i] &= alive[i] & paymentAllowed[payments[i]] & statusAllowed[statuses[i]];
+        if (query.branchId != 0)
+        {
+            const uint32_t *branches = columns.branches.data() + begin;
+            for (size_t i = 0; i < n; ++i)
+                mask[i] &= static_cast<uint8_t>(branches[i] == query.branchId);
+        }
+
+        const int64_t *amounts = columns.amounts.data() + begin;
+        if (trash == 1)
+        {
+            // 不分组时直接按掩码求和
+            maskedSum(amounts, mask, n, counts[0], sums[0]);
+            continue;
+        }
+        const uint8_t *blockDims[DimensionCount];
+        for (size_t d = 0; d < DimensionCount; ++d)
+            blockDims[d] = dims[d] + begin;
+        groupKeys(blockDims, strides, mask, trash, n, keys);
+        for (size_t i = 0; i < n; ++i)
+        {
+            ++counts[keys[i]];
+            sums[keys[i]] += amounts[i];
+        }
+    }
+}
+
+OrderColumns::Result OrderColumns::query(const Query &query) const
+{
+    Result result;
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    uint8_t paymentAllowed[256];
+    uint8_t statusAllowed[256];
+    std::fill(paymentAllowed, paymentAllowed + 256, query.paymentMethods.empty() ? 1 : 0);
+    std::fill(statusAllowed, statusAllowed + 256, query.orderStatuses.empty() ? 1 : 0);
+    for (auto &value : query.paymentMethods)
+    {
+        auto it = payments_.codes.find(value);
+        if (it != payments_.codes.end())
+            paymentAllowed[it->second] = 1;
+    }
+    for (auto &value : query.orderStatuses)
+    {
+        auto it = statuses_.codes.find(value);
+        if (it != statuses_.codes.end())
+            statusAllowed[it->second] = 1;
+    }
+
+    // 最后一个分组维度步长为 1，结果按 groupBy 的字典序排列
+    uint32_t sizes[DimensionCount] = {kDimensionSizes[Weekday],
+                                      kDimensionSizes[Hour],
+                                      static_cast<uint32_t>(payments_.values.size()),
+                                      static_cast<uint32_t>(statuses_.values.size())};
+    uint32_t strides[DimensionCount] = {0, 0, 0, 0};
+    std::vector<Dimension> groupBy;
+    for (auto dimension : query.groupBy)
+    {
+        if (dimension < DimensionCount && std::find(groupBy.begin(), groupBy.end(), dimension) == groupBy.end())
+            groupBy.push_back(dimension);
+    }
+    uint32_t groups = 1;
+    for (auto it = groupBy.rbegin(); it != groupBy.rend(); ++it)
+    {
+        strides[*it] = groups;
+        groups *= sizes[*it];
+    }
+    auto trash = groups;
+    std::vector<uint64_t> counts(groups + 1, 0);
+    std::vector<int64_t> sums(groups + 1, 0);
+
+    for (auto &[tenantId, columns] : tenants_)
+    {
+        if (query.tenantId != 0 && tenantId != query.tenantId)
+            continue;
+        scan(columns, query, paymentAllowed, statusAllowed, strides, trash, counts, sums, result.scanned);
+    }
+
+    for (uint32_t key = 0; key < groups; ++key)
+    {
+        if (counts[key] == 0)
+            continue;
+        Group group;
+        group.count = counts[key];
+        group.amountCents = sums[key];
+        for (auto dimension : groupBy)
+        {
+            auto code = (key / strides[dimension]) % sizes[dimension];
+            switch (dimension)
+            {
+            case PaymentMethod:
+                group.keys.push_back(payments_.values[code]);
+                break;
+            case OrderStatus:
+                group.keys.push_back(statuses_.values[code]);
+                break;
+            default:
+                group.keys.push_back(std::to_string(code));
+                break;
+            }
+        }
+        result.groups.push_back(std::move(group));
+    }
+    return result;
+}
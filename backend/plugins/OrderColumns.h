@@ -0,0 +1,120 @@
+/**
+ *
+ *  OrderColumns.h
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 按租户分列存放的订单缓存，不依赖 drogon，便于单独压测。
+ *
+ * 金额以分为单位的定点数保存，支付方式和订单状态字典编码为 1 字节，
+ * 时间保存为秒级时间戳并预先拆出本地星期和小时。
+ * 聚合按块执行：先用 SIMD 计算过滤掩码和分组下标，再按下标累加。
+ */
+class OrderColumns
+{
+public:
+  enum Dimension : uint8_t
+  {
+    Weekday,       // 1-7，周一为 1
+    Hour,          // 0-23
+    PaymentMethod, // 支付方式
+    OrderStatus,   // 订单状态
+    DimensionCount
+  };
+  static const char *dimensionName(Dimension dimension);
+  static bool parseDimension(const std::string &name, Dimension &dimension);
+
+  struct OrderRow
+  {
+    uint32_t orderId{0};
+    uint32_t tenantId{0};
+    uint32_t branchId{0};
+    int64_t amountCents{0};
+    int64_t createdAt{0}; // 秒
+    uint8_t weekday{1};
+    uint8_t hour{0};
+    std::string paymentMethod;
+    std::string orderStatus;
+  };
+
+  struct Query
+  {
+    uint32_t tenantId{0}; // 0 表示全部租户
+    uint32_t branchId{0}; // 0 表示不过滤分店
+    int64_t from{std::numeric_limits<int64_t>::min()}; // 秒，含
+    int64_t to{std::numeric_limits<int64_t>::max()};   // 秒，不含
+    std::vector<std::string> paymentMethods;           // 为空表示不过滤
+    std::vector<std::string> orderStatuses;
+    std::vector<Dimension> groupBy;
+  };
+
+  struct Group
+  {
+    std::vector<std::string> keys; // 与 groupBy 一一对应
+    uint64_t count{0};
+    int64_t amountCents{0};
+  };
+
+  struct Result
+  {
+    std::vector<Group> groups;
+    uint64_t scanned{0};
+  };
+
+  /// 新增或覆盖一条订单
+  void upsert(const OrderRow &row);
+  void remove(uint32_t orderId);
+  /// 丢弃早于 before（秒）的订单
+  void trim(int64_t before);
+
+  Result query(const Query &query) const;
+  size_t size() const;
+
+  /// 运行时是否使用 AVX2 内核
+  static bool simdEnabled();
+  /// 压测时强制使用标量内核对比
+  static void setSimdEnabled(bool enabled);
+
+private:
+  struct TenantColumns
+  {
+    std::vector<uint32_t> orderIds;
+    std::vector<int64_t> createdAt;
+    std::vector<int64_t> amounts;
+    std::vector<uint32_t> branches;
+    std::vector<uint8_t> weekdays;
+    std::vector<uint8_t> hours;
+    std::vector<uint8_t> payments;
+    std::vector<uint8_t> statuses;
+    std::vector<uint8_t> alive;
+    std::unordered_map<uint32_t, uint32_t> rowOf; // 订单ID -> 行号
+    bool sorted{true};                            // createdAt 是否递增，递增时按时间二分缩小扫描范围
+  };
+
+  struct Dictionary
+  {
+    std::vector<std::string> values{""}; // 0 为空值
+    std::unordered_map<std::string, uint8_t> codes{{"", 0}};
+    uint8_t encode(const std::string &value);
+  };
+
+  void scan(const TenantColumns &columns, const Query &query, const uint8_t *paymentAllowed,
+            const uint8_t *statusAllowed, const uint32_t *strides, uint32_t trash,
+            std::vector<uint64_t> &counts, std::vector<int64_t> &sums, uint64_t &scanned) const;
+
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<uint32_t, TenantColumns> tenants_;
+  std::unordered_map<uint32_t, uint32_t> orderTenants_;
+  Dictionary payments_;
+  Dictionary statuses_;
+};
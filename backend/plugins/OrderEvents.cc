@@ -0,0 +1,47 @@
+/**
+ *
+ *  OrderEvents.cc
+ *
+ */
+
+#include "OrderEvents.h"
+#include "IngredientDeduction.h"
+#include "KitchenOrders.h"
+#include "OrderAnalytics.h"
+#include "ReportAggregator.h"
+#include "ReportSketches.h"
+#include "TableOccupancy.h"
+#include <drogon/drogon.h>
+
+using namespace drogon;
+using namespace drogon_model::saas_restaurant;
+
+void OrderEvents::created(const OrderTable &order)
+{
+    app().getPlugin<IngredientDeduction>()->deductOrder(order);
+    app().getPlugin<ReportAggregator>()->orderCreated(order);
+    app().getPlugin<OrderAnalytics>()->orderCreated(order);
+    app().getPlugin<ReportSketches>()->orderCreated(order);
+    app().getPlugin<TableOccupancy>()->orderCreated(order);
+    app().getPlugin<KitchenOrders>()->orderCreated(order);
+}
+
+void OrderEvents::updated(const OrderTable &before)
+{
+    auto orderId = before.getValueOfOrderId();
+    app().getPlugin<IngredientDeduction>()->orderChanged(orderId);
+    app().getPlugin<ReportAggregator>()->orderUpdated(before);
+    app().getPlugin<OrderAnalytics>()->refreshOrder(orderId);
+    app().getPlugin<TableOccupancy>()->orderChanged(orderId);
+    app().getPlugin<KitchenOrders>()->orderChanged(orderId);
+}
+
+void OrderEvents::removed(const OrderTable &before)
+{
+    auto orderId = before.getValueOfOrderId();
+    app().getPlugin<IngredientDeduction>()->restoreOrder(orderId);
+    app().getPlugin<ReportAggregator>()->orderRemoved(before);
+    app().getPlugin<OrderAnalytics>()->removeOrder(orderId);
+    app().getPlugin<TableOccupancy>()->orderChanged(orderId);
+    app().getPlugin<KitchenOrders>()->orderChanged(orderId);
+}
@@ -0,0 +1,22 @@
+/**
+ *
+ *  OrderEvents.h
+ *
+ */
+
+#pragma once
+
+#include "OrderTable.h"
+
+/**
+ * @brief 订单增删改成功后通知各个常驻订单数据的插件，订单控制器只调用这里。
+ *
+ * 新增时传入写库的订单（含自增ID），修改、删除时传入修改前的订单，各插件按需回读新值。
+ */
+class OrderEvents
+{
+public:
+  static void created(const drogon_model::saas_restaurant::OrderTable &order);
+  static void updated(const drogon_model::saas_restaurant::OrderTable &before);
+  static void removed(const drogon_model::saas_restaurant::OrderTable &before);
+};
@@ -0,0 +1,112 @@
+/**
+ *
+ *  OrderFlow.cc
+ *
+ */
+
+#include "OrderFlow.h"
+
+namespace
+{
+const char *const kStatusNames[] = {"待确认", "已确认", "制作中", "待派送", "已完成", "已取消"};
+const char *const kPaymentNames[] = {"待支付", "已支付", "已退款"};
+
+constexpr uint32_t bit(OrderFlow::Status status)
+{
+    return 1u << static_cast<uint32_t>(status);
+}
+
+// 每个状态可以去往的状态
+constexpr uint32_t kNext[] = {
+    bit(OrderFlow::Status::Confirmed) | bit(OrderFlow::Status::Cancelled),                                   // 待确认
+    bit(OrderFlow::Status::Cooking) | bit(OrderFlow::Status::Cancelled),                                     // 已确认
+    bit(OrderFlow::Status::Ready) | bit(OrderFlow::Status::Completed) | bit(OrderFlow::Status::Cancelled), // 制作中
+    bit(OrderFlow::Status::Completed) | bit(OrderFlow::Status::Cancelled),                                   // 待派送
+    0,                                                                                                       // 已完成
+    0,                                                                                                       // 已取消
+};
+
+template <typename T, size_t N>
+bool lookup(const char *const (&names)[N], const std::string &name, T &value)
+{
+    for (size_t i = 0; i < N; ++i)
+    {
+        if (name == names[i])
+        {
+            value = static_cast<T>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+template <size_t N>
+std::string joined(const char *const (&names)[N])
+{
+    std::string text;
+    for (size_t i = 0; i < N; ++i)
+        text += (i == 0 ? "" : "、") + std::string(names[i]);
+    return text;
+}
+
+// 按名称校验一次修改，T 为 Status 或 Payment
+template <typename T, size_t N>
+bool check(const char *const (&names)[N],
+           const char *field,
+           const std::string &from,
+           const std::string &to,
+           std::string &error)
+{
+    T target;
+    if (!lookup(names, to, target))
+    {
+        error = std::string(field) + " 须为 " + joined(names) + " 之一";
+        return false;
+    }
+    T current;
+    if (from.empty() || from == to || !lookup(names, from, current) || OrderFlow::canMove(current, target))
+        return true;
+    error = std::string(field) + " 不能从「" + from + "」改为「" + to + "」";
+    return false;
+}
+} // namespace
+
+bool OrderFlow::parse(const std::string &name, Status &status)
+{
+    return lookup(kStatusNames, name, status);
+}
+
+bool OrderFlow::parse(const std::string &name, Payment &payment)
+{
+    return lookup(kPaymentNames, name, payment);
+}
+
+const char *OrderFlow::name(Status status)
+{
+    return kStatusNames[static_cast<size_t>(status)];
+}
+
+const char *OrderFlow::name(Payment payment)
+{
+    return kPaymentNames[static_cast<size_t>(payment)];
+}
+
+bool OrderFlow::canMove(Status from, Status to)
+{
+    return from == to || (kNext[static_cast<size_t>(from)] & bit(to)) != 0;
+}
+
+bool OrderFlow::canMove(Payment from, Payment to)
+{
+    return from == to || static_cast<uint32_t>(to) == static_cast<uint32_t>(from) + 1;
+}
+
+bool OrderFlow::checkStatus(const std::string &from, const std::string &to, std::string &error)
+{
+    return check<Status>(kStatusNames, "order_status", from, to, error);
+}
+
+bool OrderFlow::checkPayment(const std::string &from, const std::string &to, std::string &error)
+{
+    return check<Payment>(kPaymentNames, "payment_status", from, to, error);
+}
@@ -0,0 +1,55 @@
+/**
+ *
+ *  OrderFlow.h
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief 订单状态和支付状态的状态机。
+ *
+ * 订单：待确认 → 已确认 → 制作中 → 待派送 → 已完成，制作中可直接已完成（堂食上桌）；
+ * 未完成的订单都可以取消。已完成、已取消为终态。
+ * 支付：待支付 → 已支付 → 已退款。
+ * 停在原状态总是允许的；原状态为空或不认识（历史数据）时只要求新状态合法。
+ */
+class OrderFlow
+{
+public:
+  enum class Status : uint8_t
+  {
+    Pending,   // 待确认
+    Confirmed, // 已确认
+    Cooking,   // 制作中
+    Ready,     // 待派送
+    Completed, // 已完成
+    Cancelled  // 已取消
+  };
+  enum class Payment : uint8_t
+  {
+    Unpaid,  // 待支付
+    Paid,    // 已支付
+    Refunded // 已退款
+  };
+
+  static bool parse(const std::string &name, Status &status);
+  static bool parse(const std::string &name, Payment &payment);
+  static const char *name(Status status);
+  static const char *name(Payment payment);
+
+  static bool canMove(Status from, Status to);
+  static bool canMove(Payment from, Payment to);
+  /// 未到终态，厨房队列只保留这些订单
+  static bool active(Status status)
+  {
+    return status != Status::Completed && status != Status::Cancelled;
+  }
+
+  /// 校验按名称的状态修改，不允许时 error 为给用户看的说明
+  static bool checkStatus(const std::string &from, const std::string &to, std::string &error);
+  static bool checkPayment(const std::string &from, const std::string &to, std::string &error);
+};
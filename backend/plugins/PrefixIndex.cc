@@ -0,0 +1,272 @@
+/**
+ *
+ *  PrefixIndex.cc
+ *
+ */
+
+#include "PrefixIndex.h"
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+// 增量集合的最小归并阈值
+constexpr size_t kMinRecent = 4096;
+
+bool startsWith(std::string_view text, std::string_view prefix)
+{
+    return text.size() >= prefix.size() && text.compare(0, prefix.size(), prefix) == 0;
+}
+} // namespace
+
+PrefixIndex::PrefixIndex() : prefixes_{{}, std::set<Entry, Less>(Less{this}), 0},
+                             infixes_{{}, std::set<Entry, Less>(Less{this}), 0}
+{
+}
+
+std::string PrefixIndex::normalize(std::string_view text)
+{
+    std::string key;
+    key.reserve(std::min(text.size(), kMaxKey));
+    for (auto c : text)
+    {
+        auto byte = static_cast<unsigned char>(c);
+        if (byte < 0x80 && std::isspace(byte))
+            continue;
+        key.push_back(byte < 0x80 ? static_cast<char>(std::tolower(byte)) : c);
+    }
+    if (key.size() > kMaxKey)
+    {
+        // 截断到 UTF-8 字符边界
+        auto end = kMaxKey;
+        while (end > 0 && (static_cast<unsigned char>(key[end]) & 0xC0) == 0x80)
+            --end;
+        key.resize(end);
+    }
+    return key;
+}
+
+uint64_t PrefixIndex::headOf(std::string_view key)
+{
+    // 不足 8 字节补 0，与按字节比较的顺序一致
+    uint64_t head = 0;
+    for (size_t i = 0; i < 8; ++i)
+        head = head << 8 | (i < key.size() ? static_cast<unsigned char>(key[i]) : 0);
+    return head;
+}
+
+std::string_view PrefixIndex::keyOf(const Entry &entry) const
+{
+    return std::string_view(slots_[entry.slot].keys[entry.field]).substr(entry.offset);
+}
+
+PrefixIndex::Entry PrefixIndex::entryOf(uint32_t slot, uint16_t field, uint16_t offset) const
+{
+    return Entry{headOf(std::string_view(slots_[slot].keys[field]).substr(offset)), slot, field, offset};
+}
+
+template <typename Visit>
+void PrefixIndex::entriesOf(uint32_t slot, Visit &&visit) const
+{
+    const auto &keys = slots_[slot].keys;
+    for (uint16_t field = 0; field < keys.size(); ++field)
+    {
+        const auto &key = keys[field];
+        if (key.empty())
+            continue;
+        visit(true, entryOf(slot, field, 0));
+        for (size_t offset = 1; offset + kMinInfix <= key.size(); ++offset)
+        {
+            if ((static_cast<unsigned char>(key[offset]) & 0xC0) != 0x80)
+                visit(false, entryOf(slot, field, static_cast<uint16_t>(offset)));
+        }
+    }
+}
+
+uint32_t PrefixIndex::allocate(uint32_t memberId, std::vector<std::string> fields)
+{
+    uint32_t slot;
+    if (!free_.empty())
+    {
+        slot = free_.back();
+        free_.pop_back();
+    }
+    else
+    {
+        slot = static_cast<uint32_t>(slots_.size());
+        slots_.emplace_back();
+    }
+    auto &s = slots_[slot];
+    s.memberId = memberId;
+    s.live = true;
+    s.keys.clear();
+    for (const auto &value : fields)
+        s.keys.push_back(normalize(value));
+    s.fields = std::move(fields);
+    members_[memberId] = slot;
+    return slot;
+}
+
+void PrefixIndex::load(std::vector<std::pair<uint32_t, std::vector<std::string>>> &&members)
+{
+    slots_.clear();
+    free_.clear();
+    retired_.clear();
+    members_.clear();
+    for (auto *column : {&prefixes_, &infixes_})
+    {
+        column->sorted.clear();
+        column->recent.clear();
+        column->dead = 0;
+    }
+    slots_.reserve(members.size());
+    members_.reserve(members.size());
+    for (auto &[memberId, fields] : members)
+    {
+        auto it = members_.find(memberId);
+        if (it != members_.end())
+        {
+            // 重复的会员以后一条为准
+            slots_[it->second].live = false;
+            retired_.push_back(it->second);
+        }
+        auto slot = allocate(memberId, std::move(fields));
+        entriesOf(slot, [this](bool prefix, const Entry &entry)
+                  { (prefix ? prefixes_ : infixes_).sorted.push_back(entry); });
+    }
+    Less less{this};
+    for (auto *column : {&prefixes_, &infixes_})
+    {
+        auto &sorted = column->sorted;
+        sorted.erase(std::remove_if(sorted.begin(), sorted.end(),
+                                    [this](const Entry &entry) { return !slots_[entry.slot].live; }),
+                     sorted.end());
+        std::sort(sorted.begin(), sorted.end(), less);
+    }
+    for (auto slot : retired_)
+    {
+        slots_[slot].fields.clear();
+        slots_[slot].keys.clear();
+        free_.push_back(slot);
+    }
+    retired_.clear();
+}
+
+void PrefixIndex::set(uint32_t memberId, const std::vector<std::string> &fields)
+{
+    auto it = members_.find(memberId);
+    if (it != members_.end())
+    {
+        if (slots_[it->second].fields == fields)
+            return;
+        retire(it->second);
+        members_.erase(it);
+    }
+    auto slot = allocate(memberId, fields);
+    entriesOf(slot, [this](bool prefix, const Entry &entry)
+              { (prefix ? prefixes_ : infixes_).recent.insert(entry); });
+    maybeCompact();
+}
+
+void PrefixIndex::remove(uint32_t memberId)
+{
+    auto it = members_.find(memberId);
+    if (it == members_.end())
+        return;
+    retire(it->second);
+    members_.erase(it);
+    maybeCompact();
+}
+
+void PrefixIndex::retire(uint32_t slot)
+{
+    // 增量集合中的条目直接删除，主数组中的只计数，留到归并时清除
+    slots_[slot].live = false;
+    entriesOf(slot, [this](bool prefix, const Entry &entry)
+              {
+        auto &column = prefix ? prefixes_ : infixes_;
+        auto it = column.recent.find(entry);
+        if (it != column.recent.end())
+            column.recent.erase(it);
+        else
+            ++column.dead; });
+    retired_.push_back(slot);
+}
+
+void PrefixIndex::maybeCompact()
+{
+    auto due = [](const Column &column)
+    {
+        auto threshold = std::max(kMinRecent, column.sorted.size() / 8);
+        return column.recent.size() > threshold || column.dead > threshold;
+    };
+    if (!due(prefixes_) && !due(infixes_))
+        return;
+    compact(prefixes_);
+    compact(infixes_);
+    // 两列都已清除失效条目，槽位可以复用
+    for (auto slot : retired_)
+    {
+        slots_[slot].fields.clear();
+        slots_[slot].keys.clear();
+        free_.push_back(slot);
+    }
+    retired_.clear();
+}
+
+void PrefixIndex::compact(Column &column)
+{
+    std::vector<Entry> merged;
+    merged.reserve(column.sorted.size() - std::min(column.dead, column.sorted.size()) + column.recent.size());
+    Less less{this};
+    auto it = column.recent.begin();
+    for (const auto &entry : column.sorted)
+    {
+        if (!slots_[entry.slot].live)
+            continue;
+        for (; it != column.recent.end() && less(*it, entry); ++it)
+            merged.push_back(*it);
+        merged.push_back(entry);
+    }
+    merged.insert(merged.end(), it, column.recent.end());
+    column.sorted.swap(merged);
+    column.recent.clear();
+    column.dead = 0;
+}
+
+void PrefixIndex::collect(const Column &column, std::string_view query, size_t limit, std::vector<uint32_t> &ids) const
+{
+    auto add = [&](const Entry &entry)
+    {
+        const auto &slot = slots_[entry.slot];
+        if (!slot.live || std::find(ids.begin(), ids.end(), slot.memberId) != ids.end())
+            return;
+        ids.push_back(slot.memberId);
+    };
+    Less less{this};
+    for (auto it = std::lower_bound(column.sorted.begin(), column.sorted.end(), query, less);
+         it != column.sorted.end() && ids.size() < limit && startsWith(keyOf(*it), query);
+         ++it)
+        add(*it);
+    for (auto it = column.recent.lower_bound(query);
+         it != column.recent.end() && ids.size() < limit && startsWith(keyOf(*it), query);
+         ++it)
+        add(*it);
+}
+
+void PrefixIndex::search(const std::string &query, size_t limit, std::vector<uint32_t> &ids) const
+{
+    ids.clear();
+    auto key = normalize(query);
+    if (key.empty() || limit == 0)
+        return;
+    collect(prefixes_, key, limit, ids);
+    if (key.size() >= kMinInfix)
+        collect(infixes_, key, limit, ids);
+}
+
+const std::vector<std::string> *PrefixIndex::fieldsOf(uint32_t memberId) const
+{
+    auto it = members_.find(memberId);
+    return it == members_.end() ? nullptr : &slots_[it->second].fields;
+}
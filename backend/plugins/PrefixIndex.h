@@ -0,0 +1,116 @@
+/**
+ *
+ *  PrefixIndex.h
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 单个租户的会员检索索引，按手机号、用户名的前缀和子串查找会员。
+ *
+ * 每个字段规范化（去空白、ASCII 转小写）后，整段作为前缀键，从第二个字符起、不短于 kMinInfix 字节的
+ * 各后缀（按 UTF-8 字符边界）作为子串键，分别放在有序数组里二分查找。
+ * 写入先进有序的增量集合，增量或失效条目积累到主数组的一定比例时归并重建，摊还每次写入 O(log n)。
+ * 查询先返回前缀匹配，再补子串匹配；短于 kMinInfix 字节的查询只做前缀匹配。不加锁，由调用方保证互斥。
+ */
+class PrefixIndex
+{
+public:
+  static constexpr size_t kMinInfix = 3;
+  static constexpr size_t kMaxKey = 64; // 每个字段只索引前 64 字节
+
+  PrefixIndex();
+  PrefixIndex(const PrefixIndex &) = delete;
+  PrefixIndex &operator=(const PrefixIndex &) = delete;
+
+  /// 启动时整体载入，直接排序建好主数组，替换原有内容
+  void load(std::vector<std::pair<uint32_t, std::vector<std::string>>> &&members);
+  /// 写入或替换会员的字段（如手机号、用户名），空字段不索引
+  void set(uint32_t memberId, const std::vector<std::string> &fields);
+  void remove(uint32_t memberId);
+  /// 最多 limit 个匹配的会员ID，前缀匹配在前
+  void search(const std::string &query, size_t limit, std::vector<uint32_t> &ids) const;
+  /// 会员写入时的原始字段，不存在时返回 nullptr
+  const std::vector<std::string> *fieldsOf(uint32_t memberId) const;
+  size_t size() const { return members_.size(); }
+
+  static std::string normalize(std::string_view text);
+
+private:
+  struct Entry
+  {
+    uint64_t head; // 后缀前 8 字节按大端打包，多数比较不用回查字符串
+    uint32_t slot;
+    uint16_t field;
+    uint16_t offset;
+  };
+  struct Slot
+  {
+    uint32_t memberId{0};
+    bool live{false};
+    std::vector<std::string> fields; // 原始值
+    std::vector<std::string> keys;   // 规范化后的键
+  };
+  // 按条目指向的后缀比较，后缀相同时按槽位排，支持直接用查询串 lower_bound
+  struct Less
+  {
+    using is_transparent = void;
+    const PrefixIndex *index;
+    bool operator()(const Entry &a, const Entry &b) const
+    {
+      if (a.head != b.head)
+        return a.head < b.head;
+      auto order = index->keyOf(a).compare(index->keyOf(b));
+      if (order != 0)
+        return order < 0;
+      return std::tie(a.slot, a.field, a.offset) < std::tie(b.slot, b.field, b.offset);
+    }
+    bool operator()(const Entry &a, std::string_view b) const
+    {
+      auto head = headOf(b);
+      return a.head != head ? a.head < head : index->keyOf(a) < b;
+    }
+    bool operator()(std::string_view a, const Entry &b) const
+    {
+      auto head = headOf(a);
+      return head != b.head ? head < b.head : a < index->keyOf(b);
+    }
+  };
+  struct Column
+  {
+    std::vector<Entry> sorted;
+    std::set<Entry, Less> recent;
+    size_t dead{0}; // sorted 中失效的条目数
+  };
+
+  static uint64_t headOf(std::string_view key);
+  std::string_view keyOf(const Entry &entry) const;
+  Entry entryOf(uint32_t slot, uint16_t field, uint16_t offset) const;
+  uint32_t allocate(uint32_t memberId, std::vector<std::string> fields);
+  /// 逐个列出槽位的前缀条目和子串条目
+  template <typename Visit>
+  void entriesOf(uint32_t slot, Visit &&visit) const;
+  void retire(uint32_t slot);
+  /// 增量或失效条目过多时归并两列并回收失效槽位
+  void maybeCompact();
+  void compact(Column &column);
+  void collect(const Column &column, std::string_view query, size_t limit, std::vector<uint32_t> &ids) const;
+
+  std::vector<Slot> slots_;
+  std::vector<uint32_t> free_;    // 可复用的槽位
+  std::vector<uint32_t> retired_; // 已失效、条目尚未清除的槽位
+  std::unordered_map<uint32_t, uint32_t> members_; // 会员 -> 槽位
+  Column prefixes_;
+  Column infixes_;
+};
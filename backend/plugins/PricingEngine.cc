@@ -0,0 +1,271 @@
+/**
+ *
+ *  PricingEngine.cc
+ *
+ */
+
+#include "PricingEngine.h"
+#include "BranchMenus.h"
+#include "MenuSnapshots.h"
+#include <drogon/drogon.h>
+#include <mutex>
+
+using namespace drogon;
+using namespace drogon::orm;
+using namespace drogon_model::saas_restaurant;
+
+namespace
+{
+const std::string kExpired = "已过期";
+} // namespace
+
+void PricingEngine::initAndStart(const Json::Value &config)
+{
+    dbClient_ = app().getDbClient(config.get("db_client", "default").asString());
+    load();
+}
+
+void PricingEngine::shutdown()
+{
+}
+
+void PricingEngine::load()
+{
+    try
+    {
+        for (const auto &level : Mapper<MemberLevel>(dbClient_).findAll())
+            applyLevel(level);
+        for (const auto &campaign : Mapper<MarketingCampaign>(dbClient_).findAll())
+            applyCampaign(campaign);
+
+        // 会员表可能很大，只取计价和校验会员需要的列
+        auto members = dbClient_->execSqlSync(
+            "select member_id, tenant_id, level_id, coalesce(status = ?, 0) as expired from member "
+            "where is_deleted = 0 or is_deleted is null",
+            kExpired);
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        for (const auto &row : members)
+        {
+            auto memberId = row["member_id"].as<uint32_t>();
+            auto tenantId = row["tenant_id"].isNull() ? 0 : row["tenant_id"].as<uint32_t>();
+            bool expired = row["expired"].as<int>() != 0;
+            members_[memberId] = {tenantId, expired};
+            if (!expired && !row["level_id"].isNull())
+                tenants_[tenantId].setMemberLevel(memberId, row["level_id"].as<uint32_t>());
+        }
+        LOG_INFO << "Pricing engine loaded " << tenants_.size() << " tenants, " << members.size() << " members";
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to load pricing rules: " << e.base().what();
+    }
+}
+
+void PricingEngine::removeMember(uint32_t memberId)
+{
+    auto it = members_.find(memberId);
+    if (it == members_.end())
+        return;
+    tenants_[it->second.tenantId].removeMember(memberId);
+    members_.erase(it);
+}
+
+void PricingEngine::removeLevel(uint32_t levelId)
+{
+    auto it = levelTenant_.find(levelId);
+    if (it == levelTenant_.end())
+        return;
+    tenants_[it->second].removeLevel(levelId);
+    levelTenant_.erase(it);
+}
+
+void PricingEngine::removeCampaign(uint32_t campaignId)
+{
+    auto it = campaignTenant_.find(campaignId);
+    if (it == campaignTenant_.end())
+        return;
+    tenants_[it->second].removeCampaign(campaignId);
+    campaignTenant_.erase(it);
+}
+
+void PricingEngine::applyMember(const Member &member)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto memberId = member.getValueOfMemberId();
+    removeMember(memberId);
+    if (member.getValueOfIsDeleted() == 1)
+        return;
+    bool expired = member.getValueOfStatus() == kExpired;
+    members_[memberId] = {member.getValueOfTenantId(), expired};
+    if (!expired && member.getLevelId())
+        tenants_[member.getValueOfTenantId()].setMemberLevel(memberId, member.getValueOfLevelId());
+}
+
+void PricingEngine::applyLevel(const MemberLevel &level)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto levelId = level.getValueOfLevelId();
+    removeLevel(levelId);
+    if (!level.getDiscountRate())
+        return;
+    tenants_[level.getValueOfTenantId()].setLevelRate(levelId, Rate::fromString(level.getValueOfDiscountRate()));
+    levelTenant_[levelId] = level.getValueOfTenantId();
+}
+
+void PricingEngine::applyCampaign(const MarketingCampaign &campaign)
+{
+    PricingRules::Campaign rule;
+    bool active = campaign.getValueOfIsDeleted() != 1 && campaign.getValueOfStatus() == "进行中" &&
+                  PricingRules::compileCampaign(campaign.getValueOfCampaignContent(), rule);
+    if (active)
+    {
+        rule.campaignId = campaign.getValueOfCampaignId();
+        rule.name = campaign.getValueOfCampaignName();
+        rule.levelId = campaign.getValueOfLevelId();
+        rule.start = campaign.getCampaignStart() ? campaign.getValueOfCampaignStart().secondsSinceEpoch() : 0;
+        rule.end = campaign.getCampaignEnd() ? campaign.getValueOfCampaignEnd().secondsSinceEpoch() : 0;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto campaignId = campaign.getValueOfCampaignId();
+    removeCampaign(campaignId);
+    if (!active)
+        return;
+    tenants_[campaign.getValueOfTenantId()].setCampaign(std::move(rule));
+    campaignTenant_[campaignId] = campaign.getValueOfTenantId();
+}
+
+void PricingEngine::memberChanged(uint32_t memberId)
+{
+    Mapper<Member>(dbClient_).findByPrimaryKey(
+        memberId,
+        [this](const Member &member) { applyMember(member); },
+        [this, memberId](const DrogonDbException &e)
+        {
+            if (!dynamic_cast<const UnexpectedRows *>(&e.base()))
+            {
+                LOG_ERROR << "Failed to refresh member " << memberId << " for pricing: " << e.base().what();
+                return;
+            }
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            removeMember(memberId);
+        });
+}
+
+void PricingEngine::memberLevelChanged(uint32_t tenantId, uint32_t memberId, uint32_t levelId)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = members_.find(memberId);
+    bool expired = it != members_.end() && it->second.expired;
+    removeMember(memberId);
+    members_[memberId] = {tenantId, expired};
+    if (!expired)
+        tenants_[tenantId].setMemberLevel(memberId, levelId);
+}
+
+void PricingEngine::levelChanged(uint32_t levelId)
+{
+    Mapper<MemberLevel>(dbClient_).findByPrimaryKey(
+        levelId,
+        [this](const MemberLevel &level) { applyLevel(level); },
+        [this, levelId](const DrogonDbException &e)
+        {
+            if (!dynamic_cast<const UnexpectedRows *>(&e.base()))
+            {
+                LOG_ERROR << "Failed to refresh member level " << levelId << " for pricing: " << e.base().what();
+                return;
+            }
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            removeLevel(levelId);
+        });
+}
+
+void PricingEngine::campaignChanged(uint32_t campaignId)
+{
+    Mapper<MarketingCampaign>(dbClient_).findByPrimaryKey(
+        campaignId,
+        [this](const MarketingCampaign &campaign) { applyCampaign(campaign); },
+        [this, campaignId](const DrogonDbException &e)
+        {
+            if (!dynamic_cast<const UnexpectedRows *>(&e.base()))
+            {
+                LOG_ERROR << "Failed to refresh campaign " << campaignId << " for pricing: " << e.base().what();
+                return;
+            }
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            removeCampaign(campaignId);
+        });
+}
+
+uint32_t PricingEngine::levelOf(uint32_t tenantId, uint32_t memberId) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = tenants_.find(tenantId);
+    return it == tenants_.end() ? 0 : it->second.levelOf(memberId);
+}
+
+bool PricingEngine::hasMember(uint32_t tenantId, uint32_t memberId) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = members_.find(memberId);
+    return it != members_.end() && it->second.tenantId == tenantId;
+}
+
+bool PricingEngine::campaignActive(uint32_t tenantId, uint32_t campaignId) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = tenants_.find(tenantId);
+    return it != tenants_.end() && it->second.campaignActive(campaignId, trantor::Date::now().secondsSinceEpoch());
+}
+
+bool PricingEngine::quote(uint32_t tenantId,
+                          uint32_t branchId,
+                          uint32_t memberId,
+                          const std::vector<PricingRules::Line> &lines,
+                          PricingRules::Quote &quote,
+                          uint32_t voucherCampaignId) const
+{
+    auto now = trantor::Date::now().secondsSinceEpoch();
+    // 菜品取自菜单快照，叠加分店覆盖后下架、售罄的菜品报不可售
+    std::shared_ptr<const BranchOverlay> overlay;
+    if (branchId != 0)
+    {
+        overlay = app().getPlugin<BranchMenus>()->overlayOf(branchId);
+        if (!overlay || overlay->tenantId() != tenantId)
+            return PricingRules().quote(memberId, lines, now, quote, voucherCampaignId);
+    }
+    const MenuSnapshot *menu = nullptr;
+    auto findDish = [&menu, &overlay](uint32_t dishId, PricingRules::Dish &dish)
+    {
+        auto found = menu ? menu->findDish(dishId) : nullptr;
+        if (!found)
+            return false;
+        dish.name = found->name;
+        dish.price = found->price;
+        const auto *status = &found->status;
+        if (overlay)
+        {
+            auto effective = overlay->resolve(*found);
+            dish.price = effective.price;
+            status = effective.status;
+        }
+        dish.onSale = *status != "下架" && *status != "售罄";
+        return true;
+    };
+    auto priced = [&]()
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = tenants_.find(tenantId);
+        static const PricingRules empty;
+        return (it == tenants_.end() ? empty : it->second).quote(memberId, lines, now, findDish, quote, voucherCampaignId);
+    };
+    bool ok = false;
+    if (!app().getPlugin<MenuSnapshots>()->readMenu(tenantId,
+                                                    [&](const MenuSnapshot &snapshot)
+                                                    {
+                                                        menu = &snapshot;
+                                                        ok = priced();
+                                                    }))
+        ok = priced();
+    return ok;
+}
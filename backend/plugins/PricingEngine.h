@@ -0,0 +1,84 @@
+/**
+ *
+ *  PricingEngine.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/orm/DbClient.h>
+#include <cstdint>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "MarketingCampaign.h"
+#include "Member.h"
+#include "MemberLevel.h"
+#include "PricingRules.h"
+
+/**
+ * @brief 服务端订单计价，按租户常驻会员等级折扣、会员所属等级和进行中的营销活动。
+ *
+ * 菜品价格和销售状态不另存一份，计价时从 MenuSnapshots 的租户快照中读取，与菜单展示同源；
+ * 指定分店时再叠加 BranchMenus 中该分店的售价和销售状态覆盖。
+ * 启动时加载其余规则，之后由各实体的增删改回调按主键重新读取单行并就地更新，计价本身不访问数据库。
+ * 已过期的会员仍记录所属租户，但不享受等级折扣。
+ */
+class PricingEngine : public drogon::Plugin<PricingEngine>
+{
+public:
+  PricingEngine() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  void memberChanged(uint32_t memberId);
+  /// 等级评估已知新等级时直接更新，不再回读
+  void memberLevelChanged(uint32_t tenantId, uint32_t memberId, uint32_t levelId);
+  void levelChanged(uint32_t levelId);
+  void campaignChanged(uint32_t campaignId);
+
+  /// 会员所属等级，非本租户会员或已过期为 0
+  uint32_t levelOf(uint32_t tenantId, uint32_t memberId) const;
+  /// 是否本租户未删除的会员（含已过期）
+  bool hasMember(uint32_t tenantId, uint32_t memberId) const;
+  /// 活动未删除、进行中、有计价规则且当前在起止时间内
+  bool campaignActive(uint32_t tenantId, uint32_t campaignId) const;
+
+  /// 租户没有菜单、或 branchId 不为 0 但不是本租户的分店时，所有菜品都不可售；
+  /// voucherCampaignId 为订单出示的券所属活动
+  bool quote(uint32_t tenantId,
+             uint32_t branchId,
+             uint32_t memberId,
+             const std::vector<PricingRules::Line> &lines,
+             PricingRules::Quote &quote,
+             uint32_t voucherCampaignId = 0) const;
+
+private:
+  void load();
+  void applyMember(const drogon_model::saas_restaurant::Member &member);
+  void applyLevel(const drogon_model::saas_restaurant::MemberLevel &level);
+  void applyCampaign(const drogon_model::saas_restaurant::MarketingCampaign &campaign);
+  // 以下 remove 须持有 mutex_，按实体所属租户移除，租户变更时不会残留旧数据
+  void removeMember(uint32_t memberId);
+  void removeLevel(uint32_t levelId);
+  void removeCampaign(uint32_t campaignId);
+
+  drogon::orm::DbClientPtr dbClient_;
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<uint32_t, PricingRules> tenants_;
+  struct MemberEntry
+  {
+    uint32_t tenantId;
+    bool expired;
+  };
+  std::unordered_map<uint32_t, MemberEntry> members_;
+  std::unordered_map<uint32_t, uint32_t> levelTenant_;
+  std::unordered_map<uint32_t, uint32_t> campaignTenant_;
+};
@@ -0,0 +1,308 @@
+/**
+ *
+ *  PricingRules.cc
+ *
+ */
+
+#include "PricingRules.h"
+#include <algorithm>
+#include <map>
+#include <memory>
+
+bool PricingRules::compileCampaign(const std::string &content, Campaign &campaign)
+{
+    Json::Value rule;
+    std::string errs;
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    if (content.empty() || !reader->parse(content.data(), content.data() + content.size(), &rule, &errs) ||
+        !rule.isObject())
+        return false;
+
+    auto type = rule["type"].asString();
+    if (type == "discount")
+    {
+        if (!Rate::isValidJson(rule["rate"]))
+            return false;
+        campaign.kind = Campaign::Discount;
+        campaign.rate = Rate::fromJson(rule["rate"]);
+        if (campaign.rate <= Rate() || campaign.rate > Rate::fromInteger(1))
+            return false;
+        campaign.dishIds.clear();
+        for (const auto &dishId : rule["dish_ids"])
+        {
+            if (dishId.isUInt())
+                campaign.dishIds.push_back(dishId.asUInt());
+        }
+        std::sort(campaign.dishIds.begin(), campaign.dishIds.end());
+        campaign.voucher = rule["voucher"].asBool();
+        return true;
+    }
+    if (type == "full_reduction")
+    {
+        if (!Money::isValidJson(rule["threshold"]) || !Money::isValidJson(rule["reduction"]))
+            return false;
+        campaign.kind = Campaign::FullReduction;
+        campaign.threshold = Money::fromJson(rule["threshold"]);
+        campaign.reduction = Money::fromJson(rule["reduction"]);
+        campaign.voucher = rule["voucher"].asBool();
+        return campaign.reduction > Money();
+    }
+    return false;
+}
+
+bool PricingRules::linesFromJson(const Json::Value &items, std::vector<Line> &lines)
+{
+    if (!items.isArray() || items.empty())
+        return false;
+    lines.clear();
+    lines.reserve(items.size());
+    for (const auto &item : items)
+    {
+        if (!item.isObject() || !item["dish_id"].isUInt() || !item["quantity"].isInt64() ||
+            item["quantity"].asInt64() <= 0 || item["quantity"].asInt64() > kMaxQuantity)
+            return false;
+        lines.push_back({item["dish_id"].asUInt(), item["quantity"].asInt64()});
+    }
+    return true;
+}
+
+void PricingRules::setDish(uint32_t dishId, Dish dish)
+{
+    dishes_[dishId] = std::move(dish);
+}
+
+bool PricingRules::removeDish(uint32_t dishId)
+{
+    return dishes_.erase(dishId) > 0;
+}
+
+void PricingRules::setLevelRate(uint32_t levelId, const Rate &rate)
+{
+    levelRates_[levelId] = rate;
+}
+
+bool PricingRules::removeLevel(uint32_t levelId)
+{
+    return levelRates_.erase(levelId) > 0;
+}
+
+void PricingRules::setMemberLevel(uint32_t memberId, uint32_t levelId)
+{
+    memberLevels_[memberId] = levelId;
+}
+
+bool PricingRules::removeMember(uint32_t memberId)
+{
+    return memberLevels_.erase(memberId) > 0;
+}
+
+void PricingRules::setCampaign(Campaign campaign)
+{
+    auto campaignId = campaign.campaignId;
+    schedule_.set(campaign.window());
+    if (!schedule_.find(campaignId))
+    {
+        campaigns_.erase(campaignId);
+        return;
+    }
+    campaigns_[campaignId] = std::move(campaign);
+}
+
+bool PricingRules::removeCampaign(uint32_t campaignId)
+{
+    schedule_.remove(campaignId);
+    return campaigns_.erase(campaignId) > 0;
+}
+
+bool PricingRules::campaignActive(uint32_t campaignId, int64_t at) const
+{
+    auto *entry = schedule_.find(campaignId);
+    return entry && entry->start <= at && at < entry->end;
+}
+
+bool PricingRules::quote(uint32_t memberId,
+                         const std::vector<Line> &lines,
+                         int64_t at,
+                         Quote &quote,
+                         uint32_t voucherCampaignId) const
+{
+    return this->quote(
+        memberId,
+        lines,
+        at,
+        [this](uint32_t dishId, Dish &dish)
+        {
+            auto it = dishes_.find(dishId);
+            if (it == dishes_.end())
+                return false;
+            dish = it->second;
+            return true;
+        },
+        quote,
+        voucherCampaignId);
+}
+
+bool PricingRules::quote(uint32_t memberId,
+                         const std::vector<Line> &lines,
+                         int64_t at,
+                         const DishLookup &findDish,
+                         Quote &quote,
+                         uint32_t voucherCampaignId) const
+{
+    quote = Quote();
+    auto member = memberId == 0 ? memberLevels_.end() : memberLevels_.find(memberId);
+    if (member != memberLevels_.end())
+    {
+        quote.levelId = member->second;
+        auto rate = levelRates_.find(member->second);
+        if (rate != levelRates_.end() && rate->second > Rate() && rate->second < Rate::fromInteger(1))
+            quote.memberRate = rate->second;
+    }
+    bool memberDiscount = quote.memberRate > Rate();
+    // 当时对该等级有效的活动，按开始时间排序；券活动只在出示了该活动的券时加入
+    std::vector<const Campaign *> discounts;
+    std::vector<const Campaign *> reductions;
+    auto use = [&](const Campaign &campaign)
+    { (campaign.kind == Campaign::Discount ? discounts : reductions).push_back(&campaign); };
+    for (const auto *entry : schedule_.activeAt(at, quote.levelId))
+    {
+        const auto &campaign = campaigns_.at(entry->campaignId);
+        if (!campaign.voucher)
+            use(campaign);
+    }
+    if (voucherCampaignId != 0 && campaignActive(voucherCampaignId, at) && campaigns_.at(voucherCampaignId).voucher)
+    {
+        quote.voucherCampaignId = voucherCampaignId;
+        use(campaigns_.at(voucherCampaignId));
+    }
+
+    // 同一菜品的多行合并
+    std::map<uint32_t, int64_t> quantities;
+    for (const auto &line : lines)
+    {
+        if (line.quantity > 0)
+            quantities[line.dishId] += line.quantity;
+    }
+
+    std::map<uint32_t, Money> campaignAmounts;
+    Dish dish;
+    for (const auto &[dishId, quantity] : quantities)
+    {
+        if (!findDish(dishId, dish) || !dish.onSale)
+        {
+            quote.unavailable.push_back(dishId);
+            continue;
+        }
+        QuotedLine quoted;
+        quoted.dishId = dishId;
+        quoted.name = dish.name;
+        quoted.quantity = quantity;
+        quoted.unitPrice = dish.price;
+        quoted.subtotal = dish.price * quantity;
+
+        const Campaign *best = nullptr;
+        for (const auto *campaign : discounts)
+        {
+            if (!campaign->dishIds.empty() &&
+                !std::binary_search(campaign->dishIds.begin(), campaign->dishIds.end(), dishId))
+                continue;
+            if (!best || campaign->rate < best->rate)
+                best = campaign;
+        }
+        auto amount = quoted.subtotal;
+        if (best)
+        {
+            auto discounted = amount * best->rate;
+            quoted.campaignId = best->campaignId;
+            campaignAmounts[best->campaignId] += amount - discounted;
+            quote.campaignDiscount += amount - discounted;
+            amount = discounted;
+        }
+        if (memberDiscount)
+        {
+            auto discounted = amount * quote.memberRate;
+            quote.memberDiscount += amount - discounted;
+            amount = discounted;
+        }
+        quoted.total = amount;
+        quoted.discount = quoted.subtotal - amount;
+        quote.subtotal += quoted.subtotal;
+        quote.total += amount;
+        quote.lines.push_back(std::move(quoted));
+    }
+    if (!quote.unavailable.empty())
+        return false;
+
+    // 满减按折后金额判断门槛，取减免最多的一档，减免相同时取门槛低的
+    const Campaign *bestReduction = nullptr;
+    for (const auto *campaign : reductions)
+    {
+        if (campaign->threshold > quote.total)
+            continue;
+        if (!bestReduction || campaign->reduction > bestReduction->reduction ||
+            (campaign->reduction == bestReduction->reduction && campaign->threshold < bestReduction->threshold))
+            bestReduction = campaign;
+    }
+    if (bestReduction)
+    {
+        quote.reduction = std::min(bestReduction->reduction, quote.total);
+        quote.total -= quote.reduction;
+    }
+
+    quote.discount = quote.subtotal - quote.total;
+    for (const auto *campaign : discounts)
+    {
+        auto it = campaignAmounts.find(campaign->campaignId);
+        if (it != campaignAmounts.end())
+            quote.applied.push_back({campaign->campaignId, campaign->name, it->second});
+    }
+    if (quote.memberDiscount > Money())
+        quote.applied.push_back({0, "会员折扣", quote.memberDiscount});
+    if (bestReduction)
+        quote.applied.push_back({bestReduction->campaignId, bestReduction->name, quote.reduction});
+    return true;
+}
+
+Json::Value PricingRules::toJson(const Quote &quote)
+{
+    Json::Value json;
+    json["lines"] = Json::arrayValue;
+    for (const auto &line : quote.lines)
+    {
+        Json::Value item;
+        item["dish_id"] = line.dishId;
+        item["dish_name"] = line.name;
+        item["quantity"] = static_cast<Json::Int64>(line.quantity);
+        item["price"] = line.unitPrice.toJson();
+        item["subtotal"] = line.subtotal.toJson();
+        item["discount"] = line.discount.toJson();
+        item["total"] = line.total.toJson();
+        if (line.campaignId != 0)
+            item["campaign_id"] = line.campaignId;
+        json["lines"].append(item);
+    }
+    json["applied"] = Json::arrayValue;
+    for (const auto &applied : quote.applied)
+    {
+        Json::Value item;
+        item["campaign_id"] = applied.campaignId;
+        item["name"] = applied.name;
+        item["amount"] = applied.amount.toJson();
+        json["applied"].append(item);
+    }
+    json["unavailable"] = Json::arrayValue;
+    for (auto dishId : quote.unavailable)
+        json["unavailable"].append(dishId);
+    json["subtotal"] = quote.subtotal.toJson();
+    json["campaign_discount"] = quote.campaignDiscount.toJson();
+    json["member_discount"] = quote.memberDiscount.toJson();
+    json["reduction"] = quote.reduction.toJson();
+    json["discount"] = quote.discount.toJson();
+    json["total"] = quote.total.toJson();
+    json["level_id"] = quote.levelId;
+    if (quote.voucherCampaignId != 0)
+        json["voucher_campaign_id"] = quote.voucherCampaignId;
+    json["member_rate"] = quote.memberRate > Rate() ? quote.memberRate.toJson() : Json::Value("1.0000");
+    return json;
+}
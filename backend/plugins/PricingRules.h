@@ -0,0 +1,152 @@
+/**
+ *
+ *  PricingRules.h
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "CampaignSchedule.h"
+#include "Money.h"
+
+/**
+ * @brief 单个租户的计价规则：菜品价格、会员等级折扣和预编译的营销活动。
+ *
+ * 计价顺序：菜品小计 -> 单品折扣活动（每行取最低折扣率）-> 会员等级折扣 -> 满减（取减免最多的一档）。
+ * 每步按行四舍五入到分，所有金额都是整数运算。不依赖 drogon，便于单独压测。
+ * 活动的起止时间放在 CampaignSchedule 里，计价时只看当时对该等级有效的活动。
+ *
+ * 营销活动的 campaign_content 为 JSON 时才参与计价，否则只作说明文字：
+ *   {"type": "discount", "rate": 0.8, "dish_ids": [1, 2]}  指定菜品 8 折，dish_ids 省略时全部菜品
+ *   {"type": "full_reduction", "threshold": 100, "reduction": 20}  满 100 减 20
+ * 加上 "voucher": true 的活动是券活动，只对出示该活动券的订单生效，不限会员等级。
+ */
+class PricingRules
+{
+public:
+  struct Dish
+  {
+    Money price;
+    std::string name;
+    bool onSale{true};
+  };
+
+  struct Campaign
+  {
+    enum Kind : uint8_t
+    {
+      Discount,
+      FullReduction
+    };
+    uint32_t campaignId{0};
+    std::string name;
+    uint32_t levelId{0}; // 0 表示所有顾客
+    int64_t start{0};    // 秒，0 表示不限
+    int64_t end{0};
+    Kind kind{Discount};
+    Rate rate;
+    Money threshold;
+    Money reduction;
+    std::vector<uint32_t> dishIds; // 升序，为空表示全部菜品
+    bool voucher{false};           // 凭券使用
+
+    /// 时间表中的条目，end 为 0 时不限结束时间
+    CampaignSchedule::Campaign window() const
+    {
+      return {campaignId, levelId, start, end == 0 ? CampaignSchedule::kOpenEnd : end, name};
+    }
+  };
+  /// 解析 campaign_content，不是可识别的规则时返回 false
+  static bool compileCampaign(const std::string &content, Campaign &campaign);
+
+  void setDish(uint32_t dishId, Dish dish);
+  bool removeDish(uint32_t dishId);
+  void setLevelRate(uint32_t levelId, const Rate &rate);
+  bool removeLevel(uint32_t levelId);
+  void setMemberLevel(uint32_t memberId, uint32_t levelId);
+  bool removeMember(uint32_t memberId);
+  void setCampaign(Campaign campaign);
+  bool removeCampaign(uint32_t campaignId);
+  /// 活动存在且 at 时刻在起止时间内，不看会员等级
+  bool campaignActive(uint32_t campaignId, int64_t at) const;
+
+  struct Line
+  {
+    uint32_t dishId{0};
+    int64_t quantity{0};
+  };
+  static constexpr int64_t kMaxQuantity = 100000; // 单行数量上限，避免金额溢出
+  /// 解析 [{"dish_id": 1, "quantity": 2}, ...]，数量须为 1 到 kMaxQuantity 的整数
+  static bool linesFromJson(const Json::Value &items, std::vector<Line> &lines);
+  struct QuotedLine
+  {
+    uint32_t dishId{0};
+    std::string name;
+    int64_t quantity{0};
+    Money unitPrice;
+    Money subtotal;
+    Money discount; // 单品活动和会员折扣
+    Money total;
+    uint32_t campaignId{0};
+  };
+  struct Applied
+  {
+    uint32_t campaignId{0}; // 0 为会员等级折扣
+    std::string name;
+    Money amount;
+  };
+  struct Quote
+  {
+    std::vector<QuotedLine> lines;
+    Money subtotal;
+    Money campaignDiscount;
+    Money memberDiscount;
+    Money reduction;
+    Money discount; // 优惠合计
+    Money total;
+    uint32_t levelId{0};
+    Rate memberRate;
+    uint32_t voucherCampaignId{0}; // 生效的券活动，0 为没有
+    std::vector<Applied> applied;
+    std::vector<uint32_t> unavailable; // 不存在或已下架的菜品
+  };
+  /// memberId 为 0 或不是本租户会员时按非会员计价；有不可售菜品时返回 false。
+  /// voucherCampaignId 为订单出示的券所属活动，在起止时间内时参与计价
+  bool quote(uint32_t memberId,
+             const std::vector<Line> &lines,
+             int64_t at,
+             Quote &quote,
+             uint32_t voucherCampaignId = 0) const;
+  /// 按菜品ID取价格和销售状态，菜品不存在时返回 false
+  using DishLookup = std::function<bool(uint32_t dishId, Dish &dish)>;
+  /// 菜品由调用方提供（如菜单快照），不使用 setDish 设置的菜品
+  bool quote(uint32_t memberId,
+             const std::vector<Line> &lines,
+             int64_t at,
+             const DishLookup &findDish,
+             Quote &quote,
+             uint32_t voucherCampaignId = 0) const;
+  /// 金额输出为字符串，与模型的 DECIMAL 字段一致
+  static Json::Value toJson(const Quote &quote);
+
+  /// 会员所属等级，非会员为 0
+  uint32_t levelOf(uint32_t memberId) const
+  {
+    auto it = memberLevels_.find(memberId);
+    return it == memberLevels_.end() ? 0 : it->second;
+  }
+  size_t dishCount() const { return dishes_.size(); }
+
+private:
+  std::unordered_map<uint32_t, Dish> dishes_;
+  std::unordered_map<uint32_t, Rate> levelRates_;
+  std::unordered_map<uint32_t, uint32_t> memberLevels_;
+  std::unordered_map<uint32_t, Campaign> campaigns_;
+  CampaignSchedule schedule_;
+};
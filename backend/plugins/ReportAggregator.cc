@@ -0,0 +1,486 @@
+/**
+ *
+ *  ReportAggregator.cc
+ *
+ */
+
+#include "ReportAggregator.h"
+#include "OrderFlow.h"
+#include <drogon/drogon.h>
+#include <set>
+#include <tuple>
+#include <vector>
+
+using namespace drogon;
+using namespace drogon::orm;
+using namespace drogon_model::saas_restaurant;
+
+namespace
+{
+// 明细里的数字可能是字符串
+double numberOf(const Json::Value &value, double defaultValue = 0)
+{
+    try
+    {
+        if (value.isString())
+            return value.asString().empty() ? defaultValue : std::stod(value.asString());
+        if (value.isNumeric())
+            return value.asDouble();
+    }
+    catch (const std::exception &)
+    {
+    }
+    return defaultValue;
+}
+
+// 明细里的金额可能是数字或字符串
+Money moneyOf(const Json::Value &value)
+{
+    return Money::isValidJson(value) ? Money::fromJson(value) : Money();
+}
+
+// 已取消、已退款的订单不是营收
+bool isRevenue(const OrderTable &order)
+{
+    OrderFlow::Status status;
+    if (OrderFlow::parse(order.getValueOfOrderStatus(), status) && status == OrderFlow::Status::Cancelled)
+        return false;
+    OrderFlow::Payment payment;
+    return !(OrderFlow::parse(order.getValueOfPaymentStatus(), payment) && payment == OrderFlow::Payment::Refunded);
+}
+} // namespace
+
+void ReportAggregator::initAndStart(const Json::Value &config)
+{
+    dbClient_ = app().getDbClient(config.get("db_client", "default").asString());
+    try
+    {
+        auto rows = dbClient_->execSqlSync("select dish_id, dish_category_id from dish");
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &row : rows)
+        {
+            dishCategories_[row["dish_id"].as<uint32_t>()] =
+                row["dish_category_id"].isNull() ? 0 : row["dish_category_id"].as<uint32_t>();
+        }
+        LOG_INFO << "Report aggregator loaded categories of " << dishCategories_.size() << " dishes";
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to load dish categories for reports: " << e.base().what();
+    }
+
+    // 首次部署时回填；统计口径修改后设 rebuild_on_start 重启一次
+    bool rebuildOnStart = config.get("rebuild_on_start", false).asBool();
+    try
+    {
+        if (!rebuildOnStart)
+            rebuildOnStart = dbClient_->execSqlSync("select 1 from report_rollup limit 1").empty() &&
+                             !dbClient_->execSqlSync("select 1 from order_table limit 1").empty();
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to check report rollups: " << e.base().what();
+        rebuildOnStart = false;
+    }
+    if (rebuildOnStart)
+        rebuild();
+}
+
+void ReportAggregator::shutdown()
+{
+}
+
+void ReportAggregator::dishChanged(uint32_t dishId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    dishCategories_.erase(dishId);
+}
+
+trantor::Date ReportAggregator::bucketOf(const trantor::Date &at, bool hourly)
+{
+    auto day = at.roundDay();
+    if (!hourly)
+        return day;
+    auto hours = (at.microSecondsSinceEpoch() - day.microSecondsSinceEpoch()) / (3600LL * 1000000);
+    return day.after(3600.0 * hours);
+}
+
+bool ReportAggregator::Contribution::sameAs(const Contribution &other) const
+{
+    return tenantId == other.tenantId && branchId == other.branchId &&
+           at.microSecondsSinceEpoch() == other.at.microSecondsSinceEpoch() &&
+           revenue == other.revenue && memberId == other.memberId && guests == other.guests &&
+           dishes == other.dishes;
+}
+
+std::optional<ReportAggregator::Contribution> ReportAggregator::contributionOf(const OrderTable &order)
+{
+    if (order.getValueOfIsDeleted() || order.getValueOfTenantId() == 0 || !isRevenue(order))
+        return std::nullopt;
+    Contribution contribution;
+    contribution.tenantId = order.getValueOfTenantId();
+    contribution.branchId = order.getValueOfBranchId();
+    contribution.at = order.getCreatedAt() ? order.getValueOfCreatedAt() : trantor::Date::now();
+    contribution.revenue = Money::fromString(order.getValueOfTotalAmount());
+
+    Json::Value detail;
+    std::string errs;
+    const auto &text = order.getValueOfOrderDetail();
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    if (!text.empty() && reader->parse(text.data(), text.data() + text.size(), &detail, &errs) && detail.isObject())
+    {
+        contribution.memberId = static_cast<uint32_t>(numberOf(detail["member_id"]));
+        for (const auto &line : detail["items"])
+        {
+            auto dishId = static_cast<uint32_t>(numberOf(line["dish_id"]));
+            if (dishId == 0)
+                continue;
+            auto quantity = static_cast<int64_t>(numberOf(line["quantity"], 1));
+            auto &dish = contribution.dishes[dishId];
+            dish.first += quantity;
+            dish.second += line.isMember("subtotal") ? moneyOf(line["subtotal"]) : moneyOf(line["price"]) * quantity;
+        }
+        if (contribution.memberId == 0)
+            contribution.guests = static_cast<int64_t>(numberOf(detail["customer_count"], 1));
+    }
+    else if (contribution.memberId == 0)
+    {
+        contribution.guests = 1;
+    }
+    return contribution;
+}
+
+void ReportAggregator::orderCreated(const OrderTable &order)
+{
+    auto contribution = contributionOf(order);
+    if (contribution)
+        apply(std::make_shared<Contribution>(std::move(*contribution)), 1);
+}
+
+void ReportAggregator::orderUpdated(const OrderTable &before)
+{
+    auto previous = contributionOf(before);
+    Mapper<OrderTable> mapper(dbClient_);
+    mapper.findByPrimaryKey(
+        before.getValueOfOrderId(),
+        [this, previous](const OrderTable &after)
+        {
+            auto current = contributionOf(after);
+            // 只改状态等无关字段时不写库
+            if (previous && current && previous->sameAs(*current))
+                return;
+            if (previous)
+                apply(std::make_shared<Contribution>(*previous), -1);
+            if (current)
+                apply(std::make_shared<Contribution>(std::move(*current)), 1);
+        },
+        [this, previous](const DrogonDbException &e)
+        {
+            if (dynamic_cast<const UnexpectedRows *>(&e.base()))
+            {
+                if (previous)
+                    apply(std::make_shared<Contribution>(*previous), -1);
+                return;
+            }
+            LOG_ERROR << "Failed to reload order for reports: " << e.base().what();
+        });
+}
+
+void ReportAggregator::orderRemoved(const OrderTable &before)
+{
+    auto contribution = contributionOf(before);
+    if (contribution)
+        apply(std::make_shared<Contribution>(std::move(*contribution)), -1);
+}
+
+void ReportAggregator::rebuild()
+{
+    // 此时还不接收请求，不会与增量更新交错；按时间桶在内存中累加，再整体写回
+    using Bucket = std::tuple<uint32_t, uint32_t, std::string, std::string>; // 租户、分店、粒度、桶起点
+    struct Totals
+    {
+        Money revenue;
+        int64_t orders{0};
+        int64_t customers{0};
+    };
+    std::map<Bucket, Totals> rollups;
+    std::map<std::pair<Bucket, uint32_t>, std::pair<int64_t, Money>> categories; // (桶, 分类ID) -> (份数, 金额)
+    std::set<std::pair<Bucket, uint32_t>> customers;                             // (桶, 会员ID)
+    size_t counted = 0;
+    try
+    {
+        uint32_t lastId = 0;
+        Mapper<OrderTable> mapper(dbClient_);
+        for (;;)
+        {
+            auto orders = mapper.orderBy(OrderTable::Cols::_order_id)
+                              .limit(1000)
+                              .findBy(Criteria(OrderTable::Cols::_order_id, CompareOperator::GT, lastId));
+            if (orders.empty())
+                break;
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto &order : orders)
+            {
+                lastId = order.getValueOfOrderId();
+                auto contribution = contributionOf(order);
+                if (!contribution)
+                    continue;
+                ++counted;
+                std::vector<uint32_t> scopes{0};
+                if (contribution->branchId != 0)
+                    scopes.push_back(contribution->branchId);
+                for (auto branchId : scopes)
+                {
+                    for (auto hourly : {true, false})
+                    {
+                        Bucket bucket{contribution->tenantId,
+                                      branchId,
+                                      hourly ? "hour" : "day",
+                                      bucketOf(contribution->at, hourly).toDbStringLocal()};
+                        auto &totals = rollups[bucket];
+                        totals.revenue += contribution->revenue;
+                        ++totals.orders;
+                        if (contribution->memberId == 0)
+                            totals.customers += contribution->guests;
+                        else if (customers.emplace(bucket, contribution->memberId).second)
+                            ++totals.customers;
+                        for (auto &[dishId, sales] : contribution->dishes)
+                        {
+                            auto it = dishCategories_.find(dishId);
+                            auto &category = categories[{bucket, it == dishCategories_.end() ? 0 : it->second}];
+                            category.first += sales.first;
+                            category.second += sales.second;
+                        }
+                    }
+                }
+            }
+        }
+
+        auto transaction = dbClient_->newTransaction();
+        transaction->execSqlSync("delete from report_customer");
+        transaction->execSqlSync("delete from report_category_rollup");
+        transaction->execSqlSync("delete from report_rollup");
+        // 分批多行 insert，每批 500 行
+        auto insertRows = [&transaction](const std::string &head, const std::string &row, size_t total, const auto &bind)
+        {
+            for (size_t begin = 0; begin < total; begin += 500)
+            {
+                auto end = std::min(total, begin + 500);
+                std::string sql = head;
+                for (size_t i = begin; i < end; ++i)
+                    sql += i == begin ? row : ", " + row;
+                auto binder = *transaction << std::move(sql);
+                bind(binder, begin, end);
+                binder << Mode::Blocking;
+                binder >> [](const Result &) {};
+                binder.exec();
+            }
+        };
+        std::vector<std::pair<Bucket, Totals>> rollupRows(rollups.begin(), rollups.end());
+        insertRows("insert into report_rollup "
+                   "(tenant_id, branch_id, granularity, bucket_start, revenue, order_count, customer_count) values ",
+                   "(?, ?, ?, ?, ?, ?, ?)",
+                   rollupRows.size(),
+                   [&rollupRows](auto &binder, size_t begin, size_t end)
+                   {
+                       for (size_t i = begin; i < end; ++i)
+                       {
+                           auto &[bucket, totals] = rollupRows[i];
+                           binder << std::get<0>(bucket) << std::get<1>(bucket) << std::get<2>(bucket)
+                                  << std::get<3>(bucket) << totals.revenue.toString() << totals.orders
+                                  << totals.customers;
+                       }
+                   });
+        std::vector<std::pair<std::pair<Bucket, uint32_t>, std::pair<int64_t, Money>>> categoryRows(categories.begin(),
+                                                                                                    categories.end());
+        insertRows("insert into report_category_rollup "
+                   "(tenant_id, branch_id, granularity, bucket_start, category_id, quantity, revenue) values ",
+                   "(?, ?, ?, ?, ?, ?, ?)",
+                   categoryRows.size(),
+                   [&categoryRows](auto &binder, size_t begin, size_t end)
+                   {
+                       for (size_t i = begin; i < end; ++i)
+                       {
+                           auto &[key, sales] = categoryRows[i];
+                           auto &bucket = key.first;
+                           binder << std::get<0>(bucket) << std::get<1>(bucket) << std::get<2>(bucket)
+                                  << std::get<3>(bucket) << key.second << sales.first << sales.second.toString();
+                       }
+                   });
+        std::vector<std::pair<Bucket, uint32_t>> customerRows(customers.begin(), customers.end());
+        insertRows("insert into report_customer (tenant_id, branch_id, granularity, bucket_start, member_id) values ",
+                   "(?, ?, ?, ?, ?)",
+                   customerRows.size(),
+                   [&customerRows](auto &binder, size_t begin, size_t end)
+                   {
+                       for (size_t i = begin; i < end; ++i)
+                       {
+                           auto &[bucket, memberId] = customerRows[i];
+                           binder << std::get<0>(bucket) << std::get<1>(bucket) << std::get<2>(bucket)
+                                  << std::get<3>(bucket) << memberId;
+                       }
+                   });
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to rebuild report rollups: " << e.base().what();
+        return;
+    }
+    LOG_INFO << "Report rollups rebuilt from " << counted << " orders, " << rollups.size() << " buckets";
+}
+
+void ReportAggregator::apply(const std::shared_ptr<Contribution> &contribution, int sign)
+{
+    std::vector<uint32_t> missing;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &[dishId, sales] : contribution->dishes)
+        {
+            if (!dishCategories_.count(dishId))
+                missing.push_back(dishId);
+        }
+    }
+    if (missing.empty())
+    {
+        write(contribution, sign);
+        return;
+    }
+
+    // 新菜品先补查分类
+    std::string sql = "select dish_id, dish_category_id from dish where dish_id in (";
+    for (size_t i = 0; i < missing.size(); ++i)
+        sql += i == 0 ? "?" : ", ?";
+    sql += ")";
+    auto binder = *dbClient_ << std::move(sql);
+    for (auto dishId : missing)
+        binder << dishId;
+    binder >> [this, contribution, sign, missing](const Result &r)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto dishId : missing)
+                dishCategories_[dishId] = 0;
+            for (const auto &row : r)
+            {
+                dishCategories_[row["dish_id"].as<uint32_t>()] =
+                    row["dish_category_id"].isNull() ? 0 : row["dish_category_id"].as<uint32_t>();
+            }
+        }
+        write(contribution, sign);
+    };
+    binder >> [this, contribution, sign](const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to load dish categories for reports: " << e.base().what();
+        write(contribution, sign);
+    };
+}
+
+void ReportAggregator::write(const std::shared_ptr<Contribution> &contribution, int sign)
+{
+    std::map<uint32_t, std::pair<int64_t, Money>> categories;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &[dishId, sales] : contribution->dishes)
+        {
+            auto it = dishCategories_.find(dishId);
+            auto &category = categories[it == dishCategories_.end() ? 0 : it->second];
+            category.first += sales.first;
+            category.second += sales.second;
+        }
+    }
+
+    auto hour = bucketOf(contribution->at, true).toDbStringLocal();
+    auto day = bucketOf(contribution->at, false).toDbStringLocal();
+    std::vector<uint32_t> scopes{0};
+    if (contribution->branchId != 0)
+        scopes.push_back(contribution->branchId);
+
+    for (auto branchId : scopes)
+    {
+        if (!categories.empty())
+        {
+            std::string sql = "insert into report_category_rollup "
+                              "(tenant_id, branch_id, granularity, bucket_start, category_id, quantity, revenue) values ";
+            for (size_t i = 0; i < categories.size() * 2; ++i)
+                sql += i == 0 ? "(?, ?, ?, ?, ?, ?, ?)" : ", (?, ?, ?, ?, ?, ?, ?)";
+            sql += " on duplicate key update quantity = quantity + values(quantity), revenue = revenue + values(revenue)";
+            auto binder = *dbClient_ << std::move(sql);
+            for (auto &[categoryId, sales] : categories)
+            {
+                for (auto granularity : {"hour", "day"})
+                {
+                    binder << contribution->tenantId << branchId << std::string(granularity)
+                           << (granularity[0] == 'h' ? hour : day) << categoryId
+                           << static_cast<int64_t>(sign * sales.first) << (sales.second * sign).toString();
+                }
+            }
+            binder >> [](const Result &) {};
+            binder >> [](const DrogonDbException &e)
+            {
+                LOG_ERROR << "Failed to update category rollup: " << e.base().what();
+            };
+        }
+
+        if (contribution->memberId == 0 || sign < 0)
+        {
+            int64_t guests = sign * contribution->guests;
+            upsertRollup(*contribution, branchId, sign, guests, guests);
+            continue;
+        }
+        // 会员在时间桶内首次出现才计入客流；天桶新增必然伴随小时桶新增
+        dbClient_->execSqlAsync(
+            "insert ignore into report_customer (tenant_id, branch_id, granularity, bucket_start, member_id) "
+            "values (?, ?, 'hour', ?, ?), (?, ?, 'day', ?, ?)",
+            [this, contribution, branchId, sign](const Result &r)
+            {
+                auto added = r.affectedRows();
+                upsertRollup(*contribution, branchId, sign, added >= 1 ? 1 : 0, added >= 2 ? 1 : 0);
+            },
+            [this, contribution, branchId, sign](const DrogonDbException &e)
+            {
+                LOG_ERROR << "Failed to record report customer: " << e.base().what();
+                upsertRollup(*contribution, branchId, sign, 0, 0);
+            },
+            contribution->tenantId,
+            branchId,
+            hour,
+            contribution->memberId,
+            contribution->tenantId,
+            branchId,
+            day,
+            contribution->memberId);
+    }
+}
+
+void ReportAggregator::upsertRollup(const Contribution &contribution,
+                                    uint32_t branchId,
+                                    int sign,
+                                    int64_t hourCustomers,
+                                    int64_t dayCustomers)
+{
+    auto revenue = (contribution.revenue * sign).toString();
+    dbClient_->execSqlAsync(
+        "insert into report_rollup "
+        "(tenant_id, branch_id, granularity, bucket_start, revenue, order_count, customer_count) "
+        "values (?, ?, 'hour', ?, ?, ?, ?), (?, ?, 'day', ?, ?, ?, ?) "
+        "on duplicate key update revenue = revenue + values(revenue), "
+        "order_count = order_count + values(order_count), customer_count = customer_count + values(customer_count)",
+        [](const Result &) {},
+        [](const DrogonDbException &e)
+        {
+            LOG_ERROR << "Failed to update report rollup: " << e.base().what();
+        },
+        contribution.tenantId,
+        branchId,
+        bucketOf(contribution.at, true).toDbStringLocal(),
+        revenue,
+        sign,
+        hourCustomers,
+        contribution.tenantId,
+        branchId,
+        bucketOf(contribution.at, false).toDbStringLocal(),
+        revenue,
+        sign,
+        dayCustomers);
+}
@@ -0,0 +1,84 @@
+/**
+ *
+ *  ReportAggregator.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/orm/DbClient.h>
+#include <trantor/utils/Date.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include "Money.h"
+#include "OrderTable.h"
+
+/**
+ * @brief 报表汇总，按租户、分店维护小时和天两级时间桶。
+ *
+ * 订单写入时增量更新 report_rollup（营收、订单数、客流）和 report_category_rollup（品类构成），
+ * 报表接口只读取时间桶，不扫描 order_table。branch_id 为 0 的行是全租户汇总。
+ * 客流 = 去重会员数 + 散客人数；会员去重记录在 report_customer，订单撤回时不回退会员客流。
+ * 已取消、已退款的订单不计入，订单改成这两种状态时按撤回处理。
+ * 时间桶为空或配置 rebuild_on_start 时，启动时从 order_table 全量重建。
+ */
+class ReportAggregator : public drogon::Plugin<ReportAggregator>
+{
+public:
+  ReportAggregator() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  /// 订单创建后计入报表
+  void orderCreated(const drogon_model::saas_restaurant::OrderTable &order);
+  /// 订单修改后重新读取，按修改前后的差值调整
+  void orderUpdated(const drogon_model::saas_restaurant::OrderTable &before);
+  /// 订单被物理删除后撤回
+  void orderRemoved(const drogon_model::saas_restaurant::OrderTable &before);
+
+  /// 菜品修改后清除缓存的分类，下次用到时重新查询
+  void dishChanged(uint32_t dishId);
+
+  /// 时间桶起点，按本地时间对齐
+  static trantor::Date bucketOf(const trantor::Date &at, bool hourly);
+
+private:
+  struct Contribution
+  {
+    uint32_t tenantId{0};
+    uint32_t branchId{0};
+    trantor::Date at;
+    Money revenue;
+    uint32_t memberId{0};
+    int64_t guests{0};                                     // 非会员订单的就餐人数
+    std::map<uint32_t, std::pair<int64_t, Money>> dishes; // 菜品ID -> (份数, 小计)
+
+    bool sameAs(const Contribution &other) const;
+  };
+
+  static std::optional<Contribution> contributionOf(const drogon_model::saas_restaurant::OrderTable &order);
+  /// 清空时间桶后按全部订单重建，在 initAndStart 中同步执行
+  void rebuild();
+  void apply(const std::shared_ptr<Contribution> &contribution, int sign);
+  void write(const std::shared_ptr<Contribution> &contribution, int sign);
+  void upsertRollup(const Contribution &contribution,
+                    uint32_t branchId,
+                    int sign,
+                    int64_t hourCustomers,
+                    int64_t dayCustomers);
+
+  drogon::orm::DbClientPtr dbClient_;
+
+  std::mutex mutex_;
+  std::unordered_map<uint32_t, uint32_t> dishCategories_; // 菜品ID -> 分类ID
+};
@@ -0,0 +1,277 @@
+/**
+ *
+ *  ReportSketches.cc
+ *
+ */
+
+#include "ReportSketches.h"
+#include <drogon/drogon.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+using namespace drogon;
+using namespace drogon::orm;
+using namespace drogon_model::saas_restaurant;
+
+namespace
+{
+// 明细里的数字可能是字符串
+double numberOf(const Json::Value &value, double defaultValue = 0)
+{
+    try
+    {
+        if (value.isString())
+            return value.asString().empty() ? defaultValue : std::stod(value.asString());
+        if (value.isNumeric())
+            return value.asDouble();
+    }
+    catch (const std::exception &)
+    {
+    }
+    return defaultValue;
+}
+
+// 会员和下单用户的ID各自独立，用高位区分
+uint64_t memberKey(uint32_t memberId)
+{
+    return (uint64_t(1) << 32) | memberId;
+}
+
+uint64_t userKey(uint32_t userId)
+{
+    return (uint64_t(2) << 32) | userId;
+}
+} // namespace
+
+void ReportSketches::initAndStart(const Json::Value &config)
+{
+    dbClient_ = app().getDbClient(config.get("db_client", "default").asString());
+    capacity_ = config.get("top_capacity", 64).asUInt();
+    memoryDays_ = std::max(1, config.get("memory_days", 2).asInt());
+
+    load();
+
+    timerId_ = app().getLoop()->runEvery(config.get("flush_interval", 60.0).asDouble(), [this]() { flush(); });
+}
+
+void ReportSketches::shutdown()
+{
+    app().getLoop()->invalidateTimer(timerId_);
+    flush();
+}
+
+std::string ReportSketches::dayOf(const trantor::Date &at)
+{
+    return at.roundDay().toDbStringLocal().substr(0, 10);
+}
+
+std::string ReportSketches::windowStart() const
+{
+    return dayOf(trantor::Date::now().roundDay().after(-86400.0 * (memoryDays_ - 1)));
+}
+
+void ReportSketches::load()
+{
+    try
+    {
+        auto rows = dbClient_->execSqlSync(
+            "select tenant_id, branch_id, bucket_date, customers, top_dishes from report_sketch where bucket_date >= ?",
+            windowStart());
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &row : rows)
+        {
+            Entry entry;
+            entry.dishes = SpaceSaving(capacity_);
+            if (!row["customers"].isNull() && !entry.customers.deserialize(row["customers"].as<std::string>()))
+                LOG_ERROR << "Broken customer sketch of tenant " << row["tenant_id"].as<uint32_t>();
+            if (!row["top_dishes"].isNull() && !entry.dishes.deserialize(row["top_dishes"].as<std::string>()))
+                LOG_ERROR << "Broken dish sketch of tenant " << row["tenant_id"].as<uint32_t>();
+            entries_[Key(row["tenant_id"].as<uint32_t>(),
+                         row["branch_id"].as<uint32_t>(),
+                         row["bucket_date"].as<std::string>().substr(0, 10))] = std::move(entry);
+        }
+        LOG_INFO << "Report sketches loaded " << entries_.size() << " recent sketches";
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to load report sketches: " << e.base().what();
+    }
+}
+
+void ReportSketches::update(uint32_t tenantId,
+                            uint32_t branchId,
+                            const trantor::Date &at,
+                            const std::function<void(Entry &)> &apply)
+{
+    auto day = dayOf(at);
+    if (tenantId == 0 || day < windowStart())
+        return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto branch : {uint32_t(0), branchId})
+    {
+        auto it = entries_.find(Key(tenantId, branch, day));
+        if (it == entries_.end())
+        {
+            it = entries_.emplace(Key(tenantId, branch, day), Entry()).first;
+            it->second.dishes = SpaceSaving(capacity_);
+        }
+        apply(it->second);
+        it->second.dirty = true;
+        if (branchId == 0)
+            break;
+    }
+}
+
+void ReportSketches::orderCreated(const OrderTable &order)
+{
+    if (order.getValueOfIsDeleted())
+        return;
+    uint32_t memberId = 0;
+    std::vector<std::pair<uint32_t, uint64_t>> dishes;
+    Json::Value detail;
+    std::string errs;
+    const auto &text = order.getValueOfOrderDetail();
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    if (!text.empty() && reader->parse(text.data(), text.data() + text.size(), &detail, &errs) && detail.isObject())
+    {
+        memberId = static_cast<uint32_t>(numberOf(detail["member_id"]));
+        for (const auto &line : detail["items"])
+        {
+            auto dishId = static_cast<uint32_t>(numberOf(line["dish_id"]));
+            auto quantity = numberOf(line["quantity"], 1);
+            if (dishId != 0 && quantity > 0)
+                dishes.emplace_back(dishId, static_cast<uint64_t>(quantity));
+        }
+    }
+    auto at = order.getCreatedAt() ? order.getValueOfCreatedAt() : trantor::Date::now();
+    auto userId = order.getValueOfUserId();
+    update(order.getValueOfTenantId(),
+           order.getValueOfBranchId(),
+           at,
+           [&](Entry &entry)
+           {
+               if (memberId != 0)
+                   entry.customers.add(memberKey(memberId));
+               else if (userId != 0)
+                   entry.customers.add(userKey(userId));
+               for (const auto &[dishId, quantity] : dishes)
+                   entry.dishes.add(dishId, quantity);
+           });
+}
+
+void ReportSketches::consumptionCreated(const ConsumptionRecord &record)
+{
+    if (record.getValueOfMemberId() == 0)
+        return;
+    auto at = record.getCreatedAt() ? record.getValueOfCreatedAt() : trantor::Date::now();
+    auto memberId = record.getValueOfMemberId();
+    // 消费记录没有分店，只计入全租户草图
+    update(record.getValueOfTenantId(), 0, at, [memberId](Entry &entry) { entry.customers.add(memberKey(memberId)); });
+}
+
+void ReportSketches::flush()
+{
+    struct Row
+    {
+        Key key;
+        std::string customers;
+        std::string dishes;
+    };
+    auto rows = std::make_shared<std::vector<Row>>();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto start = windowStart();
+        for (auto it = entries_.begin(); it != entries_.end();)
+        {
+            if (it->second.dirty)
+            {
+                rows->push_back({it->first, it->second.customers.serialize(), it->second.dishes.serialize()});
+                it->second.dirty = false;
+            }
+            // 窗口之外的草图已写回，移出内存
+            if (std::get<2>(it->first) < start)
+                it = entries_.erase(it);
+            else
+                ++it;
+        }
+    }
+    if (rows->empty())
+        return;
+
+    std::string sql = "insert into report_sketch (tenant_id, branch_id, bucket_date, customers, top_dishes) values ";
+    for (size_t i = 0; i < rows->size(); ++i)
+        sql += i == 0 ? "(?, ?, ?, ?, ?)" : ", (?, ?, ?, ?, ?)";
+    sql += " on duplicate key update customers = values(customers), top_dishes = values(top_dishes)";
+    auto binder = *dbClient_ << std::move(sql);
+    for (const auto &row : *rows)
+        binder << std::get<0>(row.key) << std::get<1>(row.key) << std::get<2>(row.key) << row.customers << row.dishes;
+    binder >> [](const Result &) {};
+    binder >> [this, rows](const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to write report sketches: " << e.base().what();
+        // 仍在内存中的草图下次重写
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &row : *rows)
+        {
+            auto it = entries_.find(row.key);
+            if (it != entries_.end())
+                it->second.dirty = true;
+        }
+    };
+}
+
+void ReportSketches::summarize(uint32_t tenantId,
+                               uint32_t branchId,
+                               const std::string &from,
+                               const std::string &to,
+                               std::function<void(const Summary &)> &&callback,
+                               std::function<void(const DrogonDbException &)> &&errorCallback)
+{
+    std::string sql = "select tenant_id, bucket_date, customers, top_dishes from report_sketch "
+                      "where branch_id = ? and bucket_date >= ? and bucket_date < ?";
+    if (tenantId != 0)
+        sql += " and tenant_id = ?";
+    auto binder = *dbClient_ << std::move(sql);
+    binder << branchId << from << to;
+    if (tenantId != 0)
+        binder << tenantId;
+    binder >> [this, tenantId, branchId, from, to, callback = std::move(callback)](const Result &r)
+    {
+        Summary summary;
+        summary.dishes = SpaceSaving(capacity_);
+        auto add = [&summary](const std::string &day, const HyperLogLog &customers, const SpaceSaving &dishes)
+        {
+            summary.days[day].merge(customers);
+            summary.customers.merge(customers);
+            summary.dishes.merge(dishes);
+        };
+        {
+            // 内存中的草图比库里的新，优先使用
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto &row : r)
+            {
+                auto tenant = row["tenant_id"].as<uint32_t>();
+                auto day = row["bucket_date"].as<std::string>().substr(0, 10);
+                if (entries_.count(Key(tenant, branchId, day)))
+                    continue;
+                HyperLogLog customers;
+                SpaceSaving dishes(capacity_);
+                if (!row["customers"].isNull())
+                    customers.deserialize(row["customers"].as<std::string>());
+                if (!row["top_dishes"].isNull())
+                    dishes.deserialize(row["top_dishes"].as<std::string>());
+                add(day, customers, dishes);
+            }
+            for (const auto &[key, entry] : entries_)
+            {
+                const auto &[tenant, branch, day] = key;
+                if ((tenantId == 0 || tenant == tenantId) && branch == branchId && day >= from && day < to)
+                    add(day, entry.customers, entry.dishes);
+            }
+        }
+        callback(summary);
+    };
+    binder >> std::move(errorCallback);
+}
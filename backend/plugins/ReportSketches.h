@@ -0,0 +1,82 @@
+/**
+ *
+ *  ReportSketches.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/orm/DbClient.h>
+#include <trantor/net/EventLoop.h>
+#include <trantor/utils/Date.h>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include "ConsumptionRecord.h"
+#include "OrderTable.h"
+#include "Sketches.h"
+
+/**
+ * @brief 按租户、分店、天维护去重顾客 HyperLogLog 和热销菜品 Space-Saving 草图。
+ *
+ * 顾客键为会员ID，没有会员的订单按下单用户计；消费记录也计入会员。branch_id 为 0 的草图是全租户汇总。
+ * 最近 memory_days 天的草图常驻内存，有变化的每 flush_interval 秒整体写回 report_sketch。
+ * 草图只增不减，订单撤回或删除不回退；早于内存窗口的订单不计入，避免覆盖已持久化的草图。
+ */
+class ReportSketches : public drogon::Plugin<ReportSketches>
+{
+public:
+  ReportSketches() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  void orderCreated(const drogon_model::saas_restaurant::OrderTable &order);
+  void consumptionCreated(const drogon_model::saas_restaurant::ConsumptionRecord &record);
+
+  struct Summary
+  {
+    std::map<std::string, HyperLogLog> days; // 日期 -> 当天去重顾客
+    HyperLogLog customers;                  // 整个范围的去重顾客
+    SpaceSaving dishes;
+  };
+  /// 合并 [from, to) 内各天的草图，日期格式 YYYY-MM-DD；tenantId 为 0 时合并全部租户
+  void summarize(uint32_t tenantId,
+                 uint32_t branchId,
+                 const std::string &from,
+                 const std::string &to,
+                 std::function<void(const Summary &)> &&callback,
+                 std::function<void(const drogon::orm::DrogonDbException &)> &&errorCallback);
+
+private:
+  using Key = std::tuple<uint32_t, uint32_t, std::string>; // 租户、分店、日期
+  struct Entry
+  {
+    HyperLogLog customers;
+    SpaceSaving dishes;
+    bool dirty{false};
+  };
+
+  static std::string dayOf(const trantor::Date &at);
+  std::string windowStart() const;
+  /// 同时更新分店和全租户草图；回调在持锁时调用
+  void update(uint32_t tenantId, uint32_t branchId, const trantor::Date &at, const std::function<void(Entry &)> &apply);
+  void load();
+  void flush();
+
+  drogon::orm::DbClientPtr dbClient_;
+  trantor::TimerId timerId_{0};
+  size_t capacity_{64};
+  int memoryDays_{2};
+
+  std::mutex mutex_;
+  std::map<Key, Entry> entries_;
+};
@@ -0,0 +1,107 @@
+/**
+ *
+ *  RfmTable.cc
+ *
+ */
+
+#include "RfmTable.h"
+#include <algorithm>
+
+void RfmTable::Metrics::add(int32_t day, int64_t amount)
+{
+    firstDay = firstDay < 0 ? day : std::min(firstDay, day);
+    lastDay = std::max(lastDay, day);
+    ++orders;
+    cents += amount;
+}
+
+void RfmTable::Metrics::merge(const Metrics &other)
+{
+    if (other.orders == 0)
+        return;
+    firstDay = firstDay < 0 ? other.firstDay : std::min(firstDay, other.firstDay);
+    lastDay = std::max(lastDay, other.lastDay);
+    orders += other.orders;
+    cents += other.cents;
+}
+
+void RfmTable::add(uint32_t memberId, int32_t day, int64_t cents)
+{
+    members_[memberId].add(day, cents);
+}
+
+void RfmTable::merge(std::unordered_map<uint32_t, Metrics> &&members)
+{
+    if (members_.empty())
+    {
+        members_.swap(members);
+        return;
+    }
+    members_.reserve(members_.size() + members.size());
+    for (const auto &[memberId, metrics] : members)
+        members_[memberId].merge(metrics);
+}
+
+void RfmTable::rescore(int32_t today)
+{
+    std::array<std::vector<int64_t>, 3> values;
+    for (auto &column : values)
+        column.reserve(members_.size());
+    for (const auto &[memberId, metrics] : members_)
+    {
+        if (metrics.orders == 0)
+            continue;
+        values[0].push_back(-static_cast<int64_t>(std::max(today - metrics.lastDay, 0)));
+        values[1].push_back(metrics.orders);
+        values[2].push_back(metrics.cents);
+    }
+    scored_ = !values[0].empty();
+    if (!scored_)
+        return;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        auto &column = values[i];
+        for (size_t q = 0; q < cuts_[i].size(); ++q)
+        {
+            // 第 (q + 1) * 20 分位
+            auto nth = column.begin() + static_cast<std::ptrdiff_t>(column.size() * (q + 1) / 5);
+            if (nth == column.end())
+                --nth;
+            std::nth_element(column.begin(), nth, column.end());
+            cuts_[i][q] = *nth;
+        }
+        std::sort(cuts_[i].begin(), cuts_[i].end());
+    }
+}
+
+RfmTable::Scores RfmTable::scoreOf(const Metrics &metrics, int32_t today) const
+{
+    if (!scored_ || metrics.orders == 0)
+        return {0, 0, 0};
+    std::array<int64_t, 3> values{-static_cast<int64_t>(std::max(today - metrics.lastDay, 0)),
+                                  static_cast<int64_t>(metrics.orders),
+                                  metrics.cents};
+    Scores scores{};
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        // 严格超过几个边界就在 1 分上加几分
+        auto above = std::lower_bound(cuts_[i].begin(), cuts_[i].end(), values[i]) - cuts_[i].begin();
+        scores[i] = static_cast<uint8_t>(1 + above);
+    }
+    return scores;
+}
+
+const RfmTable::Metrics *RfmTable::find(uint32_t memberId) const
+{
+    auto it = members_.find(memberId);
+    return it == members_.end() ? nullptr : &it->second;
+}
+
+std::vector<std::pair<uint32_t, RfmTable::Scores>> RfmTable::scores(int32_t today) const
+{
+    std::vector<std::pair<uint32_t, Scores>> result;
+    result.reserve(members_.size());
+    for (const auto &[memberId, metrics] : members_)
+        result.emplace_back(memberId, scoreOf(metrics, today));
+    return result;
+}
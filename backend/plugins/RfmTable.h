@@ -0,0 +1,55 @@
+/**
+ *
+ *  RfmTable.h
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 单个租户的会员 RFM 指标和评分。
+ *
+ * 每个会员累计首次、最近消费日，消费笔数和金额（分），可以分片各自累加后合并。
+ * rescore 按全体会员的分布取 20/40/60/80 分位作为边界，R 越近、F 越多、M 越高分数越高，各 1-5 分；
+ * 两次 rescore 之间新增的消费按已有边界增量评分。
+ */
+class RfmTable
+{
+public:
+  struct Metrics
+  {
+    int32_t firstDay{-1};
+    int32_t lastDay{-1};
+    uint32_t orders{0};
+    int64_t cents{0};
+
+    void add(int32_t day, int64_t amount);
+    void merge(const Metrics &other);
+  };
+  using Scores = std::array<uint8_t, 3>; // R、F、M
+
+  void add(uint32_t memberId, int32_t day, int64_t cents);
+  /// 合并另一分片的指标，同一会员的指标相加
+  void merge(std::unordered_map<uint32_t, Metrics> &&members);
+  /// 按 today 重新计算三项分位边界
+  void rescore(int32_t today);
+  /// 按当前边界评分，未消费过的会员为 0 分
+  Scores scoreOf(const Metrics &metrics, int32_t today) const;
+  const Metrics *find(uint32_t memberId) const;
+  /// 全部会员的评分
+  std::vector<std::pair<uint32_t, Scores>> scores(int32_t today) const;
+  size_t size() const { return members_.size(); }
+
+private:
+  std::unordered_map<uint32_t, Metrics> members_;
+  // 分位边界，取值越大分数越高；R 用负的未消费天数
+  std::array<std::array<int64_t, 4>, 3> cuts_{};
+  bool scored_{false};
+};
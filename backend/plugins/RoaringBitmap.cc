@@ -0,0 +1,379 @@
+/**
+ *
+ *  RoaringBitmap.cc
+ *
+ */
+
+#include "RoaringBitmap.h"
+#include <algorithm>
+
+bool RoaringBitmap::Container::contains(uint16_t low) const
+{
+    if (isBitmap())
+        return (bits[low >> 6] >> (low & 63)) & 1;
+    return std::binary_search(array.begin(), array.end(), low);
+}
+
+bool RoaringBitmap::Container::add(uint16_t low)
+{
+    if (isBitmap())
+    {
+        auto &word = bits[low >> 6];
+        auto mask = uint64_t(1) << (low & 63);
+        if (word & mask)
+            return false;
+        word |= mask;
+        ++count;
+        return true;
+    }
+    auto it = std::lower_bound(array.begin(), array.end(), low);
+    if (it != array.end() && *it == low)
+        return false;
+    array.insert(it, low);
+    ++count;
+    if (count > kArrayMax)
+        toBitmap();
+    return true;
+}
+
+bool RoaringBitmap::Container::remove(uint16_t low)
+{
+    if (isBitmap())
+    {
+        auto &word = bits[low >> 6];
+        auto mask = uint64_t(1) << (low & 63);
+        if (!(word & mask))
+            return false;
+        word &= ~mask;
+        --count;
+        if (count < kArrayMin)
+            toArray();
+        return true;
+    }
+    auto it = std::lower_bound(array.begin(), array.end(), low);
+    if (it == array.end() || *it != low)
+        return false;
+    array.erase(it);
+    --count;
+    return true;
+}
+
+void RoaringBitmap::Container::toBitmap()
+{
+    bits.assign(kWords, 0);
+    for (auto low : array)
+        bits[low >> 6] |= uint64_t(1) << (low & 63);
+    std::vector<uint16_t>().swap(array);
+}
+
+void RoaringBitmap::Container::toArray()
+{
+    array.clear();
+    array.reserve(count);
+    for (size_t w = 0; w < kWords; ++w)
+    {
+        for (auto word = bits[w]; word; word &= word - 1)
+            array.push_back(static_cast<uint16_t>(w * 64 + __builtin_ctzll(word)));
+    }
+    std::vector<uint64_t>().swap(bits);
+}
+
+void RoaringBitmap::Container::normalize()
+{
+    if (isBitmap() && count <= kArrayMax)
+        toArray();
+    else if (!isBitmap() && count > kArrayMax)
+        toBitmap();
+}
+
+RoaringBitmap::Container *RoaringBitmap::find(uint16_t key)
+{
+    auto it = std::lower_bound(containers_.begin(), containers_.end(), key, [](const Container &c, uint16_t k) {
+        return c.key < k;
+    });
+    return it != containers_.end() && it->key == key ? &*it : nullptr;
+}
+
+const RoaringBitmap::Container *RoaringBitmap::find(uint16_t key) const
+{
+    return const_cast<RoaringBitmap *>(this)->find(key);
+}
+
+void RoaringBitmap::add(uint32_t value)
+{
+    auto key = static_cast<uint16_t>(value >> 16);
+    auto it = std::lower_bound(containers_.begin(), containers_.end(), key, [](const Container &c, uint16_t k) {
+        return c.key < k;
+    });
+    if (it == containers_.end() || it->key != key)
+    {
+        Container container;
+        container.key = key;
+        it = containers_.insert(it, std::move(container));
+    }
+    it->add(static_cast<uint16_t>(value));
+}
+
+void RoaringBitmap::remove(uint32_t value)
+{
+    auto *container = find(static_cast<uint16_t>(value >> 16));
+    if (!container || !container->remove(static_cast<uint16_t>(value)) || container->count > 0)
+        return;
+    containers_.erase(containers_.begin() + (container - containers_.data()));
+}
+
+bool RoaringBitmap::contains(uint32_t value) const
+{
+    const auto *container = find(static_cast<uint16_t>(value >> 16));
+    return container && container->contains(static_cast<uint16_t>(value));
+}
+
+uint64_t RoaringBitmap::cardinality() const
+{
+    uint64_t total = 0;
+    for (const auto &container : containers_)
+        total += container.count;
+    return total;
+}
+
+RoaringBitmap::Container RoaringBitmap::combine(const Container &a, const Container &b, Op op)
+{
+    Container out;
+    out.key = a.key;
+    if (a.isBitmap() && b.isBitmap())
+    {
+        out.bits.resize(Container::kWords);
+        for (size_t w = 0; w < Container::kWords; ++w)
+        {
+            auto word = op == Op::And ? a.bits[w] & b.bits[w] : op == Op::Or ? a.bits[w] | b.bits[w] : a.bits[w] & ~b.bits[w];
+            out.bits[w] = word;
+            out.count += static_cast<uint32_t>(__builtin_popcountll(word));
+        }
+        out.normalize();
+        return out;
+    }
+    if (!a.isBitmap() && !b.isBitmap())
+    {
+        out.array.reserve(op == Op::Or ? a.count + b.count : a.count);
+        auto target = std::back_inserter(out.array);
+        if (op == Op::And)
+            std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), target);
+        else if (op == Op::Or)
+            std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), target);
+        else
+            std::set_difference(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), target);
+        out.count = static_cast<uint32_t>(out.array.size());
+        out.normalize();
+        return out;
+    }
+    // 数组与位图混合：数组侧逐个查位
+    if (op == Op::Or)
+    {
+        out = a.isBitmap() ? a : b;
+        const auto &array = a.isBitmap() ? b.array : a.array;
+        for (auto low : array)
+            out.add(low);
+        return out;
+    }
+    if (op == Op::And)
+    {
+        const auto &array = a.isBitmap() ? b.array : a.array;
+        const auto &bitmap = a.isBitmap() ? a : b;
+        for (auto low : array)
+        {
+            if (bitmap.contains(low))
+                out.array.push_back(low);
+        }
+        out.count = static_cast<uint32_t>(out.array.size());
+        return out;
+    }
+    if (a.isBitmap())
+    {
+        out = a;
+        for (auto low : b.array)
+            out.remove(low);
+        return out;
+    }
+    for (auto low : a.array)
+    {
+        if (!b.contains(low))
+            out.array.push_back(low);
+    }
+    out.count = static_cast<uint32_t>(out.array.size());
+    return out;
+}
+
+uint64_t RoaringBitmap::andCount(const Container &a, const Container &b)
+{
+    if (a.isBitmap() && b.isBitmap())
+    {
+        uint64_t count = 0;
+        for (size_t w = 0; w < Container::kWords; ++w)
+            count += static_cast<uint64_t>(__builtin_popcountll(a.bits[w] & b.bits[w]));
+        return count;
+    }
+    const auto &small = a.isBitmap() ? b : a;
+    const auto &other = a.isBitmap() ? a : b;
+    uint64_t count = 0;
+    for (auto low : small.array)
+        count += other.contains(low);
+    return count;
+}
+
+RoaringBitmap RoaringBitmap::operator&(const RoaringBitmap &other) const
+{
+    RoaringBitmap result;
+    auto i = containers_.begin();
+    auto j = other.containers_.begin();
+    while (i != containers_.end() && j != other.containers_.end())
+    {
+        if (i->key < j->key)
+            ++i;
+        else if (j->key < i->key)
+            ++j;
+        else
+        {
+            auto container = combine(*i, *j, Op::And);
+            if (container.count > 0)
+                result.containers_.push_back(std::move(container));
+            ++i;
+            ++j;
+        }
+    }
+    return result;
+}
+
+RoaringBitmap RoaringBitmap::operator|(const RoaringBitmap &other) const
+{
+    RoaringBitmap result;
+    auto i = containers_.begin();
+    auto j = other.containers_.begin();
+    while (i != containers_.end() || j != other.containers_.end())
+    {
+        if (j == other.containers_.end() || (i != containers_.end() && i->key < j->key))
+            result.containers_.push_back(*i++);
+        else if (i == containers_.end() || j->key < i->key)
+            result.containers_.push_back(*j++);
+        else
+            result.containers_.push_back(combine(*i++, *j++, Op::Or));
+    }
+    return result;
+}
+
+RoaringBitmap RoaringBitmap::operator-(const RoaringBitmap &other) const
+{
+    RoaringBitmap result;
+    auto j = other.containers_.begin();
+    for (const auto &container : containers_)
+    {
+        while (j != other.containers_.end() && j->key < container.key)
+            ++j;
+        if (j == other.containers_.end() || j->key != container.key)
+        {
+            result.containers_.push_back(container);
+            continue;
+        }
+        auto diff = combine(container, *j, Op::AndNot);
+        if (diff.count > 0)
+            result.containers_.push_back(std::move(diff));
+    }
+    return result;
+}
+
+RoaringBitmap &RoaringBitmap::operator|=(const RoaringBitmap &other)
+{
+    *this = *this | other;
+    return *this;
+}
+
+RoaringBitmap &RoaringBitmap::operator&=(const RoaringBitmap &other)
+{
+    *this = *this & other;
+    return *this;
+}
+
+uint64_t RoaringBitmap::andCardinality(const RoaringBitmap &other) const
+{
+    uint64_t count = 0;
+    auto i = containers_.begin();
+    auto j = other.containers_.begin();
+    while (i != containers_.end() && j != other.containers_.end())
+    {
+        if (i->key < j->key)
+            ++i;
+        else if (j->key < i->key)
+            ++j;
+        else
+            count += andCount(*i++, *j++);
+    }
+    return count;
+}
+
+void RoaringBitmap::forEach(const std::function<bool(uint32_t)> &callback) const
+{
+    for (const auto &container : containers_)
+    {
+        uint32_t high = uint32_t(container.key) << 16;
+        if (!container.isBitmap())
+        {
+            for (auto low : container.array)
+            {
+                if (!callback(high | low))
+                    return;
+            }
+            continue;
+        }
+        for (size_t w = 0; w < Container::kWords; ++w)
+        {
+            for (auto word = container.bits[w]; word; word &= word - 1)
+            {
+                if (!callback(high | static_cast<uint32_t>(w * 64 + __builtin_ctzll(word))))
+                    return;
+            }
+        }
+    }
+}
+
+std::vector<uint32_t> RoaringBitmap::page(uint64_t offset, uint64_t limit) const
+{
+    std::vector<uint32_t> values;
+    if (limit == 0)
+        return values;
+    // 整块跳过 offset
+    size_t first = 0;
+    for (; first < containers_.size() && offset >= containers_[first].count; ++first)
+        offset -= containers_[first].count;
+    for (size_t c = first; c < containers_.size() && values.size() < limit; ++c)
+    {
+        const auto &container = containers_[c];
+        uint32_t high = uint32_t(container.key) << 16;
+        if (!container.isBitmap())
+        {
+            for (size_t k = offset; k < container.array.size() && values.size() < limit; ++k)
+                values.push_back(high | container.array[k]);
+        }
+        else
+        {
+            uint64_t skipped = 0;
+            for (size_t w = 0; w < Container::kWords && values.size() < limit; ++w)
+            {
+                for (auto word = container.bits[w]; word && values.size() < limit; word &= word - 1)
+                {
+                    if (skipped++ < offset)
+                        continue;
+                    values.push_back(high | static_cast<uint32_t>(w * 64 + __builtin_ctzll(word)));
+                }
+            }
+        }
+        offset = 0;
+    }
+    return values;
+}
+
+size_t RoaringBitmap::memoryBytes() const
+{
+    size_t bytes = containers_.capacity() * sizeof(Container);
+    for (const auto &container : containers_)
+        bytes += container.array.capacity() * sizeof(uint16_t) + container.bits.capacity() * sizeof(uint64_t);
+    return bytes;
+}
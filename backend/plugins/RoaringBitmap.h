@@ -0,0 +1,79 @@
+/**
+ *
+ *  RoaringBitmap.h
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief 32 位整数集合的压缩位图（Roaring）。
+ *
+ * 按高 16 位分块，每块不超过 4096 个元素时存为有序 uint16 数组，否则存为 65536 位的位图；
+ * 位图块删到 2048 个以下才转回数组。
+ * 会员ID稠密时每个会员约 1 位，稀疏时约 2 字节；交、并、差按块合并，位图块之间逐 64 位运算。
+ */
+class RoaringBitmap
+{
+public:
+  void add(uint32_t value);
+  void remove(uint32_t value);
+  bool contains(uint32_t value) const;
+  uint64_t cardinality() const;
+  bool empty() const { return containers_.empty(); }
+  void clear() { containers_.clear(); }
+
+  RoaringBitmap operator&(const RoaringBitmap &other) const;
+  RoaringBitmap operator|(const RoaringBitmap &other) const;
+  /// 差集
+  RoaringBitmap operator-(const RoaringBitmap &other) const;
+  RoaringBitmap &operator|=(const RoaringBitmap &other);
+  RoaringBitmap &operator&=(const RoaringBitmap &other);
+  /// 只求交集大小，不生成结果
+  uint64_t andCardinality(const RoaringBitmap &other) const;
+
+  /// 升序遍历，回调返回 false 时停止
+  void forEach(const std::function<bool(uint32_t)> &callback) const;
+  /// 升序跳过 offset 个后取最多 limit 个
+  std::vector<uint32_t> page(uint64_t offset, uint64_t limit) const;
+  size_t memoryBytes() const;
+
+private:
+  struct Container
+  {
+    static constexpr size_t kArrayMax = 4096;
+    // 位图块删到低于此数才转回数组，避免在 kArrayMax 附近反复增删时来回转换
+    static constexpr size_t kArrayMin = kArrayMax / 2;
+    static constexpr size_t kWords = 1024;
+
+    uint16_t key{0};
+    uint32_t count{0};
+    std::vector<uint16_t> array; // 数组块，count 不超过 kArrayMax
+    std::vector<uint64_t> bits;  // 否则为 kWords 个 64 位字
+
+    bool isBitmap() const { return !bits.empty(); }
+    bool contains(uint16_t low) const;
+    bool add(uint16_t low);
+    bool remove(uint16_t low);
+    void toBitmap();
+    void toArray();
+    /// 新生成的块按计数选用较小的表示
+    void normalize();
+  };
+  enum class Op
+  {
+    And,
+    Or,
+    AndNot
+  };
+  static Container combine(const Container &a, const Container &b, Op op);
+  static uint64_t andCount(const Container &a, const Container &b);
+  Container *find(uint16_t key);
+  const Container *find(uint16_t key) const;
+
+  std::vector<Container> containers_; // 按 key 升序
+};
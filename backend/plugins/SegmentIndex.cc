@@ -0,0 +1,267 @@
+/**
+ *
+ *  SegmentIndex.cc
+ *
+ */
+
+#include "SegmentIndex.h"
+#include <algorithm>
+
+SegmentIndex::SegmentIndex(std::vector<int64_t> spendBounds, std::vector<int32_t> recencyBounds, int32_t windowDays)
+    : spendBounds_(std::move(spendBounds)), recencyBounds_(std::move(recencyBounds)), windowDays_(std::max(windowDays, 1))
+{
+    std::sort(spendBounds_.begin(), spendBounds_.end());
+    spendBounds_.erase(std::unique(spendBounds_.begin(), spendBounds_.end()), spendBounds_.end());
+    std::sort(recencyBounds_.begin(), recencyBounds_.end());
+    recencyBounds_.erase(std::unique(recencyBounds_.begin(), recencyBounds_.end()), recencyBounds_.end());
+    bySpend_.resize(spendBucketCount());
+    byRecency_.resize(recencyBucketCount());
+    for (auto &scores : byRfm_)
+        scores.resize(kScoreCount);
+}
+
+size_t SegmentIndex::spendBucketOf(int64_t cents) const
+{
+    return static_cast<size_t>(std::upper_bound(spendBounds_.begin(), spendBounds_.end(), cents) - spendBounds_.begin());
+}
+
+size_t SegmentIndex::recencyBucketOf(int32_t lastDay) const
+{
+    if (lastDay < 0)
+        return recencyBounds_.size() + 1;
+    auto days = std::max(today_ - lastDay, 0);
+    return static_cast<size_t>(std::lower_bound(recencyBounds_.begin(), recencyBounds_.end(), days) -
+                               recencyBounds_.begin());
+}
+
+int64_t SegmentIndex::windowSpend(const Member &member) const
+{
+    int64_t total = 0;
+    for (const auto &[day, cents] : member.daily)
+    {
+        if (day > today_ - windowDays_)
+            total += cents;
+    }
+    return total;
+}
+
+void SegmentIndex::list(uint32_t memberId, Member &member)
+{
+    member.listed = true;
+    member.spendBucket = spendBucketOf(windowSpend(member));
+    member.recencyBucket = recencyBucketOf(member.lastDay);
+    all_.add(memberId);
+    byLevel_[member.levelId].add(memberId);
+    byStatus_[member.status].add(memberId);
+    bySpend_[member.spendBucket].add(memberId);
+    byRecency_[member.recencyBucket].add(memberId);
+    for (size_t i = 0; i < byRfm_.size(); ++i)
+        byRfm_[i][member.rfm[i]].add(memberId);
+}
+
+void SegmentIndex::unlist(uint32_t memberId, const Member &member)
+{
+    if (!member.listed)
+        return;
+    all_.remove(memberId);
+    auto level = byLevel_.find(member.levelId);
+    level->second.remove(memberId);
+    if (level->second.empty())
+        byLevel_.erase(level);
+    auto status = byStatus_.find(member.status);
+    status->second.remove(memberId);
+    if (status->second.empty())
+        byStatus_.erase(status);
+    bySpend_[member.spendBucket].remove(memberId);
+    byRecency_[member.recencyBucket].remove(memberId);
+    for (size_t i = 0; i < byRfm_.size(); ++i)
+        byRfm_[i][member.rfm[i]].remove(memberId);
+}
+
+void SegmentIndex::rebucket(uint32_t memberId, Member &member)
+{
+    if (!member.listed)
+        return;
+    auto spend = spendBucketOf(windowSpend(member));
+    if (spend != member.spendBucket)
+    {
+        bySpend_[member.spendBucket].remove(memberId);
+        bySpend_[spend].add(memberId);
+        member.spendBucket = spend;
+    }
+    auto recency = recencyBucketOf(member.lastDay);
+    if (recency != member.recencyBucket)
+    {
+        byRecency_[member.recencyBucket].remove(memberId);
+        byRecency_[recency].add(memberId);
+        member.recencyBucket = recency;
+    }
+}
+
+void SegmentIndex::setMember(uint32_t memberId, uint32_t levelId, const std::string &status)
+{
+    auto &member = members_[memberId];
+    if (member.listed && member.levelId == levelId && member.status == status)
+        return;
+    unlist(memberId, member);
+    member.levelId = levelId;
+    member.status = status;
+    list(memberId, member);
+}
+
+void SegmentIndex::setLevel(uint32_t memberId, uint32_t levelId)
+{
+    auto it = members_.find(memberId);
+    if (it == members_.end() || !it->second.listed)
+        return;
+    setMember(memberId, levelId, it->second.status);
+}
+
+void SegmentIndex::setRfm(uint32_t memberId, const std::array<uint8_t, 3> &rfm)
+{
+    auto &member = members_[memberId];
+    for (size_t i = 0; i < rfm.size(); ++i)
+    {
+        auto score = rfm[i] < kScoreCount ? rfm[i] : 0;
+        if (score == member.rfm[i])
+            continue;
+        if (member.listed)
+        {
+            byRfm_[i][member.rfm[i]].remove(memberId);
+            byRfm_[i][score].add(memberId);
+        }
+        member.rfm[i] = static_cast<uint8_t>(score);
+    }
+}
+
+void SegmentIndex::removeMember(uint32_t memberId)
+{
+    auto it = members_.find(memberId);
+    if (it == members_.end())
+        return;
+    unlist(memberId, it->second);
+    members_.erase(it);
+}
+
+void SegmentIndex::addConsumption(uint32_t memberId, int32_t day, int64_t cents)
+{
+    if (day > today_)
+        advance(day);
+    auto &member = members_[memberId];
+    member.lastDay = std::max(member.lastDay, day);
+    if (day > today_ - windowDays_)
+    {
+        auto it = std::lower_bound(member.daily.begin(),
+                                   member.daily.end(),
+                                   day,
+                                   [](const std::pair<int32_t, int64_t> &entry, int32_t d) { return entry.first < d; });
+        if (it != member.daily.end() && it->first == day)
+            it->second += cents;
+        else
+            member.daily.insert(it, {day, cents});
+    }
+    rebucket(memberId, member);
+}
+
+void SegmentIndex::setDailySpend(uint32_t memberId, int32_t day, int64_t cents)
+{
+    auto &member = members_[memberId];
+    auto it = std::lower_bound(member.daily.begin(),
+                               member.daily.end(),
+                               day,
+                               [](const std::pair<int32_t, int64_t> &entry, int32_t d) { return entry.first < d; });
+    if (it != member.daily.end() && it->first == day)
+        it->second = cents;
+    else
+        member.daily.insert(it, {day, cents});
+    member.lastDay = std::max(member.lastDay, day);
+    rebucket(memberId, member);
+}
+
+void SegmentIndex::setLastVisit(uint32_t memberId, int32_t day)
+{
+    auto &member = members_[memberId];
+    member.lastDay = std::max(member.lastDay, day);
+    rebucket(memberId, member);
+}
+
+void SegmentIndex::advance(int32_t today)
+{
+    if (today <= today_)
+        return;
+    today_ = today;
+    // 每天一次全量换档，只涉及有过消费的会员
+    for (auto &[memberId, member] : members_)
+    {
+        if (member.lastDay < 0)
+            continue;
+        auto expired = std::find_if(member.daily.begin(),
+                                    member.daily.end(),
+                                    [this](const std::pair<int32_t, int64_t> &entry)
+                                    { return entry.first > today_ - windowDays_; });
+        member.daily.erase(member.daily.begin(), expired);
+        rebucket(memberId, member);
+    }
+}
+
+RoaringBitmap SegmentIndex::select(const Filter &filter) const
+{
+    RoaringBitmap result = all_;
+    auto narrow = [&result](const auto &index, const auto &keys)
+    {
+        if (keys.empty())
+            return;
+        RoaringBitmap any;
+        for (const auto &key : keys)
+        {
+            auto it = index.find(key);
+            if (it != index.end())
+                any |= it->second;
+        }
+        result &= any;
+    };
+    auto narrowBuckets = [&result](const std::vector<RoaringBitmap> &index, const std::vector<size_t> &buckets)
+    {
+        if (buckets.empty())
+            return;
+        RoaringBitmap any;
+        for (auto bucket : buckets)
+        {
+            if (bucket < index.size())
+                any |= index[bucket];
+        }
+        result &= any;
+    };
+    narrow(byLevel_, filter.levels);
+    narrow(byStatus_, filter.statuses);
+    narrowBuckets(bySpend_, filter.spendBuckets);
+    narrowBuckets(byRecency_, filter.recencyBuckets);
+    narrowBuckets(byRfm_[0], filter.recencyScores);
+    narrowBuckets(byRfm_[1], filter.frequencyScores);
+    narrowBuckets(byRfm_[2], filter.monetaryScores);
+    return result;
+}
+
+uint64_t SegmentIndex::count(const Filter &filter) const
+{
+    return select(filter).cardinality();
+}
+
+size_t SegmentIndex::memoryBytes() const
+{
+    size_t bytes = all_.memoryBytes();
+    for (const auto &[level, bitmap] : byLevel_)
+        bytes += bitmap.memoryBytes();
+    for (const auto &[status, bitmap] : byStatus_)
+        bytes += bitmap.memoryBytes();
+    for (const auto &bitmap : bySpend_)
+        bytes += bitmap.memoryBytes();
+    for (const auto &bitmap : byRecency_)
+        bytes += bitmap.memoryBytes();
+    for (const auto &scores : byRfm_)
+    {
+        for (const auto &bitmap : scores)
+            bytes += bitmap.memoryBytes();
+    }
+    return bytes;
+}
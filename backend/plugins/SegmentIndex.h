@@ -0,0 +1,105 @@
+/**
+ *
+ *  SegmentIndex.h
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "RoaringBitmap.h"
+
+/**
+ * @brief 单个租户的会员分群位图索引。
+ *
+ * 每个会员按等级、状态、近 window_days 天消费档、最近到店档各落入一张位图，分群查询是位图的交并。
+ * 消费档按 spendBounds（分）划分：bucket i 为 [bounds[i-1], bounds[i])；
+ * 到店档按 recencyBounds（天）划分：bucket i 为距最近消费不超过 bounds[i] 天，最后一档为从未消费。
+ * 另有 R、F、M 三项评分各一组位图，0 为未评分，1-5 由调用方算好后写入。
+ * 天数为本地日期距 1970-01-01 的天数，由调用方换算。
+ */
+class SegmentIndex
+{
+public:
+  SegmentIndex(std::vector<int64_t> spendBounds, std::vector<int32_t> recencyBounds, int32_t windowDays);
+
+  /// 新增或修改会员的等级和状态
+  void setMember(uint32_t memberId, uint32_t levelId, const std::string &status);
+  /// 只改已登记会员的等级，未登记时忽略
+  void setLevel(uint32_t memberId, uint32_t levelId);
+  void removeMember(uint32_t memberId);
+  /// 记一笔消费；早于窗口的只更新最近到店日
+  void addConsumption(uint32_t memberId, int32_t day, int64_t cents);
+  /// 用 day 天的消费汇总覆盖会员当天的消费额，载入时使用
+  void setDailySpend(uint32_t memberId, int32_t day, int64_t cents);
+  void setLastVisit(uint32_t memberId, int32_t day);
+  /// 日期前进到 today，滚出窗口的消费和到店天数变化引起的换档
+  void advance(int32_t today);
+
+  static constexpr size_t kScoreCount = 6;
+  /// 写入 R、F、M 评分，超出 1-5 的按未评分
+  void setRfm(uint32_t memberId, const std::array<uint8_t, 3> &rfm);
+
+  struct Filter
+  {
+    // 各维度之间取交集，维度内取并集，空表示不限
+    std::vector<uint32_t> levels;
+    std::vector<std::string> statuses;
+    std::vector<size_t> spendBuckets;
+    std::vector<size_t> recencyBuckets;
+    std::vector<size_t> recencyScores;
+    std::vector<size_t> frequencyScores;
+    std::vector<size_t> monetaryScores;
+  };
+  RoaringBitmap select(const Filter &filter) const;
+  uint64_t count(const Filter &filter) const;
+
+  size_t spendBucketOf(int64_t cents) const;
+  /// lastDay < 0 表示从未消费
+  size_t recencyBucketOf(int32_t lastDay) const;
+  size_t spendBucketCount() const { return spendBounds_.size() + 1; }
+  size_t recencyBucketCount() const { return recencyBounds_.size() + 2; }
+  const std::vector<int64_t> &spendBounds() const { return spendBounds_; }
+  const std::vector<int32_t> &recencyBounds() const { return recencyBounds_; }
+  size_t size() const { return all_.cardinality(); }
+  size_t memoryBytes() const;
+
+private:
+  struct Member
+  {
+    bool listed{false}; // 会员已登记，未登记时只积累消费
+    uint32_t levelId{0};
+    std::string status;
+    int32_t lastDay{-1};
+    size_t spendBucket{0};
+    size_t recencyBucket{0};
+    std::array<uint8_t, 3> rfm{0, 0, 0};
+    std::vector<std::pair<int32_t, int64_t>> daily; // 窗口内按天升序的消费额
+  };
+
+  void unlist(uint32_t memberId, const Member &member);
+  void list(uint32_t memberId, Member &member);
+  int64_t windowSpend(const Member &member) const;
+  /// 重新计算两个消费相关的档位，变化时移动位图
+  void rebucket(uint32_t memberId, Member &member);
+
+  std::vector<int64_t> spendBounds_;
+  std::vector<int32_t> recencyBounds_;
+  int32_t windowDays_;
+  int32_t today_{0};
+
+  std::unordered_map<uint32_t, Member> members_;
+  RoaringBitmap all_;
+  std::map<uint32_t, RoaringBitmap> byLevel_;
+  std::map<std::string, RoaringBitmap> byStatus_;
+  std::vector<RoaringBitmap> bySpend_;
+  std::vector<RoaringBitmap> byRecency_;
+  std::array<std::vector<RoaringBitmap>, 3> byRfm_;
+};
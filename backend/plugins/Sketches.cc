@@ -0,0 +1,294 @@
+/**
+ *
+ *  Sketches.cc
+ *
+ */
+
+#include "Sketches.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+// splitmix64 的混合函数，把连续的 ID 打散到 64 位
+uint64_t mix(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+const char kSparse = 'S';
+const char kDense = 'D';
+} // namespace
+
+void HyperLogLog::add(uint64_t key)
+{
+    if (registers_.empty())
+        registers_.assign(kRegisters, 0);
+    auto hash = mix(key);
+    auto index = hash >> (64 - kPrecision);
+    auto rest = hash << kPrecision;
+    // rest 为 0 时前导零个数取最大值 64 - p
+    uint8_t rank = rest == 0 ? 64 - kPrecision + 1 : static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+    if (rank > registers_[index])
+        registers_[index] = rank;
+}
+
+void HyperLogLog::merge(const HyperLogLog &other)
+{
+    if (other.registers_.empty())
+        return;
+    if (registers_.empty())
+    {
+        registers_ = other.registers_;
+        return;
+    }
+    for (size_t i = 0; i < kRegisters; ++i)
+        registers_[i] = std::max(registers_[i], other.registers_[i]);
+}
+
+double HyperLogLog::estimate() const
+{
+    if (registers_.empty())
+        return 0;
+    const double m = static_cast<double>(kRegisters);
+    double sum = 0;
+    size_t zeros = 0;
+    for (auto r : registers_)
+    {
+        sum += std::ldexp(1.0, -r);
+        zeros += r == 0;
+    }
+    double alpha = 0.7213 / (1 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+    // 小基数时用线性计数修正
+    if (estimate <= 2.5 * m && zeros > 0)
+        estimate = m * std::log(m / static_cast<double>(zeros));
+    return estimate;
+}
+
+double HyperLogLog::standardError()
+{
+    return 1.04 / std::sqrt(static_cast<double>(kRegisters));
+}
+
+std::string HyperLogLog::serialize() const
+{
+    std::string bytes;
+    size_t nonZero = 0;
+    for (auto r : registers_)
+        nonZero += r != 0;
+    if (nonZero * 3 < kRegisters)
+    {
+        bytes.reserve(1 + nonZero * 3);
+        bytes.push_back(kSparse);
+        for (size_t i = 0; i < registers_.size(); ++i)
+        {
+            if (registers_[i] == 0)
+                continue;
+            bytes.push_back(static_cast<char>(i & 0xff));
+            bytes.push_back(static_cast<char>(i >> 8));
+            bytes.push_back(static_cast<char>(registers_[i]));
+        }
+        return bytes;
+    }
+    bytes.reserve(1 + kRegisters);
+    bytes.push_back(kDense);
+    bytes.append(registers_.begin(), registers_.end());
+    return bytes;
+}
+
+bool HyperLogLog::deserialize(const std::string &bytes)
+{
+    registers_.clear();
+    if (bytes.empty())
+        return true;
+    if (bytes[0] == kDense)
+    {
+        if (bytes.size() != 1 + kRegisters)
+            return false;
+        registers_.assign(bytes.begin() + 1, bytes.end());
+        return true;
+    }
+    if (bytes[0] != kSparse || (bytes.size() - 1) % 3 != 0)
+        return false;
+    if (bytes.size() == 1)
+        return true;
+    registers_.assign(kRegisters, 0);
+    for (size_t i = 1; i < bytes.size(); i += 3)
+    {
+        size_t index = static_cast<uint8_t>(bytes[i]) | (static_cast<size_t>(static_cast<uint8_t>(bytes[i + 1])) << 8);
+        if (index >= kRegisters)
+        {
+            registers_.clear();
+            return false;
+        }
+        registers_[index] = static_cast<uint8_t>(bytes[i + 2]);
+    }
+    return true;
+}
+
+uint64_t SpaceSaving::floor() const
+{
+    if (counters_.size() < capacity_)
+        return 0;
+    uint64_t minimum = UINT64_MAX;
+    for (const auto &[key, counter] : counters_)
+        minimum = std::min(minimum, counter.count);
+    return minimum;
+}
+
+uint64_t SpaceSaving::maxError() const
+{
+    uint64_t error = 0;
+    for (const auto &[key, counter] : counters_)
+        error = std::max(error, counter.error);
+    return error;
+}
+
+void SpaceSaving::add(uint32_t key, uint64_t weight)
+{
+    total_ += weight;
+    auto it = counters_.find(key);
+    if (it != counters_.end())
+    {
+        it->second.count += weight;
+        return;
+    }
+    if (counters_.size() < capacity_)
+    {
+        counters_.emplace(key, Counter{key, weight, 0});
+        return;
+    }
+    // 替换计数最小的项，新项继承其计数作为误差
+    auto victim = counters_.begin();
+    for (auto c = counters_.begin(); c != counters_.end(); ++c)
+    {
+        if (c->second.count < victim->second.count)
+            victim = c;
+    }
+    Counter counter{key, victim->second.count + weight, victim->second.count};
+    counters_.erase(victim);
+    counters_.emplace(key, counter);
+}
+
+void SpaceSaving::merge(const SpaceSaving &other)
+{
+    // 一方缺失的项按该方的最小计数补齐，再保留计数最大的 capacity 项
+    auto ownFloor = floor();
+    auto otherFloor = other.floor();
+    std::unordered_map<uint32_t, Counter> merged;
+    for (const auto &[key, counter] : counters_)
+    {
+        auto it = other.counters_.find(key);
+        Counter c = counter;
+        if (it != other.counters_.end())
+        {
+            c.count += it->second.count;
+            c.error += it->second.error;
+        }
+        else
+        {
+            c.count += otherFloor;
+            c.error += otherFloor;
+        }
+        merged.emplace(key, c);
+    }
+    for (const auto &[key, counter] : other.counters_)
+    {
+        if (merged.count(key))
+            continue;
+        Counter c = counter;
+        c.count += ownFloor;
+        c.error += ownFloor;
+        merged.emplace(key, c);
+    }
+
+    total_ += other.total_;
+    capacity_ = std::max(capacity_, other.capacity_);
+    if (merged.size() > capacity_)
+    {
+        std::vector<Counter> sorted;
+        sorted.reserve(merged.size());
+        for (const auto &[key, counter] : merged)
+            sorted.push_back(counter);
+        std::nth_element(sorted.begin(), sorted.begin() + capacity_, sorted.end(),
+                         [](const Counter &a, const Counter &b) { return a.count > b.count; });
+        sorted.resize(capacity_);
+        merged.clear();
+        for (const auto &counter : sorted)
+            merged.emplace(counter.key, counter);
+    }
+    counters_ = std::move(merged);
+}
+
+std::vector<SpaceSaving::Counter> SpaceSaving::top(size_t k) const
+{
+    std::vector<Counter> sorted;
+    sorted.reserve(counters_.size());
+    for (const auto &[key, counter] : counters_)
+        sorted.push_back(counter);
+    std::sort(sorted.begin(),
+              sorted.end(),
+              [](const Counter &a, const Counter &b) { return a.count != b.count ? a.count > b.count : a.key < b.key; });
+    if (sorted.size() > k)
+        sorted.resize(k);
+    return sorted;
+}
+
+std::string SpaceSaving::serialize() const
+{
+    std::string text = std::to_string(capacity_) + ";" + std::to_string(total_) + ";";
+    bool first = true;
+    for (const auto &counter : top(counters_.size()))
+    {
+        if (!first)
+            text += ",";
+        first = false;
+        text += std::to_string(counter.key) + ":" + std::to_string(counter.count) + ":" + std::to_string(counter.error);
+    }
+    return text;
+}
+
+bool SpaceSaving::deserialize(const std::string &text)
+{
+    counters_.clear();
+    total_ = 0;
+    if (text.empty())
+        return true;
+    const char *p = text.c_str();
+    char *end = nullptr;
+    auto capacity = std::strtoull(p, &end, 10);
+    if (end == p || *end != ';' || capacity == 0)
+        return false;
+    p = end + 1;
+    auto total = std::strtoull(p, &end, 10);
+    if (end == p || *end != ';')
+        return false;
+    p = end + 1;
+    std::unordered_map<uint32_t, Counter> counters;
+    while (*p)
+    {
+        Counter counter;
+        counter.key = static_cast<uint32_t>(std::strtoul(p, &end, 10));
+        if (end == p || *end != ':')
+            return false;
+        p = end + 1;
+        counter.count = std::strtoull(p, &end, 10);
+        if (end == p || *end != ':')
+            return false;
+        p = end + 1;
+        counter.error = std::strtoull(p, &end, 10);
+        if (end == p || (*end != ',' && *end != '\0'))
+            return false;
+        p = *end == ',' ? end + 1 : end;
+        counters.emplace(counter.key, counter);
+    }
+    capacity_ = static_cast<size_t>(capacity);
+    total_ = total;
+    counters_ = std::move(counters);
+    return true;
+}
@@ -0,0 +1,83 @@
+/**
+ *
+ *  Sketches.h
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief HyperLogLog 基数估计，2^12 个寄存器，标准误差约 1.04 / sqrt(4096) ≈ 1.6%。
+ *
+ * 同精度的草图可任意合并（逐寄存器取最大值），合并结果等价于对并集计数。
+ * 序列化时寄存器较少时用稀疏格式（每个非零寄存器 3 字节），否则用 4096 字节的稠密格式。
+ */
+class HyperLogLog
+{
+public:
+  static constexpr uint8_t kPrecision = 12;
+  static constexpr size_t kRegisters = size_t(1) << kPrecision;
+
+  /// 加入一个 64 位键，内部再做一次混合
+  void add(uint64_t key);
+  void merge(const HyperLogLog &other);
+  double estimate() const;
+  bool empty() const { return registers_.empty(); }
+
+  /// 估计值的相对标准误差
+  static double standardError();
+
+  std::string serialize() const;
+  /// 格式错误时返回 false，草图保持为空
+  bool deserialize(const std::string &bytes);
+
+private:
+  std::vector<uint8_t> registers_; // 为空表示没有加入过任何键
+};
+
+/**
+ * @brief Space-Saving 热门项草图，最多保留 capacity 个计数器。
+ *
+ * 每个计数器的计数不小于真实值，且高估量不超过 error，error <= total / capacity。
+ * 真实计数超过 total / capacity 的项一定在草图中。按 Agarwal 等人的方法合并，误差界保持不变。
+ */
+class SpaceSaving
+{
+public:
+  struct Counter
+  {
+    uint32_t key{0};
+    uint64_t count{0};
+    uint64_t error{0}; // 计数的最大高估量
+  };
+
+  explicit SpaceSaving(size_t capacity = 64) : capacity_(capacity) {}
+
+  void add(uint32_t key, uint64_t weight = 1);
+  void merge(const SpaceSaving &other);
+  /// 按计数从大到小返回前 k 项
+  std::vector<Counter> top(size_t k) const;
+
+  uint64_t total() const { return total_; }
+  size_t capacity() const { return capacity_; }
+  /// 任一计数的高估上界
+  uint64_t maxError() const;
+
+  /// 文本格式：capacity;total;key:count:error,...
+  std::string serialize() const;
+  bool deserialize(const std::string &text);
+
+private:
+  /// 草图满时未出现的项的计数上界
+  uint64_t floor() const;
+
+  size_t capacity_;
+  uint64_t total_{0};
+  std::unordered_map<uint32_t, Counter> counters_;
+};
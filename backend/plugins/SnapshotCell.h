@@ -0,0 +1,78 @@
+/**
+ *
+ *  SnapshotCell.h
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief 不可变快照的发布点（RCU）：写者构造新版本后原子替换，读者不加锁。
+ *
+ * 读者各自持有 Reader（通常是 thread_local），只在版本号变化时重新取一次 shared_ptr，
+ * 其余时候只读一个原子计数，不改动共享的引用计数，多线程读取互不争用缓存行。
+ * 旧版本在最后一个持有它的读者换到新版本后自动释放；闲置线程最多多留一个旧版本。
+ * 写者之间的互斥由调用方负责。
+ */
+template <typename T>
+class SnapshotCell
+{
+public:
+  using Ptr = std::shared_ptr<const T>;
+
+  void publish(Ptr next)
+  {
+#if defined(__cpp_lib_atomic_shared_ptr)
+    current_.store(std::move(next), std::memory_order_release);
+#else
+    std::atomic_store_explicit(&current_, std::move(next), std::memory_order_release);
+#endif
+    version_.fetch_add(1, std::memory_order_release);
+  }
+
+  Ptr load() const
+  {
+#if defined(__cpp_lib_atomic_shared_ptr)
+    return current_.load(std::memory_order_acquire);
+#else
+    return std::atomic_load_explicit(&current_, std::memory_order_acquire);
+#endif
+  }
+
+  uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
+  class Reader
+  {
+  public:
+    /// 当前版本，返回的指针在本读者下一次 get 之前有效
+    const T *get(const SnapshotCell &cell)
+    {
+      auto version = cell.version();
+      if (cell_ != &cell || version != version_)
+      {
+        // 先读版本号再取指针：取到的不会比版本号旧，最坏多刷新一次
+        pinned_ = cell.load();
+        version_ = version;
+        cell_ = &cell;
+      }
+      return pinned_.get();
+    }
+
+  private:
+    const SnapshotCell *cell_{nullptr};
+    uint64_t version_{0};
+    Ptr pinned_;
+  };
+
+private:
+#if defined(__cpp_lib_atomic_shared_ptr)
+  std::atomic<Ptr> current_;
+#else
+  Ptr current_;
+#endif
+  std::atomic<uint64_t> version_{0};
+};
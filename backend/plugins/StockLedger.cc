@@ -0,0 +1,203 @@
+/**
+ *
+ *  StockLedger.cc
+ *
+ */
+
+#include "StockLedger.h"
+#include <algorithm>
+
+void StockLedger::open(int64_t quantity)
+{
+    entries_.clear();
+    snapshots_.assign(1, Snapshot{0, 0, quantity, 0});
+}
+
+void StockLedger::assign(std::vector<Entry> entries)
+{
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.recordId < b.recordId; });
+    entries.erase(std::unique(entries.begin(),
+                              entries.end(),
+                              [](const Entry &a, const Entry &b) { return a.recordId == b.recordId; }),
+                  entries.end());
+    for (size_t i = 1; i < entries.size(); ++i)
+        entries[i].at = std::max(entries[i].at, entries[i - 1].at);
+    entries_ = std::move(entries);
+    if (snapshots_.size() > 1)
+        snapshots_.resize(1);
+}
+
+bool StockLedger::restore(int64_t at, uint32_t lastRecordId, int64_t quantity)
+{
+    Snapshot snapshot{at, lastRecordId, quantity, 0};
+    snapshot.entryCount = lastRecordId == 0 ? 0 : lowerBound(lastRecordId + 1);
+    if (!snapshots_.empty() && (snapshots_.back().lastRecordId > lastRecordId || snapshots_.back().at > at ||
+                                snapshots_.back().entryCount > snapshot.entryCount))
+        return false;
+    // 同一位置的旧快照以后写的为准
+    if (!snapshots_.empty() && snapshots_.back().entryCount == snapshot.entryCount)
+        snapshots_.back() = snapshot;
+    else
+        snapshots_.push_back(snapshot);
+    return true;
+}
+
+bool StockLedger::ensureOpening(int64_t currentQuantity, Snapshot &opening)
+{
+    if (!snapshots_.empty() && snapshots_.front().entryCount == 0)
+        return false;
+    opening = Snapshot{0, 0, 0, 0};
+    bool created = snapshots_.empty();
+    if (created)
+    {
+        // 首次启用：以当前数量倒推期初数量
+        opening.quantity = currentQuantity;
+        for (const auto &entry : entries_)
+            opening.quantity -= entry.delta;
+    }
+    else
+    {
+        const auto &first = snapshots_.front();
+        opening.quantity = first.quantity;
+        for (size_t i = 0; i < first.entryCount; ++i)
+            opening.quantity -= entries_[i].delta;
+    }
+    snapshots_.insert(snapshots_.begin(), opening);
+    return created;
+}
+
+size_t StockLedger::verify(uint32_t &firstRecordId)
+{
+    if (snapshots_.empty())
+        return 0;
+    int64_t quantity = snapshots_.front().quantity;
+    size_t counted = 0;
+    for (size_t i = 1; i < snapshots_.size(); ++i)
+    {
+        for (; counted < snapshots_[i].entryCount; ++counted)
+            quantity += entries_[counted].delta;
+        if (snapshots_[i].quantity != quantity)
+        {
+            firstRecordId = snapshots_[i].lastRecordId;
+            auto dropped = snapshots_.size() - i;
+            snapshots_.resize(i);
+            return dropped;
+        }
+    }
+    return 0;
+}
+
+bool StockLedger::insert(Entry entry, size_t &dropped)
+{
+    dropped = 0;
+    auto position = lowerBound(entry.recordId);
+    if (position < entries_.size() && entries_[position].recordId == entry.recordId)
+        return false;
+    if (position > 0)
+        entry.at = std::max(entry.at, entries_[position - 1].at);
+    if (position < entries_.size())
+        entry.at = std::min(entry.at, entries_[position].at);
+    entries_.insert(entries_.begin() + static_cast<std::ptrdiff_t>(position), entry);
+    // 快照已包含的流水之前插入了新流水，快照数量不再成立
+    while (snapshots_.size() > 1 && snapshots_.back().entryCount > position)
+    {
+        snapshots_.pop_back();
+        ++dropped;
+    }
+    return true;
+}
+
+bool StockLedger::contains(uint32_t recordId) const
+{
+    auto position = lowerBound(recordId);
+    return position < entries_.size() && entries_[position].recordId == recordId;
+}
+
+int64_t StockLedger::current() const
+{
+    if (snapshots_.empty())
+        return 0;
+    const auto &snapshot = snapshots_.back();
+    int64_t quantity = snapshot.quantity;
+    for (size_t i = snapshot.entryCount; i < entries_.size(); ++i)
+        quantity += entries_[i].delta;
+    return quantity;
+}
+
+int64_t StockLedger::quantityAt(int64_t at) const
+{
+    if (snapshots_.empty())
+        return 0;
+    const auto &snapshot = snapshots_[snapshotBefore(at)];
+    int64_t quantity = snapshot.quantity;
+    for (size_t i = snapshot.entryCount; i < entries_.size() && entries_[i].at <= at; ++i)
+        quantity += entries_[i].delta;
+    return quantity;
+}
+
+int64_t StockLedger::balanceBefore(size_t index) const
+{
+    if (snapshots_.empty())
+        return 0;
+    // 从不晚于 index 的最近快照开始累加
+    auto snapshot = std::upper_bound(snapshots_.begin(),
+                                     snapshots_.end(),
+                                     index,
+                                     [](size_t count, const Snapshot &s) { return count < s.entryCount; }) -
+                    1;
+    int64_t balance = snapshot->quantity;
+    for (size_t i = snapshot->entryCount; i < index; ++i)
+        balance += entries_[i].delta;
+    return balance;
+}
+
+std::pair<size_t, size_t> StockLedger::range(int64_t from, int64_t to) const
+{
+    auto first = std::lower_bound(entries_.begin(), entries_.end(), from, [](const Entry &e, int64_t at) { return e.at < at; });
+    auto last = std::upper_bound(entries_.begin(), entries_.end(), to, [](int64_t at, const Entry &e) { return at < e.at; });
+    if (last < first)
+        last = first;
+    return {static_cast<size_t>(first - entries_.begin()), static_cast<size_t>(last - entries_.begin())};
+}
+
+bool StockLedger::takeSnapshot(size_t minDeltas, Snapshot &snapshot)
+{
+    if (snapshots_.empty())
+        return false;
+    auto newDeltas = entries_.size() - snapshots_.back().entryCount;
+    if (newDeltas == 0 || newDeltas < minDeltas)
+        return false;
+    const auto &last = entries_.back();
+    // 压缩后晚到的流水编号可能小于基准，快照编号不能回退
+    snapshot = Snapshot{last.at, std::max(last.recordId, snapshots_.back().lastRecordId), current(), entries_.size()};
+    snapshots_.push_back(snapshot);
+    return true;
+}
+
+void StockLedger::compact()
+{
+    if (snapshots_.empty())
+        return;
+    auto base = snapshots_.back();
+    entries_.erase(entries_.begin(), entries_.begin() + static_cast<std::ptrdiff_t>(base.entryCount));
+    base.entryCount = 0;
+    snapshots_.assign(1, base);
+}
+
+size_t StockLedger::snapshotBefore(int64_t at) const
+{
+    auto it = std::upper_bound(snapshots_.begin(), snapshots_.end(), at, [](int64_t t, const Snapshot &s) { return t < s.at; });
+    if (it == snapshots_.begin())
+        return 0;
+    return static_cast<size_t>(it - snapshots_.begin()) - 1;
+}
+
+size_t StockLedger::lowerBound(uint32_t recordId) const
+{
+    return static_cast<size_t>(
+        std::lower_bound(entries_.begin(),
+                         entries_.end(),
+                         recordId,
+                         [](const Entry &e, uint32_t id) { return e.recordId < id; }) -
+        entries_.begin());
+}
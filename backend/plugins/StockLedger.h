@@ -0,0 +1,80 @@
+/**
+ *
+ *  StockLedger.h
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 单个物料的流水账：按 record_id 有序的数量增量和若干快照。
+ *
+ * 流水插入到 record_id 的有序位置，写库回调乱序到达时二分查找依然成立。
+ * 时刻按 record_id 顺序取不减的值：晚到的流水时刻夹在前后两条之间。
+ * 快照记录截至某条流水（含）的数量；插入更早的流水会使其后的快照失效并被丢弃，期初快照始终保留。
+ * 压缩后最新的快照成为第一个快照（基准），之前的流水不再保存，早于基准的时刻须另行查询。
+ * 不加锁，由调用方保证互斥。
+ */
+class StockLedger
+{
+public:
+  struct Entry
+  {
+    uint32_t recordId{0};
+    int64_t at{0}; // 微秒时间戳
+    int64_t delta{0};
+  };
+  struct Snapshot
+  {
+    int64_t at{0};
+    uint32_t lastRecordId{0};
+    int64_t quantity{0};
+    size_t entryCount{0}; // 快照已包含的流水条数
+  };
+
+  /// 清空流水，只留期初数量
+  void open(int64_t quantity);
+  bool opened() const { return !snapshots_.empty(); }
+  /// 替换全部流水（可无序），只保留期初快照
+  void assign(std::vector<Entry> entries);
+  /// 装载已持久化的快照，须按 lastRecordId 升序调用；与已有快照次序不符时忽略并返回 false
+  bool restore(int64_t at, uint32_t lastRecordId, int64_t quantity);
+  /// 补齐期初快照：没有任何快照时按当前数量倒推并返回 true（调用方持久化）
+  bool ensureOpening(int64_t currentQuantity, Snapshot &opening);
+  /// 丢弃与期初加流水不符的快照（写库先后错乱留下的），返回丢弃的个数，
+  /// firstRecordId 为第一个被丢弃快照的 lastRecordId
+  size_t verify(uint32_t &firstRecordId);
+
+  /// 插入一条流水，record_id 已存在时返回 false；
+  /// 有快照因此失效时 dropped 为丢弃的个数，失效的是 lastRecordId 大于该流水的快照
+  bool insert(Entry entry, size_t &dropped);
+  bool contains(uint32_t recordId) const;
+
+  int64_t current() const;
+  /// 指定时刻（含）的数量
+  int64_t quantityAt(int64_t at) const;
+  /// 第 index 条流水生效前的数量
+  int64_t balanceBefore(size_t index) const;
+  /// 时刻落在 [from, to] 内的流水下标区间 [first, last)
+  std::pair<size_t, size_t> range(int64_t from, int64_t to) const;
+
+  /// 自上个快照以来至少有 minDeltas 条新流水时追加快照
+  bool takeSnapshot(size_t minDeltas, Snapshot &snapshot);
+  /// 丢弃最新快照已包含的流水和更早的快照，最新快照成为基准
+  void compact();
+
+  const std::vector<Entry> &entries() const { return entries_; }
+  const std::vector<Snapshot> &snapshots() const { return snapshots_; }
+
+private:
+  size_t snapshotBefore(int64_t at) const;
+  size_t lowerBound(uint32_t recordId) const;
+
+  std::vector<Entry> entries_;     // 按 record_id 升序，at 不减
+  std::vector<Snapshot> snapshots_; // 按 lastRecordId 升序，第一个为期初或压缩后的基准
+};
@@ -0,0 +1,240 @@
+/**
+ *
+ *  StockWarningEngine.cc
+ *
+ */
+
+#include "StockWarningEngine.h"
+#include "InventoryLedger.h"
+#include "Inventory.h"
+#include <drogon/drogon.h>
+
+using namespace drogon;
+using namespace drogon::orm;
+using namespace drogon_model::saas_restaurant;
+
+void StockWarningEngine::initAndStart(const Json::Value &config)
+{
+    dbClient_ = app().getDbClient(config.get("db_client", "default").asString());
+    auto ledger = app().getPlugin<InventoryLedger>();
+
+    try
+    {
+        auto now = trantor::Date::now().microSecondsSinceEpoch();
+        auto inventories = Mapper<Inventory>(dbClient_).findBy(
+            Criteria(Inventory::Cols::_is_deleted, CompareOperator::EQ, 0) ||
+            Criteria(Inventory::Cols::_is_deleted, CompareOperator::IsNull));
+        for (auto &inventory : inventories)
+        {
+            auto itemId = inventory.getValueOfInventoryId();
+            auto quantity = ledger->quantityOf(itemId);
+            index_.setItem(inventory.getValueOfTenantId(),
+                           itemId,
+                           inventory.getValueOfItemName(),
+                           inventory.getValueOfMinStock(),
+                           inventory.getValueOfMaxStock(),
+                           quantity,
+                           now);
+            {
+                std::lock_guard<std::mutex> lock(statusMutex_);
+                statuses_[itemId] = inventory.getValueOfStatus();
+            }
+            // 启动时只修正与阈值不符的状态
+            syncStatus(itemId,
+                       StockWarningIndex::classify(quantity, inventory.getValueOfMinStock(), inventory.getValueOfMaxStock()));
+        }
+        LOG_INFO << "Stock warning engine loaded " << inventories.size() << " items";
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to load stock warning thresholds: " << e.base().what();
+    }
+
+    // 每次库存变动只判断被改动的物料
+    ledger->addListener([this](uint32_t tenantId, uint32_t itemId, int64_t quantity)
+                        {
+        auto event = index_.evaluate(tenantId, itemId, quantity, trantor::Date::now().microSecondsSinceEpoch());
+        if (event)
+            publish(*event, true); });
+}
+
+void StockWarningEngine::shutdown()
+{
+    std::lock_guard<std::mutex> lock(connMutex_);
+    connections_.clear();
+}
+
+void StockWarningEngine::refreshItem(uint32_t itemId)
+{
+    Mapper<Inventory> mapper(dbClient_);
+    mapper.findByPrimaryKey(
+        itemId,
+        [this](const Inventory &inventory)
+        {
+            auto now = trantor::Date::now().microSecondsSinceEpoch();
+            std::optional<StockWarningIndex::Event> event;
+            auto itemId = inventory.getValueOfInventoryId();
+            if (inventory.getValueOfIsDeleted())
+            {
+                {
+                    std::lock_guard<std::mutex> lock(statusMutex_);
+                    statuses_.erase(itemId);
+                }
+                event = index_.removeItem(inventory.getValueOfTenantId(), itemId, now);
+                if (event)
+                    publish(*event, false);
+                return;
+            }
+            {
+                // 刚读到的行即库中状态，接口可能直接改过 status
+                std::lock_guard<std::mutex> lock(statusMutex_);
+                statuses_[itemId] = inventory.getValueOfStatus();
+            }
+            auto quantity = app().getPlugin<InventoryLedger>()->quantityOf(itemId);
+            event = index_.setItem(inventory.getValueOfTenantId(),
+                                   itemId,
+                                   inventory.getValueOfItemName(),
+                                   inventory.getValueOfMinStock(),
+                                   inventory.getValueOfMaxStock(),
+                                   quantity,
+                                   now);
+            syncStatus(itemId,
+                       StockWarningIndex::classify(quantity, inventory.getValueOfMinStock(), inventory.getValueOfMaxStock()));
+            if (event)
+                publish(*event, false);
+        },
+        [this, itemId](const DrogonDbException &e)
+        {
+            if (dynamic_cast<const UnexpectedRows *>(&e.base()))
+            {
+                // 物料已被物理删除
+                removeItem(0, itemId);
+                return;
+            }
+            LOG_ERROR << "Failed to refresh stock warning of item " << itemId << ": " << e.base().what();
+        });
+}
+
+void StockWarningEngine::removeItem(uint32_t tenantId, uint32_t itemId)
+{
+    {
+        std::lock_guard<std::mutex> lock(statusMutex_);
+        statuses_.erase(itemId);
+    }
+    auto event = index_.removeItem(tenantId, itemId, trantor::Date::now().microSecondsSinceEpoch());
+    if (event)
+        publish(*event, false);
+}
+
+Json::Value StockWarningEngine::toJson(const StockWarningIndex::Warning &warning)
+{
+    Json::Value ret;
+    ret["id"] = (Json::UInt64)warning.id;
+    ret["tenant_id"] = warning.tenantId;
+    ret["item_id"] = warning.itemId;
+    ret["item_name"] = warning.itemName;
+    ret["level"] = StockWarningIndex::levelName(warning.level);
+    ret["title"] = std::string("库存") + StockWarningIndex::statusName(warning.level) + "：" + warning.itemName;
+    ret["description"] = "当前库存 " + std::to_string(warning.quantity) +
+                         "，最小值 " + std::to_string(warning.minStock) +
+                         "，最大值 " + std::to_string(warning.maxStock);
+    ret["quantity"] = (Json::Int64)warning.quantity;
+    ret["min_stock"] = warning.minStock;
+    ret["max_stock"] = warning.maxStock;
+    ret["timestamp"] = trantor::Date(warning.raisedAt).toDbStringLocal();
+    if (warning.resolvedAt == 0)
+    {
+        ret["status"] = "ACTIVE";
+        ret["resolved_at"] = Json::Value::null;
+    }
+    else
+    {
+        ret["status"] = "RESOLVED";
+        ret["resolved_at"] = trantor::Date(warning.resolvedAt).toDbStringLocal();
+    }
+    return ret;
+}
+
+void StockWarningEngine::subscribe(uint32_t tenantId, const WebSocketConnectionPtr &conn)
+{
+    conn->setContext(std::make_shared<uint32_t>(tenantId));
+    std::lock_guard<std::mutex> lock(connMutex_);
+    connections_[tenantId].insert(conn);
+}
+
+void StockWarningEngine::unsubscribe(const WebSocketConnectionPtr &conn)
+{
+    auto tenantId = conn->getContext<uint32_t>();
+    if (!tenantId)
+        return;
+    std::lock_guard<std::mutex> lock(connMutex_);
+    auto it = connections_.find(*tenantId);
+    if (it == connections_.end())
+        return;
+    it->second.erase(conn);
+    if (it->second.empty())
+        connections_.erase(it);
+}
+
+void StockWarningEngine::syncStatus(uint32_t itemId, StockWarningIndex::Level level)
+{
+    std::string status = StockWarningIndex::statusName(level);
+    {
+        std::lock_guard<std::mutex> lock(statusMutex_);
+        auto &cached = statuses_[itemId];
+        if (cached == status)
+            return;
+        cached = status;
+    }
+    dbClient_->execSqlAsync(
+        "update inventory set status = ? where inventory_id = ?",
+        [](const Result &) {},
+        [this, itemId](const DrogonDbException &e)
+        {
+            LOG_ERROR << "Failed to update status of item " << itemId << ": " << e.base().what();
+            // 写失败时忘掉缓存，下次变化重写
+            std::lock_guard<std::mutex> lock(statusMutex_);
+            statuses_.erase(itemId);
+        },
+        status,
+        itemId);
+}
+
+void StockWarningEngine::publish(const StockWarningIndex::Event &event, bool persistStatus)
+{
+    const auto &warning = event.warning;
+    if (persistStatus)
+    {
+        // 同步库存状态，前端列表直接使用
+        syncStatus(warning.itemId,
+                   event.kind == StockWarningIndex::Event::Kind::Resolved ? StockWarningIndex::Level::None
+                                                                          : warning.level);
+    }
+
+    Json::Value message;
+    switch (event.kind)
+    {
+    case StockWarningIndex::Event::Kind::Raised:
+        message["type"] = "raised";
+        break;
+    case StockWarningIndex::Event::Kind::Changed:
+        message["type"] = "changed";
+        break;
+    case StockWarningIndex::Event::Kind::Resolved:
+        message["type"] = "resolved";
+        break;
+    }
+    message["data"] = toJson(warning);
+    auto payload = message.toStyledString();
+
+    // 系统管理员以租户 0 订阅全部预警
+    std::lock_guard<std::mutex> lock(connMutex_);
+    for (auto tenantId : {warning.tenantId, 0u})
+    {
+        auto it = connections_.find(tenantId);
+        if (it == connections_.end())
+            continue;
+        for (auto &conn : it->second)
+            conn->send(payload);
+    }
+}
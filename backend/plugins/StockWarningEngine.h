@@ -0,0 +1,64 @@
+/**
+ *
+ *  StockWarningEngine.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/WebSocketConnection.h>
+#include <drogon/orm/DbClient.h>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+#include "StockWarningIndex.h"
+
+/**
+ * @brief 库存预警引擎。
+ *
+ * 订阅 InventoryLedger 的数量变化，只对被改动的物料重新判断阈值；
+ * 预警变化且与库中状态不同时回写 inventory.status，并推送给该租户已连接的 WebSocket 客户端。
+ */
+class StockWarningEngine : public drogon::Plugin<StockWarningEngine>
+{
+public:
+  StockWarningEngine() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  /// 物料新增或修改后，从数据库重新读取阈值
+  void refreshItem(uint32_t itemId);
+  /// 物料被删除，tenantId 为 0 时按物料查找租户
+  void removeItem(uint32_t tenantId, uint32_t itemId);
+
+  const StockWarningIndex &index() const
+  {
+    return index_;
+  }
+  static Json::Value toJson(const StockWarningIndex::Warning &warning);
+
+  void subscribe(uint32_t tenantId, const drogon::WebSocketConnectionPtr &conn);
+  void unsubscribe(const drogon::WebSocketConnectionPtr &conn);
+
+private:
+  void publish(const StockWarningIndex::Event &event, bool persistStatus);
+  /// 按预警等级回写 inventory.status，与库中已有的状态相同时不写
+  void syncStatus(uint32_t itemId, StockWarningIndex::Level level);
+
+  drogon::orm::DbClientPtr dbClient_;
+  StockWarningIndex index_;
+
+  std::mutex statusMutex_;
+  std::unordered_map<uint32_t, std::string> statuses_; // 物料ID -> 库中的 inventory.status
+
+  std::mutex connMutex_;
+  std::unordered_map<uint32_t, std::set<drogon::WebSocketConnectionPtr>> connections_;
+};
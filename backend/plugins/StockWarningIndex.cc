@@ -0,0 +1,220 @@
+/**
+ *
+ *  StockWarningIndex.cc
+ *
+ */
+
+#include "StockWarningIndex.h"
+
+StockWarningIndex::Level StockWarningIndex::classify(int64_t quantity, int32_t minStock, int32_t maxStock)
+{
+    // 与前端 calculateStatus 规则一致：不高于最小值的 30% 为紧缺
+    if (quantity * 10 <= static_cast<int64_t>(minStock) * 3)
+        return Level::High;
+    if (quantity <= minStock)
+        return Level::Medium;
+    if (maxStock > 0 && quantity >= maxStock)
+        return Level::Low;
+    return Level::None;
+}
+
+const char *StockWarningIndex::levelName(Level level)
+{
+    switch (level)
+    {
+    case Level::High:
+        return "HIGH";
+    case Level::Medium:
+        return "MEDIUM";
+    case Level::Low:
+        return "LOW";
+    default:
+        return "NONE";
+    }
+}
+
+const char *StockWarningIndex::statusName(Level level)
+{
+    switch (level)
+    {
+    case Level::High:
+        return "紧缺";
+    case Level::Medium:
+        return "偏低";
+    case Level::Low:
+        return "过剩";
+    default:
+        return "正常";
+    }
+}
+
+std::optional<StockWarningIndex::Event> StockWarningIndex::setItem(uint32_t tenantId,
+                                                                   uint32_t itemId,
+                                                                   const std::string &itemName,
+                                                                   int32_t minStock,
+                                                                   int32_t maxStock,
+                                                                   int64_t quantity,
+                                                                   int64_t now)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &tenant = tenants_[tenantId];
+    auto &item = tenant.items[itemId];
+    item.name = itemName;
+    item.minStock = minStock;
+    item.maxStock = maxStock;
+    item.quantity = quantity;
+    return applyLocked(tenant, tenantId, itemId, item, now);
+}
+
+std::optional<StockWarningIndex::Event> StockWarningIndex::removeItem(uint32_t tenantId, uint32_t itemId, int64_t now)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto tenantIt = tenants_.begin();
+    if (tenantId == 0)
+    {
+        // 物料已从数据库删除时不知道所属租户，逐个租户查找
+        while (tenantIt != tenants_.end() && !tenantIt->second.items.count(itemId))
+            ++tenantIt;
+    }
+    else
+    {
+        tenantIt = tenants_.find(tenantId);
+    }
+    if (tenantIt == tenants_.end())
+        return std::nullopt;
+    auto &tenant = tenantIt->second;
+    auto itemIt = tenant.items.find(itemId);
+    if (itemIt == tenant.items.end())
+        return std::nullopt;
+    std::optional<Event> event;
+    if (itemIt->second.activePos != npos)
+    {
+        Warning warning;
+        deactivateLocked(tenant, itemIt->second, now, warning);
+        event = Event{Event::Kind::Resolved, warning};
+    }
+    tenant.items.erase(itemIt);
+    return event;
+}
+
+std::optional<StockWarningIndex::Event> StockWarningIndex::evaluate(uint32_t tenantId,
+                                                                    uint32_t itemId,
+                                                                    int64_t quantity,
+                                                                    int64_t now)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto tenantIt = tenants_.find(tenantId);
+    if (tenantIt == tenants_.end())
+        return std::nullopt;
+    auto &tenant = tenantIt->second;
+    auto itemIt = tenant.items.find(itemId);
+    if (itemIt == tenant.items.end())
+        return std::nullopt;
+    itemIt->second.quantity = quantity;
+    return applyLocked(tenant, tenantId, itemId, itemIt->second, now);
+}
+
+std::vector<StockWarningIndex::Warning> StockWarningIndex::active(uint32_t tenantId) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (tenantId == 0)
+    {
+        std::vector<Warning> ret;
+        for (auto &[id, tenant] : tenants_)
+            ret.insert(ret.end(), tenant.active.begin(), tenant.active.end());
+        return ret;
+    }
+    auto it = tenants_.find(tenantId);
+    if (it == tenants_.end())
+        return {};
+    return it->second.active;
+}
+
+std::vector<StockWarningIndex::Warning> StockWarningIndex::resolved(uint32_t tenantId) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (tenantId == 0)
+    {
+        std::vector<Warning> ret;
+        for (auto &[id, tenant] : tenants_)
+            ret.insert(ret.end(), tenant.resolved.begin(), tenant.resolved.end());
+        return ret;
+    }
+    auto it = tenants_.find(tenantId);
+    if (it == tenants_.end())
+        return {};
+    return {it->second.resolved.begin(), it->second.resolved.end()};
+}
+
+size_t StockWarningIndex::activeCount(uint32_t tenantId) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = tenants_.find(tenantId);
+    if (it == tenants_.end())
+        return 0;
+    return it->second.active.size();
+}
+
+std::optional<StockWarningIndex::Event> StockWarningIndex::applyLocked(TenantState &tenant,
+                                                                       uint32_t tenantId,
+                                                                       uint32_t itemId,
+                                                                       ItemState &item,
+                                                                       int64_t now)
+{
+    auto level = classify(item.quantity, item.minStock, item.maxStock);
+    if (item.activePos == npos)
+    {
+        if (level == Level::None)
+            return std::nullopt;
+        Warning warning;
+        warning.id = nextId_++;
+        warning.tenantId = tenantId;
+        warning.itemId = itemId;
+        warning.level = level;
+        warning.quantity = item.quantity;
+        warning.minStock = item.minStock;
+        warning.maxStock = item.maxStock;
+        warning.itemName = item.name;
+        warning.raisedAt = now;
+        item.activePos = tenant.active.size();
+        tenant.active.push_back(warning);
+        return Event{Event::Kind::Raised, warning};
+    }
+
+    auto &warning = tenant.active[item.activePos];
+    if (level == Level::None)
+    {
+        Warning resolved;
+        deactivateLocked(tenant, item, now, resolved);
+        return Event{Event::Kind::Resolved, resolved};
+    }
+    bool changed = warning.level != level;
+    warning.quantity = item.quantity;
+    warning.minStock = item.minStock;
+    warning.maxStock = item.maxStock;
+    warning.itemName = item.name;
+    if (!changed)
+        return std::nullopt;
+    warning.level = level;
+    return Event{Event::Kind::Changed, warning};
+}
+
+void StockWarningIndex::deactivateLocked(TenantState &tenant, ItemState &item, int64_t now, Warning &out)
+{
+    auto pos = item.activePos;
+    out = tenant.active[pos];
+    out.quantity = item.quantity;
+    out.resolvedAt = now;
+    // 与末尾交换后删除，保持 O(1)
+    if (pos + 1 != tenant.active.size())
+    {
+        tenant.active[pos] = std::move(tenant.active.back());
+        tenant.items[tenant.active[pos].itemId].activePos = pos;
+    }
+    tenant.active.pop_back();
+    item.activePos = npos;
+
+    tenant.resolved.push_front(out);
+    if (tenant.resolved.size() > resolvedCapacity_)
+        tenant.resolved.pop_back();
+}
@@ -0,0 +1,112 @@
+/**
+ *
+ *  StockWarningIndex.h
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 按租户维护的库存预警索引，不依赖 drogon，便于单独压测。
+ *
+ * 每次库存变动只重新判断被改动的物料，活跃预警保存在连续数组中，
+ * 列表查询的代价与活跃预警数成正比。
+ */
+class StockWarningIndex
+{
+public:
+  /// 与前端库存状态对应：紧缺 HIGH、偏低 MEDIUM、过剩 LOW
+  enum class Level
+  {
+    None,
+    Low,
+    Medium,
+    High
+  };
+
+  struct Warning
+  {
+    uint64_t id{0};
+    uint32_t tenantId{0};
+    uint32_t itemId{0};
+    Level level{Level::None};
+    int64_t quantity{0};
+    int32_t minStock{0};
+    int32_t maxStock{0};
+    std::string itemName;
+    int64_t raisedAt{0};   // 微秒时间戳
+    int64_t resolvedAt{0}; // 0 表示仍活跃
+  };
+
+  struct Event
+  {
+    enum class Kind
+    {
+      Raised,
+      Changed,
+      Resolved
+    };
+    Kind kind;
+    Warning warning;
+  };
+
+  explicit StockWarningIndex(size_t resolvedCapacity = 100)
+      : resolvedCapacity_(resolvedCapacity)
+  {
+  }
+
+  static Level classify(int64_t quantity, int32_t minStock, int32_t maxStock);
+  static const char *levelName(Level level);
+  static const char *statusName(Level level);
+
+  /// 设置（或更新）物料阈值，并用已知数量重新判断
+  std::optional<Event> setItem(uint32_t tenantId,
+                               uint32_t itemId,
+                               const std::string &itemName,
+                               int32_t minStock,
+                               int32_t maxStock,
+                               int64_t quantity,
+                               int64_t now);
+  /// 物料被删除，活跃预警随之解除；tenantId 为 0 时按物料查找租户
+  std::optional<Event> removeItem(uint32_t tenantId, uint32_t itemId, int64_t now);
+  /// 库存变动后只判断该物料
+  std::optional<Event> evaluate(uint32_t tenantId, uint32_t itemId, int64_t quantity, int64_t now);
+
+  /// tenantId 为 0 时返回所有租户
+  std::vector<Warning> active(uint32_t tenantId) const;
+  std::vector<Warning> resolved(uint32_t tenantId) const;
+  size_t activeCount(uint32_t tenantId) const;
+
+private:
+  static constexpr size_t npos = static_cast<size_t>(-1);
+  struct ItemState
+  {
+    std::string name;
+    int32_t minStock{0};
+    int32_t maxStock{0};
+    int64_t quantity{0};
+    size_t activePos{npos}; // 在 active 数组中的位置
+  };
+  struct TenantState
+  {
+    std::unordered_map<uint32_t, ItemState> items;
+    std::vector<Warning> active;
+    std::deque<Warning> resolved; // 最近解除的预警，新的在前
+  };
+
+  std::optional<Event> applyLocked(TenantState &tenant, uint32_t tenantId, uint32_t itemId, ItemState &item, int64_t now);
+  void deactivateLocked(TenantState &tenant, ItemState &item, int64_t now, Warning &out);
+
+  size_t resolvedCapacity_;
+  uint64_t nextId_{1};
+  mutable std::mutex mutex_;
+  std::unordered_map<uint32_t, TenantState> tenants_;
+};
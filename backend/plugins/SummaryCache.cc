@@ -0,0 +1,81 @@
+/**
+ *
+ *  SummaryCache.cc
+ *
+ */
+
+#include "SummaryCache.h"
+#include <algorithm>
+
+void SummaryCache::Summary::add(int64_t at, int64_t amount, int64_t earned)
+{
+    firstAt = orders == 0 ? at : std::min(firstAt, at);
+    lastAt = orders == 0 ? at : std::max(lastAt, at);
+    ++orders;
+    cents += amount;
+    points += earned;
+}
+
+SummaryCache::SummaryCache(size_t capacity) : capacity_(std::max<size_t>(capacity, 1))
+{
+    index_.reserve(capacity_);
+}
+
+bool SummaryCache::get(uint32_t memberId, Summary &summary)
+{
+    auto it = index_.find(memberId);
+    if (it == index_.end())
+        return false;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    summary = it->second->second;
+    return true;
+}
+
+void SummaryCache::put(uint32_t memberId, const Summary &summary)
+{
+    auto it = index_.find(memberId);
+    if (it != index_.end())
+    {
+        it->second->second = summary;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return;
+    }
+    if (index_.size() >= capacity_)
+    {
+        // 复用最久未访问的节点
+        auto last = std::prev(entries_.end());
+        index_.erase(last->first);
+        last->first = memberId;
+        last->second = summary;
+        entries_.splice(entries_.begin(), entries_, last);
+    }
+    else
+    {
+        entries_.emplace_front(memberId, summary);
+    }
+    index_.emplace(memberId, entries_.begin());
+}
+
+bool SummaryCache::add(uint32_t memberId, int64_t at, int64_t cents, int64_t points)
+{
+    auto it = index_.find(memberId);
+    if (it == index_.end())
+        return false;
+    it->second->second.add(at, cents, points);
+    return true;
+}
+
+void SummaryCache::erase(uint32_t memberId)
+{
+    auto it = index_.find(memberId);
+    if (it == index_.end())
+        return;
+    entries_.erase(it->second);
+    index_.erase(it);
+}
+
+void SummaryCache::clear()
+{
+    entries_.clear();
+    index_.clear();
+}
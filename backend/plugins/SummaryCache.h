@@ -0,0 +1,53 @@
+/**
+ *
+ *  SummaryCache.h
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @brief 会员消费汇总的 LRU 缓存，容量满时淘汰最久未访问的会员。
+ *
+ * 汇总只统计金额大于 0 的消费记录（不含会员到期等事件），积分只计非负整数。
+ * 不加锁，由调用方保证互斥。
+ */
+class SummaryCache
+{
+public:
+  struct Summary
+  {
+    uint32_t orders{0};
+    int64_t cents{0};
+    int64_t points{0};
+    int64_t firstAt{0}; // 首次消费时间（秒），没有消费时为 0
+    int64_t lastAt{0};
+
+    void add(int64_t at, int64_t amount, int64_t earned);
+  };
+
+  explicit SummaryCache(size_t capacity);
+
+  /// 命中时写入 summary 并移到最近使用
+  bool get(uint32_t memberId, Summary &summary);
+  void put(uint32_t memberId, const Summary &summary);
+  /// 已缓存时累加一笔消费，未缓存时不做处理并返回 false
+  bool add(uint32_t memberId, int64_t at, int64_t cents, int64_t points);
+  void erase(uint32_t memberId);
+  void clear();
+  size_t size() const { return index_.size(); }
+  size_t capacity() const { return capacity_; }
+
+private:
+  using Entries = std::list<std::pair<uint32_t, Summary>>;
+
+  size_t capacity_;
+  Entries entries_; // 头部为最近使用
+  std::unordered_map<uint32_t, Entries::iterator> index_;
+};
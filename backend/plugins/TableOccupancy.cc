@@ -0,0 +1,311 @@
+/**
+ *
+ *  TableOccupancy.cc
+ *
+ */
+
+#include "TableOccupancy.h"
+#include "Branch.h"
+#include <drogon/drogon.h>
+#include <algorithm>
+
+using namespace drogon;
+using namespace drogon::orm;
+using namespace drogon_model::saas_restaurant;
+
+namespace
+{
+double numberOf(const Json::Value &value, double defaultValue = 0)
+{
+    try
+    {
+        if (value.isString())
+            return value.asString().empty() ? defaultValue : std::stod(value.asString());
+        if (value.isNumeric())
+            return value.asDouble();
+    }
+    catch (const std::exception &)
+    {
+    }
+    return defaultValue;
+}
+} // namespace
+
+void TableOccupancy::initAndStart(const Json::Value &config)
+{
+    dbClient_ = app().getDbClient(config.get("db_client", "default").asString());
+    compactRecords_ = std::max<uint64_t>(config.get("compact_records", 4096).asUInt64(), 64);
+    const auto &statuses = config["release_statuses"];
+    if (statuses.isArray())
+    {
+        for (const auto &status : statuses)
+            releaseStatuses_.insert(status.asString());
+    }
+    else
+    {
+        releaseStatuses_ = {"已完成", "已取消"};
+    }
+
+    std::string error;
+    auto logPath = config.get("log_path", "./occupancy.log").asString();
+    if (!log_.open(logPath, error))
+        LOG_ERROR << "Failed to open occupancy log " << logPath << ", occupancy will not survive restarts: " << error;
+    load();
+    writer_ = std::thread([this]() { writeLoop(); });
+}
+
+void TableOccupancy::shutdown()
+{
+    // 写完已排队的事件
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        stopping_ = true;
+    }
+    pendingCv_.notify_one();
+    if (writer_.joinable())
+        writer_.join();
+}
+
+void TableOccupancy::load()
+{
+    std::lock_guard<std::mutex> lock(boardMutex_);
+    try
+    {
+        auto rows = dbClient_->execSqlSync(
+            "select branch_id, capacity from branch where (is_deleted = 0 or is_deleted is null)");
+        for (const auto &row : rows)
+            board_.setCapacity(row["branch_id"].as<uint32_t>(),
+                               row["capacity"].isNull() ? 0 : row["capacity"].as<uint32_t>());
+        LOG_INFO << "Table occupancy loaded " << rows.size() << " branches";
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to load branch capacities: " << e.base().what();
+    }
+    if (!log_.isOpen())
+        return;
+    auto replayed = log_.replay([this](const OccupancyBoard::Event &event) { board_.apply(event); });
+    if (replayed > 0)
+        LOG_INFO << "Replayed " << replayed << " occupancy events from log, " << board_.orderCount()
+                 << " orders seated";
+}
+
+void TableOccupancy::branchChanged(uint32_t branchId)
+{
+    Mapper<Branch>(dbClient_).findByPrimaryKey(
+        branchId,
+        [this, branchId](const Branch &branch)
+        {
+            std::lock_guard<std::mutex> lock(boardMutex_);
+            if (branch.getValueOfIsDeleted() == 1)
+                board_.removeBranch(branchId);
+            else
+                board_.setCapacity(branchId, branch.getValueOfCapacity());
+        },
+        [this, branchId](const DrogonDbException &e)
+        {
+            if (!dynamic_cast<const UnexpectedRows *>(&e.base()))
+            {
+                LOG_ERROR << "Failed to refresh capacity of branch " << branchId << ": " << e.base().what();
+                return;
+            }
+            std::lock_guard<std::mutex> lock(boardMutex_);
+            board_.removeBranch(branchId);
+        });
+}
+
+OccupancyBoard::Event TableOccupancy::eventOf(const OrderTable &order) const
+{
+    OccupancyBoard::Event event;
+    event.type = OccupancyBoard::Event::Release;
+    event.orderId = order.getValueOfOrderId();
+    event.at = (order.getCreatedAt() ? order.getValueOfCreatedAt() : trantor::Date::now()).secondsSinceEpoch();
+    if (order.getValueOfIsDeleted() == 1 || !order.getBranchId() ||
+        releaseStatuses_.count(order.getValueOfOrderStatus()) != 0 || !order.getValueOfDeliveryAddress().empty())
+        return event;
+
+    Json::Value detail;
+    std::string errs;
+    const auto &text = order.getValueOfOrderDetail();
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    if (text.empty() || !reader->parse(text.data(), text.data() + text.size(), &detail, &errs) || !detail.isObject())
+        return event;
+    const auto &table = detail["table_number"];
+    event.table = table.isString() || table.isIntegral() ? table.asString() : std::string();
+    if (event.table.empty() || event.table.size() > OccupancyLog::kMaxTable)
+    {
+        event.table.clear();
+        return event;
+    }
+    event.type = OccupancyBoard::Event::Seat;
+    event.branchId = order.getValueOfBranchId();
+    event.covers = static_cast<uint16_t>(std::clamp(numberOf(detail["customer_count"], 1), 1.0, 65535.0));
+    return event;
+}
+
+void TableOccupancy::orderCreated(const OrderTable &order)
+{
+    auto event = eventOf(order);
+    if (event.type == OccupancyBoard::Event::Seat)
+        submit(std::move(event));
+}
+
+void TableOccupancy::orderChanged(uint32_t orderId)
+{
+    Mapper<OrderTable>(dbClient_).findByPrimaryKey(
+        orderId,
+        [this, orderId](const OrderTable &order)
+        {
+            auto event = eventOf(order);
+            uint32_t branchId = 0;
+            std::string table;
+            bool seated;
+            {
+                std::lock_guard<std::mutex> lock(boardMutex_);
+                seated = board_.locate(orderId, branchId, table);
+            }
+            // 未入座的订单结束时不必写日志
+            if (event.type == OccupancyBoard::Event::Seat || seated)
+                submit(std::move(event));
+        },
+        [this, orderId](const DrogonDbException &e)
+        {
+            if (!dynamic_cast<const UnexpectedRows *>(&e.base()))
+            {
+                LOG_ERROR << "Failed to refresh order " << orderId << " for occupancy: " << e.base().what();
+                return;
+            }
+            OccupancyBoard::Event event;
+            event.type = OccupancyBoard::Event::Release;
+            event.orderId = orderId;
+            event.at = trantor::Date::now().secondsSinceEpoch();
+            submit(std::move(event));
+        });
+}
+
+void TableOccupancy::seat(uint32_t branchId, const std::string &table, uint16_t covers, Callback &&callback)
+{
+    OccupancyBoard::Event event;
+    event.type = OccupancyBoard::Event::Seat;
+    event.branchId = branchId;
+    event.covers = covers;
+    event.table = table;
+    event.at = trantor::Date::now().secondsSinceEpoch();
+    submit(std::move(event), std::move(callback));
+}
+
+void TableOccupancy::clear(uint32_t branchId, const std::string &table, Callback &&callback)
+{
+    OccupancyBoard::Event event;
+    event.type = OccupancyBoard::Event::Clear;
+    event.branchId = branchId;
+    event.table = table;
+    event.at = trantor::Date::now().secondsSinceEpoch();
+    submit(std::move(event), std::move(callback));
+}
+
+void TableOccupancy::submit(OccupancyBoard::Event event, Callback &&callback)
+{
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        pending_.push_back(Pending{std::move(event), std::move(callback)});
+    }
+    pendingCv_.notify_one();
+}
+
+void TableOccupancy::writeLoop()
+{
+    std::vector<Pending> batch;
+    std::vector<OccupancyBoard::Event> events;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(pendingMutex_);
+            pendingCv_.wait(lock, [this]() { return stopping_ || !pending_.empty(); });
+            if (pending_.empty())
+                return;
+            batch.swap(pending_);
+        }
+
+        // 组提交：排队期间到达的事件共用一次 fdatasync，落盘后才应用，内存状态不会领先于日志
+        events.clear();
+        for (const auto &item : batch)
+            events.push_back(item.event);
+        bool written = !log_.isOpen() || log_.append(events);
+        if (written)
+        {
+            std::lock_guard<std::mutex> lock(boardMutex_);
+            for (const auto &event : events)
+                board_.apply(event);
+        }
+        else
+        {
+            LOG_ERROR << "Failed to write " << events.size() << " occupancy events to log";
+        }
+        for (auto &item : batch)
+            if (item.callback)
+                item.callback(written);
+        batch.clear();
+        compact();
+    }
+}
+
+void TableOccupancy::compact()
+{
+    if (!log_.isOpen() || log_.records() < compactRecords_)
+        return;
+    std::vector<OccupancyBoard::Event> events;
+    {
+        std::lock_guard<std::mutex> lock(boardMutex_);
+        events = board_.checkpoint();
+    }
+    // 当前状态本身就很大时不反复压缩
+    if (events.size() * 4 > log_.records())
+        return;
+    auto before = log_.records();
+    if (log_.rewrite(events))
+        LOG_INFO << "Occupancy log compacted from " << before << " to " << events.size() << " records";
+    else
+        LOG_ERROR << "Failed to compact occupancy log";
+}
+
+bool TableOccupancy::hasBranch(uint32_t branchId) const
+{
+    std::lock_guard<std::mutex> lock(boardMutex_);
+    return board_.hasBranch(branchId);
+}
+
+bool TableOccupancy::occupancyOf(uint32_t branchId, bool withTables, Json::Value &data) const
+{
+    OccupancyBoard::Summary summary;
+    std::vector<OccupancyBoard::Table> tables;
+    {
+        std::lock_guard<std::mutex> lock(boardMutex_);
+        if (!board_.summary(branchId, summary))
+            return false;
+        if (withTables)
+            tables = board_.tables(branchId);
+    }
+    data["branch_id"] = branchId;
+    data["capacity"] = summary.capacity;
+    data["covers"] = summary.covers;
+    data["available"] = summary.capacity > summary.covers ? summary.capacity - summary.covers : 0;
+    data["tables_occupied"] = summary.tables;
+    if (!withTables)
+        return true;
+    data["tables"] = Json::Value(Json::arrayValue);
+    for (const auto &table : tables)
+    {
+        Json::Value item;
+        item["table_number"] = table.name;
+        item["covers"] = table.covers;
+        item["since"] = trantor::Date(table.since * 1000000).toDbStringLocal();
+        item["manual"] = table.manual;
+        item["order_ids"] = Json::Value(Json::arrayValue);
+        for (auto orderId : table.orders)
+            item["order_ids"].append(orderId);
+        data["tables"].append(std::move(item));
+    }
+    return true;
+}
@@ -0,0 +1,86 @@
+/**
+ *
+ *  TableOccupancy.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/orm/DbClient.h>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "OccupancyBoard.h"
+#include "OccupancyLog.h"
+#include "OrderTable.h"
+
+/**
+ * @brief 各分店的实时桌台占用和剩余容量。
+ *
+ * 订单创建、修改、删除时按 order_detail 中的 table_number、customer_count 生成入座或离桌事件，
+ * 也可手工入座、清台。事件交给写日志线程组提交，落盘后才应用到 OccupancyBoard，重启时重放日志恢复，
+ * 不写数据库；日志记录数超过 compact_records 且为当前状态的数倍时压缩成当前状态。
+ * 分店容量取 branch.capacity，分店增删改时重读。
+ */
+class TableOccupancy : public drogon::Plugin<TableOccupancy>
+{
+public:
+  TableOccupancy() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  void branchChanged(uint32_t branchId);
+  void orderCreated(const drogon_model::saas_restaurant::OrderTable &order);
+  /// 订单修改或删除后按主键重读
+  void orderChanged(uint32_t orderId);
+
+  /// 落盘后回调，logged 为 false 表示日志写入失败、事件未生效；回调在写日志线程中执行
+  using Callback = std::function<void(bool logged)>;
+  /// 手工入座，桌上已有客时改为 covers 位
+  void seat(uint32_t branchId, const std::string &table, uint16_t covers, Callback &&callback);
+  void clear(uint32_t branchId, const std::string &table, Callback &&callback);
+
+  bool hasBranch(uint32_t branchId) const;
+  /// {branch_id, capacity, covers, available, tables_occupied}，with_tables 时带各桌明细；分店不存在时返回 false
+  bool occupancyOf(uint32_t branchId, bool withTables, Json::Value &data) const;
+
+private:
+  struct Pending
+  {
+    OccupancyBoard::Event event;
+    Callback callback;
+  };
+
+  void load();
+  void submit(OccupancyBoard::Event event, Callback &&callback = nullptr);
+  void writeLoop();
+  void compact();
+  /// 订单对应的事件：堂食且未结束时入座，否则离桌
+  OccupancyBoard::Event eventOf(const drogon_model::saas_restaurant::OrderTable &order) const;
+
+  drogon::orm::DbClientPtr dbClient_;
+  std::unordered_set<std::string> releaseStatuses_;
+  uint64_t compactRecords_{4096};
+
+  mutable std::mutex boardMutex_;
+  OccupancyBoard board_;
+  OccupancyLog log_; // 只在写日志线程中访问
+
+  std::mutex pendingMutex_;
+  std::condition_variable pendingCv_;
+  std::vector<Pending> pending_;
+  bool stopping_{false};
+  std::thread writer_;
+};
@@ -0,0 +1,193 @@
+/**
+ *
+ *  VoucherBook.cc
+ *
+ */
+
+#include "VoucherBook.h"
+
+namespace
+{
+const char kAlphabet[] = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+
+int valueOf(char c)
+{
+    if (c >= 'a' && c <= 'z')
+        c = static_cast<char>(c - 'a' + 'A');
+    switch (c)
+    {
+        case 'O':
+            return 0;
+        case 'I':
+        case 'L':
+            return 1;
+        case 'U':
+            return -1;
+        default:
+            break;
+    }
+    for (int i = 0; i < 32; ++i)
+    {
+        if (kAlphabet[i] == c)
+            return i;
+    }
+    return -1;
+}
+
+uint64_t mix(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+} // namespace
+
+uint64_t VoucherBook::secretOf(const std::string &key)
+{
+    // FNV-1a 64，跨平台、跨版本稳定
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : key)
+        hash = (hash ^ c) * 1099511628211ULL;
+    return mix(hash);
+}
+
+VoucherBook::~VoucherBook()
+{
+    for (auto &chunk : chunks_)
+        delete[] chunk.load(std::memory_order_relaxed);
+}
+
+uint32_t VoucherBook::checkOf(uint64_t seq) const
+{
+    return static_cast<uint32_t>(mix(mix(seq ^ secret_) + secret_) >> 32);
+}
+
+std::string VoucherBook::encode(uint64_t seq) const
+{
+    uint64_t bits = (seq << 32) | checkOf(seq);
+    std::string code(kCodeLength, '0');
+    for (int i = kCodeLength - 1; i >= 0; --i)
+    {
+        code[i] = kAlphabet[bits & 31];
+        bits >>= 5;
+    }
+    return code;
+}
+
+bool VoucherBook::decode(const std::string &code, uint64_t &seq) const
+{
+    if (code.size() != kCodeLength)
+        return false;
+    uint64_t bits = 0;
+    for (char c : code)
+    {
+        int value = valueOf(c);
+        if (value < 0)
+            return false;
+        bits = (bits << 5) | static_cast<uint64_t>(value);
+    }
+    seq = bits >> 32;
+    return seq != 0 && static_cast<uint32_t>(bits) == checkOf(seq);
+}
+
+VoucherBook::Slot *VoucherBook::slotOf(uint64_t seq) const
+{
+    if (seq == 0 || seq > kMaxSeq)
+        return nullptr;
+    auto *chunk = chunks_[seq >> kChunkBits].load(std::memory_order_acquire);
+    return chunk ? &chunk[seq & (kChunkSize - 1)] : nullptr;
+}
+
+VoucherBook::Slot *VoucherBook::ensureSlot(uint64_t seq)
+{
+    auto &chunk = chunks_[seq >> kChunkBits];
+    auto *slots = chunk.load(std::memory_order_relaxed);
+    if (!slots)
+    {
+        slots = new Slot[kChunkSize];
+        chunk.store(slots, std::memory_order_release);
+    }
+    return &slots[seq & (kChunkSize - 1)];
+}
+
+uint64_t VoucherBook::reserve(uint32_t tenantId, uint32_t campaignId, uint32_t count)
+{
+    std::lock_guard<std::mutex> lock(growMutex_);
+    auto first = nextSeq_.load(std::memory_order_relaxed);
+    if (count == 0 || first + count - 1 > kMaxSeq)
+        return 0;
+    for (uint64_t seq = first; seq < first + count; ++seq)
+    {
+        auto *slot = ensureSlot(seq);
+        slot->tenantId = tenantId;
+        slot->campaignId = campaignId;
+    }
+    nextSeq_.store(first + count, std::memory_order_release);
+    return first;
+}
+
+void VoucherBook::restore(uint64_t seq, uint32_t tenantId, uint32_t campaignId, State state)
+{
+    if (seq == 0 || seq > kMaxSeq)
+        return;
+    std::lock_guard<std::mutex> lock(growMutex_);
+    auto *slot = ensureSlot(seq);
+    slot->tenantId = tenantId;
+    slot->campaignId = campaignId;
+    slot->state.store(state, std::memory_order_release);
+    if (seq >= nextSeq_.load(std::memory_order_relaxed))
+        nextSeq_.store(seq + 1, std::memory_order_release);
+}
+
+bool VoucherBook::transition(uint64_t seq, State expected, State desired)
+{
+    auto *slot = slotOf(seq);
+    if (!slot)
+        return false;
+    uint8_t current = expected;
+    return slot->state.compare_exchange_strong(current, desired, std::memory_order_acq_rel);
+}
+
+VoucherBook::Claim VoucherBook::claim(const std::string &code, uint32_t tenantId, uint64_t &seq, uint32_t &campaignId)
+{
+    if (!decode(code, seq))
+        return Claim::Invalid;
+    auto *slot = slotOf(seq);
+    if (!slot)
+        return Claim::Invalid;
+    // 状态不是 Unissued 时归属字段已发布
+    auto state = slot->state.load(std::memory_order_acquire);
+    if (state == Unissued || slot->tenantId != tenantId)
+        return Claim::Invalid;
+    uint8_t expected = Available;
+    if (!slot->state.compare_exchange_strong(expected, Redeemed, std::memory_order_acq_rel))
+        return expected == Voided ? Claim::Voided : expected == Redeemed ? Claim::AlreadyRedeemed : Claim::Invalid;
+    campaignId = slot->campaignId;
+    return Claim::Ok;
+}
+
+VoucherBook::Claim VoucherBook::peek(const std::string &code,
+                                     uint32_t tenantId,
+                                     uint64_t &seq,
+                                     uint32_t &campaignId) const
+{
+    if (!decode(code, seq))
+        return Claim::Invalid;
+    auto *slot = slotOf(seq);
+    if (!slot)
+        return Claim::Invalid;
+    auto state = slot->state.load(std::memory_order_acquire);
+    if (state == Unissued || slot->tenantId != tenantId)
+        return Claim::Invalid;
+    if (state != Available)
+        return state == Voided ? Claim::Voided : Claim::AlreadyRedeemed;
+    campaignId = slot->campaignId;
+    return Claim::Ok;
+}
+
+VoucherBook::State VoucherBook::stateOf(uint64_t seq) const
+{
+    auto *slot = slotOf(seq);
+    return slot ? static_cast<State>(slot->state.load(std::memory_order_acquire)) : Unissued;
+}
@@ -0,0 +1,92 @@
+/**
+ *
+ *  VoucherBook.h
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * @brief 券码编解码和无锁核销表。
+ *
+ * 券码为 12 位 Crockford Base32（60 位）：高 28 位是发券序号，低 32 位是序号和密钥的校验值，
+ * 猜中一张有效券码约需 2^32 次尝试。序号直接定位核销表中的槽位，不需要哈希表。
+ * 槽位按 65536 个一块分配，块指针发布后不再移动；核销只对槽位状态做一次 CAS，
+ * 同一张券并发核销时只有一个请求成功。
+ */
+class VoucherBook
+{
+public:
+  enum State : uint8_t
+  {
+    Unissued = 0, // 已预留序号，尚未落库
+    Available,
+    Redeemed,
+    Voided
+  };
+  enum class Claim
+  {
+    Ok,
+    Invalid, // 券码错误、不属于该租户或尚未发放
+    AlreadyRedeemed,
+    Voided
+  };
+
+  static constexpr int kCodeLength = 12;
+  static constexpr uint64_t kSeqBits = 28;
+  static constexpr uint64_t kMaxSeq = (uint64_t(1) << kSeqBits) - 1; // 序号从 1 开始
+
+  explicit VoucherBook(uint64_t secret) : secret_(secret) {}
+  /// 由配置中的密钥字符串得到校验密钥，更换密钥后已发放的券码全部失效
+  static uint64_t secretOf(const std::string &key);
+  ~VoucherBook();
+  VoucherBook(const VoucherBook &) = delete;
+  VoucherBook &operator=(const VoucherBook &) = delete;
+
+  std::string encode(uint64_t seq) const;
+  /// 校验格式和校验值，大小写不敏感，O、I、L 分别按 0、1、1 处理
+  bool decode(const std::string &code, uint64_t &seq) const;
+
+  /// 预留 count 个连续序号并记录归属，状态为 Unissued；序号用尽时返回 0
+  uint64_t reserve(uint32_t tenantId, uint32_t campaignId, uint32_t count);
+  /// 启动时按数据库和日志恢复单张券，须在开始核销前调用
+  void restore(uint64_t seq, uint32_t tenantId, uint32_t campaignId, State state);
+  /// 发布或回退状态，只在 expected 状态下生效
+  bool transition(uint64_t seq, State expected, State desired);
+
+  /// 核销，成功时返回券所属活动
+  Claim claim(const std::string &code, uint32_t tenantId, uint64_t &seq, uint32_t &campaignId);
+  /// 与 claim 相同的校验，但不改状态，用于试算
+  Claim peek(const std::string &code, uint32_t tenantId, uint64_t &seq, uint32_t &campaignId) const;
+  /// 不校验券码，只读状态
+  State stateOf(uint64_t seq) const;
+  uint64_t nextSeq() const { return nextSeq_.load(std::memory_order_acquire); }
+
+private:
+  struct Slot
+  {
+    std::atomic<uint8_t> state{Unissued};
+    uint32_t tenantId{0}; // 状态离开 Unissued 前写入
+    uint32_t campaignId{0};
+  };
+  static constexpr uint64_t kChunkBits = 16;
+  static constexpr uint64_t kChunkSize = uint64_t(1) << kChunkBits;
+  static constexpr uint64_t kChunks = (kMaxSeq >> kChunkBits) + 1;
+
+  uint32_t checkOf(uint64_t seq) const;
+  Slot *slotOf(uint64_t seq) const;
+  /// 须持有 growMutex_
+  Slot *ensureSlot(uint64_t seq);
+
+  uint64_t secret_;
+  std::array<std::atomic<Slot *>, kChunks> chunks_{};
+  std::mutex growMutex_;
+  std::atomic<uint64_t> nextSeq_{1};
+};
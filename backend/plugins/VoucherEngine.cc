@@ -0,0 +1,386 @@
+/**
+ *
+ *  VoucherEngine.cc
+ *
+ */
+
+#include "VoucherEngine.h"
+#include "PricingEngine.h"
+#include <drogon/drogon.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+namespace
+{
+const std::string kAvailable = "未使用";
+const std::string kRedeemed = "已使用";
+const std::string kVoided = "已作废";
+constexpr size_t kRowsPerInsert = 1000;
+} // namespace
+
+void VoucherEngine::initAndStart(const Json::Value &config)
+{
+    dbClient_ = app().getDbClient(config.get("db_client", "default").asString());
+    maxIssue_ = std::max(config.get("max_issue", 10000).asUInt(), 1u);
+    persistBatch_ = std::max<size_t>(config.get("persist_batch", 1000).asUInt64(), 1);
+
+    // 密钥公开时任何人都能伪造券码，未配置时不发券也不核销，其余功能照常
+    const char *env = std::getenv("VOUCHER_CODE_SECRET");
+    auto secret = env && *env ? std::string(env) : config.get("code_secret", "").asString();
+    if (secret.empty() || secret == "change_me")
+    {
+        LOG_ERROR << "Voucher code secret is not configured, set VOUCHER_CODE_SECRET or code_secret; "
+                     "voucher issue and redemption are disabled";
+        return;
+    }
+    book_ = std::make_unique<VoucherBook>(VoucherBook::secretOf(secret));
+
+    std::string error;
+    auto logPath = config.get("log_path", "./voucher.log").asString();
+    logOpen_ = log_.open(logPath, error);
+    if (!logOpen_)
+        LOG_ERROR << "Failed to open voucher log " << logPath << ", redemption is disabled: " << error;
+    load();
+
+    writer_ = std::thread([this]() { writeLoop(); });
+    timerId_ = app().getLoop()->runEvery(config.get("persist_interval", 1.0).asDouble(), [this]() { persist(); });
+}
+
+void VoucherEngine::shutdown()
+{
+    // 写完已排队的核销；未落库的部分留在日志中，下次启动时重放
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        stopping_ = true;
+    }
+    pendingCv_.notify_one();
+    if (writer_.joinable())
+        writer_.join();
+    if (timerId_ != 0)
+        app().getLoop()->invalidateTimer(timerId_);
+}
+
+std::string VoucherEngine::describe(Redeem result)
+{
+    switch (result)
+    {
+        case Redeem::Ok:
+            return "ok";
+        case Redeem::AlreadyRedeemed:
+            return "券已使用";
+        case Redeem::Voided:
+            return "券已作废";
+        case Redeem::Inactive:
+            return "券对应的活动不在进行中";
+        case Redeem::Disabled:
+            return "券暂不可用";
+        case Redeem::Failed:
+            return "核销暂不可用";
+        default:
+            return "券码无效";
+    }
+}
+
+void VoucherEngine::load()
+{
+    try
+    {
+        auto rows = dbClient_->execSqlSync("select voucher_id, tenant_id, campaign_id, status from voucher");
+        for (const auto &row : rows)
+        {
+            auto status = row["status"].isNull() ? kAvailable : row["status"].as<std::string>();
+            book_->restore(row["voucher_id"].as<uint64_t>(),
+                           row["tenant_id"].as<uint32_t>(),
+                           row["campaign_id"].as<uint32_t>(),
+                           status == kRedeemed  ? VoucherBook::Redeemed
+                           : status == kVoided ? VoucherBook::Voided
+                                               : VoucherBook::Available);
+        }
+        LOG_INFO << "Voucher engine loaded " << rows.size() << " vouchers";
+    }
+    catch (const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to load vouchers: " << e.base().what();
+    }
+
+    // 日志中的核销可能尚未落库，重新排队写回
+    auto replayed = log_.replay(
+        [this](const VoucherLog::Record &record)
+        {
+            book_->restore(record.seq, record.tenantId, record.campaignId, VoucherBook::Redeemed);
+            unpersisted_.push_back(record);
+        });
+    logged_ = replayed;
+    if (replayed > 0)
+        LOG_INFO << "Replayed " << replayed << " voucher redemptions from log";
+}
+
+void VoucherEngine::issue(uint32_t tenantId,
+                          uint32_t campaignId,
+                          uint32_t count,
+                          std::function<void(std::vector<std::string> codes)> &&callback,
+                          std::function<void(const std::string &message)> &&errorCallback)
+{
+    if (!book_)
+    {
+        errorCallback("券码密钥未配置");
+        return;
+    }
+    auto callbackPtr = std::make_shared<std::function<void(std::vector<std::string>)>>(std::move(callback));
+    auto errorPtr = std::make_shared<std::function<void(const std::string &)>>(std::move(errorCallback));
+    dbClient_->execSqlAsync(
+        "select tenant_id from marketing_campaign where campaign_id = ? and (is_deleted = 0 or is_deleted is null)",
+        [this, tenantId, campaignId, count, callbackPtr, errorPtr](const Result &result)
+        {
+            if (result.empty() || result[0]["tenant_id"].isNull() || result[0]["tenant_id"].as<uint32_t>() != tenantId)
+            {
+                (*callbackPtr)({});
+                return;
+            }
+            auto first = book_->reserve(tenantId, campaignId, count);
+            if (first == 0)
+            {
+                (*errorPtr)("券序号已用尽");
+                return;
+            }
+            auto codes = std::make_shared<std::vector<std::string>>();
+            codes->reserve(count);
+            for (uint64_t seq = first; seq < first + count; ++seq)
+                codes->push_back(book_->encode(seq));
+
+            // 所有批次在同一事务中写入，提交成功后才可核销
+            dbClient_->newTransactionAsync(
+                [this, tenantId, campaignId, first, count, codes, callbackPtr, errorPtr](
+                    const std::shared_ptr<Transaction> &transaction)
+                {
+                    if (!transaction)
+                    {
+                        (*errorPtr)("database error");
+                        return;
+                    }
+                    auto failed = std::make_shared<std::atomic<bool>>(false);
+                    transaction->setCommitCallback(
+                        [this, first, count, codes, failed, callbackPtr, errorPtr](bool committed)
+                        {
+                            if (*failed)
+                                return;
+                            if (!committed)
+                            {
+                                (*errorPtr)("database error");
+                                return;
+                            }
+                            for (uint64_t seq = first; seq < first + count; ++seq)
+                                book_->transition(seq, VoucherBook::Unissued, VoucherBook::Available);
+                            (*callbackPtr)(std::move(*codes));
+                        });
+                    for (size_t begin = 0; begin < count; begin += kRowsPerInsert)
+                    {
+                        auto end = std::min<size_t>(begin + kRowsPerInsert, count);
+                        std::string sql =
+                            "insert into voucher (voucher_id, voucher_code, tenant_id, campaign_id, status) values ";
+                        for (size_t i = begin; i < end; ++i)
+                            sql += i == begin ? "(?, ?, ?, ?, ?)" : ", (?, ?, ?, ?, ?)";
+                        auto binder = *transaction << std::move(sql);
+                        for (size_t i = begin; i < end; ++i)
+                            binder << static_cast<uint64_t>(first + i) << (*codes)[i] << tenantId << campaignId << kAvailable;
+                        binder >> [](const Result &) {};
+                        // 出错时事务自动回滚且不再触发提交回调，在这里应答，只应答一次
+                        binder >> [failed, errorPtr](const DrogonDbException &e)
+                        {
+                            LOG_ERROR << "Failed to insert vouchers: " << e.base().what();
+                            if (!failed->exchange(true))
+                                (*errorPtr)("database error");
+                        };
+                    }
+                });
+        },
+        [errorPtr](const DrogonDbException &e)
+        {
+            LOG_ERROR << e.base().what();
+            (*errorPtr)("database error");
+        },
+        campaignId);
+}
+
+namespace
+{
+VoucherEngine::Redeem resultOf(VoucherBook::Claim claim)
+{
+    switch (claim)
+    {
+        case VoucherBook::Claim::Ok:
+            return VoucherEngine::Redeem::Ok;
+        case VoucherBook::Claim::AlreadyRedeemed:
+            return VoucherEngine::Redeem::AlreadyRedeemed;
+        case VoucherBook::Claim::Voided:
+            return VoucherEngine::Redeem::Voided;
+        default:
+            return VoucherEngine::Redeem::Invalid;
+    }
+}
+} // namespace
+
+void VoucherEngine::redeem(uint32_t tenantId,
+                           const std::string &code,
+                           uint32_t orderId,
+                           uint32_t memberId,
+                           RedeemCallback &&callback)
+{
+    uint64_t seq = 0;
+    uint32_t campaignId = 0;
+    auto result = hold(tenantId, code, seq, campaignId);
+    if (result != Redeem::Ok)
+    {
+        callback(result, 0);
+        return;
+    }
+    confirm(seq, tenantId, campaignId, orderId, memberId, std::move(callback));
+}
+
+VoucherEngine::Redeem VoucherEngine::check(uint32_t tenantId, const std::string &code, uint32_t &campaignId) const
+{
+    if (!book_ || !logOpen_)
+        return Redeem::Disabled;
+    uint64_t seq = 0;
+    auto result = resultOf(book_->peek(code, tenantId, seq, campaignId));
+    if (result == Redeem::Ok && !app().getPlugin<PricingEngine>()->campaignActive(tenantId, campaignId))
+        return Redeem::Inactive;
+    return result;
+}
+
+VoucherEngine::Redeem VoucherEngine::hold(uint32_t tenantId, const std::string &code, uint64_t &seq, uint32_t &campaignId)
+{
+    if (!book_ || !logOpen_)
+        return Redeem::Disabled;
+    auto result = resultOf(book_->claim(code, tenantId, seq, campaignId));
+    if (result != Redeem::Ok)
+        return result;
+    // 先占用再查活动，查到不可用时放回
+    if (!app().getPlugin<PricingEngine>()->campaignActive(tenantId, campaignId))
+    {
+        release(seq);
+        return Redeem::Inactive;
+    }
+    return Redeem::Ok;
+}
+
+void VoucherEngine::release(uint64_t seq)
+{
+    if (book_)
+        book_->transition(seq, VoucherBook::Redeemed, VoucherBook::Available);
+}
+
+void VoucherEngine::confirm(uint64_t seq,
+                            uint32_t tenantId,
+                            uint32_t campaignId,
+                            uint32_t orderId,
+                            uint32_t memberId,
+                            RedeemCallback &&callback)
+{
+    Pending pending;
+    pending.record.seq = seq;
+    pending.record.tenantId = tenantId;
+    pending.record.campaignId = campaignId;
+    pending.record.orderId = orderId;
+    pending.record.memberId = memberId;
+    pending.record.at = trantor::Date::now().secondsSinceEpoch();
+    pending.callback = std::move(callback);
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        pending_.push_back(std::move(pending));
+    }
+    pendingCv_.notify_one();
+}
+
+void VoucherEngine::writeLoop()
+{
+    std::vector<Pending> batch;
+    std::vector<VoucherLog::Record> records;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(pendingMutex_);
+            pendingCv_.wait(lock, [this]() { return stopping_ || !pending_.empty(); });
+            if (pending_.empty())
+                return;
+            batch.swap(pending_);
+        }
+
+        // 组提交：排队期间到达的核销共用一次 fdatasync
+        records.clear();
+        for (const auto &item : batch)
+            records.push_back(item.record);
+        bool written;
+        {
+            std::lock_guard<std::mutex> logLock(logMutex_);
+            written = log_.append(records);
+            if (written)
+            {
+                std::lock_guard<std::mutex> lock(persistMutex_);
+                logged_ += records.size();
+                unpersisted_.insert(unpersisted_.end(), records.begin(), records.end());
+            }
+        }
+        if (!written)
+            LOG_ERROR << "Failed to write " << records.size() << " voucher redemptions to log";
+
+        for (auto &item : batch)
+        {
+            if (written)
+            {
+                item.callback(Redeem::Ok, item.record.campaignId);
+            }
+            else
+            {
+                book_->transition(item.record.seq, VoucherBook::Redeemed, VoucherBook::Available);
+                item.callback(Redeem::Failed, 0);
+            }
+        }
+        batch.clear();
+    }
+}
+
+void VoucherEngine::persist()
+{
+    auto rows = std::make_shared<std::vector<VoucherLog::Record>>();
+    {
+        std::lock_guard<std::mutex> lock(persistMutex_);
+        if (persisting_ || unpersisted_.empty())
+            return;
+        auto n = std::min(persistBatch_, unpersisted_.size());
+        rows->assign(unpersisted_.begin(), unpersisted_.begin() + n);
+        persisting_ = true;
+    }
+
+    std::string sql = "insert into voucher (voucher_id, voucher_code, tenant_id, campaign_id, status, order_id, "
+                      "member_id, redeemed_at) values ";
+    for (size_t i = 0; i < rows->size(); ++i)
+        sql += i == 0 ? "(?, ?, ?, ?, ?, nullif(?, 0), nullif(?, 0), ?)" : ", (?, ?, ?, ?, ?, nullif(?, 0), nullif(?, 0), ?)";
+    sql += " on duplicate key update status = values(status), order_id = values(order_id), "
+           "member_id = values(member_id), redeemed_at = values(redeemed_at)";
+    auto binder = *dbClient_ << std::move(sql);
+    for (const auto &row : *rows)
+        binder << row.seq << book_->encode(row.seq) << row.tenantId << row.campaignId << kRedeemed << row.orderId
+               << row.memberId << trantor::Date(row.at * 1000000).toDbStringLocal();
+    binder >> [this, rows](const Result &)
+    {
+        std::lock_guard<std::mutex> logLock(logMutex_);
+        std::lock_guard<std::mutex> lock(persistMutex_);
+        unpersisted_.erase(unpersisted_.begin(), unpersisted_.begin() + rows->size());
+        persisted_ += rows->size();
+        persisting_ = false;
+        // 日志中的核销都已落库，截断日志
+        if (unpersisted_.empty() && persisted_ == logged_ && log_.truncate())
+            logged_ = persisted_ = 0;
+    };
+    binder >> [this](const DrogonDbException &e)
+    {
+        LOG_ERROR << "Failed to persist voucher redemptions: " << e.base().what();
+        std::lock_guard<std::mutex> lock(persistMutex_);
+        persisting_ = false;
+    };
+}
@@ -0,0 +1,116 @@
+/**
+ *
+ *  VoucherEngine.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/orm/DbClient.h>
+#include <trantor/net/EventLoop.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "VoucherBook.h"
+#include "VoucherLog.h"
+
+/**
+ * @brief 营销活动单次券的发放和核销。
+ *
+ * 启动时把 voucher 表全部载入 VoucherBook，再重放核销日志中尚未落库的记录。
+ * 核销先在内存中 CAS 抢占，成功后交给写日志线程组提交，落盘后才回调成功；
+ * 日志写失败时回退抢占。已落盘的核销每 persist_interval 秒批量写回 voucher 表，
+ * 日志中的记录全部落库后截断日志。
+ * 只有活动未删除、进行中且在起止时间内的券可以核销。下单时先 hold 占用券，订单写库后
+ * confirm 写日志，写库失败时 release。
+ * 券码密钥取环境变量 VOUCHER_CODE_SECRET，没有时取配置 code_secret；都未配置时发券和核销均返回错误。
+ */
+class VoucherEngine : public drogon::Plugin<VoucherEngine>
+{
+public:
+  VoucherEngine() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  /// 为活动生成 count 张券，全部落库后回调券码；活动不存在或不属于该租户时 codes 为空，未配置密钥时回调错误
+  void issue(uint32_t tenantId,
+             uint32_t campaignId,
+             uint32_t count,
+             std::function<void(std::vector<std::string> codes)> &&callback,
+             std::function<void(const std::string &message)> &&errorCallback);
+
+  enum class Redeem
+  {
+    Ok,
+    Invalid,
+    AlreadyRedeemed,
+    Voided,
+    Inactive, // 活动已删除、未开始、已结束或没有计价规则
+    Disabled, // 未配置密钥或核销日志打不开
+    Failed    // 日志写入失败，券未被占用
+  };
+  static std::string describe(Redeem result);
+  using RedeemCallback = std::function<void(Redeem result, uint32_t campaignId)>;
+  /// 核销，写入日志后回调，回调可能在写日志线程中执行
+  void redeem(uint32_t tenantId, const std::string &code, uint32_t orderId, uint32_t memberId, RedeemCallback &&callback);
+  /// 与核销相同的校验，不占用券，用于试算
+  Redeem check(uint32_t tenantId, const std::string &code, uint32_t &campaignId) const;
+  /// 在内存中占用券，之后须 confirm 或 release；confirm 前进程退出时券仍可用
+  Redeem hold(uint32_t tenantId, const std::string &code, uint64_t &seq, uint32_t &campaignId);
+  void release(uint64_t seq);
+  /// 把 hold 占用的券写入日志，失败时回退占用并以 Failed 回调
+  void confirm(uint64_t seq,
+               uint32_t tenantId,
+               uint32_t campaignId,
+               uint32_t orderId,
+               uint32_t memberId,
+               RedeemCallback &&callback);
+
+  uint32_t maxIssue() const { return maxIssue_; }
+
+private:
+  struct Pending
+  {
+    VoucherLog::Record record;
+    RedeemCallback callback;
+  };
+
+  void load();
+  void writeLoop();
+  void persist();
+
+  drogon::orm::DbClientPtr dbClient_;
+  std::unique_ptr<VoucherBook> book_; // 未配置密钥时为空
+  VoucherLog log_;
+  bool logOpen_{false};
+  uint32_t maxIssue_{10000};
+  size_t persistBatch_{1000};
+  trantor::TimerId timerId_{0};
+
+  // 等待写日志的核销
+  std::mutex pendingMutex_;
+  std::condition_variable pendingCv_;
+  std::vector<Pending> pending_;
+  bool stopping_{false};
+  std::thread writer_;
+
+  std::mutex logMutex_; // 写日志和截断互斥
+  // 已写日志、尚未落库的核销；logged_ / persisted_ 为上次截断以来的条数
+  std::mutex persistMutex_;
+  std::deque<VoucherLog::Record> unpersisted_;
+  bool persisting_{false};
+  uint64_t logged_{0};
+  uint64_t persisted_{0};
+};
@@ -0,0 +1,171 @@
+/**
+ *
+ *  VoucherLog.cc
+ *
+ */
+
+#include "VoucherLog.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+constexpr uint32_t kMagic = 0x56434852; // "VCHR"
+constexpr size_t kRecordSize = 40;
+
+void put32(unsigned char *p, uint32_t v)
+{
+    for (int i = 0; i < 4; ++i)
+        p[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+void put64(unsigned char *p, uint64_t v)
+{
+    for (int i = 0; i < 8; ++i)
+        p[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+uint32_t get32(const unsigned char *p)
+{
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; --i)
+        v = (v << 8) | p[i];
+    return v;
+}
+
+uint64_t get64(const unsigned char *p)
+{
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; --i)
+        v = (v << 8) | p[i];
+    return v;
+}
+
+// FNV-1a
+uint32_t checksum(const unsigned char *p, size_t n)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < n; ++i)
+        h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+// magic | seq | tenant | campaign | order | member | at | checksum
+void encodeRecord(const VoucherLog::Record &record, unsigned char *p)
+{
+    put32(p, kMagic);
+    put64(p + 4, record.seq);
+    put32(p + 12, record.tenantId);
+    put32(p + 16, record.campaignId);
+    put32(p + 20, record.orderId);
+    put32(p + 24, record.memberId);
+    put64(p + 28, static_cast<uint64_t>(record.at));
+    put32(p + 36, checksum(p, 36));
+}
+
+bool decodeRecord(const unsigned char *p, VoucherLog::Record &record)
+{
+    if (get32(p) != kMagic || get32(p + 36) != checksum(p, 36))
+        return false;
+    record.seq = get64(p + 4);
+    record.tenantId = get32(p + 12);
+    record.campaignId = get32(p + 16);
+    record.orderId = get32(p + 20);
+    record.memberId = get32(p + 24);
+    record.at = static_cast<int64_t>(get64(p + 28));
+    return true;
+}
+} // namespace
+
+VoucherLog::~VoucherLog()
+{
+    if (fd_ >= 0)
+        ::close(fd_);
+}
+
+bool VoucherLog::open(const std::string &path, std::string &error)
+{
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0640);
+    if (fd_ < 0)
+    {
+        error = std::strerror(errno);
+        return false;
+    }
+    auto end = ::lseek(fd_, 0, SEEK_END);
+    size_ = end < 0 ? 0 : static_cast<uint64_t>(end);
+    return true;
+}
+
+size_t VoucherLog::replay(const std::function<void(const Record &)> &callback)
+{
+    size_t count = 0;
+    uint64_t valid = 0;
+    unsigned char buffer[kRecordSize * 256];
+    size_t filled = 0;
+    bool corrupted = false;
+    while (!corrupted)
+    {
+        auto n = ::pread(fd_, buffer + filled, sizeof(buffer) - filled, static_cast<off_t>(valid + filled));
+        if (n <= 0)
+            break;
+        filled += static_cast<size_t>(n);
+        size_t used = 0;
+        for (; used + kRecordSize <= filled; used += kRecordSize)
+        {
+            Record record;
+            if (!decodeRecord(buffer + used, record))
+            {
+                corrupted = true;
+                break;
+            }
+            callback(record);
+            ++count;
+            valid += kRecordSize;
+        }
+        std::memmove(buffer, buffer + used, filled - used);
+        filled -= used;
+    }
+    // 丢弃末尾不完整或损坏的记录，后续追加从有效末尾开始
+    if (valid != size_ && ::ftruncate(fd_, static_cast<off_t>(valid)) == 0)
+        size_ = valid;
+    return count;
+}
+
+bool VoucherLog::append(const std::vector<Record> &records)
+{
+    if (records.empty())
+        return true;
+    std::vector<unsigned char> buffer(records.size() * kRecordSize);
+    for (size_t i = 0; i < records.size(); ++i)
+        encodeRecord(records[i], buffer.data() + i * kRecordSize);
+
+    size_t written = 0;
+    while (written < buffer.size())
+    {
+        auto n = ::pwrite(fd_, buffer.data() + written, buffer.size() - written, static_cast<off_t>(size_ + written));
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        written += static_cast<size_t>(n);
+    }
+    if (written != buffer.size() || ::fdatasync(fd_) != 0)
+    {
+        // 截掉可能写了一部分的记录，调用方回退本批核销
+        if (::ftruncate(fd_, static_cast<off_t>(size_)) != 0)
+            size_ = static_cast<uint64_t>(::lseek(fd_, 0, SEEK_END));
+        return false;
+    }
+    size_ += buffer.size();
+    return true;
+}
+
+bool VoucherLog::truncate()
+{
+    if (::ftruncate(fd_, 0) != 0 || ::fdatasync(fd_) != 0)
+        return false;
+    size_ = 0;
+    return true;
+}
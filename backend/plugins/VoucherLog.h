@@ -0,0 +1,48 @@
+/**
+ *
+ *  VoucherLog.h
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 核销记录的追加日志。
+ *
+ * 每条记录定长 40 字节并带校验，批量 write 后 fdatasync 一次（组提交）。
+ * 日志中的记录全部写入数据库后截断；启动时重放，末尾写了一半的记录被忽略。
+ */
+class VoucherLog
+{
+public:
+  struct Record
+  {
+    uint64_t seq{0};
+    uint32_t tenantId{0};
+    uint32_t campaignId{0};
+    uint32_t orderId{0};
+    uint32_t memberId{0};
+    int64_t at{0}; // 秒
+  };
+
+  VoucherLog() = default;
+  ~VoucherLog();
+  VoucherLog(const VoucherLog &) = delete;
+  VoucherLog &operator=(const VoucherLog &) = delete;
+
+  bool open(const std::string &path, std::string &error);
+  /// 按写入顺序回调每条完整记录，返回记录数
+  size_t replay(const std::function<void(const Record &)> &callback);
+  /// 写入并落盘，失败时文件截回写入前的长度
+  bool append(const std::vector<Record> &records);
+  bool truncate();
+
+private:
+  int fd_{-1};
+  uint64_t size_{0};
+};
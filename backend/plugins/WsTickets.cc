@@ -0,0 +1,61 @@
+/**
+ *
+ *  WsTickets.cc
+ *
+ */
+
+#include "WsTickets.h"
+#include <drogon/drogon.h>
+#include <drogon/utils/Utilities.h>
+
+using namespace drogon;
+
+namespace
+{
+double nowSeconds()
+{
+    return static_cast<double>(trantor::Date::now().microSecondsSinceEpoch()) / 1e6;
+}
+} // namespace
+
+void WsTickets::initAndStart(const Json::Value &config)
+{
+    ttl_ = config.get("ttl", 30.0).asDouble();
+}
+
+void WsTickets::shutdown()
+{
+}
+
+std::string WsTickets::issue(const std::string &path)
+{
+    auto now = nowSeconds();
+    // 64 位十六进制，拼两个随机 UUID
+    auto ticket = utils::getUuid() + utils::getUuid();
+    std::lock_guard<std::mutex> lock(mutex_);
+    prune(now);
+    tickets_[ticket] = Ticket{path, now + ttl_};
+    return ticket;
+}
+
+bool WsTickets::consume(const std::string &ticket, const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = tickets_.find(ticket);
+    if (it == tickets_.end())
+        return false;
+    bool valid = it->second.path == path && it->second.expiresAt >= nowSeconds();
+    tickets_.erase(it);
+    return valid;
+}
+
+void WsTickets::prune(double now)
+{
+    for (auto it = tickets_.begin(); it != tickets_.end();)
+    {
+        if (it->second.expiresAt < now)
+            it = tickets_.erase(it);
+        else
+            ++it;
+    }
+}
@@ -0,0 +1,50 @@
+/**
+ *
+ *  WsTickets.h
+ *
+ */
+
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief WebSocket 连接用的一次性票据。
+ *
+ * 浏览器 WebSocket 无法设置 Authorization 请求头，已登录的前端先用 JWT 调 /api/ws/ticket
+ * 换取绑定某个 /ws/ 路径的短期票据，再以 ticket 参数发起升级请求；票据验过即作废，
+ * JWT 不再出现在 URL、访问日志和代理日志中。
+ */
+class WsTickets : public drogon::Plugin<WsTickets>
+{
+public:
+  WsTickets() {}
+  /// This method must be called by drogon to initialize and start the plugin.
+  /// It must be implemented by the user.
+  void initAndStart(const Json::Value &config) override;
+
+  /// This method must be called by drogon to shutdown the plugin.
+  /// It must be implemented by the user.
+  void shutdown() override;
+
+  /// 为 path 签发票据
+  std::string issue(const std::string &path);
+  /// 票据存在、未过期且绑定 path 时返回 true，无论结果如何票据都作废
+  bool consume(const std::string &ticket, const std::string &path);
+  double ttl() const { return ttl_; }
+
+private:
+  struct Ticket
+  {
+    std::string path;
+    double expiresAt; // 秒
+  };
+  void prune(double now);
+
+  double ttl_{30.0};
+  std::mutex mutex_;
+  std::unordered_map<std::string, Ticket> tickets_;
+};
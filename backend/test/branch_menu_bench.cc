@@ -0,0 +1,207 @@
+// 分店菜单压测：一个租户菜单、若干分店各有少量覆盖；
+// 对比"总店快照 + 分店覆盖逐个合并"与"每个分店复制一份完整菜单"的内存、整单读取和单条修改耗时，
+// 并用随机的增删覆盖与 std::map 逐条核对
+#include "plugins/BranchOverlay.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+const std::string kStatuses[] = {"在售", "售罄", "下架"};
+
+BranchOverlay::Override randomOverride(std::mt19937 &rng, uint32_t dishes)
+{
+    BranchOverlay::Override delta;
+    delta.dishId = 1 + rng() % dishes;
+    if (rng() % 2)
+        delta.price = Money::fromRaw(static_cast<int64_t>(500 + rng() % 10000));
+    if (rng() % 3 == 0)
+        delta.status = kStatuses[rng() % 3];
+    if (rng() % 3 == 0)
+        delta.stock = rng() % 100;
+    return delta;
+}
+
+size_t dishBytes(const MenuSnapshot::Dish &dish)
+{
+    return sizeof(dish) + dish.name.capacity() + dish.description.capacity() + dish.status.capacity() +
+           dish.coverImg.capacity();
+}
+
+size_t overlayBytes(const BranchOverlay &overlay)
+{
+    size_t bytes = sizeof(overlay) + overlay.overrides().capacity() * sizeof(BranchOverlay::Override);
+    for (const auto &delta : overlay.overrides())
+        if (delta.status)
+            bytes += delta.status->capacity();
+    return bytes;
+}
+
+// 对照组：把覆盖直接写进一份菜单副本
+std::vector<MenuSnapshot::Dish> copyOf(const MenuSnapshot &menu, const BranchOverlay &overlay)
+{
+    auto dishes = menu.dishes();
+    for (auto &dish : dishes)
+    {
+        auto delta = overlay.find(dish.dishId);
+        if (!delta)
+            continue;
+        if (delta->price)
+            dish.price = *delta->price;
+        if (delta->status)
+            dish.status = *delta->status;
+        if (delta->stock)
+            dish.stock = *delta->stock;
+    }
+    return dishes;
+}
+
+bool same(const BranchOverlay::Effective &effective, const MenuSnapshot::Dish &copy)
+{
+    return effective.dish->dishId == copy.dishId && effective.price == copy.price && *effective.status == copy.status &&
+           effective.stock == copy.stock;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const uint32_t dishes = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 300;
+    const uint32_t branches = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 200;
+    const uint32_t perBranch = argc > 3 ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 20;
+    const int rounds = 200;
+
+    std::mt19937 rng(42);
+    MenuSnapshot::Sources sources;
+    for (uint32_t id = 1; id <= 20; ++id)
+        sources.categories.set(CategoryTree::Category{id, id > 5 ? 1 + id % 5 : 0, "分类" + std::to_string(id), 0});
+    for (uint32_t id = 1; id <= dishes; ++id)
+    {
+        MenuSnapshot::Dish dish;
+        dish.dishId = id;
+        dish.categoryId = 1 + rng() % 20;
+        dish.name = "招牌菜品第" + std::to_string(id) + "号";
+        dish.description = "选用当季食材，现点现做，口味可按需调整";
+        dish.status = rng() % 20 == 0 ? "下架" : "在售";
+        dish.coverImg = "https://cdn.example.com/dish/" + std::to_string(id) + ".jpg";
+        dish.price = Money::fromRaw(static_cast<int64_t>(500 + rng() % 10000));
+        dish.stock = rng() % 500;
+        sources.dishes[id] = dish;
+    }
+    auto menu = MenuSnapshot::build(1, 1, sources, 0);
+
+    std::vector<std::shared_ptr<const BranchOverlay>> overlays;
+    std::vector<std::vector<MenuSnapshot::Dish>> copies;
+    for (uint32_t branchId = 1; branchId <= branches; ++branchId)
+    {
+        std::vector<BranchOverlay::Override> overrides;
+        for (uint32_t i = 0; i < perBranch; ++i)
+            overrides.push_back(randomOverride(rng, dishes));
+        overlays.push_back(std::make_shared<const BranchOverlay>(branchId, 1, std::move(overrides)));
+        copies.push_back(copyOf(*menu, *overlays.back()));
+    }
+
+    size_t baseBytes = 0;
+    for (const auto &dish : menu->dishes())
+        baseBytes += dishBytes(dish);
+    size_t overlayTotal = baseBytes;
+    for (const auto &overlay : overlays)
+        overlayTotal += overlayBytes(*overlay);
+    size_t copyTotal = 0;
+    for (const auto &copy : copies)
+        for (const auto &dish : copy)
+            copyTotal += dishBytes(dish);
+    std::printf("%u dishes, %u branches, %u overrides each\n", dishes, branches, perBranch);
+    std::printf("memory: overlay %zu KB, copies %zu KB\n", overlayTotal / 1024, copyTotal / 1024);
+
+    // 整单读取：每次取一个分店的全部菜品生效值
+    uint64_t errors = 0;
+    int64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round)
+        for (const auto &overlay : overlays)
+            for (const auto &dish : menu->dishes())
+            {
+                auto effective = overlay->resolve(dish);
+                checksum += effective.price.raw() + effective.stock;
+            }
+    auto overlayUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round)
+        for (const auto &copy : copies)
+            for (const auto &dish : copy)
+                checksum -= dish.price.raw() + dish.stock;
+    auto copyUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    if (checksum != 0)
+        ++errors;
+    const double menus = static_cast<double>(rounds) * branches;
+    std::printf("read whole branch menu: overlay %.2f us, copy %.2f us\n", overlayUs / menus, copyUs / menus);
+
+    // 单条修改：覆盖写时复制 vs 重新复制整份菜单
+    const int updates = 2000;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < updates; ++i)
+    {
+        auto &overlay = overlays[i % branches];
+        overlay = overlay->with(randomOverride(rng, dishes));
+    }
+    auto withUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < updates; ++i)
+        copies[i % branches] = copyOf(*menu, *overlays[i % branches]);
+    auto recopyUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    std::printf("update one override: overlay %.2f us, copy %.2f us\n", withUs / updates, recopyUs / updates);
+
+    // 随机增删与 std::map 对照，旧版本不受新版本影响
+    std::map<uint32_t, BranchOverlay::Override> expected;
+    auto overlay = std::make_shared<const BranchOverlay>(0, 1);
+    for (int i = 0; i < 20000; ++i)
+    {
+        auto previous = overlay;
+        auto before = previous->overrides().size();
+        if (rng() % 3 == 0)
+        {
+            auto dishId = 1 + rng() % dishes;
+            expected.erase(dishId);
+            overlay = overlay->without(dishId);
+        }
+        else
+        {
+            auto delta = randomOverride(rng, dishes);
+            expected[delta.dishId] = delta;
+            overlay = overlay->with(delta);
+        }
+        if (previous->overrides().size() != before || overlay->overrides().size() != expected.size())
+            ++errors;
+    }
+    auto it = expected.begin();
+    for (const auto &delta : overlay->overrides())
+    {
+        if (it == expected.end() || it->first != delta.dishId || it->second.price != delta.price ||
+            it->second.status != delta.status || it->second.stock != delta.stock)
+            ++errors;
+        ++it;
+    }
+    auto copy = copyOf(*menu, *overlay);
+    for (size_t i = 0; i < copy.size(); ++i)
+        if (!same(overlay->resolve(menu->dishes()[i]), copy[i]))
+            ++errors;
+    for (size_t b = 0; b < overlays.size(); ++b)
+        for (size_t i = 0; i < copies[b].size(); ++i)
+            if (!same(overlays[b]->resolve(menu->dishes()[i]), copies[b][i]))
+                ++errors;
+
+    if (errors != 0)
+    {
+        std::printf("INCONSISTENT: %llu errors\n", static_cast<unsigned long long>(errors));
+        return 1;
+    }
+    std::printf("consistent\n");
+    return 0;
+}
@@ -0,0 +1,100 @@
+// 分店菜单覆盖：生效值合并、写时复制的新旧版本互不影响
+#include <drogon/drogon_test.h>
+#include "plugins/BranchOverlay.h"
+
+namespace
+{
+MenuSnapshot::Dish dish(uint32_t dishId, int64_t price, const std::string &status, uint32_t stock)
+{
+    MenuSnapshot::Dish dish;
+    dish.dishId = dishId;
+    dish.name = "菜品" + std::to_string(dishId);
+    dish.status = status;
+    dish.price = Money::fromRaw(price);
+    dish.stock = stock;
+    return dish;
+}
+
+BranchOverlay::Override priceOf(uint32_t dishId, int64_t price)
+{
+    BranchOverlay::Override delta;
+    delta.dishId = dishId;
+    delta.price = Money::fromRaw(price);
+    return delta;
+}
+} // namespace
+
+DROGON_TEST(BranchOverlayResolve)
+{
+    auto base = dish(1, 2800, "在售", 50);
+    BranchOverlay empty(7, 3);
+    auto effective = empty.resolve(base);
+    CHECK(effective.dish == &base);
+    CHECK(effective.price == base.price);
+    CHECK(effective.status == &base.status);
+    CHECK(effective.stock == 50);
+    CHECK(effective.delta == nullptr);
+
+    // 只覆盖写了的字段，其余取总店
+    BranchOverlay::Override soldOut;
+    soldOut.dishId = 1;
+    soldOut.status = "售罄";
+    auto overlay = empty.with(soldOut);
+    effective = overlay->resolve(base);
+    CHECK(*effective.status == "售罄");
+    CHECK(effective.price == base.price);
+    CHECK(effective.stock == 50);
+    REQUIRE(effective.delta != nullptr);
+    CHECK(!effective.delta->price);
+
+    auto priced = soldOut;
+    priced.price = Money::fromRaw(2500);
+    priced.stock = 0;
+    overlay = overlay->with(priced);
+    effective = overlay->resolve(base);
+    CHECK(effective.price == Money::fromRaw(2500));
+    CHECK(*effective.status == "售罄");
+    // 库存覆盖为 0 也生效
+    CHECK(effective.stock == 0);
+    CHECK(overlay->overrides().size() == 1);
+
+    // 其他菜品不受影响
+    auto other = dish(2, 1200, "下架", 5);
+    effective = overlay->resolve(other);
+    CHECK(effective.price == other.price);
+    CHECK(*effective.status == "下架");
+    CHECK(effective.delta == nullptr);
+}
+
+DROGON_TEST(BranchOverlayCopyOnWrite)
+{
+    // 批量载入时同一菜品保留最后一条，结果按菜品ID升序
+    BranchOverlay loaded(7, 3, {priceOf(5, 500), priceOf(2, 200), priceOf(5, 550), priceOf(9, 900)});
+    CHECK(loaded.branchId() == 7);
+    CHECK(loaded.tenantId() == 3);
+    REQUIRE(loaded.overrides().size() == 3);
+    CHECK(loaded.overrides()[0].dishId == 2);
+    CHECK(loaded.overrides()[1].dishId == 5);
+    CHECK(loaded.overrides()[2].dishId == 9);
+    REQUIRE(loaded.find(5) != nullptr);
+    CHECK(*loaded.find(5)->price == Money::fromRaw(550));
+    CHECK(loaded.find(3) == nullptr);
+
+    // 新版本的增删不影响旧版本
+    auto added = loaded.with(priceOf(3, 300));
+    auto removed = added->without(5);
+    auto untouched = removed->without(42);
+    CHECK(loaded.overrides().size() == 3);
+    CHECK(loaded.find(3) == nullptr);
+    CHECK(added->overrides().size() == 4);
+    REQUIRE(added->find(5) != nullptr);
+    CHECK(removed->find(5) == nullptr);
+    REQUIRE(removed->find(3) != nullptr);
+    CHECK(removed->overrides()[1].dishId == 3);
+    CHECK(untouched->overrides().size() == 3);
+    CHECK(untouched->branchId() == 7);
+
+    auto base = dish(5, 800, "在售", 10);
+    CHECK(loaded.resolve(base).price == Money::fromRaw(550));
+    CHECK(removed->resolve(base).price == Money::fromRaw(800));
+}
@@ -0,0 +1,148 @@
+// 群发投递压测：内存队列 + 会随机失败的本地替身发送器，校验限速、重试后每条消息恰有一个结果
+#include "plugins/BroadcastPump.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// 一成整批超时、百分之一单条被拒，其余写入本地文件
+class FlakySender : public BroadcastSender
+{
+public:
+    explicit FlakySender(const std::string &path) : sink_(path)
+    {
+    }
+
+    void send(const std::vector<BroadcastDelivery> &batch, std::vector<Outcome> &outcomes) override
+    {
+        ++batches;
+        if (rng_() % 10 == 0)
+        {
+            outcomes.assign(batch.size(), Outcome::Retry);
+            return;
+        }
+        sink_.send(batch, outcomes);
+        for (auto &outcome : outcomes)
+        {
+            if (rng_() % 100 == 0)
+                outcome = Outcome::Rejected;
+        }
+    }
+
+    std::atomic<uint64_t> batches{0};
+
+private:
+    FileSender sink_;
+    std::mt19937 rng_{7};
+};
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const uint64_t messages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    const double rate = argc > 2 ? std::atof(argv[2]) : 100000;
+    const std::string sinkPath = argc > 3 ? argv[3] : "broadcast_bench.jsonl";
+
+    // 内存队列：待发送的下标，重试的放回队尾
+    std::mutex mutex;
+    std::deque<uint64_t> queue;
+    std::vector<int64_t> nextAt(messages, 0);
+    std::vector<uint32_t> attempts(messages, 0);
+    std::vector<int> state(messages, 0); // 0 待发送，1 已发送，2 失败
+    for (uint64_t i = 0; i < messages; ++i)
+        queue.push_back(i);
+    std::atomic<uint64_t> done{0};
+
+    auto sender = std::make_shared<FlakySender>(sinkPath);
+    RetryPolicy retry;
+    retry.maxAttempts = 3;
+    retry.baseDelay = 0; // 压测中立即重试
+    BroadcastPump pump(
+        sender,
+        TokenBucket(rate, rate / 10),
+        retry,
+        500,
+        0.01,
+        [&](size_t limit, int64_t now)
+        {
+            std::vector<BroadcastDelivery> batch;
+            std::lock_guard<std::mutex> lock(mutex);
+            while (batch.size() < limit && !queue.empty() && nextAt[queue.front()] <= now)
+            {
+                auto i = queue.front();
+                queue.pop_front();
+                BroadcastDelivery delivery;
+                delivery.deliveryId = i + 1;
+                delivery.broadcastId = 1;
+                delivery.memberId = static_cast<uint32_t>(i % 100000 + 1);
+                delivery.address = "1380000" + std::to_string(i % 10000);
+                delivery.content = "周末会员日全场八折";
+                delivery.attempts = attempts[i];
+                batch.push_back(std::move(delivery));
+            }
+            return batch;
+        },
+        [&](const std::vector<BroadcastPump::Result> &results)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto &result : results)
+            {
+                auto i = result.deliveryId - 1;
+                attempts[i] = result.attempts;
+                if (result.state == BroadcastPump::Result::Retry)
+                {
+                    nextAt[i] = result.retryAt;
+                    queue.push_back(i);
+                    continue;
+                }
+                state[i] = result.state == BroadcastPump::Result::Sent ? 1 : 2;
+                ++done;
+            }
+        });
+
+    auto start = std::chrono::steady_clock::now();
+    pump.start();
+    while (done < messages)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    pump.stop();
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t sent = 0, failed = 0, retried = 0;
+    for (uint64_t i = 0; i < messages; ++i)
+    {
+        sent += state[i] == 1;
+        failed += state[i] == 2;
+        retried += attempts[i] > 1;
+    }
+    std::printf("%llu messages in %.2f s (%.0f/s, limit %.0f/s), %llu batches\n",
+                static_cast<unsigned long long>(messages),
+                seconds,
+                messages / seconds,
+                rate,
+                static_cast<unsigned long long>(sender->batches.load()));
+    std::printf("sent %llu, failed %llu, retried %llu\n",
+                static_cast<unsigned long long>(sent),
+                static_cast<unsigned long long>(failed),
+                static_cast<unsigned long long>(retried));
+    // 每次尝试都消耗令牌，含重试的总尝试次数不能明显超过限速
+    uint64_t totalAttempts = 0;
+    for (auto n : attempts)
+        totalAttempts += n;
+    auto allowed = rate * seconds + rate / 10 + 500;
+    if (sent + failed != messages || totalAttempts > allowed)
+    {
+        std::printf("INCONSISTENT: attempts %llu, allowed %.0f\n", static_cast<unsigned long long>(totalAttempts), allowed);
+        return 1;
+    }
+    std::printf("consistent, %llu attempts\n", static_cast<unsigned long long>(totalAttempts));
+    return 0;
+}
@@ -0,0 +1,196 @@
+// 群发 HTTP 渠道：本机回环的假网关按脚本应答，核对请求内容与各种应答对应的投递结果
+#include <drogon/drogon_test.h>
+#include <trantor/net/EventLoopThread.h>
+#include <trantor/net/TcpServer.h>
+#include "plugins/HttpSender.h"
+
+#include <cctype>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace
+{
+/**
+ * 最小的 HTTP/1.1 服务端：按 Content-Length 读完一个请求，记下请求行和请求体，
+ * 再按顺序取一条预设的应答；status 为 0 时不应答，用来模拟超时。
+ */
+class FakeGateway
+{
+public:
+    struct Reply
+    {
+        int status{200};
+        std::string body;
+    };
+
+    FakeGateway()
+    {
+        loop_.run();
+        std::promise<void> started;
+        loop_.getLoop()->runInLoop(
+            [this, &started]()
+            {
+                server_ = std::make_unique<trantor::TcpServer>(loop_.getLoop(),
+                                                               trantor::InetAddress("127.0.0.1", 0),
+                                                               "FakeGateway");
+                server_->setRecvMessageCallback(
+                    [this](const trantor::TcpConnectionPtr &conn, trantor::MsgBuffer *buffer) { receive(conn, buffer); });
+                server_->start();
+                started.set_value();
+            });
+        started.get_future().wait();
+    }
+
+    ~FakeGateway()
+    {
+        std::promise<void> stopped;
+        loop_.getLoop()->runInLoop(
+            [this, &stopped]()
+            {
+                server_.reset();
+                stopped.set_value();
+            });
+        stopped.get_future().wait();
+    }
+
+    std::string url() const
+    {
+        return "http://127.0.0.1:" + std::to_string(server_->address().toPort()) + "/sms/send";
+    }
+
+    void script(Reply reply)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        replies_.push_back(std::move(reply));
+    }
+
+    /// 收到的请求：请求行和请求体
+    std::vector<std::pair<std::string, std::string>> requests()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return requests_;
+    }
+
+private:
+    void receive(const trantor::TcpConnectionPtr &conn, trantor::MsgBuffer *buffer)
+    {
+        std::string data(buffer->peek(), buffer->readableBytes());
+        auto headerEnd = data.find("\r\n\r\n");
+        if (headerEnd == std::string::npos)
+            return;
+        size_t length = 0;
+        auto header = data.substr(0, headerEnd);
+        for (auto &c : header)
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        auto field = header.find("content-length:");
+        if (field != std::string::npos)
+            length = std::stoul(header.substr(field + 15));
+        if (data.size() < headerEnd + 4 + length)
+            return;
+        buffer->retrieve(headerEnd + 4 + length);
+
+        Reply reply;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            requests_.emplace_back(data.substr(0, data.find("\r\n")), data.substr(headerEnd + 4, length));
+            if (!replies_.empty())
+            {
+                reply = std::move(replies_.front());
+                replies_.pop_front();
+            }
+        }
+        if (reply.status == 0)
+            return;
+        conn->send("HTTP/1.1 " + std::to_string(reply.status) +
+                   " X\r\nContent-Type: application/json\r\nContent-Length: " + std::to_string(reply.body.size()) +
+                   "\r\n\r\n" + reply.body);
+    }
+
+    trantor::EventLoopThread loop_{"FakeGateway"};
+    std::unique_ptr<trantor::TcpServer> server_;
+    std::mutex mutex_;
+    std::deque<Reply> replies_;
+    std::vector<std::pair<std::string, std::string>> requests_;
+};
+
+std::vector<BroadcastDelivery> batchOf(size_t size)
+{
+    std::vector<BroadcastDelivery> batch;
+    for (size_t i = 1; i <= size; ++i)
+        batch.push_back({100 + i, 7, static_cast<uint32_t>(i), "1380000000" + std::to_string(i), "满100减20", 0});
+    return batch;
+}
+} // namespace
+
+DROGON_TEST(HttpSenderDelivers)
+{
+    using Outcome = BroadcastSender::Outcome;
+    FakeGateway gateway;
+    trantor::EventLoopThread clientLoop("HttpSenderTest");
+    clientLoop.run();
+    HttpSender sender(gateway.url(), clientLoop.getLoop(), 2.0);
+    auto batch = batchOf(3);
+    std::vector<Outcome> outcomes;
+
+    // 成功，其中一条被网关拒收
+    gateway.script({200, "{\"rejected\": [102]}"});
+    sender.send(batch, outcomes);
+    REQUIRE(outcomes.size() == 3);
+    CHECK(outcomes[0] == Outcome::Sent);
+    CHECK(outcomes[1] == Outcome::Rejected);
+    CHECK(outcomes[2] == Outcome::Sent);
+
+    auto requests = gateway.requests();
+    REQUIRE(requests.size() == 1);
+    CHECK(requests[0].first == "POST /sms/send HTTP/1.1");
+    Json::Value body;
+    std::string errs;
+    const auto &text = requests[0].second;
+    std::unique_ptr<Json::CharReader> reader(Json::CharReaderBuilder().newCharReader());
+    REQUIRE(reader->parse(text.data(), text.data() + text.size(), &body, &errs));
+    REQUIRE(body["messages"].size() == 3);
+    CHECK(body["messages"][0]["delivery_id"].asUInt64() == 101);
+    CHECK(body["messages"][2]["member_id"].asUInt() == 3);
+    CHECK(body["messages"][1]["address"].asString() == "13800000002");
+    CHECK(body["messages"][0]["content"].asString() == "满100减20");
+
+    // 限流和服务端错误整批重试，其余 4xx 整批放弃
+    gateway.script({429, "{}"});
+    sender.send(batch, outcomes);
+    CHECK(outcomes == std::vector<Outcome>(3, Outcome::Retry));
+    gateway.script({503, ""});
+    sender.send(batch, outcomes);
+    CHECK(outcomes == std::vector<Outcome>(3, Outcome::Retry));
+    gateway.script({400, "{\"error\": \"bad sign\"}"});
+    sender.send(batch, outcomes);
+    CHECK(outcomes == std::vector<Outcome>(3, Outcome::Rejected));
+    CHECK(gateway.requests().size() == 4);
+}
+
+DROGON_TEST(HttpSenderTimeout)
+{
+    using Outcome = BroadcastSender::Outcome;
+    std::string url;
+    trantor::EventLoopThread clientLoop("HttpSenderTest");
+    clientLoop.run();
+    std::vector<Outcome> outcomes;
+    {
+        // 网关收下请求但不应答
+        FakeGateway gateway;
+        url = gateway.url();
+        HttpSender sender(url, clientLoop.getLoop(), 0.5);
+        gateway.script({0, ""});
+        sender.send(batchOf(2), outcomes);
+        CHECK(outcomes == std::vector<Outcome>(2, Outcome::Retry));
+        CHECK(gateway.requests().size() == 1);
+    }
+
+    // 网关已关闭，连接失败
+    HttpSender sender(url, clientLoop.getLoop(), 0.5);
+    sender.send(batchOf(2), outcomes);
+    CHECK(outcomes == std::vector<Outcome>(2, Outcome::Retry));
+}
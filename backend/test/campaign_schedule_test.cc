@@ -0,0 +1,102 @@
+// 营销活动时间表：活动在开始、结束时刻的切换，与逐个活动判断的结果一致
+#include <drogon/drogon_test.h>
+#include "plugins/CampaignSchedule.h"
+
+#include <algorithm>
+#include <random>
+
+namespace
+{
+std::vector<uint32_t> idsOf(const std::vector<const CampaignSchedule::Campaign *> &campaigns)
+{
+    std::vector<uint32_t> ids;
+    for (const auto *campaign : campaigns)
+        ids.push_back(campaign->campaignId);
+    return ids;
+}
+} // namespace
+
+DROGON_TEST(CampaignScheduleTransitions)
+{
+    CampaignSchedule schedule;
+    schedule.set({1, 0, 100, 200, "午市"});
+    schedule.set({2, 3, 150, CampaignSchedule::kOpenEnd, "金卡长期"});
+    schedule.set({3, 0, 200, 300, "晚市"});
+
+    // 开始时刻生效，结束时刻失效
+    CHECK(idsOf(schedule.activeAt(99, 0)).empty());
+    CHECK(idsOf(schedule.activeAt(100, 0)) == std::vector<uint32_t>({1}));
+    CHECK(idsOf(schedule.activeAt(199, 3)) == std::vector<uint32_t>({1, 2}));
+    CHECK(idsOf(schedule.activeAt(200, 3)) == std::vector<uint32_t>({2, 3}));
+    CHECK(idsOf(schedule.activeAt(200, 1)) == std::vector<uint32_t>({3}));
+    CHECK(idsOf(schedule.activeAt(300, 0)).empty());
+    CHECK(idsOf(schedule.activeAt(1000000, 3)) == std::vector<uint32_t>({2}));
+    CHECK(schedule.boundariesIn(100, 300) == std::vector<int64_t>({100, 150, 200}));
+    CHECK(schedule.boundariesIn(0, 1000) == std::vector<int64_t>({100, 150, 200, 300}));
+    CHECK(schedule.nextChange(99) == 100);
+    CHECK(schedule.nextChange(200) == 300);
+    CHECK(schedule.nextChange(300) == CampaignSchedule::kOpenEnd);
+
+    // 延长、移除，以及结束不晚于开始的活动被移除
+    schedule.set({1, 0, 100, 250, "午市"});
+    CHECK(idsOf(schedule.activeAt(220, 0)) == std::vector<uint32_t>({1, 3}));
+    CHECK(schedule.remove(3));
+    CHECK(!schedule.remove(3));
+    CHECK(idsOf(schedule.activeAt(220, 0)) == std::vector<uint32_t>({1}));
+    schedule.set({1, 0, 300, 300, "午市"});
+    CHECK(schedule.find(1) == nullptr);
+    CHECK(schedule.size() == 1);
+    CHECK(schedule.boundariesIn(0, 1000) == std::vector<int64_t>({150}));
+
+    // 复制出的时间表与原表互不影响
+    auto copy = schedule;
+    CHECK(schedule.remove(2));
+    CHECK(idsOf(copy.activeAt(200, 3)) == std::vector<uint32_t>({2}));
+    CHECK(schedule.activeAt(200, 3).empty());
+}
+
+DROGON_TEST(CampaignScheduleMatchesScan)
+{
+    std::mt19937 rng(5);
+    CampaignSchedule schedule;
+    std::vector<CampaignSchedule::Campaign> all;
+    for (uint32_t id = 1; id <= 300; ++id)
+    {
+        int64_t start = rng() % 10000;
+        int64_t end = rng() % 8 == 0 ? CampaignSchedule::kOpenEnd : start + 1 + rng() % 2000;
+        all.push_back({id, static_cast<uint32_t>(rng() % 4), start, end, ""});
+        schedule.set(all.back());
+    }
+    // 随机替换、移除一部分
+    for (int i = 0; i < 100; ++i)
+    {
+        auto &campaign = all[rng() % all.size()];
+        if (rng() % 3 == 0)
+        {
+            schedule.remove(campaign.campaignId);
+            campaign.end = campaign.start;
+        }
+        else
+        {
+            campaign.start = rng() % 10000;
+            campaign.end = campaign.start + 1 + rng() % 2000;
+            schedule.set(campaign);
+        }
+    }
+
+    for (int64_t at = -1; at <= 12500; at += 7)
+    {
+        auto level = static_cast<uint32_t>(at % 4);
+        std::vector<const CampaignSchedule::Campaign *> expected;
+        for (const auto &campaign : all)
+        {
+            if (campaign.start <= at && at < campaign.end && (campaign.levelId == 0 || campaign.levelId == level))
+                expected.push_back(&campaign);
+        }
+        std::sort(expected.begin(),
+                  expected.end(),
+                  [](const CampaignSchedule::Campaign *a, const CampaignSchedule::Campaign *b)
+                  { return a->start != b->start ? a->start < b->start : a->campaignId < b->campaignId; });
+        CHECK(idsOf(schedule.activeAt(at, level)) == idsOf(expected));
+    }
+}
@@ -0,0 +1,140 @@
+// 分类树压测：随机生成多层分类（含成环、父分类缺失），统计重排和子树查询耗时，并与逐层查找子分类的结果比对
+#include "plugins/CategoryTree.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+double msSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 逐层找子分类，相当于原先按 parent_id 递归查询
+std::vector<uint32_t> walk(const std::vector<CategoryTree::Category> &all, const CategoryTree &tree, uint32_t categoryId)
+{
+    std::vector<uint32_t> result{categoryId};
+    for (size_t i = 0; i < result.size(); ++i)
+    {
+        for (const auto &category : all)
+        {
+            auto node = tree.find(category.categoryId);
+            if (category.categoryId != result[i] && node->parent == result[i])
+                result.push_back(category.categoryId);
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const uint32_t categories = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 500;
+    const uint32_t queries = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 100000;
+
+    // 分类ID打乱后逐个插入，父分类多数是更早的分类，少数指向不存在的分类、自身或更晚的分类（可能成环）
+    std::mt19937 rng(42);
+    std::vector<CategoryTree::Category> all;
+    for (uint32_t id = 1; id <= categories; ++id)
+    {
+        CategoryTree::Category category;
+        category.categoryId = id;
+        auto roll = rng() % 100;
+        if (id == 1 || roll < 10)
+            category.parentId = 0;
+        else if (roll < 92)
+            category.parentId = 1 + rng() % (id - 1);
+        else if (roll < 94)
+            category.parentId = categories + 1 + rng() % 100;
+        else if (roll < 96)
+            category.parentId = id;
+        else
+            category.parentId = 1 + rng() % categories;
+        category.name = "分类" + std::to_string(id);
+        category.sortOrder = static_cast<int32_t>(rng() % 5);
+        all.push_back(category);
+    }
+    auto shuffled = all;
+    std::shuffle(shuffled.begin(), shuffled.end(), rng);
+
+    auto start = std::chrono::steady_clock::now();
+    CategoryTree tree;
+    for (const auto &category : shuffled)
+        tree.set(category);
+    auto setMs = msSince(start);
+
+    uint64_t mismatches = 0;
+    if (tree.order().size() != tree.size())
+        ++mismatches;
+    // 每个分类都应在根到自己的路径上各祖先的区间内
+    for (const auto &category : all)
+    {
+        auto path = tree.pathOf(category.categoryId);
+        auto node = tree.find(category.categoryId);
+        if (path.empty() || path.back() != category.categoryId || path.size() != node->depth + 1)
+            ++mismatches;
+        for (auto ancestor : path)
+        {
+            if (!tree.contains(ancestor, category.categoryId))
+                ++mismatches;
+        }
+        // 能挂到原父分类上的必须挂上去
+        if (node->parent != 0 && node->parent != category.parentId)
+            ++mismatches;
+    }
+    for (uint32_t id = 1; id <= categories; id += std::max<uint32_t>(categories / 200, 1))
+    {
+        auto fast = tree.subtree(id);
+        std::sort(fast.begin(), fast.end());
+        if (fast != walk(all, tree, id))
+            ++mismatches;
+    }
+
+    start = std::chrono::steady_clock::now();
+    size_t total = 0;
+    for (uint32_t i = 0; i < queries; ++i)
+        total += tree.subtree(1 + rng() % categories).size();
+    auto queryMs = msSince(start);
+
+    start = std::chrono::steady_clock::now();
+    const uint32_t walks = std::min<uint32_t>(queries, 1000);
+    for (uint32_t i = 0; i < walks; ++i)
+        total += walk(all, tree, 1 + rng() % categories).size();
+    auto walkMs = msSince(start);
+
+    // 删掉一半后剩下的仍然自洽
+    for (uint32_t id = 2; id <= categories; id += 2)
+        tree.remove(id);
+    for (const auto &category : all)
+    {
+        auto node = tree.find(category.categoryId);
+        if (!node)
+            continue;
+        if (node->parent != 0 && (!tree.contains(node->parent, category.categoryId) || node->parent % 2 == 0))
+            ++mismatches;
+    }
+
+    std::printf("%u categories in %zu roots: insert one by one %.1f ms (%.1f us per rebuild)\n",
+                categories,
+                tree.roots().size(),
+                setMs,
+                setMs * 1000 / categories);
+    std::printf("subtree %.3f us per query, level-by-level walk %.1f us per query (%zu ids)\n",
+                queryMs * 1000 / queries,
+                walkMs * 1000 / walks,
+                total);
+    if (mismatches != 0)
+    {
+        std::printf("INCONSISTENT: %llu mismatches\n", static_cast<unsigned long long>(mismatches));
+        return 1;
+    }
+    std::printf("consistent\n");
+    return 0;
+}
@@ -0,0 +1,121 @@
+// 菜品分类树：先序编号、子树区间、同级排序，以及缺失父分类和成环时的处理
+#include <drogon/drogon_test.h>
+#include "plugins/CategoryTree.h"
+
+#include <map>
+#include <random>
+
+namespace
+{
+using Ids = std::vector<uint32_t>;
+
+CategoryTree::Category category(uint32_t categoryId, uint32_t parentId, int32_t sortOrder = 0)
+{
+    return CategoryTree::Category{categoryId, parentId, "分类" + std::to_string(categoryId), sortOrder};
+}
+} // namespace
+
+DROGON_TEST(CategoryTreeIntervals)
+{
+    CategoryTree tree;
+    // 1 热菜 ─ 3 川菜 ─ 5 水煮
+    //       └ 4 粤菜
+    // 2 饮品
+    tree.set(category(1, 0, 10));
+    tree.set(category(2, 0, 20));
+    tree.set(category(3, 1, 5));
+    tree.set(category(4, 1, 5));
+    tree.set(category(5, 3));
+    CHECK(tree.size() == 5);
+
+    // 同级按 sort_order 从大到小、再按ID
+    CHECK((tree.roots() == Ids{2, 1}));
+    CHECK((tree.childrenOf(1) == Ids{3, 4}));
+    CHECK((tree.order() == Ids{2, 1, 3, 5, 4}));
+    CHECK((tree.subtree(1) == Ids{1, 3, 5, 4}));
+    CHECK(tree.subtree(2) == Ids{2});
+    CHECK(tree.subtree(9).empty());
+    CHECK((tree.pathOf(5) == Ids{1, 3, 5}));
+    REQUIRE(tree.find(5) != nullptr);
+    CHECK(tree.find(5)->depth == 2);
+    CHECK(tree.contains(1, 5));
+    CHECK(tree.contains(3, 3));
+    CHECK(!tree.contains(4, 5));
+    CHECK(!tree.contains(2, 1));
+
+    // 改父分类后整棵子树跟着移动
+    tree.set(category(3, 2, 5));
+    CHECK((tree.subtree(2) == Ids{2, 3, 5}));
+    CHECK((tree.subtree(1) == Ids{1, 4}));
+    CHECK(tree.contains(2, 5));
+
+    // 删除父分类后子分类当作根
+    tree.remove(2);
+    CHECK(tree.find(2) == nullptr);
+    CHECK((tree.roots() == Ids{1, 3}));
+    CHECK((tree.pathOf(5) == Ids{3, 5}));
+    CHECK(tree.find(3)->parent == 0);
+}
+
+DROGON_TEST(CategoryTreeCycles)
+{
+    CategoryTree tree;
+    tree.set(category(1, 0));
+    // 自己做父分类的当作根
+    tree.set(category(2, 2));
+    // 5 和 6 互为父分类，从较小的ID断开
+    tree.set(category(5, 6));
+    tree.set(category(6, 5));
+    tree.set(category(7, 6));
+    CHECK(tree.order().size() == 5);
+    CHECK((tree.roots() == Ids{1, 2, 5}));
+    CHECK((tree.subtree(5) == Ids{5, 6, 7}));
+    CHECK((tree.pathOf(7) == Ids{5, 6, 7}));
+    CHECK(!tree.contains(6, 5));
+}
+
+DROGON_TEST(CategoryTreeMatchesParentWalk)
+{
+    std::mt19937 rng(23);
+    CategoryTree tree;
+    std::map<uint32_t, uint32_t> parents;
+    for (int step = 0; step < 2000; ++step)
+    {
+        auto categoryId = static_cast<uint32_t>(1 + rng() % 80);
+        if (rng() % 6 == 0)
+        {
+            tree.remove(categoryId);
+            parents.erase(categoryId);
+            continue;
+        }
+        // 只挂到ID更小的分类下，不成环
+        auto parentId = categoryId > 1 && rng() % 4 ? static_cast<uint32_t>(1 + rng() % (categoryId - 1)) : 0;
+        tree.set(category(categoryId, parentId, static_cast<int32_t>(rng() % 3)));
+        parents[categoryId] = parentId;
+    }
+    REQUIRE(tree.order().size() == parents.size());
+    auto ancestorOf = [&parents](uint32_t ancestor, uint32_t categoryId) {
+        for (auto current = categoryId; current != 0;)
+        {
+            if (current == ancestor)
+                return true;
+            auto it = parents.find(current);
+            current = it == parents.end() ? 0 : it->second;
+            if (current != 0 && parents.count(current) == 0)
+                current = 0;
+        }
+        return false;
+    };
+    for (const auto &[a, pa] : parents)
+        for (const auto &[b, pb] : parents)
+            CHECK(tree.contains(a, b) == ancestorOf(a, b));
+    // 先序序列里子树是连续的一段
+    for (const auto &[categoryId, parentId] : parents)
+    {
+        auto subtree = tree.subtree(categoryId);
+        REQUIRE(!subtree.empty());
+        CHECK(subtree.front() == categoryId);
+        for (auto inner : subtree)
+            CHECK(ancestorOf(categoryId, inner));
+    }
+}
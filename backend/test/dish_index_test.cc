@@ -0,0 +1,25 @@
+// 菜品检索：拼音首字母覆盖基本汉字区，GB2312 一级汉字之外的菜名也能按首字母搜到
+#include <drogon/drogon_test.h>
+#include "plugins/DishIndex.h"
+
+DROGON_TEST(DishIndexInitials)
+{
+    // GB2312 一级汉字
+    CHECK(DishIndex::initialOf(U'鸡') == U'j');
+    CHECK(DishIndex::initialOf(U'菜') == U'c');
+    CHECK(DishIndex::initialOf(U'啊') == U'a');
+    CHECK(DishIndex::initialOf(U'座') == U'z');
+    // 二级汉字和 GB2312 之外的汉字
+    CHECK(DishIndex::initialOf(U'馄') == U'h');
+    CHECK(DishIndex::initialOf(U'饨') == U't');
+    CHECK(DishIndex::initialOf(U'鳕') == U'x');
+    CHECK(DishIndex::initialOf(U'鲟') == U'x');
+    CHECK(DishIndex::initialOf(U'䶮') == 0);
+    CHECK(DishIndex::initialOf(U'a') == 0);
+    CHECK(DishIndex::initialOf(U'。') == 0);
+
+    // 英文数字原样保留
+    CHECK(DishIndex::initialsOf(DishIndex::normalize("鲜虾馄饨")) == U"xxht");
+    CHECK(DishIndex::initialsOf(DishIndex::normalize("香煎鳕鱼")) == U"xjxy");
+    CHECK(DishIndex::initialsOf(DishIndex::normalize("可乐330ml")) == U"kl330ml");
+}
@@ -0,0 +1,137 @@
+// 菜品检索压测：随机生成菜单后按菜名片段、拼音首字母和多词查询，统计耗时并与逐个扫描的结果比对
+#include "plugins/DishIndex.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+const char *kWords[] = {"宫保", "鸡丁", "红烧", "牛肉", "酸菜", "鱼", "麻婆", "豆腐", "回锅", "肉", "清蒸", "鲈鱼",
+                        "干煸", "四季豆", "糖醋", "里脊", "水煮", "肉片", "番茄", "炒蛋", "蒜蓉", "西兰花", "米饭", "可乐"};
+const char *kDescriptions[] = {"经典川菜", "微辣", "招牌", "下饭", "清淡", "冰镇", "现做", "Spicy"};
+
+bool contains(const std::u32string &text, const std::u32string &term)
+{
+    return text.find(term) != std::u32string::npos;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const uint32_t dishes = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 5000;
+    const uint32_t queries = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 20000;
+    const size_t limit = 20;
+
+    std::mt19937 rng(42);
+    std::vector<DishIndex::Dish> menu;
+    DishIndex index;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t id = 1; id <= dishes; ++id)
+    {
+        DishIndex::Dish dish;
+        dish.dishId = id;
+        dish.name = std::string(kWords[rng() % 24]) + kWords[rng() % 24];
+        if (rng() % 3 == 0)
+            dish.name += "（大份）";
+        dish.description = std::string(kDescriptions[rng() % 8]) + "，" + kDescriptions[rng() % 8];
+        dish.sortOrder = static_cast<int32_t>(rng() % 10);
+        dish.sales = static_cast<uint32_t>(rng() % 1000);
+        menu.push_back(dish);
+        index.set(dish);
+    }
+    auto loadUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / dishes;
+
+    // 菜名片段、单字、拼音首字母、描述加菜名的多词查询
+    std::vector<std::string> samples;
+    for (uint32_t i = 0; i < queries; ++i)
+    {
+        const auto &dish = menu[rng() % menu.size()];
+        auto name = DishIndex::normalize(dish.name);
+        switch (rng() % 4)
+        {
+        case 0:
+            samples.push_back(kWords[rng() % 24]);
+            break;
+        case 1:
+            samples.push_back(dish.name.substr(0, 3));
+            break;
+        case 2:
+        {
+            std::string initials;
+            for (auto ch : DishIndex::initialsOf(name))
+                initials.push_back(ch == 0 ? ' ' : static_cast<char>(ch));
+            samples.push_back(initials.substr(0, 2 + rng() % 3));
+            break;
+        }
+        default:
+            samples.push_back(std::string(kDescriptions[rng() % 8]) + " " + kWords[rng() % 24]);
+            break;
+        }
+    }
+
+    size_t found = 0;
+    start = std::chrono::steady_clock::now();
+    for (const auto &query : samples)
+        found += index.search(query, limit).size();
+    auto queryUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / queries;
+
+    // 抽查：返回的都命中且有序，不足 limit 时与逐个扫描的结果相同
+    uint64_t mismatches = 0;
+    for (uint32_t i = 0; i < 500 && i < queries; ++i)
+    {
+        std::vector<std::u32string> terms;
+        auto normalized = DishIndex::normalize(samples[i]);
+        for (size_t begin = 0; begin < normalized.size();)
+        {
+            auto end = std::min(normalized.find(char32_t(0), begin), normalized.size());
+            terms.push_back(normalized.substr(begin, end - begin));
+            begin = end + 1;
+        }
+        auto matches = [&terms](const DishIndex::Dish &dish)
+        {
+            auto name = DishIndex::normalize(dish.name);
+            auto initials = DishIndex::initialsOf(name);
+            auto description = DishIndex::normalize(dish.description);
+            return std::all_of(terms.begin(), terms.end(), [&](const std::u32string &term)
+                               { return contains(name, term) || contains(initials, term) || contains(description, term); });
+        };
+        std::vector<uint32_t> expected;
+        for (const auto &dish : menu)
+        {
+            if (matches(dish))
+                expected.push_back(dish.dishId);
+        }
+        auto hits = index.search(samples[i], limit);
+        std::vector<uint32_t> ids;
+        for (size_t k = 0; k < hits.size(); ++k)
+        {
+            ids.push_back(hits[k].dish->dishId);
+            if (!matches(*hits[k].dish) || (k > 0 && hits[k].score > hits[k - 1].score))
+                ++mismatches;
+        }
+        if (hits.size() != std::min(expected.size(), limit))
+            ++mismatches;
+        std::sort(ids.begin(), ids.end());
+        if (expected.size() <= limit && ids != expected)
+            ++mismatches;
+    }
+
+    std::printf("%u dishes: index %.1f us/dish, %u queries %.1f us/query, %.1f hits/query\n",
+                dishes,
+                loadUs,
+                queries,
+                queryUs,
+                static_cast<double>(found) / queries);
+    if (mismatches != 0)
+    {
+        std::printf("INCONSISTENT: %llu mismatches\n", static_cast<unsigned long long>(mismatches));
+        return 1;
+    }
+    std::printf("consistent\n");
+    return 0;
+}
@@ -0,0 +1,92 @@
+// 会员到期压测：按到期日分桶取到期会员，与逐个扫描比较，校验取出的恰好是已到期的会员，并统计耗时
+#include "plugins/ExpiryBuckets.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace
+{
+double msSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const uint32_t members = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 1000000;
+    const size_t batch = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200;
+    const int64_t day = 86400;
+    const int64_t start = 20000 * day;
+    std::mt19937 rng(42);
+
+    // 有效期分布在一年内，一成会员之后续期
+    ExpiryBuckets buckets;
+    std::vector<int64_t> expireAt(members + 1);
+    auto begin = std::chrono::steady_clock::now();
+    for (uint32_t id = 1; id <= members; ++id)
+    {
+        expireAt[id] = start + static_cast<int64_t>(rng() % (365 * day));
+        buckets.set(id, expireAt[id], static_cast<int32_t>(expireAt[id] / day));
+    }
+    for (uint32_t id = 1; id <= members; id += 10)
+    {
+        expireAt[id] += 30 * day;
+        buckets.set(id, expireAt[id], static_cast<int32_t>(expireAt[id] / day));
+    }
+    auto buildMs = msSince(begin);
+
+    // 每分钟扫一次，模拟 30 天
+    std::vector<char> taken(members + 1, 0);
+    uint64_t batches = 0, mismatches = 0;
+    double sweepMs = 0, scanMs = 0;
+    for (int64_t now = start; now < start + 30 * day; now += 60)
+    {
+        begin = std::chrono::steady_clock::now();
+        while (true)
+        {
+            auto due = buckets.takeDue(now, static_cast<int32_t>(now / day), batch);
+            if (due.empty())
+                break;
+            ++batches;
+            for (const auto &[id, at] : due)
+            {
+                if (taken[id] || at != expireAt[id] || at > now)
+                    ++mismatches;
+                taken[id] = 1;
+            }
+        }
+        sweepMs += msSince(begin);
+
+        // 每天核对一次：逐个扫描，已到期的必须都已取出，未到期的都没有
+        if ((now - start) % day == 0)
+        {
+            begin = std::chrono::steady_clock::now();
+            for (uint32_t id = 1; id <= members; ++id)
+                mismatches += (expireAt[id] <= now) != (taken[id] != 0);
+            scanMs += msSince(begin);
+        }
+    }
+
+    uint64_t expired = 0;
+    for (uint32_t id = 1; id <= members; ++id)
+        expired += taken[id];
+    std::printf("%u members in %zu day buckets built in %.1f ms\n", members, buckets.bucketCount(), buildMs);
+    std::printf("30 days of minute sweeps: %llu expired in %llu batches, %.1f ms total (%.2f us per sweep); "
+                "daily full scan %.1f ms each\n",
+                static_cast<unsigned long long>(expired),
+                static_cast<unsigned long long>(batches),
+                sweepMs,
+                sweepMs * 1000 / (30 * 1440),
+                scanMs / 30);
+    if (mismatches != 0)
+    {
+        std::printf("INCONSISTENT: %llu mismatches\n", static_cast<unsigned long long>(mismatches));
+        return 1;
+    }
+    std::printf("consistent\n");
+    return 0;
+}
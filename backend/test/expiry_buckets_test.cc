@@ -0,0 +1,101 @@
+// 会员到期队列：按到期时刻分批取出、重新设置与删除
+#include <drogon/drogon_test.h>
+#include "plugins/ExpiryBuckets.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+namespace
+{
+constexpr int64_t kDay = 86400;
+
+int32_t dayOf(int64_t at)
+{
+    return static_cast<int32_t>(at / kDay);
+}
+} // namespace
+
+DROGON_TEST(ExpiryBucketsTakeDue)
+{
+    ExpiryBuckets buckets;
+    const int64_t base = 20000 * kDay;
+    buckets.set(1, base + 3600, dayOf(base + 3600));
+    buckets.set(2, base + 60, dayOf(base + 60));
+    buckets.set(3, base - kDay, dayOf(base - kDay));
+    buckets.set(4, base + 2 * kDay, dayOf(base + 2 * kDay));
+    CHECK(buckets.size() == 4);
+    CHECK(buckets.bucketCount() == 3);
+
+    // 前一天的桶和当天已到期的前缀，按到期时刻升序
+    auto due = buckets.takeDue(base + 600, dayOf(base), 10);
+    REQUIRE(due.size() == 2);
+    CHECK(due[0].first == 3);
+    CHECK(due[0].second == base - kDay);
+    CHECK(due[1].first == 2);
+    CHECK(!buckets.contains(2));
+    CHECK(buckets.contains(1));
+    CHECK(buckets.size() == 2);
+
+    // 重新设置会从旧桶移走
+    buckets.set(1, base + 3 * kDay, dayOf(base + 3 * kDay));
+    CHECK(buckets.takeDue(base + 7200, dayOf(base), 10).empty());
+    buckets.remove(4);
+    CHECK(buckets.takeDue(base + 2 * kDay + 1, dayOf(base + 2 * kDay), 10).empty());
+    due = buckets.takeDue(base + 3 * kDay, dayOf(base + 3 * kDay), 10);
+    REQUIRE(due.size() == 1);
+    CHECK(due[0].first == 1);
+    CHECK(buckets.size() == 0);
+    CHECK(buckets.bucketCount() == 0);
+}
+
+DROGON_TEST(ExpiryBucketsBatchLimit)
+{
+    ExpiryBuckets buckets;
+    std::mt19937 rng(3);
+    std::map<uint32_t, int64_t> expected;
+    const int64_t now = 20010 * kDay + 12 * 3600;
+    for (uint32_t memberId = 1; memberId <= 5000; ++memberId)
+    {
+        auto at = now - 20 * kDay + static_cast<int64_t>(rng() % (40 * kDay));
+        buckets.set(memberId, at, dayOf(at));
+        expected[memberId] = at;
+    }
+    // 随机重设和删除一部分
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        auto memberId = static_cast<uint32_t>(1 + rng() % 5000);
+        if (rng() % 2)
+        {
+            buckets.remove(memberId);
+            expected.erase(memberId);
+            continue;
+        }
+        auto at = now - 20 * kDay + static_cast<int64_t>(rng() % (40 * kDay));
+        buckets.set(memberId, at, dayOf(at));
+        expected[memberId] = at;
+    }
+    CHECK(buckets.size() == expected.size());
+
+    std::vector<std::pair<int64_t, uint32_t>> wanted;
+    for (const auto &[memberId, at] : expected)
+        if (at <= now)
+            wanted.emplace_back(at, memberId);
+    std::sort(wanted.begin(), wanted.end());
+
+    // 每批最多 128 个，批与批首尾相接
+    std::vector<std::pair<int64_t, uint32_t>> taken;
+    while (true)
+    {
+        auto batch = buckets.takeDue(now, dayOf(now), 128);
+        CHECK(batch.size() <= 128);
+        if (batch.empty())
+            break;
+        for (const auto &[memberId, at] : batch)
+            taken.emplace_back(at, memberId);
+    }
+    CHECK(taken == wanted);
+    CHECK(buckets.size() == expected.size() - wanted.size());
+    for (const auto &[at, memberId] : wanted)
+        CHECK(!buckets.contains(memberId));
+}
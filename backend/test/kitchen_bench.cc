@@ -0,0 +1,203 @@
+// 厨房队列压测：订单表中有大量历史订单、少量未完成订单，
+// 对比"轮询全表、过滤未完成、按优先级排序"与"按分店维护的活跃队列"取厨显列表的耗时；
+// 随机推进状态（含不合法的推进），统计合并写库后的写入条数，并与暴力过滤排序的结果逐单核对
+#include "plugins/KitchenQueue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+using Status = OrderFlow::Status;
+
+const Status kAll[] = {
+    Status::Pending, Status::Confirmed, Status::Cooking, Status::Ready, Status::Completed, Status::Cancelled};
+
+// 从全表过滤出分店的未完成订单并排序
+std::vector<KitchenQueue::Ticket> scan(const KitchenQueue &queue,
+                                       const std::vector<KitchenQueue::Ticket> &table,
+                                       uint32_t branchId,
+                                       size_t limit)
+{
+    std::vector<KitchenQueue::Ticket> result;
+    for (const auto &ticket : table)
+        if (ticket.branchId == branchId && OrderFlow::active(ticket.status))
+            result.push_back(ticket);
+    std::sort(result.begin(),
+              result.end(),
+              [&queue](const KitchenQueue::Ticket &a, const KitchenQueue::Ticket &b)
+              {
+                  auto x = queue.rankOf(a);
+                  auto y = queue.rankOf(b);
+                  return x != y ? x < y : a.orderId < b.orderId;
+              });
+    if (result.size() > limit)
+        result.resize(limit);
+    return result;
+}
+
+// 正常流程的下一步，制作中有时直接上桌完成
+Status nextOf(Status status, std::mt19937 &rng)
+{
+    if (status == Status::Cooking && rng() % 4 == 0)
+        return Status::Completed;
+    return static_cast<Status>(static_cast<int>(status) + 1);
+}
+
+bool same(const std::vector<KitchenQueue::Ticket> &a, const std::vector<KitchenQueue::Ticket> &b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i)
+        if (a[i].orderId != b[i].orderId || a[i].status != b[i].status || a[i].changedAt != b[i].changedAt)
+            return false;
+    return true;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const size_t orders = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    const size_t active = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 600;
+    const size_t moves = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 200000;
+    const uint32_t branches = 20;
+    const size_t limit = 200;
+
+    std::mt19937 rng(42);
+    KitchenQueue queue({0, 60, 300});
+    std::vector<KitchenQueue::Ticket> table;
+    table.reserve(orders);
+    const int64_t now = 1760000000;
+    for (size_t i = 0; i < orders; ++i)
+    {
+        KitchenQueue::Ticket ticket;
+        ticket.orderId = static_cast<uint32_t>(i + 1);
+        ticket.tenantId = 1;
+        ticket.branchId = 1 + rng() % branches;
+        ticket.kind = static_cast<KitchenQueue::Kind>(rng() % 3);
+        // 最后 active 单为未完成，按下单先后排在表尾
+        ticket.placedAt = now - static_cast<int64_t>(orders - i) * 30 + static_cast<int64_t>(rng() % 60);
+        ticket.changedAt = ticket.placedAt;
+        ticket.status = i + active < orders ? (rng() % 10 ? Status::Completed : Status::Cancelled)
+                                            : kAll[rng() % 4];
+        ticket.table = ticket.kind == KitchenQueue::Kind::DineIn ? "A" + std::to_string(rng() % 40) : "";
+        ticket.items = Json::Value(Json::arrayValue);
+        table.push_back(ticket);
+        queue.put(ticket);
+    }
+    std::printf("%zu orders in table, %zu held in kitchen queue\n", table.size(), queue.size());
+
+    // 厨显取列表
+    const int polls = 2000;
+    size_t listed = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < polls; ++i)
+        listed += scan(queue, table, 1 + static_cast<uint32_t>(i) % branches, limit).size();
+    auto scanUs = secondsSince(start) * 1e6 / polls;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < polls; ++i)
+        listed -= queue.list(1 + static_cast<uint32_t>(i) % branches, limit).size();
+    auto listUs = secondsSince(start) * 1e6 / polls;
+    std::printf("kitchen list: scan table %.1f us, queue %.2f us\n", scanUs, listUs);
+    uint64_t errors = listed != 0;
+
+    // 随机推进：多数沿 待确认→已确认→制作中→待派送→已完成 走下一步，少数为任意状态（多半不合法），
+    // 新订单按完成的速度进来；每 flush_every 次推进合并写库一次，同一订单只写最后的状态
+    const size_t flushEvery = 500;
+    size_t moved = 0;
+    size_t rejected = 0;
+    size_t writes = 0;
+    std::unordered_set<uint32_t> dirty;
+    std::vector<size_t> live; // 未完成订单在 table 中的下标
+    for (size_t i = orders - active; i < orders; ++i)
+        live.push_back(i);
+    int64_t clock = now;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < moves; ++i)
+    {
+        auto pick = rng() % live.size();
+        auto &row = table[live[pick]];
+        auto to = rng() % 10 ? nextOf(row.status, rng) : kAll[rng() % 6];
+        ++clock;
+        KitchenQueue::Ticket ticket;
+        auto result = queue.move(row.orderId, to, clock, ticket);
+        if ((result == KitchenQueue::Move::Moved) != OrderFlow::canMove(row.status, to))
+            ++errors;
+        if (result != KitchenQueue::Move::Moved)
+        {
+            ++rejected;
+            continue;
+        }
+        ++moved;
+        if (row.status != to)
+        {
+            row.status = to;
+            row.changedAt = clock;
+            dirty.insert(row.orderId);
+        }
+        if (!OrderFlow::active(to))
+        {
+            // 完成一单，进来一单
+            live[pick] = table.size();
+            KitchenQueue::Ticket order;
+            order.orderId = static_cast<uint32_t>(table.size() + 1);
+            order.tenantId = 1;
+            order.branchId = 1 + rng() % branches;
+            order.kind = static_cast<KitchenQueue::Kind>(rng() % 3);
+            order.placedAt = clock;
+            order.changedAt = clock;
+            order.items = Json::Value(Json::arrayValue);
+            table.push_back(order);
+            queue.put(order);
+        }
+        if ((i + 1) % flushEvery == 0)
+        {
+            writes += dirty.size();
+            dirty.clear();
+        }
+    }
+    writes += dirty.size();
+    auto moveNs = secondsSince(start) * 1e9 / static_cast<double>(moves);
+    std::printf("%zu moves (%zu accepted, %zu rejected): %.0f ns each, %zu status writes after coalescing\n",
+                moves,
+                moved,
+                rejected,
+                moveNs,
+                writes);
+
+    // 已完成的订单不在队列中
+    KitchenQueue::Ticket ticket;
+    if (queue.move(table.front().orderId, Status::Cancelled, clock, ticket) != KitchenQueue::Move::NotFound)
+        ++errors;
+
+    // 与暴力结果逐分店核对
+    size_t held = 0;
+    for (uint32_t branchId = 1; branchId <= branches; ++branchId)
+    {
+        auto expected = scan(queue, table, branchId, SIZE_MAX);
+        held += expected.size();
+        if (!same(queue.list(branchId), expected))
+            ++errors;
+    }
+    if (held != queue.size())
+        ++errors;
+    std::printf("%zu of %zu orders still active\n", queue.size(), table.size());
+
+    if (errors != 0)
+    {
+        std::printf("INCONSISTENT: %llu errors\n", static_cast<unsigned long long>(errors));
+        return 1;
+    }
+    std::printf("consistent\n");
+    return 0;
+}
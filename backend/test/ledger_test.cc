@@ -0,0 +1,160 @@
+// 库存流水账：乱序追加、快照与回放
+#include <drogon/drogon_test.h>
+#include "plugins/StockLedger.h"
+
+#include <algorithm>
+#include <random>
+
+namespace
+{
+// 暴力计算：期初加上 record_id 不大于 lastId 的全部增量
+int64_t replay(int64_t opening, const std::vector<StockLedger::Entry> &entries, uint32_t lastId)
+{
+    for (const auto &entry : entries)
+        if (entry.recordId <= lastId)
+            opening += entry.delta;
+    return opening;
+}
+} // namespace
+
+DROGON_TEST(StockLedgerOutOfOrderAppend)
+{
+    std::mt19937 rng(7);
+    std::vector<StockLedger::Entry> all;
+    for (uint32_t id = 1; id <= 400; ++id)
+        all.push_back({id, 1000 + static_cast<int64_t>(id) * 10, static_cast<int64_t>(rng() % 21) - 10});
+    // 相邻的写库回调互相交错
+    auto arrival = all;
+    for (size_t i = 0; i + 1 < arrival.size(); i += 2 + rng() % 3)
+        std::swap(arrival[i], arrival[i + 1 + rng() % std::min<size_t>(3, arrival.size() - i - 1)]);
+
+    StockLedger ledger;
+    ledger.open(100);
+    size_t dropped = 0;
+    size_t invalidated = 0;
+    for (size_t i = 0; i < arrival.size(); ++i)
+    {
+        REQUIRE(ledger.insert(arrival[i], dropped));
+        invalidated += dropped;
+        if (i % 17 == 0)
+        {
+            StockLedger::Snapshot snapshot;
+            ledger.takeSnapshot(1, snapshot);
+        }
+    }
+    CHECK(invalidated > 0);
+    CHECK(!ledger.insert(all.front(), dropped));
+
+    const auto &entries = ledger.entries();
+    REQUIRE(entries.size() == all.size());
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        CHECK(entries[i].recordId == i + 1);
+        if (i > 0)
+            CHECK(entries[i - 1].at <= entries[i].at);
+    }
+    // 留下的快照都与回放一致
+    for (const auto &snapshot : ledger.snapshots())
+        CHECK(snapshot.quantity == replay(100, all, snapshot.lastRecordId));
+    uint32_t first = 0;
+    CHECK(ledger.verify(first) == 0);
+
+    CHECK(ledger.current() == replay(100, all, UINT32_MAX));
+    for (uint32_t id = 0; id <= 400; id += 13)
+    {
+        auto at = 1000 + static_cast<int64_t>(id) * 10;
+        CHECK(ledger.quantityAt(at) == replay(100, all, id));
+        CHECK(ledger.balanceBefore(id) == replay(100, all, id));
+    }
+    auto [begin, end] = ledger.range(1000 + 50 * 10, 1000 + 60 * 10);
+    CHECK(begin == 49);
+    CHECK(end == 60);
+}
+
+DROGON_TEST(StockLedgerLateEntryTime)
+{
+    StockLedger ledger;
+    ledger.open(0);
+    size_t dropped = 0;
+    ledger.insert({1, 100, 5}, dropped);
+    ledger.insert({3, 300, 5}, dropped);
+    StockLedger::Snapshot snapshot;
+    REQUIRE(ledger.takeSnapshot(1, snapshot));
+    CHECK(snapshot.quantity == 10);
+
+    // 晚到的 2 号时刻晚于 3 号，夹到 3 号的时刻；其后的快照失效
+    REQUIRE(ledger.insert({2, 500, -3}, dropped));
+    CHECK(dropped == 1);
+    CHECK(ledger.snapshots().size() == 1);
+    CHECK(ledger.entries()[1].at == 300);
+    CHECK(ledger.quantityAt(200) == 5);
+    CHECK(ledger.quantityAt(300) == 7);
+    CHECK(ledger.current() == 7);
+}
+
+DROGON_TEST(StockLedgerRestore)
+{
+    StockLedger ledger;
+    ledger.assign({{3, 30, 4}, {1, 10, 2}, {2, 20, -1}, {4, 40, 6}});
+    // 库中只有中途的快照：由它倒推期初
+    REQUIRE(ledger.restore(20, 2, 11));
+    StockLedger::Snapshot opening;
+    CHECK(!ledger.ensureOpening(0, opening));
+    CHECK(opening.quantity == 10);
+    CHECK(ledger.current() == 21);
+    CHECK(ledger.quantityAt(25) == 11);
+
+    // 写库先后错乱留下的快照与回放不符，被丢弃
+    StockLedger stale;
+    stale.assign({{1, 10, 2}, {2, 20, -1}, {3, 30, 4}});
+    REQUIRE(stale.restore(0, 0, 10));
+    REQUIRE(stale.restore(10, 1, 12));
+    REQUIRE(stale.restore(30, 3, 99));
+    CHECK(!stale.restore(20, 2, 11));
+    uint32_t first = 0;
+    CHECK(stale.verify(first) == 1);
+    CHECK(first == 3);
+    CHECK(stale.current() == 15);
+
+    // 首次启用：没有快照时按当前数量倒推期初
+    StockLedger fresh;
+    fresh.assign({{1, 10, 2}, {2, 20, 3}});
+    CHECK(fresh.ensureOpening(50, opening));
+    CHECK(opening.quantity == 45);
+    CHECK(fresh.quantityAt(15) == 47);
+}
+
+DROGON_TEST(StockLedgerCompact)
+{
+    StockLedger ledger;
+    ledger.open(10);
+    size_t dropped = 0;
+    ledger.insert({1, 100, 5}, dropped);
+    ledger.insert({2, 200, -3}, dropped);
+    ledger.insert({4, 400, 2}, dropped);
+    StockLedger::Snapshot snapshot;
+    REQUIRE(ledger.takeSnapshot(1, snapshot));
+    ledger.insert({5, 500, 1}, dropped);
+
+    // 只留最新快照之后的流水，数量不变
+    ledger.compact();
+    REQUIRE(ledger.snapshots().size() == 1);
+    CHECK(ledger.snapshots().front().lastRecordId == 4);
+    CHECK(ledger.snapshots().front().entryCount == 0);
+    REQUIRE(ledger.entries().size() == 1);
+    CHECK(ledger.current() == 15);
+    CHECK(ledger.quantityAt(450) == 14);
+    StockLedger::Snapshot opening;
+    CHECK(!ledger.ensureOpening(0, opening));
+
+    // 压缩后晚到的 3 号插在最前，基准保留，新快照编号不回退
+    REQUIRE(ledger.insert({3, 300, 4}, dropped));
+    CHECK(dropped == 0);
+    CHECK(ledger.current() == 19);
+    REQUIRE(ledger.takeSnapshot(1, snapshot));
+    CHECK(snapshot.lastRecordId == 5);
+    CHECK(snapshot.quantity == 19);
+    ledger.compact();
+    CHECK(ledger.entries().empty());
+    CHECK(ledger.current() == 19);
+}
@@ -0,0 +1,116 @@
+// 会员等级评估压测：随机生成等级门槛和会员累计值，校验二分查找与逐级比较一致，并统计单次评估耗时
+#include "plugins/LevelLadder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+double msSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 逐级比较：按阶梯顺序，直到第一个不满足的等级
+uint32_t scan(std::vector<LevelLadder::Level> levels, int64_t points, Money spent)
+{
+    std::sort(levels.begin(), levels.end(), [](const LevelLadder::Level &a, const LevelLadder::Level &b) {
+        return std::make_tuple(a.requiredSpent, a.requiredPoints, a.levelId) <
+               std::make_tuple(b.requiredSpent, b.requiredPoints, b.levelId);
+    });
+    uint32_t levelId = 0;
+    for (const auto &level : levels)
+    {
+        if (points < level.requiredPoints || spent < level.requiredSpent)
+            break;
+        levelId = level.levelId;
+    }
+    return levelId;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const uint32_t members = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 1000000;
+    const uint32_t tenants = 100;
+    std::mt19937 rng(42);
+
+    // 每个租户 3 到 12 级，门槛大体递增，偶有积分门槛倒挂
+    std::vector<std::vector<LevelLadder::Level>> definitions(tenants);
+    std::vector<LevelLadder> ladders;
+    uint32_t nextLevel = 1;
+    for (auto &levels : definitions)
+    {
+        auto count = 3 + rng() % 10;
+        int64_t points = 0, cents = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            LevelLadder::Level level;
+            level.levelId = nextLevel++;
+            points += rng() % 2000;
+            cents += rng() % 200000;
+            level.requiredPoints = rng() % 8 == 0 ? points / 2 : points;
+            level.requiredSpent = Money::fromRaw(cents);
+            levels.push_back(level);
+        }
+        std::shuffle(levels.begin(), levels.end(), rng);
+        ladders.emplace_back(levels);
+    }
+
+    struct Sample
+    {
+        uint32_t tenant;
+        int64_t points;
+        Money spent;
+    };
+    std::vector<Sample> samples(members);
+    for (auto &sample : samples)
+    {
+        sample.tenant = rng() % tenants;
+        sample.points = rng() % 15000;
+        sample.spent = Money::fromRaw(rng() % 1500000);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t checksum = 0;
+    for (const auto &sample : samples)
+        checksum += ladders[sample.tenant].levelFor(sample.points, sample.spent);
+    auto evaluateMs = msSince(start);
+
+    uint64_t mismatches = 0, upgrades = 0;
+    for (uint32_t i = 0; i < members; ++i)
+    {
+        const auto &sample = samples[i];
+        const auto &ladder = ladders[sample.tenant];
+        auto expected = scan(definitions[sample.tenant], sample.points, sample.spent);
+        if (ladder.levelFor(sample.points, sample.spent) != expected)
+            ++mismatches;
+        // 随机当前等级：只有比当前位次高时才升级
+        const auto &levels = definitions[sample.tenant];
+        auto current = i % 3 == 0 ? 0 : levels[i % levels.size()].levelId;
+        auto to = ladder.upgrade(current, sample.points, sample.spent);
+        auto shouldUpgrade = expected != 0 && ladder.rankOf(expected) > ladder.rankOf(current);
+        if (to != (shouldUpgrade ? expected : 0))
+            ++mismatches;
+        upgrades += to != 0;
+    }
+
+    std::printf("%u members, %u tenants: %.2f ms (%.1f ns/member), checksum %llu\n",
+                members,
+                tenants,
+                evaluateMs,
+                evaluateMs * 1e6 / members,
+                static_cast<unsigned long long>(checksum));
+    if (mismatches != 0)
+    {
+        std::printf("INCONSISTENT: %llu mismatches\n", static_cast<unsigned long long>(mismatches));
+        return 1;
+    }
+    std::printf("consistent, %llu upgrades\n", static_cast<unsigned long long>(upgrades));
+    return 0;
+}
@@ -0,0 +1,185 @@
+// 会员检索压测：整体载入会员后穿插改号、删除，按手机号片段和用户名查询，统计耗时并与逐个扫描的结果比对
+#include "plugins/PrefixIndex.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+double nsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::string randomPhone(std::mt19937 &rng)
+{
+    std::string phone = "1" + std::to_string(3 + rng() % 7);
+    for (int i = 0; i < 9; ++i)
+        phone.push_back(static_cast<char>('0' + rng() % 10));
+    return phone;
+}
+
+std::string randomName(std::mt19937 &rng)
+{
+    static const char *surnames[] = {"张", "王", "李", "赵", "Chen", "Liu", "wang"};
+    static const char *given[] = {"伟", "芳", "娜", "敏", "静", "Li", "Ming", "hua"};
+    std::string name = surnames[rng() % 7];
+    for (auto n = 1 + rng() % 2; n > 0; --n)
+        name += given[rng() % 8];
+    return name;
+}
+
+bool matches(const std::vector<std::string> &fields, const std::string &key, bool prefixOnly)
+{
+    for (const auto &field : fields)
+    {
+        auto normalized = PrefixIndex::normalize(field);
+        auto pos = normalized.find(key);
+        if (pos == 0)
+            return true;
+        // 子串须落在字符边界上，且后缀不短于 kMinInfix
+        if (!prefixOnly && pos != std::string::npos)
+        {
+            for (; pos != std::string::npos; pos = normalized.find(key, pos + 1))
+            {
+                if ((static_cast<unsigned char>(normalized[pos]) & 0xC0) != 0x80 &&
+                    normalized.size() - pos >= PrefixIndex::kMinInfix)
+                    return true;
+            }
+        }
+    }
+    return false;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const uint32_t members = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 200000;
+    const uint32_t queries = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 100000;
+    const size_t limit = 10;
+
+    std::mt19937 rng(42);
+    std::unordered_map<uint32_t, std::vector<std::string>> truth;
+    PrefixIndex index;
+
+    std::vector<std::pair<uint32_t, std::vector<std::string>>> rows;
+    rows.reserve(members);
+    for (uint32_t id = 1; id <= members; ++id)
+    {
+        rows.emplace_back(id, std::vector<std::string>{randomPhone(rng), randomName(rng)});
+        truth[id] = rows.back().second;
+    }
+    auto start = std::chrono::steady_clock::now();
+    index.load(std::move(rows));
+    auto loadNs = nsSince(start) / members;
+
+    // 一成会员改号或改名，百分之一删除
+    start = std::chrono::steady_clock::now();
+    uint32_t writes = 0;
+    for (uint32_t i = 0; i < members / 10; ++i, ++writes)
+    {
+        auto id = static_cast<uint32_t>(1 + rng() % members);
+        if (rng() % 10 == 0)
+        {
+            index.remove(id);
+            truth.erase(id);
+            continue;
+        }
+        std::vector<std::string> fields{randomPhone(rng), randomName(rng)};
+        index.set(id, fields);
+        truth[id] = fields;
+    }
+    auto writeNs = nsSince(start) / std::max(writes, 1u);
+
+    // 手机号尾号、号段前缀和用户名
+    std::vector<std::string> samples;
+    samples.reserve(queries);
+    for (uint32_t i = 0; i < queries; ++i)
+    {
+        auto phone = randomPhone(rng);
+        switch (rng() % 4)
+        {
+        case 0:
+            samples.push_back(phone.substr(7)); // 后四位
+            break;
+        case 1:
+            samples.push_back(phone.substr(0, 7)); // 号段
+            break;
+        case 2:
+            samples.push_back(phone.substr(3, 5));
+            break;
+        default:
+            samples.push_back(randomName(rng));
+            break;
+        }
+    }
+    std::vector<uint32_t> ids;
+    size_t found = 0;
+    start = std::chrono::steady_clock::now();
+    for (const auto &query : samples)
+    {
+        index.search(query, limit, ids);
+        found += ids.size();
+    }
+    auto queryNs = nsSince(start) / queries;
+
+    // 抽查：返回的都匹配，不足 limit 时与逐个扫描的结果相同，前缀匹配排在前面
+    uint64_t mismatches = 0;
+    for (uint32_t i = 0; i < 300 && i < queries; ++i)
+    {
+        const auto &query = samples[i];
+        auto key = PrefixIndex::normalize(query);
+        bool prefixOnly = key.size() < PrefixIndex::kMinInfix;
+        index.search(query, limit, ids);
+        std::vector<uint32_t> expected;
+        size_t prefixCount = 0;
+        for (const auto &[id, fields] : truth)
+        {
+            if (matches(fields, key, prefixOnly))
+                expected.push_back(id);
+            if (matches(fields, key, true))
+                ++prefixCount;
+        }
+        bool seenInfix = false;
+        for (auto id : ids)
+        {
+            auto fields = index.fieldsOf(id);
+            if (!fields || !truth.count(id) || *fields != truth[id] || !matches(*fields, key, prefixOnly))
+                ++mismatches;
+            else if (matches(*fields, key, true) ? seenInfix : !(seenInfix = true))
+                ++mismatches;
+        }
+        if (std::min(prefixCount, limit) > ids.size())
+            ++mismatches;
+        if (expected.size() <= limit)
+        {
+            std::sort(expected.begin(), expected.end());
+            auto sorted = ids;
+            std::sort(sorted.begin(), sorted.end());
+            if (sorted != expected)
+                ++mismatches;
+        }
+    }
+
+    std::printf("%u members: load %.0f ns/member, %u writes %.0f ns/write, %u queries %.0f ns/query, %.1f matches/query\n",
+                members,
+                loadNs,
+                writes,
+                writeNs,
+                queries,
+                queryNs,
+                static_cast<double>(found) / queries);
+    if (mismatches != 0)
+    {
+        std::printf("INCONSISTENT: %llu mismatches\n", static_cast<unsigned long long>(mismatches));
+        return 1;
+    }
+    std::printf("consistent\n");
+    return 0;
+}
@@ -0,0 +1,270 @@
+// 菜单快照压测：多个读线程按租户取菜单，同时一个写线程不断改价发布新版本；
+// 对比 SnapshotCell（RCU）、读写锁、互斥锁保护的同一份菜单在 1 到 N 个读线程下的吞吐和相对单线程的倍数，
+// 并检查旧版本都已释放
+#include "plugins/MenuSnapshot.h"
+#include "plugins/SnapshotCell.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+using Catalog = std::unordered_map<uint32_t, std::shared_ptr<const MenuSnapshot>>;
+
+MenuSnapshot::Sources makeTenant(std::mt19937 &rng, uint32_t dishes)
+{
+    MenuSnapshot::Sources sources;
+    for (uint32_t id = 1; id <= 20; ++id)
+    {
+        auto parentId = id > 5 ? static_cast<uint32_t>(1 + rng() % 5) : 0u;
+        sources.categories.set(
+            CategoryTree::Category{id, parentId, "分类" + std::to_string(id), static_cast<int32_t>(rng() % 10)});
+    }
+    for (uint32_t id = 1; id <= dishes; ++id)
+    {
+        MenuSnapshot::Dish dish;
+        dish.dishId = id;
+        dish.categoryId = 1 + rng() % 21; // 21 为不存在的分类
+        dish.name = "菜品" + std::to_string(id);
+        dish.description = "招牌 现做";
+        dish.status = rng() % 20 == 0 ? "下架" : "在售";
+        dish.price = Money::fromRaw(static_cast<int64_t>(500 + rng() % 10000));
+        dish.sortOrder = static_cast<int32_t>(rng() % 10);
+        dish.sales = rng() % 1000;
+        sources.dishes[id] = dish;
+    }
+    PricingRules::Campaign campaign;
+    campaign.campaignId = 1;
+    campaign.rate = Rate::fromRaw(8000);
+    for (uint32_t id = 1; id <= dishes; id += 3)
+        campaign.dishIds.push_back(id);
+    sources.schedule.set(campaign.window());
+    sources.campaigns[1] = campaign;
+    return sources;
+}
+
+struct Result
+{
+    double readsPerSecond{0};
+    uint64_t errors{0};
+};
+
+// 持续 ms 毫秒，readers 个线程读，一个线程每 writeEvery 微秒改一个菜品价格并发布
+template <typename Read, typename Publish>
+Result run(uint32_t readers, int ms, int writeEvery, uint32_t tenants, Read read, Publish publish)
+{
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> reads{0};
+    std::atomic<uint64_t> errors{0};
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < readers; ++t)
+    {
+        threads.emplace_back([&, t]()
+                             {
+            std::mt19937 rng(t);
+            std::vector<uint64_t> seen(tenants + 1, 0);
+            uint64_t count = 0;
+            size_t bytes = 0;
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                auto tenantId = 1 + rng() % tenants;
+                uint64_t version = 0;
+                bytes += read(tenantId, version);
+                // 同一线程看到的版本不会倒退
+                if (version < seen[tenantId])
+                    errors.fetch_add(1, std::memory_order_relaxed);
+                seen[tenantId] = version;
+                ++count;
+            }
+            reads.fetch_add(count);
+            if (bytes == 0)
+                errors.fetch_add(1); });
+    }
+    std::thread writer([&]()
+                       {
+        uint32_t round = 0;
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            publish(1 + round % tenants, round);
+            ++round;
+            std::this_thread::sleep_for(std::chrono::microseconds(writeEvery));
+        } });
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    stop = true;
+    for (auto &thread : threads)
+        thread.join();
+    writer.join();
+    return Result{static_cast<double>(reads) * 1000 / ms, errors};
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const uint32_t dishes = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 200;
+    const uint32_t maxThreads =
+        argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : std::max(std::thread::hardware_concurrency(), 1u);
+    const int ms = argc > 3 ? std::atoi(argv[3]) : 1000;
+    const uint32_t tenants = 8;
+    const int writeEvery = 2000;
+
+    std::mt19937 rng(42);
+    std::vector<MenuSnapshot::Sources> sources;
+    for (uint32_t i = 0; i <= tenants; ++i)
+        sources.push_back(makeTenant(rng, dishes));
+    uint64_t version = 0;
+    auto buildAll = [&]()
+    {
+        auto catalog = std::make_shared<Catalog>();
+        for (uint32_t tenantId = 1; tenantId <= tenants; ++tenantId)
+            (*catalog)[tenantId] = MenuSnapshot::build(tenantId, ++version, sources[tenantId], 0);
+        return catalog;
+    };
+    auto start = std::chrono::steady_clock::now();
+    auto initial = buildAll();
+    auto buildUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / tenants;
+    std::printf("%u dishes per tenant, %zu bytes per menu, build %.0f us\n",
+                dishes,
+                initial->at(1)->body().size(),
+                buildUs);
+
+    // 写者：改一个菜品的价格，重建该租户，复制目录后替换
+    auto rebuild = [&](const Catalog &current, uint32_t tenantId, uint32_t round)
+    {
+        auto &dish = sources[tenantId].dishes[1 + round % dishes];
+        dish.price = Money::fromRaw(500 + round % 10000);
+        auto next = std::make_shared<Catalog>(current);
+        (*next)[tenantId] = MenuSnapshot::build(tenantId, ++version, sources[tenantId], 0);
+        return next;
+    };
+
+    SnapshotCell<Catalog> cell;
+    cell.publish(initial);
+    std::shared_mutex lock;
+    std::shared_ptr<Catalog> locked = std::make_shared<Catalog>(*initial);
+    std::mutex mutex;
+    std::shared_ptr<Catalog> guarded = std::make_shared<Catalog>(*initial);
+    initial.reset();
+    std::vector<std::weak_ptr<const MenuSnapshot>> retired;
+    std::mutex retiredMutex;
+
+    uint64_t errors = 0;
+    double rcuOne = 0;
+    double rwOne = 0;
+    double mutexOne = 0;
+    for (uint32_t threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        auto rcu = run(
+            threads,
+            ms,
+            writeEvery,
+            tenants,
+            [&cell](uint32_t tenantId, uint64_t &seen)
+            {
+                thread_local SnapshotCell<Catalog>::Reader reader;
+                const auto &menu = reader.get(cell)->at(tenantId);
+                seen = menu->version();
+                // 与 menuOf 一样只共享响应体，不复制
+                std::shared_ptr<const std::string> body(menu, &menu->body());
+                return body->size();
+            },
+            [&](uint32_t tenantId, uint32_t round)
+            {
+                auto current = cell.load();
+                {
+                    std::lock_guard<std::mutex> guard(retiredMutex);
+                    retired.push_back(current->at(tenantId));
+                }
+                cell.publish(rebuild(*current, tenantId, round));
+            });
+        auto rw = run(
+            threads,
+            ms,
+            writeEvery,
+            tenants,
+            [&](uint32_t tenantId, uint64_t &seen)
+            {
+                std::shared_lock<std::shared_mutex> guard(lock);
+                const auto &menu = locked->at(tenantId);
+                seen = menu->version();
+                // 与 menuOf 一样只共享响应体，不复制
+                std::shared_ptr<const std::string> body(menu, &menu->body());
+                return body->size();
+            },
+            [&](uint32_t tenantId, uint32_t round)
+            {
+                // 同样在锁外构造，只在替换时持有写锁
+                auto next = rebuild(*locked, tenantId, round);
+                std::unique_lock<std::shared_mutex> guard(lock);
+                locked = std::move(next);
+            });
+        auto mx = run(
+            threads,
+            ms,
+            writeEvery,
+            tenants,
+            [&](uint32_t tenantId, uint64_t &seen)
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                const auto &menu = guarded->at(tenantId);
+                seen = menu->version();
+                // 与 menuOf 一样只共享响应体，不复制
+                std::shared_ptr<const std::string> body(menu, &menu->body());
+                return body->size();
+            },
+            [&](uint32_t tenantId, uint32_t round)
+            {
+                auto next = rebuild(*guarded, tenantId, round);
+                std::lock_guard<std::mutex> guard(mutex);
+                guarded = std::move(next);
+            });
+        if (threads == 1)
+        {
+            rcuOne = rcu.readsPerSecond;
+            rwOne = rw.readsPerSecond;
+            mutexOne = mx.readsPerSecond;
+        }
+        errors += rcu.errors + rw.errors + mx.errors;
+        std::printf("%2u readers: snapshot %10.0f reads/s (x%.2f), shared_mutex %10.0f reads/s (x%.2f), "
+                    "mutex %10.0f reads/s (x%.2f)\n",
+                    threads,
+                    rcu.readsPerSecond,
+                    rcu.readsPerSecond / rcuOne,
+                    rw.readsPerSecond,
+                    rw.readsPerSecond / rwOne,
+                    mx.readsPerSecond,
+                    mx.readsPerSecond / mutexOne);
+        if (threads < maxThreads && threads * 2 > maxThreads)
+            threads = maxThreads / 2;
+    }
+
+    // 读线程都已退出，除了当前发布的版本，替换下来的旧版本应全部释放
+    locked.reset();
+    guarded.reset();
+    auto current = cell.load();
+    size_t alive = 0;
+    for (const auto &weak : retired)
+    {
+        auto menu = weak.lock();
+        if (menu && menu != current->at(menu->tenantId()))
+            ++alive;
+    }
+    std::printf("%zu versions retired, %zu still alive\n", retired.size(), alive);
+    if (errors != 0 || alive != 0)
+    {
+        std::printf("INCONSISTENT: %llu errors\n", static_cast<unsigned long long>(errors));
+        return 1;
+    }
+    std::printf("consistent\n");
+    return 0;
+}
@@ -0,0 +1,79 @@
+// 定点金额：解析、四舍五入、格式化和按比例计算
+#include <drogon/drogon_test.h>
+#include "plugins/Money.h"
+
+DROGON_TEST(MoneyParse)
+{
+    Money value;
+    REQUIRE(Money::parse("12.5", value));
+    CHECK(value.raw() == 1250);
+    REQUIRE(Money::parse(" -3 ", value));
+    CHECK(value.raw() == -300);
+    REQUIRE(Money::parse("+.05", value));
+    CHECK(value.raw() == 5);
+
+    // 多出的小数位四舍五入，远离 0
+    REQUIRE(Money::parse("12.345", value));
+    CHECK(value.raw() == 1235);
+    REQUIRE(Money::parse("12.3449", value));
+    CHECK(value.raw() == 1234);
+    REQUIRE(Money::parse("-12.345", value));
+    CHECK(value.raw() == -1235);
+    REQUIRE(Money::parse("0.995", value));
+    CHECK(value.raw() == 100);
+
+    CHECK(!Money::parse("", value));
+    CHECK(!Money::parse(".", value));
+    CHECK(!Money::parse("1.2.3", value));
+    CHECK(!Money::parse("12a", value));
+    CHECK(!Money::parse("99999999999999999999", value));
+    CHECK(Money::fromString("abc") == Money());
+}
+
+DROGON_TEST(MoneyJson)
+{
+    CHECK(Money::fromRaw(1250).toString() == "12.50");
+    CHECK(Money::fromRaw(-5).toString() == "-0.05");
+    CHECK(Money::fromRaw(0).toString() == "0.00");
+    CHECK(Rate::fromRaw(8500).toString() == "0.8500");
+    CHECK(Money::fromRaw(1999).toJson().asString() == "19.99");
+
+    // 数字按文本解析，不经 double 乘法取整
+    CHECK(Money::fromJson(Json::Value(0.1)).raw() == 10);
+    CHECK(Money::fromJson(Json::Value(19.99)).raw() == 1999);
+    CHECK(Money::fromJson(Json::Value("19.99")).raw() == 1999);
+    CHECK(Money::fromJson(Json::Value(3)).raw() == 300);
+    CHECK(Money::isValidJson(Json::Value("8.8")));
+    CHECK(!Money::isValidJson(Json::Value(1e20)));
+    CHECK(!Money::isValidJson(Json::Value(Json::arrayValue)));
+    CHECK(!Money::isValidJson(Json::Value("八元")));
+
+    // 控制器校验：缺省和 null 跳过，出错时提示字段名
+    Json::Value body;
+    body["dish_price"] = "28.00";
+    body["cost_price"] = Json::Value::null;
+    std::string err;
+    CHECK(Money::checkFields(body, {"dish_price", "cost_price", "origin_price"}, err));
+    body["origin_price"] = "¥30";
+    CHECK(!Money::checkFields(body, {"dish_price", "cost_price", "origin_price"}, err));
+    CHECK(err.find("origin_price") != std::string::npos);
+}
+
+DROGON_TEST(MoneyArithmetic)
+{
+    // 折扣率相乘后四舍五入到分
+    CHECK((Money::fromRaw(999) * Rate::fromRaw(8500)).raw() == 849); // 8.4915
+    CHECK((Money::fromRaw(1001) * Rate::fromRaw(5000)).raw() == 501); // 5.005
+    CHECK((Money::fromRaw(-1001) * Rate::fromRaw(5000)).raw() == -501);
+    CHECK((Money::fromRaw(1000) / 3).raw() == 333);
+    CHECK((Money::fromRaw(1000) / 6).raw() == 167);
+    CHECK((Money::fromRaw(250) * 4).raw() == 1000);
+
+    Money values[] = {Money::fromRaw(101), Money::fromRaw(202), Money::fromRaw(-3)};
+    CHECK(sumOf(values, 3).raw() == 300);
+    Money scaled[3];
+    scaleAll(values, Rate::fromRaw(9000), scaled, 3);
+    CHECK(scaled[0].raw() == 91);
+    CHECK(scaled[1].raw() == 182);
+    CHECK(scaled[2].raw() == -3);
+}
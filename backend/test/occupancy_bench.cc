@@ -0,0 +1,220 @@
+// 桌台占用压测：随机生成入座、加单、离桌、清台事件写入日志，
+// 对比每条事件 fdatasync 一次与组提交的吞吐，测分店概况查询耗时；
+// 重放日志（含末尾写了一半的记录）和压缩后的日志都应恢复出同样的状态，计数与逐桌累加一致
+#include "plugins/OccupancyBoard.h"
+#include "plugins/OccupancyLog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+std::vector<OccupancyBoard::Event> randomEvents(std::mt19937 &rng, size_t count, uint32_t branches)
+{
+    std::vector<OccupancyBoard::Event> events;
+    std::vector<uint32_t> open;
+    uint32_t nextOrder = 1;
+    for (size_t i = 0; i < count; ++i)
+    {
+        OccupancyBoard::Event event;
+        event.at = 1700000000 + static_cast<int64_t>(i);
+        event.branchId = 1 + rng() % branches;
+        event.table = (rng() % 2 ? "大厅" : "A") + std::to_string(1 + rng() % 30);
+        auto dice = rng() % 100;
+        if (dice < 45 || open.empty())
+        {
+            event.type = OccupancyBoard::Event::Seat;
+            event.orderId = nextOrder++;
+            event.covers = static_cast<uint16_t>(1 + rng() % 8);
+            open.push_back(event.orderId);
+        }
+        else if (dice < 85)
+        {
+            event.type = OccupancyBoard::Event::Release;
+            auto pick = rng() % open.size();
+            event.orderId = open[pick];
+            open[pick] = open.back();
+            open.pop_back();
+        }
+        else if (dice < 95)
+        {
+            event.type = OccupancyBoard::Event::Seat; // 手工入座
+            event.covers = static_cast<uint16_t>(1 + rng() % 8);
+        }
+        else
+        {
+            event.type = OccupancyBoard::Event::Clear;
+        }
+        events.push_back(event);
+    }
+    return events;
+}
+
+// 两个状态逐分店、逐桌比较，并核对计数等于各桌之和
+bool same(const OccupancyBoard &a, const OccupancyBoard &b, uint32_t branches)
+{
+    for (uint32_t branchId = 1; branchId <= branches; ++branchId)
+    {
+        OccupancyBoard::Summary x;
+        OccupancyBoard::Summary y;
+        if (!a.summary(branchId, x) || !b.summary(branchId, y))
+            return false;
+        if (x.capacity != y.capacity || x.covers != y.covers || x.tables != y.tables)
+            return false;
+        auto left = a.tables(branchId);
+        auto right = b.tables(branchId);
+        if (left.size() != right.size() || left.size() != x.tables)
+            return false;
+        uint32_t covers = 0;
+        for (size_t i = 0; i < left.size(); ++i)
+        {
+            auto orders = left[i].orders;
+            auto others = right[i].orders;
+            std::sort(orders.begin(), orders.end());
+            std::sort(others.begin(), others.end());
+            if (left[i].name != right[i].name || left[i].covers != right[i].covers || left[i].since != right[i].since ||
+                left[i].manual != right[i].manual || orders != others)
+                return false;
+            covers += left[i].covers;
+        }
+        if (covers != x.covers)
+            return false;
+    }
+    return a.orderCount() == b.orderCount();
+}
+
+OccupancyBoard replayed(const std::string &path, uint32_t branches, size_t &records)
+{
+    OccupancyBoard board;
+    for (uint32_t branchId = 1; branchId <= branches; ++branchId)
+        board.setCapacity(branchId, 120);
+    OccupancyLog log;
+    std::string error;
+    log.open(path, error);
+    records = log.replay([&board](const OccupancyBoard::Event &event) { board.apply(event); });
+    return board;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+    const size_t batch = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 64;
+    const std::string path = argc > 3 ? argv[3] : "./occupancy_bench.log";
+    const uint32_t branches = 20;
+
+    std::mt19937 rng(42);
+    auto events = randomEvents(rng, count, branches);
+    OccupancyBoard expected;
+    for (uint32_t branchId = 1; branchId <= branches; ++branchId)
+        expected.setCapacity(branchId, 120);
+    uint64_t errors = 0;
+
+    // 每条事件单独落盘，只跑一小段
+    const size_t single = std::min<size_t>(count, 500);
+    {
+        ::unlink(path.c_str());
+        OccupancyLog log;
+        std::string error;
+        if (!log.open(path, error))
+        {
+            std::printf("cannot open %s: %s\n", path.c_str(), error.c_str());
+            return 1;
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < single; ++i)
+            errors += !log.append({events[i]});
+        std::printf("fdatasync per event: %.0f events/s\n", static_cast<double>(single) / secondsSince(start));
+    }
+
+    // 组提交：每批共用一次 fdatasync，落盘后应用
+    ::unlink(path.c_str());
+    {
+        OccupancyLog log;
+        std::string error;
+        log.open(path, error);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t begin = 0; begin < events.size(); begin += batch)
+        {
+            std::vector<OccupancyBoard::Event> group(events.begin() + static_cast<long>(begin),
+                                                     events.begin() + static_cast<long>(std::min(begin + batch, events.size())));
+            errors += !log.append(group);
+            for (const auto &event : group)
+                expected.apply(event);
+        }
+        std::printf("group commit (%zu per batch): %.0f events/s\n", batch, static_cast<double>(count) / secondsSince(start));
+    }
+
+    // 分店概况 O(1)
+    const int queries = 1000000;
+    uint64_t covers = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < queries; ++i)
+    {
+        OccupancyBoard::Summary summary;
+        expected.summary(1 + static_cast<uint32_t>(i) % branches, summary);
+        covers += summary.covers;
+    }
+    std::printf("summary query: %.1f ns (%llu)\n",
+                secondsSince(start) * 1e9 / queries,
+                static_cast<unsigned long long>(covers % 10));
+
+    // 重放：末尾追加半条记录，模拟写到一半断电
+    {
+        int fd = ::open(path.c_str(), O_WRONLY | O_APPEND);
+        const char torn[20] = "PCCO partial record";
+        errors += ::write(fd, torn, sizeof(torn)) != static_cast<ssize_t>(sizeof(torn));
+        ::close(fd);
+    }
+    size_t records = 0;
+    start = std::chrono::steady_clock::now();
+    auto restored = replayed(path, branches, records);
+    std::printf("replay %zu records: %.2f ms\n", records, secondsSince(start) * 1000);
+    if (records != count || !same(expected, restored, branches))
+        ++errors;
+
+    // 压缩成当前状态后重放
+    {
+        OccupancyLog log;
+        std::string error;
+        log.open(path, error);
+        log.replay([](const OccupancyBoard::Event &) {});
+        auto checkpoint = expected.checkpoint();
+        errors += !log.rewrite(checkpoint);
+        std::printf("compacted %zu -> %llu records, %zu orders seated\n",
+                    count,
+                    static_cast<unsigned long long>(log.records()),
+                    expected.orderCount());
+        // 压缩后继续追加
+        auto more = randomEvents(rng, 1000, branches);
+        for (auto &event : more)
+            event.orderId += event.orderId != 0 ? static_cast<uint32_t>(count) : 0;
+        errors += !log.append(more);
+        for (const auto &event : more)
+            expected.apply(event);
+    }
+    auto compacted = replayed(path, branches, records);
+    if (!same(expected, compacted, branches))
+        ++errors;
+    ::unlink(path.c_str());
+
+    if (errors != 0)
+    {
+        std::printf("INCONSISTENT: %llu errors\n", static_cast<unsigned long long>(errors));
+        return 1;
+    }
+    std::printf("consistent\n");
+    return 0;
+}
@@ -0,0 +1,262 @@
+// 桌台占用：入座、加单、离桌、清台的计数，检查点重放，以及写前日志的追加、截断和压缩
+#include <drogon/drogon_test.h>
+#include "plugins/OccupancyLog.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <random>
+#include <unistd.h>
+
+namespace
+{
+using Event = OccupancyBoard::Event;
+
+Event seat(uint32_t branchId, const std::string &table, uint32_t orderId, uint16_t covers, int64_t at)
+{
+    Event event;
+    event.type = Event::Seat;
+    event.branchId = branchId;
+    event.table = table;
+    event.orderId = orderId;
+    event.covers = covers;
+    event.at = at;
+    return event;
+}
+
+Event release(uint32_t orderId)
+{
+    Event event;
+    event.type = Event::Release;
+    event.orderId = orderId;
+    return event;
+}
+
+Event clear(uint32_t branchId, const std::string &table)
+{
+    Event event;
+    event.type = Event::Clear;
+    event.branchId = branchId;
+    event.table = table;
+    return event;
+}
+
+// 两块看板对外可见的状态相同
+bool sameBoard(const OccupancyBoard &a, const OccupancyBoard &b, const std::vector<uint32_t> &branches)
+{
+    for (auto branchId : branches)
+    {
+        OccupancyBoard::Summary x;
+        OccupancyBoard::Summary y;
+        if (a.summary(branchId, x) != b.summary(branchId, y))
+            return false;
+        if (x.capacity != y.capacity || x.covers != y.covers || x.tables != y.tables)
+            return false;
+        auto left = a.tables(branchId);
+        auto right = b.tables(branchId);
+        if (left.size() != right.size())
+            return false;
+        for (size_t i = 0; i < left.size(); ++i)
+        {
+            auto leftOrders = left[i].orders;
+            auto rightOrders = right[i].orders;
+            std::sort(leftOrders.begin(), leftOrders.end());
+            std::sort(rightOrders.begin(), rightOrders.end());
+            if (left[i].name != right[i].name || left[i].covers != right[i].covers ||
+                left[i].since != right[i].since || left[i].manual != right[i].manual || leftOrders != rightOrders)
+                return false;
+        }
+    }
+    return a.orderCount() == b.orderCount();
+}
+
+std::string temporaryLog()
+{
+    return (std::filesystem::temp_directory_path() / ("occupancy_test_" + std::to_string(::getpid()) + ".log"))
+        .string();
+}
+} // namespace
+
+DROGON_TEST(OccupancyBoardEvents)
+{
+    OccupancyBoard board;
+    board.setCapacity(1, 40);
+    CHECK(board.hasBranch(1));
+    CHECK(!board.hasBranch(2));
+    OccupancyBoard::Summary summary;
+    CHECK(!board.summary(2, summary));
+
+    CHECK(board.apply(seat(1, "A1", 100, 4, 10)));
+    // 加单：人数取较大值，不重复累加
+    CHECK(board.apply(seat(1, "A1", 101, 2, 20)));
+    CHECK(board.apply(seat(1, "B2", 102, 3, 30)));
+    REQUIRE(board.summary(1, summary));
+    CHECK(summary.capacity == 40);
+    CHECK(summary.covers == 7);
+    CHECK(summary.tables == 2);
+    auto tables = board.tables(1);
+    REQUIRE(tables.size() == 2);
+    CHECK(tables[0].name == "A1");
+    CHECK(tables[0].orders.size() == 2);
+
+    // 换桌：从原桌离开
+    CHECK(board.apply(seat(1, "C3", 102, 3, 40)));
+    uint32_t branchId = 0;
+    std::string table;
+    REQUIRE(board.locate(102, branchId, table));
+    CHECK(table == "C3");
+    board.summary(1, summary);
+    CHECK(summary.tables == 2);
+
+    // 桌上还有订单时不离桌
+    CHECK(board.apply(release(100)));
+    board.summary(1, summary);
+    CHECK(summary.tables == 2);
+    CHECK(board.apply(release(101)));
+    board.summary(1, summary);
+    CHECK(summary.covers == 3);
+    CHECK(summary.tables == 1);
+    CHECK(!board.apply(release(101)));
+
+    // 手工入座设定人数，订单结束后仍占桌，须清台
+    CHECK(board.apply(seat(1, "D4", 0, 6, 50)));
+    CHECK(board.apply(seat(1, "D4", 103, 2, 60)));
+    CHECK(board.apply(release(103)));
+    board.summary(1, summary);
+    CHECK(summary.covers == 9);
+    CHECK(summary.tables == 2);
+    CHECK(board.apply(clear(1, "D4")));
+    CHECK(!board.apply(clear(1, "D4")));
+    CHECK(!board.apply(seat(1, "", 104, 2, 70)));
+    board.summary(1, summary);
+    CHECK(summary.covers == 3);
+    CHECK(summary.tables == 1);
+
+    board.removeBranch(1);
+    CHECK(!board.hasBranch(1));
+    CHECK(!board.locate(102, branchId, table));
+    CHECK(board.orderCount() == 0);
+}
+
+DROGON_TEST(OccupancyCheckpointReplay)
+{
+    std::mt19937 rng(29);
+    const std::vector<uint32_t> branches{1, 2, 3};
+    OccupancyBoard board;
+    for (auto branchId : branches)
+        board.setCapacity(branchId, 50);
+    std::vector<Event> history;
+    for (int64_t at = 1; at <= 3000; ++at)
+    {
+        auto branchId = branches[rng() % branches.size()];
+        auto table = "T" + std::to_string(rng() % 8);
+        auto orderId = static_cast<uint32_t>(1 + rng() % 60);
+        Event event;
+        switch (rng() % 6)
+        {
+            case 0:
+                event = seat(branchId, table, 0, static_cast<uint16_t>(1 + rng() % 8), at);
+                break;
+            case 1:
+            case 2:
+                event = release(orderId);
+                break;
+            case 3:
+                event = clear(branchId, table);
+                break;
+            default:
+                event = seat(branchId, table, orderId, static_cast<uint16_t>(1 + rng() % 8), at);
+        }
+        board.apply(event);
+        history.push_back(event);
+    }
+
+    // 同样的事件序列重放得到同样的状态
+    OccupancyBoard replayed;
+    for (auto branchId : branches)
+        replayed.setCapacity(branchId, 50);
+    for (const auto &event : history)
+        replayed.apply(event);
+    CHECK(sameBoard(board, replayed, branches));
+
+    // 检查点只用入座事件表示当前状态
+    OccupancyBoard restored;
+    for (auto branchId : branches)
+        restored.setCapacity(branchId, 50);
+    for (const auto &event : board.checkpoint())
+    {
+        CHECK(event.type == Event::Seat);
+        restored.apply(event);
+    }
+    CHECK(sameBoard(board, restored, branches));
+}
+
+DROGON_TEST(OccupancyLogReplay)
+{
+    auto path = temporaryLog();
+    std::filesystem::remove(path);
+    std::vector<Event> events{seat(1, "A1", 100, 4, 10),
+                              seat(1, "A1", 0, 6, 20),
+                              seat(2, std::string(OccupancyLog::kMaxTable + 10, 'x'), 101, 2, 30),
+                              release(100),
+                              clear(2, "B2")};
+    {
+        OccupancyLog log;
+        std::string error;
+        REQUIRE(log.open(path, error));
+        CHECK(log.replay([](const Event &) {}) == 0);
+        REQUIRE(log.append({events[0], events[1]}));
+        REQUIRE(log.append({events[2], events[3], events[4]}));
+        CHECK(log.records() == 5);
+    }
+    // 末尾写了一半的记录在重放时丢弃并截掉
+    {
+        auto size = std::filesystem::file_size(path);
+        std::filesystem::resize_file(path, size + 20);
+    }
+    {
+        OccupancyLog log;
+        std::string error;
+        REQUIRE(log.open(path, error));
+        std::vector<Event> replayed;
+        CHECK(log.replay([&replayed](const Event &event) { replayed.push_back(event); }) == 5);
+        REQUIRE(replayed.size() == 5);
+        for (size_t i = 0; i < replayed.size(); ++i)
+        {
+            CHECK(replayed[i].type == events[i].type);
+            CHECK(replayed[i].branchId == events[i].branchId);
+            CHECK(replayed[i].orderId == events[i].orderId);
+            CHECK(replayed[i].covers == events[i].covers);
+            CHECK(replayed[i].at == events[i].at);
+        }
+        // 过长的桌号截到 kMaxTable 字节
+        CHECK(replayed[2].table == std::string(OccupancyLog::kMaxTable, 'x'));
+        CHECK(log.records() == 5);
+
+        // 压缩后只剩检查点
+        OccupancyBoard board;
+        board.setCapacity(1, 20);
+        board.setCapacity(2, 20);
+        for (const auto &event : replayed)
+            board.apply(event);
+        REQUIRE(log.rewrite(board.checkpoint()));
+        CHECK(log.records() == board.checkpoint().size());
+        REQUIRE(log.append({release(101)}));
+    }
+    {
+        OccupancyLog log;
+        std::string error;
+        REQUIRE(log.open(path, error));
+        OccupancyBoard board;
+        board.setCapacity(1, 20);
+        board.setCapacity(2, 20);
+        log.replay([&board](const Event &event) { board.apply(event); });
+        OccupancyBoard::Summary summary;
+        REQUIRE(board.summary(1, summary));
+        CHECK(summary.covers == 6);
+        CHECK(summary.tables == 1);
+        REQUIRE(board.summary(2, summary));
+        CHECK(summary.tables == 0);
+        CHECK(board.orderCount() == 0);
+    }
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,226 @@
+// 营业时间压测：随机生成各分店的营业时间文本，
+// 对比"每次请求逐个解析文本"与"缓存编译好的位图"回答全部分店是否营业的耗时，
+// 并按生成时的结构化时段逐分钟核对 isOpen 和 minutesUntilChange
+#include "plugins/OpeningHours.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+using Ranges = std::vector<std::pair<uint32_t, uint32_t>>;
+
+struct Plan
+{
+    std::string text;
+    std::vector<Ranges> weekly{7}; // 0 为周一，结束小于开始为跨夜
+    std::map<int32_t, Ranges> holidays;
+};
+
+const char *const kWeekdays[] = {"周一", "周二", "周三", "周四", "周五", "周六", "周日"};
+
+std::string hhmm(uint32_t minutes)
+{
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "%02u:%02u", minutes / 60, minutes % 60);
+    return buffer;
+}
+
+Ranges randomRanges(std::mt19937 &rng, bool overnight)
+{
+    Ranges ranges;
+    if (rng() % 10 == 0)
+        return ranges;
+    auto start = static_cast<uint32_t>(6 * 60 + rng() % 48 * 5);
+    auto end = static_cast<uint32_t>(start + 60 + rng() % 60 * 5);
+    if (rng() % 2)
+    {
+        // 午市、晚市两段
+        ranges.emplace_back(start, end);
+        start = end + 30 + static_cast<uint32_t>(rng() % 24 * 5);
+        end = start + 120 + static_cast<uint32_t>(rng() % 36 * 5);
+    }
+    if (overnight && rng() % 4 == 0)
+        end = static_cast<uint32_t>(rng() % 48 * 5);
+    else
+        end = std::min(end, 24u * 60);
+    if (start < 24 * 60 && start != end)
+        ranges.emplace_back(start, end);
+    return ranges;
+}
+
+std::string rangesText(const Ranges &ranges)
+{
+    if (ranges.empty())
+        return "休息";
+    std::string text;
+    for (const auto &[start, end] : ranges)
+        text += (text.empty() ? "" : ",") + hhmm(start) + "-" + hhmm(end);
+    return text;
+}
+
+Plan randomPlan(std::mt19937 &rng, int32_t today)
+{
+    Plan plan;
+    auto daily = randomRanges(rng, true);
+    plan.text = "每天 " + rangesText(daily);
+    for (auto &ranges : plan.weekly)
+        ranges = daily;
+    // 个别星期单独设置，后面的覆盖前面的
+    for (auto i = rng() % 3; i > 0; --i)
+    {
+        auto day = rng() % 7;
+        plan.weekly[day] = randomRanges(rng, true);
+        plan.text += "；" + std::string(kWeekdays[day]) + " " + rangesText(plan.weekly[day]);
+    }
+    for (auto i = rng() % 3; i > 0; --i)
+    {
+        auto day = today + static_cast<int32_t>(rng() % 14);
+        auto ranges = randomRanges(rng, false);
+        plan.holidays[day] = ranges;
+        // 由天数反推年、月、日
+        char date[32];
+        int32_t year = 2000;
+        uint32_t month = 1;
+        for (int32_t y = 2000; y <= 2100; ++y)
+            if (OpeningHours::dayOf(y, 1, 1) <= day)
+                year = y;
+        for (uint32_t m = 1; m <= 12; ++m)
+            if (OpeningHours::dayOf(year, m, 1) <= day)
+                month = m;
+        auto dayOfMonth = static_cast<uint32_t>(day - OpeningHours::dayOf(year, month, 1) + 1);
+        std::snprintf(date, sizeof(date), "%04d-%02u-%02u", year, month, dayOfMonth);
+        plan.text += "\n" + std::string(date) + " " + rangesText(ranges);
+    }
+    return plan;
+}
+
+bool covers(const Ranges &ranges, uint32_t minute, bool spill)
+{
+    for (const auto &[start, end] : ranges)
+    {
+        if (spill)
+        {
+            if (end < start && minute < end)
+                return true;
+            continue;
+        }
+        if (start < end ? (minute >= start && minute < end) : minute >= start)
+            return true;
+    }
+    return false;
+}
+
+bool expectedOpen(const Plan &plan, int32_t day, uint32_t minute)
+{
+    auto holiday = plan.holidays.find(day);
+    if (holiday != plan.holidays.end())
+        return covers(holiday->second, minute, false);
+    auto weekday = OpeningHours::weekdayOf(day);
+    return covers(plan.weekly[weekday], minute, false) || covers(plan.weekly[(weekday + 6) % 7], minute, true);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const uint32_t branches = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 200;
+    const uint32_t queries = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 2000;
+
+    std::mt19937 rng(42);
+    const int32_t today = OpeningHours::dayOf(2025, 9, 29);
+    std::vector<Plan> plans;
+    std::vector<OpeningHours> compiled(branches);
+    uint64_t errors = 0;
+    size_t textBytes = 0;
+    for (uint32_t i = 0; i < branches; ++i)
+    {
+        plans.push_back(randomPlan(rng, today));
+        textBytes += plans.back().text.size();
+        std::string error;
+        if (!OpeningHours::parse(plans.back().text, compiled[i], error))
+        {
+            std::printf("parse failed: %s\n", error.c_str());
+            ++errors;
+        }
+    }
+    std::printf("%u branches, %.1f bytes of text per branch, %zu bytes of bitmap per branch\n",
+                branches,
+                static_cast<double>(textBytes) / branches,
+                sizeof(OpeningHours::Day) * 7);
+
+    std::vector<std::pair<int32_t, uint32_t>> moments;
+    for (uint32_t i = 0; i < queries; ++i)
+        moments.emplace_back(today + static_cast<int32_t>(rng() % 14), static_cast<uint32_t>(rng() % (24 * 60)));
+
+    // 每次请求解析全部分店的文本
+    uint64_t parsedOpen = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &[day, minute] : moments)
+        for (const auto &plan : plans)
+        {
+            OpeningHours hours;
+            std::string error;
+            OpeningHours::parse(plan.text, hours, error);
+            parsedOpen += hours.isOpen(day, minute);
+        }
+    auto parseUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    // 缓存的位图一遍扫过
+    uint64_t cachedOpen = 0;
+    start = std::chrono::steady_clock::now();
+    for (const auto &[day, minute] : moments)
+        for (const auto &hours : compiled)
+            cachedOpen += hours.isOpen(day, minute);
+    auto cachedUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    if (parsedOpen != cachedOpen)
+        ++errors;
+    std::printf("open now across all branches: parse %.2f us, cached %.3f us (%.1f%% open)\n",
+                parseUs / queries,
+                cachedUs / queries,
+                100.0 * static_cast<double>(cachedOpen) / queries / branches);
+
+    // 逐分钟核对：状态与结构化时段一致，下一次变化的时刻之前状态不变、到时刻后改变
+    const uint32_t checked = std::min(branches, 50u);
+    for (uint32_t i = 0; i < checked; ++i)
+        for (int32_t day = today; day < today + 14; ++day)
+            for (uint32_t minute = 0; minute < 24 * 60; minute += 7)
+            {
+                bool open = expectedOpen(plans[i], day, minute);
+                if (compiled[i].isOpen(day, minute) != open)
+                {
+                    ++errors;
+                    continue;
+                }
+                auto change = compiled[i].minutesUntilChange(day, minute, 8);
+                if (change < 0)
+                    change = 9 * 24 * 60;
+                for (int64_t step = 5; step < change; step += 5)
+                {
+                    auto at = static_cast<int64_t>(minute) + step;
+                    if (expectedOpen(plans[i], day + static_cast<int32_t>(at / (24 * 60)), static_cast<uint32_t>(at % (24 * 60))) != open)
+                    {
+                        ++errors;
+                        break;
+                    }
+                    if (step > 9 * 24 * 60)
+                        break;
+                }
+                auto at = static_cast<int64_t>(minute) + change;
+                if (change < 9 * 24 * 60 &&
+                    expectedOpen(plans[i], day + static_cast<int32_t>(at / (24 * 60)), static_cast<uint32_t>(at % (24 * 60))) == open)
+                    ++errors;
+            }
+
+    if (errors != 0)
+    {
+        std::printf("INCONSISTENT: %llu errors\n", static_cast<unsigned long long>(errors));
+        return 1;
+    }
+    std::printf("consistent\n");
+    return 0;
+}
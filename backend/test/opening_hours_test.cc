@@ -0,0 +1,133 @@
+// 分店营业时间：星期与时段解析、跨夜时段、节假日覆盖，以及格式错误的提示
+#include <drogon/drogon_test.h>
+#include "plugins/OpeningHours.h"
+
+namespace
+{
+uint32_t at(uint32_t hour, uint32_t minute = 0)
+{
+    return hour * 60 + minute;
+}
+} // namespace
+
+DROGON_TEST(OpeningHoursWeekly)
+{
+    // 2025-10-06 是周一
+    const auto monday = OpeningHours::dayOf(2025, 10, 6);
+    CHECK(OpeningHours::weekdayOf(monday) == 0);
+    CHECK(OpeningHours::weekdayOf(OpeningHours::dayOf(1970, 1, 1)) == 3);
+    CHECK(OpeningHours::dayOf(1970, 1, 1) == 0);
+
+    OpeningHours hours;
+    std::string error;
+    REQUIRE(OpeningHours::parse("周一至周五 11:00-14:00,17:00-21:30；周末 10:00-22:00；周三 休息", hours, error));
+    CHECK(!hours.isOpen(monday, at(10, 55)));
+    CHECK(hours.isOpen(monday, at(11)));
+    CHECK(hours.isOpen(monday, at(13, 55)));
+    CHECK(!hours.isOpen(monday, at(14)));
+    CHECK(hours.isOpen(monday, at(21, 25)));
+    CHECK(!hours.isOpen(monday, at(21, 30)));
+    // 后面的段覆盖前面同一天的设置
+    CHECK(!hours.isOpen(monday + 2, at(12)));
+    CHECK(hours.isOpen(monday + 5, at(10)));
+    CHECK(hours.isOpen(monday + 6, at(21, 59)));
+    CHECK(hours.holidays().empty());
+
+    CHECK(hours.minutesUntilChange(monday, at(12)) == 120);
+    CHECK(hours.minutesUntilChange(monday, at(15)) == 120);
+    // 周二 21:30 关门到周四 11:00
+    CHECK(hours.minutesUntilChange(monday + 1, at(21, 30)) == 24 * 60 + 2 * 60 + 30 + 11 * 60);
+
+    // 英文星期、省略星期即每天
+    REQUIRE(OpeningHours::parse("Mon-Fri 09:00-18:00\nSat,Sun closed", hours, error));
+    CHECK(hours.isOpen(monday + 4, at(9)));
+    CHECK(!hours.isOpen(monday + 5, at(12)));
+    REQUIRE(OpeningHours::parse("全天", hours, error));
+    CHECK(hours.isOpen(monday + 3, at(0)));
+    CHECK(hours.isOpen(monday + 3, at(23, 59)));
+    CHECK(hours.minutesUntilChange(monday, at(12)) == -1);
+}
+
+DROGON_TEST(OpeningHoursOvernight)
+{
+    const auto friday = OpeningHours::dayOf(2025, 10, 10);
+    REQUIRE(OpeningHours::weekdayOf(friday) == 4);
+    OpeningHours hours;
+    std::string error;
+    // 结束早于开始表示营业到次日
+    REQUIRE(OpeningHours::parse("周五 18:00-02:00", hours, error));
+    CHECK(!hours.isOpen(friday, at(17, 55)));
+    CHECK(hours.isOpen(friday, at(23, 59)));
+    CHECK(hours.isOpen(friday + 1, at(1, 55)));
+    CHECK(!hours.isOpen(friday + 1, at(2)));
+    // 周四凌晨没有从周三延续过来的时段
+    CHECK(!hours.isOpen(friday - 1, at(1)));
+    // 跨过零点的剩余营业时长
+    CHECK(hours.minutesUntilChange(friday, at(23)) == 180);
+
+    // 周日跨到周一
+    REQUIRE(OpeningHours::parse("周日 20:00-01:00", hours, error));
+    CHECK(hours.isOpen(friday + 3, at(0, 30)));
+    CHECK(!hours.isOpen(friday + 3, at(1)));
+}
+
+DROGON_TEST(OpeningHoursHolidays)
+{
+    const auto national = OpeningHours::dayOf(2025, 10, 1);
+    OpeningHours hours;
+    std::string error;
+    REQUIRE(OpeningHours::parse("每天 20:00-02:00；2025-10-01 休息；2025-10-02至2025-10-03 10:00-14:00", hours, error));
+    REQUIRE(hours.holidays().size() == 3);
+    CHECK(hours.holidays().front().first == national);
+    // 节假日整天替换，包括前一天跨夜延续过来的部分
+    CHECK(hours.isOpen(national - 1, at(21)));
+    CHECK(!hours.isOpen(national, at(1)));
+    CHECK(!hours.isOpen(national, at(21)));
+    CHECK(hours.isOpen(national + 1, at(12)));
+    CHECK(!hours.isOpen(national + 1, at(21)));
+    CHECK(!hours.isOpen(national + 2, at(14)));
+    // 节假日之后恢复每周的设置
+    CHECK(hours.isOpen(national + 3, at(1)));
+    CHECK(hours.isOpen(national + 3, at(20)));
+    // 前一天的跨夜时段在节假日零点结束
+    CHECK(hours.minutesUntilChange(national - 1, at(23)) == 60);
+}
+
+DROGON_TEST(OpeningHoursMalformed)
+{
+    OpeningHours hours;
+    std::string error;
+    REQUIRE(OpeningHours::parse("每天 10:00-22:00", hours, error));
+    const auto day = OpeningHours::dayOf(2025, 10, 6);
+
+    const char *const malformed[] = {
+        "",
+        " ；；",
+        "周一 25:00-26:00",
+        "10:03-12:00",
+        "10:00",
+        "10:00-10:00",
+        "周一 abc",
+        "周一, 10:00-12:00",
+        "10:00-12:00 外卖",
+        "2025-02-29 休息",
+        "2025-10-01 22:00-02:00",
+        "2025-10-05至2025-10-01 休息",
+    };
+    for (auto text : malformed)
+    {
+        error.clear();
+        CHECK(!OpeningHours::parse(text, hours, error));
+        CHECK(!error.empty());
+    }
+    // 失败时不改动原来的结果
+    CHECK(hours.isOpen(day, at(12)));
+
+    // 出错的段号和原文写进提示
+    CHECK(!OpeningHours::parse("每天 10:00-22:00；周二 10:07-12:00", hours, error));
+    CHECK(error.find("第 2 段") != std::string::npos);
+    CHECK(error.find("周二 10:07-12:00") != std::string::npos);
+    CHECK(error.find("5 分钟") != std::string::npos);
+    CHECK(!OpeningHours::parse("2025-10-01 22:00-02:00", hours, error));
+    CHECK(error.find("跨夜") != std::string::npos);
+}
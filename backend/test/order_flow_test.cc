@@ -0,0 +1,93 @@
+// 订单状态机：状态、支付状态的合法推进，以及厨房队列按状态机推进和移出
+#include <drogon/drogon_test.h>
+#include "plugins/KitchenQueue.h"
+#include "plugins/OrderFlow.h"
+
+DROGON_TEST(OrderFlowStatus)
+{
+    using Status = OrderFlow::Status;
+    const Status all[] = {
+        Status::Pending, Status::Confirmed, Status::Cooking, Status::Ready, Status::Completed, Status::Cancelled};
+    // 允许的推进，行为原状态，列按 all 的顺序
+    const bool allowed[6][6] = {
+        {true, true, false, false, false, true},    // 待确认
+        {false, true, true, false, false, true},    // 已确认
+        {false, false, true, true, true, true},     // 制作中
+        {false, false, false, true, true, true},    // 待派送
+        {false, false, false, false, true, false},  // 已完成
+        {false, false, false, false, false, true},  // 已取消
+    };
+    for (size_t from = 0; from < 6; ++from)
+    {
+        CHECK(OrderFlow::active(all[from]) == (from < 4));
+        for (size_t to = 0; to < 6; ++to)
+            CHECK(OrderFlow::canMove(all[from], all[to]) == allowed[from][to]);
+        Status parsed;
+        REQUIRE(OrderFlow::parse(OrderFlow::name(all[from]), parsed));
+        CHECK(parsed == all[from]);
+    }
+
+    using Payment = OrderFlow::Payment;
+    CHECK(OrderFlow::canMove(Payment::Unpaid, Payment::Paid));
+    CHECK(OrderFlow::canMove(Payment::Paid, Payment::Refunded));
+    CHECK(OrderFlow::canMove(Payment::Paid, Payment::Paid));
+    CHECK(!OrderFlow::canMove(Payment::Unpaid, Payment::Refunded));
+    CHECK(!OrderFlow::canMove(Payment::Refunded, Payment::Paid));
+}
+
+DROGON_TEST(OrderFlowCheckByName)
+{
+    std::string error;
+    CHECK(OrderFlow::checkStatus("待确认", "已确认", error));
+    CHECK(OrderFlow::checkStatus("制作中", "已完成", error));
+    // 原状态为空或不认识的历史数据只校验新状态
+    CHECK(OrderFlow::checkStatus("", "已完成", error));
+    CHECK(OrderFlow::checkStatus("处理中", "已完成", error));
+    CHECK(OrderFlow::checkStatus("已完成", "已完成", error));
+
+    CHECK(!OrderFlow::checkStatus("已完成", "制作中", error));
+    CHECK(error.find("已完成") != std::string::npos);
+    CHECK(!OrderFlow::checkStatus("待确认", "待派送", error));
+    CHECK(!OrderFlow::checkStatus("待确认", "完成", error));
+    CHECK(error.find("order_status") == 0);
+
+    CHECK(OrderFlow::checkPayment("待支付", "已支付", error));
+    CHECK(!OrderFlow::checkPayment("已退款", "已支付", error));
+    CHECK(error.find("payment_status") == 0);
+}
+
+DROGON_TEST(KitchenQueueMoves)
+{
+    using Status = OrderFlow::Status;
+    KitchenQueue queue({0, 60, 300});
+    KitchenQueue::Ticket ticket;
+    ticket.orderId = 1;
+    ticket.branchId = 7;
+    ticket.placedAt = 1000;
+    CHECK(queue.put(ticket) == KitchenQueue::Change::Put);
+    // 外卖提前 300 秒，排在更早下单的堂食前面
+    ticket.orderId = 2;
+    ticket.kind = KitchenQueue::Kind::Delivery;
+    ticket.placedAt = 1200;
+    queue.put(ticket);
+    auto listed = queue.list(7);
+    REQUIRE(listed.size() == 2);
+    CHECK(listed[0].orderId == 2);
+
+    KitchenQueue::Ticket moved;
+    CHECK(queue.move(1, Status::Ready, 1300, moved) == KitchenQueue::Move::Rejected);
+    CHECK(queue.move(1, Status::Confirmed, 1300, moved) == KitchenQueue::Move::Moved);
+    CHECK(moved.status == Status::Confirmed);
+    CHECK(moved.changedAt == 1300);
+    CHECK(queue.move(1, Status::Cooking, 1400, moved) == KitchenQueue::Move::Moved);
+    // 到终态即移出队列
+    CHECK(queue.move(1, Status::Completed, 1500, moved) == KitchenQueue::Move::Moved);
+    CHECK(queue.find(1) == nullptr);
+    CHECK(queue.move(1, Status::Cancelled, 1600, moved) == KitchenQueue::Move::NotFound);
+    CHECK(queue.list(7).size() == 1);
+
+    ticket.status = Status::Cancelled;
+    CHECK(queue.put(ticket) == KitchenQueue::Change::Removed);
+    CHECK(queue.size() == 0);
+    CHECK(queue.list(7).empty());
+}
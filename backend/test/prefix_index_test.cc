@@ -0,0 +1,138 @@
+// 会员检索索引：前缀、子串匹配，增量写入与归并后和暴力查找一致
+#include <drogon/drogon_test.h>
+#include "plugins/PrefixIndex.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+
+namespace
+{
+std::set<uint32_t> toSet(const std::vector<uint32_t> &ids)
+{
+    return std::set<uint32_t>(ids.begin(), ids.end());
+}
+
+// 暴力查找：任一字段以查询开头为前缀匹配，长度够时在其他位置出现为子串匹配
+void bruteForce(const std::map<uint32_t, std::vector<std::string>> &members,
+                const std::string &query,
+                std::set<uint32_t> &prefixes,
+                std::set<uint32_t> &infixes)
+{
+    auto key = PrefixIndex::normalize(query);
+    for (const auto &[memberId, fields] : members)
+        for (const auto &field : fields)
+        {
+            auto normalized = PrefixIndex::normalize(field);
+            if (normalized.empty())
+                continue;
+            if (normalized.compare(0, key.size(), key) == 0)
+                prefixes.insert(memberId);
+            else if (key.size() >= PrefixIndex::kMinInfix && normalized.find(key, 1) != std::string::npos)
+                infixes.insert(memberId);
+        }
+    for (auto memberId : prefixes)
+        infixes.erase(memberId);
+}
+} // namespace
+
+DROGON_TEST(PrefixIndexBasics)
+{
+    PrefixIndex index;
+    index.load({{1, {"13800138000", "Alice Wang"}}, {2, {"13912345678", "张三丰"}}, {3, {"", "alice"}}});
+    CHECK(index.size() == 3);
+    CHECK(PrefixIndex::normalize(" Alice  Wang ") == "alicewang");
+
+    std::vector<uint32_t> ids;
+    index.search("138", 10, ids);
+    CHECK(ids == std::vector<uint32_t>{1});
+    // ASCII 不区分大小写，空白不计
+    index.search("ALICE", 10, ids);
+    CHECK((toSet(ids) == std::set<uint32_t>{1, 3}));
+    index.search("wang", 10, ids);
+    CHECK(ids == std::vector<uint32_t>{1});
+    index.search("345", 10, ids);
+    CHECK(ids == std::vector<uint32_t>{2});
+    // 中文按字符边界取子串，短于 kMinInfix 字节的查询只做前缀匹配
+    index.search("三丰", 10, ids);
+    CHECK(ids == std::vector<uint32_t>{2});
+    index.search("00", 10, ids);
+    CHECK(ids.empty());
+    index.search("张", 10, ids);
+    CHECK(ids == std::vector<uint32_t>{2});
+    index.search("  ", 10, ids);
+    CHECK(ids.empty());
+
+    index.set(3, {"13800999999", "bob"});
+    index.search("1380", 10, ids);
+    CHECK(ids.size() == 2);
+    CHECK((toSet(ids) == std::set<uint32_t>{1, 3}));
+    index.search("alice", 10, ids);
+    CHECK(ids == std::vector<uint32_t>{1});
+    index.search("1380", 1, ids);
+    CHECK(ids.size() == 1);
+
+    index.remove(1);
+    CHECK(index.fieldsOf(1) == nullptr);
+    REQUIRE(index.fieldsOf(3) != nullptr);
+    CHECK(index.fieldsOf(3)->at(1) == "bob");
+    index.search("1380", 10, ids);
+    CHECK(ids == std::vector<uint32_t>{3});
+}
+
+DROGON_TEST(PrefixIndexMatchesBruteForce)
+{
+    std::mt19937 rng(17);
+    const std::string names[] = {"wang", "li", "zhang", "liu", "chen", "王", "李", "张伟", "刘洋", "陈静"};
+    auto randomFields = [&]() {
+        std::string phone = "1";
+        for (int i = 0; i < 10; ++i)
+            phone += static_cast<char>('0' + rng() % 10);
+        return std::vector<std::string>{phone, names[rng() % 10] + names[rng() % 10] + std::to_string(rng() % 100)};
+    };
+
+    PrefixIndex index;
+    std::map<uint32_t, std::vector<std::string>> members;
+    std::vector<std::pair<uint32_t, std::vector<std::string>>> initial;
+    for (uint32_t memberId = 1; memberId <= 2000; ++memberId)
+    {
+        members[memberId] = randomFields();
+        initial.emplace_back(memberId, members[memberId]);
+    }
+    index.load(std::move(initial));
+    // 增量写入足够多，触发几次归并
+    for (int step = 0; step < 6000; ++step)
+    {
+        auto memberId = static_cast<uint32_t>(1 + rng() % 3000);
+        if (rng() % 5 == 0)
+        {
+            index.remove(memberId);
+            members.erase(memberId);
+        }
+        else
+        {
+            members[memberId] = randomFields();
+            index.set(memberId, members[memberId]);
+        }
+    }
+    CHECK(index.size() == members.size());
+
+    const std::string queries[] = {
+        "13", "138", "1395", "55", "555", "0123", "wang", "zhang1", "ng5", "王李", "伟刘", "chen9"};
+    std::vector<uint32_t> ids;
+    for (const auto &query : queries)
+    {
+        std::set<uint32_t> prefixes;
+        std::set<uint32_t> infixes;
+        bruteForce(members, query, prefixes, infixes);
+        index.search(query, 100000, ids);
+        REQUIRE(ids.size() == prefixes.size() + infixes.size());
+        // 前缀匹配在前，子串匹配在后
+        auto split = ids.begin() + static_cast<long>(prefixes.size());
+        CHECK(std::set<uint32_t>(ids.begin(), split) == prefixes);
+        CHECK(std::set<uint32_t>(split, ids.end()) == infixes);
+        index.search(query, 5, ids);
+        CHECK(ids.size() == std::min<size_t>(5, prefixes.size() + infixes.size()));
+    }
+}
@@ -0,0 +1,69 @@
+// 订单计价压测：构造一个租户的菜品、会员等级和活动，统计单次试算耗时
+#include "plugins/PricingRules.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+int main(int argc, char **argv)
+{
+    const int quotes = argc > 1 ? std::atoi(argv[1]) : 200000;
+    const uint32_t dishes = 500;
+    const uint32_t members = 100000;
+    const int64_t now = 1760000000;
+    std::mt19937 rng(42);
+
+    PricingRules rules;
+    for (uint32_t d = 1; d <= dishes; ++d)
+        rules.setDish(d, {Money::fromRaw(500 + rng() % 20000), "dish" + std::to_string(d), d % 50 != 0});
+    for (uint32_t level = 1; level <= 4; ++level)
+        rules.setLevelRate(level, Rate::fromRaw(10000 - 500 * level));
+    for (uint32_t m = 1; m <= members; ++m)
+        rules.setMemberLevel(m, 1 + m % 4);
+    for (uint32_t c = 1; c <= 20; ++c)
+    {
+        PricingRules::Campaign campaign;
+        std::string content = c % 4 == 0
+                                  ? "{\"type\":\"full_reduction\",\"threshold\":" + std::to_string(50 * c) +
+                                        ",\"reduction\":" + std::to_string(5 * c) + "}"
+                                  : "{\"type\":\"discount\",\"rate\":0.85,\"dish_ids\":[" + std::to_string(c) + "," +
+                                        std::to_string(c * 7) + "," + std::to_string(c * 13) + "]}";
+        if (!PricingRules::compileCampaign(content, campaign))
+            return 1;
+        campaign.campaignId = c;
+        campaign.name = "campaign" + std::to_string(c);
+        campaign.levelId = c % 3 == 0 ? 2 : 0;
+        campaign.start = now - 86400;
+        campaign.end = now + 86400;
+        rules.setCampaign(std::move(campaign));
+    }
+
+    // 预先生成购物车，计时只包含计价
+    std::vector<std::vector<PricingRules::Line>> carts(1024);
+    for (auto &cart : carts)
+    {
+        size_t lines = 1 + rng() % 12;
+        for (size_t i = 0; i < lines; ++i)
+        {
+            uint32_t dishId = 1 + rng() % dishes;
+            if (dishId % 50 == 0)
+                ++dishId;
+            cart.push_back({dishId, static_cast<int64_t>(1 + rng() % 3)});
+        }
+    }
+
+    PricingRules::Quote quote;
+    int64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int q = 0; q < quotes; ++q)
+    {
+        if (rules.quote(1 + q % members, carts[q % carts.size()], now, quote))
+            checksum += quote.total.raw();
+    }
+    auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%d quotes, %.2f us/quote, checksum %lld\n", quotes, elapsed / quotes, static_cast<long long>(checksum));
+    return 0;
+}
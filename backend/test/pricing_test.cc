@@ -0,0 +1,193 @@
+// 订单计价：单品折扣、会员折扣、满减的先后顺序与逐行取整，不可售菜品
+#include <drogon/drogon_test.h>
+#include "plugins/PricingRules.h"
+
+namespace
+{
+const int64_t kNow = 1760000000;
+
+PricingRules::Campaign campaignOf(uint32_t campaignId, const std::string &content, uint32_t levelId = 0)
+{
+    PricingRules::Campaign campaign;
+    PricingRules::compileCampaign(content, campaign);
+    campaign.campaignId = campaignId;
+    campaign.name = "活动" + std::to_string(campaignId);
+    campaign.levelId = levelId;
+    return campaign;
+}
+
+PricingRules rulesOf()
+{
+    PricingRules rules;
+    rules.setDish(1, {Money::fromRaw(1999), "宫保鸡丁", true});
+    rules.setDish(2, {Money::fromRaw(3500), "水煮鱼", true});
+    rules.setDish(3, {Money::fromRaw(800), "米饭", true});
+    rules.setDish(4, {Money::fromRaw(2800), "售罄菜", false});
+    rules.setLevelRate(1, Rate::fromRaw(9500));
+    rules.setMemberLevel(100, 1);
+    return rules;
+}
+} // namespace
+
+DROGON_TEST(PricingCompileCampaign)
+{
+    PricingRules::Campaign campaign;
+    REQUIRE(PricingRules::compileCampaign("{\"type\":\"discount\",\"rate\":\"0.8\",\"dish_ids\":[3,1]}", campaign));
+    CHECK(campaign.kind == PricingRules::Campaign::Discount);
+    CHECK(campaign.rate == Rate::fromRaw(8000));
+    CHECK(campaign.dishIds == std::vector<uint32_t>({1, 3}));
+    REQUIRE(PricingRules::compileCampaign("{\"type\":\"full_reduction\",\"threshold\":100,\"reduction\":20}", campaign));
+    CHECK(campaign.kind == PricingRules::Campaign::FullReduction);
+    CHECK(campaign.threshold == Money::fromInteger(100));
+    CHECK(campaign.reduction == Money::fromInteger(20));
+
+    CHECK(!PricingRules::compileCampaign("周末八折", campaign));
+    CHECK(!PricingRules::compileCampaign("{\"type\":\"discount\",\"rate\":1.5}", campaign));
+    CHECK(!PricingRules::compileCampaign("{\"type\":\"discount\",\"rate\":0}", campaign));
+    CHECK(!PricingRules::compileCampaign("{\"type\":\"full_reduction\",\"threshold\":100,\"reduction\":0}", campaign));
+}
+
+DROGON_TEST(PricingLines)
+{
+    std::vector<PricingRules::Line> lines;
+    Json::Value items(Json::arrayValue);
+    CHECK(!PricingRules::linesFromJson(items, lines));
+    Json::Value item;
+    item["dish_id"] = 1;
+    item["quantity"] = 2;
+    items.append(item);
+    REQUIRE(PricingRules::linesFromJson(items, lines));
+    CHECK(lines.size() == 1);
+    item["quantity"] = 0;
+    items.append(item);
+    CHECK(!PricingRules::linesFromJson(items, lines));
+    items[1]["quantity"] = static_cast<Json::Int64>(PricingRules::kMaxQuantity + 1);
+    CHECK(!PricingRules::linesFromJson(items, lines));
+    items[1]["quantity"] = 1.5;
+    CHECK(!PricingRules::linesFromJson(items, lines));
+}
+
+DROGON_TEST(PricingQuote)
+{
+    auto rules = rulesOf();
+    PricingRules::Quote quote;
+
+    // 非会员、无活动：同一菜品的多行合并
+    REQUIRE(rules.quote(0, {{1, 1}, {3, 2}, {1, 1}}, kNow, quote));
+    REQUIRE(quote.lines.size() == 2);
+    CHECK(quote.lines[0].quantity == 2);
+    CHECK(quote.subtotal == Money::fromRaw(1999 * 2 + 1600));
+    CHECK(quote.total == quote.subtotal);
+    CHECK(quote.discount == Money());
+
+    // 单品 8 折 -> 会员 95 折 -> 满 50 减 5，每步逐行四舍五入
+    rules.setCampaign(campaignOf(1, "{\"type\":\"discount\",\"rate\":0.8,\"dish_ids\":[1]}"));
+    rules.setCampaign(campaignOf(2, "{\"type\":\"discount\",\"rate\":0.9}"));
+    rules.setCampaign(campaignOf(3, "{\"type\":\"full_reduction\",\"threshold\":50,\"reduction\":5}"));
+    rules.setCampaign(campaignOf(4, "{\"type\":\"full_reduction\",\"threshold\":100,\"reduction\":15}"));
+    REQUIRE(rules.quote(100, {{1, 1}, {2, 1}}, kNow, quote));
+    CHECK(quote.levelId == 1);
+    // 19.99 * 0.8 = 15.992 -> 15.99，* 0.95 = 15.1905 -> 15.19
+    CHECK(quote.lines[0].campaignId == 1);
+    CHECK(quote.lines[0].total == Money::fromRaw(1519));
+    // 35.00 * 0.9 = 31.50，* 0.95 = 29.925 -> 29.93
+    CHECK(quote.lines[1].campaignId == 2);
+    CHECK(quote.lines[1].total == Money::fromRaw(2993));
+    CHECK(quote.campaignDiscount == Money::fromRaw(400 + 350));
+    CHECK(quote.memberDiscount == Money::fromRaw(80 + 157));
+    // 折后 45.12 未到 50 的门槛
+    CHECK(quote.reduction == Money());
+    CHECK(quote.total == Money::fromRaw(4512));
+    CHECK(quote.discount == quote.subtotal - quote.total);
+    CHECK(quote.applied.size() == 3);
+
+    // 按折后金额取减免最多的一档
+    REQUIRE(rules.quote(0, {{2, 4}}, kNow, quote));
+    CHECK(quote.subtotal == Money::fromInteger(140));
+    CHECK(quote.reduction == Money::fromInteger(15));
+    CHECK(quote.total == Money::fromInteger(140 - 14 - 15));
+    CHECK(quote.applied.back().campaignId == 4);
+}
+
+DROGON_TEST(PricingCampaignWindow)
+{
+    auto rules = rulesOf();
+    auto campaign = campaignOf(1, "{\"type\":\"discount\",\"rate\":0.5}", 1);
+    campaign.start = kNow;
+    campaign.end = kNow + 3600;
+    rules.setCampaign(campaign);
+    PricingRules::Quote quote;
+
+    // 只对等级 1 的会员，在 [start, end) 内有效
+    REQUIRE(rules.quote(0, {{3, 1}}, kNow, quote));
+    CHECK(quote.total == Money::fromRaw(800));
+    REQUIRE(rules.quote(100, {{3, 1}}, kNow - 1, quote));
+    CHECK(quote.lines[0].campaignId == 0);
+    REQUIRE(rules.quote(100, {{3, 1}}, kNow, quote));
+    CHECK(quote.lines[0].total == Money::fromRaw(380));
+    REQUIRE(rules.quote(100, {{3, 1}}, kNow + 3600, quote));
+    CHECK(quote.lines[0].campaignId == 0);
+
+    CHECK(rules.removeCampaign(1));
+    CHECK(!rules.removeCampaign(1));
+    REQUIRE(rules.quote(100, {{3, 1}}, kNow, quote));
+    CHECK(quote.lines[0].total == Money::fromRaw(760));
+}
+
+DROGON_TEST(PricingVoucherCampaign)
+{
+    auto rules = rulesOf();
+    // 满 30 减 10 的券活动，只对等级 2 开放也不影响凭券使用
+    auto campaign = campaignOf(7, "{\"type\":\"full_reduction\",\"threshold\":30,\"reduction\":10,\"voucher\":true}", 2);
+    REQUIRE(campaign.voucher);
+    campaign.start = kNow;
+    campaign.end = kNow + 3600;
+    rules.setCampaign(campaign);
+    rules.setCampaign(campaignOf(8, "{\"type\":\"full_reduction\",\"threshold\":30,\"reduction\":3}"));
+    CHECK(rules.campaignActive(7, kNow));
+    CHECK(!rules.campaignActive(7, kNow + 3600));
+    CHECK(!rules.campaignActive(9, kNow));
+    PricingRules::Quote quote;
+
+    // 不出示券时券活动不参与
+    REQUIRE(rules.quote(0, {{2, 1}}, kNow, quote));
+    CHECK(quote.reduction == Money::fromInteger(3));
+    CHECK(quote.voucherCampaignId == 0);
+    REQUIRE(rules.quote(0, {{2, 1}}, kNow, quote, 7));
+    CHECK(quote.reduction == Money::fromInteger(10));
+    CHECK(quote.voucherCampaignId == 7);
+    CHECK(PricingRules::toJson(quote)["voucher_campaign_id"].asUInt() == 7);
+    // 过期的券活动和普通活动的券不额外减免
+    REQUIRE(rules.quote(0, {{2, 1}}, kNow + 3600, quote, 7));
+    CHECK(quote.reduction == Money::fromInteger(3));
+    CHECK(quote.voucherCampaignId == 0);
+    REQUIRE(rules.quote(0, {{2, 1}}, kNow, quote, 8));
+    CHECK(quote.reduction == Money::fromInteger(3));
+    CHECK(quote.voucherCampaignId == 0);
+}
+
+DROGON_TEST(PricingUnavailable)
+{
+    auto rules = rulesOf();
+    PricingRules::Quote quote;
+    CHECK(!rules.quote(0, {{1, 1}, {4, 1}, {9, 1}}, kNow, quote));
+    CHECK(quote.unavailable == std::vector<uint32_t>({4, 9}));
+
+    // 调用方提供菜品时不看 setDish 的菜品
+    auto fromMenu = [](uint32_t dishId, PricingRules::Dish &dish)
+    {
+        if (dishId != 4)
+            return false;
+        dish = {Money::fromRaw(2600), "分店特价", true};
+        return true;
+    };
+    REQUIRE(rules.quote(0, {{4, 2}}, kNow, fromMenu, quote));
+    CHECK(quote.total == Money::fromRaw(5200));
+    CHECK(quote.lines[0].name == "分店特价");
+    CHECK(!rules.quote(0, {{1, 1}}, kNow, fromMenu, quote));
+
+    auto json = PricingRules::toJson(quote);
+    CHECK(json["unavailable"][0].asUInt() == 1);
+    CHECK(json["total"].asString() == "0.00");
+    CHECK(json["member_rate"].asString() == "1.0000");
+}
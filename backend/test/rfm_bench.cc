@@ -0,0 +1,128 @@
+// RFM 压测：按会员ID区间分片多线程累加后合并，校验与单线程结果一致，并统计累加、评分耗时和各分数人数
+#include "plugins/RfmTable.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+double msSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct Record
+{
+    uint32_t memberId;
+    int32_t day;
+    int64_t cents;
+};
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const uint32_t members = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 1000000;
+    const uint32_t records = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 5000000;
+    const uint32_t threads = argc > 3 ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 4;
+    const int32_t today = 20000;
+
+    // 消费记录按会员ID排序，相当于按 (member_id, record_id) 分页读出的顺序；少数会员消费很多
+    std::mt19937 rng(42);
+    std::vector<Record> all;
+    all.reserve(records);
+    for (uint32_t i = 0; i < records; ++i)
+    {
+        auto memberId = static_cast<uint32_t>(rng() % 10 == 0 ? 1 + rng() % (members / 100 + 1) : 1 + rng() % members);
+        all.push_back(Record{memberId, today - static_cast<int32_t>(rng() % 730), static_cast<int64_t>(1000 + rng() % 50000)});
+    }
+    std::sort(all.begin(), all.end(), [](const Record &a, const Record &b) { return a.memberId < b.memberId; });
+
+    auto start = std::chrono::steady_clock::now();
+    RfmTable serial;
+    for (const auto &record : all)
+        serial.add(record.memberId, record.day, record.cents);
+    auto serialMs = msSince(start);
+
+    // 按会员ID区间切片，每片累加到自己的表，最后合并
+    start = std::chrono::steady_clock::now();
+    const uint32_t partitions = threads * 4;
+    std::vector<std::unordered_map<uint32_t, RfmTable::Metrics>> parts(partitions);
+    std::vector<std::thread> workers;
+    for (uint32_t t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t]()
+                             {
+            for (uint32_t p = t; p < partitions; p += threads)
+            {
+                auto first = static_cast<uint32_t>(static_cast<uint64_t>(members) * p / partitions) + 1;
+                auto last = static_cast<uint32_t>(static_cast<uint64_t>(members) * (p + 1) / partitions);
+                auto it = std::lower_bound(all.begin(), all.end(), first,
+                                           [](const Record &r, uint32_t id) { return r.memberId < id; });
+                for (; it != all.end() && it->memberId <= last; ++it)
+                    parts[p][it->memberId].add(it->day, it->cents);
+            } });
+    }
+    for (auto &worker : workers)
+        worker.join();
+    RfmTable parallel;
+    for (auto &part : parts)
+        parallel.merge(std::move(part));
+    auto parallelMs = msSince(start);
+
+    start = std::chrono::steady_clock::now();
+    serial.rescore(today);
+    parallel.rescore(today);
+    auto rescoreMs = msSince(start) / 2;
+
+    uint64_t mismatches = 0;
+    uint64_t histogram[3][6] = {};
+    for (uint32_t id = 1; id <= members; ++id)
+    {
+        auto a = serial.find(id);
+        auto b = parallel.find(id);
+        if (!a != !b)
+        {
+            ++mismatches;
+            continue;
+        }
+        if (!a)
+            continue;
+        if (a->orders != b->orders || a->cents != b->cents || a->firstDay != b->firstDay || a->lastDay != b->lastDay)
+            ++mismatches;
+        auto scores = parallel.scoreOf(*b, today);
+        if (scores != serial.scoreOf(*a, today))
+            ++mismatches;
+        for (size_t i = 0; i < scores.size(); ++i)
+            ++histogram[i][scores[i]];
+    }
+
+    std::printf("%u records of %zu members: serial %.1f ms, %u threads x %u partitions %.1f ms, rescore %.1f ms\n",
+                records,
+                parallel.size(),
+                serialMs,
+                threads,
+                partitions,
+                parallelMs,
+                rescoreMs);
+    const char *names[] = {"R", "F", "M"};
+    for (size_t i = 0; i < 3; ++i)
+    {
+        std::printf("%s:", names[i]);
+        for (size_t score = 1; score <= 5; ++score)
+            std::printf(" %zu=%llu", score, static_cast<unsigned long long>(histogram[i][score]));
+        std::printf("\n");
+    }
+    if (mismatches != 0)
+    {
+        std::printf("INCONSISTENT: %llu mismatches\n", static_cast<unsigned long long>(mismatches));
+        return 1;
+    }
+    std::printf("consistent\n");
+    return 0;
+}
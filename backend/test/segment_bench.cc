@@ -0,0 +1,109 @@
+// 会员分群压测：随机生成会员和消费，校验位图查询与逐个扫描一致，并统计建索引和查询耗时
+#include "plugins/SegmentIndex.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+double msSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const uint32_t members = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 1000000;
+    const uint32_t consumptions = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 3000000;
+    const int32_t today = 20000;
+    const std::string statuses[] = {"活跃", "非活跃", "冻结"};
+
+    SegmentIndex index({10000, 30000, 100000, 300000}, {7, 30, 90}, 30);
+    index.advance(today);
+
+    struct Truth
+    {
+        uint32_t level;
+        size_t status;
+        int64_t spend{0}; // 近 30 天
+        int32_t lastDay{-1};
+    };
+    std::vector<Truth> truth(members + 1);
+    std::mt19937 rng(42);
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t id = 1; id <= members; ++id)
+    {
+        truth[id].level = 1 + rng() % 4;
+        truth[id].status = rng() % 10 < 8 ? 0 : 1 + rng() % 2;
+        index.setMember(id, truth[id].level, statuses[truth[id].status]);
+    }
+    for (uint32_t k = 0; k < consumptions; ++k)
+    {
+        // 会员活跃度偏斜：低ID会员消费更频繁
+        uint32_t id = 1 + static_cast<uint32_t>(std::pow(double(rng()) / rng.max(), 2.0) * (members - 1));
+        int32_t day = today - static_cast<int32_t>(rng() % 180);
+        int64_t cents = 1000 + rng() % 40000;
+        index.addConsumption(id, day, cents);
+        if (day > today - 30)
+            truth[id].spend += cents;
+        truth[id].lastDay = std::max(truth[id].lastDay, day);
+    }
+    std::printf("build: %u members, %u consumptions in %.1f ms, bitmaps %.1f MB\n",
+                members,
+                consumptions,
+                msSince(start),
+                index.memoryBytes() / 1048576.0);
+
+    // 金卡（等级 3）、活跃、近 30 天消费满 300 元、30 天内到店
+    SegmentIndex::Filter filter;
+    filter.levels = {3};
+    filter.statuses = {"活跃"};
+    filter.spendBuckets = {2, 3, 4};
+    filter.recencyBuckets = {0, 1};
+
+    const int rounds = 100;
+    start = std::chrono::steady_clock::now();
+    uint64_t count = 0;
+    for (int r = 0; r < rounds; ++r)
+        count = index.count(filter);
+    std::printf("count: %llu members, %.3f ms/query\n", static_cast<unsigned long long>(count), msSince(start) / rounds);
+
+    start = std::chrono::steady_clock::now();
+    auto page = index.select(filter).page(1000, 500);
+    std::printf("page: %zu ids from offset 1000 in %.3f ms\n", page.size(), msSince(start));
+
+    // 逐个扫描校验
+    start = std::chrono::steady_clock::now();
+    uint64_t expected = 0;
+    for (uint32_t id = 1; id <= members; ++id)
+    {
+        const auto &t = truth[id];
+        auto days = t.lastDay < 0 ? -1 : today - t.lastDay;
+        if (t.level == 3 && t.status == 0 && t.spend >= 30000 && days >= 0 && days <= 30)
+            ++expected;
+    }
+    std::printf("scan: %llu members in %.3f ms\n", static_cast<unsigned long long>(expected), msSince(start));
+
+    // 日期前进一周后整体换档
+    start = std::chrono::steady_clock::now();
+    index.advance(today + 7);
+    std::printf("advance 7 days: %.1f ms, count now %llu\n",
+                msSince(start),
+                static_cast<unsigned long long>(index.count(filter)));
+
+    if (count != expected)
+    {
+        std::printf("MISMATCH\n");
+        return 1;
+    }
+    std::printf("consistent\n");
+    return 0;
+}
@@ -0,0 +1,255 @@
+// 会员分群：Roaring 位图的集合运算，以及分群索引的换档和筛选
+#include <drogon/drogon_test.h>
+#include "plugins/SegmentIndex.h"
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <random>
+#include <set>
+
+namespace
+{
+using Ids = std::set<uint32_t>;
+
+Ids toSet(const RoaringBitmap &bitmap)
+{
+    Ids values;
+    bitmap.forEach([&values](uint32_t value) {
+        values.insert(value);
+        return true;
+    });
+    return values;
+}
+
+// 同时覆盖稀疏的数组块和稠密的位图块
+RoaringBitmap randomBitmap(std::mt19937 &rng, Ids &expected)
+{
+    RoaringBitmap bitmap;
+    for (int i = 0; i < 3000; ++i)
+    {
+        auto value = static_cast<uint32_t>(rng() % 200000);
+        bitmap.add(value);
+        expected.insert(value);
+    }
+    for (uint32_t value = 70000; value < 78000; value += 1 + rng() % 2)
+    {
+        bitmap.add(value);
+        expected.insert(value);
+    }
+    return bitmap;
+}
+} // namespace
+
+DROGON_TEST(RoaringBitmapMatchesStdSet)
+{
+    std::mt19937 rng(11);
+    Ids a;
+    Ids b;
+    auto left = randomBitmap(rng, a);
+    auto right = randomBitmap(rng, b);
+    CHECK(toSet(left) == a);
+    CHECK(left.cardinality() == a.size());
+    for (uint32_t value = 69990; value < 70010; ++value)
+        CHECK(left.contains(value) == (a.count(value) != 0));
+
+    Ids expected;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::inserter(expected, expected.end()));
+    CHECK(toSet(left & right) == expected);
+    CHECK(left.andCardinality(right) == expected.size());
+    expected.clear();
+    std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::inserter(expected, expected.end()));
+    CHECK(toSet(left | right) == expected);
+    expected.clear();
+    std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::inserter(expected, expected.end()));
+    CHECK(toSet(left - right) == expected);
+
+    // 删光一个块后不留空块
+    for (uint32_t value = 70000; value < 78000; ++value)
+    {
+        left.remove(value);
+        a.erase(value);
+    }
+    CHECK(toSet(left) == a);
+
+    auto page = left.page(10, 5);
+    REQUIRE(page.size() == 5);
+    CHECK(page.front() == *std::next(a.begin(), 10));
+    CHECK(left.page(a.size(), 5).empty());
+
+    RoaringBitmap empty;
+    CHECK(empty.empty());
+    CHECK((left & empty).empty());
+    CHECK(toSet(left | empty) == a);
+}
+
+DROGON_TEST(SegmentIndexBuckets)
+{
+    // 消费档：[0, 100)、[100, 1000)、[1000, ∞)；到店档：7 天内、30 天内、更早、从未消费
+    SegmentIndex index({100, 1000}, {7, 30}, 30);
+    index.advance(1000);
+    CHECK(index.spendBucketCount() == 3);
+    CHECK(index.recencyBucketCount() == 4);
+    CHECK(index.spendBucketOf(99) == 0);
+    CHECK(index.spendBucketOf(100) == 1);
+    CHECK(index.spendBucketOf(5000) == 2);
+    CHECK(index.recencyBucketOf(-1) == 3);
+    CHECK(index.recencyBucketOf(993) == 0);
+    CHECK(index.recencyBucketOf(992) == 1);
+
+    index.setMember(1, 1, "正常");
+    index.setMember(2, 2, "正常");
+    index.setMember(3, 2, "冻结");
+    index.addConsumption(1, 999, 1500);
+    index.addConsumption(2, 980, 200);
+    // 未登记会员的消费先积累，登记时再落档
+    index.addConsumption(4, 1000, 50);
+    CHECK(index.size() == 3);
+
+    SegmentIndex::Filter filter;
+    filter.spendBuckets = {2};
+    CHECK(toSet(index.select(filter)) == Ids{1});
+    filter.spendBuckets.clear();
+    filter.recencyBuckets = {3};
+    CHECK(toSet(index.select(filter)) == Ids{3});
+    filter.recencyBuckets.clear();
+    filter.levels = {2};
+    filter.statuses = {"正常"};
+    CHECK(toSet(index.select(filter)) == Ids{2});
+
+    index.setMember(4, 1, "正常");
+    filter = {};
+    filter.levels = {1};
+    filter.recencyBuckets = {0};
+    CHECK((toSet(index.select(filter)) == Ids{1, 4}));
+
+    // 滚出窗口后消费清零、到店换档
+    index.advance(1029);
+    filter = {};
+    filter.spendBuckets = {1, 2};
+    CHECK(index.select(filter).empty());
+    filter.spendBuckets = {0};
+    CHECK((toSet(index.select(filter)) == Ids{1, 2, 3, 4}));
+    filter = {};
+    filter.recencyBuckets = {2};
+    CHECK(toSet(index.select(filter)) == Ids{2});
+
+    index.removeMember(1);
+    CHECK(index.size() == 3);
+    filter = {};
+    filter.levels = {1};
+    CHECK(toSet(index.select(filter)) == Ids{4});
+}
+
+DROGON_TEST(SegmentIndexMatchesBruteForce)
+{
+    struct Member
+    {
+        uint32_t level{0};
+        std::string status;
+        std::map<int32_t, int64_t> daily;
+    };
+    const std::string statuses[] = {"正常", "冻结", "已过期"};
+    std::mt19937 rng(5);
+    SegmentIndex index({1000, 10000, 50000}, {7, 30, 90}, 30);
+    std::map<uint32_t, Member> members;
+    int32_t today = 20000;
+    index.advance(today);
+    for (int step = 0; step < 20000; ++step)
+    {
+        auto memberId = static_cast<uint32_t>(1 + rng() % 500);
+        switch (rng() % 8)
+        {
+        case 0:
+        {
+            auto &member = members[memberId];
+            member.level = 1 + rng() % 4;
+            member.status = statuses[rng() % 3];
+            index.setMember(memberId, member.level, member.status);
+            break;
+        }
+        case 1:
+            if (rng() % 4 == 0)
+            {
+                members.erase(memberId);
+                index.removeMember(memberId);
+            }
+            break;
+        case 2:
+            if (rng() % 50 == 0)
+                index.advance(++today);
+            break;
+        default:
+        {
+            // 只给登记过的会员记消费，removeMember 后不再有残留
+            auto it = members.find(memberId);
+            if (it == members.end())
+                break;
+            auto day = today - static_cast<int32_t>(rng() % 120);
+            auto cents = static_cast<int64_t>(rng() % 20000);
+            it->second.daily[day] += cents;
+            index.addConsumption(memberId, day, cents);
+        }
+        }
+    }
+
+    for (size_t round = 0; round < 40; ++round)
+    {
+        SegmentIndex::Filter filter;
+        if (rng() % 2)
+            filter.levels = {1 + static_cast<uint32_t>(rng() % 4)};
+        if (rng() % 2)
+            filter.statuses = {statuses[rng() % 3]};
+        if (rng() % 2)
+            filter.spendBuckets = {rng() % 4, rng() % 4};
+        if (rng() % 2)
+            filter.recencyBuckets = {rng() % 5};
+        Ids expected;
+        for (const auto &[memberId, member] : members)
+        {
+            int64_t spend = 0;
+            int32_t lastDay = -1;
+            for (const auto &[day, cents] : member.daily)
+            {
+                if (day > today - 30)
+                    spend += cents;
+                lastDay = std::max(lastDay, day);
+            }
+            auto has = [](const auto &keys, const auto &key) {
+                return keys.empty() || std::find(keys.begin(), keys.end(), key) != keys.end();
+            };
+            if (has(filter.levels, member.level) && has(filter.statuses, member.status) &&
+                has(filter.spendBuckets, index.spendBucketOf(spend)) &&
+                has(filter.recencyBuckets, index.recencyBucketOf(lastDay)))
+                expected.insert(memberId);
+        }
+        CHECK(toSet(index.select(filter)) == expected);
+        CHECK(index.count(filter) == expected.size());
+    }
+}
+
+DROGON_TEST(RoaringBitmapConversionHysteresis)
+{
+    // 一个块 5000 个元素为位图块，删到 2048 个以下才转回数组
+    RoaringBitmap bitmap;
+    for (uint32_t value = 0; value < 5000; ++value)
+        bitmap.add(value * 2);
+    auto bitmapBytes = bitmap.memoryBytes();
+    CHECK(bitmapBytes >= 8192);
+    for (uint32_t value = 4999; value >= 2048; --value)
+        bitmap.remove(value * 2);
+    CHECK(bitmap.cardinality() == 2048);
+    CHECK(bitmap.memoryBytes() == bitmapBytes);
+    // 在阈值附近反复增删不来回转换
+    for (int round = 0; round < 10; ++round)
+    {
+        bitmap.add(1);
+        bitmap.remove(1);
+    }
+    CHECK(bitmap.memoryBytes() == bitmapBytes);
+    bitmap.remove(0);
+    CHECK(bitmap.memoryBytes() < bitmapBytes);
+    CHECK(bitmap.cardinality() == 2047);
+    for (uint32_t value = 1; value < 2048; ++value)
+        CHECK(bitmap.contains(value * 2));
+}
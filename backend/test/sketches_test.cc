@@ -0,0 +1,125 @@
+// 报表草图：HyperLogLog 的误差与合并，Space-Saving 的误差界与序列化
+#include <drogon/drogon_test.h>
+#include "plugins/Sketches.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+
+DROGON_TEST(HyperLogLogError)
+{
+    HyperLogLog empty;
+    CHECK(empty.empty());
+    CHECK(empty.estimate() == 0);
+
+    // 各个规模下误差不超过 4 倍标准误差
+    const auto bound = 4 * HyperLogLog::standardError();
+    for (uint64_t n : {100ULL, 1000ULL, 20000ULL, 300000ULL})
+    {
+        HyperLogLog sketch;
+        for (uint64_t key = 1; key <= n; ++key)
+        {
+            sketch.add(key);
+            sketch.add(key); // 重复不计
+        }
+        auto error = std::fabs(sketch.estimate() - static_cast<double>(n)) / static_cast<double>(n);
+        CHECK(error < bound);
+    }
+}
+
+DROGON_TEST(HyperLogLogMergeAndSerialize)
+{
+    // 两段有重叠的键，合并后等价于对并集计数
+    HyperLogLog a;
+    HyperLogLog b;
+    HyperLogLog all;
+    for (uint64_t key = 0; key < 60000; ++key)
+    {
+        if (key < 40000)
+            a.add(key * 2654435761ULL);
+        if (key >= 20000)
+            b.add(key * 2654435761ULL);
+        all.add(key * 2654435761ULL);
+    }
+    a.merge(b);
+    CHECK(a.estimate() == all.estimate());
+
+    HyperLogLog restored;
+    REQUIRE(restored.deserialize(a.serialize()));
+    CHECK(restored.estimate() == a.estimate());
+
+    // 稀疏格式
+    HyperLogLog sparse;
+    for (uint64_t key = 0; key < 50; ++key)
+        sparse.add(key);
+    auto bytes = sparse.serialize();
+    CHECK(bytes.size() < HyperLogLog::kRegisters);
+    REQUIRE(restored.deserialize(bytes));
+    CHECK(restored.estimate() == sparse.estimate());
+
+    CHECK(!restored.deserialize("garbage"));
+    CHECK(restored.empty());
+}
+
+DROGON_TEST(SpaceSavingBounds)
+{
+    // Zipf 分布的菜品销量
+    std::mt19937 rng(11);
+    std::vector<double> weights;
+    for (int rank = 1; rank <= 2000; ++rank)
+        weights.push_back(1.0 / rank);
+    std::discrete_distribution<uint32_t> pick(weights.begin(), weights.end());
+
+    SpaceSaving first(64);
+    SpaceSaving second(64);
+    std::map<uint32_t, uint64_t> truth;
+    for (int i = 0; i < 200000; ++i)
+    {
+        auto key = pick(rng) + 1;
+        uint64_t weight = 1 + rng() % 3;
+        truth[key] += weight;
+        (i % 2 ? first : second).add(key, weight);
+    }
+    first.merge(second);
+
+    uint64_t total = 0;
+    for (const auto &[key, count] : truth)
+        total += count;
+    REQUIRE(first.total() == total);
+    CHECK(first.maxError() <= total / first.capacity());
+
+    auto top = first.top(first.capacity());
+    std::map<uint32_t, SpaceSaving::Counter> kept;
+    for (const auto &counter : top)
+        kept[counter.key] = counter;
+    for (size_t i = 1; i < top.size(); ++i)
+        CHECK(top[i - 1].count >= top[i].count);
+    // 计数不低估，高估量不超过 error
+    for (const auto &[key, counter] : kept)
+    {
+        CHECK(counter.count >= truth[key]);
+        CHECK(counter.count - truth[key] <= counter.error);
+        CHECK(counter.error <= first.maxError());
+    }
+    // 真实计数超过 total / capacity 的项一定在草图中
+    for (const auto &[key, count] : truth)
+    {
+        if (count > total / first.capacity())
+            CHECK(kept.count(key) == 1);
+    }
+    CHECK(top.front().key == 1);
+
+    SpaceSaving restored;
+    REQUIRE(restored.deserialize(first.serialize()));
+    CHECK(restored.total() == first.total());
+    CHECK(restored.capacity() == first.capacity());
+    auto again = restored.top(5);
+    REQUIRE(again.size() == 5);
+    for (size_t i = 0; i < again.size(); ++i)
+    {
+        CHECK(again[i].key == top[i].key);
+        CHECK(again[i].count == top[i].count);
+    }
+    CHECK(!restored.deserialize("not;a;sketch"));
+}
@@ -0,0 +1,70 @@
+// 会员汇总缓存压测：热点会员反复查询、穿插新增消费，统计命中率和每次操作耗时，并校验命中的汇总与全量累加一致
+#include "plugins/SummaryCache.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+int main(int argc, char **argv)
+{
+    const uint32_t members = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 1000000;
+    const uint32_t operations = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 5000000;
+    const size_t capacity = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 100000;
+
+    // 全量累加的真实汇总，相当于数据库聚合
+    std::vector<SummaryCache::Summary> truth(members + 1);
+    SummaryCache cache(capacity);
+    std::mt19937 rng(42);
+    uint64_t hits = 0;
+    uint64_t reads = 0;
+    uint64_t mismatches = 0;
+    int64_t now = 1700000000;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < operations; ++i)
+    {
+        // 九成操作落在 1% 的常客上
+        auto memberId = static_cast<uint32_t>(rng() % 10 != 0 ? 1 + rng() % (members / 100 + 1) : 1 + rng() % members);
+        if (rng() % 4 == 0)
+        {
+            // 新增消费：已缓存的直接累加
+            ++now;
+            auto cents = static_cast<int64_t>(1000 + rng() % 50000);
+            auto points = static_cast<int64_t>(rng() % 100);
+            truth[memberId].add(now, cents, points);
+            cache.add(memberId, now, cents, points);
+            continue;
+        }
+        ++reads;
+        SummaryCache::Summary summary;
+        if (cache.get(memberId, summary))
+        {
+            ++hits;
+            const auto &expected = truth[memberId];
+            if (summary.orders != expected.orders || summary.cents != expected.cents ||
+                summary.points != expected.points || summary.firstAt != expected.firstAt ||
+                summary.lastAt != expected.lastAt)
+                ++mismatches;
+            continue;
+        }
+        cache.put(memberId, truth[memberId]);
+    }
+    auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%u operations over %u members, capacity %zu: %.1f ns/op, hit rate %.1f%%, cached %zu\n",
+                operations,
+                members,
+                capacity,
+                ns / operations,
+                reads == 0 ? 0.0 : 100.0 * static_cast<double>(hits) / static_cast<double>(reads),
+                cache.size());
+    if (mismatches != 0 || cache.size() > capacity)
+    {
+        std::printf("INCONSISTENT: %llu mismatches\n", static_cast<unsigned long long>(mismatches));
+        return 1;
+    }
+    std::printf("consistent\n");
+    return 0;
+}
@@ -60,3 +60,7 @@ export const getRecommendedDishes = () => {
   return http.get<Dish[]>('/api/dish/hot');
 }
 
+//菜品全文检索：菜名、描述片段或拼音首字母，按匹配程度、排序权重和销量排序
+export const searchDishes = (q: string, limit = 100) => {
+  return http.get<(Dish & { score: number })[]>('/api/dish/search', { tenant_id: localStorage.getItem("tenant_id"), q, limit });
+}
@@ -82,4 +82,15 @@ export const deleteLevel = (levelId:number) => {
 //获取会员消费记录
 export const getConsumptionRecords=(memberId:number)=>{
   return http.get<ConsumptionRecordType[]>('/api/consumptionrecord/member/'+memberId);
-}
\ No newline at end of file
+}
+
+export interface MemberMatchType {
+  member_id: number;
+  phone: string;
+  username: string;
+}
+
+//按手机号/用户名片段查找会员，开头匹配的在前
+export const searchMembers = (q: string, limit = 20) => {
+  return http.get<MemberMatchType[]>('/api/member/search', { tenant_id: localStorage.getItem("tenant_id"), q, limit });
+}
@@ -14,6 +14,7 @@ export interface OrderType {
       total_amount: string;
       updated_at?: string;
       user_id: number;
+      branch_id?: number|null;
 }
 
 //获取订单列表
@@ -34,4 +35,34 @@ export const updateOrder=(orderId:number | null,data:OrderType)=>{
 //删除订单
 export const deleteOrder = (orderId:number) => {
   return http.put('/api/member/'+orderId, {order_id:orderId, is_deleted: 1 });
-}
\ No newline at end of file
+}
+
+export interface QuoteLineType {
+  dish_id: number;
+  dish_name: string;
+  quantity: number;
+  price: string;
+  subtotal: string;
+  discount: string; // 单品活动和会员折扣
+  total: string;
+  campaign_id?: number;
+}
+
+export interface QuoteType {
+  lines: QuoteLineType[];
+  applied: { campaign_id: number; name: string; amount: string }[]; // campaign_id 为 0 是会员折扣
+  unavailable: number[];
+  subtotal: string;
+  campaign_discount: string;
+  member_discount: string;
+  reduction: string;
+  discount: string;
+  total: string;
+  level_id: number;
+  member_rate: string;
+}
+
+//订单试算，金额以服务端为准；会员不是本租户的有效会员时请求失败
+export const quoteOrder = (items: { dish_id: number; quantity: number }[], memberId?: number) => {
+  return http.post<QuoteType>('/api/order/quote', { items, member_id: memberId });
+}
@@ -55,3 +55,57 @@ export const  createInventoryRecord= (data:InventoryRecordType) => {
   return http.post('/api/inventoryrecord',data);
 }
 
+
+export interface InventoryForecastItemType {
+  tenant_id: number;
+  item_id: number;
+  item_name: string;
+  supplier: string;
+  quantity: number;
+  min_stock: number;
+  max_stock: number;
+  daily_usage: number;
+  days_until_stockout: number | null;
+  reorder_quantity: number;
+}
+
+export interface InventoryForecastType {
+  supplier: string;
+  reorder_quantity: number;
+  items: InventoryForecastItemType[];
+}
+
+//获取库存消耗预测与补货建议，按供应商分组
+export const getInventoryForecast = () => {
+  const tenant_id = localStorage.getItem("tenant_id");
+  return http.get<InventoryForecastType[]>('/api/inventory/forecast', { tenant_id: tenant_id ? +tenant_id : 0 });
+}
+
+export interface DishIngredientType {
+  ingredient_id?: number;
+  tenant_id: number;
+  dish_id: number;
+  item_id: number;
+  quantity: number;
+  is_deleted?: number;
+}
+
+//获取菜品配方
+export const getDishIngredients = (dishId:number) => {
+  return http.get<DishIngredientType[]>('/api/dishingredient/dish/'+dishId);
+}
+
+//添加配方物料
+export const createDishIngredient = (data:DishIngredientType) => {
+  return http.post('/api/dishingredient',{...data,is_deleted:0});
+}
+
+//更新配方物料用量
+export const updateDishIngredient = (ingredientId:number,data:DishIngredientType) => {
+  return http.put('/api/dishingredient/'+ingredientId,{...data,ingredient_id:ingredientId});
+}
+
+//删除配方物料
+export const deleteDishIngredient = (ingredientId:number) => {
+  return http.delete('/api/dishingredient/'+ingredientId);
+}
@@ -0,0 +1,92 @@
+import http from '@/utils/request'
+
+export interface ReportQuery {
+  from?: string; // YYYY-MM-DD，含
+  to?: string;   // YYYY-MM-DD，含
+  branch_id?: number;
+}
+
+export interface ReportSummaryType {
+  revenue: number;
+  orders: number;
+  customers: number;
+  avg_order_value: number;
+  new_members: number;
+}
+
+export interface ReportTrendType {
+  bucket: string;
+  revenue: number;
+  orders: number;
+  customers: number;
+  avg_order_value: number;
+}
+
+export interface ReportCategoryType {
+  category_id: number;
+  category_name: string;
+  quantity: number;
+  revenue: number;
+  share: number;
+}
+
+export interface ReportMembershipType {
+  level_id: number;
+  level_name: string;
+  count: number;
+}
+
+export interface ReportCustomersType {
+  days: { date: string; customers: number }[];
+  customers: number;
+  standard_error: number; // 相对标准误差
+}
+
+export interface ReportTopDishType {
+  dish_id: number;
+  dish_name: string;
+  count: number;       // 估计份数，不小于真实值
+  error: number;       // 最大高估量
+  lower_bound: number;
+}
+
+export interface ReportTopDishesType {
+  total: number;
+  max_error: number;
+  items: ReportTopDishType[];
+}
+
+const tenantParam = () => {
+  const tenant_id = localStorage.getItem("tenant_id");
+  return { tenant_id: tenant_id ? +tenant_id : 0 };
+}
+
+//获取汇总指标
+export const getReportSummary = (query: ReportQuery) => {
+  return http.get<ReportSummaryType>('/api/report/summary', { ...tenantParam(), ...query });
+}
+
+//获取营收趋势，按天或小时
+export const getReportTrend = (query: ReportQuery, granularity: "day" | "hour" = "day") => {
+  return http.get<ReportTrendType[]>('/api/report/trend', { ...tenantParam(), ...query, granularity });
+}
+
+//获取品类销售构成
+export const getReportCategory = (query: ReportQuery) => {
+  return http.get<ReportCategoryType[]>('/api/report/category', { ...tenantParam(), ...query });
+}
+
+//获取会员等级分布
+export const getReportMembership = () => {
+  return http.get<ReportMembershipType[]>('/api/report/membership', tenantParam());
+}
+
+//获取去重顾客数（近似）
+export const getReportCustomers = (query: ReportQuery) => {
+  return http.get<ReportCustomersType>('/api/report/customers', { ...tenantParam(), ...query });
+}
+
+//获取热销菜品（近似）
+export const getReportTopDishes = (query: ReportQuery, limit = 5) => {
+  return http.get<ReportTopDishesType>('/api/report/topdishes', { ...tenantParam(), ...query, limit });
+}
@@ -37,3 +37,36 @@ export const getToken = (tenantId:number) => {
 }
 
 
+
+export interface WarningType {
+  id: number,
+  timestamp: string,
+  level: "HIGH" | "MEDIUM" | "LOW",
+  title: string,
+  description: string,
+  status: "ACTIVE" | "RESOLVED",
+  tenant_id: number,
+  item_id: number,
+  item_name: string,
+  quantity: number,
+  min_stock: number,
+  max_stock: number,
+  resolved_at: string | null
+}
+
+//获取库存预警，tenantId 为 0 时返回全部租户
+export const getWarnings = (status: "ALL" | "ACTIVE" | "RESOLVED", tenantId: number = 0) => {
+  return http.get<WarningType[]>('/api/warnings', { status, tenant_id: tenantId });
+}
+
+//换取 WebSocket 连接票据，短期有效且只能用一次
+export const getSocketTicket = (path: string) => {
+  return http.post<{ ticket: string, expires_in: number }>('/api/ws/ticket', { path }, true);
+}
+
+//库存预警推送地址
+export const getWarningSocketUrl = async (tenantId: number = 0) => {
+  const { ticket } = await getSocketTicket('/ws/warnings');
+  const base = import.meta.env.VITE_API_BASE_URL || window.location.origin;
+  return base.replace(/^http/, 'ws') + '/ws/warnings?tenant_id=' + tenantId + '&ticket=' + encodeURIComponent(ticket);
+}
@@ -377,6 +377,7 @@ function Branch() {
                   onChange={(e) =>
                     setFormData({ ...formData, opening_hours: e.target.value })
                   }
+                  placeholder="每天 10:00-22:00；周一 休息；2025-10-01 休息"
                   className="w-full px-3 py-2 border border-gray-300 rounded-md focus:outline-none focus:ring-2 focus:ring-indigo-500"
                 />
               </div>
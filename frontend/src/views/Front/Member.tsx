@@ -13,6 +13,7 @@ import {
   updateMember,
   deleteMember,
   getConsumptionRecords,
+  searchMembers,
   type MemberType,
   type MemberLevelType,
   type ConsumptionRecordType,
@@ -62,11 +63,35 @@ function Member() {
   const [showDeleteModal, setShowDeleteModal] = useState(false);
   const [memberToDelete, setMemberToDelete] = useState<MemberType | null>(null);
 
+  // 服务端检索命中的会员ID，为 null 时按本地列表匹配
+  const [matchedIds, setMatchedIds] = useState<Set<number> | null>(null);
+
+  useEffect(() => {
+    const term = searchTerm.trim();
+    if (!term || /^M00\d+$/.test(term)) {
+      setMatchedIds(null);
+      return;
+    }
+    let cancelled = false;
+    const timer = setTimeout(() => {
+      searchMembers(term)
+        .then((matches) => {
+          if (!cancelled) setMatchedIds(new Set(matches.map((m) => m.member_id)));
+        })
+        .catch((error) => console.error("搜索会员失败:", error));
+    }, 200);
+    return () => {
+      cancelled = true;
+      clearTimeout(timer);
+    };
+  }, [searchTerm]);
+
   const filteredMembers = members.filter((member) => {
-    const matchSearch =
-      member.username?.includes(searchTerm) ||
-      member.phone?.includes(searchTerm) ||
-      "M00" + member.member_id === searchTerm;
+    const matchSearch = matchedIds
+      ? matchedIds.has(member.member_id)
+      : member.username?.includes(searchTerm) ||
+        member.phone?.includes(searchTerm) ||
+        "M00" + member.member_id === searchTerm;
     const matchLevel = levelFilter === "全部" || member.level === levelFilter;
     const matchStatus =
       statusFilter === "全部" || member.status === statusFilter;
@@ -1,8 +1,14 @@
 import { useEffect, useState } from "react";
-import { createOrder, type OrderType } from "@/apis/front/order";
+import {
+  createOrder,
+  quoteOrder,
+  type OrderType,
+  type QuoteType,
+} from "@/apis/front/order";
 import {
   getDishes,
   getRecommendedDishes,
+  searchDishes,
   //@ts-ignore
   getDishCategories,
   //@ts-ignore
@@ -106,16 +112,50 @@ function PlaceOrder() {
   });
   const [membershipId, setMembershipId] = useState("");
   const [showOrderStatus, setShowOrderStatus] = useState(false);
-  const [currentDiscount, setCurrentDiscount] = useState(1);
-
-  const filteredItems = dishes.filter((item) => {
-    const matchSearch = item.dish_name
-      .toLowerCase()
-      .includes(searchTerm.toLowerCase());
-    const matchCategory =
-      selectedCategory === "全部" || item.category === selectedCategory;
-    return matchSearch && matchCategory;
-  });
+  // 服务端确认过的会员ID，未验证时不按会员价计价
+  const [memberId, setMemberId] = useState<number | undefined>();
+  const [quote, setQuote] = useState<QuoteType | null>(null);
+
+  // 服务端检索结果的名次（菜品ID -> 名次），为 null 时按本地菜名匹配
+  const [searchRanks, setSearchRanks] = useState<Map<number, number> | null>(
+    null
+  );
+
+  useEffect(() => {
+    const term = searchTerm.trim();
+    if (!term) {
+      setSearchRanks(null);
+      return;
+    }
+    let cancelled = false;
+    const timer = setTimeout(() => {
+      searchDishes(term)
+        .then((hits) => {
+          if (!cancelled)
+            setSearchRanks(new Map(hits.map((hit, i) => [hit.dish_id, i])));
+        })
+        .catch((error) => console.error("搜索菜品失败:", error));
+    }, 200);
+    return () => {
+      cancelled = true;
+      clearTimeout(timer);
+    };
+  }, [searchTerm]);
+
+  const filteredItems = dishes
+    .filter((item) => {
+      const matchSearch = searchRanks
+        ? searchRanks.has(item.dish_id)
+        : item.dish_name.toLowerCase().includes(searchTerm.toLowerCase());
+      const matchCategory =
+        selectedCategory === "全部" || item.category === selectedCategory;
+      return matchSearch && matchCategory;
+    })
+    .sort((a, b) =>
+      searchRanks
+        ? (searchRanks.get(a.dish_id) ?? 0) - (searchRanks.get(b.dish_id) ?? 0)
+        : 0
+    );
 
   const addToCart = (item: CartItem) => {
     setCart((currentCart) => {
@@ -153,11 +193,45 @@ function PlaceOrder() {
     0
   );
 
-  const finalAmount = totalAmount * currentDiscount;
+  const cartItems = () =>
+    cart.map((item) => ({ dish_id: item.dish_id, quantity: item.quantity }));
+
+  // 购物车或会员变化时向服务端试算，下单时服务端按同样规则重新计价
+  useEffect(() => {
+    if (cart.length === 0) {
+      setQuote(null);
+      return;
+    }
+    let cancelled = false;
+    quoteOrder(cartItems(), memberId)
+      .then((result) => {
+        if (!cancelled) setQuote(result);
+      })
+      .catch(() => {
+        if (!cancelled) setQuote(null);
+      });
+    return () => {
+      cancelled = true;
+    };
+  }, [cart, memberId]);
 
-  const applyMembership = () => {
-    if (membershipId.length === 8) {
-      setCurrentDiscount(0.9);
+  // 会员卡号即会员ID，服务端确认是本租户的有效会员后才带上试算和下单
+  const applyMembership = async () => {
+    setMemberId(undefined);
+    const id = membershipId.trim();
+    if (!/^\d{1,9}$/.test(id)) {
+      alert("会员卡号无效");
+      return;
+    }
+    if (cart.length === 0) {
+      alert("请先选择菜品");
+      return;
+    }
+    try {
+      setQuote(await quoteOrder(cartItems(), +id));
+      setMemberId(+id);
+    } catch (error) {
+      alert(error instanceof Error ? error.message : "会员验证失败");
     }
   };
 
@@ -186,18 +260,15 @@ function PlaceOrder() {
         quantity: item.quantity,
         subtotal: (+item.dish_price * item.quantity).toString(),
       })),
-      member_id: membershipId,
-      discount_rate: currentDiscount,
-      subtotal: totalAmount.toString(),
-      discount_amount: (totalAmount - finalAmount).toString(),
+      member_id: memberId ?? null,
     };
 
     const orderData: OrderType = {
       order_status: orderDetails.status,
       payment_method: orderDetails.paymentMethod,
       payment_status: "待支付",
-      total_amount: finalAmount.toString(),
-      discount_ammout: (totalAmount - finalAmount).toString(),
+      total_amount: quote ? quote.total : totalAmount.toString(),
+      discount_ammout: quote ? quote.discount : "0",
       delivery_address: null,
       tenant_id: 1,
       user_id: 1,
@@ -505,7 +576,10 @@ function PlaceOrder() {
                   <input
                     type="text"
                     value={membershipId}
-                    onChange={(e) => setMembershipId(e.target.value)}
+                    onChange={(e) => {
+                      setMembershipId(e.target.value);
+                      setMemberId(undefined);
+                    }}
                     className="flex-1 rounded-l-md border-gray-300 focus:border-indigo-500 focus:ring-indigo-500"
                   />
                   <button
@@ -515,7 +589,7 @@ function PlaceOrder() {
                     验证
                   </button>
                 </div>
-                {currentDiscount < 1 && (
+                {memberId !== undefined && (
                   <p className="mt-2 text-sm text-green-600">
                     已应用会员折扣！
                   </p>
@@ -571,18 +645,19 @@ function PlaceOrder() {
                     <span>小计</span>
                     <span>¥{totalAmount}</span>
                   </div>
-                  {currentDiscount < 1 && (
-                    <div className="flex justify-between text-sm text-green-600">
-                      <span>会员折扣</span>
-                      <span>
-                        -¥{(totalAmount * (1 - currentDiscount)).toFixed(2)}
-                      </span>
+                  {quote?.applied.map((item) => (
+                    <div
+                      key={item.campaign_id}
+                      className="flex justify-between text-sm text-green-600"
+                    >
+                      <span>{item.name}</span>
+                      <span>-¥{item.amount}</span>
                     </div>
-                  )}
+                  ))}
                   <div className="flex justify-between text-lg font-bold border-t pt-2">
                     <span>实付金额</span>
                     <span className="text-indigo-600">
-                      ¥{finalAmount.toFixed(2)}
+                      ¥{quote ? quote.total : totalAmount.toFixed(2)}
                     </span>
                   </div>
                 </div>
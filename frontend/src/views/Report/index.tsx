@@ -14,6 +14,16 @@ import {
   Cell,
 } from "recharts";
 
+import {
+  getReportCategory,
+  getReportMembership,
+  getReportSummary,
+  getReportTopDishes,
+  getReportTrend,
+  type ReportQuery,
+  type ReportSummaryType,
+} from "@/apis/report";
+
 interface SalesData {
   name: string;
   revenue: number;
@@ -27,36 +37,53 @@ interface CategorySales {
   color: string;
 }
 
+interface PopularDish {
+  name: string;
+  sales: number;
+}
+
 interface MembershipData {
   name: string;
   value: number;
   color: string;
 }
 
-const dailyData: SalesData[] = [
-  { name: "周一", revenue: 3500, orders: 120, customers: 95 },
-  { name: "周二", revenue: 4200, orders: 145, customers: 112 },
-  { name: "周三", revenue: 3800, orders: 132, customers: 98 },
-  { name: "周四", revenue: 4800, orders: 168, customers: 124 },
-  { name: "周五", revenue: 5500, orders: 189, customers: 145 },
-  { name: "周六", revenue: 6800, orders: 232, customers: 178 },
-  { name: "周日", revenue: 6200, orders: 210, customers: 165 },
-];
+const COLORS = ["#FF6B6B", "#4ECDC4", "#45B7D1", "#96CEB4", "#FFEEAD", "#6C757D", "#FFD700", "#00A6FB"];
 
-const categorySales: CategorySales[] = [
-  { name: "热菜", value: 45, color: "#FF6B6B" },
-  { name: "凉菜", value: 15, color: "#4ECDC4" },
-  { name: "主食", value: 20, color: "#45B7D1" },
-  { name: "饮品", value: 12, color: "#96CEB4" },
-  { name: "其他", value: 8, color: "#FFEEAD" },
-];
+const RANGE_DAYS: Record<string, number> = {
+  today: 1,
+  week: 7,
+  month: 30,
+  quarter: 90,
+  year: 365,
+};
 
-const membershipData: MembershipData[] = [
-  { name: "普通会员", value: 350, color: "#6C757D" },
-  { name: "白银会员", value: 180, color: "#ADB5BD" },
-  { name: "黄金会员", value: 120, color: "#FFD700" },
-  { name: "钻石会员", value: 50, color: "#00A6FB" },
-];
+const formatDate = (date: Date) =>
+  `${date.getFullYear()}-${String(date.getMonth() + 1).padStart(2, "0")}-${String(date.getDate()).padStart(2, "0")}`;
+
+// 本期与上一期的日期范围
+function rangeOf(timeRange: string): { current: ReportQuery; previous: ReportQuery } {
+  const days = RANGE_DAYS[timeRange] || 7;
+  const to = new Date();
+  const from = new Date(to);
+  from.setDate(to.getDate() - days + 1);
+  const prevTo = new Date(from);
+  prevTo.setDate(from.getDate() - 1);
+  const prevFrom = new Date(prevTo);
+  prevFrom.setDate(prevTo.getDate() - days + 1);
+  return {
+    current: { from: formatDate(from), to: formatDate(to) },
+    previous: { from: formatDate(prevFrom), to: formatDate(prevTo) },
+  };
+}
+
+const changeOf = (current: number, previous: number) => {
+  if (!previous) {
+    return { change: current ? "100%" : "0%", isPositive: current >= 0 };
+  }
+  const rate = ((current - previous) / previous) * 100;
+  return { change: `${Math.abs(rate).toFixed(1)}%`, isPositive: rate >= 0 };
+};
 
 // 添加一个自定义 Hook 用于计算容器宽度
 function useContainerWidth() {
@@ -85,6 +112,62 @@ function Report() {
     useContainerWidth();
   const { containerRef: barChartRef, width: barChartWidth } =
     useContainerWidth();
+  const [dailyData, setDailyData] = useState<SalesData[]>([]);
+  const [categorySales, setCategorySales] = useState<CategorySales[]>([]);
+  const [membershipData, setMembershipData] = useState<MembershipData[]>([]);
+  const [popularDishes, setPopularDishes] = useState<PopularDish[]>([]);
+  const [summary, setSummary] = useState<ReportSummaryType | null>(null);
+  const [previousSummary, setPreviousSummary] =
+    useState<ReportSummaryType | null>(null);
+
+  useEffect(() => {
+    const { current, previous } = rangeOf(timeRange);
+    const hourly = timeRange === "today";
+    getReportTrend(current, hourly ? "hour" : "day").then((res) => {
+      setDailyData(
+        (res || []).map((item) => ({
+          name: hourly ? item.bucket.slice(11, 16) : item.bucket.slice(5, 10),
+          revenue: item.revenue,
+          orders: item.orders,
+          customers: item.customers,
+        }))
+      );
+    });
+    getReportCategory(current).then((res) => {
+      setCategorySales(
+        (res || []).map((item, index) => ({
+          name: item.category_name,
+          value: item.share,
+          color: COLORS[index % COLORS.length],
+        }))
+      );
+    });
+    getReportTopDishes(current).then((res) => {
+      setPopularDishes(
+        (res?.items || []).map((item) => ({
+          name: item.dish_name,
+          sales: item.count,
+        }))
+      );
+    });
+    getReportSummary(current).then((res) => setSummary(res));
+    getReportSummary(previous).then((res) => setPreviousSummary(res));
+  }, [timeRange]);
+
+  useEffect(() => {
+    getReportMembership().then((res) => {
+      setMembershipData(
+        (res || []).map((item, index) => ({
+          name: item.level_name,
+          value: item.count,
+          color: COLORS[index % COLORS.length],
+        }))
+      );
+    });
+  }, []);
+
+  const kpi = (key: keyof ReportSummaryType) =>
+    changeOf(summary?.[key] || 0, previousSummary?.[key] || 0);
 
   const KPICard = ({
     title,
@@ -151,18 +234,24 @@ function Report() {
       <div className="grid grid-cols-1 md:grid-cols-2 lg:grid-cols-4 gap-6 mb-8">
         <KPICard
           title="总营收"
-          value="¥34,800"
-          change="12.5%"
-          isPositive={true}
+          value={`¥${(summary?.revenue || 0).toLocaleString()}`}
+          {...kpi("revenue")}
+        />
+        <KPICard
+          title="订单数"
+          value={(summary?.orders || 0).toLocaleString()}
+          {...kpi("orders")}
         />
-        <KPICard title="订单数" value="1,196" change="8.2%" isPositive={true} />
         <KPICard
           title="客单价"
-          value="¥29.1"
-          change="3.1%"
-          isPositive={false}
+          value={`¥${(summary?.avg_order_value || 0).toFixed(1)}`}
+          {...kpi("avg_order_value")}
+        />
+        <KPICard
+          title="新增会员"
+          value={(summary?.new_members || 0).toLocaleString()}
+          {...kpi("new_members")}
         />
-        <KPICard title="新增会员" value="48" change="15.4%" isPositive={true} />
       </div>
 
       {/* Charts */}
@@ -186,15 +275,15 @@ function Report() {
               <Legend />
               <Line
                 type="monotone"
-                dataKey="revenue"
+                dataKey={dataType}
                 stroke="#8884d8"
-                name="营收(元)"
-              />
-              <Line
-                type="monotone"
-                dataKey="orders"
-                stroke="#82ca9d"
-                name="订单数"
+                name={
+                  dataType === "revenue"
+                    ? "营收(元)"
+                    : dataType === "orders"
+                    ? "订单数"
+                    : "客流"
+                }
               />
             </LineChart>
           </div>
@@ -254,13 +343,7 @@ function Report() {
             <BarChart
               width={barChartWidth || 400}
               height={300}
-              data={[
-                { name: "红烧狮子头", sales: 289 },
-                { name: "糖醋里脊", sales: 256 },
-                { name: "宫保鸡丁", sales: 245 },
-                { name: "水煮鱼", sales: 236 },
-                { name: "麻婆豆腐", sales: 228 },
-              ]}
+              data={popularDishes}
             >
               <CartesianGrid strokeDasharray="3 3" />
               <XAxis dataKey="name" />
@@ -313,7 +396,7 @@ function Report() {
                       {day.customers}
                     </td>
                     <td className="px-6 py-4 whitespace-nowrap text-sm text-gray-900">
-                      ¥{(day.revenue / day.orders).toFixed(2)}
+                      ¥{day.orders ? (day.revenue / day.orders).toFixed(2) : "0.00"}
                     </td>
                   </tr>
                 ))}
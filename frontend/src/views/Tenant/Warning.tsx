@@ -1,46 +1,48 @@
-import { useState } from "react";
+import { useEffect, useState } from "react";
+import {
+  getWarnings,
+  getWarningSocketUrl,
+  type WarningType,
+} from "@/apis/tenant";
 
-interface WarningItem {
-  id: number;
-  timestamp: string;
-  level: "HIGH" | "MEDIUM" | "LOW";
-  title: string;
-  description: string;
-  status: "ACTIVE" | "RESOLVED";
-}
+type WarningItem = WarningType;
 
 function Warning() {
   const [statusFilter, setStatusFilter] = useState<
     "ALL" | "ACTIVE" | "RESOLVED"
   >("ALL");
+  const [warnings, setWarnings] = useState<WarningItem[]>([]);
+
+  useEffect(() => {
+    getWarnings("ALL").then((res) => {
+      setWarnings(res || []);
+    });
 
-  // 模拟预警数据
-  const warnings: WarningItem[] = [
-    {
-      id: 1,
-      timestamp: "2024-01-20 10:30:15",
-      level: "HIGH",
-      title: "系统负载过高",
-      description: "服务器CPU使用率超过90%",
-      status: "ACTIVE",
-    },
-    {
-      id: 2,
-      timestamp: "2024-01-20 09:15:22",
-      level: "MEDIUM",
-      title: "存储空间不足",
-      description: "磁盘使用率达到85%",
-      status: "ACTIVE",
-    },
-    {
-      id: 3,
-      timestamp: "2024-01-19 15:40:45",
-      level: "LOW",
-      title: "数据库连接异常",
-      description: "数据库响应时间超过预期",
-      status: "RESOLVED",
-    },
-  ];
+    // 后端库存变动时推送预警变化，先换取一次性票据再连接
+    let socket: WebSocket | null = null;
+    let closed = false;
+    getWarningSocketUrl().then((url) => {
+      if (closed) {
+        return;
+      }
+      socket = new WebSocket(url);
+      socket.onmessage = (event) => {
+        const message = JSON.parse(event.data);
+        if (message.type === "snapshot") {
+          return;
+        }
+        const warning: WarningItem = message.data;
+        setWarnings((prev) => [
+          warning,
+          ...prev.filter((item) => item.id !== warning.id),
+        ]);
+      };
+    });
+    return () => {
+      closed = true;
+      socket?.close();
+    };
+  }, []);
 
   const getLevelColor = (level: string) => {
     switch (level) {
@@ -129,11 +131,7 @@ function Warning() {
             <p className="text-gray-600 mb-2">{warning.description}</p>
             <div className="flex justify-between items-center text-sm text-gray-500">
               <span>{warning.timestamp}</span>
-              {warning.status === "ACTIVE" && (
-                <button className="text-blue-500 hover:text-blue-700">
-                  标记为已解决
-                </button>
-              )}
+              {warning.resolved_at && <span>解决于 {warning.resolved_at}</span>}
             </div>
           </div>
         ))}